@@ -10398,6 +10398,7 @@ String className;
 bool enabled;
 /* readonly */
 bool enabledEffective;
+bool eventDispatch;
 /* readonly */
 uint id;
 /* readonly */
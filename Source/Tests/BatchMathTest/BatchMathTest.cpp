@@ -0,0 +1,203 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Math/BatchMath.h>
+#include <Urho3D/Math/Random.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+/// Interleaved vertex, as the batch functions are used on vertex buffers.
+struct TestVertex
+{
+    /// Position.
+    Vector3 position_;
+    /// Normal.
+    Vector3 normal_;
+    /// Texture coordinates.
+    Vector2 texCoord_;
+};
+
+/// Return whether two vectors are equal within a relative tolerance, as the SIMD kernels may round differently.
+static bool Near(const Vector3& lhs, const Vector3& rhs)
+{
+    return (lhs - rhs).Length() <= 1e-5f * Max(1.0f, rhs.Length());
+}
+
+/// Return whether two 4D vectors are equal within a relative tolerance.
+static bool Near(const Vector4& lhs, const Vector4& rhs)
+{
+    const Vector4 delta = lhs - rhs;
+    return sqrtf(delta.DotProduct(delta)) <= 1e-5f * Max(1.0f, sqrtf(rhs.DotProduct(rhs)));
+}
+
+/// Return whether two floats are equal within a relative tolerance.
+static bool Near(float lhs, float rhs)
+{
+    return Abs(lhs - rhs) <= 1e-5f * Max(1.0f, Abs(rhs));
+}
+
+/// Return a random vector with components in the range.
+static Vector3 RandomVector(float range)
+{
+    return Vector3(Random(-range, range), Random(-range, range), Random(-range, range));
+}
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    SetRandomSeed(1);
+
+    // Timings are per whole array. Odd count, so that the remainder after any unrolled or vectorized loop is also covered
+    const unsigned count = 100003;
+    const unsigned numIterations = 20;
+    const unsigned stride = sizeof(TestVertex);
+
+    PODVector<TestVertex> vertices(count);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        vertices[i].position_ = RandomVector(100.0f);
+        vertices[i].normal_ = i % 1000 ? RandomVector(1.0f).Normalized() : Vector3::ZERO;
+        vertices[i].texCoord_ = Vector2(Random(), Random());
+    }
+
+    const Matrix3x4 transform(Vector3(10.0f, -5.0f, 3.0f), Quaternion(30.0f, 45.0f, 60.0f), Vector3(2.0f, 0.5f, 1.5f));
+    const Matrix3 normalMatrix = transform.ToMatrix3().Inverse().Transpose();
+    const Matrix4 projection(1.2f, 0.0f, 0.0f, 0.0f, 0.0f, 1.6f, 0.0f, 0.0f, 0.0f, 0.0f, 1.001f, -0.1f, 0.0f, 0.0f, 1.0f, 0.0f);
+    const Plane plane(Vector3(1.0f, 2.0f, -0.5f).Normalized(), Vector3(3.0f, -1.0f, 7.0f));
+
+    PODVector<TestVertex> output(vertices);
+    PODVector<Vector3> expected(count);
+    HiresTimer timer;
+
+    // Points
+    timer.Reset();
+    for (unsigned j = 0; j < numIterations; ++j)
+    {
+        for (unsigned i = 0; i < count; ++i)
+            expected[i] = transform * vertices[i].position_;
+    }
+    test.Report("Transform points, per element", timer.GetUSec(false), numIterations);
+    timer.Reset();
+    for (unsigned j = 0; j < numIterations; ++j)
+        TransformPoints(transform, &vertices[0].position_, stride, &output[0].position_, stride, count);
+    test.Report("Transform points, batch", timer.GetUSec(false), numIterations);
+    bool pointsNear = true;
+    for (unsigned i = 0; i < count; ++i)
+        pointsNear &= Near(output[i].position_, expected[i]) && output[i].texCoord_ == vertices[i].texCoord_;
+    URHO3D_CHECK(test, pointsNear);
+
+    // Directions
+    for (unsigned i = 0; i < count; ++i)
+        expected[i] = transform * Vector4(vertices[i].position_, 0.0f);
+    TransformDirections(transform, &vertices[0].position_, stride, &output[0].position_, stride, count);
+    bool directionsNear = true;
+    for (unsigned i = 0; i < count; ++i)
+        directionsNear &= Near(output[i].position_, expected[i]);
+    URHO3D_CHECK(test, directionsNear);
+
+    // Normals, in place. Zero normals stay zero
+    PODVector<TestVertex> normals(vertices);
+    timer.Reset();
+    for (unsigned i = 0; i < count; ++i)
+        expected[i] = (normalMatrix * vertices[i].normal_).Normalized();
+    test.Report("Transform normals, per element", timer.GetUSec(false));
+    timer.Reset();
+    TransformNormals(normalMatrix, &normals[0].normal_, stride, &normals[0].normal_, stride, count);
+    test.Report("Transform normals, batch", timer.GetUSec(false));
+    bool normalsNear = true;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (vertices[i].normal_ == Vector3::ZERO)
+            normalsNear &= normals[i].normal_ == Vector3::ZERO;
+        else
+            normalsNear &= Near(normals[i].normal_, expected[i]) && normals[i].position_ == vertices[i].position_;
+    }
+    URHO3D_CHECK(test, normalsNear);
+
+    // Projection into a packed array
+    PODVector<Vector4> projected(count);
+    timer.Reset();
+    ProjectPoints(projection, &vertices[0].position_, stride, &projected[0], count);
+    test.Report("Project points, batch", timer.GetUSec(false));
+    bool projectedNear = true;
+    for (unsigned i = 0; i < count; ++i)
+        projectedNear &= Near(projected[i], projection * Vector4(vertices[i].position_, 1.0f));
+    URHO3D_CHECK(test, projectedNear);
+
+    // Bounding box of points
+    BoundingBox expectedBox;
+    timer.Reset();
+    for (unsigned i = 0; i < count; ++i)
+        expectedBox.Merge(vertices[i].position_);
+    test.Report("Merge points, per element", timer.GetUSec(false));
+    BoundingBox box;
+    timer.Reset();
+    MergePoints(box, &vertices[0].position_, stride, count);
+    test.Report("Merge points, batch", timer.GetUSec(false));
+    URHO3D_CHECK(test, box.Defined() && box.min_ == expectedBox.min_ && box.max_ == expectedBox.max_);
+
+    // Bounding boxes
+    const unsigned numBoxes = count / 4;
+    PODVector<BoundingBox> boxes(numBoxes);
+    for (unsigned i = 0; i < numBoxes; ++i)
+    {
+        Vector3 center = RandomVector(100.0f);
+        Vector3 halfSize(Random(0.1f, 5.0f), Random(0.1f, 5.0f), Random(0.1f, 5.0f));
+        boxes[i] = BoundingBox(center - halfSize, center + halfSize);
+    }
+    PODVector<BoundingBox> expectedBoxes(numBoxes);
+    timer.Reset();
+    for (unsigned i = 0; i < numBoxes; ++i)
+        expectedBoxes[i] = boxes[i].Transformed(transform);
+    test.Report("Transform bounding boxes, per element", timer.GetUSec(false));
+    timer.Reset();
+    TransformBoundingBoxes(transform, &boxes[0], &boxes[0], numBoxes);
+    test.Report("Transform bounding boxes, batch", timer.GetUSec(false));
+    bool boxesNear = true;
+    for (unsigned i = 0; i < numBoxes; ++i)
+        boxesNear &= Near(boxes[i].min_, expectedBoxes[i].min_) && Near(boxes[i].max_, expectedBoxes[i].max_);
+    URHO3D_CHECK(test, boxesNear);
+
+    // Plane distances
+    PODVector<float> distances(count);
+    PODVector<float> expectedDistances(count);
+    timer.Reset();
+    for (unsigned i = 0; i < count; ++i)
+        expectedDistances[i] = plane.Distance(vertices[i].position_);
+    test.Report("Plane distances, per element", timer.GetUSec(false));
+    timer.Reset();
+    CalculatePlaneDistances(plane, &vertices[0].position_, stride, &distances[0], count);
+    test.Report("Plane distances, batch", timer.GetUSec(false));
+    bool distancesNear = true;
+    for (unsigned i = 0; i < count; ++i)
+        distancesNear &= Near(distances[i], expectedDistances[i]);
+    URHO3D_CHECK(test, distancesNear);
+
+    // A zero count does not touch the output
+    BoundingBox undefinedBox;
+    MergePoints(undefinedBox, &vertices[0].position_, stride, 0);
+    URHO3D_CHECK(test, !undefinedBox.Defined());
+
+    return test.GetExitCode();
+}
@@ -0,0 +1,221 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Resource/Decompress.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+/// Fill a buffer with deterministic pseudo-random data.
+static void FillRandom(PODVector<unsigned char>& buffer, unsigned size, unsigned seed)
+{
+    buffer.Resize(size);
+    for (unsigned i = 0; i < size; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        buffer[i] = (unsigned char)(seed >> 24u);
+    }
+}
+
+/// Return the size of a DXT compressed image in bytes.
+static unsigned GetDXTDataSize(int width, int height, int depth, CompressedFormat format)
+{
+    unsigned blockSize = format == CF_DXT1 ? 8 : 16;
+    return (unsigned)(((width + 3) / 4) * ((height + 3) / 4) * depth) * blockSize;
+}
+
+/// Expand a 565 color to 8 bits per component.
+static void ReferenceUnpack565(unsigned value, unsigned char* color)
+{
+    unsigned r = (value >> 11u) & 0x1fu;
+    unsigned g = (value >> 5u) & 0x3fu;
+    unsigned b = value & 0x1fu;
+    color[0] = (unsigned char)((r << 3u) | (r >> 2u));
+    color[1] = (unsigned char)((g << 2u) | (g >> 4u));
+    color[2] = (unsigned char)((b << 3u) | (b >> 2u));
+    color[3] = 255;
+}
+
+/// Decode one DXT block to 16 RGBA pixels straight from the format specification.
+static void ReferenceDecodeBlock(unsigned char* pixels, const unsigned char* block, CompressedFormat format)
+{
+    const unsigned char* colorBlock = format == CF_DXT1 ? block : block + 8;
+
+    unsigned c0 = colorBlock[0] | (colorBlock[1] << 8u);
+    unsigned c1 = colorBlock[2] | (colorBlock[3] << 8u);
+    unsigned char palette[4][4];
+    ReferenceUnpack565(c0, palette[0]);
+    ReferenceUnpack565(c1, palette[1]);
+    bool threeColor = format == CF_DXT1 && c0 <= c1;
+    for (unsigned j = 0; j < 3; ++j)
+    {
+        unsigned a = palette[0][j];
+        unsigned b = palette[1][j];
+        palette[2][j] = (unsigned char)(threeColor ? (a + b) / 2 : (2 * a + b) / 3);
+        palette[3][j] = (unsigned char)(threeColor ? 0 : (a + 2 * b) / 3);
+    }
+    palette[2][3] = 255;
+    palette[3][3] = (unsigned char)(threeColor ? 0 : 255);
+
+    for (unsigned i = 0; i < 16; ++i)
+    {
+        unsigned index = (colorBlock[4 + i / 4] >> (2 * (i % 4))) & 3u;
+        memcpy(pixels + i * 4, palette[index], 4);
+    }
+
+    if (format == CF_DXT3)
+    {
+        for (unsigned i = 0; i < 16; ++i)
+        {
+            unsigned alpha = (block[i / 2] >> (4 * (i % 2))) & 0xfu;
+            pixels[i * 4 + 3] = (unsigned char)(alpha * 17);
+        }
+    }
+    else if (format == CF_DXT5)
+    {
+        unsigned a0 = block[0];
+        unsigned a1 = block[1];
+        unsigned char codebook[8];
+        codebook[0] = (unsigned char)a0;
+        codebook[1] = (unsigned char)a1;
+        for (unsigned i = 1; i < 7; ++i)
+        {
+            if (a0 > a1)
+                codebook[1 + i] = (unsigned char)(((7 - i) * a0 + i * a1) / 7);
+            else if (i < 5)
+                codebook[1 + i] = (unsigned char)(((5 - i) * a0 + i * a1) / 5);
+        }
+        if (a0 <= a1)
+        {
+            codebook[6] = 0;
+            codebook[7] = 255;
+        }
+
+        unsigned long long indices = 0;
+        for (unsigned i = 0; i < 6; ++i)
+            indices |= (unsigned long long)block[2 + i] << (8 * i);
+        for (unsigned i = 0; i < 16; ++i)
+            pixels[i * 4 + 3] = codebook[(indices >> (3 * i)) & 7u];
+    }
+}
+
+/// Decode a DXT image with the reference block decoder, clipping the blocks at the image edges.
+static void ReferenceDecompressDXT(unsigned char* rgba, const unsigned char* blocks, int width, int height, int depth,
+    CompressedFormat format)
+{
+    unsigned blockSize = format == CF_DXT1 ? 8 : 16;
+    for (int z = 0; z < depth; ++z)
+    {
+        for (int y = 0; y < height; y += 4)
+        {
+            for (int x = 0; x < width; x += 4)
+            {
+                unsigned char pixels[16 * 4];
+                ReferenceDecodeBlock(pixels, blocks, format);
+                blocks += blockSize;
+
+                for (int py = 0; py < 4 && y + py < height; ++py)
+                {
+                    for (int px = 0; px < 4 && x + px < width; ++px)
+                        memcpy(rgba + (((z * height) + y + py) * width + x + px) * 4, pixels + (py * 4 + px) * 4, 4);
+                }
+            }
+        }
+    }
+}
+
+/// Check the DXT decoder against the reference over several image sizes, and the block row ranges against the full image.
+static void TestDXT(UnitTest& test, CompressedFormat format)
+{
+    static const int sizes[][3] = {{4, 4, 1}, {64, 64, 1}, {37, 21, 1}, {5, 3, 1}, {16, 12, 3}, {13, 7, 2}};
+
+    for (auto size : sizes)
+    {
+        int width = size[0];
+        int height = size[1];
+        int depth = size[2];
+        unsigned numBytes = (unsigned)(width * height * depth * 4);
+
+        PODVector<unsigned char> blocks;
+        FillRandom(blocks, GetDXTDataSize(width, height, depth, format), (unsigned)(width * 131 + height * 7 + format));
+
+        PODVector<unsigned char> expected(numBytes);
+        ReferenceDecompressDXT(&expected[0], &blocks[0], width, height, depth, format);
+
+        PODVector<unsigned char> result(numBytes);
+        DecompressImageDXT(&result[0], &blocks[0], width, height, depth, format);
+        URHO3D_CHECK(test, !memcmp(&result[0], &expected[0], numBytes));
+
+        // Decode in two ranges of block rows
+        int numBlockRows = ((height + 3) / 4) * depth;
+        int split = numBlockRows / 2;
+        memset(&result[0], 0, numBytes);
+        DecompressImageDXT(&result[0], &blocks[0], width, height, depth, format, split, numBlockRows);
+        DecompressImageDXT(&result[0], &blocks[0], width, height, depth, format, 0, split);
+        URHO3D_CHECK(test, !memcmp(&result[0], &expected[0], numBytes));
+    }
+}
+
+/// Check that a large level decompresses identically with and without the work queue, and report the timings.
+static void TestThreadedLevel(UnitTest& test, CompressedFormat format, int width, int height, unsigned dataSize, const char* name)
+{
+    PODVector<unsigned char> data;
+    FillRandom(data, dataSize, (unsigned)format);
+
+    CompressedLevel level;
+    level.data_ = &data[0];
+    level.format_ = format;
+    level.width_ = width;
+    level.height_ = height;
+    level.depth_ = 1;
+    level.dataSize_ = dataSize;
+
+    unsigned numBytes = (unsigned)(width * height * 4);
+    PODVector<unsigned char> single(numBytes);
+    PODVector<unsigned char> threaded(numBytes);
+
+    HiresTimer timer;
+    URHO3D_CHECK(test, level.Decompress(&single[0]));
+    test.Report((String(name) + " single thread").CString(), timer.GetUSec(true));
+    URHO3D_CHECK(test, level.Decompress(&threaded[0], test.GetSubsystem<WorkQueue>()));
+    test.Report((String(name) + " work queue").CString(), timer.GetUSec(true));
+
+    URHO3D_CHECK(test, !memcmp(&single[0], &threaded[0], numBytes));
+}
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+
+    TestDXT(test, CF_DXT1);
+    TestDXT(test, CF_DXT3);
+    TestDXT(test, CF_DXT5);
+
+    const int size = 2048;
+    TestThreadedLevel(test, CF_DXT1, size, size, GetDXTDataSize(size, size, 1, CF_DXT1), "DXT1 2048x2048");
+    TestThreadedLevel(test, CF_DXT5, size, size, GetDXTDataSize(size, size, 1, CF_DXT5), "DXT5 2048x2048");
+    TestThreadedLevel(test, CF_ETC2_RGBA, size, size, (unsigned)(size * size), "ETC2 RGBA 2048x2048");
+    TestThreadedLevel(test, CF_PVRTC_RGBA_4BPP, size, size, (unsigned)(size * size / 2), "PVRTC RGBA 4bpp 2048x2048");
+
+    return test.GetExitCode();
+}
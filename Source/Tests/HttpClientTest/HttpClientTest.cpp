@@ -0,0 +1,258 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Network/HttpClient.h>
+#include <Urho3D/Network/HttpRequest.h>
+
+#include <Civetweb/civetweb.h>
+
+#include "UnitTest.h"
+
+#include <atomic>
+
+using namespace Urho3D;
+
+/// Number of requests received by the silent handler.
+static std::atomic<unsigned> numSilentRequests{};
+
+/// Serve the number of bytes given in the query string with a known Content-Length, so that the connection can be kept alive.
+static int HandleData(mg_connection* connection, void* userData)
+{
+    const mg_request_info* info = mg_get_request_info(connection);
+    unsigned size = info->query_string ? ToUInt(info->query_string) : 0;
+
+    mg_printf(connection, "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: %u\r\n\r\n", size);
+
+    unsigned char buffer[4096];
+    unsigned sent = 0;
+    while (sent < size)
+    {
+        unsigned chunk = Min(size - sent, (unsigned)sizeof(buffer));
+        for (unsigned i = 0; i < chunk; ++i)
+            buffer[i] = (unsigned char)(sent + i);
+        if (mg_write(connection, buffer, chunk) <= 0)
+            break;
+        sent += chunk;
+    }
+
+    return 200;
+}
+
+/// Count the request but do not respond, so that the client times out.
+static int HandleSilent(mg_connection* connection, void* userData)
+{
+    ++numSilentRequests;
+    Time::Sleep(1000);
+    return 1;
+}
+
+/// Start the local server. Try a few ports in case one is in use.
+static mg_context* StartServer(int& port)
+{
+    mg_callbacks callbacks;
+    memset(&callbacks, 0, sizeof callbacks);
+
+    for (port = 28080; port < 28090; ++port)
+    {
+        String listeningPorts = "127.0.0.1:" + String(port);
+        const char* options[] = {
+            "listening_ports", listeningPorts.CString(),
+            "enable_keep_alive", "yes",
+            "num_threads", "4",
+            nullptr
+        };
+
+        mg_context* context = mg_start(&callbacks, nullptr, options);
+        if (context)
+        {
+            mg_set_request_handler(context, "/data", &HandleData, nullptr);
+            mg_set_request_handler(context, "/silent", &HandleSilent, nullptr);
+            return context;
+        }
+    }
+
+    return nullptr;
+}
+
+/// Read the whole response and check its contents.
+static bool ReadResponse(HttpRequest* request, unsigned size)
+{
+    unsigned char buffer[8192];
+    unsigned total = 0;
+    bool valid = true;
+
+    while (!request->IsEof())
+    {
+        unsigned read = request->Read(buffer, sizeof buffer);
+        for (unsigned i = 0; i < read; ++i)
+            valid &= buffer[i] == (unsigned char)(total + i);
+        total += read;
+    }
+
+    return valid && total == size && request->GetState() == HTTP_CLOSED && request->GetStatusCode() == 200;
+}
+
+/// Return the finished requests once the specified number has been reported.
+static Vector<SharedPtr<HttpRequest> > WaitForFinished(HttpClient* client, unsigned count)
+{
+    Vector<SharedPtr<HttpRequest> > finished;
+    HiresTimer timer;
+    while (finished.Size() < count && timer.GetUSec(false) < 10000000)
+    {
+        client->GetFinishedRequests(finished);
+        Time::Sleep(1);
+    }
+    return finished;
+}
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+
+    int port;
+    mg_context* server = StartServer(port);
+    if (!URHO3D_CHECK(test, server))
+        return test.GetExitCode();
+
+    const String url = "http://127.0.0.1:" + String(port) + "/data?";
+    const unsigned numRequests = 100;
+
+    // Sequential requests, with and without keep-alive
+    for (unsigned keepAlive = 0; keepAlive < 2; ++keepAlive)
+    {
+        SharedPtr<HttpClient> client(new HttpClient());
+        client->SetKeepAlive(keepAlive != 0);
+
+        unsigned numValid = 0;
+        unsigned numReused = 0;
+        HiresTimer timer;
+        for (unsigned i = 0; i < numRequests; ++i)
+        {
+            SharedPtr<HttpRequest> request(new HttpRequest(url + "1000", String::EMPTY, Vector<String>(), String::EMPTY));
+            client->QueueRequest(request);
+            if (ReadResponse(request, 1000))
+                ++numValid;
+            if (request->IsConnectionReused())
+                ++numReused;
+            WaitForFinished(client, 1);
+        }
+        test.Report(keepAlive ? "HTTP request, keep-alive" : "HTTP request, new connection", timer.GetUSec(false), numRequests);
+
+        URHO3D_CHECK(test, numValid == numRequests);
+        // All but the first request go through the pooled connection
+        URHO3D_CHECK(test, numReused == (keepAlive ? numRequests - 1 : 0));
+        URHO3D_CHECK(test, client->GetNumActiveRequests() == 0);
+    }
+
+    // Concurrent requests with a response larger than the read buffer, all reported as finished
+    {
+        SharedPtr<HttpClient> client(new HttpClient());
+        client->SetNumThreads(4);
+        const unsigned size = 1000000;
+        Vector<SharedPtr<HttpRequest> > requests;
+        for (unsigned i = 0; i < 8; ++i)
+        {
+            requests.Push(SharedPtr<HttpRequest>(new HttpRequest(url + String(size), String::EMPTY, Vector<String>(),
+                String::EMPTY)));
+            client->QueueRequest(requests.Back());
+        }
+
+        unsigned numValid = 0;
+        for (unsigned i = 0; i < requests.Size(); ++i)
+        {
+            if (ReadResponse(requests[i], size))
+                ++numValid;
+        }
+        URHO3D_CHECK(test, numValid == requests.Size());
+        URHO3D_CHECK(test, WaitForFinished(client, requests.Size()).Size() == requests.Size());
+    }
+
+    // An abandoned request that fills the read buffer must not block the only worker thread
+    {
+        SharedPtr<HttpClient> client(new HttpClient());
+        client->SetNumThreads(1);
+        client->QueueRequest(new HttpRequest(url + "10000000", String::EMPTY, Vector<String>(), String::EMPTY));
+        Time::Sleep(100);
+
+        SharedPtr<HttpRequest> request(new HttpRequest(url + "1000", String::EMPTY, Vector<String>(), String::EMPTY));
+        client->QueueRequest(request);
+        Vector<SharedPtr<HttpRequest> > finished = WaitForFinished(client, 1);
+        URHO3D_CHECK(test, finished.Size() == 1 && finished[0] == request);
+        URHO3D_CHECK(test, ReadResponse(request, 1000));
+        URHO3D_CHECK(test, client->GetNumActiveRequests() == 0);
+    }
+
+    // Large responses that are not read yet do not occupy the worker threads, so other requests still complete
+    {
+        SharedPtr<HttpClient> client(new HttpClient());
+        client->SetNumThreads(2);
+        const unsigned size = 4000000;
+        Vector<SharedPtr<HttpRequest> > large;
+        for (unsigned i = 0; i < 2; ++i)
+        {
+            large.Push(SharedPtr<HttpRequest>(new HttpRequest(url + String(size), String::EMPTY, Vector<String>(),
+                String::EMPTY)));
+            client->QueueRequest(large.Back());
+        }
+        Time::Sleep(100);
+
+        SharedPtr<HttpRequest> request(new HttpRequest(url + "1000", String::EMPTY, Vector<String>(), String::EMPTY));
+        client->QueueRequest(request);
+        Vector<SharedPtr<HttpRequest> > finished = WaitForFinished(client, 3);
+        URHO3D_CHECK(test, finished.Size() == 3 && finished.Contains(request));
+        URHO3D_CHECK(test, ReadResponse(request, 1000));
+        URHO3D_CHECK(test, ReadResponse(large[0], size) && ReadResponse(large[1], size));
+    }
+
+    // A request with side effects is not sent again after the response timed out on a pooled connection
+    {
+        SharedPtr<HttpClient> client(new HttpClient());
+        client->SetNumThreads(1);
+        client->SetTimeout(200);
+        SharedPtr<HttpRequest> request(new HttpRequest(url + "1000", String::EMPTY, Vector<String>(), String::EMPTY));
+        client->QueueRequest(request);
+        URHO3D_CHECK(test, ReadResponse(request, 1000));
+        WaitForFinished(client, 1);
+        URHO3D_CHECK(test, client->GetNumIdleConnections() == 1);
+
+        const String silentUrl = "http://127.0.0.1:" + String(port) + "/silent";
+        request = new HttpRequest(silentUrl, "POST", Vector<String>(), "data");
+        client->QueueRequest(request);
+        WaitForFinished(client, 1);
+        URHO3D_CHECK(test, request->GetState() == HTTP_ERROR);
+        URHO3D_CHECK(test, numSilentRequests == 1);
+    }
+
+    // Destroying the client with requests in flight stops and fails them
+    {
+        SharedPtr<HttpClient> client(new HttpClient());
+        SharedPtr<HttpRequest> request(new HttpRequest(url + "10000000", String::EMPTY, Vector<String>(), String::EMPTY));
+        client->QueueRequest(request);
+        Time::Sleep(100);
+        client.Reset();
+        URHO3D_CHECK(test, request->GetState() == HTTP_CLOSED || request->GetState() == HTTP_ERROR);
+    }
+
+    mg_stop(server);
+
+    return test.GetExitCode();
+}
@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/Thread.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Resource/Image.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+/// Fill an image with deterministic pseudo-random data.
+static SharedPtr<Image> CreateTestImage(Context* context, int width, int height, unsigned components)
+{
+    SharedPtr<Image> image(new Image(context));
+    image->SetSize(width, height, components);
+
+    unsigned seed = 0x12345678u + components;
+    unsigned char* data = image->GetData();
+    for (unsigned i = 0; i < (unsigned)(width * height) * components; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        data[i] = (unsigned char)(seed >> 24u);
+    }
+
+    return image;
+}
+
+/// Calculate the next mip level of an even-sized 2D image with a plain 2x2 box filter.
+static SharedPtr<Image> CalculateReferenceLevel(const Image* image)
+{
+    int width = image->GetWidth();
+    int widthOut = width / 2;
+    int heightOut = image->GetHeight() / 2;
+    unsigned components = image->GetComponents();
+
+    SharedPtr<Image> level(new Image(image->GetContext()));
+    level->SetSize(widthOut, heightOut, components);
+
+    const unsigned char* in = image->GetData();
+    unsigned char* out = level->GetData();
+    for (int y = 0; y < heightOut; ++y)
+    {
+        const unsigned char* upper = in + (y * 2) * width * components;
+        const unsigned char* lower = upper + width * components;
+        for (int x = 0; x < widthOut; ++x)
+        {
+            for (unsigned c = 0; c < components; ++c)
+            {
+                unsigned sum = (unsigned)upper[x * 2 * components + c] + upper[(x * 2 + 1) * components + c] +
+                    lower[x * 2 * components + c] + lower[(x * 2 + 1) * components + c];
+                *out++ = (unsigned char)(sum >> 2u);
+            }
+        }
+    }
+
+    return level;
+}
+
+/// Return whether two images have the same size and pixel data.
+static bool CompareImages(const Image* a, const Image* b)
+{
+    if (!a || !b || a->GetWidth() != b->GetWidth() || a->GetHeight() != b->GetHeight() || a->GetDepth() != b->GetDepth() ||
+        a->GetComponents() != b->GetComponents())
+        return false;
+
+    return !memcmp(a->GetData(), b->GetData(), (size_t)(a->GetWidth() * a->GetHeight() * a->GetDepth() * a->GetComponents()));
+}
+
+/// Thread which precalculates the mip levels of an image, like the background resource loader does.
+class MipLevelThread : public Thread
+{
+public:
+    /// Construct.
+    explicit MipLevelThread(Image* image) :
+        image_(image),
+        usec_(0)
+    {
+    }
+
+    /// Precalculate the levels and measure the time.
+    void ThreadFunction() override
+    {
+        HiresTimer timer;
+        image_->PrecalculateLevels();
+        usec_ = timer.GetUSec(false);
+    }
+
+    /// Image.
+    Image* image_;
+    /// Time taken in microseconds.
+    long long usec_;
+};
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    Context* context = test.GetContext();
+
+    const int size = 2048;
+
+    for (unsigned components = 1; components <= 4; ++components)
+    {
+        SharedPtr<Image> image = CreateTestImage(context, size, size, components);
+        String suffix = " (" + String(components) + " components)";
+
+        // Reference result from the scalar filter
+        HiresTimer timer;
+        SharedPtr<Image> reference = CalculateReferenceLevel(image);
+        test.Report(("Reference mip level" + suffix).CString(), timer.GetUSec(true));
+
+        // Main thread: rows are split to the worker threads
+        SharedPtr<Image> level = image->GetNextLevel();
+        test.Report(("Main thread mip level" + suffix).CString(), timer.GetUSec(true));
+        URHO3D_CHECK(test, CompareImages(level, reference));
+
+        // Background thread: the full chain through PrecalculateLevels()
+        MipLevelThread thread(image);
+        thread.Run();
+        thread.Stop();
+        test.Report(("Background thread mip chain" + suffix).CString(), thread.usec_);
+
+        SharedPtr<Image> current = image;
+        while (current->GetWidth() > 1 && current->GetHeight() > 1)
+        {
+            SharedPtr<Image> expected = CalculateReferenceLevel(current);
+            SharedPtr<Image> next = current->GetNextLevel();
+            if (!URHO3D_CHECK(test, CompareImages(next, expected)))
+                break;
+            current = next;
+        }
+    }
+
+    // Luminance to RGBA expansion
+    SharedPtr<Image> luminance = CreateTestImage(context, 1023, 17, 1);
+    SharedPtr<Image> rgba = luminance->ConvertToRGBA();
+    bool converted = rgba && rgba->GetComponents() == 4;
+    for (int i = 0; converted && i < luminance->GetWidth() * luminance->GetHeight(); ++i)
+    {
+        unsigned char l = luminance->GetData()[i];
+        const unsigned char* pixel = rgba->GetData() + i * 4;
+        converted = pixel[0] == l && pixel[1] == l && pixel[2] == l && pixel[3] == 255;
+    }
+    URHO3D_CHECK(test, converted);
+
+    // Volume image DDS round trip keeps the depth
+    SharedPtr<Image> volume(new Image(context));
+    volume->SetSize(16, 8, 4, 4);
+    for (unsigned i = 0; i < 16 * 8 * 4 * 4; ++i)
+        volume->GetData()[i] = (unsigned char)(i * 7);
+    VectorBuffer dds;
+    URHO3D_CHECK(test, volume->SaveDDS(dds));
+    dds.Seek(0);
+    SharedPtr<Image> loaded(new Image(context));
+    if (URHO3D_CHECK(test, loaded->Load(dds)))
+    {
+        URHO3D_CHECK(test, loaded->GetDepth() == 4);
+        URHO3D_CHECK(test, CompareImages(loaded, volume));
+    }
+
+    return test.GetExitCode();
+}
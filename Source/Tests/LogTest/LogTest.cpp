@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/IO/File.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+/// Read the log file and return the number of lines containing the specified text.
+static unsigned CountLines(Context* context, const String& fileName, const String& text)
+{
+    File file(context, fileName);
+    unsigned count = 0;
+    while (!file.IsEof())
+    {
+        if (file.ReadLine().Contains(text))
+            ++count;
+    }
+    return count;
+}
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    Context* context = test.GetContext();
+    auto* log = test.GetSubsystem<Log>();
+    auto* fileSystem = test.GetSubsystem<FileSystem>();
+    const String fileName = fileSystem->GetTemporaryDir() + "LogTest.log";
+    const unsigned numMessages = 100000;
+
+    log->SetQuiet(true);
+    log->SetTimeStamp(false);
+
+    // Compare writing and flushing each message against the background writer
+    for (unsigned async = 0; async < 2; ++async)
+    {
+        log->SetAsync(async != 0);
+        log->Open(fileName);
+        HiresTimer timer;
+        for (unsigned i = 0; i < numMessages; ++i)
+            URHO3D_LOGINFO("Benchmark message " + String(i));
+        log->Close();
+        test.Report(async ? "Log message, asynchronous" : "Log message, synchronous", timer.GetUSec(false), numMessages);
+        URHO3D_CHECK(test, CountLines(context, fileName, "Benchmark message") == numMessages);
+    }
+
+    // With a small queue that drops on overflow and a long flush interval, info messages get dropped but errors must be
+    // on disk as soon as they have been logged
+    log->SetAsync(true);
+    log->SetDropOnOverflow(true);
+    log->SetMaxQueueSize(1024);
+    log->SetFlushSize(1024);
+    log->SetFlushInterval(60000);
+    log->Open(fileName);
+    const unsigned numErrors = 10;
+    bool errorsWritten = true;
+    for (unsigned i = 0; i < numErrors; ++i)
+    {
+        for (unsigned j = 0; j < 1000; ++j)
+            URHO3D_LOGINFO("Overflow message " + String(j));
+        URHO3D_LOGERROR("Error message " + String(i));
+        if (CountLines(context, fileName, "Error message") != i + 1)
+            errorsWritten = false;
+    }
+    URHO3D_CHECK(test, errorsWritten);
+    URHO3D_CHECK(test, log->GetNumDroppedMessages() > 0);
+    log->Close();
+    URHO3D_CHECK(test, CountLines(context, fileName, "Error message") == numErrors);
+
+    fileSystem->Delete(fileName);
+    return test.GetExitCode();
+}
@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/LuaScript/LuaScript.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+/// Number of loop iterations in each benchmark.
+static const unsigned NUM_ITERATIONS = 200000;
+
+/// Move and rotate a node through the tolua++ bindings.
+static const char* toluaLoop =
+    "local node = toluaNode\n"
+    "local delta = Quaternion(0, 1, 0)\n"
+    "local step = Vector3(0, 0, 0.001)\n"
+    "local sum = 0\n"
+    "for i = 1, iterations do\n"
+    "    node:Rotate(delta)\n"
+    "    node:Translate(step)\n"
+    "    local position = node.position\n"
+    "    sum = sum + (position + step):Length()\n"
+    "end\n"
+    "toluaSum = sum\n";
+
+/// The same loop through the FFI fast path.
+static const char* ffiLoop =
+    "local node = UrhoFFI.ToPointer(ffiNode)\n"
+    "local delta = UrhoFFI.EulerAngles(0, 1, 0)\n"
+    "local step = UrhoFFI.Vector3(0, 0, 0.001)\n"
+    "local position = UrhoFFI.Vector3()\n"
+    "local sum = 0\n"
+    "for i = 1, iterations do\n"
+    "    UrhoFFI.Rotate(node, delta)\n"
+    "    UrhoFFI.Translate(node, step)\n"
+    "    UrhoFFI.GetPosition(node, position)\n"
+    "    sum = sum + (position + step):Length()\n"
+    "end\n"
+    "ffiSum = sum\n";
+
+/// Check that both loops produced the same node transform and results.
+static const char* compareResults =
+    "local function near(lhs, rhs) return math.abs(lhs - rhs) < 1e-3 end\n"
+    "local toluaPosition = toluaNode.position\n"
+    "local ffiPosition = UrhoFFI.GetPosition(ffiNode)\n"
+    "local toluaRotation = toluaNode.rotation\n"
+    "local ffiRotation = UrhoFFI.GetRotation(ffiNode)\n"
+    "if not (near(toluaPosition.x, ffiPosition.x) and near(toluaPosition.y, ffiPosition.y) and near(toluaPosition.z, ffiPosition.z)) then\n"
+    "    error('positions differ')\n"
+    "end\n"
+    "if not (near(toluaRotation.w, ffiRotation.w) and near(toluaRotation.x, ffiRotation.x) and\n"
+    "    near(toluaRotation.y, ffiRotation.y) and near(toluaRotation.z, ffiRotation.z)) then\n"
+    "    error('rotations differ')\n"
+    "end\n"
+    "if not near(toluaSum / iterations, ffiSum / iterations) then\n"
+    "    error('loop results differ')\n"
+    "end\n"
+    "local converted = UrhoFFI.FromVector3(Vector3(1, 2, 3)):CrossProduct(UrhoFFI.Vector3(0, 1, 0)):ToVector3()\n"
+    "if not converted:Equals(Vector3(-3, 0, 1)) then\n"
+    "    error('conversion failed')\n"
+    "end\n";
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    Context* context = test.GetContext();
+    RegisterSceneLibrary(context);
+    context->RegisterSubsystem(new LuaScript(context));
+    auto* luaScript = test.GetSubsystem<LuaScript>();
+
+    URHO3D_CHECK(test, luaScript->ExecuteString("iterations = " + String(NUM_ITERATIONS) + "\n"
+        "scene = Scene()\n"
+        "toluaNode = scene:CreateChild('Tolua')\n"
+        "ffiNode = scene:CreateChild('FFI')\n"));
+
+    HiresTimer timer;
+    URHO3D_CHECK(test, luaScript->ExecuteString(toluaLoop));
+    test.Report("Node rotate/translate/position, tolua++", timer.GetUSec(true), NUM_ITERATIONS);
+    URHO3D_CHECK(test, luaScript->ExecuteString(ffiLoop));
+    test.Report("Node rotate/translate/position, FFI", timer.GetUSec(true), NUM_ITERATIONS);
+
+    URHO3D_CHECK(test, luaScript->ExecuteString(compareResults));
+
+    return test.GetExitCode();
+}
@@ -0,0 +1,246 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/Math/Random.h>
+#include <Urho3D/Network/Connection.h>
+#include <Urho3D/Network/Network.h>
+#include <Urho3D/Network/NetworkEvents.h>
+#include <Urho3D/Network/Protocol.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SmoothedTransform.h>
+
+#include <SLikeNet/types.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+/// Event handler that records the controls acknowledged events of a connection.
+class AcknowledgementListener : public Object
+{
+    URHO3D_OBJECT(AcknowledgementListener, Object);
+
+public:
+    /// Construct.
+    AcknowledgementListener(Context* context, Connection* connection) :
+        Object(context),
+        numEvents_(0),
+        timeStamp_(0)
+    {
+        SubscribeToEvent(connection, E_CONTROLSACKNOWLEDGED, URHO3D_HANDLER(AcknowledgementListener, HandleControlsAcknowledged));
+    }
+
+    /// Handle controls acknowledged event.
+    void HandleControlsAcknowledged(StringHash eventType, VariantMap& eventData)
+    {
+        using namespace ControlsAcknowledged;
+
+        ++numEvents_;
+        timeStamp_ = eventData[P_TIMESTAMP].GetUInt();
+    }
+
+    /// Number of received events.
+    unsigned numEvents_;
+    /// Timestamp of the latest event.
+    unsigned timeStamp_;
+};
+
+/// Process a node position update from the server as the client connection would receive it.
+static void ReceivePosition(Connection* connection, unsigned nodeID, unsigned serverTimeMs, unsigned char timeStamp,
+    const Vector3& position)
+{
+    VectorBuffer msg;
+    msg.WriteNetID(nodeID);
+    msg.WriteUInt(serverTimeMs);
+    msg.WriteUByte(timeStamp);
+    // Network Position is the first latest data attribute of a node. The rest are left out and keep their values
+    msg.WriteVector3(position);
+
+    MemoryBuffer buffer(msg.GetData(), msg.GetSize());
+    connection->ProcessMessage(MSG_NODELATESTDATA, buffer);
+}
+
+/// Send client controls with the specified buttons to the server.
+static void SendControls(Connection* connection, unsigned buttons)
+{
+    Controls controls;
+    controls.buttons_ = buttons;
+    connection->SetControls(controls);
+    connection->SendClientUpdate();
+}
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    Context* context = test.GetContext();
+    RegisterSceneLibrary(context);
+    context->RegisterSubsystem(new Network(context));
+
+    const float frameStep = 1.0f / 60.0f;
+    const float interpolationDelay = 0.1f;
+    const float maxExtrapolation = 0.05f;
+    const unsigned sendIntervalMs = 50;
+    const unsigned serverStartMs = 10000;
+    const unsigned numUpdates = 60;
+    const float latency = 0.1f;
+    const float maxJitter = 0.04f;
+    const unsigned numFrames = 300;
+    const unsigned numWarmupFrames = 60;
+
+    // Client side scene joined through a connection to a server that only exists as the messages fed to it
+    SharedPtr<Scene> scene(new Scene(context));
+    scene->SetInterpolationDelay(interpolationDelay);
+    scene->SetMaxExtrapolation(maxExtrapolation);
+    SharedPtr<Connection> connection(new Connection(context, false, SLNet::AddressOrGUID(), nullptr));
+    connection->SetScene(scene);
+    VectorBuffer loadScene;
+    loadScene.WriteString(String::EMPTY);
+    loadScene.WriteVLE(0);
+    MemoryBuffer loadSceneBuffer(loadScene.GetData(), loadScene.GetSize());
+    connection->ProcessMessage(MSG_LOADSCENE, loadSceneBuffer);
+    URHO3D_CHECK(test, connection->IsSceneLoaded());
+
+    Node* node = scene->CreateChild("Object");
+    auto* transform = node->CreateComponent<SmoothedTransform>();
+
+    // The server moves the node at one unit per second and sends updates at a fixed rate. They arrive with a varying
+    // latency, but being stamped with the server time they must still be played back at the server's pace
+    SetRandomSeed(1);
+    PODVector<float> arrivalTimes;
+    for (unsigned i = 0; i < numUpdates; ++i)
+        arrivalTimes.Push(i * sendIntervalMs / 1000.0f + latency + Random(maxJitter));
+
+    unsigned numReceived = 0;
+    float lastPosition = 0.0f;
+    unsigned maxSnapshots = 0;
+    bool interpolated = true;
+    bool smooth = true;
+    bool extrapolated = true;
+    bool settled = false;
+    for (unsigned i = 0; i < numFrames; ++i)
+    {
+        while (numReceived < numUpdates && arrivalTimes[numReceived] <= scene->GetSmoothingTime())
+        {
+            ReceivePosition(connection, node->GetID(), serverStartMs + numReceived * sendIntervalMs, 0,
+                Vector3(numReceived * sendIntervalMs / 1000.0f, 0.0f, 0.0f));
+            ++numReceived;
+        }
+        scene->Update(frameStep);
+
+        float position = node->GetPosition().x_;
+        double renderTime = scene->GetInterpolationTime() - serverStartMs / 1000.0;
+        double newestTime = (numReceived - 1) * sendIntervalMs / 1000.0;
+        if (i >= numWarmupFrames)
+        {
+            maxSnapshots = Max(maxSnapshots, transform->GetNumSnapshots());
+            if (renderTime <= newestTime + maxExtrapolation)
+            {
+                // Both interpolating between the snapshots and extrapolating past the newest one follow the motion
+                if (Abs(position - renderTime) > 0.001)
+                {
+                    if (renderTime <= newestTime)
+                        interpolated = false;
+                    else
+                        extrapolated = false;
+                }
+                // The server clock estimate only drifts slowly, so the node moves by about a frame's worth each frame
+                if (Abs(position - lastPosition - frameStep) > frameStep * 0.5f)
+                    smooth = false;
+            }
+            else if (numReceived == numUpdates)
+            {
+                // No more updates: past the extrapolation limit the node settles at the newest snapshot
+                settled = position == (float)newestTime && !transform->IsInProgress();
+            }
+        }
+        lastPosition = position;
+    }
+    URHO3D_CHECK(test, interpolated);
+    URHO3D_CHECK(test, extrapolated);
+    URHO3D_CHECK(test, smooth);
+    URHO3D_CHECK(test, settled);
+    // The buffer holds only the snapshots from the interpolation delay behind the newest one
+    URHO3D_CHECK(test, maxSnapshots > 1 && maxSnapshots <= 5);
+
+    // After the pause, a new update restarts the history at the render time from the previous snapshot
+    unsigned serverTimeMs = serverStartMs + numFrames * 1000 / 60;
+    float settledPosition = node->GetPosition().x_;
+    ReceivePosition(connection, node->GetID(), serverTimeMs, 0, Vector3(settledPosition + 0.1f, 0.0f, 0.0f));
+    URHO3D_CHECK(test, transform->GetNumSnapshots() == 2);
+    // Position and rotation of the same update share a snapshot
+    transform->SetTargetRotation(Quaternion(90.0f, Vector3::UP));
+    URHO3D_CHECK(test, transform->GetNumSnapshots() == 2);
+    // An update older than the newest snapshot arriving out of order is not buffered
+    ReceivePosition(connection, node->GetID(), serverTimeMs - sendIntervalMs, 0, Vector3(settledPosition, 0.0f, 0.0f));
+    URHO3D_CHECK(test, transform->GetNumSnapshots() == 2);
+    // A jump beyond the snap threshold discards the history
+    ReceivePosition(connection, node->GetID(), serverTimeMs + sendIntervalMs, 0,
+        Vector3(settledPosition + scene->GetSnapThreshold() * 2.0f, 0.0f, 0.0f));
+    URHO3D_CHECK(test, transform->GetNumSnapshots() == 1);
+
+    // Controls stay unacknowledged until the server echoes their timestamp in a scene update
+    AcknowledgementListener listener(context, connection);
+    unsigned char firstTimeStamp = connection->GetTimeStamp();
+    for (unsigned i = 0; i < 3; ++i)
+        SendControls(connection, i);
+    URHO3D_CHECK(test, connection->GetNumUnacknowledgedControls() == 3);
+    connection->ProcessAcknowledgedControls();
+    URHO3D_CHECK(test, listener.numEvents_ == 0);
+
+    ReceivePosition(connection, node->GetID(), serverTimeMs, (unsigned char)(firstTimeStamp + 1), Vector3::ZERO);
+    URHO3D_CHECK(test, connection->GetNumUnacknowledgedControls() == 1);
+    URHO3D_CHECK(test, connection->GetUnacknowledgedControls(0).buttons_ == 2);
+    URHO3D_CHECK(test, connection->GetAcknowledgedTimeStamp() == (unsigned char)(firstTimeStamp + 1));
+    connection->ProcessAcknowledgedControls();
+    URHO3D_CHECK(test, listener.numEvents_ == 1 && listener.timeStamp_ == (unsigned char)(firstTimeStamp + 1));
+
+    // Older or repeated acknowledgements fall outside the window of unacknowledged controls and are ignored
+    ReceivePosition(connection, node->GetID(), serverTimeMs, firstTimeStamp, Vector3::ZERO);
+    ReceivePosition(connection, node->GetID(), serverTimeMs, (unsigned char)(firstTimeStamp + 1), Vector3::ZERO);
+    URHO3D_CHECK(test, connection->GetNumUnacknowledgedControls() == 1);
+    connection->ProcessAcknowledgedControls();
+    URHO3D_CHECK(test, listener.numEvents_ == 1);
+
+    ReceivePosition(connection, node->GetID(), serverTimeMs, (unsigned char)(firstTimeStamp + 2), Vector3::ZERO);
+    URHO3D_CHECK(test, connection->GetNumUnacknowledgedControls() == 0);
+    connection->ProcessAcknowledgedControls();
+    URHO3D_CHECK(test, listener.numEvents_ == 2 && listener.timeStamp_ == (unsigned char)(firstTimeStamp + 2));
+
+    // The window keeps the latest controls and works across the wraparound of the 8-bit timestamp
+    for (unsigned i = 0; i < 300; ++i)
+        SendControls(connection, i);
+    unsigned numControls = connection->GetNumUnacknowledgedControls();
+    URHO3D_CHECK(test, numControls > 0 && numControls < 256);
+    URHO3D_CHECK(test, connection->GetUnacknowledgedControls(numControls - 1).buttons_ == 299);
+    auto oldest = (unsigned char)(connection->GetTimeStamp() - numControls);
+    ReceivePosition(connection, node->GetID(), serverTimeMs, (unsigned char)(oldest - 1), Vector3::ZERO);
+    URHO3D_CHECK(test, connection->GetNumUnacknowledgedControls() == numControls);
+    ReceivePosition(connection, node->GetID(), serverTimeMs, oldest, Vector3::ZERO);
+    URHO3D_CHECK(test, connection->GetNumUnacknowledgedControls() == numControls - 1);
+    ReceivePosition(connection, node->GetID(), serverTimeMs, (unsigned char)(connection->GetTimeStamp() - 1), Vector3::ZERO);
+    URHO3D_CHECK(test, connection->GetNumUnacknowledgedControls() == 0);
+    connection->ProcessAcknowledgedControls();
+    URHO3D_CHECK(test, listener.numEvents_ == 3 && listener.timeStamp_ == (unsigned char)(connection->GetTimeStamp() - 1));
+
+    return test.GetExitCode();
+}
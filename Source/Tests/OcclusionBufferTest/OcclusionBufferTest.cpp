@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Graphics/Camera.h>
+#include <Urho3D/Graphics/OcclusionBuffer.h>
+#include <Urho3D/Scene/Node.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+/// Vertex with a normal, so that the position stride is not tightly packed.
+struct OccluderVertex
+{
+    /// Position.
+    Vector3 position_;
+    /// Normal.
+    Vector3 normal_;
+};
+
+/// Draw the submitted triangles and return the time taken in microseconds.
+static long long Draw(OcclusionBuffer* buffer, const PODVector<OccluderVertex>& vertices, const PODVector<unsigned short>& indices)
+{
+    buffer->Clear();
+    if (indices.Empty())
+        buffer->AddTriangles(Matrix3x4::IDENTITY, &vertices[0], sizeof(OccluderVertex), 0, vertices.Size());
+    else
+    {
+        buffer->AddTriangles(Matrix3x4::IDENTITY, &vertices[0], sizeof(OccluderVertex), &indices[0], sizeof(unsigned short), 0,
+            indices.Size());
+    }
+
+    HiresTimer timer;
+    buffer->DrawTriangles();
+    return timer.GetUSec(false);
+}
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    Context* context = test.GetContext();
+    context->RegisterFactory<Camera>();
+
+    Node cameraNode(context);
+    auto* camera = cameraNode.CreateComponent<Camera>();
+    camera->SetFarClip(100.0f);
+
+    const int size = 256;
+    SharedPtr<OcclusionBuffer> buffer(new OcclusionBuffer(context));
+    buffer->SetSize(size, size, false);
+    buffer->SetView(camera);
+    buffer->SetMaxTriangles(M_MAX_UNSIGNED);
+    buffer->SetCullMode(CULL_NONE);
+
+    // A wavy grid in front of the camera which extends past the view edges, so that many triangles are clipped. The triangle
+    // count is not a multiple of the projection chunk size
+    const unsigned gridSize = 41;
+    PODVector<OccluderVertex> gridVertices;
+    for (unsigned y = 0; y <= gridSize; ++y)
+    {
+        for (unsigned x = 0; x <= gridSize; ++x)
+        {
+            OccluderVertex vertex;
+            vertex.position_ = Vector3(x - gridSize * 0.5f, y - gridSize * 0.5f, 10.0f + Sin(x * 40.0f) + Cos(y * 25.0f));
+            vertex.normal_ = Vector3::BACK;
+            gridVertices.Push(vertex);
+        }
+    }
+
+    PODVector<unsigned short> indices;
+    for (unsigned y = 0; y < gridSize; ++y)
+    {
+        for (unsigned x = 0; x < gridSize; ++x)
+        {
+            auto i = (unsigned short)(y * (gridSize + 1) + x);
+            indices.Push(i);
+            indices.Push((unsigned short)(i + gridSize + 1));
+            indices.Push((unsigned short)(i + 1));
+            indices.Push((unsigned short)(i + 1));
+            indices.Push((unsigned short)(i + gridSize + 1));
+            indices.Push((unsigned short)(i + gridSize + 2));
+        }
+    }
+
+    PODVector<OccluderVertex> vertices;
+    for (unsigned i = 0; i < indices.Size(); ++i)
+        vertices.Push(gridVertices[indices[i]]);
+
+    // The non-indexed batch projects its vertices in chunks. It must produce the same depth as the indexed batch, which
+    // transforms each triangle separately
+    const unsigned numIterations = 20;
+    long long nonIndexedTime = 0;
+    long long indexedTime = 0;
+    PODVector<int> nonIndexedDepth(size * size);
+    for (unsigned i = 0; i < numIterations; ++i)
+        nonIndexedTime += Draw(buffer, vertices, PODVector<unsigned short>());
+    memcpy(&nonIndexedDepth[0], buffer->GetBuffer(), size * size * sizeof(int));
+    for (unsigned i = 0; i < numIterations; ++i)
+        indexedTime += Draw(buffer, gridVertices, indices);
+
+    test.Report("Draw non-indexed occluder", nonIndexedTime, numIterations);
+    test.Report("Draw indexed occluder", indexedTime, numIterations);
+
+    unsigned numCovered = 0;
+    bool sameDepth = true;
+    for (int i = 0; i < size * size; ++i)
+    {
+        sameDepth &= nonIndexedDepth[i] == buffer->GetBuffer()[i];
+        if (nonIndexedDepth[i] < (int)OCCLUSION_Z_SCALE)
+            ++numCovered;
+    }
+    URHO3D_CHECK(test, numCovered == size * size);
+    URHO3D_CHECK(test, sameDepth);
+
+    return test.GetExitCode();
+}
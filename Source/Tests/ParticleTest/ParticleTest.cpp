@@ -0,0 +1,145 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/ParticleEffect.h>
+#include <Urho3D/Graphics/ParticleEmitter.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    Context* context = test.GetContext();
+    RegisterSceneLibrary(context);
+    RegisterGraphicsLibrary(context);
+
+    const unsigned numEmitters = 100;
+    const unsigned numParticles = 1000;
+    const unsigned numFrames = 60;
+    const float timeStep = 1.0f / 60.0f;
+
+    // An effect that keeps the emitters full, with the forces and color frames that the integration has to apply
+    SharedPtr<ParticleEffect> effect(new ParticleEffect(context));
+    effect->SetNumParticles(numParticles);
+    effect->SetUpdateInvisible(true);
+    effect->SetEmitterType(EMITTER_BOX);
+    effect->SetEmitterSize(Vector3::ONE);
+    effect->SetMinEmissionRate(2.0f * numParticles);
+    effect->SetMaxEmissionRate(2.0f * numParticles);
+    effect->SetMinTimeToLive(4.0f);
+    effect->SetMaxTimeToLive(5.0f);
+    effect->SetMinVelocity(1.0f);
+    effect->SetMaxVelocity(2.0f);
+    effect->SetConstantForce(Vector3(0.0f, -1.0f, 0.0f));
+    effect->SetDampingForce(0.5f);
+    effect->SetMinRotationSpeed(-90.0f);
+    effect->SetMaxRotationSpeed(90.0f);
+    effect->SetSizeAdd(0.1f);
+    effect->SetSizeMul(1.1f);
+    effect->AddColorFrame(ColorFrame(Color::WHITE, 0.0f));
+    effect->AddColorFrame(ColorFrame(Color::RED, 1.0f));
+    effect->AddColorFrame(ColorFrame(Color::TRANSPARENT_BLACK, 4.0f));
+
+    SharedPtr<Scene> scene(new Scene(context));
+    auto* octree = scene->CreateComponent<Octree>();
+    PODVector<ParticleEmitter*> emitters;
+    for (unsigned i = 0; i < numEmitters; ++i)
+    {
+        Node* node = scene->CreateChild();
+        node->SetPosition(Vector3((float)(i % 10) * 10.0f, 0.0f, (float)(i / 10) * 10.0f));
+        auto* emitter = node->CreateComponent<ParticleEmitter>();
+        emitter->SetEffect(effect);
+        emitters.Push(emitter);
+    }
+
+    FrameInfo frame;
+    frame.frameNumber_ = 0;
+    frame.timeStep_ = timeStep;
+    frame.viewSize_ = IntVector2(1920, 1080);
+    frame.camera_ = nullptr;
+
+    // Emit until the emitters are full, then measure the drawable update, which runs the emitters on the worker threads
+    for (unsigned i = 0; i < 60; ++i)
+    {
+        ++frame.frameNumber_;
+        scene->Update(timeStep);
+        octree->Update(frame);
+    }
+
+    unsigned numActive = 0;
+    for (unsigned i = 0; i < emitters.Size(); ++i)
+        numActive += emitters[i]->GetNumActiveParticles();
+    URHO3D_CHECK(test, numActive == numEmitters * numParticles);
+
+    long long usec = 0;
+    for (unsigned i = 0; i < numFrames; ++i)
+    {
+        ++frame.frameNumber_;
+        scene->Update(timeStep);
+        HiresTimer timer;
+        octree->Update(frame);
+        usec += timer.GetUSec(false);
+    }
+
+    unsigned numCores = test.GetSubsystem<WorkQueue>()->GetNumThreads() + 1;
+    double particlesPerMs = (double)numActive * numFrames / ((double)usec / 1000.0);
+    test.Report("100k particles, update", usec, numFrames);
+    printf("%-48s %12.0f\n", "Particles per ms per core", particlesPerMs / numCores);
+
+    // The simulated billboards must be enabled, finite and inside the reach of the effect
+    unsigned numInvalid = 0;
+    for (unsigned i = 0; i < emitters.Size(); ++i)
+    {
+        const PODVector<Billboard>& billboards = emitters[i]->GetBillboards();
+        // Relative effects simulate in the node's local space
+        const Vector3 origin = effect->IsRelative() ? Vector3::ZERO : emitters[i]->GetNode()->GetWorldPosition();
+        for (unsigned j = 0; j < billboards.Size(); ++j)
+        {
+            const Billboard& billboard = billboards[j];
+            if (!billboard.enabled_ || IsNaN(billboard.position_.x_) || (billboard.position_ - origin).Length() > 20.0f ||
+                billboard.size_.x_ <= 0.0f)
+                ++numInvalid;
+        }
+    }
+    URHO3D_CHECK(test, numInvalid == 0);
+
+    // Emission stopped: all particles expire and get disabled
+    for (unsigned i = 0; i < emitters.Size(); ++i)
+        emitters[i]->SetEmitting(false);
+    for (unsigned i = 0; i < 400; ++i)
+    {
+        ++frame.frameNumber_;
+        scene->Update(timeStep);
+        octree->Update(frame);
+    }
+    numActive = 0;
+    for (unsigned i = 0; i < emitters.Size(); ++i)
+        numActive += emitters[i]->GetNumActiveParticles();
+    URHO3D_CHECK(test, numActive == 0);
+
+    return test.GetExitCode();
+}
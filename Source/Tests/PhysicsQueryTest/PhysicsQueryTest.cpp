@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Math/Random.h>
+#include <Urho3D/Physics/CollisionShape.h>
+#include <Urho3D/Physics/PhysicsWorld.h>
+#include <Urho3D/Physics/RigidBody.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "UnitTest.h"
+
+#include <algorithm>
+
+using namespace Urho3D;
+
+/// Half size of the area the bodies are placed in.
+static const float AREA_SIZE = 50.0f;
+/// Collision layer of the bodies that the masked queries skip.
+static const unsigned SKIPPED_LAYER = 2;
+
+/// Return whether two raycast results are the same.
+static bool SameResult(const PhysicsRaycastResult& lhs, const PhysicsRaycastResult& rhs)
+{
+    return lhs.body_ == rhs.body_ && (!lhs.body_ || (lhs.distance_ == rhs.distance_ && lhs.position_ == rhs.position_ &&
+        lhs.normal_ == rhs.normal_));
+}
+
+/// Return whether all bodies of one list are contained in another.
+static bool ContainsAll(const RigidBody* const* start, const RigidBody* const* end, const PODVector<RigidBody*>& bodies)
+{
+    for (unsigned i = 0; i < bodies.Size(); ++i)
+    {
+        if (std::find(start, end, bodies[i]) == end)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    Context* context = test.GetContext();
+    RegisterSceneLibrary(context);
+    RegisterPhysicsLibrary(context);
+    SetRandomSeed(1);
+
+    // Unit boxes without rotation, so that the broadphase bounding boxes are easy to check
+    SharedPtr<Scene> scene(new Scene(context));
+    auto* world = scene->CreateComponent<PhysicsWorld>();
+    PODVector<RigidBody*> bodies;
+    for (unsigned i = 0; i < 2000; ++i)
+    {
+        Node* node = scene->CreateChild("Box");
+        node->SetPosition(Vector3(Random(-AREA_SIZE, AREA_SIZE), Random(0.0f, 10.0f), Random(-AREA_SIZE, AREA_SIZE)));
+        auto* body = node->CreateComponent<RigidBody>();
+        body->SetCollisionLayer(i % 2 ? SKIPPED_LAYER : 1);
+        node->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+        bodies.Push(body);
+    }
+    world->Simulate(1);
+
+    const unsigned numQueries = 10000;
+    PODVector<PhysicsRaycastQuery> queries(numQueries);
+    for (unsigned i = 0; i < numQueries; ++i)
+    {
+        PhysicsRaycastQuery& query = queries[i];
+        Vector3 origin(Random(-AREA_SIZE, AREA_SIZE), Random(0.0f, 10.0f), Random(-AREA_SIZE, AREA_SIZE));
+        Vector3 direction(Random(-1.0f, 1.0f), Random(-0.2f, 0.2f), Random(-1.0f, 1.0f));
+        query.ray_ = Ray(origin, direction);
+        query.maxDistance_ = Random(5.0f, 40.0f);
+        query.radius_ = i % 4 ? 0.0f : 0.25f;
+        query.collisionMask_ = i % 3 ? M_MAX_UNSIGNED : ~SKIPPED_LAYER;
+    }
+
+    // The batch returns the same closest hits as the single queries
+    PODVector<PhysicsRaycastResult> singleResults(numQueries);
+    HiresTimer timer;
+    for (unsigned i = 0; i < numQueries; ++i)
+    {
+        const PhysicsRaycastQuery& query = queries[i];
+        if (query.radius_ > 0.0f)
+            world->SphereCast(singleResults[i], query.ray_, query.radius_, query.maxDistance_, query.collisionMask_);
+        else
+            world->RaycastSingle(singleResults[i], query.ray_, query.maxDistance_, query.collisionMask_);
+    }
+    test.Report("Raycast, single queries", timer.GetUSec(false), numQueries);
+
+    PODVector<PhysicsRaycastResult> batchResults;
+    timer.Reset();
+    world->RaycastBatch(batchResults, queries);
+    test.Report("Raycast, batch", timer.GetUSec(false), numQueries);
+
+    URHO3D_CHECK(test, batchResults.Size() == numQueries);
+    unsigned numHits = 0;
+    unsigned numMismatches = 0;
+    bool masksRespected = true;
+    for (unsigned i = 0; i < numQueries && i < batchResults.Size(); ++i)
+    {
+        if (batchResults[i].body_)
+        {
+            ++numHits;
+            if (!(queries[i].collisionMask_ & batchResults[i].body_->GetCollisionLayer()))
+                masksRespected = false;
+        }
+        if (!SameResult(batchResults[i], singleResults[i]))
+            ++numMismatches;
+    }
+    printf("%u of %u queries hit, %u differ from the single queries\n", numHits, numQueries, numMismatches);
+    URHO3D_CHECK(test, numHits > numQueries / 10 && numHits < numQueries);
+    URHO3D_CHECK(test, numMismatches == 0);
+    URHO3D_CHECK(test, masksRespected);
+
+    // Small batches run inline and give the same results
+    PODVector<PhysicsRaycastQuery> smallQueries(queries.Buffer(), 10);
+    PODVector<PhysicsRaycastResult> smallResults;
+    world->RaycastBatch(smallResults, smallQueries);
+    bool smallSame = smallResults.Size() == smallQueries.Size();
+    for (unsigned i = 0; i < smallResults.Size(); ++i)
+        smallSame &= SameResult(smallResults[i], singleResults[i]);
+    URHO3D_CHECK(test, smallSame);
+
+    // Overlap queries return the bodies whose broadphase bounding boxes intersect the box. These include all bodies whose
+    // boxes intersect the query box, and only bodies within the box expanded by the body half size and the contact
+    // threshold. The exact box query also reports bodies within the collision margins, so it is only used for timing
+    PODVector<PhysicsOverlapQuery> overlapQueries(numQueries);
+    for (unsigned i = 0; i < numQueries; ++i)
+    {
+        Vector3 center(Random(-AREA_SIZE, AREA_SIZE), Random(0.0f, 10.0f), Random(-AREA_SIZE, AREA_SIZE));
+        Vector3 halfSize(Random(0.5f, 3.0f), Random(0.5f, 3.0f), Random(0.5f, 3.0f));
+        overlapQueries[i].box_ = BoundingBox(center - halfSize, center + halfSize);
+        overlapQueries[i].collisionMask_ = i % 3 ? M_MAX_UNSIGNED : ~SKIPPED_LAYER;
+    }
+
+    PODVector<RigidBody*> singleBodies;
+    unsigned numSingleBodies = 0;
+    timer.Reset();
+    for (unsigned i = 0; i < numQueries; ++i)
+    {
+        world->GetRigidBodies(singleBodies, overlapQueries[i].box_, overlapQueries[i].collisionMask_);
+        numSingleBodies += singleBodies.Size();
+    }
+    test.Report("Box overlap, single queries", timer.GetUSec(false), numQueries);
+
+    PODVector<RigidBody*> batchBodies;
+    PODVector<unsigned> offsets;
+    timer.Reset();
+    world->GetRigidBodiesBatch(batchBodies, offsets, overlapQueries);
+    test.Report("Box overlap, batch", timer.GetUSec(false), numQueries);
+
+    URHO3D_CHECK(test, offsets.Size() == numQueries + 1 && offsets.Back() == batchBodies.Size());
+    URHO3D_CHECK(test, batchBodies.Size() > numQueries && numSingleBodies > 0);
+    bool containsExact = true;
+    bool withinBounds = true;
+    PODVector<RigidBody*> exactBodies;
+    for (unsigned i = 0; i < numQueries && offsets.Size() == numQueries + 1; ++i)
+    {
+        const RigidBody* const* start = batchBodies.Buffer() + offsets[i];
+        const RigidBody* const* end = batchBodies.Buffer() + offsets[i + 1];
+        exactBodies.Clear();
+        for (unsigned j = 0; j < bodies.Size(); ++j)
+        {
+            const Vector3& position = bodies[j]->GetPosition();
+            BoundingBox bodyBox(position - Vector3(0.5f, 0.5f, 0.5f), position + Vector3(0.5f, 0.5f, 0.5f));
+            if (overlapQueries[i].box_.IsInside(bodyBox) != OUTSIDE &&
+                (overlapQueries[i].collisionMask_ & bodies[j]->GetCollisionLayer()))
+                exactBodies.Push(bodies[j]);
+        }
+        containsExact &= ContainsAll(start, end, exactBodies);
+
+        BoundingBox expanded = overlapQueries[i].box_;
+        expanded.min_ -= Vector3(0.6f, 0.6f, 0.6f);
+        expanded.max_ += Vector3(0.6f, 0.6f, 0.6f);
+        for (const RigidBody* const* j = start; j != end; ++j)
+        {
+            if (expanded.IsInside((*j)->GetPosition()) == OUTSIDE ||
+                !(overlapQueries[i].collisionMask_ & (*j)->GetCollisionLayer()))
+                withinBounds = false;
+        }
+    }
+    URHO3D_CHECK(test, containsExact);
+    URHO3D_CHECK(test, withinBounds);
+
+    // An empty batch gives an empty result with a single offset
+    world->GetRigidBodiesBatch(batchBodies, offsets, PODVector<PhysicsOverlapQuery>());
+    URHO3D_CHECK(test, batchBodies.Empty() && offsets.Size() == 1 && offsets[0] == 0);
+
+    return test.GetExitCode();
+}
@@ -0,0 +1,170 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Physics/CollisionShape.h>
+#include <Urho3D/Physics/PhysicsWorld.h>
+#include <Urho3D/Physics/RigidBody.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+/// Create a scene with a box stack, a compound body and a few fast spheres thrown at the stack.
+static SharedPtr<Scene> CreateTestScene(Context* context)
+{
+    SharedPtr<Scene> scene(new Scene(context));
+    auto* world = scene->CreateComponent<PhysicsWorld>();
+    world->SetDeterministic(true);
+
+    Node* groundNode = scene->CreateChild("Ground");
+    groundNode->SetPosition(Vector3(0.0f, -0.5f, 0.0f));
+    groundNode->SetScale(Vector3(100.0f, 1.0f, 100.0f));
+    groundNode->CreateComponent<RigidBody>();
+    groundNode->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+
+    for (int y = 0; y < 6; ++y)
+    {
+        for (int x = 0; x < 4; ++x)
+        {
+            for (int z = 0; z < 4; ++z)
+            {
+                Node* boxNode = scene->CreateChild("Box");
+                boxNode->SetPosition(Vector3(x * 1.05f - 1.5f, y + 0.5f, z * 1.05f - 1.5f));
+                auto* body = boxNode->CreateComponent<RigidBody>();
+                body->SetMass(1.0f);
+                body->SetFriction(0.75f);
+                boxNode->CreateComponent<CollisionShape>()->SetBox(Vector3::ONE);
+            }
+        }
+    }
+
+    // A body with two shapes, which has several contact manifolds against the ground
+    Node* compoundNode = scene->CreateChild("Compound");
+    compoundNode->SetPosition(Vector3(6.0f, 1.0f, 0.0f));
+    compoundNode->CreateComponent<RigidBody>()->SetMass(2.0f);
+    compoundNode->CreateComponent<CollisionShape>()->SetBox(Vector3(1.0f, 0.5f, 3.0f), Vector3(-1.0f, 0.0f, 0.0f));
+    compoundNode->CreateComponent<CollisionShape>()->SetSphere(1.0f, Vector3(1.0f, 0.0f, 0.0f));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        Node* sphereNode = scene->CreateChild("Sphere");
+        sphereNode->SetPosition(Vector3(-15.0f - i * 2.0f, 1.0f + i, (float)i - 1.5f));
+        auto* body = sphereNode->CreateComponent<RigidBody>();
+        body->SetMass(5.0f);
+        body->SetLinearVelocity(Vector3(12.0f, 2.0f, 0.0f));
+        sphereNode->CreateComponent<CollisionShape>()->SetSphere(1.0f);
+    }
+
+    return scene;
+}
+
+/// Simulate a number of fixed steps and record the transforms and velocities of all bodies after each step.
+static void Record(PhysicsWorld* world, unsigned numSteps, VectorBuffer& dest)
+{
+    PODVector<RigidBody*> bodies;
+    world->GetScene()->GetComponents<RigidBody>(bodies, true);
+
+    dest.Clear();
+    for (unsigned i = 0; i < numSteps; ++i)
+    {
+        world->Simulate(1);
+        for (unsigned j = 0; j < bodies.Size(); ++j)
+        {
+            dest.WriteVector3(bodies[j]->GetPosition());
+            dest.WriteQuaternion(bodies[j]->GetRotation());
+            dest.WriteVector3(bodies[j]->GetLinearVelocity());
+            dest.WriteVector3(bodies[j]->GetAngularVelocity());
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    Context* context = test.GetContext();
+    RegisterSceneLibrary(context);
+    RegisterPhysicsLibrary(context);
+
+    const unsigned numSettleSteps = 60;
+    const unsigned numReplaySteps = 180;
+    const unsigned numRollbackSteps = 8;
+    const unsigned numRollbackIterations = 20;
+    const long long frameBudgetUSec = 16667;
+
+    // Reference run without saving
+    SharedPtr<Scene> referenceScene = CreateTestScene(context);
+    auto* referenceWorld = referenceScene->GetComponent<PhysicsWorld>();
+    referenceWorld->Simulate(numSettleSteps);
+    VectorBuffer reference;
+    Record(referenceWorld, numReplaySteps, reference);
+
+    // Saving in the middle of the same run must not change it
+    SharedPtr<Scene> scene = CreateTestScene(context);
+    auto* world = scene->GetComponent<PhysicsWorld>();
+    world->Simulate(numSettleSteps);
+    VectorBuffer state;
+    HiresTimer timer;
+    world->SaveState(state);
+    test.Report("Save physics state", timer.GetUSec(false));
+    VectorBuffer live;
+    Record(world, numReplaySteps, live);
+    URHO3D_CHECK(test, live.GetBuffer() == reference.GetBuffer());
+
+    // Each replay from the saved state must be bitwise identical
+    VectorBuffer replays[2];
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        state.Seek(0);
+        timer.Reset();
+        URHO3D_CHECK(test, world->RestoreState(state));
+        test.Report("Restore physics state", timer.GetUSec(false));
+        Record(world, numReplaySteps, replays[i]);
+    }
+    URHO3D_CHECK(test, replays[0].GetBuffer() == replays[1].GetBuffer());
+
+    // The restored contact points and the canonical solver order of the deterministic mode make the replay bitwise identical
+    // to the original run over all steps
+    URHO3D_CHECK(test, replays[0].GetBuffer() == live.GetBuffer());
+
+    // A rollback restores the state and simulates the frames since again, which must fit in one frame
+    timer.Reset();
+    for (unsigned i = 0; i < numRollbackIterations; ++i)
+    {
+        state.Seek(0);
+        world->RestoreState(state);
+        world->Simulate(numRollbackSteps);
+    }
+    long long rollbackUSec = timer.GetUSec(false);
+    test.Report("Restore physics state and simulate 8 steps", rollbackUSec, numRollbackIterations);
+    URHO3D_CHECK(test, rollbackUSec < frameBudgetUSec * numRollbackIterations);
+
+    // Saving again after restoring gives the same state
+    state.Seek(0);
+    world->RestoreState(state);
+    VectorBuffer resaved;
+    world->SaveState(resaved);
+    URHO3D_CHECK(test, resaved.GetBuffer() == state.GetBuffer());
+
+    return test.GetExitCode();
+}
@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/Light.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/StaticModel.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Scene/CompiledScene.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+/// Create a level with unique node transforms and mostly identical components, like a placed prop field.
+static void CreateLevel(Scene* scene, unsigned numNodes)
+{
+    scene->CreateComponent<Octree>();
+
+    unsigned seed = 0x9e3779b9u;
+    for (unsigned i = 0; i < numNodes; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        Node* parent = (i % 10 && scene->GetNumChildren()) ? scene->GetChildren().Back().Get() : scene;
+        Node* node = parent->CreateChild("Prop");
+        node->SetPosition(Vector3((float)(seed & 0xffu), (float)((seed >> 8u) & 0xffu), (float)(seed >> 16u)));
+        node->SetRotation(Quaternion((float)(seed % 360), Vector3::UP));
+
+        auto* model = node->CreateComponent<StaticModel>();
+        model->SetCastShadows(true);
+        if (i % 8 == 0)
+        {
+            auto* light = node->CreateComponent<Light>();
+            light->SetRange(10.0f + (float)(i % 3));
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    Context* context = test.GetContext();
+    RegisterSceneLibrary(context);
+    RegisterGraphicsLibrary(context);
+
+    const unsigned numNodes = 50000;
+    const unsigned iterations = 3;
+
+    SharedPtr<Scene> scene(new Scene(context));
+    CreateLevel(scene, numNodes);
+
+    VectorBuffer binary;
+    VectorBuffer xml;
+    VectorBuffer compiled;
+    URHO3D_CHECK(test, scene->Save(binary));
+    URHO3D_CHECK(test, scene->SaveXML(xml));
+    URHO3D_CHECK(test, scene->SaveCompiled(compiled));
+    printf("Scene sizes: binary %u, XML %u, compiled %u bytes\n", binary.GetSize(), xml.GetSize(), compiled.GetSize());
+
+    // Each load goes to a fresh scene so that removing the previous contents is not measured
+    SharedPtr<Scene> loaded;
+    long long usec[4] = {};
+    HiresTimer timer;
+    for (unsigned i = 0; i < iterations; ++i)
+    {
+        for (unsigned format = 0; format < 4; ++format)
+        {
+            loaded = new Scene(context);
+            binary.Seek(0);
+            xml.Seek(0);
+            compiled.Seek(0);
+            timer.Reset();
+            if (format == 0)
+                loaded->Load(binary);
+            else if (format == 1)
+                loaded->LoadXML(xml);
+            else if (format == 2)
+                loaded->LoadCompiled(compiled);
+            else
+            {
+                // The data of a memory-mapped file is loaded in place
+                loaded->LoadCompiled(compiled.GetData(), compiled.GetSize());
+            }
+            usec[format] += timer.GetUSec(false);
+        }
+    }
+    test.Report("Binary scene load", usec[0], iterations);
+    test.Report("XML scene load", usec[1], iterations);
+    test.Report("Compiled scene load", usec[2], iterations);
+    test.Report("Compiled scene load from memory", usec[3], iterations);
+
+    // The compiled scene must load to the same state as the binary scene
+    VectorBuffer resaved;
+    URHO3D_CHECK(test, loaded->Save(resaved));
+    URHO3D_CHECK(test, loaded->GetNumChildren(true) == scene->GetNumChildren(true));
+    URHO3D_CHECK(test, resaved.GetSize() == binary.GetSize() && !memcmp(resaved.GetData(), binary.GetData(), binary.GetSize()));
+
+    // Stopping a threaded asynchronous load must wait for the worker thread reading the file, at any point of the read
+    auto* fileSystem = test.GetSubsystem<FileSystem>();
+    String fileName = fileSystem->GetProgramDir() + "SceneLoadTest.bin";
+    {
+        File file(context, fileName, FILE_WRITE);
+        URHO3D_CHECK(test, scene->Save(file));
+    }
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        SharedPtr<File> file(new File(context, fileName));
+        URHO3D_CHECK(test, loaded->LoadAsync(file));
+        Time::Sleep(i);
+        loaded->StopAsyncLoading();
+        URHO3D_CHECK(test, !loaded->IsAsyncLoading());
+    }
+    fileSystem->Delete(fileName);
+
+    // Attribute loading alone: Serializable::Load() from the binary component data versus the compiled attribute blocks,
+    // where the identical blocks are decoded once
+    PODVector<StaticModel*> models;
+    scene->GetComponents<StaticModel>(models, true);
+    Vector<VectorBuffer> modelData(models.Size());
+    CompiledSceneWriter writer;
+    PODVector<unsigned> blocks(models.Size());
+    unsigned typeIndex = 0;
+    for (unsigned i = 0; i < models.Size(); ++i)
+    {
+        models[i]->Save(modelData[i]);
+        bool typeCompiled;
+        typeIndex = writer.AddType(models[i], typeCompiled);
+        URHO3D_CHECK(test, typeCompiled);
+        blocks[i] = writer.AddAttributes(models[i], typeIndex);
+    }
+    VectorBuffer modelCompiled;
+    writer.Write(modelCompiled);
+
+    timer.Reset();
+    for (unsigned i = 0; i < models.Size(); ++i)
+    {
+        // Skip the type and ID in front of the attributes
+        modelData[i].Seek(2 * sizeof(unsigned));
+        models[i]->Load(modelData[i]);
+    }
+    test.Report("Binary attribute load per component", timer.GetUSec(true), models.Size());
+
+    CompiledSceneReader reader;
+    URHO3D_CHECK(test, reader.Open(modelCompiled.GetData(), modelCompiled.GetSize()));
+    timer.Reset();
+    for (unsigned i = 0; i < models.Size(); ++i)
+        reader.LoadAttributes(models[i], typeIndex, blocks[i]);
+    test.Report("Compiled attribute load per component", timer.GetUSec(true), models.Size());
+    URHO3D_CHECK(test, reader.GetNumBlocks() == 1);
+
+    // Corrupt data must be rejected without crashing
+    VectorBuffer truncated;
+    truncated.Write(compiled.GetData(), compiled.GetSize() / 2);
+    truncated.Seek(0);
+    loaded->LoadCompiled(truncated);
+
+    return test.GetExitCode();
+}
@@ -0,0 +1,187 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifdef URHO3D_ANGELSCRIPT
+#include <Urho3D/AngelScript/Script.h>
+#include <Urho3D/AngelScript/ScriptFile.h>
+#include <Urho3D/AngelScript/ScriptInstance.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#endif
+#include <Urho3D/Scene/LogicComponent.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SceneEvents.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+/// Total number of logic component updates.
+static unsigned numUpdates = 0;
+
+/// Minimal logic component that moves its node.
+class TestLogic : public LogicComponent
+{
+    URHO3D_OBJECT(TestLogic, LogicComponent);
+
+public:
+    /// Construct.
+    explicit TestLogic(Context* context) :
+        LogicComponent(context)
+    {
+        SetUpdateEventMask(USE_UPDATE);
+    }
+
+    /// Handle scene update.
+    void Update(float timeStep) override
+    {
+        node_->Translate(Vector3(timeStep, 0.0f, 0.0f));
+        ++numUpdates;
+    }
+};
+
+/// Event handler that records how many component updates had happened when the scene update event was sent.
+class UpdateOrderChecker : public Object
+{
+    URHO3D_OBJECT(UpdateOrderChecker, Object);
+
+public:
+    /// Construct.
+    UpdateOrderChecker(Context* context, Scene* scene) :
+        Object(context),
+        updatesBeforeEvent_(0)
+    {
+        SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(UpdateOrderChecker, HandleSceneUpdate));
+    }
+
+    /// Handle scene update event.
+    void HandleSceneUpdate(StringHash eventType, VariantMap& eventData) { updatesBeforeEvent_ = numUpdates; }
+
+    /// Number of component updates done before the event.
+    unsigned updatesBeforeEvent_;
+};
+
+#ifdef URHO3D_ANGELSCRIPT
+/// Event handler that records the position of a scripted node when the scene update event was sent.
+class ScriptOrderChecker : public Object
+{
+    URHO3D_OBJECT(ScriptOrderChecker, Object);
+
+public:
+    /// Construct.
+    ScriptOrderChecker(Context* context, Scene* scene, Node* node) :
+        Object(context),
+        node_(node),
+        positionAtEvent_(0.0f)
+    {
+        SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(ScriptOrderChecker, HandleSceneUpdate));
+    }
+
+    /// Handle scene update event.
+    void HandleSceneUpdate(StringHash eventType, VariantMap& eventData) { positionAtEvent_ = node_->GetPosition().x_; }
+
+    /// Scripted node.
+    Node* node_;
+    /// X position of the node at the time of the event.
+    float positionAtEvent_;
+};
+
+/// Script object that moves its node by one unit per update.
+static const char* moverScript =
+    "class Mover : ScriptObject\n"
+    "{\n"
+    "    void Update(float timeStep)\n"
+    "    {\n"
+    "        node.Translate(Vector3(1.0f, 0.0f, 0.0f));\n"
+    "    }\n"
+    "}\n";
+#endif
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    Context* context = test.GetContext();
+    RegisterSceneLibrary(context);
+    context->RegisterFactory<TestLogic>();
+
+    const unsigned numComponents = 50000;
+    const unsigned numFrames = 20;
+    const float timeStep = 1.0f / 60.0f;
+
+    for (unsigned eventDispatch = 0; eventDispatch < 2; ++eventDispatch)
+    {
+        SharedPtr<Scene> scene(new Scene(context));
+        // Subscribe to the scene update event before the components exist
+        SharedPtr<UpdateOrderChecker> checker(new UpdateOrderChecker(context, scene));
+        for (unsigned i = 0; i < numComponents; ++i)
+        {
+            auto* logic = scene->CreateChild()->CreateComponent<TestLogic>();
+            if (eventDispatch)
+                logic->SetUpdateEventMask(USE_UPDATE | USE_EVENTDISPATCH);
+        }
+
+        // The first update calls DelayedStart(), measure the following ones
+        scene->Update(timeStep);
+
+        numUpdates = 0;
+        HiresTimer timer;
+        for (unsigned i = 0; i < numFrames; ++i)
+            scene->Update(timeStep);
+        test.Report(eventDispatch ? "50k logic components, event dispatch" : "50k logic components, direct calls",
+            timer.GetUSec(false), numFrames);
+
+        URHO3D_CHECK(test, numUpdates == numComponents * numFrames);
+        // Directly called components are updated before the scene update event is sent. Event dispatched components are
+        // updated in subscription order, so after the handler that subscribed first
+        if (eventDispatch)
+            URHO3D_CHECK(test, checker->updatesBeforeEvent_ == numComponents * (numFrames - 1));
+        else
+            URHO3D_CHECK(test, checker->updatesBeforeEvent_ == numComponents * numFrames);
+    }
+
+#ifdef URHO3D_ANGELSCRIPT
+    // Script objects are called directly by default as well, and can opt out to be ordered by event subscription
+    context->RegisterSubsystem(new Script(context));
+    SharedPtr<ScriptFile> scriptFile(new ScriptFile(context));
+    scriptFile->SetName("Mover.as");
+    MemoryBuffer scriptSource(moverScript, (unsigned)strlen(moverScript));
+    if (URHO3D_CHECK(test, scriptFile->Load(scriptSource)))
+    {
+        for (unsigned eventDispatch = 0; eventDispatch < 2; ++eventDispatch)
+        {
+            SharedPtr<Scene> scene(new Scene(context));
+            Node* node = scene->CreateChild();
+            SharedPtr<ScriptOrderChecker> checker(new ScriptOrderChecker(context, scene, node));
+            auto* instance = node->CreateComponent<ScriptInstance>();
+            instance->CreateObject(scriptFile, "Mover");
+            instance->SetEventDispatch(eventDispatch != 0);
+
+            for (unsigned i = 0; i < numFrames; ++i)
+                scene->Update(timeStep);
+
+            URHO3D_CHECK(test, node->GetPosition().x_ == (float)numFrames);
+            URHO3D_CHECK(test, checker->positionAtEvent_ == (float)(eventDispatch ? numFrames - 1 : numFrames));
+        }
+    }
+#endif
+
+    return test.GetExitCode();
+}
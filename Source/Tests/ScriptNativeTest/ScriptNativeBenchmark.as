@@ -0,0 +1,88 @@
+// Numeric script functions for comparing interpreted and natively translated throughput
+
+#pragma jit
+
+double SumSquares(int count)
+{
+    int sum = 0;
+    for (int i = 0; i < count; ++i)
+        sum += (i * i) % 7;
+    return sum;
+}
+
+double Oscillate(int steps)
+{
+    float position = 1.0;
+    float velocity = 0.0;
+    const float timeStep = 0.001;
+    for (int i = 0; i < steps; ++i)
+    {
+        velocity -= position * 4.0 * timeStep;
+        position += velocity * timeStep;
+    }
+    return position;
+}
+
+double CountPrimes(int limit)
+{
+    int count = 0;
+    for (int n = 2; n < limit; ++n)
+    {
+        bool prime = true;
+        for (int d = 2; d * d <= n; ++d)
+        {
+            if (n % d == 0)
+            {
+                prime = false;
+                break;
+            }
+        }
+        if (prime)
+            ++count;
+    }
+    return count;
+}
+
+double Mandelbrot(int size)
+{
+    int inside = 0;
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            double cr = 3.0 * x / size - 2.0;
+            double ci = 2.0 * y / size - 1.0;
+            double zr = 0.0;
+            double zi = 0.0;
+            int i = 0;
+            while (i < 50 && zr * zr + zi * zi < 4.0)
+            {
+                double t = zr * zr - zi * zi + cr;
+                zi = 2.0 * zr * zi + ci;
+                zr = t;
+                ++i;
+            }
+            if (i == 50)
+                ++inside;
+        }
+    }
+    return inside;
+}
+
+double Hash(int count)
+{
+    uint hash = 2166136261;
+    int64 total = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        hash = (hash ^ uint(i & 0xff)) * 16777619;
+        hash ^= hash >> 13;
+        total += int64(hash % 1000) - 500;
+    }
+    return double(total);
+}
+
+double Divide(int divisor)
+{
+    return 100 / divisor;
+}
@@ -0,0 +1,185 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/AngelScript/Script.h>
+#include <Urho3D/AngelScript/ScriptFile.h>
+#include <Urho3D/AngelScript/ScriptNativeCompiler.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+// Defined in the translation of the benchmark script generated by ScriptCompiler during the build
+void RegisterScriptNativeBenchmark(ScriptNativeCompiler* compiler);
+
+/// Benchmark function and its argument.
+struct Benchmark
+{
+    /// Function declaration.
+    const char* declaration_;
+    /// Argument.
+    int argument_;
+};
+
+/// Load a script module from source or bytecode.
+static SharedPtr<ScriptFile> LoadScript(Context* context, const String& name, const String& source)
+{
+    SharedPtr<ScriptFile> script(new ScriptFile(context));
+    script->SetName(name);
+    MemoryBuffer buffer(source.CString(), source.Length());
+    script->Load(buffer);
+    return script;
+}
+
+/// Execute a function with one int argument. Return true and the result if the execution finished.
+static bool Execute(asIScriptContext* scriptContext, ScriptFile* script, const char* declaration, int argument, double& result)
+{
+    asIScriptFunction* function = script->GetFunction(declaration);
+    if (!function || scriptContext->Prepare(function) < 0)
+        return false;
+    scriptContext->SetArgDWord(0, (asDWORD)argument);
+    if (scriptContext->Execute() != asEXECUTION_FINISHED)
+        return false;
+    result = scriptContext->GetReturnDouble();
+    return true;
+}
+
+/// Line callback that counts its calls.
+static void CountLineCallbacks(asIScriptContext* scriptContext, unsigned* count)
+{
+    ++*count;
+}
+
+int main(int argc, char** argv)
+{
+    // The compiled functions are released through the JIT compiler, so it has to outlive the script subsystem
+    ScriptNativeCompiler compiler;
+    UnitTest test;
+    Context* context = test.GetContext();
+    context->RegisterSubsystem(new Script(context));
+    auto* script = context->GetSubsystem<Script>();
+    asIScriptEngine* engine = script->GetScriptEngine();
+    asIScriptContext* scriptContext = engine->CreateContext();
+
+    File file(context, BENCHMARK_SCRIPT);
+    String source = file.ReadString();
+
+    static const Benchmark benchmarks[] =
+    {
+        {"double SumSquares(int)", 1000000},
+        {"double Oscillate(int)", 1000000},
+        {"double CountPrimes(int)", 50000},
+        {"double Mandelbrot(int)", 200},
+        {"double Hash(int)", 1000000}
+    };
+    const unsigned numBenchmarks = sizeof benchmarks / sizeof benchmarks[0];
+    const unsigned numFunctions = numBenchmarks + 1;
+    const unsigned iterations = 5;
+
+    // Without a JIT compiler the module is interpreted
+    SharedPtr<ScriptFile> interpreted = LoadScript(context, "Interpreted", source);
+    URHO3D_CHECK(test, interpreted->IsCompiled());
+    URHO3D_CHECK(test, interpreted->IsJITCompile());
+
+    RegisterScriptNativeBenchmark(&compiler);
+    script->SetJITCompiler(&compiler);
+
+    // Each script function is linked to its translation
+    SharedPtr<ScriptFile> native = LoadScript(context, "Native", source);
+    URHO3D_CHECK(test, native->IsCompiled());
+    URHO3D_CHECK(test, compiler.GetNumCompiledFunctions() == numFunctions);
+
+    // The translations are linked when the module is loaded from bytecode as well
+    VectorBuffer byteCode;
+    URHO3D_CHECK(test, native->SaveByteCode(byteCode));
+    URHO3D_CHECK(test, String((const char*)byteCode.GetData(), 4) == "ASBJ");
+    SharedPtr<ScriptFile> loaded(new ScriptFile(context));
+    loaded->SetName("Loaded");
+    byteCode.Seek(0);
+    URHO3D_CHECK(test, loaded->Load(byteCode));
+    URHO3D_CHECK(test, loaded->IsJITCompile());
+    URHO3D_CHECK(test, compiler.GetNumCompiledFunctions() == numFunctions * 2);
+
+    // A function whose script has changed since it was translated stays interpreted
+    SharedPtr<ScriptFile> changed = LoadScript(context, "Changed", source.Replaced("(i * i) % 7", "(i * i) % 5"));
+    URHO3D_CHECK(test, changed->IsCompiled());
+    URHO3D_CHECK(test, compiler.GetNumCompiledFunctions() == numFunctions * 3 - 1);
+
+    // Modules that are not marked stay interpreted
+    SharedPtr<ScriptFile> unmarked = LoadScript(context, "Unmarked", source.Replaced("#pragma jit", ""));
+    URHO3D_CHECK(test, unmarked->IsCompiled());
+    URHO3D_CHECK(test, !unmarked->IsJITCompile());
+    URHO3D_CHECK(test, compiler.GetNumCompiledFunctions() == numFunctions * 3 - 1);
+
+    // The translations return to the virtual machine to raise script exceptions
+    double result = 0.0;
+    URHO3D_CHECK(test, Execute(scriptContext, native, "double Divide(int)", 4, result) && result == 25.0);
+    URHO3D_CHECK(test, !Execute(scriptContext, native, "double Divide(int)", 0, result));
+    URHO3D_CHECK(test, scriptContext->GetState() == asEXECUTION_EXCEPTION);
+
+    // With a line callback the translations return to the virtual machine to call it at the same points as it would
+    unsigned numInterpretedCallbacks = 0;
+    unsigned numNativeCallbacks = 0;
+    double expected = 0.0;
+    scriptContext->SetLineCallback(asFUNCTION(CountLineCallbacks), &numInterpretedCallbacks, asCALL_CDECL);
+    URHO3D_CHECK(test, Execute(scriptContext, interpreted, "double CountPrimes(int)", 1000, expected));
+    scriptContext->SetLineCallback(asFUNCTION(CountLineCallbacks), &numNativeCallbacks, asCALL_CDECL);
+    URHO3D_CHECK(test, Execute(scriptContext, native, "double CountPrimes(int)", 1000, result) && result == expected);
+    URHO3D_CHECK(test, numInterpretedCallbacks > 0 && numNativeCallbacks == numInterpretedCallbacks);
+    scriptContext->ClearLineCallback();
+
+    long long interpretedUSec = 0;
+    long long nativeUSec = 0;
+    for (unsigned i = 0; i < numBenchmarks; ++i)
+    {
+        const Benchmark& benchmark = benchmarks[i];
+        // The translations must give bitwise the same results as the virtual machine
+        URHO3D_CHECK(test, Execute(scriptContext, interpreted, benchmark.declaration_, benchmark.argument_, expected));
+        URHO3D_CHECK(test, Execute(scriptContext, native, benchmark.declaration_, benchmark.argument_, result) && result == expected);
+        URHO3D_CHECK(test, Execute(scriptContext, loaded, benchmark.declaration_, benchmark.argument_, result) && result == expected);
+        URHO3D_CHECK(test, Execute(scriptContext, changed, benchmark.declaration_, benchmark.argument_, result) &&
+            (result == expected) == (i != 0));
+
+        HiresTimer timer;
+        for (unsigned j = 0; j < iterations; ++j)
+            Execute(scriptContext, interpreted, benchmark.declaration_, benchmark.argument_, result);
+        long long usec = timer.GetUSec(true);
+        interpretedUSec += usec;
+        test.Report((String("Interpreted ") + benchmark.declaration_).CString(), usec, iterations);
+
+        for (unsigned j = 0; j < iterations; ++j)
+            Execute(scriptContext, native, benchmark.declaration_, benchmark.argument_, result);
+        usec = timer.GetUSec(true);
+        nativeUSec += usec;
+        test.Report((String("Native ") + benchmark.declaration_).CString(), usec, iterations);
+    }
+
+    test.Report("Interpreted total", interpretedUSec, iterations);
+    test.Report("Native total", nativeUSec, iterations);
+    URHO3D_CHECK(test, nativeUSec < interpretedUSec);
+
+    scriptContext->Release();
+    return test.GetExitCode();
+}
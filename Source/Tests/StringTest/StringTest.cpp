@@ -0,0 +1,221 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Container/StringArena.h>
+#include <Urho3D/Core/StringHashRegister.h>
+
+#include "UnitTest.h"
+
+#include <atomic>
+#include <new>
+
+using namespace Urho3D;
+
+/// Number of global operator new calls.
+static std::atomic<unsigned> numAllocations(0);
+
+void* operator new(size_t size)
+{
+    ++numAllocations;
+    if (void* ptr = malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+/// Report the time and the number of allocations per iteration of a benchmark, then return the allocations per iteration.
+template <class T> static float Benchmark(const UnitTest& test, const char* name, unsigned iterations, T function)
+{
+    unsigned startAllocations = numAllocations;
+    HiresTimer timer;
+    for (unsigned i = 0; i < iterations; ++i)
+        function(i);
+    long long usec = timer.GetUSec(false);
+    float allocations = (float)(numAllocations - startAllocations) / (float)iterations;
+
+    test.Report(name, usec, iterations);
+    printf("%-48s %12.2f allocations\n", "", allocations);
+    return allocations;
+}
+
+int main(int argc, char** argv)
+{
+    // No worker threads, so that the allocation counts only cover the measured code
+    UnitTest test(0);
+    const unsigned numIterations = 100000;
+    const char* shortText = "Position";
+    const char* longText = "Model/Materials/TerrainDetail/Stone.xml";
+    const String shortString(shortText);
+    const String longString(longText);
+    volatile unsigned sink = 0;
+
+    URHO3D_CHECK(test, shortString.IsInline());
+    URHO3D_CHECK(test, !longString.IsInline() && !longString.IsArena());
+
+    // Short strings must not allocate when constructed, copied, appended to or passed by value
+    URHO3D_CHECK(test, Benchmark(test, "Construct short string", numIterations, [&](unsigned) {
+        String str(shortText);
+        sink = sink + str.Length();
+    }) == 0.0f);
+    URHO3D_CHECK(test, Benchmark(test, "Copy short string", numIterations, [&](unsigned) {
+        String str(shortString);
+        sink = sink + str.Length();
+    }) == 0.0f);
+    URHO3D_CHECK(test, Benchmark(test, "Concatenate short strings", numIterations, [&](unsigned) {
+        String str = String("Tag") + "_" + "Enemy";
+        sink = sink + str.Length();
+    }) == 0.0f);
+
+    URHO3D_CHECK(test, Benchmark(test, "Construct long string", numIterations, [&](unsigned) {
+        String str(longText);
+        sink = sink + str.Length();
+    }) == 1.0f);
+    URHO3D_CHECK(test, Benchmark(test, "Copy long string", numIterations, [&](unsigned) {
+        String str(longString);
+        sink = sink + str.Length();
+    }) == 1.0f);
+    URHO3D_CHECK(test, Benchmark(test, "Move long string", numIterations, [&](unsigned) {
+        String str(longString);
+        String moved(std::move(str));
+        sink = sink + moved.Length();
+    }) == 1.0f);
+
+    // Appending onto a temporary must not create a new string per operator
+    const String prefix("Data/Textures/");
+    float chainAllocations = Benchmark(test, "Concatenate onto temporary", numIterations, [&](unsigned) {
+        String str = String(prefix) + longString + "." + shortString;
+        sink = sink + str.Length();
+    });
+    float copyAllocations = Benchmark(test, "Concatenate with copies", numIterations, [&](unsigned) {
+        String str = prefix + longString;
+        str = str + ".";
+        str = str + shortString;
+        sink = sink + str.Length();
+    });
+    URHO3D_CHECK(test, chainAllocations <= 2.0f);
+    URHO3D_CHECK(test, chainAllocations < copyAllocations);
+
+    // Interning returns one shared copy and does not allocate once the string is in the table
+    const String& interned = InternString(longString);
+    URHO3D_CHECK(test, interned == longString && &interned != &longString);
+    URHO3D_CHECK(test, Benchmark(test, "Intern existing string", numIterations, [&](unsigned) {
+        const String& str = InternString(longString);
+        sink = sink + (&str == &interned ? 1 : 0);
+    }) == 0.0f);
+    URHO3D_CHECK(test, &InternString(String(longText)) == &interned);
+
+    // Strings with colliding hashes get stored copies of their own, which outlive the temporary arguments
+    URHO3D_CHECK(test, StringHash("AttrkhWfQr") == StringHash("AttrRwyikC"));
+    const String& first = InternString(String("AttrkhWfQr"));
+    const String& second = InternString(String("AttrRwyikC"));
+    URHO3D_CHECK(test, first == "AttrkhWfQr" && second == "AttrRwyikC");
+    URHO3D_CHECK(test, &InternString(String("AttrRwyikC")) == &second);
+
+    // Arena strings allocate per block instead of per string
+    {
+        StringArena arena;
+        Vector<String> strings(numIterations);
+        unsigned startAllocations = numAllocations;
+        HiresTimer timer;
+        for (unsigned i = 0; i < numIterations; ++i)
+            arena.Assign(strings[i], longString);
+        test.Report("Assign long string from arena", timer.GetUSec(false), numIterations);
+        // One allocation per block, plus the occasional growth of the block list
+        URHO3D_CHECK(test, numAllocations - startAllocations <= 2 * arena.GetNumBlocks());
+        URHO3D_CHECK(test, arena.GetNumBlocks() < numIterations / 100);
+        URHO3D_CHECK(test, arena.GetUsedSize() == numIterations * (longString.Length() + 1));
+
+        bool allValid = true;
+        for (unsigned i = 0; i < numIterations; ++i)
+            allValid &= strings[i].IsArena() && strings[i] == longString;
+        URHO3D_CHECK(test, allValid);
+
+        Vector<String> heapStrings(numIterations);
+        startAllocations = numAllocations;
+        timer.Reset();
+        for (unsigned i = 0; i < numIterations; ++i)
+            heapStrings[i] = longString;
+        test.Report("Assign long string to heap", timer.GetUSec(false), numIterations);
+        URHO3D_CHECK(test, numAllocations - startAllocations == numIterations);
+
+        // Short strings stay inline also when assigned from the arena
+        String shortArena;
+        arena.Assign(shortArena, shortString);
+        URHO3D_CHECK(test, shortArena.IsInline() && shortArena == shortString);
+
+        // Copies go to the heap, while moves and swaps keep the arena buffer
+        String copy(strings[0]);
+        URHO3D_CHECK(test, !copy.IsArena() && copy == longString);
+        String moved(std::move(strings[1]));
+        URHO3D_CHECK(test, moved.IsArena() && moved == longString && strings[1].Empty());
+        moved.Swap(copy);
+        URHO3D_CHECK(test, copy.IsArena() && !moved.IsArena() && copy == moved);
+
+        // Shrinking stays in the arena buffer, growing or compacting to the inline buffer leaves it
+        strings[2].Resize(10);
+        URHO3D_CHECK(test, strings[2].IsArena() && strings[2] == longString.Substring(0, 10));
+        strings[3] += "/Extra";
+        URHO3D_CHECK(test, !strings[3].IsArena() && strings[3] == longString + "/Extra");
+        strings[4].Resize(4);
+        strings[4].Reserve(5);
+        URHO3D_CHECK(test, strings[4].IsInline() && strings[4] == longString.Substring(0, 4));
+        strings[5].Compact();
+        URHO3D_CHECK(test, strings[5].IsArena());
+
+        // Reassigning from the arena replaces a heap buffer
+        arena.Assign(heapStrings[0], "Another/Long/Resource/Name.xml");
+        URHO3D_CHECK(test, heapStrings[0].IsArena() && heapStrings[0] == "Another/Long/Resource/Name.xml");
+
+        // Strings must be released before the arena is cleared
+        strings.Clear();
+        heapStrings.Clear();
+        copy.Clear();
+        arena.Clear();
+        URHO3D_CHECK(test, arena.GetNumBlocks() == 0 && arena.GetUsedSize() == 0);
+    }
+
+    return test.GetExitCode();
+}
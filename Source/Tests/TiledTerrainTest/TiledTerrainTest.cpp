@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/Terrain.h>
+#include <Urho3D/Graphics/TiledTerrain.h>
+#include <Urho3D/Resource/Image.h>
+#include <Urho3D/Resource/XMLFile.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "UnitTest.h"
+
+using namespace Urho3D;
+
+/// Run frames until the terrain has no tile loads in progress.
+static void RunFrames(UnitTest& test, Scene* scene, TiledTerrain* terrain, unsigned minFrames)
+{
+    auto* cache = test.GetSubsystem<ResourceCache>();
+    VariantMap eventData;
+    eventData[BeginFrame::P_TIMESTEP] = 1.0f / 60.0f;
+
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        // The resource cache finishes background loaded resources at the beginning of the frame
+        cache->SendEvent(E_BEGINFRAME, eventData);
+        scene->Update(1.0f / 60.0f);
+        if (i >= minFrames && !terrain->GetNumLoadingTiles())
+            break;
+        Time::Sleep(1);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    Context* context = test.GetContext();
+    RegisterSceneLibrary(context);
+    RegisterGraphicsLibrary(context);
+
+    auto* cache = test.GetSubsystem<ResourceCache>();
+    auto* fileSystem = test.GetSubsystem<FileSystem>();
+    const int size = 1025;
+    const int tileSize = 128;
+    const Vector3 spacing(2.0f, 0.5f, 2.0f);
+
+    // A smooth 16-bit heightmap, red as MSB and green as LSB
+    SharedPtr<Image> heightMap(new Image(context));
+    heightMap->SetSize(size, size, 3);
+    unsigned char* pixel = heightMap->GetData();
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            auto value = (unsigned)(32768.0f + 12000.0f * Sin((float)x * 1.1f) * Cos((float)y * 0.9f) + 8000.0f *
+                Sin((float)(x + y) * 0.7f));
+            *pixel++ = (unsigned char)(value >> 8u);
+            *pixel++ = (unsigned char)(value & 0xffu);
+            *pixel++ = 0;
+        }
+    }
+
+    String dir = fileSystem->GetTemporaryDir() + "TiledTerrainTest/";
+    fileSystem->CreateDir(dir);
+    cache->AddResourceDir(dir);
+
+    SharedPtr<Scene> scene(new Scene(context));
+    scene->CreateComponent<Octree>();
+    Node* tiledNode = scene->CreateChild("Tiled");
+    auto* tiled = tiledNode->CreateComponent<TiledTerrain>();
+    URHO3D_CHECK(test, tiled->SaveTileSet(heightMap, dir + "World.xml", tileSize, 16));
+
+    // The whole heightmap in one terrain as the reference
+    Node* referenceNode = scene->CreateChild("Reference");
+    auto* reference = referenceNode->CreateComponent<Terrain>();
+    reference->SetSpacing(spacing);
+    reference->SetEnabled(false);
+    HiresTimer timer;
+    reference->SetHeightMap(heightMap);
+    test.Report("Terrain::SetHeightMap, 1025x1025", timer.GetUSec(true));
+
+    tiled->SetSpacing(spacing);
+    tiled->SetLoadDistance(300.0f);
+    tiled->SetUnloadDistance(400.0f);
+    tiled->SetHeightCacheSize(20);
+    tiled->SetMaxTilesPerUpdate(4);
+    timer.Reset();
+    URHO3D_CHECK(test, tiled->SetTileSet(cache->GetResource<XMLFile>("World.xml")));
+    test.Report("TiledTerrain::SetTileSet, 8x8 tiles", timer.GetUSec(true));
+    URHO3D_CHECK(test, tiled->GetNumTiles() == IntVector2(8, 8));
+    URHO3D_CHECK(test, tiled->GetNumVertices() == IntVector2(size, size));
+    URHO3D_CHECK(test, !tiled->GetNumLoadedTiles() && !tiled->GetNumCachedTiles());
+
+    // The quadtree bounds match the reference terrain
+    BoundingBox bounds = tiled->GetBoundingBox();
+    URHO3D_CHECK(test, Equals(bounds.min_.x_, -1024.0f) && Equals(bounds.max_.z_, 1024.0f));
+    URHO3D_CHECK(test, bounds.min_.y_ <= reference->GetHeight(Vector3::ZERO) && bounds.max_.y_ >= reference->GetHeight(Vector3::ZERO));
+
+    // Page in around the south-west corner
+    Node* focus = scene->CreateChild("Focus");
+    focus->SetPosition(Vector3(-900.0f, 0.0f, -900.0f));
+    focus->SetPosition(Vector3(-900.0f, reference->GetHeight(focus->GetPosition()), -900.0f));
+    tiled->SetFocusNode(focus);
+    timer.Reset();
+    RunFrames(test, scene, tiled, 10);
+    test.Report("Page in around focus", timer.GetUSec(true));
+
+    unsigned numLoaded = tiled->GetNumLoadedTiles();
+    printf("Loaded tiles %u, cached tiles %u\n", numLoaded, tiled->GetNumCachedTiles());
+    URHO3D_CHECK(test, numLoaded > 1 && numLoaded < 16);
+    URHO3D_CHECK(test, tiled->GetTileTerrain(0, 0) && tiled->GetTileTerrain(1, 1));
+    URHO3D_CHECK(test, !tiled->GetTileTerrain(7, 7) && !tiled->GetTileTerrain(4, 0));
+
+    Terrain* corner = tiled->GetTileTerrain(0, 0);
+    if (corner)
+    {
+        URHO3D_CHECK(test, corner->IsStreaming());
+        URHO3D_CHECK(test, corner->GetNumVertices() == IntVector2(tileSize + 1, tileSize + 1));
+        URHO3D_CHECK(test, corner->GetNorthNeighbor() == tiled->GetTileTerrain(0, 1));
+        URHO3D_CHECK(test, corner->GetEastNeighbor() == tiled->GetTileTerrain(1, 0));
+    }
+
+    // Heights and normals from the paged-in tiles match the reference exactly, elsewhere the overview approximates them
+    float maxNearError = 0.0f;
+    float maxFarError = 0.0f;
+    float minNormalDot = 1.0f;
+    for (int i = 0; i < 1000; ++i)
+    {
+        Vector3 position(Random(-1024.0f, 1024.0f), 0.0f, Random(-1024.0f, 1024.0f));
+        float error = Abs(tiled->GetHeight(position) - reference->GetHeight(position));
+        IntVector2 tile((int)((position.x_ + 1024.0f) / 256.0f), (int)((position.z_ + 1024.0f) / 256.0f));
+        if (tiled->GetTileTerrain(tile.x_, tile.y_))
+        {
+            maxNearError = Max(maxNearError, error);
+            minNormalDot = Min(minNormalDot, tiled->GetNormal(position).DotProduct(reference->GetNormal(position)));
+            URHO3D_CHECK(test, Abs(tiled->GetTileTerrain(tile.x_, tile.y_)->GetHeight(position) - reference->GetHeight(position)) < 0.01f);
+        }
+        else
+            maxFarError = Max(maxFarError, error);
+    }
+    printf("Height error near %f, far %f, normal dot %f\n", maxNearError, maxFarError, minNormalDot);
+    URHO3D_CHECK(test, maxNearError < 0.01f);
+    URHO3D_CHECK(test, minNormalDot > 0.99f);
+    URHO3D_CHECK(test, maxFarError < 2.0f);
+
+    // Move to the north-east corner. The old tiles are paged out and the height cache stays within its size
+    focus->SetPosition(Vector3(900.0f, reference->GetHeight(Vector3(900.0f, 0.0f, 900.0f)), 900.0f));
+    RunFrames(test, scene, tiled, 10);
+    printf("Loaded tiles %u, cached tiles %u\n", tiled->GetNumLoadedTiles(), tiled->GetNumCachedTiles());
+    URHO3D_CHECK(test, !tiled->GetTileTerrain(0, 0));
+    URHO3D_CHECK(test, tiled->GetTileTerrain(7, 7) != nullptr);
+    URHO3D_CHECK(test, tiled->GetNumLoadedTiles() == numLoaded);
+    URHO3D_CHECK(test, tiled->GetNumCachedTiles() <= 20);
+    URHO3D_CHECK(test, tiledNode->GetNumChildren() == tiled->GetNumLoadedTiles());
+
+    // Paging back in from the height cache does not need the disk
+    focus->SetPosition(Vector3(-900.0f, reference->GetHeight(Vector3(-900.0f, 0.0f, -900.0f)), -900.0f));
+    tiled->SetLoadDistance(100.0f);
+    RunFrames(test, scene, tiled, 10);
+    URHO3D_CHECK(test, tiled->GetTileTerrain(0, 0) != nullptr);
+
+    // Removing the component removes the tiles
+    tiledNode->RemoveComponent(tiled);
+    URHO3D_CHECK(test, !tiledNode->GetNumChildren());
+
+    Vector<String> files;
+    fileSystem->ScanDir(files, dir, "*.*", SCAN_FILES, false);
+    for (unsigned i = 0; i < files.Size(); ++i)
+        fileSystem->Delete(dir + files[i]);
+
+    return test.GetExitCode();
+}
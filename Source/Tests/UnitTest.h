@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/ResourceCache.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace Urho3D
+{
+
+/// Headless test program. Creates a context with the core subsystems, counts failed checks and reports benchmark timings.
+class UnitTest
+{
+public:
+    /// Construct. Create the specified number of worker threads; the default keeps at least two even on a single core so that the threaded code paths get exercised.
+    explicit UnitTest(unsigned numThreads = Max(GetNumLogicalCPUs(), 3U) - 1) :
+        context_(new Context()),
+        numFailures_(0)
+    {
+        context_->RegisterSubsystem(new Time(context_));
+        context_->RegisterSubsystem(new WorkQueue(context_));
+        context_->RegisterSubsystem(new FileSystem(context_));
+#ifdef URHO3D_LOGGING
+        context_->RegisterSubsystem(new Log(context_));
+#endif
+        context_->RegisterSubsystem(new ResourceCache(context_));
+        context_->GetSubsystem<WorkQueue>()->CreateThreads(numThreads);
+    }
+
+    /// Check a condition. Print the expression and count a failure if false. Return the condition.
+    bool Check(bool condition, const char* expression, const char* file, int line)
+    {
+        if (!condition)
+        {
+            printf("%s(%d): check failed: %s\n", file, line, expression);
+            ++numFailures_;
+        }
+        return condition;
+    }
+
+    /// Print a benchmark result. The time is in microseconds and divided by the number of iterations.
+    void Report(const char* name, long long usec, unsigned iterations = 1) const
+    {
+        printf("%-48s %12.2f us\n", name, (double)usec / (double)Max(iterations, 1U));
+    }
+
+    /// Return the process exit code.
+    int GetExitCode() const
+    {
+        if (numFailures_)
+            printf("%u check(s) failed\n", numFailures_);
+        return numFailures_ ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    /// Return the context.
+    Context* GetContext() const { return context_; }
+
+    /// Return a subsystem.
+    template <class T> T* GetSubsystem() const { return context_->GetSubsystem<T>(); }
+
+private:
+    /// Context.
+    SharedPtr<Context> context_;
+    /// Number of failed checks.
+    unsigned numFailures_;
+};
+
+}
+
+/// Check a condition within a UnitTest.
+#define URHO3D_CHECK(test, expression) (test).Check((expression), #expression, __FILE__, __LINE__)
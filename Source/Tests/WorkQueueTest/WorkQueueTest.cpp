@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/Thread.h>
+
+#include "UnitTest.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace Urho3D;
+
+/// Record of a work item execution.
+struct ExecutionRecord
+{
+    /// Thread that executed the item.
+    std::thread::id thread_;
+    /// Thread index passed to the work function.
+    unsigned threadIndex_;
+};
+
+/// Work function that keeps the thread busy for a while and records where it was executed.
+static void BusyWorkFunction(const WorkItem* item, unsigned threadIndex)
+{
+    HiresTimer timer;
+    while (timer.GetUSec(false) < 2000)
+    {
+    }
+
+    auto* record = reinterpret_cast<ExecutionRecord*>(item->aux_);
+    record->thread_ = std::this_thread::get_id();
+    record->threadIndex_ = threadIndex;
+}
+
+/// Thread that executes work items through the work queue, like the background resource loader.
+class ExecutingThread : public Thread
+{
+public:
+    /// Construct.
+    ExecutingThread(WorkQueue* queue, const Vector<SharedPtr<WorkItem> >& items) :
+        queue_(queue),
+        items_(items)
+    {
+    }
+
+    /// Execute the items once.
+    void ThreadFunction() override
+    {
+        queue_->ExecuteItems(items_);
+        finished_ = true;
+    }
+
+    /// Work queue.
+    WorkQueue* queue_;
+    /// Items to execute.
+    Vector<SharedPtr<WorkItem> > items_;
+    /// Finished flag.
+    std::atomic<bool> finished_{};
+};
+
+int main(int argc, char** argv)
+{
+    UnitTest test;
+    auto* queue = test.GetSubsystem<WorkQueue>();
+    const unsigned numThreads = queue->GetNumThreads();
+    const unsigned numItems = 32;
+
+    // Leave the worker threads paused, as the main thread does after completing its work each frame
+    queue->Complete(M_MAX_UNSIGNED);
+
+    PODVector<ExecutionRecord> records(numItems);
+    Vector<SharedPtr<WorkItem> > items;
+    for (unsigned i = 0; i < numItems; ++i)
+    {
+        SharedPtr<WorkItem> item(new WorkItem());
+        item->workFunction_ = BusyWorkFunction;
+        item->aux_ = &records[i];
+        items.Push(item);
+    }
+
+    ExecutingThread thread(queue, items);
+    HiresTimer timer;
+    thread.Run();
+    while (!thread.finished_)
+        Time::Sleep(1);
+    test.Report("Execute items from another thread while paused", timer.GetUSec(false));
+    thread.Stop();
+
+    // The worker threads take part, and the calling thread uses an index of its own
+    PODVector<std::thread::id> threadIds;
+    bool indicesValid = true;
+    for (unsigned i = 0; i < numItems; ++i)
+    {
+        const ExecutionRecord& record = records[i];
+        if (!threadIds.Contains(record.thread_))
+            threadIds.Push(record.thread_);
+        indicesValid &= items[i]->completed_ && record.threadIndex_ >= 1 && record.threadIndex_ <= numThreads + 1;
+    }
+    printf("Items executed on %u threads\n", threadIds.Size());
+    URHO3D_CHECK(test, indicesValid);
+    URHO3D_CHECK(test, threadIds.Size() > 1);
+
+    // Queued work is still completed normally afterwards
+    for (unsigned i = 0; i < numItems; ++i)
+    {
+        SharedPtr<WorkItem> item = queue->GetFreeItem();
+        item->priority_ = M_MAX_UNSIGNED;
+        item->workFunction_ = BusyWorkFunction;
+        item->aux_ = &records[i];
+        records[i].threadIndex_ = M_MAX_UNSIGNED;
+        queue->AddWorkItem(item);
+    }
+    queue->Complete(M_MAX_UNSIGNED);
+    bool allCompleted = true;
+    for (unsigned i = 0; i < numItems; ++i)
+        allCompleted &= records[i].threadIndex_ <= numThreads;
+    URHO3D_CHECK(test, allCompleted);
+
+    return test.GetExitCode();
+}
@@ -16,6 +16,8 @@
 * 3. This notice may not be removed or altered from any source distribution.
 */
 
+// Modified for Urho3D
+
 #include "Box2D/Dynamics/Contacts/b2Contact.h"
 #include "Box2D/Dynamics/Contacts/b2CircleContact.h"
 #include "Box2D/Dynamics/Contacts/b2PolygonAndCircleContact.h"
@@ -68,11 +70,9 @@ void b2Contact::AddType(b2ContactCreateFcn* createFcn, b2ContactDestroyFcn* dest
 
 b2Contact* b2Contact::Create(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB, b2BlockAllocator* allocator)
 {
-	if (s_initialized == false)
-	{
-		InitializeRegisters();
-		s_initialized = true;
-	}
+	// Urho3D: initialize with a thread-safe static, as separate worlds may be stepped concurrently on worker threads
+	static const bool initialized = (InitializeRegisters(), s_initialized = true);
+	B2_NOT_USED(initialized);
 
 	b2Shape::Type type1 = fixtureA->GetType();
 	b2Shape::Type type2 = fixtureB->GetType();
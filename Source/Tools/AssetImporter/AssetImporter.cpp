@@ -37,9 +37,11 @@
 #include <Urho3D/Graphics/Zone.h>
 #include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/MemoryBuffer.h>
 #ifdef URHO3D_PHYSICS
 #include <Urho3D/Physics/PhysicsWorld.h>
 #endif
+#include <Urho3D/Resource/Image.h>
 #include <Urho3D/Resource/ResourceCache.h>
 #include <Urho3D/Resource/XMLFile.h>
 #include <Urho3D/Scene/Scene.h>
@@ -161,6 +163,9 @@ bool emissiveAO_ = false;
 bool noOverwriteMaterial_ = false;
 bool noOverwriteTexture_ = false;
 bool noOverwriteNewerTexture_ = false;
+bool compressTextures_ = false;
+// Textures kept in their original format when compressing: normal maps and textures that could not be compressed
+HashSet<String> uncompressedTextures_;
 bool checkUniqueModel_ = true;
 bool moveToBindPose_ = false;
 unsigned maxBones_ = 64;
@@ -197,9 +202,12 @@ void CreateHierarchy(Scene* scene, aiNode* srcNode, HashMap<aiNode*, Node*>& nod
 Node* CreateSceneNode(Scene* scene, aiNode* srcNode, HashMap<aiNode*, Node*>& nodeMapping);
 void BuildAndSaveScene(OutScene& scene, bool asPrefab);
 
+void CollectMaterialTextures(HashSet<String>& usedTextures);
 void ExportMaterials(HashSet<String>& usedTextures);
 void BuildAndSaveMaterial(aiMaterial* material, HashSet<String>& usedTextures);
 void CopyTextures(const HashSet<String>& usedTextures, const String& sourcePath);
+bool SaveCompressedTexture(Image& image, const String& fullDestName);
+bool IsCompressedTexture(const String& nameIn);
 
 void CombineLods(const PODVector<float>& lodDistances, const Vector<String>& modelNames, const String& outName);
 
@@ -301,6 +309,8 @@ void Run(const Vector<String>& arguments)
             "-cm         Check and do not overwrite if material exists\n"
             "-ct         Check and do not overwrite if texture exists\n"
             "-ctn        Check and do not overwrite if texture has newer timestamp\n"
+            "-dds        Compress material textures to DXT1/DXT5 DDS files with mipmaps.\n"
+            "            Normal maps are copied in their original format\n"
             "-am         Export all meshes even if identical (scene mode only)\n"
             "-bp         Move bones to bind pose before saving model\n"
             "-split <start> <end> (animation model only)\n"
@@ -452,6 +462,8 @@ void Run(const Vector<String>& arguments)
                 noOverwriteTexture_ = true;
             else if (argument == "ctn")
                 noOverwriteNewerTexture_ = true;
+            else if (argument == "dds")
+                compressTextures_ = true;
             else if (argument == "am")
                 checkUniqueModel_ = false;
             else if (argument == "bp")
@@ -468,6 +480,10 @@ void Run(const Vector<String>& arguments)
         }
     }
 
+    // Texture compression splits the larger mip levels into block rows processed on the worker threads
+    if (compressTextures_)
+        context_->GetSubsystem<WorkQueue>()->CreateThreads(GetNumPhysicalCPUs() - 1);
+
     if (command == "model" || command == "scene" || command == "anim" || command == "node" || command == "dump")
     {
         String inFile = arguments[1];
@@ -567,10 +583,13 @@ void Run(const Vector<String>& arguments)
 
         if (!noMaterials_)
         {
+            // Copy the textures first, so that the materials refer to the files actually written. A texture that fails to
+            // compress is copied in its original format instead
             HashSet<String> usedTextures;
-            ExportMaterials(usedTextures);
+            CollectMaterialTextures(usedTextures);
             if (!noTextures_)
                 CopyTextures(usedTextures, GetPath(inFile));
+            ExportMaterials(usedTextures);
         }
     }
     else if (command == "lod")
@@ -1800,6 +1819,29 @@ void BuildAndSaveScene(OutScene& scene, bool asPrefab)
     }
 }
 
+void CollectMaterialTextures(HashSet<String>& usedTextures)
+{
+    static const aiTextureType textureTypes[] = {aiTextureType_DIFFUSE, aiTextureType_NORMALS, aiTextureType_SPECULAR,
+        aiTextureType_LIGHTMAP, aiTextureType_EMISSIVE};
+
+    for (unsigned i = 0; i < scene_->mNumMaterials; ++i)
+    {
+        aiMaterial* material = scene_->mMaterials[i];
+        for (aiTextureType type : textureTypes)
+        {
+            aiString stringVal;
+            if (material->Get(AI_MATKEY_TEXTURE(type, 0), stringVal) != AI_SUCCESS)
+                continue;
+
+            String texName = GetFileNameAndExtension(FromAIString(stringVal));
+            usedTextures.Insert(texName);
+            // DXT compression of the color channels visibly degrades normal maps, so keep them as they are
+            if (type == aiTextureType_NORMALS)
+                uncompressedTextures_.Insert(texName);
+        }
+    }
+}
+
 void ExportMaterials(HashSet<String>& usedTextures)
 {
     if (useSubdirs_)
@@ -1996,6 +2038,19 @@ void CopyTextures(const HashSet<String>& usedTextures, const String& sourcePath)
                 if (!tex->mHeight)
                 {
                     PrintLine("Saving embedded texture " + GetFileNameAndExtension(fullDestName));
+                    if (IsCompressedTexture(*i))
+                    {
+                        MemoryBuffer source((const void*)tex->pcData, tex->mWidth);
+                        Image image(context_);
+                        if (image.Load(source) && SaveCompressedTexture(image, fullDestName))
+                            continue;
+
+                        PrintLine("Failed to compress embedded texture " + GetFileNameAndExtension(fullDestName) +
+                            ", saving it uncompressed");
+                        uncompressedTextures_.Insert(*i);
+                        fullDestName = resourcePath_ + GenerateTextureName(texIndex);
+                    }
+
                     File dest(context_, fullDestName, FILE_WRITE);
                     dest.Write((const void*)tex->pcData, tex->mWidth);
                 }
@@ -2006,6 +2061,17 @@ void CopyTextures(const HashSet<String>& usedTextures, const String& sourcePath)
                     Image image(context_);
                     image.SetSize(tex->mWidth, tex->mHeight, 4);
                     memcpy(image.GetData(), (const void*)tex->pcData, (size_t)tex->mWidth * tex->mHeight * 4);
+                    if (IsCompressedTexture(*i))
+                    {
+                        if (SaveCompressedTexture(image, fullDestName))
+                            continue;
+
+                        PrintLine("Failed to compress embedded texture " + GetFileNameAndExtension(fullDestName) +
+                            ", saving it uncompressed");
+                        uncompressedTextures_.Insert(*i);
+                        fullDestName = resourcePath_ + GenerateTextureName(texIndex);
+                    }
+
                     image.SavePNG(fullDestName);
                 }
             }
@@ -2013,11 +2079,13 @@ void CopyTextures(const HashSet<String>& usedTextures, const String& sourcePath)
         else
         {
             String fullSourceName = sourcePath + *i;
-            String fullDestName = resourcePath_ + (useSubdirs_ ? "Textures/" : "") + *i;
+            String fullDestName = resourcePath_ + GetMaterialTextureName(*i);
 
+            // Textures that are not copied are referred to by their original names
             if (!fileSystem->FileExists(fullSourceName))
             {
                 PrintLine("Skipping copy of nonexisting material texture " + *i);
+                uncompressedTextures_.Insert(*i);
                 continue;
             }
             {
@@ -2025,6 +2093,7 @@ void CopyTextures(const HashSet<String>& usedTextures, const String& sourcePath)
                 if (!test.GetSize())
                 {
                     PrintLine("Skipping copy of zero-size material texture " + *i);
+                    uncompressedTextures_.Insert(*i);
                     continue;
                 }
             }
@@ -2042,12 +2111,40 @@ void CopyTextures(const HashSet<String>& usedTextures, const String& sourcePath)
                 continue;
             }
 
+            if (IsCompressedTexture(*i))
+            {
+                PrintLine("Compressing material texture " + *i);
+                Image image(context_);
+                File source(context_, fullSourceName);
+                if (image.Load(source) && SaveCompressedTexture(image, fullDestName))
+                    continue;
+
+                PrintLine("Failed to compress material texture " + *i + ", copying it uncompressed");
+                uncompressedTextures_.Insert(*i);
+                fullDestName = resourcePath_ + GetMaterialTextureName(*i);
+            }
+
             PrintLine("Copying material texture " + *i);
             fileSystem->Copy(fullSourceName, fullDestName);
         }
     }
 }
 
+bool SaveCompressedTexture(Image& image, const String& fullDestName)
+{
+    if (image.IsCompressed())
+        return image.SaveDDS(fullDestName);
+
+    // Use DXT5 only when the texture has an alpha channel, otherwise the smaller DXT1
+    SharedPtr<Image> compressed = image.GetCompressedImage(image.HasAlphaChannel() ? CF_DXT5 : CF_DXT1);
+    return compressed && compressed->SaveDDS(fullDestName);
+}
+
+bool IsCompressedTexture(const String& nameIn)
+{
+    return compressTextures_ && !uncompressedTextures_.Contains(nameIn);
+}
+
 void CombineLods(const PODVector<float>& lodDistances, const Vector<String>& modelNames, const String& outName)
 {
     // Load models
@@ -2369,6 +2466,8 @@ String GetMaterialTextureName(const String& nameIn)
     // Detect assimp embedded texture
     if (nameIn.Length() && nameIn[0] == '*')
         return GenerateTextureName(ToInt(nameIn.Substring(1)));
+    else if (IsCompressedTexture(nameIn))
+        return (useSubdirs_ ? "Textures/" : "") + ReplaceExtension(nameIn, ".dds");
     else
         return (useSubdirs_ ? "Textures/" : "") + nameIn;
 }
@@ -2379,7 +2478,9 @@ String GenerateTextureName(unsigned texIndex)
     {
         // If embedded texture contains encoded data, use the format hint for file extension. Else save RGBA8 data as PNG
         aiTexture* tex = scene_->mTextures[texIndex];
-        if (!tex->mHeight)
+        if (IsCompressedTexture("*" + String(texIndex)))
+            return (useSubdirs_ ? "Textures/" : "") + inputName_ + "_Texture" + String(texIndex) + ".dds";
+        else if (!tex->mHeight)
             return (useSubdirs_ ? "Textures/" : "") + inputName_ + "_Texture" + String(texIndex) + "." + tex->achFormatHint;
         else
             return (useSubdirs_ ? "Textures/" : "") + inputName_ + "_Texture" + String(texIndex) + ".png";
@@ -26,6 +26,14 @@
 #include <Urho3D/IO/File.h>
 #include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/PackageFile.h>
+#ifndef MINI_URHO
+#include <Urho3D/Container/HashSet.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/MemoryBuffer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+#include <Urho3D/Resource/Image.h>
+#include <Urho3D/Resource/XMLFile.h>
+#endif
 
 #ifdef WIN32
 #include <windows.h>
@@ -56,6 +64,10 @@ unsigned checksum_ = 0;
 bool compress_ = false;
 bool quiet_ = false;
 unsigned blockSize_ = COMPRESSED_BLOCK_SIZE;
+#ifndef MINI_URHO
+Vector<String> texturePatterns_;
+HashSet<String> dataImages_;
+#endif
 
 String ignoreExtensions_[] = {
     ".bak",
@@ -63,11 +75,33 @@ String ignoreExtensions_[] = {
     ""
 };
 
+#ifndef MINI_URHO
+String textureExtensions_[] = {
+    ".png",
+    ".jpg",
+    ".jpeg",
+    ".tga",
+    ".bmp",
+    ""
+};
+
+String resourceDescriptionExtensions_[] = {
+    ".xml",
+    ".json",
+    ""
+};
+#endif
+
 int main(int argc, char** argv);
 void Run(const Vector<String>& arguments);
 void ProcessFile(const String& fileName, const String& rootDir);
 void WritePackageFile(const String& fileName, const String& rootDir);
 void WriteHeader(File& dest);
+#ifndef MINI_URHO
+bool MatchPattern(const char* name, const char* pattern);
+void FindDataImages(const Vector<String>& fileNames, const String& rootDir);
+bool CompressTexture(const String& fileName, SharedArrayPtr<unsigned char>& buffer, unsigned& dataSize);
+#endif
 
 int main(int argc, char** argv)
 {
@@ -92,6 +126,12 @@ void Run(const Vector<String>& arguments)
             "Options:\n"
             "-c      Enable package file LZ4 compression\n"
             "-q      Enable quiet mode\n"
+#ifndef MINI_URHO
+            "-d<pattern>  Compress image files matching the wildcard pattern (e.g. -dTextures/*) to\n"
+            "        DXT1/DXT5 DDS data with mipmaps, keeping their names. May be repeated. Images\n"
+            "        referenced as Image resources (e.g. terrain heightmaps, cursor shapes) or used\n"
+            "        as material normal maps are not compressed\n"
+#endif
             "\n"
             "Basepath is an optional prefix that will be added to the file entries.\n\n"
             "Alternative output usage: PackageTool <output option> <package name>\n"
@@ -122,6 +162,13 @@ void Run(const Vector<String>& arguments)
                     case 'q':
                         quiet_ = true;
                         break;
+#ifndef MINI_URHO
+                    case 'd':
+                        if (arguments[i].Length() < 3)
+                            ErrorExit("Option -d requires a file name pattern, e.g. -dTextures/*");
+                        texturePatterns_.Push(arguments[i].Substring(2));
+                        break;
+#endif
                     default:
                         ErrorExit("Unrecognized option");
                     }
@@ -130,6 +177,15 @@ void Run(const Vector<String>& arguments)
         }
     }
 
+#ifndef MINI_URHO
+    // Texture compression splits the larger mip levels into block rows processed on the worker threads
+    if (texturePatterns_.Size())
+    {
+        context_->RegisterSubsystem(new WorkQueue(context_));
+        context_->GetSubsystem<WorkQueue>()->CreateThreads(GetNumPhysicalCPUs() - 1);
+    }
+#endif
+
     if (!isOutputMode)
     {
         if (!quiet_)
@@ -158,6 +214,11 @@ void Run(const Vector<String>& arguments)
         for (unsigned i = 0; i < fileNames.Size(); ++i)
             ProcessFile(fileNames[i], dirName);
 
+#ifndef MINI_URHO
+        if (texturePatterns_.Size())
+            FindDataImages(fileNames, dirName);
+#endif
+
         WritePackageFile(packageName, dirName);
     }
     else
@@ -255,13 +316,19 @@ void WritePackageFile(const String& fileName, const String& rootDir)
             ErrorExit("Could not open file " + fileFullPath);
 
         unsigned dataSize = entries_[i].size_;
-        totalDataSize += dataSize;
         SharedArrayPtr<unsigned char> buffer(new unsigned char[dataSize]);
 
         if (srcFile.Read(&buffer[0], dataSize) != dataSize)
             ErrorExit("Could not read file " + fileFullPath);
         srcFile.Close();
 
+#ifndef MINI_URHO
+        // The entry keeps its original name; Image detects the DDS data by its file ID when loading
+        if (texturePatterns_.Size() && CompressTexture(entries_[i].name_, buffer, dataSize))
+            entries_[i].size_ = dataSize;
+#endif
+        totalDataSize += dataSize;
+
         for (unsigned j = 0; j < dataSize; ++j)
         {
             checksum_ = SDBMHash(checksum_, buffer[j]);
@@ -343,3 +410,141 @@ void WriteHeader(File& dest)
     dest.WriteUInt(entries_.Size());
     dest.WriteUInt(checksum_);
 }
+
+#ifndef MINI_URHO
+bool MatchPattern(const char* name, const char* pattern)
+{
+    // Case-insensitive match where * matches any sequence of characters and ? any single character
+    for (; *pattern; ++name, ++pattern)
+    {
+        if (*pattern == '*')
+        {
+            for (;;)
+            {
+                if (MatchPattern(name, pattern + 1))
+                    return true;
+                if (!*name++)
+                    return false;
+            }
+        }
+        if (!*name || (*pattern != '?' && tolower(*name) != tolower(*pattern)))
+            return false;
+    }
+
+    return !*name;
+}
+
+void FindDataImages(const Vector<String>& fileNames, const String& rootDir)
+{
+    for (unsigned i = 0; i < fileNames.Size(); ++i)
+    {
+        String extension = GetExtension(fileNames[i]);
+        bool isDescription = false;
+        for (unsigned j = 0; resourceDescriptionExtensions_[j].Length(); ++j)
+        {
+            if (extension == resourceDescriptionExtensions_[j])
+            {
+                isDescription = true;
+                break;
+            }
+        }
+        if (!isDescription)
+            continue;
+
+        File file(context_, rootDir + "/" + fileNames[i]);
+        String text;
+        text.Resize(file.GetSize());
+        if (text.Empty() || file.Read(&text[0], text.Length()) != text.Length())
+            continue;
+
+        // Images referenced as Image resources, for example a terrain heightmap or cursor shapes, are read on the CPU
+        // and can not be stored compressed. A resource reference list may contain several names after the type
+        for (unsigned pos = text.Find("Image;"); pos != String::NPOS; pos = text.Find("Image;", pos))
+        {
+            pos += 6;
+            unsigned end = pos;
+            while (end < text.Length() && text[end] != '"' && text[end] != '\'' && text[end] != '<' && text[end] != '\n')
+                ++end;
+
+            Vector<String> names = text.Substring(pos, end - pos).Split(';');
+            for (unsigned j = 0; j < names.Size(); ++j)
+                dataImages_.Insert(names[j].Trimmed().ToLower());
+            pos = end;
+        }
+
+        // Normal maps would lose their precision as DXT1, and the DXT5 packed normal layout needs the PACKEDNORMAL
+        // shader define, so leave them uncompressed
+        if (extension == ".xml" && text.Contains("<material", false))
+        {
+            XMLFile xml(context_);
+            MemoryBuffer source(text.CString(), text.Length());
+            if (!xml.Load(source))
+                continue;
+
+            for (XMLElement texture = xml.GetRoot().GetChild("texture"); texture; texture = texture.GetNext("texture"))
+            {
+                String unit = texture.GetAttributeLower("unit");
+                if (unit == "normal" || unit == "norm" || unit == "1")
+                    dataImages_.Insert(texture.GetAttribute("name").ToLower());
+            }
+        }
+    }
+}
+
+bool CompressTexture(const String& fileName, SharedArrayPtr<unsigned char>& buffer, unsigned& dataSize)
+{
+    String extension = GetExtension(fileName);
+    bool isTexture = false;
+    for (unsigned i = 0; textureExtensions_[i].Length(); ++i)
+    {
+        if (extension == textureExtensions_[i])
+        {
+            isTexture = true;
+            break;
+        }
+    }
+    if (!isTexture)
+        return false;
+
+    bool matches = false;
+    for (unsigned i = 0; i < texturePatterns_.Size(); ++i)
+    {
+        if (MatchPattern(fileName.CString(), texturePatterns_[i].CString()))
+        {
+            matches = true;
+            break;
+        }
+    }
+    if (!matches)
+        return false;
+
+    if (dataImages_.Contains(fileName.ToLower()))
+    {
+        if (!quiet_)
+            PrintLine("Not compressing image " + fileName + " used as data or normal map");
+        return false;
+    }
+
+    MemoryBuffer source(buffer.Get(), dataSize);
+    SharedPtr<Image> image(new Image(context_));
+    if (!image->Load(source) || image->IsCompressed() || image->GetDepth() > 1)
+    {
+        PrintLine("Skipping compression of image " + fileName);
+        return false;
+    }
+
+    // Use DXT5 only when the image has an alpha channel, otherwise the smaller DXT1
+    SharedPtr<Image> compressed = image->GetCompressedImage(image->HasAlphaChannel() ? CF_DXT5 : CF_DXT1);
+    VectorBuffer dest;
+    if (!compressed || !compressed->SaveDDS(dest))
+    {
+        PrintLine("Failed to compress image " + fileName);
+        return false;
+    }
+
+    dataSize = dest.GetSize();
+    buffer = new unsigned char[dataSize];
+    memcpy(buffer.Get(), dest.GetData(), dataSize);
+    return true;
+}
+#endif
@@ -22,6 +22,7 @@
 
 #include <Urho3D/AngelScript/Script.h>
 #include <Urho3D/AngelScript/ScriptFile.h>
+#include <Urho3D/AngelScript/ScriptNativeCompiler.h>
 #include <Urho3D/Core/Context.h>
 #include <Urho3D/Core/ProcessUtils.h>
 #include <Urho3D/Engine/Engine.h>
@@ -44,6 +45,7 @@
 using namespace Urho3D;
 
 void CompileScript(Context* context, const String& fileName);
+void TranslateScript(Context* context, const String& fileName, const String& outputFileName, const String& registerFunctionName);
 
 int main(int argc, char** argv)
 {
@@ -54,15 +56,27 @@ int main(int argc, char** argv)
     #endif
 
     bool dumpApiMode = false;
+    bool nativeMode = false;
+    unsigned resourcePathArgument = 1;
     String sourceTree;
     String outputFile;
 
     if (arguments.Size() < 1)
         ErrorExit("Usage: ScriptCompiler <input file> [resource path for includes]\n"
+                  "       ScriptCompiler -native <input file> <C++ output file> <register function name> [resource path for includes]\n"
                   "       ScriptCompiler -dumpapi <source tree> <Doxygen output file> [C header output file]");
     else
     {
-        if (arguments[0] != "-dumpapi")
+        if (arguments[0] == "-native")
+        {
+            nativeMode = true;
+            resourcePathArgument = 4;
+            if (arguments.Size() > 3)
+                outputFile = arguments[1];
+            else
+                ErrorExit("Usage: ScriptCompiler -native <input file> <C++ output file> <register function name> [resource path for includes]");
+        }
+        else if (arguments[0] != "-dumpapi")
             outputFile = arguments[0];
         else
         {
@@ -116,12 +130,14 @@ int main(int argc, char** argv)
         auto* cache = context->GetSubsystem<ResourceCache>();
 
         // Add resource path to be able to resolve includes
-        if (arguments.Size() > 1)
-            cache->AddResourceDir(arguments[1]);
+        if (arguments.Size() > resourcePathArgument)
+            cache->AddResourceDir(arguments[resourcePathArgument]);
         else
             cache->AddResourceDir(cache->GetPreferredResourceDir(path));
 
-        if (!file.StartsWith("*"))
+        if (nativeMode)
+            TranslateScript(context, outputFile, arguments[2], arguments[3]);
+        else if (!file.StartsWith("*"))
             CompileScript(context, outputFile);
         else
         {
@@ -171,4 +187,29 @@ void CompileScript(Context* context, const String& fileName)
         ErrorExit("Failed to open output file " + fileName);
 
     script.SaveByteCode(outFile);
+    if (script.IsJITCompile())
+        PrintLine("Included JIT entry points in " + outFileName);
+}
+
+void TranslateScript(Context* context, const String& fileName, const String& outputFileName, const String& registerFunctionName)
+{
+    PrintLine("Translating script file " + fileName);
+
+    File inFile(context, fileName, FILE_READ);
+    if (!inFile.IsOpen())
+        ErrorExit("Failed to open script file " + fileName);
+
+    ScriptFile script(context);
+    if (!script.Load(inFile))
+        ErrorExit();
+    if (!script.IsJITCompile())
+        ErrorExit("Script file " + fileName + " is not marked with #pragma jit");
+
+    String source = ScriptNativeCompiler::Translate(script.GetScriptModule(), registerFunctionName);
+
+    File outFile(context, outputFileName, FILE_WRITE);
+    if (!outFile.IsOpen())
+        ErrorExit("Failed to open output file " + outputFileName);
+
+    outFile.Write(source.CString(), source.Length());
 }
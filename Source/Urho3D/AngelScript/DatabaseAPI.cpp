@@ -62,6 +62,11 @@ static CScriptArray* DbResultGetRow(unsigned index, DbResult* ptr)
         return VectorToArray<Variant>(rows[index], "Array<Variant>");
 }
 
+static CScriptArray* DbResultGetColumnValues(unsigned index, DbResult* ptr)
+{
+    return VectorToArray<Variant>(ptr->GetColumnValues(index), "Array<Variant>");
+}
+
 static void RegisterDbResult(asIScriptEngine* engine)
 {
     engine->RegisterObjectType("DbResult", sizeof(DbResult), asOBJ_VALUE | asOBJ_APP_CLASS_C);
@@ -74,16 +79,46 @@ static void RegisterDbResult(asIScriptEngine* engine)
     engine->RegisterObjectMethod("DbResult", "int64 get_numAffectedRows() const", asMETHOD(DbResult, GetNumAffectedRows), asCALL_THISCALL);
     engine->RegisterObjectMethod("DbResult", "Array<String>@ get_columns() const", asFUNCTION(DbResultGetColumns), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("DbResult", "Array<Variant>@ get_row(uint) const", asFUNCTION(DbResultGetRow), asCALL_CDECL_OBJLAST);
+    engine->RegisterObjectMethod("DbResult", "Array<Variant>@ get_columnValues(uint) const", asFUNCTION(DbResultGetColumnValues), asCALL_CDECL_OBJLAST);
+    engine->RegisterObjectMethod("DbResult", "bool get_columnar() const", asMETHOD(DbResult, IsColumnar), asCALL_THISCALL);
+}
+
+static bool DbStatementBindArray(CScriptArray* values, DbStatement* ptr)
+{
+    return ptr->Bind(ArrayToVector<Variant>(values));
+}
+
+static void RegisterDbStatement(asIScriptEngine* engine)
+{
+    RegisterRefCounted<DbStatement>(engine, "DbStatement");
+    engine->RegisterObjectMethod("DbStatement", "bool Bind(uint, const Variant&in)", asMETHODPR(DbStatement, Bind, (unsigned, const Variant&), bool), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DbStatement", "bool Bind(Array<Variant>@+)", asFUNCTION(DbStatementBindArray), asCALL_CDECL_OBJLAST);
+    engine->RegisterObjectMethod("DbStatement", "void ClearBindings()", asMETHOD(DbStatement, ClearBindings), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DbStatement", "DbResult Execute(bool columnar = false, bool useCursorEvent = false)", asMETHOD(DbStatement, Execute), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DbStatement", "void Finalize()", asMETHOD(DbStatement, Finalize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DbStatement", "const String& get_sql() const", asMETHOD(DbStatement, GetSQL), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DbStatement", "uint get_numParameters() const", asMETHOD(DbStatement, GetNumParameters), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DbStatement", "bool get_successful() const", asMETHOD(DbStatement, IsSuccessful), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DbStatement", "bool get_valid() const", asMETHOD(DbStatement, IsValid), asCALL_THISCALL);
 }
 
 static void RegisterDbConnection(asIScriptEngine* engine)
 {
     RegisterObject<DbConnection>(engine, "DbConnection");
     engine->RegisterObjectMethod("DbConnection", "DbResult Execute(const String&in, bool useCursorEvent = false)", asMETHOD(DbConnection, Execute), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DbConnection", "DbStatement@+ Prepare(const String&in)", asMETHOD(DbConnection, Prepare), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DbConnection", "bool BeginTransaction()", asMETHOD(DbConnection, BeginTransaction), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DbConnection", "bool CommitTransaction()", asMETHOD(DbConnection, CommitTransaction), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DbConnection", "bool RollbackTransaction()", asMETHOD(DbConnection, RollbackTransaction), asCALL_THISCALL);
     engine->RegisterObjectMethod("DbConnection", "const String& get_connectionString() const", asMETHOD(DbConnection, GetConnectionString), asCALL_THISCALL);
     engine->RegisterObjectMethod("DbConnection", "bool get_connected() const", asMETHOD(DbConnection, IsConnected), asCALL_THISCALL);
 }
 
+static unsigned DatabaseExecuteAsync(DbConnection* connection, const String& sql, CScriptArray* parameters, bool columnar, Database* ptr)
+{
+    return ptr->ExecuteAsync(connection, sql, parameters ? ArrayToVector<Variant>(parameters) : Variant::emptyVariantVector, columnar);
+}
+
 static Database* GetDatabase()
 {
     return GetScriptContext()->GetSubsystem<Database>();
@@ -103,9 +138,14 @@ void RegisterDatabase(asIScriptEngine* engine)
     RegisterObject<Database>(engine, "Database");
     engine->RegisterObjectMethod("Database", "DbConnection@+ Connect(const String&in)", asMETHOD(Database, Connect), asCALL_THISCALL);
     engine->RegisterObjectMethod("Database", "void Disconnect(DbConnection@+)", asMETHOD(Database, Disconnect), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Database", "uint ExecuteAsync(DbConnection@+, const String&in, Array<Variant>@+ parameters = null, bool columnar = false)", asFUNCTION(DatabaseExecuteAsync), asCALL_CDECL_OBJLAST);
+    engine->RegisterObjectMethod("Database", "void CompleteAsync()", asMETHOD(Database, CompleteAsync), asCALL_THISCALL);
     engine->RegisterObjectMethod("Database", "bool get_pooling() const", asMETHOD(Database, IsPooling), asCALL_THISCALL);
     engine->RegisterObjectMethod("Database", "void set_poolSize(uint)", asMETHOD(Database, SetPoolSize), asCALL_THISCALL);
     engine->RegisterObjectMethod("Database", "uint get_poolSize() const", asMETHOD(Database, GetPoolSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Database", "void set_asyncTransactionBatching(bool)", asMETHOD(Database, SetAsyncTransactionBatching), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Database", "bool get_asyncTransactionBatching() const", asMETHOD(Database, GetAsyncTransactionBatching), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Database", "uint get_numAsyncRequests() const", asMETHOD(Database, GetNumAsyncRequests), asCALL_THISCALL);
 
     engine->RegisterGlobalFunction("Database@+ get_database()", asFUNCTION(GetDatabase), asCALL_CDECL);
     engine->RegisterGlobalFunction("DBAPI get_DBAPI()", asFUNCTION(GetDBAPI), asCALL_CDECL);
@@ -114,6 +154,7 @@ void RegisterDatabase(asIScriptEngine* engine)
 void RegisterDatabaseAPI(asIScriptEngine* engine)
 {
     RegisterDbResult(engine);
+    RegisterDbStatement(engine);
     RegisterDbConnection(engine);
     RegisterDatabase(engine);
 }
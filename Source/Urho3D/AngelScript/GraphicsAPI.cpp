@@ -50,6 +50,7 @@
 #include "../Graphics/Texture2DArray.h"
 #include "../Graphics/Texture3D.h"
 #include "../Graphics/TextureCube.h"
+#include "../Graphics/TiledTerrain.h"
 #include "../Graphics/Skybox.h"
 #include "../Graphics/VertexBuffer.h"
 #include "../Graphics/Zone.h"
@@ -1688,6 +1689,7 @@ static void RegisterParticleEmitter(asIScriptEngine* engine)
     engine->RegisterObjectMethod("ParticleEmitter", "ParticleEffect@+ get_effect() const", asMETHOD(ParticleEmitter, GetEffect), asCALL_THISCALL);
     engine->RegisterObjectMethod("ParticleEmitter", "void set_numParticles(uint) const", asMETHOD(ParticleEmitter, SetNumParticles), asCALL_THISCALL);
     engine->RegisterObjectMethod("ParticleEmitter", "uint get_numParticles() const", asMETHOD(ParticleEmitter, GetNumParticles), asCALL_THISCALL);
+    engine->RegisterObjectMethod("ParticleEmitter", "uint get_numActiveParticles() const", asMETHOD(ParticleEmitter, GetNumActiveParticles), asCALL_THISCALL);
     engine->RegisterObjectMethod("ParticleEmitter", "void set_emitting(bool)", asMETHOD(ParticleEmitter, SetEmitting), asCALL_THISCALL);
     engine->RegisterObjectMethod("ParticleEmitter", "bool get_emitting() const", asMETHOD(ParticleEmitter, IsEmitting), asCALL_THISCALL);
     engine->RegisterObjectMethod("ParticleEmitter", "void set_serializeParticles() const", asMETHOD(ParticleEmitter, SetSerializeParticles), asCALL_THISCALL);
@@ -1777,6 +1779,7 @@ static void RegisterDecalSet(asIScriptEngine* engine)
 {
     RegisterDrawable<DecalSet>(engine, "DecalSet");
     engine->RegisterObjectMethod("DecalSet", "bool AddDecal(Drawable@+, const Vector3&in, const Quaternion&in, float, float, float, const Vector2&in, const Vector2&in, float timeToLive = 0.0, float normalCutoff = 0.1, uint subGeometry = 0xffffffff)", asMETHOD(DecalSet, AddDecal), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DecalSet", "bool AddDecalAsync(Drawable@+, const Vector3&in, const Quaternion&in, float, float, float, const Vector2&in, const Vector2&in, float timeToLive = 0.0, float normalCutoff = 0.1, uint subGeometry = 0xffffffff)", asMETHOD(DecalSet, AddDecalAsync), asCALL_THISCALL);
     engine->RegisterObjectMethod("DecalSet", "void RemoveDecals(uint)", asMETHOD(DecalSet, RemoveDecals), asCALL_THISCALL);
     engine->RegisterObjectMethod("DecalSet", "void RemoveAllDecals()", asMETHOD(DecalSet, RemoveAllDecals), asCALL_THISCALL);
     engine->RegisterObjectMethod("DecalSet", "void set_material(Material@+)", asMETHOD(DecalSet, SetMaterial), asCALL_THISCALL);
@@ -1790,12 +1793,16 @@ static void RegisterDecalSet(asIScriptEngine* engine)
     engine->RegisterObjectMethod("DecalSet", "uint get_maxIndices() const", asMETHOD(DecalSet, GetMaxIndices), asCALL_THISCALL);
     engine->RegisterObjectMethod("DecalSet", "void set_optimizeBufferSize(bool)", asMETHOD(DecalSet, SetOptimizeBufferSize), asCALL_THISCALL);
     engine->RegisterObjectMethod("DecalSet", "bool get_optimizeBufferSize() const", asMETHOD(DecalSet, GetOptimizeBufferSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DecalSet", "void set_maxDecalsPerFrame(uint)", asMETHOD(DecalSet, SetMaxDecalsPerFrame), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DecalSet", "uint get_maxDecalsPerFrame() const", asMETHOD(DecalSet, GetMaxDecalsPerFrame), asCALL_THISCALL);
+    engine->RegisterObjectMethod("DecalSet", "uint get_numPendingDecals() const", asMETHOD(DecalSet, GetNumPendingDecals), asCALL_THISCALL);
     engine->RegisterObjectMethod("DecalSet", "Zone@+ get_zone() const", asMETHOD(DecalSet, GetZone), asCALL_THISCALL);
 }
 
 static void RegisterTerrain(asIScriptEngine* engine)
 {
     RegisterDrawable<TerrainPatch>(engine, "TerrainPatch");
+    engine->RegisterObjectMethod("TerrainPatch", "bool get_geometryLoaded() const", asMETHOD(TerrainPatch, IsGeometryLoaded), asCALL_THISCALL);
     RegisterComponent<Terrain>(engine, "Terrain");
     engine->RegisterObjectMethod("Terrain", "void ApplyHeightMap()", asMETHOD(Terrain, ApplyHeightMap), asCALL_THISCALL);
     engine->RegisterObjectMethod("Terrain", "float GetHeight(const Vector3&in) const", asMETHOD(Terrain, GetHeight), asCALL_THISCALL);
@@ -1828,6 +1835,11 @@ static void RegisterTerrain(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Terrain", "bool get_occluder() const", asMETHOD(Terrain, IsOccluder), asCALL_THISCALL);
     engine->RegisterObjectMethod("Terrain", "void set_occludee(bool)", asMETHOD(Terrain, SetOccludee), asCALL_THISCALL);
     engine->RegisterObjectMethod("Terrain", "bool get_occludee() const", asMETHOD(Terrain, IsOccludee), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Terrain", "void set_streaming(bool)", asMETHOD(Terrain, SetStreaming), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Terrain", "bool get_streaming() const", asMETHOD(Terrain, IsStreaming), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Terrain", "void set_streamingUnloadDelay(float)", asMETHOD(Terrain, SetStreamingUnloadDelay), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Terrain", "float get_streamingUnloadDelay() const", asMETHOD(Terrain, GetStreamingUnloadDelay), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Terrain", "uint get_numLoadedPatches() const", asMETHOD(Terrain, GetNumLoadedPatches), asCALL_THISCALL);
     engine->RegisterObjectMethod("Terrain", "void set_drawDistance(float)", asMETHOD(Terrain, SetDrawDistance), asCALL_THISCALL);
     engine->RegisterObjectMethod("Terrain", "float get_drawDistance() const", asMETHOD(Terrain, GetDrawDistance), asCALL_THISCALL);
     engine->RegisterObjectMethod("Terrain", "void set_shadowDistance(float)", asMETHOD(Terrain, SetShadowDistance), asCALL_THISCALL);
@@ -1852,6 +1864,55 @@ static void RegisterTerrain(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Terrain", "Terrain@+ get_westNeighbor() const", asMETHOD(Terrain, GetEastNeighbor), asCALL_THISCALL);
     engine->RegisterObjectMethod("Terrain", "void set_eastNeighbor(Terrain@+)", asMETHOD(Terrain, SetWestNeighbor), asCALL_THISCALL);
     engine->RegisterObjectMethod("Terrain", "Terrain@+ get_eastNeighbor() const", asMETHOD(Terrain, GetWestNeighbor), asCALL_THISCALL);
+    RegisterComponent<TiledTerrain>(engine, "TiledTerrain");
+    engine->RegisterObjectMethod("TiledTerrain", "bool SetTileSet(XMLFile@+)", asMETHOD(TiledTerrain, SetTileSet), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "bool SaveTileSet(Image@+, const String&in, int, int = 16) const", asMETHOD(TiledTerrain, SaveTileSet), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void UpdateTiles()", asMETHOD(TiledTerrain, UpdateTiles), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "float GetHeight(const Vector3&in) const", asMETHOD(TiledTerrain, GetHeight), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "Vector3 GetNormal(const Vector3&in) const", asMETHOD(TiledTerrain, GetNormal), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "Terrain@+ GetTileTerrain(int, int) const", asMETHOD(TiledTerrain, GetTileTerrain), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "BoundingBox get_boundingBox() const", asMETHOD(TiledTerrain, GetBoundingBox), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "XMLFile@+ get_tileSet() const", asMETHOD(TiledTerrain, GetTileSet), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_material(Material@+)", asMETHOD(TiledTerrain, SetMaterial), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "Material@+ get_material() const", asMETHOD(TiledTerrain, GetMaterial), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_spacing(const Vector3&in)", asMETHOD(TiledTerrain, SetSpacing), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "const Vector3& get_spacing() const", asMETHOD(TiledTerrain, GetSpacing), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_patchSize(int)", asMETHOD(TiledTerrain, SetPatchSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "int get_patchSize() const", asMETHOD(TiledTerrain, GetPatchSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_maxLodLevels(uint)", asMETHOD(TiledTerrain, SetMaxLodLevels), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "uint get_maxLodLevels() const", asMETHOD(TiledTerrain, GetMaxLodLevels), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_loadDistance(float)", asMETHOD(TiledTerrain, SetLoadDistance), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "float get_loadDistance() const", asMETHOD(TiledTerrain, GetLoadDistance), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_unloadDistance(float)", asMETHOD(TiledTerrain, SetUnloadDistance), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "float get_unloadDistance() const", asMETHOD(TiledTerrain, GetUnloadDistance), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_heightCacheSize(uint)", asMETHOD(TiledTerrain, SetHeightCacheSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "uint get_heightCacheSize() const", asMETHOD(TiledTerrain, GetHeightCacheSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_maxTilesPerUpdate(uint)", asMETHOD(TiledTerrain, SetMaxTilesPerUpdate), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "uint get_maxTilesPerUpdate() const", asMETHOD(TiledTerrain, GetMaxTilesPerUpdate), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_focusNode(Node@+)", asMETHOD(TiledTerrain, SetFocusNode), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "Node@+ get_focusNode() const", asMETHOD(TiledTerrain, GetFocusNode), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_drawDistance(float)", asMETHOD(TiledTerrain, SetDrawDistance), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "float get_drawDistance() const", asMETHOD(TiledTerrain, GetDrawDistance), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_shadowDistance(float)", asMETHOD(TiledTerrain, SetShadowDistance), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "float get_shadowDistance() const", asMETHOD(TiledTerrain, GetShadowDistance), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_lodBias(float)", asMETHOD(TiledTerrain, SetLodBias), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "float get_lodBias() const", asMETHOD(TiledTerrain, GetLodBias), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_viewMask(uint)", asMETHOD(TiledTerrain, SetViewMask), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "uint get_viewMask() const", asMETHOD(TiledTerrain, GetViewMask), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_lightMask(uint)", asMETHOD(TiledTerrain, SetLightMask), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "uint get_lightMask() const", asMETHOD(TiledTerrain, GetLightMask), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_castShadows(bool)", asMETHOD(TiledTerrain, SetCastShadows), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "bool get_castShadows() const", asMETHOD(TiledTerrain, GetCastShadows), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_occluder(bool)", asMETHOD(TiledTerrain, SetOccluder), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "bool get_occluder() const", asMETHOD(TiledTerrain, IsOccluder), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "void set_occludee(bool)", asMETHOD(TiledTerrain, SetOccludee), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "bool get_occludee() const", asMETHOD(TiledTerrain, IsOccludee), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "int get_tileSize() const", asMETHOD(TiledTerrain, GetTileSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "const IntVector2& get_numTiles() const", asMETHOD(TiledTerrain, GetNumTiles), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "const IntVector2& get_numVertices() const", asMETHOD(TiledTerrain, GetNumVertices), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "uint get_numLoadedTiles() const", asMETHOD(TiledTerrain, GetNumLoadedTiles), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "uint get_numCachedTiles() const", asMETHOD(TiledTerrain, GetNumCachedTiles), asCALL_THISCALL);
+    engine->RegisterObjectMethod("TiledTerrain", "uint get_numLoadingTiles() const", asMETHOD(TiledTerrain, GetNumLoadingTiles), asCALL_THISCALL);
 }
 
 
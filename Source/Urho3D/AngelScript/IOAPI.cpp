@@ -152,6 +152,10 @@ static void RegisterLog(asIScriptEngine* engine)
     engine->RegisterGlobalProperty("const int LOG_ERROR", (void*)&LOG_ERROR);
     engine->RegisterGlobalProperty("const int LOG_NONE", (void*)&LOG_NONE);
 
+    engine->RegisterEnum("LogFormat");
+    engine->RegisterEnumValue("LogFormat", "LOG_FORMAT_TEXT", LOG_FORMAT_TEXT);
+    engine->RegisterEnumValue("LogFormat", "LOG_FORMAT_JSONLINES", LOG_FORMAT_JSONLINES);
+
     RegisterObject<Log>(engine, "Log");
     engine->RegisterObjectMethod("Log", "void Open(const String&in)", asMETHOD(Log, Open), asCALL_THISCALL);
     engine->RegisterObjectMethod("Log", "void Close()", asMETHOD(Log, Close), asCALL_THISCALL);
@@ -168,6 +172,19 @@ static void RegisterLog(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Log", "String get_lastMessage()", asMETHOD(Log, GetLastMessage), asCALL_THISCALL);
     engine->RegisterObjectMethod("Log", "void set_quiet(bool)", asMETHOD(Log, SetQuiet), asCALL_THISCALL);
     engine->RegisterObjectMethod("Log", "bool get_quiet() const", asMETHOD(Log, IsQuiet), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void set_format(LogFormat)", asMETHOD(Log, SetFormat), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "LogFormat get_format() const", asMETHOD(Log, GetFormat), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void set_async(bool)", asMETHOD(Log, SetAsync), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "bool get_async() const", asMETHOD(Log, IsAsync), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void set_flushInterval(uint)", asMETHOD(Log, SetFlushInterval), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "uint get_flushInterval() const", asMETHOD(Log, GetFlushInterval), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void set_flushSize(uint)", asMETHOD(Log, SetFlushSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "uint get_flushSize() const", asMETHOD(Log, GetFlushSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void set_maxQueueSize(uint)", asMETHOD(Log, SetMaxQueueSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "uint get_maxQueueSize() const", asMETHOD(Log, GetMaxQueueSize), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void set_dropOnOverflow(bool)", asMETHOD(Log, SetDropOnOverflow), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "bool get_dropOnOverflow() const", asMETHOD(Log, GetDropOnOverflow), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "uint get_numDroppedMessages() const", asMETHOD(Log, GetNumDroppedMessages), asCALL_THISCALL);
     engine->RegisterGlobalFunction("Log@+ get_log()", asFUNCTION(GetLog), asCALL_CDECL);
 
     // Register also Print() functions for convenience
@@ -25,7 +25,9 @@
 #include "../Precompiled.h"
 
 #include "../AngelScript/APITemplates.h"
+#include "../Network/HttpClient.h"
 #include "../Network/HttpRequest.h"
+#include "../Network/MetricsServer.h"
 #include "../Network/Network.h"
 #include "../Network/NetworkPriority.h"
 
@@ -87,6 +89,9 @@ static void RegisterConnection(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Connection", "void set_rotation(const Quaternion&in)", asMETHOD(Connection, SetRotation), asCALL_THISCALL);
     engine->RegisterObjectMethod("Connection", "const Quaternion& get_rotation() const", asMETHOD(Connection, GetRotation), asCALL_THISCALL);
     engine->RegisterObjectMethod("Connection", "void SendPackageToClient(PackageFile@+)", asMETHOD(Connection, SendPackageToClient), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Connection", "uint8 get_acknowledgedTimeStamp() const", asMETHOD(Connection, GetAcknowledgedTimeStamp), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Connection", "uint get_numUnacknowledgedControls() const", asMETHOD(Connection, GetNumUnacknowledgedControls), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Connection", "const Controls& get_unacknowledgedControls(uint) const", asMETHOD(Connection, GetUnacknowledgedControls), asCALL_THISCALL);
     engine->RegisterObjectProperty("Connection", "Controls controls", offsetof(Connection, controls_));
     engine->RegisterObjectProperty("Connection", "uint8 timeStamp", offsetof(Connection, timeStamp_));
     engine->RegisterObjectProperty("Connection", "VariantMap identity", offsetof(Connection, identity_));
@@ -112,6 +117,28 @@ static void RegisterHttpRequest(asIScriptEngine* engine)
     engine->RegisterObjectMethod("HttpRequest", "HttpRequestState get_state() const", asMETHOD(HttpRequest, GetState), asCALL_THISCALL);
     engine->RegisterObjectMethod("HttpRequest", "uint get_availableSize() const", asMETHOD(HttpRequest, GetAvailableSize), asCALL_THISCALL);
     engine->RegisterObjectMethod("HttpRequest", "bool get_open() const", asMETHOD(HttpRequest, IsOpen), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpRequest", "int get_statusCode() const", asMETHOD(HttpRequest, GetStatusCode), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpRequest", "String GetResponseHeader(const String&in) const", asMETHOD(HttpRequest, GetResponseHeader), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpRequest", "bool get_connectionReused() const", asMETHOD(HttpRequest, IsConnectionReused), asCALL_THISCALL);
+}
+
+static void RegisterHttpClient(asIScriptEngine* engine)
+{
+    RegisterRefCounted<HttpClient>(engine, "HttpClient");
+    engine->RegisterObjectMethod("HttpClient", "void CloseIdleConnections()", asMETHOD(HttpClient, CloseIdleConnections), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "void set_numThreads(uint)", asMETHOD(HttpClient, SetNumThreads), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "uint get_numThreads() const", asMETHOD(HttpClient, GetNumThreads), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "void set_keepAlive(bool)", asMETHOD(HttpClient, SetKeepAlive), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "bool get_keepAlive() const", asMETHOD(HttpClient, GetKeepAlive), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "void set_maxIdleConnections(uint)", asMETHOD(HttpClient, SetMaxIdleConnections), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "uint get_maxIdleConnections() const", asMETHOD(HttpClient, GetMaxIdleConnections), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "void set_idleTimeout(uint)", asMETHOD(HttpClient, SetIdleTimeout), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "uint get_idleTimeout() const", asMETHOD(HttpClient, GetIdleTimeout), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "void set_timeout(int)", asMETHOD(HttpClient, SetTimeout), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "int get_timeout() const", asMETHOD(HttpClient, GetTimeout), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "uint get_numQueuedRequests() const", asMETHOD(HttpClient, GetNumQueuedRequests), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "uint get_numActiveRequests() const", asMETHOD(HttpClient, GetNumActiveRequests), asCALL_THISCALL);
+    engine->RegisterObjectMethod("HttpClient", "uint get_numIdleConnections() const", asMETHOD(HttpClient, GetNumIdleConnections), asCALL_THISCALL);
 }
 
 static Network* GetNetwork()
@@ -201,15 +228,38 @@ void RegisterNetwork(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Network", "bool get_serverRunning() const", asMETHOD(Network, IsServerRunning), asCALL_THISCALL);
     engine->RegisterObjectMethod("Network", "Connection@+ get_serverConnection() const", asMETHOD(Network, GetServerConnection), asCALL_THISCALL);
     engine->RegisterObjectMethod("Network", "Array<Connection@>@ get_clientConnections() const", asFUNCTION(NetworkGetClientConnections), asCALL_CDECL_OBJLAST);
+    engine->RegisterObjectMethod("Network", "HttpClient@+ get_httpClient() const", asMETHOD(Network, GetHttpClient), asCALL_THISCALL);
     engine->RegisterGlobalFunction("Network@+ get_network()", asFUNCTION(GetNetwork), asCALL_CDECL);
 }
 
+static MetricsServer* GetMetricsServer()
+{
+    return GetScriptContext()->GetSubsystem<MetricsServer>();
+}
+
+static void RegisterMetricsServer(asIScriptEngine* engine)
+{
+    RegisterObject<MetricsServer>(engine, "MetricsServer");
+    engine->RegisterObjectMethod("MetricsServer", "bool Start(uint16, const String&in address = \"127.0.0.1\")", asMETHOD(MetricsServer, Start), asCALL_THISCALL);
+    engine->RegisterObjectMethod("MetricsServer", "void Stop()", asMETHOD(MetricsServer, Stop), asCALL_THISCALL);
+    engine->RegisterObjectMethod("MetricsServer", "bool get_running() const", asMETHOD(MetricsServer, IsRunning), asCALL_THISCALL);
+    engine->RegisterObjectMethod("MetricsServer", "void set_updateInterval(float)", asMETHOD(MetricsServer, SetUpdateInterval), asCALL_THISCALL);
+    engine->RegisterObjectMethod("MetricsServer", "float get_updateInterval() const", asMETHOD(MetricsServer, GetUpdateInterval), asCALL_THISCALL);
+    engine->RegisterObjectMethod("MetricsServer", "void set_profilerMaxDepth(uint)", asMETHOD(MetricsServer, SetProfilerMaxDepth), asCALL_THISCALL);
+    engine->RegisterObjectMethod("MetricsServer", "uint get_profilerMaxDepth() const", asMETHOD(MetricsServer, GetProfilerMaxDepth), asCALL_THISCALL);
+    engine->RegisterObjectMethod("MetricsServer", "String get_textSnapshot() const", asMETHOD(MetricsServer, GetTextSnapshot), asCALL_THISCALL);
+    engine->RegisterObjectMethod("MetricsServer", "String get_jsonSnapshot() const", asMETHOD(MetricsServer, GetJSONSnapshot), asCALL_THISCALL);
+    engine->RegisterGlobalFunction("MetricsServer@+ get_metricsServer()", asFUNCTION(GetMetricsServer), asCALL_CDECL);
+}
+
 void RegisterNetworkAPI(asIScriptEngine* engine)
 {
     RegisterNetworkPriority(engine);
     RegisterConnection(engine);
     RegisterHttpRequest(engine);
+    RegisterHttpClient(engine);
     RegisterNetwork(engine);
+    RegisterMetricsServer(engine);
 }
 
 }
@@ -295,6 +295,11 @@ static CScriptArray* PhysicsWorldGetCollidingBodies(RigidBody* body, PhysicsWorl
     return VectorToHandleArray<RigidBody>(result, "Array<RigidBody@>");
 }
 
+static bool PhysicsWorldRestoreState(VectorBuffer& src, PhysicsWorld* ptr)
+{
+    return ptr->RestoreState(src);
+}
+
 static void RegisterPhysicsWorld(asIScriptEngine* engine)
 {
     engine->RegisterObjectType("PhysicsRaycastResult", sizeof(PhysicsRaycastResult), asOBJ_VALUE | asOBJ_APP_CLASS_C);
@@ -323,6 +328,13 @@ static void RegisterPhysicsWorld(asIScriptEngine* engine)
     engine->RegisterObjectMethod("PhysicsWorld", "Array<RigidBody@>@ GetCollidingBodies(RigidBody@+)", asFUNCTION(PhysicsWorldGetCollidingBodies), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("PhysicsWorld", "void DrawDebugGeometry(bool)", asMETHODPR(PhysicsWorld, DrawDebugGeometry, (bool), void), asCALL_THISCALL);
     engine->RegisterObjectMethod("PhysicsWorld", "void RemoveCachedGeometry(Model@+)", asMETHOD(PhysicsWorld, RemoveCachedGeometry), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld", "void Simulate(uint)", asMETHOD(PhysicsWorld, Simulate), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld", "void AddStateNode(Node@+)", asMETHOD(PhysicsWorld, AddStateNode), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld", "void RemoveStateNode(Node@+)", asMETHOD(PhysicsWorld, RemoveStateNode), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld", "void AddStateComponent(Component@+)", asMETHOD(PhysicsWorld, AddStateComponent), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld", "void RemoveStateComponent(Component@+)", asMETHOD(PhysicsWorld, RemoveStateComponent), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld", "void SaveState(VectorBuffer&)", asMETHOD(PhysicsWorld, SaveState), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld", "bool RestoreState(VectorBuffer&)", asFUNCTION(PhysicsWorldRestoreState), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("PhysicsWorld", "void set_gravity(const Vector3&in)", asMETHOD(PhysicsWorld, SetGravity), asCALL_THISCALL);
     engine->RegisterObjectMethod("PhysicsWorld", "Vector3 get_gravity() const", asMETHOD(PhysicsWorld, GetGravity), asCALL_THISCALL);
     engine->RegisterObjectMethod("PhysicsWorld", "void set_maxSubSteps(int)", asMETHOD(PhysicsWorld, SetMaxSubSteps), asCALL_THISCALL);
@@ -339,6 +351,10 @@ static void RegisterPhysicsWorld(asIScriptEngine* engine)
     engine->RegisterObjectMethod("PhysicsWorld", "bool get_internalEdge() const", asMETHOD(PhysicsWorld, GetInternalEdge), asCALL_THISCALL);
     engine->RegisterObjectMethod("PhysicsWorld", "void set_splitImpulse(bool)", asMETHOD(PhysicsWorld, SetSplitImpulse), asCALL_THISCALL);
     engine->RegisterObjectMethod("PhysicsWorld", "bool get_splitImpulse() const", asMETHOD(PhysicsWorld, GetSplitImpulse), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld", "void set_collisionCacheDir(const String&in)", asMETHOD(PhysicsWorld, SetCollisionCacheDir), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld", "const String& get_collisionCacheDir() const", asMETHOD(PhysicsWorld, GetCollisionCacheDir), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld", "void set_deterministic(bool)", asMETHOD(PhysicsWorld, SetDeterministic), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld", "bool get_deterministic() const", asMETHOD(PhysicsWorld, IsDeterministic), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "PhysicsWorld@+ get_physicsWorld() const", asFUNCTION(SceneGetPhysicsWorld), asCALL_CDECL_OBJLAST);
     engine->RegisterGlobalFunction("PhysicsWorld@+ get_physicsWorld()", asFUNCTION(GetPhysicsWorld), asCALL_CDECL);
 }
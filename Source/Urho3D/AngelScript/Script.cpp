@@ -232,6 +232,16 @@ void Script::SetExecuteConsoleCommands(bool enable)
         UnsubscribeFromEvent(E_CONSOLECOMMAND);
 }
 
+void Script::SetJITCompiler(asIJITCompiler* compiler)
+{
+    scriptEngine_->SetJITCompiler(compiler);
+}
+
+asIJITCompiler* Script::GetJITCompiler() const
+{
+    return scriptEngine_->GetJITCompiler();
+}
+
 void Script::MessageCallback(const asSMessageInfo* msg)
 {
     String message;
@@ -244,6 +254,9 @@ void Script::MessageCallback(const asSMessageInfo* msg)
         break;
 
     case asMSGTYPE_WARNING:
+        // The modules not marked with #pragma jit are left without JIT entry points on purpose
+        if (scriptEngine_->GetJITCompiler() && String(msg->message).EndsWith("compiled without JIT entry points"))
+            break;
         URHO3D_LOGWARNING(message);
         break;
 
@@ -27,6 +27,7 @@
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
 
+class asIJITCompiler;
 class asIScriptContext;
 class asIScriptEngine;
 class asIScriptModule;
@@ -73,6 +74,8 @@ public:
     void SetDefaultScene(Scene* scene);
     /// Set whether to execute engine console commands as script code.
     void SetExecuteConsoleCommands(bool enable);
+    /// Set the JIT compiler for translating the script functions to native code. It is called for the functions of the modules marked with #pragma jit, either compiled or loaded from bytecode afterward. The compiler is not owned by the script subsystem and must outlive it, as the compiled functions are released through it.
+    void SetJITCompiler(asIJITCompiler* compiler);
     /// Print the whole script API (all registered classes, methods and properties) to the log. No-ops when URHO3D_LOGGING not defined.
     void DumpAPI(DumpMode mode = DOXYGEN, const String& sourceTree = String::EMPTY);
     /// Log a message from the script engine.
@@ -96,6 +99,9 @@ public:
     /// Return whether is executing engine console commands as script code.
     bool GetExecuteConsoleCommands() const { return executeConsoleCommands_; }
 
+    /// Return the JIT compiler.
+    asIJITCompiler* GetJITCompiler() const;
+
     /// Clear the inbuild object type cache.
     void ClearObjectTypeCache();
     /// Query for an inbuilt object type by constant declaration. Can not be used for script types.
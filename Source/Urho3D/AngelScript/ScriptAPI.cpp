@@ -246,6 +246,8 @@ static void RegisterScriptInstance(asIScriptEngine* engine)
     engine->RegisterObjectMethod("ScriptInstance", "ScriptObject@+ get_scriptObject() const", asMETHOD(ScriptInstance, GetScriptObject), asCALL_THISCALL);
     engine->RegisterObjectMethod("ScriptInstance", "void set_className(const String&in)", asMETHOD(ScriptInstance, SetClassName), asCALL_THISCALL);
     engine->RegisterObjectMethod("ScriptInstance", "const String& get_className() const", asMETHOD(ScriptInstance, GetClassName), asCALL_THISCALL);
+    engine->RegisterObjectMethod("ScriptInstance", "void set_eventDispatch(bool)", asMETHOD(ScriptInstance, SetEventDispatch), asCALL_THISCALL);
+    engine->RegisterObjectMethod("ScriptInstance", "bool get_eventDispatch() const", asMETHOD(ScriptInstance, GetEventDispatch), asCALL_THISCALL);
     engine->RegisterGlobalFunction("ScriptInstance@+ get_self()", asFUNCTION(GetSelf), asCALL_CDECL);
 
     // Register convenience functions for controlling self, similar to event sending
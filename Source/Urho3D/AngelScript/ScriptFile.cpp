@@ -130,9 +130,11 @@ bool ScriptFile::BeginLoad(Deserializer& source)
         }
     }
 
-    // Check if this file is precompiled bytecode
-    if (source.ReadFileID() == "ASBC")
+    // Check if this file is precompiled bytecode. Bytecode of modules marked with #pragma jit has its own identifier
+    String fileID = source.ReadFileID();
+    if (fileID == "ASBC" || fileID == "ASBJ")
     {
+        jitCompile_ = fileID == "ASBJ";
         // Perform actual parsing in EndLoad(); read data now
         loadByteCodeSize_ = source.GetSize() - source.GetPosition();
         loadByteCode_ = new unsigned char[loadByteCodeSize_];
@@ -166,7 +168,12 @@ bool ScriptFile::EndLoad()
     }
     else
     {
+        // Include the JIT entry points in the bytecode only for modules marked with #pragma jit. The bytecode saved from
+        // such a module keeps them, so that a JIT compiler can also compile the module when it is loaded from bytecode
+        asIScriptEngine* engine = script_->GetScriptEngine();
+        engine->SetEngineProperty(asEP_INCLUDE_JIT_INSTRUCTIONS, (asPWORD)jitCompile_);
         int result = scriptModule_->Build();
+        engine->SetEngineProperty(asEP_INCLUDE_JIT_INSTRUCTIONS, (asPWORD)false);
         if (result >= 0)
         {
             URHO3D_LOGINFO("Compiled script module " + GetName());
@@ -595,7 +602,7 @@ bool ScriptFile::SaveByteCode(Serializer& dest)
 {
     if (compiled_)
     {
-        dest.WriteFileID("ASBC");
+        dest.WriteFileID(jitCompile_ ? "ASBJ" : "ASBC");
         ByteCodeSerializer serializer = ByteCodeSerializer(dest);
         return scriptModule_->SaveByteCode(&serializer, true) >= 0;
     }
@@ -768,6 +775,24 @@ bool ScriptFile::AddScriptSection(asIScriptEngine* engine, Deserializer& source)
                         memset(&buffer[start], ' ', pos - start);
                     }
                 }
+                else if (token == "pragma")
+                {
+                    pos += len;
+                    t = engine->ParseToken(&buffer[pos], dataSize - pos, &len);
+                    if (t == asTC_WHITESPACE)
+                    {
+                        pos += len;
+                        t = engine->ParseToken(&buffer[pos], dataSize - pos, &len);
+                    }
+
+                    if (t == asTC_IDENTIFIER && String(&buffer[pos], (unsigned)len) == "jit")
+                    {
+                        // Mark the whole module for JIT compilation
+                        jitCompile_ = true;
+                        pos += len;
+                        memset(&buffer[start], ' ', pos - start);
+                    }
+                }
             }
         }
         // Don't search includes within statement blocks or between tokens in statements
@@ -958,6 +983,7 @@ void ScriptFile::ReleaseModule()
     {
         // Clear search caches and event handlers
         includeFiles_.Clear();
+        jitCompile_ = false;
         validClasses_.Clear();
         functions_.Clear();
         methods_.Clear();
@@ -112,6 +112,8 @@ public:
 
     /// Return whether script compiled successfully.
     bool IsCompiled() const { return compiled_; }
+    /// Return whether the module is marked for JIT compilation with #pragma jit.
+    bool IsJITCompile() const { return jitCompile_; }
 
     /// Clean up an event invoker object when its associated script object no longer exists.
     void CleanupEventInvoker(asIScriptObject* object);
@@ -136,6 +138,8 @@ private:
     bool compiled_{};
     /// Subscribed to application update event flag.
     bool subscribed_{};
+    /// JIT compilation requested flag.
+    bool jitCompile_{};
     /// Encountered include files during script file loading.
     HashSet<String> includeFiles_;
     /// Search cache for checking whether script classes implement "ScriptObject" interface.
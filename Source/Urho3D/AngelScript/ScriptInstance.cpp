@@ -229,6 +229,33 @@ void ScriptInstance::OnSetEnabled()
     UpdateEventSubscription();
 }
 
+void ScriptInstance::OnSceneUpdate(UpdatePhase phase, float timeStep)
+{
+    switch (phase)
+    {
+    case UPDATE_PHASE_UPDATE:
+        HandleSceneUpdate(timeStep);
+        break;
+
+    case UPDATE_PHASE_POSTUPDATE:
+        HandleScenePostUpdate(timeStep);
+        break;
+
+#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
+    case UPDATE_PHASE_FIXEDUPDATE:
+        HandlePhysicsPreStep(timeStep);
+        break;
+
+    case UPDATE_PHASE_FIXEDPOSTUPDATE:
+        HandlePhysicsPostStep(timeStep);
+        break;
+#endif
+
+    default:
+        break;
+    }
+}
+
 bool ScriptInstance::CreateObject(ScriptFile* scriptFile, const String& className)
 {
     className_ = String::EMPTY; // Do not create object during SetScriptFile()
@@ -330,6 +357,26 @@ void ScriptInstance::ClearDelayedExecute(const String& declaration)
     }
 }
 
+void ScriptInstance::SetEventDispatch(bool enable)
+{
+    if (enable == eventDispatch_)
+        return;
+
+    // Unsubscribe through the old mechanism, then subscribe again through the new
+    Scene* scene = GetScene();
+    if (scene)
+    {
+        for (unsigned i = 0; i < MAX_UPDATE_PHASES; ++i)
+            SetUpdatePhase(scene, (UpdatePhase)i, false);
+    }
+    subscribed_ = false;
+    subscribedPostFixed_ = false;
+
+    eventDispatch_ = enable;
+    if (scene)
+        UpdateEventSubscription();
+}
+
 void ScriptInstance::AddEventHandler(StringHash eventType, const String& handlerName)
 {
     if (!scriptObject_)
@@ -535,12 +582,16 @@ void ScriptInstance::OnSceneSet(Scene* scene)
         UpdateEventSubscription();
     else
     {
-        UnsubscribeFromEvent(E_SCENEUPDATE);
-        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+        // The scene has already removed this component from its direct update registry
+        if (eventDispatch_)
+        {
+            UnsubscribeFromEvent(E_SCENEUPDATE);
+            UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
-        UnsubscribeFromEvent(E_PHYSICSPRESTEP);
-        UnsubscribeFromEvent(E_PHYSICSPOSTSTEP);
+            UnsubscribeFromEvent(E_PHYSICSPRESTEP);
+            UnsubscribeFromEvent(E_PHYSICSPOSTSTEP);
 #endif
+        }
         subscribed_ = false;
         subscribedPostFixed_ = false;
     }
@@ -597,6 +648,12 @@ void ScriptInstance::ReleaseObject()
         UnsubscribeFromAllEventsExcept(exceptions, false);
         if (node_)
             node_->RemoveListener(this);
+        Scene* scene = GetScene();
+        if (scene)
+        {
+            for (unsigned i = 0; i < MAX_UPDATE_PHASES; ++i)
+                scene->RemoveUpdateComponent((UpdatePhase)i, this);
+        }
         subscribed_ = false;
         subscribedPostFixed_ = false;
 
@@ -775,14 +832,14 @@ void ScriptInstance::UpdateEventSubscription()
     {
         if (!subscribed_ && (methods_[METHOD_UPDATE] || methods_[METHOD_DELAYEDSTART] || delayedCalls_.Size()))
         {
-            SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(ScriptInstance, HandleSceneUpdate));
+            SetUpdatePhase(scene, UPDATE_PHASE_UPDATE, true);
             subscribed_ = true;
         }
 
         if (!subscribedPostFixed_)
         {
             if (methods_[METHOD_POSTUPDATE])
-                SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(ScriptInstance, HandleScenePostUpdate));
+                SetUpdatePhase(scene, UPDATE_PHASE_POSTUPDATE, true);
 
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
             if (methods_[METHOD_FIXEDUPDATE] || methods_[METHOD_FIXEDPOSTUPDATE])
@@ -792,9 +849,9 @@ void ScriptInstance::UpdateEventSubscription()
                 if (world)
                 {
                     if (methods_[METHOD_FIXEDUPDATE])
-                        SubscribeToEvent(world, E_PHYSICSPRESTEP, URHO3D_HANDLER(ScriptInstance, HandlePhysicsPreStep));
+                        SetUpdatePhase(scene, UPDATE_PHASE_FIXEDUPDATE, true);
                     if (methods_[METHOD_FIXEDPOSTUPDATE])
-                        SubscribeToEvent(world, E_PHYSICSPOSTSTEP, URHO3D_HANDLER(ScriptInstance, HandlePhysicsPostStep));
+                        SetUpdatePhase(scene, UPDATE_PHASE_FIXEDPOSTUPDATE, true);
                 }
                 else
                     URHO3D_LOGERROR("No physics world, can not subscribe script object to fixed update events");
@@ -810,23 +867,15 @@ void ScriptInstance::UpdateEventSubscription()
     {
         if (subscribed_)
         {
-            UnsubscribeFromEvent(scene, E_SCENEUPDATE);
+            SetUpdatePhase(scene, UPDATE_PHASE_UPDATE, false);
             subscribed_ = false;
         }
 
         if (subscribedPostFixed_)
         {
-            UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
-
-#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
-            Component* world = GetFixedUpdateSource();
-            if (world)
-            {
-                UnsubscribeFromEvent(world, E_PHYSICSPRESTEP);
-                UnsubscribeFromEvent(world, E_PHYSICSPOSTSTEP);
-            }
-#endif
-
+            SetUpdatePhase(scene, UPDATE_PHASE_POSTUPDATE, false);
+            SetUpdatePhase(scene, UPDATE_PHASE_FIXEDUPDATE, false);
+            SetUpdatePhase(scene, UPDATE_PHASE_FIXEDPOSTUPDATE, false);
             subscribedPostFixed_ = false;
         }
 
@@ -835,15 +884,78 @@ void ScriptInstance::UpdateEventSubscription()
     }
 }
 
-void ScriptInstance::HandleSceneUpdate(StringHash eventType, VariantMap& eventData)
+void ScriptInstance::SetUpdatePhase(Scene* scene, UpdatePhase phase, bool enable)
 {
-    if (!scriptObject_)
+    if (!eventDispatch_)
+    {
+        if (enable)
+            scene->AddUpdateComponent(phase, this);
+        else
+            scene->RemoveUpdateComponent(phase, this);
+        return;
+    }
+
+    Object* sender = scene;
+    StringHash eventType;
+    switch (phase)
+    {
+    case UPDATE_PHASE_UPDATE:
+        eventType = E_SCENEUPDATE;
+        break;
+
+    case UPDATE_PHASE_POSTUPDATE:
+        eventType = E_SCENEPOSTUPDATE;
+        break;
+
+#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
+    case UPDATE_PHASE_FIXEDUPDATE:
+        sender = GetFixedUpdateSource();
+        eventType = E_PHYSICSPRESTEP;
+        break;
+
+    case UPDATE_PHASE_FIXEDPOSTUPDATE:
+        sender = GetFixedUpdateSource();
+        eventType = E_PHYSICSPOSTSTEP;
+        break;
+#endif
+
+    default:
+        return;
+    }
+
+    if (!sender)
         return;
 
+    if (enable)
+        SubscribeToEvent(sender, eventType, URHO3D_HANDLER(ScriptInstance, HandleUpdateEvent));
+    else
+        UnsubscribeFromEvent(sender, eventType);
+}
+
+void ScriptInstance::HandleUpdateEvent(StringHash eventType, VariantMap& eventData)
+{
     using namespace SceneUpdate;
 
+    // The physics events use the same timestep parameter
     float timeStep = eventData[P_TIMESTEP].GetFloat();
 
+    if (eventType == E_SCENEUPDATE)
+        HandleSceneUpdate(timeStep);
+    else if (eventType == E_SCENEPOSTUPDATE)
+        HandleScenePostUpdate(timeStep);
+#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
+    else if (eventType == E_PHYSICSPRESTEP)
+        HandlePhysicsPreStep(timeStep);
+    else if (eventType == E_PHYSICSPOSTSTEP)
+        HandlePhysicsPostStep(timeStep);
+#endif
+}
+
+void ScriptInstance::HandleSceneUpdate(float timeStep)
+{
+    if (!scriptObject_)
+        return;
+
     // Execute delayed calls
     for (unsigned i = 0; i < delayedCalls_.Size();)
     {
@@ -882,21 +994,19 @@ void ScriptInstance::HandleSceneUpdate(StringHash eventType, VariantMap& eventDa
     }
 }
 
-void ScriptInstance::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+void ScriptInstance::HandleScenePostUpdate(float timeStep)
 {
     if (!scriptObject_)
         return;
 
-    using namespace ScenePostUpdate;
-
     VariantVector parameters;
-    parameters.Push(eventData[P_TIMESTEP]);
+    parameters.Push(timeStep);
     scriptFile_->Execute(scriptObject_, methods_[METHOD_POSTUPDATE], parameters);
 }
 
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
 
-void ScriptInstance::HandlePhysicsPreStep(StringHash eventType, VariantMap& eventData)
+void ScriptInstance::HandlePhysicsPreStep(float timeStep)
 {
     if (!scriptObject_)
         return;
@@ -908,22 +1018,18 @@ void ScriptInstance::HandlePhysicsPreStep(StringHash eventType, VariantMap& even
         methods_[METHOD_DELAYEDSTART] = nullptr;  // Only execute once
     }
 
-    using namespace PhysicsPreStep;
-
     VariantVector parameters;
-    parameters.Push(eventData[P_TIMESTEP]);
+    parameters.Push(timeStep);
     scriptFile_->Execute(scriptObject_, methods_[METHOD_FIXEDUPDATE], parameters);
 }
 
-void ScriptInstance::HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData)
+void ScriptInstance::HandlePhysicsPostStep(float timeStep)
 {
     if (!scriptObject_)
         return;
 
-    using namespace PhysicsPostStep;
-
     VariantVector parameters;
-    parameters.Push(eventData[P_TIMESTEP]);
+    parameters.Push(timeStep);
     scriptFile_->Execute(scriptObject_, methods_[METHOD_FIXEDPOSTUPDATE], parameters);
 }
 
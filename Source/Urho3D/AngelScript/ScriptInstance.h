@@ -81,6 +81,8 @@ public:
     void ApplyAttributes() override;
     /// Handle enabled/disabled state change.
     void OnSetEnabled() override;
+    /// Handle an update phase called directly by the scene.
+    void OnSceneUpdate(UpdatePhase phase, float timeStep) override;
 
     /// Add a scripted event handler.
     void AddEventHandler(StringHash eventType, const String& handlerName) override;
@@ -116,6 +118,8 @@ public:
         (float delay, bool repeat, const String& declaration, const VariantVector& parameters = Variant::emptyVariantVector);
     /// Clear pending delay-executed method calls. If empty declaration given, clears all.
     void ClearDelayedExecute(const String& declaration = String::EMPTY);
+    /// Set whether to receive the update methods through the scene and physics update events instead of being called directly by the scene. Use this when the script object's update needs to be ordered relative to other event handlers. Default false.
+    void SetEventDispatch(bool enable);
 
     /// Return script file.
     ScriptFile* GetScriptFile() const { return scriptFile_; }
@@ -126,6 +130,9 @@ public:
     /// Return class name.
     const String& GetClassName() const { return className_; }
 
+    /// Return whether receives the update methods through the update events.
+    bool GetEventDispatch() const { return eventDispatch_; }
+
     /// Check if the object is derived from a class.
     bool IsA(const String& className) const;
     /// Check if has a method.
@@ -173,15 +180,19 @@ private:
     void ClearScriptAttributes();
     /// Subscribe/unsubscribe from scene updates as necessary.
     void UpdateEventSubscription();
-    /// Handle scene update event.
-    void HandleSceneUpdate(StringHash eventType, VariantMap& eventData);
-    /// Handle scene post-update event.
-    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    /// Subscribe/unsubscribe from one update phase, either in the scene's direct update registry or through the update event.
+    void SetUpdatePhase(Scene* scene, UpdatePhase phase, bool enable);
+    /// Handle an update event when event dispatch is in use.
+    void HandleUpdateEvent(StringHash eventType, VariantMap& eventData);
+    /// Handle scene update.
+    void HandleSceneUpdate(float timeStep);
+    /// Handle scene post-update.
+    void HandleScenePostUpdate(float timeStep);
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
-    /// Handle physics pre-step event.
-    void HandlePhysicsPreStep(StringHash eventType, VariantMap& eventData);
-    /// Handle physics post-step event.
-    void HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData);
+    /// Handle physics pre-step.
+    void HandlePhysicsPreStep(float timeStep);
+    /// Handle physics post-step.
+    void HandlePhysicsPostStep(float timeStep);
 #endif
     /// Handle an event in script.
     void HandleScriptEvent(StringHash eventType, VariantMap& eventData);
@@ -210,6 +221,8 @@ private:
     bool subscribed_{};
     /// Subscribed to scene post and fixed update events flag.
     bool subscribedPostFixed_{};
+    /// Receive updates through the update events flag.
+    bool eventDispatch_{};
 };
 
 /// Return the active AngelScript context. Provided as a wrapper to the AngelScript API function to avoid undefined symbol error in shared library Urho3D builds.
@@ -0,0 +1,884 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../AngelScript/ScriptNativeCompiler.h"
+#include "../Container/HashSet.h"
+#include "../Math/MathDefs.h"
+
+#include <cstdio>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Return size of a bytecode instruction in DWORDs.
+static unsigned GetInstructionSize(asEBCInstr op)
+{
+    return (unsigned)asBCTypeSize[asBCInfo[op].type];
+}
+
+/// Return mask of the bytes of a bytecode instruction that hold operands. The rest are the opcode and padding, which is not
+/// initialized when the bytecode is loaded.
+static unsigned GetOperandMask(asEBCInstr op)
+{
+    switch (asBCInfo[op].type)
+    {
+    case asBCTYPE_W_ARG:
+    case asBCTYPE_wW_ARG:
+    case asBCTYPE_rW_ARG:
+        return 0x000c;
+
+    case asBCTYPE_DW_ARG:
+        return 0x00f0;
+
+    case asBCTYPE_rW_DW_ARG:
+    case asBCTYPE_wW_DW_ARG:
+    case asBCTYPE_W_DW_ARG:
+    case asBCTYPE_wW_rW_rW_ARG:
+        return 0x00fc;
+
+    case asBCTYPE_QW_ARG:
+    case asBCTYPE_DW_DW_ARG:
+        return 0x0ff0;
+
+    case asBCTYPE_wW_QW_ARG:
+    case asBCTYPE_rW_QW_ARG:
+    case asBCTYPE_rW_DW_DW_ARG:
+        return 0x0ffc;
+
+    case asBCTYPE_wW_rW_ARG:
+    case asBCTYPE_rW_rW_ARG:
+    case asBCTYPE_wW_W_ARG:
+        return 0x003c;
+
+    case asBCTYPE_wW_rW_DW_ARG:
+    case asBCTYPE_rW_W_DW_ARG:
+        return 0x0f3c;
+
+    case asBCTYPE_QW_DW_ARG:
+        return 0xfff0;
+
+    default:
+        return 0;
+    }
+}
+
+/// Return the target position of a jump instruction, or -1 if the instruction is not a jump.
+static int GetJumpTarget(const asDWORD* bc, unsigned pos)
+{
+    switch (*(const asBYTE*)bc)
+    {
+    case asBC_JMP:
+    case asBC_JZ:
+    case asBC_JNZ:
+    case asBC_JS:
+    case asBC_JNS:
+    case asBC_JP:
+    case asBC_JNP:
+    case asBC_JLowZ:
+    case asBC_JLowNZ:
+        return (int)pos + 2 + asBC_INTARG(bc);
+
+    default:
+        return -1;
+    }
+}
+
+/// Return the address of a variable in the stack frame of a translated function.
+static String Address(short offset)
+{
+    return offset >= 0 ? "fp - " + String((int)offset) : "fp + " + String(-(int)offset);
+}
+
+/// Return an expression loading a variable.
+static String Load(const char* type, short offset)
+{
+    return String("ScriptNativeLoad<") + type + ">(" + Address(offset) + ")";
+}
+
+/// Return a statement storing an expression to a variable.
+static String Store(const char* type, short offset, const String& value)
+{
+    return String("    ScriptNativeStore<") + type + ">(" + Address(offset) + ", " + value + ");\n";
+}
+
+/// Return a statement storing the result of a binary operation on two variables to a third.
+static String Binary(const char* type, const asDWORD* bc, const char* op)
+{
+    return Store(type, asBC_SWORDARG0(bc), Load(type, asBC_SWORDARG1(bc)) + " " + op + " " + Load(type, asBC_SWORDARG2(bc)));
+}
+
+/// Return a statement storing the comparison of two values to the value register.
+static String Compare(const char* type, const String& lhs, const String& rhs)
+{
+    return String("    ScriptNativeStore<int>(&value, ScriptNativeCompare<") + type + ">(" + lhs + ", " + rhs + "));\n";
+}
+
+/// Return a statement incrementing or decrementing the value the value register points to.
+static String Increment(const char* type, const char* op)
+{
+    return String("    ScriptNativeStore<") + type + ">(ScriptNativeLoad<void*>(&value), " + type + "(ScriptNativeLoad<" + type +
+        ">(ScriptNativeLoad<void*>(&value)) " + op + " 1));\n";
+}
+
+/// Return a statement converting a variable in place.
+static String Convert(const char* destType, const char* sourceType, const asDWORD* bc)
+{
+    short offset = asBC_SWORDARG0(bc);
+    return Store(destType, offset, String(destType) + "(" + Load(sourceType, offset) + ")");
+}
+
+/// Return a statement converting a variable to another.
+static String ConvertFrom(const char* destType, const char* sourceType, const asDWORD* bc)
+{
+    return Store(destType, asBC_SWORDARG0(bc), String(destType) + "(" + Load(sourceType, asBC_SWORDARG1(bc)) + ")");
+}
+
+/// Return a statement replacing a variable with its low byte or word and clearing the rest of the DWORD.
+static String Truncate(const char* type, short offset, const String& source)
+{
+    return String("    {\n") +
+        "        " + type + " low = " + source + ";\n"
+        "        ScriptNativeStore<asDWORD>(" + Address(offset) + ", 0u);\n"
+        "        ScriptNativeStore<" + type + ">(" + Address(offset) + ", low);\n"
+        "    }\n";
+}
+
+/// Return a DWORD constant.
+static String DWordConstant(asDWORD value)
+{
+    char buffer[CONVERSION_BUFFER_LENGTH];
+    sprintf(buffer, "0x%08Xu", value);
+    return String(buffer);
+}
+
+/// Return a QWORD constant.
+static String QWordConstant(asQWORD value)
+{
+    char buffer[CONVERSION_BUFFER_LENGTH];
+    sprintf(buffer, "0x%016llXull", (unsigned long long)value);
+    return String(buffer);
+}
+
+/// Return a float constant from its bits.
+static String FloatConstant(asDWORD bits)
+{
+    return "ScriptNativeFloat(" + DWordConstant(bits) + ")";
+}
+
+/// Return a statement that returns to the virtual machine to execute the instruction at a position.
+static String Exit(unsigned pos)
+{
+    return "    {\n"
+        "        regs->programPointer = bc + " + String(pos) + ";\n"
+        "        regs->valueRegister = value;\n"
+        "        return;\n"
+        "    }\n";
+}
+
+/// Translate a bytecode instruction to C++ statements. Return false if the instruction is left to the virtual machine.
+static bool TranslateInstruction(String& code, const asDWORD* bc, unsigned pos)
+{
+    switch (*(const asBYTE*)bc)
+    {
+    case asBC_JitEntry:
+        // Only a label for resuming the translation
+        return true;
+
+    case asBC_SUSPEND:
+        // Let the virtual machine call the line callback or suspend the context
+        code += "    if (regs->doProcessSuspend)\n" + Exit(pos);
+        return true;
+
+    case asBC_JMP:
+        code += "    goto bc" + String(GetJumpTarget(bc, pos)) + ";\n";
+        return true;
+
+    case asBC_JZ:
+    case asBC_JNZ:
+    case asBC_JS:
+    case asBC_JNS:
+    case asBC_JP:
+    case asBC_JNP:
+    case asBC_JLowZ:
+    case asBC_JLowNZ:
+        {
+            static const char* conditions[] = {"== 0", "!= 0", "< 0", ">= 0", "> 0", "<= 0"};
+            asBYTE op = *(const asBYTE*)bc;
+            if (op == asBC_JLowZ || op == asBC_JLowNZ)
+                code += String("    if (ScriptNativeLoad<asBYTE>(&value) ") + (op == asBC_JLowZ ? "== 0" : "!= 0");
+            else
+                code += String("    if (ScriptNativeLoad<int>(&value) ") + conditions[op - asBC_JZ];
+            code += ")\n        goto bc" + String(GetJumpTarget(bc, pos)) + ";\n";
+        }
+        return true;
+
+    case asBC_CMPi:
+        code += Compare("int", Load("int", asBC_SWORDARG0(bc)), Load("int", asBC_SWORDARG1(bc)));
+        return true;
+
+    case asBC_CMPu:
+        code += Compare("asDWORD", Load("asDWORD", asBC_SWORDARG0(bc)), Load("asDWORD", asBC_SWORDARG1(bc)));
+        return true;
+
+    case asBC_CMPf:
+        code += Compare("float", Load("float", asBC_SWORDARG0(bc)), Load("float", asBC_SWORDARG1(bc)));
+        return true;
+
+    case asBC_CMPd:
+        code += Compare("double", Load("double", asBC_SWORDARG0(bc)), Load("double", asBC_SWORDARG1(bc)));
+        return true;
+
+    case asBC_CMPi64:
+        code += Compare("asINT64", Load("asINT64", asBC_SWORDARG0(bc)), Load("asINT64", asBC_SWORDARG1(bc)));
+        return true;
+
+    case asBC_CMPu64:
+        code += Compare("asQWORD", Load("asQWORD", asBC_SWORDARG0(bc)), Load("asQWORD", asBC_SWORDARG1(bc)));
+        return true;
+
+    case asBC_CMPIi:
+        code += Compare("int", Load("int", asBC_SWORDARG0(bc)), "int(" + DWordConstant(asBC_DWORDARG(bc)) + ")");
+        return true;
+
+    case asBC_CMPIu:
+        code += Compare("asDWORD", Load("asDWORD", asBC_SWORDARG0(bc)), DWordConstant(asBC_DWORDARG(bc)));
+        return true;
+
+    case asBC_CMPIf:
+        code += Compare("float", Load("float", asBC_SWORDARG0(bc)), FloatConstant(asBC_DWORDARG(bc)));
+        return true;
+
+    // Integer arithmetic is done unsigned, so that overflow wraps like in the virtual machine instead of being undefined
+    case asBC_NEGi:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), "0u - " + Load("asDWORD", asBC_SWORDARG0(bc)));
+        return true;
+
+    case asBC_NEGf:
+        code += Store("float", asBC_SWORDARG0(bc), "-" + Load("float", asBC_SWORDARG0(bc)));
+        return true;
+
+    case asBC_NEGd:
+        code += Store("double", asBC_SWORDARG0(bc), "-" + Load("double", asBC_SWORDARG0(bc)));
+        return true;
+
+    case asBC_NEGi64:
+        code += Store("asQWORD", asBC_SWORDARG0(bc), "0ull - " + Load("asQWORD", asBC_SWORDARG0(bc)));
+        return true;
+
+    case asBC_BNOT:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), "~" + Load("asDWORD", asBC_SWORDARG0(bc)));
+        return true;
+
+    case asBC_BNOT64:
+        code += Store("asQWORD", asBC_SWORDARG0(bc), "~" + Load("asQWORD", asBC_SWORDARG0(bc)));
+        return true;
+
+    case asBC_INCi8:
+        code += Increment("asBYTE", "+");
+        return true;
+
+    case asBC_DECi8:
+        code += Increment("asBYTE", "-");
+        return true;
+
+    case asBC_INCi16:
+        code += Increment("asWORD", "+");
+        return true;
+
+    case asBC_DECi16:
+        code += Increment("asWORD", "-");
+        return true;
+
+    case asBC_INCi:
+        code += Increment("asDWORD", "+");
+        return true;
+
+    case asBC_DECi:
+        code += Increment("asDWORD", "-");
+        return true;
+
+    case asBC_INCi64:
+        code += Increment("asQWORD", "+");
+        return true;
+
+    case asBC_DECi64:
+        code += Increment("asQWORD", "-");
+        return true;
+
+    case asBC_INCf:
+        code += Increment("float", "+");
+        return true;
+
+    case asBC_DECf:
+        code += Increment("float", "-");
+        return true;
+
+    case asBC_INCd:
+        code += Increment("double", "+");
+        return true;
+
+    case asBC_DECd:
+        code += Increment("double", "-");
+        return true;
+
+    case asBC_IncVi:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), Load("asDWORD", asBC_SWORDARG0(bc)) + " + 1u");
+        return true;
+
+    case asBC_DecVi:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), Load("asDWORD", asBC_SWORDARG0(bc)) + " - 1u");
+        return true;
+
+    case asBC_BAND:
+        code += Binary("asDWORD", bc, "&");
+        return true;
+
+    case asBC_BOR:
+        code += Binary("asDWORD", bc, "|");
+        return true;
+
+    case asBC_BXOR:
+        code += Binary("asDWORD", bc, "^");
+        return true;
+
+    case asBC_BSLL:
+        code += Binary("asDWORD", bc, "<<");
+        return true;
+
+    case asBC_BSRL:
+        code += Binary("asDWORD", bc, ">>");
+        return true;
+
+    case asBC_BSRA:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), Load("int", asBC_SWORDARG1(bc)) + " >> " + Load("asDWORD", asBC_SWORDARG2(bc)));
+        return true;
+
+    case asBC_BAND64:
+        code += Binary("asQWORD", bc, "&");
+        return true;
+
+    case asBC_BOR64:
+        code += Binary("asQWORD", bc, "|");
+        return true;
+
+    case asBC_BXOR64:
+        code += Binary("asQWORD", bc, "^");
+        return true;
+
+    case asBC_BSLL64:
+        code += Store("asQWORD", asBC_SWORDARG0(bc), Load("asQWORD", asBC_SWORDARG1(bc)) + " << " + Load("asDWORD", asBC_SWORDARG2(bc)));
+        return true;
+
+    case asBC_BSRL64:
+        code += Store("asQWORD", asBC_SWORDARG0(bc), Load("asQWORD", asBC_SWORDARG1(bc)) + " >> " + Load("asDWORD", asBC_SWORDARG2(bc)));
+        return true;
+
+    case asBC_BSRA64:
+        code += Store("asINT64", asBC_SWORDARG0(bc), Load("asINT64", asBC_SWORDARG1(bc)) + " >> " + Load("asDWORD", asBC_SWORDARG2(bc)));
+        return true;
+
+    case asBC_ADDi:
+        code += Binary("asDWORD", bc, "+");
+        return true;
+
+    case asBC_SUBi:
+        code += Binary("asDWORD", bc, "-");
+        return true;
+
+    case asBC_MULi:
+        code += Binary("asDWORD", bc, "*");
+        return true;
+
+    case asBC_ADDf:
+        code += Binary("float", bc, "+");
+        return true;
+
+    case asBC_SUBf:
+        code += Binary("float", bc, "-");
+        return true;
+
+    case asBC_MULf:
+        code += Binary("float", bc, "*");
+        return true;
+
+    case asBC_ADDd:
+        code += Binary("double", bc, "+");
+        return true;
+
+    case asBC_SUBd:
+        code += Binary("double", bc, "-");
+        return true;
+
+    case asBC_MULd:
+        code += Binary("double", bc, "*");
+        return true;
+
+    case asBC_ADDi64:
+        code += Binary("asQWORD", bc, "+");
+        return true;
+
+    case asBC_SUBi64:
+        code += Binary("asQWORD", bc, "-");
+        return true;
+
+    case asBC_MULi64:
+        code += Binary("asQWORD", bc, "*");
+        return true;
+
+    // Division by zero and overflow raise a script exception, so leave them to the virtual machine
+    case asBC_DIVi:
+    case asBC_MODi:
+        code += "    if (" + Load("int", asBC_SWORDARG2(bc)) + " == 0 || (" + Load("int", asBC_SWORDARG2(bc)) + " == -1 && " +
+            Load("int", asBC_SWORDARG1(bc)) + " == int(0x80000000u)))\n" + Exit(pos);
+        code += Binary("int", bc, *(const asBYTE*)bc == asBC_DIVi ? "/" : "%");
+        return true;
+
+    case asBC_DIVu:
+    case asBC_MODu:
+        code += "    if (" + Load("asDWORD", asBC_SWORDARG2(bc)) + " == 0u)\n" + Exit(pos);
+        code += Binary("asDWORD", bc, *(const asBYTE*)bc == asBC_DIVu ? "/" : "%");
+        return true;
+
+    case asBC_DIVf:
+        code += "    if (" + Load("float", asBC_SWORDARG2(bc)) + " == 0.0f)\n" + Exit(pos);
+        code += Binary("float", bc, "/");
+        return true;
+
+    case asBC_MODf:
+        code += "    if (" + Load("float", asBC_SWORDARG2(bc)) + " == 0.0f)\n" + Exit(pos);
+        code += Store("float", asBC_SWORDARG0(bc), "fmodf(" + Load("float", asBC_SWORDARG1(bc)) + ", " + Load("float", asBC_SWORDARG2(bc)) + ")");
+        return true;
+
+    case asBC_DIVd:
+        code += "    if (" + Load("double", asBC_SWORDARG2(bc)) + " == 0.0)\n" + Exit(pos);
+        code += Binary("double", bc, "/");
+        return true;
+
+    case asBC_MODd:
+        code += "    if (" + Load("double", asBC_SWORDARG2(bc)) + " == 0.0)\n" + Exit(pos);
+        code += Store("double", asBC_SWORDARG0(bc), "fmod(" + Load("double", asBC_SWORDARG1(bc)) + ", " + Load("double", asBC_SWORDARG2(bc)) + ")");
+        return true;
+
+    case asBC_ADDIi:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), Load("asDWORD", asBC_SWORDARG1(bc)) + " + " + DWordConstant(bc[2]));
+        return true;
+
+    case asBC_SUBIi:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), Load("asDWORD", asBC_SWORDARG1(bc)) + " - " + DWordConstant(bc[2]));
+        return true;
+
+    case asBC_MULIi:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), Load("asDWORD", asBC_SWORDARG1(bc)) + " * " + DWordConstant(bc[2]));
+        return true;
+
+    case asBC_ADDIf:
+        code += Store("float", asBC_SWORDARG0(bc), Load("float", asBC_SWORDARG1(bc)) + " + " + FloatConstant(bc[2]));
+        return true;
+
+    case asBC_SUBIf:
+        code += Store("float", asBC_SWORDARG0(bc), Load("float", asBC_SWORDARG1(bc)) + " - " + FloatConstant(bc[2]));
+        return true;
+
+    case asBC_MULIf:
+        code += Store("float", asBC_SWORDARG0(bc), Load("float", asBC_SWORDARG1(bc)) + " * " + FloatConstant(bc[2]));
+        return true;
+
+    case asBC_SetV1:
+    case asBC_SetV2:
+    case asBC_SetV4:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), DWordConstant(asBC_DWORDARG(bc)));
+        return true;
+
+    case asBC_SetV8:
+        code += Store("asQWORD", asBC_SWORDARG0(bc), QWordConstant(asBC_QWORDARG(bc)));
+        return true;
+
+    case asBC_CpyVtoV4:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), Load("asDWORD", asBC_SWORDARG1(bc)));
+        return true;
+
+    case asBC_CpyVtoV8:
+        code += Store("asQWORD", asBC_SWORDARG0(bc), Load("asQWORD", asBC_SWORDARG1(bc)));
+        return true;
+
+    case asBC_CpyVtoR4:
+        code += "    ScriptNativeStore<asDWORD>(&value, " + Load("asDWORD", asBC_SWORDARG0(bc)) + ");\n";
+        return true;
+
+    case asBC_CpyVtoR8:
+        code += "    value = " + Load("asQWORD", asBC_SWORDARG0(bc)) + ";\n";
+        return true;
+
+    case asBC_CpyRtoV4:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), "ScriptNativeLoad<asDWORD>(&value)");
+        return true;
+
+    case asBC_CpyRtoV8:
+        code += Store("asQWORD", asBC_SWORDARG0(bc), "value");
+        return true;
+
+    case asBC_ClrVPtr:
+        code += Store("asPWORD", asBC_SWORDARG0(bc), "0");
+        return true;
+
+    case asBC_LDV:
+        code += "    ScriptNativeStore<void*>(&value, " + Address(asBC_SWORDARG0(bc)) + ");\n";
+        return true;
+
+    case asBC_WRTV1:
+    case asBC_WRTV2:
+    case asBC_WRTV4:
+    case asBC_WRTV8:
+        {
+            static const char* types[] = {"asBYTE", "asWORD", "asDWORD", "asQWORD"};
+            const char* type = types[*(const asBYTE*)bc - asBC_WRTV1];
+            code += String("    ScriptNativeStore<") + type + ">(ScriptNativeLoad<void*>(&value), " + Load(type, asBC_SWORDARG0(bc)) + ");\n";
+        }
+        return true;
+
+    case asBC_RDR1:
+        code += Truncate("asBYTE", asBC_SWORDARG0(bc), "ScriptNativeLoad<asBYTE>(ScriptNativeLoad<void*>(&value))");
+        return true;
+
+    case asBC_RDR2:
+        code += Truncate("asWORD", asBC_SWORDARG0(bc), "ScriptNativeLoad<asWORD>(ScriptNativeLoad<void*>(&value))");
+        return true;
+
+    case asBC_RDR4:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), "ScriptNativeLoad<asDWORD>(ScriptNativeLoad<void*>(&value))");
+        return true;
+
+    case asBC_RDR8:
+        code += Store("asQWORD", asBC_SWORDARG0(bc), "ScriptNativeLoad<asQWORD>(ScriptNativeLoad<void*>(&value))");
+        return true;
+
+    case asBC_iTOb:
+        code += Truncate("asBYTE", asBC_SWORDARG0(bc), "asBYTE(" + Load("asDWORD", asBC_SWORDARG0(bc)) + ")");
+        return true;
+
+    case asBC_iTOw:
+        code += Truncate("asWORD", asBC_SWORDARG0(bc), "asWORD(" + Load("asDWORD", asBC_SWORDARG0(bc)) + ")");
+        return true;
+
+    case asBC_iTOf:
+        code += Convert("float", "int", bc);
+        return true;
+
+    case asBC_fTOi:
+        code += Convert("int", "float", bc);
+        return true;
+
+    case asBC_uTOf:
+        code += Convert("float", "asDWORD", bc);
+        return true;
+
+    case asBC_fTOu:
+        // Converted through int like in the virtual machine
+        code += Store("asDWORD", asBC_SWORDARG0(bc), "asDWORD(int(" + Load("float", asBC_SWORDARG0(bc)) + "))");
+        return true;
+
+    case asBC_sbTOi:
+        code += Convert("int", "signed char", bc);
+        return true;
+
+    case asBC_swTOi:
+        code += Convert("int", "short", bc);
+        return true;
+
+    case asBC_ubTOi:
+        code += Convert("int", "asBYTE", bc);
+        return true;
+
+    case asBC_uwTOi:
+        code += Convert("int", "asWORD", bc);
+        return true;
+
+    case asBC_dTOi:
+        code += ConvertFrom("int", "double", bc);
+        return true;
+
+    case asBC_dTOu:
+        code += Store("asDWORD", asBC_SWORDARG0(bc), "asDWORD(int(" + Load("double", asBC_SWORDARG1(bc)) + "))");
+        return true;
+
+    case asBC_dTOf:
+        code += ConvertFrom("float", "double", bc);
+        return true;
+
+    case asBC_iTOd:
+        code += ConvertFrom("double", "int", bc);
+        return true;
+
+    case asBC_uTOd:
+        code += ConvertFrom("double", "asDWORD", bc);
+        return true;
+
+    case asBC_fTOd:
+        code += ConvertFrom("double", "float", bc);
+        return true;
+
+    case asBC_i64TOi:
+        code += ConvertFrom("int", "asINT64", bc);
+        return true;
+
+    case asBC_uTOi64:
+        code += ConvertFrom("asINT64", "asDWORD", bc);
+        return true;
+
+    case asBC_iTOi64:
+        code += ConvertFrom("asINT64", "int", bc);
+        return true;
+
+    case asBC_fTOi64:
+        code += ConvertFrom("asINT64", "float", bc);
+        return true;
+
+    case asBC_dTOi64:
+        code += Convert("asINT64", "double", bc);
+        return true;
+
+    case asBC_fTOu64:
+        code += Store("asQWORD", asBC_SWORDARG0(bc), "asQWORD(asINT64(" + Load("float", asBC_SWORDARG1(bc)) + "))");
+        return true;
+
+    case asBC_dTOu64:
+        code += Store("asQWORD", asBC_SWORDARG0(bc), "asQWORD(asINT64(" + Load("double", asBC_SWORDARG0(bc)) + "))");
+        return true;
+
+    case asBC_i64TOf:
+        code += ConvertFrom("float", "asINT64", bc);
+        return true;
+
+    case asBC_u64TOf:
+        code += ConvertFrom("float", "asQWORD", bc);
+        return true;
+
+    case asBC_i64TOd:
+        code += Convert("double", "asINT64", bc);
+        return true;
+
+    case asBC_u64TOd:
+        code += Convert("double", "asQWORD", bc);
+        return true;
+
+    default:
+        // Calls, object and stack operations, and the instructions that depend on the engine's boolean representation
+        return false;
+    }
+}
+
+/// Translate a script function to a C++ function. Return false if it has no JIT entry points or nothing to translate.
+static bool TranslateFunction(String& source, asIScriptFunction* function, const String& name)
+{
+    asUINT length;
+    asDWORD* byteCode = function->GetByteCode(&length);
+    if (!byteCode)
+        return false;
+
+    // Collect the entry points and jump targets, which need labels
+    PODVector<unsigned> entries;
+    HashSet<unsigned> labels;
+    for (asUINT pos = 0; pos < length;)
+    {
+        auto op = (asEBCInstr)*(asBYTE*)&byteCode[pos];
+        if (op == asBC_JitEntry)
+        {
+            entries.Push(pos);
+            labels.Insert(pos);
+        }
+        int target = GetJumpTarget(&byteCode[pos], pos);
+        if (target >= 0)
+            labels.Insert((unsigned)target);
+        pos += GetInstructionSize(op);
+    }
+    if (entries.Empty())
+        return false;
+
+    String code;
+    unsigned numInstructions = 0;
+    unsigned numTranslated = 0;
+    for (asUINT pos = 0; pos < length;)
+    {
+        auto op = (asEBCInstr)*(asBYTE*)&byteCode[pos];
+        if (labels.Contains(pos))
+            code += "bc" + String(pos) + ":\n";
+        if (op != asBC_JitEntry && op != asBC_SUSPEND)
+            ++numInstructions;
+
+        if (TranslateInstruction(code, &byteCode[pos], pos))
+        {
+            if (op != asBC_JitEntry && op != asBC_SUSPEND)
+                ++numTranslated;
+        }
+        else
+            code += "    // " + String(asBCInfo[op].name) + "\n" + Exit(pos);
+
+        pos += GetInstructionSize(op);
+    }
+    if (!numTranslated)
+        return false;
+
+    source += "// " + String(function->GetDeclaration(true, true)) + ": " + String(numTranslated) + " of " + String(numInstructions) +
+        " instructions translated\n";
+    source += "void " + name + "(asSVMRegisters* regs, asPWORD entry)\n"
+        "{\n"
+        "    asDWORD* bc = regs->programPointer - (entry - 1);\n"
+        "    asDWORD* fp = regs->stackFramePointer;\n"
+        "    asQWORD value = regs->valueRegister;\n"
+        "\n"
+        "    switch (entry)\n"
+        "    {\n";
+    for (unsigned i = 0; i < entries.Size(); ++i)
+        source += "    case " + String(entries[i] + 1) + ": goto bc" + String(entries[i]) + ";\n";
+    source += "    default:\n"
+        "        // Not an entry point of this translation, continue in the virtual machine\n"
+        "        regs->programPointer += asBCTypeSize[asBCInfo[asBC_JitEntry].type];\n"
+        "        return;\n"
+        "    }\n"
+        "\n" + code + "}\n\n";
+    return true;
+}
+
+void ScriptNativeCompiler::AddFunctions(const ScriptNativeFunction* functions, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+        functions_[MakePair(String(functions[i].declaration_), functions[i].byteCodeHash_)] = functions[i].function_;
+}
+
+int ScriptNativeCompiler::CompileFunction(asIScriptFunction* function, asJITFunction* output)
+{
+    HashMap<Pair<String, unsigned>, asJITFunction>::ConstIterator i =
+        functions_.Find(MakePair(String(function->GetDeclaration(true, true)), GetByteCodeHash(function)));
+    // Functions without a translation, or whose script has changed since it was translated, stay interpreted
+    if (i == functions_.End())
+        return asNO_FUNCTION;
+
+    // Make each entry point resume the translation at its own position, which the translation finds from the JIT argument
+    asUINT length;
+    asDWORD* byteCode = function->GetByteCode(&length);
+    for (asUINT pos = 0; pos < length;)
+    {
+        auto op = (asEBCInstr)*(asBYTE*)&byteCode[pos];
+        if (op == asBC_JitEntry)
+            asBC_PTRARG(&byteCode[pos]) = pos + 1;
+        pos += GetInstructionSize(op);
+    }
+
+    *output = i->second_;
+    ++numCompiledFunctions_;
+    return asSUCCESS;
+}
+
+String ScriptNativeCompiler::Translate(asIScriptModule* module, const String& registerFunctionName)
+{
+    PODVector<asIScriptFunction*> functions;
+    for (asUINT i = 0; i < module->GetFunctionCount(); ++i)
+        functions.Push(module->GetFunctionByIndex(i));
+    for (asUINT i = 0; i < module->GetObjectTypeCount(); ++i)
+    {
+        asITypeInfo* type = module->GetObjectTypeByIndex(i);
+        for (asUINT j = 0; j < type->GetMethodCount(); ++j)
+            functions.Push(type->GetMethodByIndex(j, false));
+    }
+
+    String source = "// Native translation of script module " + String(module->GetName()) + ", generated by ScriptCompiler. Do not edit.\n"
+        "\n"
+        "#include <Urho3D/AngelScript/ScriptNativeCompiler.h>\n"
+        "\n"
+        "#include <cmath>\n"
+        "\n"
+        "using namespace Urho3D;\n"
+        "\n"
+        "namespace\n"
+        "{\n"
+        "\n";
+
+    String table;
+    unsigned count = 0;
+    for (unsigned i = 0; i < functions.Size(); ++i)
+    {
+        asIScriptFunction* function = functions[i];
+        String name = "NativeFunction" + String(count);
+        if (!TranslateFunction(source, function, name))
+            continue;
+
+        String declaration = String(function->GetDeclaration(true, true)).Replaced("\\", "\\\\").Replaced("\"", "\\\"");
+        table += "        {\"" + declaration + "\", " + DWordConstant(GetByteCodeHash(function)) + ", " + name + "},\n";
+        ++count;
+    }
+
+    source += "}\n"
+        "\n"
+        "void " + registerFunctionName + "(ScriptNativeCompiler* compiler)\n"
+        "{\n";
+    if (count)
+    {
+        source += "    static const ScriptNativeFunction functions[] =\n"
+            "    {\n" + table +
+            "    };\n"
+            "\n"
+            "    compiler->AddFunctions(functions, " + String(count) + ");\n";
+    }
+    else
+        source += "    // No translated functions\n    (void)compiler;\n";
+    source += "}\n";
+
+    return source;
+}
+
+unsigned ScriptNativeCompiler::GetByteCodeHash(asIScriptFunction* function)
+{
+    asUINT length;
+    const asDWORD* byteCode = function->GetByteCode(&length);
+    unsigned hash = 0;
+    String code;
+
+    // Hash the opcodes, and the operands of the translated instructions only, as the rest may contain pointers that change
+    // between runs. The JIT argument is excluded as well, as it is set when the function is linked
+    for (asUINT pos = 0; pos < length;)
+    {
+        auto op = (asEBCInstr)*(const asBYTE*)&byteCode[pos];
+        unsigned size = GetInstructionSize(op);
+        const auto* bytes = (const unsigned char*)&byteCode[pos];
+        hash = SDBMHash(hash, bytes[0]);
+        if (op != asBC_JitEntry && TranslateInstruction(code, &byteCode[pos], pos))
+        {
+            unsigned mask = GetOperandMask(op);
+            for (unsigned i = 1; i < size * sizeof(asDWORD); ++i)
+            {
+                if (mask & (1u << i))
+                    hash = SDBMHash(hash, bytes[i]);
+            }
+        }
+
+        code.Clear();
+        pos += size;
+    }
+
+    return hash;
+}
+
+}
@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+/// \file
+
+#pragma once
+
+#ifdef URHO3D_IS_BUILDING
+#include "Urho3D.h"
+#else
+#include <Urho3D/Urho3D.h>
+#endif
+
+#include "../Container/HashMap.h"
+#include "../Container/Pair.h"
+#include "../Container/Str.h"
+
+#include <AngelScript/angelscript.h>
+
+#include <cstring>
+
+namespace Urho3D
+{
+
+/// Native translation of a script function, generated ahead of time by ScriptNativeCompiler::Translate().
+struct ScriptNativeFunction
+{
+    /// Function declaration including the object type and namespace.
+    const char* declaration_;
+    /// Hash of the bytecode the translation was generated from.
+    unsigned byteCodeHash_;
+    /// Translated function. The JIT argument selects the entry point it resumes from.
+    asJITFunction function_;
+};
+
+/// Load a value from script memory without breaking strict aliasing. Used by the translated functions.
+template <class T> inline T ScriptNativeLoad(const void* address)
+{
+    T value;
+    memcpy(&value, address, sizeof value);
+    return value;
+}
+
+/// Store a value to script memory without breaking strict aliasing. Used by the translated functions.
+template <class T> inline void ScriptNativeStore(void* address, T value)
+{
+    memcpy(address, &value, sizeof value);
+}
+
+/// Compare two values like the AngelScript virtual machine. Used by the translated functions.
+template <class T> inline int ScriptNativeCompare(T lhs, T rhs)
+{
+    return lhs == rhs ? 0 : (lhs < rhs ? -1 : 1);
+}
+
+/// Reinterpret a constant operand of a bytecode instruction as float. Used by the translated functions.
+inline float ScriptNativeFloat(asDWORD bits)
+{
+    return ScriptNativeLoad<float>(&bits);
+}
+
+/// AngelScript JIT compiler that links the script functions of modules marked with #pragma jit to their ahead-of-time native translations.
+class URHO3D_API ScriptNativeCompiler : public asIJITCompiler
+{
+public:
+    /// Add translated functions. The table must stay valid for the lifetime of the compiler.
+    void AddFunctions(const ScriptNativeFunction* functions, unsigned count);
+    /// Link a script function to its translation if one exists for its current bytecode. Called by the script engine.
+    int CompileFunction(asIScriptFunction* function, asJITFunction* output) override;
+    /// Release a linked function. Called by the script engine.
+    void ReleaseJITFunction(asJITFunction func) override { }
+
+    /// Return number of script functions linked to their translations.
+    unsigned GetNumCompiledFunctions() const { return numCompiledFunctions_; }
+
+    /// Translate the script functions of a module compiled with JIT entry points to C++ source. The source defines a function with the given name that adds the translations to a compiler.
+    static String Translate(asIScriptModule* module, const String& registerFunctionName);
+    /// Return hash of the parts of a script function's bytecode that are translated to native code.
+    static unsigned GetByteCodeHash(asIScriptFunction* function);
+
+private:
+    /// Translated functions by declaration and bytecode hash.
+    HashMap<Pair<String, unsigned>, asJITFunction> functions_;
+    /// Number of script functions linked to their translations.
+    unsigned numCompiledFunctions_{};
+};
+
+}
@@ -441,6 +441,11 @@ static void RegisterPhysicsWorld2D(asIScriptEngine* engine)
     engine->RegisterObjectMethod("PhysicsWorld2D", "Array<RigidBody2D@>@ GetRigidBodies(const Rect&in, uint collisionMask = 0xffff)", asFUNCTION(PhysicsWorld2DGetRigidBodies), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("PhysicsWorld2D", "void set_updateEnabled(bool)", asMETHOD(PhysicsWorld2D, SetUpdateEnabled), asCALL_THISCALL);
     engine->RegisterObjectMethod("PhysicsWorld2D", "bool get_updateEnabled() const", asMETHOD(PhysicsWorld2D, IsUpdateEnabled), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld2D", "void set_threadedUpdate(bool)", asMETHOD(PhysicsWorld2D, SetThreadedUpdate), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld2D", "bool get_threadedUpdate() const", asMETHOD(PhysicsWorld2D, GetThreadedUpdate), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld2D", "void set_batchedContactEvents(bool)", asMETHOD(PhysicsWorld2D, SetBatchedContactEvents), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld2D", "bool get_batchedContactEvents() const", asMETHOD(PhysicsWorld2D, GetBatchedContactEvents), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PhysicsWorld2D", "void CompleteUpdate()", asMETHOD(PhysicsWorld2D, CompleteUpdate), asCALL_THISCALL);
     engine->RegisterObjectMethod("PhysicsWorld2D", "void set_drawShape(bool)", asMETHOD(PhysicsWorld2D, SetDrawShape), asCALL_THISCALL);
     engine->RegisterObjectMethod("PhysicsWorld2D", "bool get_drawShape() const", asMETHOD(PhysicsWorld2D, GetDrawShape), asCALL_THISCALL);
     engine->RegisterObjectMethod("PhysicsWorld2D", "void set_drawJoint(bool)", asMETHOD(PhysicsWorld2D, SetDrawJoint), asCALL_THISCALL);
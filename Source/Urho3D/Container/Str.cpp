@@ -35,22 +35,18 @@
 namespace Urho3D
 {
 
-char String::endZero = 0;
-
 const String String::EMPTY;
 
 String::String(const WString& str) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     SetUTF8FromWChar(str.CString());
 }
 
 String::String(int value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%d", value);
@@ -59,8 +55,7 @@ String::String(int value) :
 
 String::String(short value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%d", value);
@@ -69,8 +64,7 @@ String::String(short value) :
 
 String::String(long value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%ld", value);
@@ -79,8 +73,7 @@ String::String(long value) :
 
 String::String(long long value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%lld", value);
@@ -89,8 +82,7 @@ String::String(long long value) :
 
 String::String(unsigned value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%u", value);
@@ -99,8 +91,7 @@ String::String(unsigned value) :
 
 String::String(unsigned short value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%u", value);
@@ -109,8 +100,7 @@ String::String(unsigned short value) :
 
 String::String(unsigned long value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%lu", value);
@@ -119,8 +109,7 @@ String::String(unsigned long value) :
 
 String::String(unsigned long long value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%llu", value);
@@ -129,8 +118,7 @@ String::String(unsigned long long value) :
 
 String::String(float value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%g", value);
@@ -139,8 +127,7 @@ String::String(float value) :
 
 String::String(double value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     char tempBuffer[CONVERSION_BUFFER_LENGTH];
     sprintf(tempBuffer, "%.15g", value);
@@ -149,8 +136,7 @@ String::String(double value) :
 
 String::String(bool value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     if (value)
         *this = "true";
@@ -160,21 +146,19 @@ String::String(bool value) :
 
 String::String(char value) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     Resize(1);
-    buffer_[0] = value;
+    GetBuffer()[0] = value;
 }
 
 String::String(char value, unsigned length) :
     length_(0),
-    capacity_(0),
-    buffer_(&endZero)
+    capacity_(0)
 {
     Resize(length);
     for (unsigned i = 0; i < length; ++i)
-        buffer_[i] = value;
+        GetBuffer()[i] = value;
 }
 
 String& String::operator +=(int rhs)
@@ -233,8 +217,8 @@ void String::Replace(char replaceThis, char replaceWith, bool caseSensitive)
     {
         for (unsigned i = 0; i < length_; ++i)
         {
-            if (buffer_[i] == replaceThis)
-                buffer_[i] = replaceWith;
+            if (GetBuffer()[i] == replaceThis)
+                GetBuffer()[i] = replaceWith;
         }
     }
     else
@@ -242,8 +226,8 @@ void String::Replace(char replaceThis, char replaceWith, bool caseSensitive)
         replaceThis = (char)tolower(replaceThis);
         for (unsigned i = 0; i < length_; ++i)
         {
-            if (tolower(buffer_[i]) == replaceThis)
-                buffer_[i] = replaceWith;
+            if (tolower(GetBuffer()[i]) == replaceThis)
+                GetBuffer()[i] = replaceWith;
         }
     }
 }
@@ -268,7 +252,7 @@ void String::Replace(unsigned pos, unsigned length, const String& replaceWith)
     if (pos + length > length_)
         return;
 
-    Replace(pos, length, replaceWith.buffer_, replaceWith.length_);
+    Replace(pos, length, replaceWith.GetBuffer(), replaceWith.length_);
 }
 
 void String::Replace(unsigned pos, unsigned length, const char* replaceWith)
@@ -326,7 +310,7 @@ String& String::Append(const char* str, unsigned length)
     {
         unsigned oldLength = length_;
         Resize(oldLength + length);
-        CopyChars(&buffer_[oldLength], str, length);
+        CopyChars(&GetBuffer()[oldLength], str, length);
     }
     return *this;
 }
@@ -354,7 +338,7 @@ void String::Insert(unsigned pos, char c)
         unsigned oldLength = length_;
         Resize(length_ + 1);
         MoveRange(pos + 1, pos, oldLength - pos);
-        buffer_[pos] = c;
+        GetBuffer()[pos] = c;
     }
 }
 
@@ -419,36 +403,46 @@ void String::Resize(unsigned newLength)
 {
     if (!capacity_)
     {
-        // If zero length requested, do not allocate buffer yet
-        if (!newLength)
+        // Short strings stay in the inline buffer
+        if (newLength < INLINE_CAPACITY)
+        {
+            inlineBuffer_[newLength] = 0;
+            length_ = newLength;
             return;
+        }
+
+        // Calculate initial capacity and move the inline contents to the heap
+        unsigned newCapacity = newLength + 1;
+        if (newCapacity < MIN_CAPACITY)
+            newCapacity = MIN_CAPACITY;
 
-        // Calculate initial capacity
-        capacity_ = newLength + 1;
-        if (capacity_ < MIN_CAPACITY)
-            capacity_ = MIN_CAPACITY;
+        auto* newBuffer = new char[newCapacity];
+        CopyChars(newBuffer, inlineBuffer_, length_);
 
-        buffer_ = new char[capacity_];
+        capacity_ = newCapacity;
+        heapBuffer_ = newBuffer;
     }
     else
     {
-        if (newLength && capacity_ < newLength + 1)
+        unsigned capacity = capacity_ & ~ARENA_BUFFER;
+        if (newLength && capacity < newLength + 1)
         {
             // Increase the capacity with half each time it is exceeded
-            while (capacity_ < newLength + 1)
-                capacity_ += (capacity_ + 1) >> 1u;
+            while (capacity < newLength + 1)
+                capacity += (capacity + 1) >> 1u;
 
-            auto* newBuffer = new char[capacity_];
-            // Move the existing data to the new buffer, then delete the old buffer
+            auto* newBuffer = new char[capacity];
+            // Move the existing data to the new buffer, then delete the old buffer. An arena string moves to the heap
             if (length_)
-                CopyChars(newBuffer, buffer_, length_);
-            delete[] buffer_;
+                CopyChars(newBuffer, heapBuffer_, length_);
+            FreeBuffer();
 
-            buffer_ = newBuffer;
+            capacity_ = capacity;
+            heapBuffer_ = newBuffer;
         }
     }
 
-    buffer_[newLength] = 0;
+    heapBuffer_[newLength] = 0;
     length_ = newLength;
 }
 
@@ -456,22 +450,37 @@ void String::Reserve(unsigned newCapacity)
 {
     if (newCapacity < length_ + 1)
         newCapacity = length_ + 1;
-    if (newCapacity == capacity_)
+
+    if (newCapacity <= INLINE_CAPACITY)
+    {
+        // Fits the inline buffer. If currently on the heap, move back and free the allocation
+        if (capacity_)
+        {
+            char* oldBuffer = heapBuffer_;
+            bool arena = IsArena();
+            CopyChars(inlineBuffer_, oldBuffer, length_ + 1);
+            if (!arena)
+                delete[] oldBuffer;
+            capacity_ = 0;
+        }
+        return;
+    }
+
+    if (newCapacity == Capacity() && capacity_)
         return;
 
     auto* newBuffer = new char[newCapacity];
     // Move the existing data to the new buffer, then delete the old buffer
-    CopyChars(newBuffer, buffer_, length_ + 1);
-    if (capacity_)
-        delete[] buffer_;
+    CopyChars(newBuffer, GetBuffer(), length_ + 1);
+    FreeBuffer();
 
     capacity_ = newCapacity;
-    buffer_ = newBuffer;
+    heapBuffer_ = newBuffer;
 }
 
 void String::Compact()
 {
-    if (capacity_)
+    if (capacity_ && !IsArena())
         Reserve(length_ + 1);
 }
 
@@ -484,7 +493,12 @@ void String::Swap(String& str)
 {
     Urho3D::Swap(length_, str.length_);
     Urho3D::Swap(capacity_, str.capacity_);
-    Urho3D::Swap(buffer_, str.buffer_);
+
+    // The storage holds no pointers into itself, so swapping the raw bytes covers both inline and heap buffers
+    char temp[INLINE_CAPACITY];
+    memcpy(temp, inlineBuffer_, INLINE_CAPACITY);
+    memcpy(inlineBuffer_, str.inlineBuffer_, INLINE_CAPACITY);
+    memcpy(str.inlineBuffer_, temp, INLINE_CAPACITY);
 }
 
 String String::Substring(unsigned pos) const
@@ -493,7 +507,7 @@ String String::Substring(unsigned pos) const
     {
         String ret;
         ret.Resize(length_ - pos);
-        CopyChars(ret.buffer_, buffer_ + pos, ret.length_);
+        CopyChars(ret.GetBuffer(), GetBuffer() + pos, ret.length_);
 
         return ret;
     }
@@ -509,7 +523,7 @@ String String::Substring(unsigned pos, unsigned length) const
         if (pos + length > length_)
             length = length_ - pos;
         ret.Resize(length);
-        CopyChars(ret.buffer_, buffer_ + pos, ret.length_);
+        CopyChars(ret.GetBuffer(), GetBuffer() + pos, ret.length_);
 
         return ret;
     }
@@ -524,14 +538,14 @@ String String::Trimmed() const
 
     while (trimStart < trimEnd)
     {
-        char c = buffer_[trimStart];
+        char c = GetBuffer()[trimStart];
         if (c != ' ' && c != 9)
             break;
         ++trimStart;
     }
     while (trimEnd > trimStart)
     {
-        char c = buffer_[trimEnd - 1];
+        char c = GetBuffer()[trimEnd - 1];
         if (c != ' ' && c != 9)
             break;
         --trimEnd;
@@ -544,7 +558,7 @@ String String::ToLower() const
 {
     String ret(*this);
     for (unsigned i = 0; i < ret.length_; ++i)
-        ret[i] = (char)tolower(buffer_[i]);
+        ret[i] = (char)tolower(GetBuffer()[i]);
 
     return ret;
 }
@@ -553,7 +567,7 @@ String String::ToUpper() const
 {
     String ret(*this);
     for (unsigned i = 0; i < ret.length_; ++i)
-        ret[i] = (char)toupper(buffer_[i]);
+        ret[i] = (char)toupper(GetBuffer()[i]);
 
     return ret;
 }
@@ -574,7 +588,7 @@ unsigned String::Find(char c, unsigned startPos, bool caseSensitive) const
     {
         for (unsigned i = startPos; i < length_; ++i)
         {
-            if (buffer_[i] == c)
+            if (GetBuffer()[i] == c)
                 return i;
         }
     }
@@ -583,7 +597,7 @@ unsigned String::Find(char c, unsigned startPos, bool caseSensitive) const
         c = (char)tolower(c);
         for (unsigned i = startPos; i < length_; ++i)
         {
-            if (tolower(buffer_[i]) == c)
+            if (tolower(GetBuffer()[i]) == c)
                 return i;
         }
     }
@@ -596,13 +610,13 @@ unsigned String::Find(const String& str, unsigned startPos, bool caseSensitive)
     if (!str.length_ || str.length_ > length_)
         return NPOS;
 
-    char first = str.buffer_[0];
+    char first = str.GetBuffer()[0];
     if (!caseSensitive)
         first = (char)tolower(first);
 
     for (unsigned i = startPos; i <= length_ - str.length_; ++i)
     {
-        char c = buffer_[i];
+        char c = GetBuffer()[i];
         if (!caseSensitive)
             c = (char)tolower(c);
 
@@ -612,8 +626,8 @@ unsigned String::Find(const String& str, unsigned startPos, bool caseSensitive)
             bool found = true;
             for (unsigned j = 1; j < str.length_; ++j)
             {
-                c = buffer_[i + j];
-                char d = str.buffer_[j];
+                c = GetBuffer()[i + j];
+                char d = str.GetBuffer()[j];
                 if (!caseSensitive)
                 {
                     c = (char)tolower(c);
@@ -648,7 +662,7 @@ unsigned String::FindLast(char c, unsigned startPos, bool caseSensitive) const
     {
         for (unsigned i = startPos; i < length_; --i)
         {
-            if (buffer_[i] == c)
+            if (GetBuffer()[i] == c)
                 return i;
         }
     }
@@ -657,7 +671,7 @@ unsigned String::FindLast(char c, unsigned startPos, bool caseSensitive) const
         c = (char)tolower(c);
         for (unsigned i = startPos; i < length_; --i)
         {
-            if (tolower(buffer_[i]) == c)
+            if (tolower(GetBuffer()[i]) == c)
                 return i;
         }
     }
@@ -672,13 +686,13 @@ unsigned String::FindLast(const String& str, unsigned startPos, bool caseSensiti
     if (startPos > length_ - str.length_)
         startPos = length_ - str.length_;
 
-    char first = str.buffer_[0];
+    char first = str.GetBuffer()[0];
     if (!caseSensitive)
         first = (char)tolower(first);
 
     for (unsigned i = startPos; i < length_; --i)
     {
-        char c = buffer_[i];
+        char c = GetBuffer()[i];
         if (!caseSensitive)
             c = (char)tolower(c);
 
@@ -687,8 +701,8 @@ unsigned String::FindLast(const String& str, unsigned startPos, bool caseSensiti
             bool found = true;
             for (unsigned j = 1; j < str.length_; ++j)
             {
-                c = buffer_[i + j];
-                char d = str.buffer_[j];
+                c = GetBuffer()[i + j];
+                char d = str.GetBuffer()[j];
                 if (!caseSensitive)
                 {
                     c = (char)tolower(c);
@@ -781,10 +795,10 @@ unsigned String::LengthUTF8() const
 {
     unsigned ret = 0;
 
-    const char* src = buffer_;
+    const char* src = GetBuffer();
     if (!src)
         return ret;
-    const char* end = buffer_ + length_;
+    const char* end = GetBuffer() + length_;
 
     while (src < end)
     {
@@ -811,12 +825,12 @@ unsigned String::ByteOffsetUTF8(unsigned index) const
 
 unsigned String::NextUTF8Char(unsigned& byteOffset) const
 {
-    if (!buffer_)
+    if (!GetBuffer())
         return 0;
 
-    const char* src = buffer_ + byteOffset;
+    const char* src = GetBuffer() + byteOffset;
     unsigned ret = DecodeUTF8(src);
-    byteOffset = (unsigned)(src - buffer_);
+    byteOffset = (unsigned)(src - GetBuffer());
 
     return ret;
 }
@@ -1231,7 +1245,7 @@ void String::Replace(unsigned pos, unsigned length, const char* srcStart, unsign
     else
         Resize(length_ + delta);
 
-    CopyChars(buffer_ + pos, srcStart, srcLength);
+    CopyChars(GetBuffer() + pos, srcStart, srcLength);
 }
 
 WString::WString() :
@@ -45,6 +45,8 @@ using StringMap = HashMap<StringHash, String>;
 /// %String class.
 class URHO3D_API String
 {
+    friend class StringArena;
+
 public:
     using Iterator = RandomAccessIterator<char>;
     using ConstIterator = RandomAccessConstIterator<char>;
@@ -52,16 +54,14 @@ public:
     /// Construct empty.
     String() noexcept :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(0)
     {
     }
 
     /// Construct from another string.
     String(const String& str) :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(0)
     {
         *this = str;
     }
@@ -69,8 +69,7 @@ public:
     /// Move-construct from another string.
     String(String && str) noexcept :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(0)
     {
         Swap(str);
     }
@@ -78,8 +77,7 @@ public:
     /// Construct from a C string.
     String(const char* str) :   // NOLINT(google-explicit-constructor)
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(0)
     {
         *this = str;
     }
@@ -87,8 +85,7 @@ public:
     /// Construct from a C string.
     String(char* str) :         // NOLINT(google-explicit-constructor)
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(0)
     {
         *this = (const char*)str;
     }
@@ -96,18 +93,16 @@ public:
     /// Construct from a char array and length.
     String(const char* str, unsigned length) :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(0)
     {
         Resize(length);
-        CopyChars(buffer_, str, length);
+        CopyChars(GetBuffer(), str, length);
     }
 
     /// Construct from a null-terminated wide character array.
     explicit String(const wchar_t* str) :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(0)
     {
         SetUTF8FromWChar(str);
     }
@@ -115,8 +110,7 @@ public:
     /// Construct from a null-terminated wide character array.
     explicit String(wchar_t* str) :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(0)
     {
         SetUTF8FromWChar(str);
     }
@@ -154,8 +148,7 @@ public:
     /// Construct from a convertible value.
     template <class T> explicit String(const T& value) :
         length_(0),
-        capacity_(0),
-        buffer_(&endZero)
+        capacity_(0)
     {
         *this = value.ToString();
     }
@@ -163,8 +156,7 @@ public:
     /// Destruct.
     ~String()
     {
-        if (capacity_)
-            delete[] buffer_;
+        FreeBuffer();
     }
 
     /// Assign a string.
@@ -173,7 +165,7 @@ public:
         if (&rhs != this)
         {
             Resize(rhs.length_);
-            CopyChars(buffer_, rhs.buffer_, rhs.length_);
+            CopyChars(GetBuffer(), rhs.GetBuffer(), rhs.length_);
         }
 
         return *this;
@@ -192,7 +184,7 @@ public:
     {
         unsigned rhsLength = CStringLength(rhs);
         Resize(rhsLength);
-        CopyChars(buffer_, rhs, rhsLength);
+        CopyChars(GetBuffer(), rhs, rhsLength);
 
         return *this;
     }
@@ -202,7 +194,7 @@ public:
     {
         unsigned oldLength = length_;
         Resize(length_ + rhs.length_);
-        CopyChars(buffer_ + oldLength, rhs.buffer_, rhs.length_);
+        CopyChars(GetBuffer() + oldLength, rhs.GetBuffer(), rhs.length_);
 
         return *this;
     }
@@ -213,7 +205,7 @@ public:
         unsigned rhsLength = CStringLength(rhs);
         unsigned oldLength = length_;
         Resize(length_ + rhsLength);
-        CopyChars(buffer_ + oldLength, rhs, rhsLength);
+        CopyChars(GetBuffer() + oldLength, rhs, rhsLength);
 
         return *this;
     }
@@ -223,7 +215,7 @@ public:
     {
         unsigned oldLength = length_;
         Resize(length_ + 1);
-        buffer_[oldLength] = rhs;
+        GetBuffer()[oldLength] = rhs;
 
         return *this;
     }
@@ -257,8 +249,8 @@ public:
     {
         String ret;
         ret.Resize(length_ + rhs.length_);
-        CopyChars(ret.buffer_, buffer_, length_);
-        CopyChars(ret.buffer_ + length_, rhs.buffer_, rhs.length_);
+        CopyChars(ret.GetBuffer(), GetBuffer(), length_);
+        CopyChars(ret.GetBuffer() + length_, rhs.GetBuffer(), rhs.length_);
 
         return ret;
     }
@@ -269,8 +261,8 @@ public:
         unsigned rhsLength = CStringLength(rhs);
         String ret;
         ret.Resize(length_ + rhsLength);
-        CopyChars(ret.buffer_, buffer_, length_);
-        CopyChars(ret.buffer_ + length_, rhs, rhsLength);
+        CopyChars(ret.GetBuffer(), GetBuffer(), length_);
+        CopyChars(ret.GetBuffer() + length_, rhs, rhsLength);
 
         return ret;
     }
@@ -303,28 +295,28 @@ public:
     char& operator [](unsigned index)
     {
         assert(index < length_);
-        return buffer_[index];
+        return GetBuffer()[index];
     }
 
     /// Return const char at index.
     const char& operator [](unsigned index) const
     {
         assert(index < length_);
-        return buffer_[index];
+        return GetBuffer()[index];
     }
 
     /// Return char at index.
     char& At(unsigned index)
     {
         assert(index < length_);
-        return buffer_[index];
+        return GetBuffer()[index];
     }
 
     /// Return const char at index.
     const char& At(unsigned index) const
     {
         assert(index < length_);
-        return buffer_[index];
+        return GetBuffer()[index];
     }
 
     /// Replace all occurrences of a character.
@@ -369,7 +361,7 @@ public:
     void Resize(unsigned newLength);
     /// Set new capacity.
     void Reserve(unsigned newCapacity);
-    /// Reallocate so that no extra memory is used.
+    /// Reallocate so that no extra memory is used. Does nothing to an arena string.
     void Compact();
     /// Clear the string.
     void Clear();
@@ -377,22 +369,22 @@ public:
     void Swap(String& str);
 
     /// Return iterator to the beginning.
-    Iterator Begin() { return Iterator(buffer_); }
+    Iterator Begin() { return Iterator(GetBuffer()); }
 
     /// Return const iterator to the beginning.
-    ConstIterator Begin() const { return ConstIterator(buffer_); }
+    ConstIterator Begin() const { return ConstIterator(GetBuffer()); }
 
     /// Return iterator to the end.
-    Iterator End() { return Iterator(buffer_ + length_); }
+    Iterator End() { return Iterator(GetBuffer() + length_); }
 
     /// Return const iterator to the end.
-    ConstIterator End() const { return ConstIterator(buffer_ + length_); }
+    ConstIterator End() const { return ConstIterator(GetBuffer() + length_); }
 
     /// Return first char, or 0 if empty.
-    char Front() const { return buffer_[0]; }
+    char Front() const { return GetBuffer()[0]; }
 
     /// Return last char, or 0 if empty.
-    char Back() const { return length_ ? buffer_[length_ - 1] : buffer_[0]; }
+    char Back() const { return length_ ? GetBuffer()[length_ - 1] : GetBuffer()[0]; }
 
     /// Return a substring from position to end.
     String Substring(unsigned pos) const;
@@ -422,13 +414,17 @@ public:
     bool EndsWith(const String& str, bool caseSensitive = true) const;
 
     /// Return the C string.
-    const char* CString() const { return buffer_; }
+    const char* CString() const { return GetBuffer(); }
 
     /// Return length.
     unsigned Length() const { return length_; }
 
     /// Return buffer capacity.
-    unsigned Capacity() const { return capacity_; }
+    unsigned Capacity() const { return capacity_ ? capacity_ & ~ARENA_BUFFER : INLINE_CAPACITY; }
+    /// Return whether the string is stored in the inline buffer without a heap allocation.
+    bool IsInline() const { return capacity_ == 0; }
+    /// Return whether the string buffer is owned by a StringArena.
+    bool IsArena() const { return (capacity_ & ARENA_BUFFER) != 0; }
 
     /// Return whether the string is empty.
     bool Empty() const { return length_ == 0; }
@@ -469,7 +465,7 @@ public:
     unsigned ToHash() const
     {
         unsigned hash = 0;
-        const char* ptr = buffer_;
+        const char* ptr = GetBuffer();
         while (*ptr)
         {
             hash = *ptr + (hash << 6u) + (hash << 16u) - hash;
@@ -509,15 +505,32 @@ public:
     static const unsigned NPOS = 0xffffffff;
     /// Initial dynamic allocation size.
     static const unsigned MIN_CAPACITY = 8;
+    /// Size of the inline buffer, including the end zero. Shorter strings do not allocate.
+    static const unsigned INLINE_CAPACITY = sizeof(void*) * 2;
     /// Empty string.
     static const String EMPTY;
 
 private:
+    /// Capacity flag for a buffer owned by a StringArena, which the string never frees.
+    static const unsigned ARENA_BUFFER = 0x80000000;
+
+    /// Free the heap buffer if one is owned. Does not reset the capacity.
+    void FreeBuffer()
+    {
+        if (capacity_ && !(capacity_ & ARENA_BUFFER))
+            delete[] heapBuffer_;
+    }
+
+    /// Return the character buffer.
+    char* GetBuffer() { return capacity_ ? heapBuffer_ : inlineBuffer_; }
+    /// Return the character buffer.
+    const char* GetBuffer() const { return capacity_ ? heapBuffer_ : inlineBuffer_; }
+
     /// Move a range of characters within the string.
     void MoveRange(unsigned dest, unsigned src, unsigned count)
     {
         if (count)
-            memmove(buffer_ + dest, buffer_ + src, count);
+            memmove(GetBuffer() + dest, GetBuffer() + src, count);
     }
 
     /// Copy chars from one buffer to another.
@@ -542,15 +555,31 @@ private:
 
     /// String length.
     unsigned length_;
-    /// Capacity, zero if buffer not allocated.
+    /// Capacity, zero if the inline buffer is in use. Has ARENA_BUFFER set if the buffer is owned by a StringArena.
     unsigned capacity_;
-    /// String buffer, point to &endZero if buffer is not allocated.
-    char* buffer_;
-
-    /// End zero for empty strings.
-    static char endZero;
+    union
+    {
+        /// Heap-allocated or arena buffer when capacity is nonzero.
+        char* heapBuffer_;
+        /// Inline buffer for short strings when capacity is zero.
+        char inlineBuffer_[INLINE_CAPACITY]{};
+    };
 };
 
+/// Add a string to a temporary string. Reuses the temporary's buffer.
+inline String operator +(String&& lhs, const String& rhs)
+{
+    lhs += rhs;
+    return std::move(lhs);
+}
+
+/// Add a C string to a temporary string. Reuses the temporary's buffer.
+inline String operator +(String&& lhs, const char* rhs)
+{
+    lhs += rhs;
+    return std::move(lhs);
+}
+
 /// Add a string to a C string.
 inline String operator +(const char* lhs, const String& rhs)
 {
@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/StringArena.h"
+#include "../Math/MathDefs.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+StringArena::StringArena(unsigned blockSize) :
+    current_(nullptr),
+    remaining_(0),
+    blockSize_(Max(blockSize, String::INLINE_CAPACITY * 2)),
+    usedSize_(0)
+{
+}
+
+StringArena::~StringArena()
+{
+    Clear();
+}
+
+void StringArena::Assign(String& dest, const char* str, unsigned length)
+{
+    dest.FreeBuffer();
+
+    if (length < String::INLINE_CAPACITY)
+    {
+        dest.capacity_ = 0;
+        String::CopyChars(dest.inlineBuffer_, str, length);
+        dest.inlineBuffer_[length] = 0;
+    }
+    else
+    {
+        char* buffer = Allocate(length + 1);
+        String::CopyChars(buffer, str, length);
+        buffer[length] = 0;
+        dest.capacity_ = (length + 1) | String::ARENA_BUFFER;
+        dest.heapBuffer_ = buffer;
+    }
+
+    dest.length_ = length;
+}
+
+void StringArena::Clear()
+{
+    for (PODVector<char*>::Iterator i = blocks_.Begin(); i != blocks_.End(); ++i)
+        delete[] *i;
+
+    blocks_.Clear();
+    current_ = nullptr;
+    remaining_ = 0;
+    usedSize_ = 0;
+}
+
+char* StringArena::Allocate(unsigned size)
+{
+    usedSize_ += size;
+
+    // Strings larger than a quarter block get a block of their own, so that the current block is not wasted
+    if (size > blockSize_ / 4)
+    {
+        auto* block = new char[size];
+        blocks_.Push(block);
+        return block;
+    }
+
+    if (size > remaining_)
+    {
+        current_ = new char[blockSize_];
+        remaining_ = blockSize_;
+        blocks_.Push(current_);
+    }
+
+    char* ret = current_;
+    current_ += size;
+    remaining_ -= size;
+    return ret;
+}
+
+}
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/Str.h"
+#include "../Container/Vector.h"
+
+namespace Urho3D
+{
+
+/// Bump allocator for strings that share one lifetime, such as the names read from a resource file. Strings longer than the inline buffer are placed in large blocks instead of allocating individually. Such strings must not outlive the arena or its Clear(); copies of them allocate normally, and growing one moves it to the heap.
+class URHO3D_API StringArena
+{
+public:
+    /// Construct with block size.
+    explicit StringArena(unsigned blockSize = DEFAULT_BLOCK_SIZE);
+    /// Destruct. Free all blocks.
+    ~StringArena();
+
+    /// Prevent copy construction.
+    StringArena(const StringArena& rhs) = delete;
+    /// Prevent assignment.
+    StringArena& operator =(const StringArena& rhs) = delete;
+
+    /// Assign characters to a string. Short strings use the inline buffer, longer ones a buffer from the arena.
+    void Assign(String& dest, const char* str, unsigned length);
+    /// Assign a C string to a string.
+    void Assign(String& dest, const char* str) { Assign(dest, str, String::CStringLength(str)); }
+    /// Assign a string to a string.
+    void Assign(String& dest, const String& str) { Assign(dest, str.CString(), str.Length()); }
+    /// Free all blocks. Strings assigned from the arena become invalid.
+    void Clear();
+
+    /// Return block size.
+    unsigned GetBlockSize() const { return blockSize_; }
+    /// Return number of allocated blocks.
+    unsigned GetNumBlocks() const { return blocks_.Size(); }
+    /// Return number of bytes handed out to strings.
+    unsigned GetUsedSize() const { return usedSize_; }
+
+    /// Default block size.
+    static const unsigned DEFAULT_BLOCK_SIZE = 65536;
+
+private:
+    /// Allocate a string buffer.
+    char* Allocate(unsigned size);
+
+    /// Allocated blocks.
+    PODVector<char*> blocks_;
+    /// Next free byte in the current block.
+    char* current_;
+    /// Bytes remaining in the current block.
+    unsigned remaining_;
+    /// Block size.
+    unsigned blockSize_;
+    /// Bytes handed out to strings.
+    unsigned usedSize_;
+};
+
+}
@@ -28,6 +28,7 @@
 #include <windows.h>
 #else
 #include <pthread.h>
+#include <ctime>
 #endif
 
 namespace Urho3D
@@ -57,10 +58,16 @@ void Condition::Wait()
     WaitForSingleObject((HANDLE)event_, INFINITE);
 }
 
+bool Condition::Wait(unsigned timeoutMs)
+{
+    return WaitForSingleObject((HANDLE)event_, timeoutMs) == WAIT_OBJECT_0;
+}
+
 #else
 
 Condition::Condition() :
     mutex_(new pthread_mutex_t),
+    set_(false),
     event_(new pthread_cond_t)
 {
     pthread_mutex_init((pthread_mutex_t*)mutex_, nullptr);
@@ -82,7 +89,13 @@ Condition::~Condition()
 
 void Condition::Set()
 {
-    pthread_cond_signal((pthread_cond_t*)event_);
+    auto* cond = (pthread_cond_t*)event_;
+    auto* mutex = (pthread_mutex_t*)mutex_;
+
+    pthread_mutex_lock(mutex);
+    set_ = true;
+    pthread_cond_signal(cond);
+    pthread_mutex_unlock(mutex);
 }
 
 void Condition::Wait()
@@ -90,9 +103,40 @@ void Condition::Wait()
     auto* cond = (pthread_cond_t*)event_;
     auto* mutex = (pthread_mutex_t*)mutex_;
 
+    // Loop to guard against spurious wakeups, then reset like an auto-reset event
+    pthread_mutex_lock(mutex);
+    while (!set_)
+        pthread_cond_wait(cond, mutex);
+    set_ = false;
+    pthread_mutex_unlock(mutex);
+}
+
+bool Condition::Wait(unsigned timeoutMs)
+{
+    auto* cond = (pthread_cond_t*)event_;
+    auto* mutex = (pthread_mutex_t*)mutex_;
+
+    // The condition uses the realtime clock for the absolute timeout
+    timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeoutMs / 1000;
+    deadline.tv_nsec += (long)(timeoutMs % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        ++deadline.tv_sec;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
     pthread_mutex_lock(mutex);
-    pthread_cond_wait(cond, mutex);
+    while (!set_)
+    {
+        if (pthread_cond_timedwait(cond, mutex, &deadline))
+            break;
+    }
+    bool wasSet = set_;
+    set_ = false;
     pthread_mutex_unlock(mutex);
+    return wasSet;
 }
 
 #endif
@@ -41,16 +41,21 @@ public:
     /// Destruct.
     ~Condition();
 
-    /// Set the condition. Will be automatically reset once a waiting thread wakes up.
+    /// Set the condition. Will be automatically reset once a waiting thread wakes up. If no thread is waiting, the next call to Wait() returns immediately.
     void Set();
 
     /// Wait on the condition.
     void Wait();
 
+    /// Wait on the condition at most the specified time in milliseconds. Return true if the condition was set, false if timed out.
+    bool Wait(unsigned timeoutMs);
+
 private:
 #ifndef _WIN32
     /// Mutex for the event, necessary for pthreads-based implementation.
     void* mutex_;
+    /// Set flag, necessary for pthreads-based implementation so that setting is not lost when no thread is waiting.
+    bool set_;
 #endif
     /// Operating system specific event.
     void* event_;
@@ -73,6 +73,42 @@ StringHash StringHashRegister::RegisterString(const char* string)
     return RegisterString(hash, string);
 }
 
+const String& StringHashRegister::InternString(const String& string)
+{
+    StringHash hash(string);
+
+    if (mutex_)
+        mutex_->Acquire();
+
+    auto iter = map_.Find(hash);
+    if (iter == map_.End())
+        iter = map_.Insert(MakePair(hash, string));
+
+    const String* ret = &iter->second_;
+    if (*ret != string)
+    {
+        // Collisions are rare, so a linear search of the side list is enough
+        List<String>::Iterator i = collisions_.Begin();
+        while (i != collisions_.End() && *i != string)
+            ++i;
+
+        if (i == collisions_.End())
+        {
+            URHO3D_LOGWARNINGF("StringHash collision detected! Both \"%s\" and \"%s\" have hash #%s",
+                string.CString(), iter->second_.CString(), hash.ToString().CString());
+            collisions_.Push(string);
+            ret = &collisions_.Back();
+        }
+        else
+            ret = &(*i);
+    }
+
+    if (mutex_)
+        mutex_->Release();
+
+    return *ret;
+}
+
 String StringHashRegister::GetStringCopy(const StringHash& hash) const
 {
     if (mutex_)
@@ -105,4 +141,11 @@ const String& StringHashRegister::GetString(const StringHash& hash) const
     return iter == map_.End() ? String::EMPTY : iter->second_;
 }
 
+const String& InternString(const String& string)
+{
+    // Hide the table in a function to ensure initialization order
+    static StringHashRegister internRegister(true /*thread safe*/ );
+    return internRegister.InternString(string);
+}
+
 }
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "../Container/HashMap.h"
+#include "../Container/List.h"
 #include "../Container/Ptr.h"
 #include "../Math/StringHash.h"
 
@@ -44,6 +45,8 @@ public:
     StringHash RegisterString(const StringHash& hash, const char* string);
     /// Register string for hash reverse mapping.
     StringHash RegisterString(const char* string);
+    /// Register string and return the stored copy, which stays valid for the lifetime of the register. A string whose hash collides with an already registered one is stored separately, so the returned copy is always equal to the argument.
+    const String& InternString(const String& string);
     /// Return string for given StringHash. Return empty string if not found.
     String GetStringCopy(const StringHash& hash) const;
     /// Return whether the string in contained in the register.
@@ -57,8 +60,13 @@ public:
 private:
     /// Hash to string map.
     StringMap map_;
+    /// Interned strings whose hash collided with a string in the map.
+    List<String> collisions_;
     /// Mutex.
     UniquePtr<Mutex> mutex_;
 };
 
+/// Return a shared copy of the string from the global interning table, adding it on first use. Interned strings live until program exit, so use only for a bounded set such as attribute names and tags. Thread-safe.
+URHO3D_API const String& InternString(const String& string);
+
 }
@@ -65,6 +65,7 @@ WorkQueue::WorkQueue(Context* context) :
     shutDown_(false),
     pausing_(false),
     paused_(false),
+    numCompletionWaiters_(0),
     completing_(false),
     tolerance_(10),
     lastSize_(0),
@@ -139,34 +140,18 @@ void WorkQueue::AddWorkItem(const SharedPtr<WorkItem>& item)
     item->completed_ = false;
 
     // Make sure worker threads' list is safe to modify
-    if (threads_.Size() && !paused_)
+    bool wasPaused = paused_;
+    if (threads_.Size() && !wasPaused)
         queueMutex_.Acquire();
 
-    // Find position for new item
-    if (queue_.Empty())
-        queue_.Push(item);
-    else
-    {
-        bool inserted = false;
-
-        for (List<WorkItem*>::Iterator i = queue_.Begin(); i != queue_.End(); ++i)
-        {
-            if ((*i)->priority_ <= item->priority_)
-            {
-                queue_.Insert(i, item);
-                inserted = true;
-                break;
-            }
-        }
-
-        if (!inserted)
-            queue_.Push(item);
-    }
+    InsertToQueue(item);
 
     if (threads_.Size())
     {
         queueMutex_.Release();
         paused_ = false;
+        if (wasPaused)
+            WakeWorkers();
     }
 }
 
@@ -237,6 +222,7 @@ void WorkQueue::Resume()
     {
         queueMutex_.Release();
         paused_ = false;
+        WakeWorkers();
     }
 }
 
@@ -259,7 +245,7 @@ void WorkQueue::Complete(unsigned priority)
                 queue_.PopFront();
                 queueMutex_.Release();
                 item->workFunction_(item, 0);
-                item->completed_ = true;
+                SetCompleted(item);
             }
             else
             {
@@ -293,6 +279,72 @@ void WorkQueue::Complete(unsigned priority)
     completing_ = false;
 }
 
+void WorkQueue::CompleteItem(const SharedPtr<WorkItem>& item)
+{
+    if (!item || item->completed_ || !workItems_.Contains(item))
+        return;
+
+    bool queued;
+    {
+        // The queue mutex is recursive, so it can be locked also while the worker threads are paused
+        MutexLock lock(queueMutex_);
+        List<WorkItem*>::Iterator i = queue_.Find(item.Get());
+        queued = i != queue_.End();
+        if (queued)
+            queue_.Erase(i);
+    }
+
+    if (queued)
+    {
+        item->workFunction_(item, 0);
+        SetCompleted(item);
+    }
+    else
+        WaitForCompletion(item);
+}
+
+void WorkQueue::ExecuteItems(const Vector<SharedPtr<WorkItem> >& items)
+{
+    for (Vector<SharedPtr<WorkItem> >::ConstIterator i = items.Begin(); i != items.End(); ++i)
+        (*i)->completed_ = false;
+
+    // Offer the items to the worker threads. Use a separate queue, as the main thread may hold the worker queue mutex
+    // for a long time while paused
+    if (threads_.Size())
+    {
+        {
+            std::lock_guard<std::mutex> lock(externalMutex_);
+            for (Vector<SharedPtr<WorkItem> >::ConstIterator i = items.Begin(); i != items.End(); ++i)
+                externalQueue_.Push(*i);
+        }
+        externalCondition_.notify_all();
+    }
+
+    // Execute the items that have not been taken by the worker threads. Outside the main thread use an index after the
+    // worker threads, so that per-thread data is not shared with the main thread
+    unsigned threadIndex = Thread::IsMainThread() ? 0 : threads_.Size() + 1;
+    for (Vector<SharedPtr<WorkItem> >::ConstIterator i = items.Begin(); i != items.End(); ++i)
+    {
+        WorkItem* item = *i;
+
+        if (threads_.Size())
+        {
+            std::lock_guard<std::mutex> lock(externalMutex_);
+            List<WorkItem*>::Iterator j = externalQueue_.Find(item);
+            if (j == externalQueue_.End())
+                continue;
+            externalQueue_.Erase(j);
+        }
+
+        item->workFunction_(item, threadIndex);
+        SetCompleted(item);
+    }
+
+    // Wait for the rest
+    for (Vector<SharedPtr<WorkItem> >::ConstIterator i = items.Begin(); i != items.End(); ++i)
+        WaitForCompletion(*i);
+}
+
 bool WorkQueue::IsCompleted(unsigned priority) const
 {
     for (List<SharedPtr<WorkItem> >::ConstIterator i = workItems_.Begin(); i != workItems_.End(); ++i)
@@ -315,30 +367,104 @@ void WorkQueue::ProcessItems(unsigned threadIndex)
 
         if (pausing_ && !wasActive)
             Time::Sleep(0);
-        else
+        else if (!queueMutex_.TryAcquire())
         {
-            queueMutex_.Acquire();
-            if (!queue_.Empty())
+            // The main thread keeps the queue mutex locked while paused. Do not block on it, but keep executing items from
+            // other threads, and wait for them or for resuming when there are none
+            wasActive = ProcessExternalItem(threadIndex);
+            if (!wasActive)
             {
-                wasActive = true;
-
-                WorkItem* item = queue_.Front();
-                queue_.PopFront();
-                queueMutex_.Release();
-                item->workFunction_(item, threadIndex);
-                item->completed_ = true;
+                std::unique_lock<std::mutex> lock(externalMutex_);
+                externalCondition_.wait(lock, [this] { return !externalQueue_.Empty() || !paused_ || shutDown_; });
             }
-            else
-            {
-                wasActive = false;
+        }
+        else if (!queue_.Empty())
+        {
+            wasActive = true;
 
-                queueMutex_.Release();
+            WorkItem* item = queue_.Front();
+            queue_.PopFront();
+            queueMutex_.Release();
+            item->workFunction_(item, threadIndex);
+            SetCompleted(item);
+        }
+        else
+        {
+            queueMutex_.Release();
+
+            // Take items executed from other threads only when there is no other work
+            wasActive = ProcessExternalItem(threadIndex);
+            if (!wasActive)
                 Time::Sleep(0);
-            }
         }
     }
 }
 
+bool WorkQueue::ProcessExternalItem(unsigned threadIndex)
+{
+    WorkItem* item;
+    {
+        std::lock_guard<std::mutex> lock(externalMutex_);
+        if (externalQueue_.Empty())
+            return false;
+        item = externalQueue_.Front();
+        externalQueue_.PopFront();
+    }
+
+    item->workFunction_(item, threadIndex);
+    SetCompleted(item);
+    return true;
+}
+
+void WorkQueue::WakeWorkers()
+{
+    // Lock the mutex before notifying so that a waiting worker can not miss the state change
+    {
+        std::lock_guard<std::mutex> lock(externalMutex_);
+    }
+    externalCondition_.notify_all();
+}
+
+void WorkQueue::InsertToQueue(WorkItem* item)
+{
+    // Find position for new item
+    for (List<WorkItem*>::Iterator i = queue_.Begin(); i != queue_.End(); ++i)
+    {
+        if ((*i)->priority_ <= item->priority_)
+        {
+            queue_.Insert(i, item);
+            return;
+        }
+    }
+
+    queue_.Push(item);
+}
+
+void WorkQueue::SetCompleted(WorkItem* item)
+{
+    item->completed_ = true;
+
+    // Lock the mutex before notifying so that a waiter can not miss the notification between checking the flag and waiting
+    if (numCompletionWaiters_)
+    {
+        {
+            std::lock_guard<std::mutex> lock(completedMutex_);
+        }
+        completedCondition_.notify_all();
+    }
+}
+
+void WorkQueue::WaitForCompletion(WorkItem* item)
+{
+    if (item->completed_)
+        return;
+
+    std::unique_lock<std::mutex> lock(completedMutex_);
+    ++numCompletionWaiters_;
+    completedCondition_.wait(lock, [item] { return item->completed_.load(); });
+    --numCompletionWaiters_;
+}
+
 void WorkQueue::PurgeCompleted(unsigned priority)
 {
     // Purge completed work items and send completion events. Do not signal items lower than priority threshold,
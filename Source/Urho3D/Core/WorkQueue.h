@@ -27,6 +27,8 @@
 #include "../Core/Object.h"
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 namespace Urho3D
 {
@@ -93,6 +95,10 @@ public:
     void Resume();
     /// Finish all queued work which has at least the specified priority. Main thread will also execute priority work. Pause worker threads if no more work remains.
     void Complete(unsigned priority);
+    /// Finish a work item added with AddWorkItem(): execute it in the main thread if no worker thread has started it yet, otherwise wait until it is finished. Does nothing if the item is not in the queue. Can only be called from the main thread.
+    void CompleteItem(const SharedPtr<WorkItem>& item);
+    /// Execute work items and wait for them to finish. Can be called from any thread, also while the worker threads are paused. The worker threads take the items only when they have no queued work of their own, and the calling thread executes the items not yet taken, with thread index 0 in the main thread and GetNumThreads() + 1 in other threads. The items are not tracked by the queue and do not send completion events.
+    void ExecuteItems(const Vector<SharedPtr<WorkItem> >& items);
 
     /// Set the pool telerance before it starts deleting pool items.
     void SetTolerance(int tolerance) { tolerance_ = tolerance; }
@@ -117,6 +123,16 @@ public:
 private:
     /// Process work items until shut down. Called by the worker threads.
     void ProcessItems(unsigned threadIndex);
+    /// Take and execute one item from the queue of items executed from other threads. Return true if an item was executed.
+    bool ProcessExternalItem(unsigned threadIndex);
+    /// Wake up worker threads waiting for items executed from other threads.
+    void WakeWorkers();
+    /// Insert an item into the worker threads' queue according to its priority. The queue mutex must be held.
+    void InsertToQueue(WorkItem* item);
+    /// Mark an item completed and wake up threads waiting for items.
+    void SetCompleted(WorkItem* item);
+    /// Wait until an item has been completed.
+    void WaitForCompletion(WorkItem* item);
     /// Purge completed work items which have at least the specified priority, and send completion events as necessary.
     void PurgeCompleted(unsigned priority);
     /// Purge the pool to reduce allocation where its unneeded.
@@ -141,7 +157,19 @@ private:
     /// Pausing flag. Indicates the worker threads should not contend for the queue mutex.
     std::atomic<bool> pausing_;
     /// Paused flag. Indicates the queue mutex being locked to prevent worker threads using up CPU time.
-    bool paused_;
+    std::atomic<bool> paused_;
+    /// Queue for items executed from other threads. Pointers are valid until ExecuteItems() returns.
+    List<WorkItem*> externalQueue_;
+    /// Mutex for the external item queue. Unlike the worker queue mutex, never left locked by pausing.
+    std::mutex externalMutex_;
+    /// Condition for waking up paused worker threads when items are executed from other threads, or when resumed.
+    std::condition_variable externalCondition_;
+    /// Mutex for waiting on item completion.
+    std::mutex completedMutex_;
+    /// Condition for waiting on item completion.
+    std::condition_variable completedCondition_;
+    /// Number of threads waiting on item completion.
+    std::atomic<int> numCompletionWaiters_;
     /// Completing work in the main thread flag.
     bool completing_;
     /// Tolerance for the shared pool before it begins to deallocate.
@@ -22,8 +22,12 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
 #include "../Database/Database.h"
+#include "../Database/DatabaseEvents.h"
+#include "../Database/DbWorker.h"
+#include "../IO/Log.h"
 
 namespace Urho3D
 {
@@ -31,13 +35,21 @@ namespace Urho3D
 Database::Database(Context* context_) :
     Object(context_),
 #ifdef ODBC_3_OR_LATER
-    poolSize_(0)
+    poolSize_(0),
 #else
-    poolSize_(M_MAX_UNSIGNED)
+    poolSize_(M_MAX_UNSIGNED),
 #endif
+    nextRequestID_(0),
+    numAsyncRequests_(0),
+    asyncTransactionBatching_(false)
 {
 }
 
+Database::~Database()
+{
+    worker_.Reset();
+}
+
 DBAPI Database::GetAPI()
 {
 #ifdef URHO3D_DATABASE_ODBC
@@ -85,6 +97,10 @@ void Database::Disconnect(DbConnection* connection)
     SharedPtr<DbConnection> dbConnection(connection);
     connections_.Remove(dbConnection);
 
+    // Discard pending asynchronous requests on the connection
+    if (worker_)
+        numAsyncRequests_ -= worker_->RemoveRequests(connection);
+
     // Must finalize the connection before closing the connection or returning it to the pool
     connection->Finalize();
 
@@ -96,4 +112,92 @@ void Database::Disconnect(DbConnection* connection)
     }
 }
 
+unsigned Database::ExecuteAsync(DbConnection* connection, const String& sql, const VariantVector& parameters, bool columnar)
+{
+    if (!connection || !connection->IsConnected())
+    {
+        URHO3D_LOGERROR("Could not queue SQL statement: not connected");
+        return 0;
+    }
+
+    if (!worker_)
+    {
+        worker_ = new DbWorker();
+        worker_->SetTransactionBatching(asyncTransactionBatching_);
+        // If threading is disabled the requests are executed on the main thread at the beginning of the next frame
+        worker_->Run();
+        SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(Database, HandleBeginFrame));
+    }
+
+    // Request ID 0 is reserved for failure
+    if (!++nextRequestID_)
+        ++nextRequestID_;
+
+    // The request is freed on the main thread after its completion event
+    auto* request = new DbRequest();
+    request->id_ = nextRequestID_;
+    request->connection_ = connection;
+    request->sql_ = sql;
+    request->parameters_ = parameters;
+    request->columnar_ = columnar;
+    request->success_ = false;
+    worker_->QueueRequest(request);
+
+    ++numAsyncRequests_;
+    return nextRequestID_;
+}
+
+void Database::CompleteAsync()
+{
+    if (!worker_)
+        return;
+
+    URHO3D_PROFILE(CompleteDbRequests);
+
+    // Execute whatever the worker has not picked up yet; waits for the worker if it is executing
+    worker_->ExecuteRequests();
+    SendCompletionEvents();
+}
+
+void Database::SetAsyncTransactionBatching(bool enable)
+{
+    asyncTransactionBatching_ = enable;
+    if (worker_)
+        worker_->SetTransactionBatching(enable);
+}
+
+void Database::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+{
+    if (!worker_->IsStarted())
+        worker_->ExecuteRequests();
+    SendCompletionEvents();
+}
+
+void Database::SendCompletionEvents()
+{
+    PODVector<DbRequest*> completed;
+    worker_->GetCompletedRequests(completed);
+    if (completed.Empty())
+        return;
+
+    using namespace DbQueryCompleted;
+
+    VariantMap& eventData = GetEventDataMap();
+    for (unsigned i = 0; i < completed.Size(); ++i)
+    {
+        --numAsyncRequests_;
+
+        DbRequest* request = completed[i];
+        eventData[P_DBCONNECTION] = request->connection_;
+        eventData[P_REQUESTID] = request->id_;
+        eventData[P_SQL] = request->sql_;
+        eventData[P_SUCCESS] = request->success_;
+        eventData[P_RESULT] = &request->result_;
+        eventData[P_NUMROWS] = request->result_.GetNumRows();
+        eventData[P_NUMAFFECTEDROWS] = (long long)request->result_.GetNumAffectedRows();
+        SendEvent(E_DBQUERYCOMPLETED, eventData);
+        delete request;
+    }
+}
+
 }
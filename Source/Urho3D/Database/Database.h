@@ -38,6 +38,7 @@ enum DBAPI
 };
 
 class DbConnection;
+class DbWorker;
 
 /// %Database subsystem. Manage database connections.
 class URHO3D_API Database : public Object
@@ -47,6 +48,8 @@ class URHO3D_API Database : public Object
 public:
     /// Construct.
     explicit Database(Context* context_);
+    /// Destruct. Stop the asynchronous execution thread.
+    ~Database() override;
     /// Return the underlying database API.
     static DBAPI GetAPI();
 
@@ -54,6 +57,12 @@ public:
     DbConnection* Connect(const String& connectionString);
     /// Disconnect a database connection. The connection object pointer should not be used anymore after this.
     void Disconnect(DbConnection* connection);
+    /// Queue an SQL statement with parameter values for execution on the database worker thread and return the request ID. The worker prepares a private statement, so the statements cached by the connection are not affected. E_DBQUERYCOMPLETED is sent on the main thread when the execution has finished.
+    unsigned ExecuteAsync(DbConnection* connection, const String& sql, const VariantVector& parameters = Variant::emptyVariantVector, bool columnar = false);
+    /// Execute all pending asynchronous requests immediately and send their completion events.
+    void CompleteAsync();
+    /// Set whether several pending asynchronous requests on the same connection are executed inside one transaction. Default false.
+    void SetAsyncTransactionBatching(bool enable);
 
     /// Return true when using internal database connection pool. The internal database pool is managed by the Database subsystem itself and should not be confused with ODBC connection pool option when ODBC is being used.
     bool IsPooling() const { return (bool)poolSize_; }
@@ -64,13 +73,33 @@ public:
     /// Set internal database connection pool size.
     void SetPoolSize(unsigned poolSize) { poolSize_ = poolSize; }
 
+    /// Return whether several pending asynchronous requests on the same connection are executed inside one transaction.
+    bool GetAsyncTransactionBatching() const { return asyncTransactionBatching_; }
+
+    /// Return number of asynchronous requests that have not sent their completion event yet.
+    unsigned GetNumAsyncRequests() const { return numAsyncRequests_; }
+
 private:
+    /// Handle begin frame event. Send completion events of finished asynchronous requests.
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+    /// Send completion events of finished asynchronous requests.
+    void SendCompletionEvents();
+
+
     /// %Database connection pool size. Default to 0 when using ODBC 3.0 or later as ODBC 3.0 driver manager could manage its own database connection pool.
     unsigned poolSize_;
     /// Active database connections.
     Vector<SharedPtr<DbConnection> > connections_;
     ///%Database connections pool.
     HashMap<String, Vector<SharedPtr<DbConnection> > > connectionsPool_;
+    /// Asynchronous execution worker.
+    SharedPtr<DbWorker> worker_;
+    /// Next asynchronous request ID.
+    unsigned nextRequestID_;
+    /// Number of asynchronous requests not completed yet.
+    unsigned numAsyncRequests_;
+    /// Asynchronous transaction batching flag.
+    bool asyncTransactionBatching_;
 };
 
 }
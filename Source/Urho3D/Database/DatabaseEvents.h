@@ -41,4 +41,16 @@ URHO3D_EVENT(E_DBCURSOR, DbCursor)
     URHO3D_PARAM(P_ABORT, Abort);                  // bool [in]
 }
 
+/// Asynchronous SQL statement execution finished.
+URHO3D_EVENT(E_DBQUERYCOMPLETED, DbQueryCompleted)
+{
+    URHO3D_PARAM(P_DBCONNECTION, DbConnection);    // DbConnection pointer
+    URHO3D_PARAM(P_REQUESTID, RequestID);          // unsigned
+    URHO3D_PARAM(P_SQL, SQL);                      // String
+    URHO3D_PARAM(P_SUCCESS, Success);              // bool, false if the statement failed or its batched transaction was rolled back
+    URHO3D_PARAM(P_RESULT, Result);                // DbResult pointer, valid only during the event (cannot be used in scripting)
+    URHO3D_PARAM(P_NUMROWS, NumRows);              // unsigned
+    URHO3D_PARAM(P_NUMAFFECTEDROWS, NumAffectedRows); // int64
+}
+
 }
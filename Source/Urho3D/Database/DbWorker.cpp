@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Database/DbWorker.h"
+#include "../IO/Log.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+DbWorker::DbWorker() :
+    transactionBatching_(false)
+{
+}
+
+DbWorker::~DbWorker()
+{
+    // Wake up the thread so that it notices it should stop
+    shouldRun_ = false;
+    queueCondition_.Set();
+    Stop();
+
+    MutexLock lock(queueMutex_);
+    for (unsigned i = 0; i < queue_.Size(); ++i)
+        delete queue_[i];
+    for (unsigned i = 0; i < completed_.Size(); ++i)
+        delete completed_[i];
+    queue_.Clear();
+    completed_.Clear();
+}
+
+void DbWorker::ThreadFunction()
+{
+    while (shouldRun_)
+    {
+        queueCondition_.Wait();
+        ExecuteRequests();
+    }
+}
+
+void DbWorker::QueueRequest(DbRequest* request)
+{
+    {
+        MutexLock lock(queueMutex_);
+        queue_.Push(request);
+    }
+
+    queueCondition_.Set();
+}
+
+void DbWorker::ExecuteRequests()
+{
+    MutexLock executeLock(executeMutex_);
+
+    // Take all pending requests at once so that requests on the same connection can share a transaction
+    PODVector<DbRequest*> requests;
+    queueMutex_.Acquire();
+    requests.Swap(queue_);
+    queueMutex_.Release();
+
+    if (requests.Empty())
+        return;
+
+    for (unsigned i = 0; i < requests.Size();)
+    {
+        DbConnection* connection = requests[i]->connection_;
+        unsigned end = i + 1;
+        while (end < requests.Size() && requests[end]->connection_ == connection)
+            ++end;
+
+        // Keep the connection to ourselves for the whole run of requests
+        MutexLock connectionLock(connection->GetMutex());
+        if (transactionBatching_ && end - i > 1 && connection->BeginTransaction())
+        {
+            // Stop at the first failure and roll back, so that the batch is applied completely or not at all
+            bool success = true;
+            for (unsigned j = i; j < end; ++j)
+            {
+                if (success)
+                    success = ExecuteRequest(*requests[j]);
+                else
+                    requests[j]->success_ = false;
+            }
+
+            if (success)
+                success = connection->CommitTransaction();
+            if (!success)
+            {
+                URHO3D_LOGERROR("Rolling back batched asynchronous SQL statements after an error");
+                connection->RollbackTransaction();
+                for (unsigned j = i; j < end; ++j)
+                    requests[j]->success_ = false;
+            }
+        }
+        else
+        {
+            for (unsigned j = i; j < end; ++j)
+                ExecuteRequest(*requests[j]);
+        }
+
+        i = end;
+    }
+
+    MutexLock queueLock(queueMutex_);
+    completed_.Push(requests);
+}
+
+void DbWorker::GetCompletedRequests(PODVector<DbRequest*>& dest)
+{
+    MutexLock lock(queueMutex_);
+    dest.Swap(completed_);
+    completed_.Clear();
+}
+
+unsigned DbWorker::RemoveRequests(DbConnection* connection)
+{
+    unsigned numRemoved = 0;
+
+
+    // Acquire the execute mutex first to wait for requests that may be executing on the worker thread
+    MutexLock executeLock(executeMutex_);
+    MutexLock queueLock(queueMutex_);
+
+    for (PODVector<DbRequest*>::Iterator i = queue_.Begin(); i != queue_.End();)
+    {
+        if ((*i)->connection_ == connection)
+        {
+            delete *i;
+            i = queue_.Erase(i);
+            ++numRemoved;
+        }
+        else
+            ++i;
+    }
+    for (PODVector<DbRequest*>::Iterator i = completed_.Begin(); i != completed_.End();)
+    {
+        if ((*i)->connection_ == connection)
+        {
+            delete *i;
+            i = completed_.Erase(i);
+            ++numRemoved;
+        }
+        else
+            ++i;
+    }
+
+    return numRemoved;
+}
+
+void DbWorker::SetTransactionBatching(bool enable)
+{
+    transactionBatching_ = enable;
+}
+
+bool DbWorker::ExecuteRequest(DbRequest& request)
+{
+    // Use a private statement: the statements cached by the connection may be bound and executed by the main thread
+    DbStatement statement(request.connection_, request.sql_);
+    request.success_ = statement.IsValid() && statement.Bind(request.parameters_);
+    if (request.success_)
+    {
+        request.result_ = statement.Execute(request.columnar_);
+        request.success_ = statement.IsSuccessful();
+    }
+
+    return request.success_;
+}
+
+}
@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Container/RefCounted.h"
+#include "../Core/Condition.h"
+#include "../Core/Mutex.h"
+#include "../Core/Thread.h"
+#include "../Database/DbConnection.h"
+
+namespace Urho3D
+{
+
+/// Queue item for asynchronous execution of an SQL statement. Allocated and freed by the main thread; the worker thread only accesses it through a pointer, so no reference counts are changed outside the main thread.
+struct DbRequest
+{
+    /// Request ID.
+    unsigned id_;
+    /// Connection to execute on. Kept alive by the Database subsystem, which removes the requests before disconnecting.
+    DbConnection* connection_;
+    /// SQL statement.
+    String sql_;
+    /// Parameter values.
+    VariantVector parameters_;
+    /// Whether to fetch the resultset in columnar layout.
+    bool columnar_;
+    /// Success flag, valid once executed. False if the statement failed or its transaction was rolled back.
+    bool success_;
+    /// Result, valid once executed.
+    DbResult result_;
+};
+
+/// Background executor of SQL statements. Owned by the Database subsystem.
+class DbWorker : public RefCounted, public Thread
+{
+public:
+    /// Construct.
+    DbWorker();
+    /// Destruct. Stop the thread and free the queued and completed requests.
+    ~DbWorker() override;
+
+    /// Request execution loop.
+    void ThreadFunction() override;
+
+    /// Queue a request allocated with new and wake up the worker thread. Takes ownership. Called from the main thread.
+    void QueueRequest(DbRequest* request);
+    /// Execute all queued requests in the calling thread. Used by the worker thread, and by the main thread when waiting for completion or when threading is disabled.
+    void ExecuteRequests();
+    /// Move executed requests to the destination vector. The caller takes ownership. Called from the main thread.
+    void GetCompletedRequests(PODVector<DbRequest*>& dest);
+    /// Remove and free all requests on a connection, waiting for requests that are being executed to finish first. Return number of requests removed. Called from the main thread.
+    unsigned RemoveRequests(DbConnection* connection);
+    /// Set whether to execute several pending requests on the same connection inside one transaction.
+    void SetTransactionBatching(bool enable);
+
+private:
+    /// Execute one request. Return true if successful.
+    bool ExecuteRequest(DbRequest& request);
+
+    /// Mutex for the queued and completed requests.
+    Mutex queueMutex_;
+    /// Mutex held while requests are being executed.
+    Mutex executeMutex_;
+    /// Condition set when requests are queued or the thread should stop.
+    Condition queueCondition_;
+    /// Requests waiting for execution.
+    PODVector<DbRequest*> queue_;
+    /// Executed requests waiting for the completion event.
+    PODVector<DbRequest*> completed_;
+    /// Transaction batching flag.
+    volatile bool transactionBatching_;
+};
+
+}
@@ -67,92 +67,105 @@ DbConnection::~DbConnection()
 
 void DbConnection::Finalize()
 {
-    // TODO
+    MutexLock lock(mutex_);
+
+    // Statements still referenced outside of the cache can not be executed anymore after this
+    for (HashMap<String, SharedPtr<DbStatement> >::Iterator i = statements_.Begin(); i != statements_.End(); ++i)
+        i->second_->Finalize();
+    statements_.Clear();
+
+    // Destroying an uncommitted transaction rolls it back
+    transaction_.Reset();
 }
 
 DbResult DbConnection::Execute(const String& sql, bool useCursorEvent)
 {
-    DbResult result;
+    MutexLock lock(mutex_);
+
+    // Ad hoc statements are not cached, use Prepare() for statements that are executed repeatedly
+    DbStatement statement(this, sql);
+    if (!statement.IsValid())
+        return DbResult();
+
+    return statement.Execute(false, useCursorEvent);
+}
+
+DbStatement* DbConnection::Prepare(const String& sql)
+{
+    MutexLock lock(mutex_);
+
+    HashMap<String, SharedPtr<DbStatement> >::Iterator i = statements_.Find(sql);
+    if (i != statements_.End())
+        return i->second_;
+
+    SharedPtr<DbStatement> statement(new DbStatement(this, sql));
+    if (!statement->IsValid())
+        return nullptr;
+
+    statements_[sql] = statement;
+    return statement;
+}
+
+bool DbConnection::BeginTransaction()
+{
+    MutexLock lock(mutex_);
+
+    if (transaction_)
+    {
+        URHO3D_LOGERROR("Could not begin transaction: a transaction is already in progress");
+        return false;
+    }
+
+    try
+    {
+        transaction_ = new nanodbc::transaction(connectionImpl_);
+        return true;
+    }
+    catch (std::runtime_error& e)
+    {
+        HandleRuntimeError("Could not begin transaction", e.what());
+        return false;
+    }
+}
+
+bool DbConnection::CommitTransaction()
+{
+    MutexLock lock(mutex_);
+
+    if (!transaction_)
+    {
+        URHO3D_LOGERROR("Could not commit transaction: no transaction in progress");
+        return false;
+    }
 
+    bool success = true;
     try
     {
-        result.resultImpl_ = nanodbc::execute(connectionImpl_, sql.Trimmed().CString());
-        unsigned numCols = (unsigned)result.resultImpl_.columns();
-        if (numCols)
-        {
-            result.columns_.Resize(numCols);
-            for (unsigned i = 0; i < numCols; ++i)
-                result.columns_[i] = result.resultImpl_.column_name((short)i).c_str();
-
-            bool filtered = false;
-            bool aborted = false;
-
-            while (result.resultImpl_.next())
-            {
-                VariantVector colValues(numCols);
-                for (unsigned i = 0; i < numCols; ++i)
-                {
-                    if (!result.resultImpl_.is_null((short)i))
-                    {
-                        // We can only bind primitive data type that our Variant class supports
-                        switch (result.resultImpl_.column_c_datatype((short)i))
-                        {
-                        case SQL_C_LONG:
-                            colValues[i] = result.resultImpl_.get<int>((short)i);
-                            if (result.resultImpl_.column_datatype((short)i) == SQL_BIT)
-                                colValues[i] = colValues[i] != 0;
-                            break;
-
-                        case SQL_C_FLOAT:
-                            colValues[i] = result.resultImpl_.get<float>((short)i);
-                            break;
-
-                        case SQL_C_DOUBLE:
-                            colValues[i] = result.resultImpl_.get<double>((short)i);
-                            break;
-
-                        default:
-                            // All other types are stored using their string representation in the Variant
-                            colValues[i] = result.resultImpl_.get<nanodbc::string>((short)i).c_str();
-                            break;
-                        }
-                    }
-                }
-
-                if (useCursorEvent)
-                {
-                    using namespace DbCursor;
-
-                    VariantMap& eventData = GetEventDataMap();
-                    eventData[P_DBCONNECTION] = this;
-                    eventData[P_RESULTIMPL] = &result.resultImpl_;
-                    eventData[P_SQL] = sql;
-                    eventData[P_NUMCOLS] = numCols;
-                    eventData[P_COLVALUES] = colValues;
-                    eventData[P_COLHEADERS] = result.columns_;
-                    eventData[P_FILTER] = false;
-                    eventData[P_ABORT] = false;
-
-                    SendEvent(E_DBCURSOR, eventData);
-
-                    filtered = eventData[P_FILTER].GetBool();
-                    aborted = eventData[P_ABORT].GetBool();
-                }
-
-                if (!filtered)
-                    result.rows_.Push(colValues);
-                if (aborted)
-                    break;
-            }
-        }
-        result.numAffectedRows_ = numCols ? -1 : result.resultImpl_.affected_rows();
+        transaction_->commit();
     }
     catch (std::runtime_error& e)
     {
-        HandleRuntimeError("Could not execute", e.what());
+        HandleRuntimeError("Could not commit transaction", e.what());
+        success = false;
+    }
+
+    transaction_.Reset();
+    return success;
+}
+
+bool DbConnection::RollbackTransaction()
+{
+    MutexLock lock(mutex_);
+
+    if (!transaction_)
+    {
+        URHO3D_LOGERROR("Could not roll back transaction: no transaction in progress");
+        return false;
     }
 
-    return result;
+    transaction_->rollback();
+    transaction_.Reset();
+    return true;
 }
 
 void DbConnection::HandleRuntimeError(const char* message, const char* cause)
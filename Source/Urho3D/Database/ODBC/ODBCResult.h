@@ -33,11 +33,13 @@ namespace Urho3D
 class URHO3D_API DbResult
 {
     friend class DbConnection;
+    friend class DbStatement;
 
 public:
     /// Default constructor constructs an empty result object.
     DbResult() :
-        numAffectedRows_(-1)
+        numAffectedRows_(-1),
+        columnar_(false)
     {
     }
 
@@ -45,7 +47,7 @@ public:
     unsigned GetNumColumns() const { return columns_.Size(); }
 
     /// Return number of rows in the resultset or 0 if the number of rows is not available.
-    unsigned GetNumRows() const { return rows_.Size(); }
+    unsigned GetNumRows() const { return columnar_ ? (columnValues_.Size() ? columnValues_[0].Size() : 0) : rows_.Size(); }
 
     /// Return number of affected rows by the DML query or -1 if the number of affected rows is not available.
     long GetNumAffectedRows() const { return numAffectedRows_; }
@@ -59,6 +61,12 @@ public:
     /// Return fetched rows collection. Filtered rows are not included in the collection.
     const Vector<VariantVector>& GetRows() const { return rows_; }
 
+    /// Return fetched values of a column. Only available when the resultset was fetched in columnar layout, otherwise return an empty collection.
+    const VariantVector& GetColumnValues(unsigned index) const { return index < columnValues_.Size() ? columnValues_[index] : Variant::emptyVariantVector; }
+
+    /// Return whether the resultset was fetched in columnar layout, one value collection per column instead of one per row.
+    bool IsColumnar() const { return columnar_; }
+
 private:
     /// The underlying implementation connection object.
     nanodbc::result resultImpl_;
@@ -66,8 +74,12 @@ private:
     StringVector columns_;
     /// Fetched rows from the resultset.
     Vector<VariantVector> rows_;
+    /// Fetched column values from the resultset when using columnar layout.
+    Vector<VariantVector> columnValues_;
     /// Number of affected rows by recent DML query.
     long numAffectedRows_;
+    /// Columnar layout flag.
+    bool columnar_;
 };
 
 }
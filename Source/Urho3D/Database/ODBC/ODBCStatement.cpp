@@ -0,0 +1,264 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../../Precompiled.h"
+
+#include "../../Core/Mutex.h"
+#include "../../Database/DatabaseEvents.h"
+#include "../../IO/Log.h"
+
+#ifdef _WIN32
+// Needs to be included above sql.h for windows
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#include <sqlext.h>
+
+namespace Urho3D
+{
+
+DbStatement::DbStatement(DbConnection* connection, const String& sql) :
+    connection_(connection),
+    sql_(sql.Trimmed()),
+    prepared_(false),
+    successful_(false)
+{
+    assert(connection_ && connection_->IsConnected());
+
+    try
+    {
+        statementImpl_.prepare(connection_->connectionImpl_, sql_.CString());
+        parameters_.Resize((unsigned)statementImpl_.parameters());
+        prepared_ = true;
+    }
+    catch (std::runtime_error& e)
+    {
+        connection_->HandleRuntimeError("Could not prepare", e.what());
+    }
+}
+
+DbStatement::~DbStatement()
+{
+    Finalize();
+}
+
+bool DbStatement::Bind(unsigned index, const Variant& value)
+{
+    if (index >= parameters_.Size())
+    {
+        URHO3D_LOGERRORF("Could not bind parameter %u: index out of range", index + 1);
+        return false;
+    }
+
+    // The driver reads the values when the statement is executed, so only store them for now
+    parameters_[index].value_ = value;
+    return true;
+}
+
+bool DbStatement::Bind(const VariantVector& values)
+{
+    bool success = true;
+    for (unsigned i = 0; i < values.Size(); ++i)
+        success &= Bind(i, values[i]);
+    return success;
+}
+
+void DbStatement::ClearBindings()
+{
+    for (unsigned i = 0; i < parameters_.Size(); ++i)
+        parameters_[i].value_.Clear();
+}
+
+DbResult DbStatement::Execute(bool columnar, bool useCursorEvent)
+{
+    DbResult result;
+    successful_ = false;
+    if (!prepared_)
+    {
+        URHO3D_LOGERROR("Could not execute: statement is not prepared");
+        return result;
+    }
+
+    MutexLock lock(connection_->GetMutex());
+
+    try
+    {
+        BindParameters();
+
+        result.resultImpl_ = statementImpl_.execute();
+        unsigned numCols = (unsigned)result.resultImpl_.columns();
+        result.columnar_ = columnar;
+        if (numCols)
+        {
+            result.columns_.Resize(numCols);
+            for (unsigned i = 0; i < numCols; ++i)
+                result.columns_[i] = result.resultImpl_.column_name((short)i).c_str();
+            if (columnar)
+                result.columnValues_.Resize(numCols);
+
+            bool filtered = false;
+            bool aborted = false;
+
+            while (result.resultImpl_.next())
+            {
+                VariantVector colValues(numCols);
+                for (unsigned i = 0; i < numCols; ++i)
+                {
+                    if (!result.resultImpl_.is_null((short)i))
+                    {
+                        // We can only bind primitive data type that our Variant class supports
+                        switch (result.resultImpl_.column_c_datatype((short)i))
+                        {
+                        case SQL_C_LONG:
+                            colValues[i] = result.resultImpl_.get<int>((short)i);
+                            if (result.resultImpl_.column_datatype((short)i) == SQL_BIT)
+                                colValues[i] = colValues[i] != 0;
+                            break;
+
+                        case SQL_C_FLOAT:
+                            colValues[i] = result.resultImpl_.get<float>((short)i);
+                            break;
+
+                        case SQL_C_DOUBLE:
+                            colValues[i] = result.resultImpl_.get<double>((short)i);
+                            break;
+
+                        default:
+                            // All other types are stored using their string representation in the Variant
+                            colValues[i] = result.resultImpl_.get<nanodbc::string>((short)i).c_str();
+                            break;
+                        }
+                    }
+                }
+
+                if (useCursorEvent)
+                {
+                    using namespace DbCursor;
+
+                    VariantMap& eventData = connection_->GetEventDataMap();
+                    eventData[P_DBCONNECTION] = connection_;
+                    eventData[P_RESULTIMPL] = &result.resultImpl_;
+                    eventData[P_SQL] = sql_;
+                    eventData[P_NUMCOLS] = numCols;
+                    eventData[P_COLVALUES] = colValues;
+                    eventData[P_COLHEADERS] = result.columns_;
+                    eventData[P_FILTER] = false;
+                    eventData[P_ABORT] = false;
+
+                    connection_->SendEvent(E_DBCURSOR, eventData);
+
+                    filtered = eventData[P_FILTER].GetBool();
+                    aborted = eventData[P_ABORT].GetBool();
+                }
+
+                if (!filtered)
+                {
+                    if (columnar)
+                    {
+                        for (unsigned i = 0; i < numCols; ++i)
+                            result.columnValues_[i].Push(colValues[i]);
+                    }
+                    else
+                        result.rows_.Push(colValues);
+                }
+                if (aborted)
+                    break;
+            }
+        }
+        result.numAffectedRows_ = numCols ? -1 : result.resultImpl_.affected_rows();
+        successful_ = true;
+    }
+    catch (std::runtime_error& e)
+    {
+        connection_->HandleRuntimeError("Could not execute", e.what());
+    }
+
+    return result;
+}
+
+void DbStatement::Finalize()
+{
+    if (prepared_)
+    {
+        try
+        {
+            statementImpl_.close();
+        }
+        catch (std::runtime_error& e)
+        {
+            connection_->HandleRuntimeError("Could not finalize", e.what());
+        }
+        prepared_ = false;
+    }
+}
+
+void DbStatement::BindParameters()
+{
+    statementImpl_.reset_parameters();
+
+    for (unsigned i = 0; i < parameters_.Size(); ++i)
+    {
+        Parameter& param = parameters_[i];
+        auto index = (short)i;
+        switch (param.value_.GetType())
+        {
+        case VAR_NONE:
+            statementImpl_.bind_null(index);
+            break;
+
+        case VAR_INT:
+        case VAR_INT64:
+            param.integer_ = param.value_.GetInt64();
+            statementImpl_.bind(index, &param.integer_);
+            break;
+
+        case VAR_BOOL:
+            param.integer_ = param.value_.GetBool() ? 1 : 0;
+            statementImpl_.bind(index, &param.integer_);
+            break;
+
+        case VAR_FLOAT:
+        case VAR_DOUBLE:
+            param.real_ = param.value_.GetDouble();
+            statementImpl_.bind(index, &param.real_);
+            break;
+
+        case VAR_BUFFER:
+            {
+                const PODVector<unsigned char>& buffer = param.value_.GetBuffer();
+                param.binary_.resize(1);
+                param.binary_[0].assign(buffer.Buffer(), buffer.Buffer() + buffer.Size());
+                statementImpl_.bind(index, param.binary_);
+            }
+            break;
+
+        default:
+            param.string_ = param.value_.ToString().CString();
+            statementImpl_.bind(index, param.string_.c_str());
+            break;
+        }
+    }
+}
+
+}
@@ -55,112 +55,73 @@ DbConnection::~DbConnection()
 
 void DbConnection::Finalize()
 {
-    // TODO
+    MutexLock lock(mutex_);
+
+    // Statements still referenced outside of the cache can not be executed anymore after this
+    for (HashMap<String, SharedPtr<DbStatement> >::Iterator i = statements_.Begin(); i != statements_.End(); ++i)
+        i->second_->Finalize();
+    statements_.Clear();
 }
 
 DbResult DbConnection::Execute(const String& sql, bool useCursorEvent)
 {
-    DbResult result;
-    const char* zLeftover = nullptr;
-    sqlite3_stmt* pStmt = nullptr;
     assert(connectionImpl_);
 
-    // 2016-10-09: Prevent string corruption when trimmed is returned.
-    String trimmedSqlStr = sql.Trimmed();
+    MutexLock lock(mutex_);
 
-    int rc = sqlite3_prepare_v2(connectionImpl_, trimmedSqlStr.CString(), -1, &pStmt, &zLeftover);
-    if (rc != SQLITE_OK)
-    {
-        URHO3D_LOGERRORF("Could not execute: %s", sqlite3_errmsg(connectionImpl_));
-        assert(!pStmt);
-        return result;
-    }
-    if (*zLeftover)
-    {
-        URHO3D_LOGERROR("Could not execute: only one SQL statement is allowed");
-        sqlite3_finalize(pStmt);
-        return result;
-    }
+    // Ad hoc statements are not cached, use Prepare() for statements that are executed repeatedly
+    DbStatement statement(this, sql);
+    if (!statement.IsValid())
+        return DbResult();
+
+    return statement.Execute(false, useCursorEvent);
+}
 
-    auto numCols = (unsigned)sqlite3_column_count(pStmt);
-    result.columns_.Resize(numCols);
-    for (unsigned i = 0; i < numCols; ++i)
-        result.columns_[i] = sqlite3_column_name(pStmt, i);
+DbStatement* DbConnection::Prepare(const String& sql)
+{
+    assert(connectionImpl_);
+
+    MutexLock lock(mutex_);
+
+    HashMap<String, SharedPtr<DbStatement> >::Iterator i = statements_.Find(sql);
+    if (i != statements_.End())
+        return i->second_;
 
-    bool filtered = false;
-    bool aborted = false;
+    SharedPtr<DbStatement> statement(new DbStatement(this, sql));
+    if (!statement->IsValid())
+        return nullptr;
 
-    while (true)
+    statements_[sql] = statement;
+    return statement;
+}
+
+bool DbConnection::BeginTransaction()
+{
+    return ExecuteDirect("BEGIN", "Could not begin transaction");
+}
+
+bool DbConnection::CommitTransaction()
+{
+    return ExecuteDirect("COMMIT", "Could not commit transaction");
+}
+
+bool DbConnection::RollbackTransaction()
+{
+    return ExecuteDirect("ROLLBACK", "Could not roll back transaction");
+}
+
+bool DbConnection::ExecuteDirect(const char* sql, const char* errorMessage)
+{
+    assert(connectionImpl_);
+
+    MutexLock lock(mutex_);
+
+    if (sqlite3_exec(connectionImpl_, sql, nullptr, nullptr, nullptr) != SQLITE_OK)
     {
-        rc = sqlite3_step(pStmt);
-        if (rc == SQLITE_ROW)
-        {
-            VariantVector colValues(numCols);
-            for (unsigned i = 0; i < numCols; ++i)
-            {
-                int type = sqlite3_column_type(pStmt, i);
-                if (type != SQLITE_NULL)
-                {
-                    // We can only bind primitive data type that our Variant class supports
-                    switch (type)
-                    {
-                    case SQLITE_INTEGER:
-                        colValues[i] = sqlite3_column_int(pStmt, i);
-                        if (String(sqlite3_column_decltype(pStmt, i)).Compare("BOOLEAN", false) == 0)
-                            colValues[i] = colValues[i] != 0;
-                        break;
-
-                    case SQLITE_FLOAT:
-                        colValues[i] = sqlite3_column_double(pStmt, i);
-                        break;
-
-                    default:
-                        // All other types are stored using their string representation in the Variant
-                        colValues[i] = (const char*)sqlite3_column_text(pStmt, i);
-                        break;
-                    }
-                }
-            }
-
-            if (useCursorEvent)
-            {
-                using namespace DbCursor;
-
-                VariantMap& eventData = GetEventDataMap();
-                eventData[P_DBCONNECTION] = this;
-                eventData[P_RESULTIMPL] = pStmt;
-                eventData[P_SQL] = sql;
-                eventData[P_NUMCOLS] = numCols;
-                eventData[P_COLVALUES] = colValues;
-                eventData[P_COLHEADERS] = result.columns_;
-                eventData[P_FILTER] = false;
-                eventData[P_ABORT] = false;
-
-                SendEvent(E_DBCURSOR, eventData);
-
-                filtered = eventData[P_FILTER].GetBool();
-                aborted = eventData[P_ABORT].GetBool();
-            }
-
-            if (!filtered)
-                result.rows_.Push(colValues);
-            if (aborted)
-            {
-                sqlite3_finalize(pStmt);
-                break;
-            }
-        }
-        else if (rc != SQLITE_DONE)
-            URHO3D_LOGERRORF("Could not execute: %s", sqlite3_errmsg(connectionImpl_));
-        if (rc != SQLITE_ROW)
-        {
-            sqlite3_finalize(pStmt);
-            break;
-        }
+        URHO3D_LOGERRORF("%s: %s", errorMessage, sqlite3_errmsg(connectionImpl_));
+        return false;
     }
-
-    result.numAffectedRows_ = numCols ? -1 : sqlite3_changes(connectionImpl_);
-    return result;
+    return true;
 }
 
 }
@@ -22,8 +22,10 @@
 
 #pragma once
 
+#include "../../Core/Mutex.h"
 #include "../../Core/Object.h"
 #include "../../Database/DbResult.h"
+#include "../../Database/DbStatement.h"
 
 #include <SQLite/sqlite3.h>
 
@@ -45,6 +47,14 @@ public:
 
     /// Execute an SQL statements immediately. Send E_DBCURSOR event for each row in the resultset when useCursorEvent parameter is set to true.
     DbResult Execute(const String& sql, bool useCursorEvent = false);
+    /// Return a prepared statement for the SQL statement. Prepared statements are cached by the connection, so preparing the same SQL again returns the same statement object. Return null if failed.
+    DbStatement* Prepare(const String& sql);
+    /// Begin a transaction. Return true if successful.
+    bool BeginTransaction();
+    /// Commit the current transaction. Return true if successful.
+    bool CommitTransaction();
+    /// Roll back the current transaction. Return true if successful.
+    bool RollbackTransaction();
 
     /// Return database connection string. The connection string for SQLite3 is using the URI format described in https://www.sqlite.org/uri.html, while the connection string for ODBC is using DSN format as per ODBC standard.
     const String& GetConnectionString() const { return connectionString_; }
@@ -55,11 +65,21 @@ public:
     /// Return true when the connection object is connected to the associated database.
     bool IsConnected() const { return connectionImpl_ != nullptr; }
 
+    /// Return the mutex that serializes statement execution when the connection is used from several threads.
+    Mutex& GetMutex() const { return mutex_; }
+
 private:
+    /// Execute an SQL statement that does not return a resultset using the SQLite one-step interface. Return true if successful.
+    bool ExecuteDirect(const char* sql, const char* errorMessage);
+
     /// The connection string for SQLite3 is using the URI format described in https://www.sqlite.org/uri.html, while the connection string for ODBC is using DSN format as per ODBC standard.
     String connectionString_;
     /// The underlying implementation connection object.
     sqlite3* connectionImpl_;
+    /// Cached prepared statements.
+    HashMap<String, SharedPtr<DbStatement> > statements_;
+    /// Mutex for statement execution.
+    mutable Mutex mutex_;
 };
 
 }
@@ -0,0 +1,255 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../../Precompiled.h"
+
+#include "../../Core/Mutex.h"
+#include "../../Database/DatabaseEvents.h"
+#include "../../IO/Log.h"
+
+namespace Urho3D
+{
+
+DbStatement::DbStatement(DbConnection* connection, const String& sql) :
+    connection_(connection),
+    statementImpl_(nullptr),
+    successful_(false)
+{
+    assert(connection_ && connection_->IsConnected());
+
+    // 2016-10-09: Prevent string corruption when trimmed is returned.
+    sql_ = sql.Trimmed();
+
+    const char* zLeftover = nullptr;
+    auto* db = const_cast<sqlite3*>(connection_->GetConnectionImpl());
+    if (sqlite3_prepare_v2(db, sql_.CString(), -1, &statementImpl_, &zLeftover) != SQLITE_OK)
+    {
+        URHO3D_LOGERRORF("Could not prepare: %s", sqlite3_errmsg(db));
+        assert(!statementImpl_);
+        return;
+    }
+    if (*zLeftover)
+    {
+        URHO3D_LOGERROR("Could not prepare: only one SQL statement is allowed");
+        Finalize();
+    }
+}
+
+DbStatement::~DbStatement()
+{
+    Finalize();
+}
+
+bool DbStatement::Bind(unsigned index, const Variant& value)
+{
+    if (!statementImpl_)
+        return false;
+
+    // SQLite parameter indices are one-based
+    int i = index + 1;
+    int rc;
+    switch (value.GetType())
+    {
+    case VAR_NONE:
+        rc = sqlite3_bind_null(statementImpl_, i);
+        break;
+
+    case VAR_INT:
+        rc = sqlite3_bind_int(statementImpl_, i, value.GetInt());
+        break;
+
+    case VAR_BOOL:
+        rc = sqlite3_bind_int(statementImpl_, i, value.GetBool() ? 1 : 0);
+        break;
+
+    case VAR_INT64:
+        rc = sqlite3_bind_int64(statementImpl_, i, value.GetInt64());
+        break;
+
+    case VAR_FLOAT:
+    case VAR_DOUBLE:
+        rc = sqlite3_bind_double(statementImpl_, i, value.GetDouble());
+        break;
+
+    case VAR_STRING:
+        {
+            const String& str = value.GetString();
+            rc = sqlite3_bind_text(statementImpl_, i, str.CString(), str.Length(), SQLITE_TRANSIENT);
+        }
+        break;
+
+    case VAR_BUFFER:
+        {
+            const PODVector<unsigned char>& buffer = value.GetBuffer();
+            rc = sqlite3_bind_blob(statementImpl_, i, buffer.Size() ? &buffer[0] : nullptr, buffer.Size(), SQLITE_TRANSIENT);
+        }
+        break;
+
+    default:
+        {
+            String str = value.ToString();
+            rc = sqlite3_bind_text(statementImpl_, i, str.CString(), str.Length(), SQLITE_TRANSIENT);
+        }
+        break;
+    }
+
+    if (rc != SQLITE_OK)
+    {
+        URHO3D_LOGERRORF("Could not bind parameter %d: %s", i, sqlite3_errstr(rc));
+        return false;
+    }
+    return true;
+}
+
+bool DbStatement::Bind(const VariantVector& values)
+{
+    bool success = true;
+    for (unsigned i = 0; i < values.Size(); ++i)
+        success &= Bind(i, values[i]);
+    return success;
+}
+
+void DbStatement::ClearBindings()
+{
+    if (statementImpl_)
+        sqlite3_clear_bindings(statementImpl_);
+}
+
+DbResult DbStatement::Execute(bool columnar, bool useCursorEvent)
+{
+    DbResult result;
+    successful_ = false;
+    if (!statementImpl_)
+    {
+        URHO3D_LOGERROR("Could not execute: statement is not prepared");
+        return result;
+    }
+
+    MutexLock lock(connection_->GetMutex());
+
+    auto numCols = (unsigned)sqlite3_column_count(statementImpl_);
+    result.columns_.Resize(numCols);
+    for (unsigned i = 0; i < numCols; ++i)
+        result.columns_[i] = sqlite3_column_name(statementImpl_, i);
+    result.columnar_ = columnar;
+    if (columnar)
+        result.columnValues_.Resize(numCols);
+
+    bool filtered = false;
+    bool aborted = false;
+
+    while (true)
+    {
+        int rc = sqlite3_step(statementImpl_);
+        if (rc == SQLITE_ROW)
+        {
+            VariantVector colValues(numCols);
+            for (unsigned i = 0; i < numCols; ++i)
+            {
+                int type = sqlite3_column_type(statementImpl_, i);
+                if (type != SQLITE_NULL)
+                {
+                    // We can only bind primitive data type that our Variant class supports
+                    switch (type)
+                    {
+                    case SQLITE_INTEGER:
+                        colValues[i] = sqlite3_column_int(statementImpl_, i);
+                        if (String(sqlite3_column_decltype(statementImpl_, i)).Compare("BOOLEAN", false) == 0)
+                            colValues[i] = colValues[i] != 0;
+                        break;
+
+                    case SQLITE_FLOAT:
+                        colValues[i] = sqlite3_column_double(statementImpl_, i);
+                        break;
+
+                    default:
+                        // All other types are stored using their string representation in the Variant
+                        colValues[i] = (const char*)sqlite3_column_text(statementImpl_, i);
+                        break;
+                    }
+                }
+            }
+
+            if (useCursorEvent)
+            {
+                using namespace DbCursor;
+
+                VariantMap& eventData = connection_->GetEventDataMap();
+                eventData[P_DBCONNECTION] = connection_;
+                eventData[P_RESULTIMPL] = statementImpl_;
+                eventData[P_SQL] = sql_;
+                eventData[P_NUMCOLS] = numCols;
+                eventData[P_COLVALUES] = colValues;
+                eventData[P_COLHEADERS] = result.columns_;
+                eventData[P_FILTER] = false;
+                eventData[P_ABORT] = false;
+
+                connection_->SendEvent(E_DBCURSOR, eventData);
+
+                filtered = eventData[P_FILTER].GetBool();
+                aborted = eventData[P_ABORT].GetBool();
+            }
+
+            if (!filtered)
+            {
+                if (columnar)
+                {
+                    for (unsigned i = 0; i < numCols; ++i)
+                        result.columnValues_[i].Push(colValues[i]);
+                }
+                else
+                    result.rows_.Push(colValues);
+            }
+            if (aborted)
+            {
+                successful_ = true;
+                break;
+            }
+        }
+        else
+        {
+            if (rc != SQLITE_DONE)
+                URHO3D_LOGERRORF("Could not execute: %s", sqlite3_errmsg(sqlite3_db_handle(statementImpl_)));
+            else
+                successful_ = true;
+            break;
+        }
+    }
+
+    result.numAffectedRows_ = numCols ? -1 : sqlite3_changes(sqlite3_db_handle(statementImpl_));
+
+    // Rewind the statement so that it can be executed again, the parameter bindings are retained
+    sqlite3_reset(statementImpl_);
+    return result;
+}
+
+void DbStatement::Finalize()
+{
+    if (statementImpl_)
+    {
+        sqlite3_finalize(statementImpl_);
+        statementImpl_ = nullptr;
+    }
+}
+
+}
@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../../Container/RefCounted.h"
+#include "../../Database/DbResult.h"
+
+#include <SQLite/sqlite3.h>
+
+namespace Urho3D
+{
+
+class DbConnection;
+
+/// %Database prepared statement. The SQL is parsed once and can be executed repeatedly with different parameter values.
+class URHO3D_API DbStatement : public RefCounted
+{
+    friend class DbConnection;
+
+public:
+    /// Construct and prepare the SQL statement on a connection. Only one SQL statement is allowed.
+    DbStatement(DbConnection* connection, const String& sql);
+    /// Destruct. Finalize the underlying statement.
+    ~DbStatement() override;
+
+    /// Bind a value to a parameter by zero-based index. Int, Int64, Bool, Float, Double, String and Buffer values are bound using their native type, an empty Variant binds NULL and all other types are bound using their string representation. Return true if successful.
+    bool Bind(unsigned index, const Variant& value);
+    /// Bind values to parameters starting from the first parameter. Return true if successful.
+    bool Bind(const VariantVector& values);
+    /// Reset all parameters to NULL.
+    void ClearBindings();
+    /// Execute the statement with the currently bound parameters. Fetch the resultset in columnar layout when columnar parameter is set to true. Send E_DBCURSOR event for each row in the resultset when useCursorEvent parameter is set to true.
+    DbResult Execute(bool columnar = false, bool useCursorEvent = false);
+    /// Finalize the underlying statement. The statement can not be executed anymore after this.
+    void Finalize();
+
+    /// Return the SQL statement.
+    const String& GetSQL() const { return sql_; }
+
+    /// Return number of parameters in the statement.
+    unsigned GetNumParameters() const { return statementImpl_ ? (unsigned)sqlite3_bind_parameter_count(statementImpl_) : 0; }
+
+    /// Return the underlying implementation statement object pointer. It is sqlite3_stmt* when using SQLite3 or nanodbc::statement* when using ODBC.
+    const sqlite3_stmt* GetStatementImpl() const { return statementImpl_; }
+
+    /// Return true when the last execution ran to completion without errors.
+    bool IsSuccessful() const { return successful_; }
+
+    /// Return true when the statement has been prepared successfully and not finalized.
+    bool IsValid() const { return statementImpl_ != nullptr; }
+
+private:
+    /// Owner connection.
+    DbConnection* connection_;
+    /// The SQL statement.
+    String sql_;
+    /// The underlying implementation statement object.
+    sqlite3_stmt* statementImpl_;
+    /// Last execution success flag.
+    bool successful_;
+};
+
+}
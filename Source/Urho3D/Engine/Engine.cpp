@@ -45,6 +45,7 @@
 #include "../Navigation/NavigationMesh.h"
 #endif
 #ifdef URHO3D_NETWORK
+#include "../Network/MetricsServer.h"
 #include "../Network/Network.h"
 #endif
 #ifdef URHO3D_DATABASE
@@ -194,6 +195,7 @@ bool Engine::Initialize(const VariantMap& parameters)
         if (HasParameter(parameters, EP_LOG_LEVEL))
             log->SetLevel(GetParameter(parameters, EP_LOG_LEVEL).GetInt());
         log->SetQuiet(GetParameter(parameters, EP_LOG_QUIET, false).GetBool());
+        log->SetAsync(GetParameter(parameters, EP_LOG_ASYNC, false).GetBool());
         log->Open(GetParameter(parameters, EP_LOG_NAME, "Urho3D.log").GetString());
     }
 
@@ -297,6 +299,15 @@ bool Engine::Initialize(const VariantMap& parameters)
 #ifdef URHO3D_NETWORK
     if (HasParameter(parameters, EP_PACKAGE_CACHE_DIR))
         GetSubsystem<Network>()->SetPackageCacheDir(GetParameter(parameters, EP_PACKAGE_CACHE_DIR).GetString());
+
+    // Start the metrics endpoint if requested
+    int metricsPort = GetParameter(parameters, EP_METRICS_PORT, 0).GetInt();
+    if (metricsPort > 0)
+    {
+        auto* metricsServer = new MetricsServer(context_);
+        context_->RegisterSubsystem(metricsServer);
+        metricsServer->Start((unsigned short)metricsPort);
+    }
 #endif
 
 #ifdef URHO3D_TESTING
@@ -134,6 +134,15 @@ bool AnimatedModel::Load(Deserializer& source)
     return success;
 }
 
+bool AnimatedModel::LoadAttributeValues(const PODVector<const AttributeInfo*>& attributes, const Vector<Variant>& values)
+{
+    loading_ = true;
+    bool success = Component::LoadAttributeValues(attributes, values);
+    loading_ = false;
+
+    return success;
+}
+
 bool AnimatedModel::LoadXML(const XMLElement& source)
 {
     loading_ = true;
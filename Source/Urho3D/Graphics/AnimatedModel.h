@@ -49,6 +49,8 @@ public:
 
     /// Load from binary data. Return true if successful.
     bool Load(Deserializer& source) override;
+    /// Load from attribute values decoded in advance. Return true if successful.
+    bool LoadAttributeValues(const PODVector<const AttributeInfo*>& attributes, const Vector<Variant>& values) override;
     /// Load from XML data. Return true if successful.
     bool LoadXML(const XMLElement& source) override;
     /// Load from JSON data. Return true if successful.
@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/WorkQueue.h"
 #include "../Core/Profiler.h"
 #include "../Graphics/Batch.h"
 #include "../Graphics/BillboardSet.h"
@@ -69,11 +70,197 @@ static const StringVector billboardsStructureElementNames =
     "   Is Enabled"
 };
 
+/// Maximum average number of element moves per billboard before the incremental sort falls back to a full sort.
+static const unsigned MAX_SORT_MOVES_PER_BILLBOARD = 8;
+/// Minimum number of billboards to expand into vertices in one work item.
+static const unsigned MIN_BILLBOARDS_PER_WORK_ITEM = 2048;
+
 inline bool CompareBillboards(Billboard* lhs, Billboard* rhs)
 {
     return lhs->sortDistance_ > rhs->sortDistance_;
 }
 
+/// Sort billboards back to front with an insertion sort, which is close to linear when the order is nearly correct. Return false, leaving the range partially sorted, if more than maxMoves element moves would be needed.
+static bool InsertionSortBillboards(Billboard** begin, Billboard** end, unsigned maxMoves)
+{
+    unsigned moves = 0;
+
+    for (Billboard** i = begin + 1; i < end; ++i)
+    {
+        Billboard* billboard = *i;
+        float distance = billboard->sortDistance_;
+        Billboard** j = i;
+
+        while (j > begin && (*(j - 1))->sortDistance_ < distance)
+        {
+            *j = *(j - 1);
+            --j;
+            if (++moves > maxMoves)
+            {
+                *j = billboard;
+                return false;
+            }
+        }
+
+        *j = billboard;
+    }
+
+    return true;
+}
+
+/// Billboard vertex expansion parameters shared by the work items.
+struct BillboardVertexParams
+{
+    /// First sorted billboard, used to calculate the vertex data offset of each range.
+    Billboard* const* first_;
+    /// Locked vertex data.
+    float* dest_;
+    /// Billboard size scale.
+    Vector3 scale_;
+    /// Fixed screen size flag.
+    bool fixedScreenSize_;
+    /// Direction mode flag.
+    bool direction_;
+};
+
+/// Expand a range of sorted billboards into vertex data.
+static void WriteBillboardVertices(const BillboardVertexParams& params, Billboard* const* start, Billboard* const* end)
+{
+    const Vector3& billboardScale = params.scale_;
+    float* dest = params.dest_ + (start - params.first_) * (params.direction_ ? 44 : 32);
+
+    if (!params.direction_)
+    {
+        for (Billboard* const* i = start; i != end; ++i)
+        {
+            Billboard& billboard = **i;
+
+            Vector2 size(billboard.size_.x_ * billboardScale.x_, billboard.size_.y_ * billboardScale.y_);
+            unsigned color = billboard.color_.ToUInt();
+            if (params.fixedScreenSize_)
+                size *= billboard.screenScaleFactor_;
+
+            float rotationMatrix[2][2];
+            SinCos(billboard.rotation_, rotationMatrix[0][1], rotationMatrix[0][0]);
+            rotationMatrix[1][0] = -rotationMatrix[0][1];
+            rotationMatrix[1][1] = rotationMatrix[0][0];
+
+            dest[0] = billboard.position_.x_;
+            dest[1] = billboard.position_.y_;
+            dest[2] = billboard.position_.z_;
+            ((unsigned&)dest[3]) = color;
+            dest[4] = billboard.uv_.min_.x_;
+            dest[5] = billboard.uv_.min_.y_;
+            dest[6] = -size.x_ * rotationMatrix[0][0] + size.y_ * rotationMatrix[0][1];
+            dest[7] = -size.x_ * rotationMatrix[1][0] + size.y_ * rotationMatrix[1][1];
+
+            dest[8] = billboard.position_.x_;
+            dest[9] = billboard.position_.y_;
+            dest[10] = billboard.position_.z_;
+            ((unsigned&)dest[11]) = color;
+            dest[12] = billboard.uv_.max_.x_;
+            dest[13] = billboard.uv_.min_.y_;
+            dest[14] = size.x_ * rotationMatrix[0][0] + size.y_ * rotationMatrix[0][1];
+            dest[15] = size.x_ * rotationMatrix[1][0] + size.y_ * rotationMatrix[1][1];
+
+            dest[16] = billboard.position_.x_;
+            dest[17] = billboard.position_.y_;
+            dest[18] = billboard.position_.z_;
+            ((unsigned&)dest[19]) = color;
+            dest[20] = billboard.uv_.max_.x_;
+            dest[21] = billboard.uv_.max_.y_;
+            dest[22] = size.x_ * rotationMatrix[0][0] - size.y_ * rotationMatrix[0][1];
+            dest[23] = size.x_ * rotationMatrix[1][0] - size.y_ * rotationMatrix[1][1];
+
+            dest[24] = billboard.position_.x_;
+            dest[25] = billboard.position_.y_;
+            dest[26] = billboard.position_.z_;
+            ((unsigned&)dest[27]) = color;
+            dest[28] = billboard.uv_.min_.x_;
+            dest[29] = billboard.uv_.max_.y_;
+            dest[30] = -size.x_ * rotationMatrix[0][0] - size.y_ * rotationMatrix[0][1];
+            dest[31] = -size.x_ * rotationMatrix[1][0] - size.y_ * rotationMatrix[1][1];
+
+            dest += 32;
+        }
+    }
+    else
+    {
+        for (Billboard* const* i = start; i != end; ++i)
+        {
+            Billboard& billboard = **i;
+
+            Vector2 size(billboard.size_.x_ * billboardScale.x_, billboard.size_.y_ * billboardScale.y_);
+            unsigned color = billboard.color_.ToUInt();
+            if (params.fixedScreenSize_)
+                size *= billboard.screenScaleFactor_;
+
+            float rot2D[2][2];
+            SinCos(billboard.rotation_, rot2D[0][1], rot2D[0][0]);
+            rot2D[1][0] = -rot2D[0][1];
+            rot2D[1][1] = rot2D[0][0];
+
+            dest[0] = billboard.position_.x_;
+            dest[1] = billboard.position_.y_;
+            dest[2] = billboard.position_.z_;
+            dest[3] = billboard.direction_.x_;
+            dest[4] = billboard.direction_.y_;
+            dest[5] = billboard.direction_.z_;
+            ((unsigned&)dest[6]) = color;
+            dest[7] = billboard.uv_.min_.x_;
+            dest[8] = billboard.uv_.min_.y_;
+            dest[9] = -size.x_ * rot2D[0][0] + size.y_ * rot2D[0][1];
+            dest[10] = -size.x_ * rot2D[1][0] + size.y_ * rot2D[1][1];
+
+            dest[11] = billboard.position_.x_;
+            dest[12] = billboard.position_.y_;
+            dest[13] = billboard.position_.z_;
+            dest[14] = billboard.direction_.x_;
+            dest[15] = billboard.direction_.y_;
+            dest[16] = billboard.direction_.z_;
+            ((unsigned&)dest[17]) = color;
+            dest[18] = billboard.uv_.max_.x_;
+            dest[19] = billboard.uv_.min_.y_;
+            dest[20] = size.x_ * rot2D[0][0] + size.y_ * rot2D[0][1];
+            dest[21] = size.x_ * rot2D[1][0] + size.y_ * rot2D[1][1];
+
+            dest[22] = billboard.position_.x_;
+            dest[23] = billboard.position_.y_;
+            dest[24] = billboard.position_.z_;
+            dest[25] = billboard.direction_.x_;
+            dest[26] = billboard.direction_.y_;
+            dest[27] = billboard.direction_.z_;
+            ((unsigned&)dest[28]) = color;
+            dest[29] = billboard.uv_.max_.x_;
+            dest[30] = billboard.uv_.max_.y_;
+            dest[31] = size.x_ * rot2D[0][0] - size.y_ * rot2D[0][1];
+            dest[32] = size.x_ * rot2D[1][0] - size.y_ * rot2D[1][1];
+
+            dest[33] = billboard.position_.x_;
+            dest[34] = billboard.position_.y_;
+            dest[35] = billboard.position_.z_;
+            dest[36] = billboard.direction_.x_;
+            dest[37] = billboard.direction_.y_;
+            dest[38] = billboard.direction_.z_;
+            ((unsigned&)dest[39]) = color;
+            dest[40] = billboard.uv_.min_.x_;
+            dest[41] = billboard.uv_.max_.y_;
+            dest[42] = -size.x_ * rot2D[0][0] - size.y_ * rot2D[0][1];
+            dest[43] = -size.x_ * rot2D[1][0] - size.y_ * rot2D[1][1];
+
+            dest += 44;
+        }
+    }
+}
+
+void WriteBillboardVerticesWork(const WorkItem* item, unsigned threadIndex)
+{
+    auto* params = reinterpret_cast<const BillboardVertexParams*>(item->aux_);
+    auto* start = reinterpret_cast<Billboard* const*>(item->start_);
+    auto* end = reinterpret_cast<Billboard* const*>(item->end_);
+    WriteBillboardVertices(*params, start, end);
+}
+
 BillboardSet::BillboardSet(Context* context) :
     Drawable(context, DRAWABLE_GEOMETRY),
     animationLodBias_(1.0f),
@@ -94,7 +281,9 @@ BillboardSet::BillboardSet(Context* context) :
     sortThisFrame_(false),
     hasOrthoCamera_(false),
     sortFrameNumber_(0),
-    previousOffset_(Vector3::ZERO)
+    previousOffset_(Vector3::ZERO),
+    vertexParams_(new BillboardVertexParams()),
+    vertexBufferLocked_(false)
 {
     geometry_->SetVertexBuffer(0, vertexBuffer_);
     geometry_->SetIndexBuffer(indexBuffer_);
@@ -242,6 +431,16 @@ void BillboardSet::UpdateGeometry(const FrameInfo& frame)
         UpdateVertexBuffer(frame);
 }
 
+void BillboardSet::FinishUpdateGeometry()
+{
+    if (vertexBufferLocked_)
+    {
+        vertexBuffer_->Unlock();
+        vertexBuffer_->ClearDataLost();
+        vertexBufferLocked_ = false;
+    }
+}
+
 UpdateGeometryType BillboardSet::GetUpdateGeometryType()
 {
     // If using camera facing, always need some kind of geometry update, in case the billboard set is rendered from several views
@@ -269,6 +468,8 @@ void BillboardSet::SetNumBillboards(unsigned num)
         return;
 
     billboards_.Resize(num);
+    // The previous sort order may point to the old billboard array
+    sortedBillboards_.Clear();
 
     // Set default values to new billboards
     for (unsigned i = oldNum; i < num; ++i)
@@ -596,25 +797,30 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
     Matrix3x4 billboardTransform = relative_ ? worldTransform : Matrix3x4::IDENTITY;
     Vector3 billboardScale = scaled_ ? worldTransform.Scale() : Vector3::ONE;
 
-    // First check number of enabled billboards
-    for (unsigned i = 0; i < numBillboards; ++i)
+    if (sorted_)
     {
-        if (billboards_[i].enabled_)
-            ++enabledBillboards;
+        enabledBillboards = UpdateSortOrder(frame, billboardTransform);
+        Vector3 worldPos = node_->GetWorldPosition();
+        // Store the "last sorted position" now
+        previousOffset_ = (worldPos - frame.camera_->GetNode()->GetWorldPosition());
     }
+    else
+    {
+        // First check number of enabled billboards
+        for (unsigned i = 0; i < numBillboards; ++i)
+        {
+            if (billboards_[i].enabled_)
+                ++enabledBillboards;
+        }
 
-    sortedBillboards_.Resize(enabledBillboards);
-    unsigned index = 0;
+        sortedBillboards_.Resize(enabledBillboards);
+        unsigned index = 0;
 
-    // Then set initial sort order and distances
-    for (unsigned i = 0; i < numBillboards; ++i)
-    {
-        Billboard& billboard = billboards_[i];
-        if (billboard.enabled_)
+        // Then set the order
+        for (unsigned i = 0; i < numBillboards; ++i)
         {
-            sortedBillboards_[index++] = &billboard;
-            if (sorted_)
-                billboard.sortDistance_ = frame.camera_->GetDistanceSquared(billboardTransform * billboards_[i].position_);
+            if (billboards_[i].enabled_)
+                sortedBillboards_[index++] = &billboards_[i];
         }
     }
 
@@ -625,141 +831,48 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
     if (!enabledBillboards)
         return;
 
-    if (sorted_)
-    {
-        Sort(sortedBillboards_.Begin(), sortedBillboards_.End(), CompareBillboards);
-        Vector3 worldPos = node_->GetWorldPosition();
-        // Store the "last sorted position" now
-        previousOffset_ = (worldPos - frame.camera_->GetNode()->GetWorldPosition());
-    }
-
     auto* dest = (float*)vertexBuffer_->Lock(0, enabledBillboards * 4, true);
     if (!dest)
         return;
 
-    if (faceCameraMode_ != FC_DIRECTION)
-    {
-        for (unsigned i = 0; i < enabledBillboards; ++i)
-        {
-            Billboard& billboard = *sortedBillboards_[i];
+    BillboardVertexParams& params = *vertexParams_;
+    params.first_ = sortedBillboards_.Buffer();
+    params.dest_ = dest;
+    params.scale_ = billboardScale;
+    params.fixedScreenSize_ = fixedScreenSize_;
+    params.direction_ = faceCameraMode_ == FC_DIRECTION;
 
-            Vector2 size(billboard.size_.x_ * billboardScale.x_, billboard.size_.y_ * billboardScale.y_);
-            unsigned color = billboard.color_.ToUInt();
-            if (fixedScreenSize_)
-                size *= billboard.screenScaleFactor_;
-
-            float rotationMatrix[2][2];
-            SinCos(billboard.rotation_, rotationMatrix[0][1], rotationMatrix[0][0]);
-            rotationMatrix[1][0] = -rotationMatrix[0][1];
-            rotationMatrix[1][1] = rotationMatrix[0][0];
-
-            dest[0] = billboard.position_.x_;
-            dest[1] = billboard.position_.y_;
-            dest[2] = billboard.position_.z_;
-            ((unsigned&)dest[3]) = color;
-            dest[4] = billboard.uv_.min_.x_;
-            dest[5] = billboard.uv_.min_.y_;
-            dest[6] = -size.x_ * rotationMatrix[0][0] + size.y_ * rotationMatrix[0][1];
-            dest[7] = -size.x_ * rotationMatrix[1][0] + size.y_ * rotationMatrix[1][1];
+    // Expand large billboard sets in parallel. This is always called from the main thread, by the view while the worker
+    // threads are updating the threaded geometries. The view completes the work items and then calls FinishUpdateGeometry(),
+    // so the main thread can meanwhile continue with the other non-threaded geometry updates
+    auto* queue = GetSubsystem<WorkQueue>();
+    unsigned numWorkItems = queue ? Min(queue->GetNumThreads() + 1, enabledBillboards / MIN_BILLBOARDS_PER_WORK_ITEM) : 1;
 
-            dest[8] = billboard.position_.x_;
-            dest[9] = billboard.position_.y_;
-            dest[10] = billboard.position_.z_;
-            ((unsigned&)dest[11]) = color;
-            dest[12] = billboard.uv_.max_.x_;
-            dest[13] = billboard.uv_.min_.y_;
-            dest[14] = size.x_ * rotationMatrix[0][0] + size.y_ * rotationMatrix[0][1];
-            dest[15] = size.x_ * rotationMatrix[1][0] + size.y_ * rotationMatrix[1][1];
-
-            dest[16] = billboard.position_.x_;
-            dest[17] = billboard.position_.y_;
-            dest[18] = billboard.position_.z_;
-            ((unsigned&)dest[19]) = color;
-            dest[20] = billboard.uv_.max_.x_;
-            dest[21] = billboard.uv_.max_.y_;
-            dest[22] = size.x_ * rotationMatrix[0][0] - size.y_ * rotationMatrix[0][1];
-            dest[23] = size.x_ * rotationMatrix[1][0] - size.y_ * rotationMatrix[1][1];
-
-            dest[24] = billboard.position_.x_;
-            dest[25] = billboard.position_.y_;
-            dest[26] = billboard.position_.z_;
-            ((unsigned&)dest[27]) = color;
-            dest[28] = billboard.uv_.min_.x_;
-            dest[29] = billboard.uv_.max_.y_;
-            dest[30] = -size.x_ * rotationMatrix[0][0] - size.y_ * rotationMatrix[0][1];
-            dest[31] = -size.x_ * rotationMatrix[1][0] - size.y_ * rotationMatrix[1][1];
-
-            dest += 32;
-        }
-    }
-    else
+    if (numWorkItems > 1)
     {
-        for (unsigned i = 0; i < enabledBillboards; ++i)
-        {
-            Billboard& billboard = *sortedBillboards_[i];
-
-            Vector2 size(billboard.size_.x_ * billboardScale.x_, billboard.size_.y_ * billboardScale.y_);
-            unsigned color = billboard.color_.ToUInt();
-            if (fixedScreenSize_)
-                size *= billboard.screenScaleFactor_;
-
-            float rot2D[2][2];
-            SinCos(billboard.rotation_, rot2D[0][1], rot2D[0][0]);
-            rot2D[1][0] = -rot2D[0][1];
-            rot2D[1][1] = rot2D[0][0];
+        unsigned billboardsPerItem = enabledBillboards / numWorkItems;
+        Billboard** start = sortedBillboards_.Buffer();
 
-            dest[0] = billboard.position_.x_;
-            dest[1] = billboard.position_.y_;
-            dest[2] = billboard.position_.z_;
-            dest[3] = billboard.direction_.x_;
-            dest[4] = billboard.direction_.y_;
-            dest[5] = billboard.direction_.z_;
-            ((unsigned&)dest[6]) = color;
-            dest[7] = billboard.uv_.min_.x_;
-            dest[8] = billboard.uv_.min_.y_;
-            dest[9] = -size.x_ * rot2D[0][0] + size.y_ * rot2D[0][1];
-            dest[10] = -size.x_ * rot2D[1][0] + size.y_ * rot2D[1][1];
-
-            dest[11] = billboard.position_.x_;
-            dest[12] = billboard.position_.y_;
-            dest[13] = billboard.position_.z_;
-            dest[14] = billboard.direction_.x_;
-            dest[15] = billboard.direction_.y_;
-            dest[16] = billboard.direction_.z_;
-            ((unsigned&)dest[17]) = color;
-            dest[18] = billboard.uv_.max_.x_;
-            dest[19] = billboard.uv_.min_.y_;
-            dest[20] = size.x_ * rot2D[0][0] + size.y_ * rot2D[0][1];
-            dest[21] = size.x_ * rot2D[1][0] + size.y_ * rot2D[1][1];
-
-            dest[22] = billboard.position_.x_;
-            dest[23] = billboard.position_.y_;
-            dest[24] = billboard.position_.z_;
-            dest[25] = billboard.direction_.x_;
-            dest[26] = billboard.direction_.y_;
-            dest[27] = billboard.direction_.z_;
-            ((unsigned&)dest[28]) = color;
-            dest[29] = billboard.uv_.max_.x_;
-            dest[30] = billboard.uv_.max_.y_;
-            dest[31] = size.x_ * rot2D[0][0] - size.y_ * rot2D[0][1];
-            dest[32] = size.x_ * rot2D[1][0] - size.y_ * rot2D[1][1];
+        for (unsigned i = 0; i < numWorkItems; ++i)
+        {
+            Billboard** end = i < numWorkItems - 1 ? start + billboardsPerItem : sortedBillboards_.Buffer() + enabledBillboards;
 
-            dest[33] = billboard.position_.x_;
-            dest[34] = billboard.position_.y_;
-            dest[35] = billboard.position_.z_;
-            dest[36] = billboard.direction_.x_;
-            dest[37] = billboard.direction_.y_;
-            dest[38] = billboard.direction_.z_;
-            ((unsigned&)dest[39]) = color;
-            dest[40] = billboard.uv_.min_.x_;
-            dest[41] = billboard.uv_.max_.y_;
-            dest[42] = -size.x_ * rot2D[0][0] - size.y_ * rot2D[0][1];
-            dest[43] = -size.x_ * rot2D[1][0] - size.y_ * rot2D[1][1];
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = WriteBillboardVerticesWork;
+            item->aux_ = &params;
+            item->start_ = start;
+            item->end_ = end;
+            queue->AddWorkItem(item);
 
-            dest += 44;
+            start = end;
         }
+
+        vertexBufferLocked_ = true;
+        return;
     }
 
+    WriteBillboardVertices(params, sortedBillboards_.Buffer(), sortedBillboards_.Buffer() + enabledBillboards);
     vertexBuffer_->Unlock();
     vertexBuffer_->ClearDataLost();
 }
@@ -770,6 +883,55 @@ void BillboardSet::MarkPositionsDirty()
     bufferDirty_ = true;
 }
 
+unsigned BillboardSet::UpdateSortOrder(const FrameInfo& frame, const Matrix3x4& billboardTransform)
+{
+    unsigned numBillboards = billboards_.Size();
+    Billboard* firstBillboard = billboards_.Buffer();
+
+    sortedFlags_.Resize(numBillboards);
+    if (numBillboards)
+        memset(sortedFlags_.Buffer(), 0, numBillboards);
+
+    // Keep the previous order of billboards that are still enabled
+    unsigned numSorted = 0;
+    for (unsigned i = 0; i < sortedBillboards_.Size(); ++i)
+    {
+        Billboard* billboard = sortedBillboards_[i];
+        auto index = (unsigned)(billboard - firstBillboard);
+        if (index < numBillboards && billboard->enabled_ && !sortedFlags_[index])
+        {
+            sortedFlags_[index] = 1;
+            sortedBillboards_[numSorted++] = billboard;
+        }
+    }
+    sortedBillboards_.Resize(numSorted);
+
+    // Then append newly enabled billboards
+    for (unsigned i = 0; i < numBillboards; ++i)
+    {
+        if (billboards_[i].enabled_ && !sortedFlags_[i])
+            sortedBillboards_.Push(&billboards_[i]);
+    }
+
+    unsigned enabledBillboards = sortedBillboards_.Size();
+    for (unsigned i = 0; i < enabledBillboards; ++i)
+    {
+        Billboard& billboard = *sortedBillboards_[i];
+        billboard.sortDistance_ = frame.camera_->GetDistanceSquared(billboardTransform * billboard.position_);
+    }
+
+    // When the camera moves slowly the previous order is nearly correct and an insertion sort finishes in close to linear time.
+    // If there is too much change, do a full sort instead
+    if (enabledBillboards > 1)
+    {
+        Billboard** begin = sortedBillboards_.Buffer();
+        if (!InsertionSortBillboards(begin, begin + enabledBillboards, enabledBillboards * MAX_SORT_MOVES_PER_BILLBOARD))
+            Sort(sortedBillboards_.Begin(), sortedBillboards_.End(), CompareBillboards);
+    }
+
+    return enabledBillboards;
+}
+
 void BillboardSet::CalculateFixedScreenSize(const FrameInfo& frame)
 {
     float invViewHeight = 1.0f / frame.viewSize_.y_;
@@ -57,6 +57,8 @@ struct URHO3D_API Billboard
     float screenScaleFactor_;
 };
 
+struct BillboardVertexParams;
+
 /// %Billboard component.
 class URHO3D_API BillboardSet : public Drawable
 {
@@ -76,6 +78,8 @@ public:
     void UpdateBatches(const FrameInfo& frame) override;
     /// Prepare geometry for rendering. Called from a worker thread if possible (no GPU update).
     void UpdateGeometry(const FrameInfo& frame) override;
+    /// Unlock the vertex buffer once the vertex expansion queued by UpdateGeometry() has completed.
+    void FinishUpdateGeometry() override;
     /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
     UpdateGeometryType GetUpdateGeometryType() override;
 
@@ -178,6 +182,8 @@ private:
     void UpdateVertexBuffer(const FrameInfo& frame);
     /// Calculate billboard scale factors in fixed screen size mode.
     void CalculateFixedScreenSize(const FrameInfo& frame);
+    /// Update the back-to-front order of enabled billboards, starting from the previous order. Return number of enabled billboards.
+    unsigned UpdateSortOrder(const FrameInfo& frame, const Matrix3x4& billboardTransform);
 
     /// Geometry.
     SharedPtr<Geometry> geometry_;
@@ -203,10 +209,16 @@ private:
     unsigned sortFrameNumber_;
     /// Previous offset to camera for determining whether sorting is necessary.
     Vector3 previousOffset_;
-    /// Billboard pointers for sorting.
+    /// Billboard pointers for sorting. Kept between frames so that sorting can start from the previous order.
     Vector<Billboard*> sortedBillboards_;
+    /// Flags for billboards already included in the previous sort order.
+    PODVector<unsigned char> sortedFlags_;
     /// Attribute buffer for network replication.
     mutable VectorBuffer attrBuffer_;
+    /// Vertex expansion parameters for the work items.
+    UniquePtr<BillboardVertexParams> vertexParams_;
+    /// Vertex buffer left locked for the expansion work items flag.
+    bool vertexBufferLocked_;
 };
 
 }
@@ -34,6 +34,7 @@
 #include "../Graphics/VertexBuffer.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
+#include "../Math/BatchMath.h"
 #include "../Resource/ResourceCache.h"
 #include "../Scene/Node.h"
 
@@ -620,8 +621,8 @@ void CustomGeometry::Commit()
     {
         totalVertices += vertices_[i].Size();
 
-        for (unsigned j = 0; j < vertices_[i].Size(); ++j)
-            boundingBox_.Merge(vertices_[i][j].position_);
+        if (!vertices_[i].Empty())
+            MergePoints(boundingBox_, &vertices_[i][0].position_, sizeof(CustomGeometryVertex), vertices_[i].Size());
     }
 
     // Make sure world-space bounding box will be updated
@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/AnimatedModel.h"
 #include "../Graphics/Batch.h"
 #include "../Graphics/Camera.h"
@@ -36,6 +37,7 @@
 #include "../Graphics/VertexBuffer.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
+#include "../Math/BatchMath.h"
 #include "../Resource/ResourceCache.h"
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
@@ -56,6 +58,7 @@ static const unsigned MIN_INDICES = 6;
 static const unsigned MAX_VERTICES = 65536;
 static const unsigned DEFAULT_MAX_VERTICES = 512;
 static const unsigned DEFAULT_MAX_INDICES = 1024;
+static const unsigned DECAL_WORK_PRIORITY = 0;
 static const VertexMaskFlags STATIC_ELEMENT_MASK = MASK_POSITION | MASK_NORMAL | MASK_TEXCOORD1 | MASK_TANGENT;
 static const VertexMaskFlags SKINNED_ELEMENT_MASK = MASK_POSITION | MASK_NORMAL | MASK_TEXCOORD1 | MASK_TANGENT |
     MASK_BLENDWEIGHTS | MASK_BLENDINDICES;
@@ -93,7 +96,8 @@ static DecalVertex ClipEdge(const DecalVertex& v0, const DecalVertex& v1, float
     return ret;
 }
 
-static void ClipPolygon(PODVector<DecalVertex>& dest, const PODVector<DecalVertex>& src, const Plane& plane, bool skinned)
+static void ClipPolygon(PODVector<DecalVertex>& dest, const PODVector<DecalVertex>& src, const Plane& plane, bool skinned,
+    PODVector<float>& distances)
 {
     unsigned last = 0;
     float lastDistance = 0.0f;
@@ -102,9 +106,12 @@ static void ClipPolygon(PODVector<DecalVertex>& dest, const PODVector<DecalVerte
     if (src.Empty())
         return;
 
+    distances.Resize(src.Size());
+    CalculatePlaneDistances(plane, &src[0].position_, sizeof(DecalVertex), &distances[0], src.Size());
+
     for (unsigned i = 0; i < src.Size(); ++i)
     {
-        float distance = plane.Distance(src[i].position_);
+        float distance = distances[i];
         if (distance >= 0.0f)
         {
             if (lastDistance < 0.0f)
@@ -123,11 +130,26 @@ static void ClipPolygon(PODVector<DecalVertex>& dest, const PODVector<DecalVerte
     }
 
     // Recheck the distances of the last and first vertices and add the final clipped vertex if applicable
-    float distance = plane.Distance(src[0].position_);
+    float distance = distances[0];
     if ((lastDistance < 0.0f && distance >= 0.0f) || (lastDistance >= 0.0f && distance < 0.0f))
         dest.Push(ClipEdge(src[last], src[0], lastDistance, distance, skinned));
 }
 
+void BuildDecalWork(const WorkItem* item, unsigned threadIndex)
+{
+    auto* decalSet = reinterpret_cast<DecalSet*>(item->aux_);
+    auto* build = reinterpret_cast<DecalBuildData*>(item->start_);
+    Vector<PODVector<DecalVertex> > faces;
+
+    for (unsigned i = 0; i < build->geometries_.Size(); ++i)
+    {
+        decalSet->GetFaces(faces, nullptr, build->geometries_[i], i, build->frustum_, build->decalNormal_,
+            build->normalCutoff_);
+    }
+
+    decalSet->BuildDecal(*build, faces, false);
+}
+
 void Decal::AddVertex(const DecalVertex& vertex)
 {
     for (unsigned i = 0; i < vertices_.Size(); ++i)
@@ -160,6 +182,7 @@ DecalSet::DecalSet(Context* context) :
     numIndices_(0),
     maxVertices_(DEFAULT_MAX_VERTICES),
     maxIndices_(DEFAULT_MAX_INDICES),
+    maxDecalsPerFrame_(0),
     optimizeBufferSize_(false),
     skinned_(false),
     bufferDirty_(true),
@@ -175,7 +198,11 @@ DecalSet::DecalSet(Context* context) :
     batches_[0].geometryType_ = GEOM_STATIC_NOINSTANCING;
 }
 
-DecalSet::~DecalSet() = default;
+DecalSet::~DecalSet()
+{
+    if (!pendingDecals_.Empty())
+        CancelPendingDecals();
+}
 
 void DecalSet::RegisterObject(Context* context)
 {
@@ -187,6 +214,7 @@ void DecalSet::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Max Vertices", GetMaxVertices, SetMaxVertices, unsigned, DEFAULT_MAX_VERTICES, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Max Indices", GetMaxIndices, SetMaxIndices, unsigned, DEFAULT_MAX_INDICES, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Optimize Buffer Size", GetOptimizeBufferSize, SetOptimizeBufferSize, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Decals Per Frame", GetMaxDecalsPerFrame, SetMaxDecalsPerFrame, unsigned, 0, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Can Be Occluded", IsOccludee, SetOccludee, bool, true, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Draw Distance", GetDrawDistance, SetDrawDistance, float, 0.0f, AM_DEFAULT);
     URHO3D_COPY_BASE_ATTRIBUTES(Drawable);
@@ -323,162 +351,88 @@ bool DecalSet::AddDecal(Drawable* target, const Vector3& worldPosition, const Qu
         bufferDirty_ = true;
     }
 
-    // Center the decal frustum on the world position
-    Vector3 adjustedWorldPosition = worldPosition - 0.5f * depth * (worldRotation * Vector3::FORWARD);
-    /// \todo target transform is not right if adding a decal to StaticModelGroup
-    Matrix3x4 targetTransform = target->GetNode()->GetWorldTransform().Inverse();
-
-    // For an animated model, adjust the decal position back to the bind pose
-    // To do this, need to find the bone the decal is colliding with
-    if (animatedModel)
-    {
-        Skeleton& skeleton = animatedModel->GetSkeleton();
-        unsigned numBones = skeleton.GetNumBones();
-        Bone* bestBone = nullptr;
-        float bestSize = 0.0f;
-
-        for (unsigned i = 0; i < numBones; ++i)
-        {
-            Bone* bone = skeleton.GetBone(i);
-            if (!bone->node_ || !bone->collisionMask_)
-                continue;
-
-            // Represent the decal as a sphere, try to find the biggest colliding bone
-            Sphere decalSphere
-                (bone->node_->GetWorldTransform().Inverse() * worldPosition, 0.5f * size / bone->node_->GetWorldScale().Length());
-
-            if (bone->collisionMask_ & BONECOLLISION_BOX)
-            {
-                float size = bone->boundingBox_.HalfSize().Length();
-                if (bone->boundingBox_.IsInside(decalSphere) && size > bestSize)
-                {
-                    bestBone = bone;
-                    bestSize = size;
-                }
-            }
-            else if (bone->collisionMask_ & BONECOLLISION_SPHERE)
-            {
-                Sphere boneSphere(Vector3::ZERO, bone->radius_);
-                float size = bone->radius_;
-                if (boneSphere.IsInside(decalSphere) && size > bestSize)
-                {
-                    bestBone = bone;
-                    bestSize = size;
-                }
-            }
-        }
-
-        if (bestBone)
-            targetTransform = (bestBone->node_->GetWorldTransform() * bestBone->offsetMatrix_).Inverse();
-    }
-
-    // Build the decal frustum
-    Frustum decalFrustum;
-    Matrix3x4 frustumTransform = targetTransform * Matrix3x4(adjustedWorldPosition, worldRotation, 1.0f);
-    decalFrustum.DefineOrtho(size, aspectRatio, 1.0, 0.0f, depth, frustumTransform);
-
-    Vector3 decalNormal = (targetTransform * Vector4(worldRotation * Vector3::BACK, 0.0f)).Normalized();
-
-    decals_.Resize(decals_.Size() + 1);
-    Decal& newDecal = decals_.Back();
-    newDecal.timeToLive_ = timeToLive;
+    DecalBuildData build;
+    PrepareDecal(build, target, worldPosition, worldRotation, size, aspectRatio, depth, topLeftUV, bottomRightUV, timeToLive,
+        normalCutoff);
 
     Vector<PODVector<DecalVertex> > faces;
-    PODVector<DecalVertex> tempFace;
-
     unsigned numBatches = target->GetBatches().Size();
 
     // Use either a specified subgeometry in the target, or all
     if (subGeometry < numBatches)
-        GetFaces(faces, target, subGeometry, decalFrustum, decalNormal, normalCutoff);
+        GetFaces(faces, target, target->GetLodGeometry(subGeometry, 0), subGeometry, build.frustum_, build.decalNormal_,
+            normalCutoff);
     else
     {
         for (unsigned i = 0; i < numBatches; ++i)
-            GetFaces(faces, target, i, decalFrustum, decalNormal, normalCutoff);
+            GetFaces(faces, target, target->GetLodGeometry(i, 0), i, build.frustum_, build.decalNormal_, normalCutoff);
     }
 
-    // Clip the acquired faces against all frustum planes
-    for (const auto& plane : decalFrustum.planes_)
-    {
-        for (unsigned j = 0; j < faces.Size(); ++j)
-        {
-            PODVector<DecalVertex>& face = faces[j];
-            if (face.Empty())
-                continue;
-
-            ClipPolygon(tempFace, face, plane, skinned_);
-            face = tempFace;
-        }
-    }
+    BuildDecal(build, faces, skinned_);
+    return CommitDecal(build.decal_);
+}
 
-    // Now triangulate the resulting faces into decal vertices
-    for (unsigned i = 0; i < faces.Size(); ++i)
-    {
-        PODVector<DecalVertex>& face = faces[i];
-        if (face.Size() < 3)
-            continue;
+bool DecalSet::AddDecalAsync(Drawable* target, const Vector3& worldPosition, const Quaternion& worldRotation, float size,
+    float aspectRatio, float depth, const Vector2& topLeftUV, const Vector2& bottomRightUV, float timeToLive, float normalCutoff,
+    unsigned subGeometry)
+{
+    URHO3D_PROFILE(AddDecalAsync);
 
-        for (unsigned j = 2; j < face.Size(); ++j)
-        {
-            newDecal.AddVertex(face[0]);
-            newDecal.AddVertex(face[j - 1]);
-            newDecal.AddVertex(face[j]);
-        }
-    }
+    // Do not add decals in headless mode
+    if (!node_ || !GetSubsystem<Graphics>())
+        return false;
 
-    // Check if resulted in no triangles
-    if (newDecal.vertices_.Empty())
+    if (!target || !target->GetNode())
     {
-        decals_.Pop();
-        return true;
+        URHO3D_LOGERROR("Null target drawable for decal");
+        return false;
     }
 
-    if (newDecal.vertices_.Size() > maxVertices_)
+    // Only the geometries of a static model's Model resource are known to keep their CPU-side data while the work is
+    // pending. Other drawables, such as CustomGeometry or terrain patches, may resize and so free their buffers at any
+    // time. Collecting faces from an animated model remaps the bones into this decal set, which can not be done in a worker
+    // thread either. Add such decals immediately, as well as all decals if there is no work queue
+    auto* queue = GetSubsystem<WorkQueue>();
+    if (!queue || !dynamic_cast<StaticModel*>(target) || dynamic_cast<AnimatedModel*>(target))
     {
-        URHO3D_LOGWARNING("Can not add decal, vertex count " + String(newDecal.vertices_.Size()) + " exceeds maximum " +
-                   String(maxVertices_));
-        decals_.Pop();
-        return false;
+        return AddDecal(target, worldPosition, worldRotation, size, aspectRatio, depth, topLeftUV, bottomRightUV, timeToLive,
+            normalCutoff, subGeometry);
     }
-    if (newDecal.indices_.Size() > maxIndices_)
+
+    if (skinned_)
     {
-        URHO3D_LOGWARNING("Can not add decal, index count " + String(newDecal.indices_.Size()) + " exceeds maximum " +
-                   String(maxIndices_));
-        decals_.Pop();
-        return false;
+        RemoveAllDecals();
+        skinned_ = false;
+        bufferDirty_ = true;
     }
 
-    // Calculate UVs
-    Matrix4 projection(Matrix4::ZERO);
-    projection.m11_ = (1.0f / (size * 0.5f));
-    projection.m00_ = projection.m11_ / aspectRatio;
-    projection.m22_ = 1.0f / depth;
-    projection.m33_ = 1.0f;
-
-    CalculateUVs(newDecal, frustumTransform.Inverse(), projection, topLeftUV, bottomRightUV);
+    pendingDecals_.Resize(pendingDecals_.Size() + 1);
+    DecalBuildData& build = pendingDecals_.Back();
+    PrepareDecal(build, target, worldPosition, worldRotation, size, aspectRatio, depth, topLeftUV, bottomRightUV, timeToLive,
+        normalCutoff);
 
-    // Transform vertices to this node's local space and generate tangents
-    Matrix3x4 decalTransform = node_->GetWorldTransform().Inverse() * target->GetNode()->GetWorldTransform();
-    TransformVertices(newDecal, skinned_ ? Matrix3x4::IDENTITY : decalTransform);
-    GenerateTangents(&newDecal.vertices_[0], sizeof(DecalVertex), &newDecal.indices_[0], sizeof(unsigned short), 0,
-        newDecal.indices_.Size(), offsetof(DecalVertex, normal_), offsetof(DecalVertex, texCoord_), offsetof(DecalVertex,
-        tangent_));
-
-    newDecal.CalculateBoundingBox();
-    numVertices_ += newDecal.vertices_.Size();
-    numIndices_ += newDecal.indices_.Size();
-
-    // Remove oldest decals if total vertices exceeded
-    while (decals_.Size() && (numVertices_ > maxVertices_ || numIndices_ > maxIndices_))
-        RemoveDecals(1);
+    // Hold the target geometries so that their CPU-side data stays alive until the decal has been built, even if the model
+    // is reloaded
+    unsigned numBatches = target->GetBatches().Size();
+    if (subGeometry < numBatches)
+        build.geometries_.Push(SharedPtr<Geometry>(target->GetLodGeometry(subGeometry, 0)));
+    else
+    {
+        for (unsigned i = 0; i < numBatches; ++i)
+            build.geometries_.Push(SharedPtr<Geometry>(target->GetLodGeometry(i, 0)));
+    }
 
-    URHO3D_LOGDEBUG("Added decal with " + String(newDecal.vertices_.Size()) + " vertices");
+    build.workItem_ = new WorkItem();
+    build.workItem_->workFunction_ = BuildDecalWork;
+    build.workItem_->start_ = &build;
+    build.workItem_->aux_ = this;
+    build.workItem_->priority_ = DECAL_WORK_PRIORITY;
+    queue->AddWorkItem(build.workItem_);
 
-    // If new decal is time limited, subscribe to scene post-update
-    if (newDecal.timeToLive_ > 0.0f && !subscribed_)
+    // Subscribe to scene post-update to add the decal when it is ready
+    if (!subscribed_)
         UpdateEventSubscription(false);
 
-    MarkDecalsDirty();
     return true;
 }
 
@@ -490,6 +444,9 @@ void DecalSet::RemoveDecals(unsigned num)
 
 void DecalSet::RemoveAllDecals()
 {
+    if (!pendingDecals_.Empty())
+        CancelPendingDecals();
+
     if (!decals_.Empty())
     {
         decals_.Clear();
@@ -510,6 +467,12 @@ void DecalSet::RemoveAllDecals()
     UpdateBatch();
 }
 
+void DecalSet::SetMaxDecalsPerFrame(unsigned num)
+{
+    maxDecalsPerFrame_ = num;
+    MarkNetworkUpdate();
+}
+
 Material* DecalSet::GetMaterial() const
 {
     return batches_[0].material_;
@@ -694,11 +657,186 @@ void DecalSet::OnWorldBoundingBoxUpdate()
     }
 }
 
-void DecalSet::GetFaces(Vector<PODVector<DecalVertex> >& faces, Drawable* target, unsigned batchIndex, const Frustum& frustum,
-    const Vector3& decalNormal, float normalCutoff)
+void DecalSet::PrepareDecal(DecalBuildData& build, Drawable* target, const Vector3& worldPosition,
+    const Quaternion& worldRotation, float size, float aspectRatio, float depth, const Vector2& topLeftUV,
+    const Vector2& bottomRightUV, float timeToLive, float normalCutoff)
 {
-    // Try to use the most accurate LOD level if possible
-    Geometry* geometry = target->GetLodGeometry(batchIndex, 0);
+    // Center the decal frustum on the world position
+    Vector3 adjustedWorldPosition = worldPosition - 0.5f * depth * (worldRotation * Vector3::FORWARD);
+    /// \todo target transform is not right if adding a decal to StaticModelGroup
+    Matrix3x4 targetTransform = target->GetNode()->GetWorldTransform().Inverse();
+
+    // For an animated model, adjust the decal position back to the bind pose
+    // To do this, need to find the bone the decal is colliding with
+    auto* animatedModel = dynamic_cast<AnimatedModel*>(target);
+    if (animatedModel)
+    {
+        Skeleton& skeleton = animatedModel->GetSkeleton();
+        unsigned numBones = skeleton.GetNumBones();
+        Bone* bestBone = nullptr;
+        float bestSize = 0.0f;
+
+        for (unsigned i = 0; i < numBones; ++i)
+        {
+            Bone* bone = skeleton.GetBone(i);
+            if (!bone->node_ || !bone->collisionMask_)
+                continue;
+
+            // Represent the decal as a sphere, try to find the biggest colliding bone
+            Sphere decalSphere
+                (bone->node_->GetWorldTransform().Inverse() * worldPosition, 0.5f * size / bone->node_->GetWorldScale().Length());
+
+            if (bone->collisionMask_ & BONECOLLISION_BOX)
+            {
+                float size = bone->boundingBox_.HalfSize().Length();
+                if (bone->boundingBox_.IsInside(decalSphere) && size > bestSize)
+                {
+                    bestBone = bone;
+                    bestSize = size;
+                }
+            }
+            else if (bone->collisionMask_ & BONECOLLISION_SPHERE)
+            {
+                Sphere boneSphere(Vector3::ZERO, bone->radius_);
+                float size = bone->radius_;
+                if (boneSphere.IsInside(decalSphere) && size > bestSize)
+                {
+                    bestBone = bone;
+                    bestSize = size;
+                }
+            }
+        }
+
+        if (bestBone)
+            targetTransform = (bestBone->node_->GetWorldTransform() * bestBone->offsetMatrix_).Inverse();
+    }
+
+    // Build the decal frustum
+    Matrix3x4 frustumTransform = targetTransform * Matrix3x4(adjustedWorldPosition, worldRotation, 1.0f);
+    build.frustum_.DefineOrtho(size, aspectRatio, 1.0, 0.0f, depth, frustumTransform);
+    build.decalNormal_ = (targetTransform * Vector4(worldRotation * Vector3::BACK, 0.0f)).Normalized();
+    build.normalCutoff_ = normalCutoff;
+
+    // Calculate the UV projection
+    build.view_ = frustumTransform.Inverse();
+    build.projection_ = Matrix4::ZERO;
+    build.projection_.m11_ = (1.0f / (size * 0.5f));
+    build.projection_.m00_ = build.projection_.m11_ / aspectRatio;
+    build.projection_.m22_ = 1.0f / depth;
+    build.projection_.m33_ = 1.0f;
+    build.topLeftUV_ = topLeftUV;
+    build.bottomRightUV_ = bottomRightUV;
+
+    // Skinned decal vertices stay in the bind pose, others are transformed to this node's local space
+    build.transform_ = skinned_ ? Matrix3x4::IDENTITY : node_->GetWorldTransform().Inverse() *
+        target->GetNode()->GetWorldTransform();
+    build.decal_.timeToLive_ = timeToLive;
+}
+
+void DecalSet::BuildDecal(DecalBuildData& build, Vector<PODVector<DecalVertex> >& faces, bool skinned)
+{
+    Decal& decal = build.decal_;
+    PODVector<DecalVertex> tempFace;
+    PODVector<float> distances;
+
+    for (unsigned i = 0; i < faces.Size(); ++i)
+    {
+        PODVector<DecalVertex>& face = faces[i];
+
+        // Clip the face against all frustum planes
+        for (const auto& plane : build.frustum_.planes_)
+        {
+            if (face.Empty())
+                break;
+
+            ClipPolygon(tempFace, face, plane, skinned, distances);
+            face.Swap(tempFace);
+        }
+
+        // Now triangulate the resulting face into decal vertices
+        for (unsigned j = 2; j < face.Size(); ++j)
+        {
+            decal.AddVertex(face[0]);
+            decal.AddVertex(face[j - 1]);
+            decal.AddVertex(face[j]);
+        }
+    }
+
+    if (decal.vertices_.Empty())
+        return;
+
+    // Calculate UVs, transform vertices to this node's local space and generate tangents
+    CalculateUVs(decal, build.view_, build.projection_, build.topLeftUV_, build.bottomRightUV_);
+    TransformVertices(decal, build.transform_);
+    GenerateTangents(&decal.vertices_[0], sizeof(DecalVertex), &decal.indices_[0], sizeof(unsigned short), 0,
+        decal.indices_.Size(), offsetof(DecalVertex, normal_), offsetof(DecalVertex, texCoord_), offsetof(DecalVertex,
+        tangent_));
+
+    decal.CalculateBoundingBox();
+}
+
+bool DecalSet::CommitDecal(Decal& decal)
+{
+    // Check if resulted in no triangles
+    if (decal.vertices_.Empty())
+        return true;
+
+    if (decal.vertices_.Size() > maxVertices_)
+    {
+        URHO3D_LOGWARNING("Can not add decal, vertex count " + String(decal.vertices_.Size()) + " exceeds maximum " +
+                   String(maxVertices_));
+        return false;
+    }
+    if (decal.indices_.Size() > maxIndices_)
+    {
+        URHO3D_LOGWARNING("Can not add decal, index count " + String(decal.indices_.Size()) + " exceeds maximum " +
+                   String(maxIndices_));
+        return false;
+    }
+
+    decals_.Resize(decals_.Size() + 1);
+    Decal& newDecal = decals_.Back();
+    newDecal.timeToLive_ = decal.timeToLive_;
+    newDecal.boundingBox_ = decal.boundingBox_;
+    newDecal.vertices_.Swap(decal.vertices_);
+    newDecal.indices_.Swap(decal.indices_);
+
+    numVertices_ += newDecal.vertices_.Size();
+    numIndices_ += newDecal.indices_.Size();
+
+    URHO3D_LOGDEBUG("Added decal with " + String(newDecal.vertices_.Size()) + " vertices");
+
+    // If new decal is time limited, subscribe to scene post-update
+    if (newDecal.timeToLive_ > 0.0f && !subscribed_)
+        UpdateEventSubscription(false);
+
+    // Remove oldest decals if total vertices exceeded
+    while (decals_.Size() && (numVertices_ > maxVertices_ || numIndices_ > maxIndices_))
+        RemoveDecals(1);
+
+    MarkDecalsDirty();
+    return true;
+}
+
+void DecalSet::CancelPendingDecals()
+{
+    auto* queue = GetSubsystem<WorkQueue>();
+
+    for (List<DecalBuildData>::Iterator i = pendingDecals_.Begin(); i != pendingDecals_.End(); ++i)
+    {
+        // If the decal was not taken by a worker thread yet, remove it from the queue. Otherwise wait for it to finish. Without
+        // the work queue its worker threads have already been stopped
+        if (i->workItem_ && queue && !queue->RemoveWorkItem(i->workItem_))
+            queue->CompleteItem(i->workItem_);
+    }
+
+    pendingDecals_.Clear();
+}
+
+void DecalSet::GetFaces(Vector<PODVector<DecalVertex> >& faces, Drawable* target, Geometry* geometry, unsigned batchIndex,
+    const Frustum& frustum, const Vector3& decalNormal, float normalCutoff)
+{
+    // The geometry should be the most accurate LOD level if possible
     if (!geometry || geometry->GetPrimitiveType() != TRIANGLE_LIST)
         return;
 
@@ -813,7 +951,7 @@ void DecalSet::GetFace(Vector<PODVector<DecalVertex> >& faces, Drawable* target,
     float normalCutoff)
 {
     bool hasNormals = normalData != nullptr;
-    bool hasSkinning = skinned_ && skinningData != nullptr;
+    bool hasSkinning = target && skinned_ && skinningData != nullptr;
 
     const Vector3& v0 = *((const Vector3*)(&positionData[i0 * positionStride]));
     const Vector3& v1 = *((const Vector3*)(&positionData[i1 * positionStride]));
@@ -974,11 +1112,14 @@ void DecalSet::CalculateUVs(Decal& decal, const Matrix3x4& view, const Matrix4&
 
 void DecalSet::TransformVertices(Decal& decal, const Matrix3x4& transform)
 {
-    for (PODVector<DecalVertex>::Iterator i = decal.vertices_.Begin(); i != decal.vertices_.End(); ++i)
-    {
-        i->position_ = transform * i->position_;
-        i->normal_ = (transform * Vector4(i->normal_, 0.0f)).Normalized();
-    }
+    if (decal.vertices_.Empty())
+        return;
+
+    DecalVertex* vertices = &decal.vertices_[0];
+    TransformPoints(transform, &vertices->position_, sizeof(DecalVertex), &vertices->position_, sizeof(DecalVertex),
+        decal.vertices_.Size());
+    TransformNormals(transform.ToMatrix3(), &vertices->normal_, sizeof(DecalVertex), &vertices->normal_, sizeof(DecalVertex),
+        decal.vertices_.Size());
 }
 
 List<Decal>::Iterator DecalSet::RemoveDecal(List<Decal>::Iterator i)
@@ -1140,8 +1281,8 @@ void DecalSet::UpdateEventSubscription(bool checkAllDecals)
             }
         }
 
-        // If no time limited decals, no need to subscribe to scene update
-        enabled = hasTimeLimitedDecals;
+        // If no time limited or pending decals, no need to subscribe to scene update
+        enabled = hasTimeLimitedDecals || !pendingDecals_.Empty();
     }
 
     if (enabled && !subscribed_)
@@ -1162,6 +1303,19 @@ void DecalSet::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData
 
     float timeStep = eventData[P_TIMESTEP].GetFloat();
 
+    // Add asynchronous decals that have finished building, in the order they were queued and up to the per-frame limit
+    unsigned numAdded = 0;
+    while (!pendingDecals_.Empty() && (!maxDecalsPerFrame_ || numAdded < maxDecalsPerFrame_))
+    {
+        DecalBuildData& build = pendingDecals_.Front();
+        if (build.workItem_ && !build.workItem_->completed_)
+            break;
+
+        CommitDecal(build.decal_);
+        pendingDecals_.PopFront();
+        ++numAdded;
+    }
+
     for (List<Decal>::Iterator i = decals_.Begin(); i != decals_.End();)
     {
         i->timer_ += timeStep;
@@ -32,6 +32,7 @@ namespace Urho3D
 
 class IndexBuffer;
 class VertexBuffer;
+struct WorkItem;
 
 /// %Decal vertex.
 struct DecalVertex
@@ -99,11 +100,40 @@ struct Decal
     PODVector<unsigned short> indices_;
 };
 
+/// %Decal geometry build data.
+struct DecalBuildData
+{
+    /// %Decal frustum in target geometry space.
+    Frustum frustum_;
+    /// %Decal view transform in target geometry space for UV calculation.
+    Matrix3x4 view_;
+    /// %Decal projection for UV calculation.
+    Matrix4 projection_;
+    /// Transform from target geometry space to the decal set's local space.
+    Matrix3x4 transform_;
+    /// %Decal normal in target geometry space.
+    Vector3 decalNormal_;
+    /// Minimum dot product of face and decal normals to include the face.
+    float normalCutoff_{};
+    /// Top-left texture coordinates.
+    Vector2 topLeftUV_;
+    /// Bottom-right texture coordinates.
+    Vector2 bottomRightUV_;
+    /// Target geometries to clip. Used in asynchronous creation.
+    Vector<SharedPtr<Geometry> > geometries_;
+    /// Work item. Used in asynchronous creation.
+    SharedPtr<WorkItem> workItem_;
+    /// Resulting decal.
+    Decal decal_;
+};
+
 /// %Decal renderer component.
 class URHO3D_API DecalSet : public Drawable
 {
     URHO3D_OBJECT(DecalSet, Drawable);
 
+    friend void BuildDecalWork(const WorkItem* item, unsigned threadIndex);
+
 public:
     /// Construct.
     explicit DecalSet(Context* context);
@@ -137,10 +167,16 @@ public:
     bool AddDecal(Drawable* target, const Vector3& worldPosition, const Quaternion& worldRotation, float size, float aspectRatio,
         float depth, const Vector2& topLeftUV, const Vector2& bottomRightUV, float timeToLive = 0.0f, float normalCutoff = 0.1f,
         unsigned subGeometry = M_MAX_UNSIGNED);
+    /// Add a decal asynchronously. The target geometry is clipped in a worker thread and the decal is added on a following frame's scene post-update. Only StaticModel targets are clipped asynchronously; decals to animated models and other drawables are added immediately. The target model must not be modified while the decal is pending. Return true if the decal was queued or added.
+    bool AddDecalAsync(Drawable* target, const Vector3& worldPosition, const Quaternion& worldRotation, float size, float aspectRatio,
+        float depth, const Vector2& topLeftUV, const Vector2& bottomRightUV, float timeToLive = 0.0f, float normalCutoff = 0.1f,
+        unsigned subGeometry = M_MAX_UNSIGNED);
     /// Remove n oldest decals.
     void RemoveDecals(unsigned num);
-    /// Remove all decals.
+    /// Remove all decals, including pending asynchronous decals.
     void RemoveAllDecals();
+    /// Set maximum number of asynchronous decals to add per frame. 0 (default) is unlimited.
+    void SetMaxDecalsPerFrame(unsigned num);
 
     /// Return material.
     Material* GetMaterial() const;
@@ -163,6 +199,12 @@ public:
     /// Return whether is optimizing GPU buffer sizes according to current amount of decals.
     bool GetOptimizeBufferSize() const { return optimizeBufferSize_; }
 
+    /// Return maximum number of asynchronous decals to add per frame.
+    unsigned GetMaxDecalsPerFrame() const { return maxDecalsPerFrame_; }
+
+    /// Return number of pending asynchronous decals.
+    unsigned GetNumPendingDecals() const { return pendingDecals_.Size(); }
+
     /// Set material attribute.
     void SetMaterialAttr(const ResourceRef& value);
     /// Set decals attribute.
@@ -179,9 +221,19 @@ protected:
     void OnMarkedDirty(Node* node) override;
 
 private:
-    /// Get triangle faces from the target geometry.
-    void GetFaces(Vector<PODVector<DecalVertex> >& faces, Drawable* target, unsigned batchIndex, const Frustum& frustum,
-        const Vector3& decalNormal, float normalCutoff);
+    /// Calculate the decal frustum and transforms.
+    void PrepareDecal(DecalBuildData& build, Drawable* target, const Vector3& worldPosition, const Quaternion& worldRotation,
+        float size, float aspectRatio, float depth, const Vector2& topLeftUV, const Vector2& bottomRightUV, float timeToLive,
+        float normalCutoff);
+    /// Clip and triangulate the faces, then calculate UVs, local-space vertices and tangents of the decal. May be called from a worker thread.
+    void BuildDecal(DecalBuildData& build, Vector<PODVector<DecalVertex> >& faces, bool skinned);
+    /// Add a built decal. Return true if successful.
+    bool CommitDecal(Decal& decal);
+    /// Wait for and discard pending asynchronous decals.
+    void CancelPendingDecals();
+    /// Get triangle faces from the target geometry. The target is needed only for skinned decals, if null the faces can be collected in a worker thread.
+    void GetFaces(Vector<PODVector<DecalVertex> >& faces, Drawable* target, Geometry* geometry, unsigned batchIndex,
+        const Frustum& frustum, const Vector3& decalNormal, float normalCutoff);
     /// Get triangle face from the target geometry.
     void GetFace
         (Vector<PODVector<DecalVertex> >& faces, Drawable* target, unsigned batchIndex, unsigned i0, unsigned i1, unsigned i2,
@@ -223,6 +275,8 @@ private:
     SharedPtr<IndexBuffer> indexBuffer_;
     /// Decals.
     List<Decal> decals_;
+    /// Pending asynchronous decals.
+    List<DecalBuildData> pendingDecals_;
     /// Bones used for skinned decals.
     Vector<Bone> bones_;
     /// Skinning matrices.
@@ -235,6 +289,8 @@ private:
     unsigned maxVertices_;
     /// Maximum indices.
     unsigned maxIndices_;
+    /// Maximum asynchronous decals to add per frame.
+    unsigned maxDecalsPerFrame_;
     /// Optimize buffer sizes flag.
     bool optimizeBufferSize_;
     /// Skinned mode flag.
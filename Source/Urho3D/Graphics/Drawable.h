@@ -131,8 +131,10 @@ public:
     virtual void Update(const FrameInfo& frame) { }
     /// Calculate distance and prepare batches for rendering. May be called from worker thread(s), possibly re-entrantly.
     virtual void UpdateBatches(const FrameInfo& frame);
-    /// Prepare geometry for rendering.
+    /// Prepare geometry for rendering. A main thread update may queue work items with the maximum priority, which the view completes together with the worker thread updates before calling FinishUpdateGeometry().
     virtual void UpdateGeometry(const FrameInfo& frame) { }
+    /// Finish a main thread geometry update once the work items it queued have completed. Called from the main thread.
+    virtual void FinishUpdateGeometry() { }
 
     /// Return whether a geometry update is necessary, and if it can happen in a worker thread.
     virtual UpdateGeometryType GetUpdateGeometryType() { return UPDATE_NONE; }
@@ -220,6 +222,9 @@ public:
     /// Return whether is in view of a specific camera this frame. Pass in a null camera to allow any camera, including shadow map cameras.
     bool IsInView(Camera* camera) const;
 
+    /// Return frame number on which the drawable was last found to be in view, or 0 if never.
+    unsigned GetViewFrameNumber() const { return viewFrameNumber_; }
+
     /// Return draw call source data.
     const Vector<SourceBatch>& GetBatches() const { return batches_; }
 
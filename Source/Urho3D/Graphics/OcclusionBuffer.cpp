@@ -27,12 +27,16 @@
 #include "../Graphics/Camera.h"
 #include "../Graphics/OcclusionBuffer.h"
 #include "../IO/Log.h"
+#include "../Math/BatchMath.h"
 
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
+/// Number of triangles of a non-indexed batch to project at a time.
+static const unsigned PROJECT_CHUNK_TRIANGLES = 256;
+
 enum ClipMask : unsigned
 {
     CLIPMASK_X_POS = 0x1,
@@ -478,20 +482,22 @@ void OcclusionBuffer::DrawBatch(const OcclusionBatch& batch, unsigned threadInde
     if (!batch.indexData_)
     {
         const unsigned char* srcData = ((const unsigned char*)batch.vertexData_) + batch.drawStart_ * batch.vertexSize_;
+        const unsigned numVertices = batch.drawCount_ / 3 * 3;
 
-        unsigned index = 0;
-        while (index + 2 < batch.drawCount_)
+        // Project the vertices in large chunks, then copy each triangle out, as clipping modifies the vertices in place
+        Vector4 projected[PROJECT_CHUNK_TRIANGLES * 3];
+        for (unsigned chunkStart = 0; chunkStart < numVertices; chunkStart += PROJECT_CHUNK_TRIANGLES * 3)
         {
-            const Vector3& v0 = *((const Vector3*)(&srcData[index * batch.vertexSize_]));
-            const Vector3& v1 = *((const Vector3*)(&srcData[(index + 1) * batch.vertexSize_]));
-            const Vector3& v2 = *((const Vector3*)(&srcData[(index + 2) * batch.vertexSize_]));
-
-            vertices[0] = ModelTransform(modelViewProj, v0);
-            vertices[1] = ModelTransform(modelViewProj, v1);
-            vertices[2] = ModelTransform(modelViewProj, v2);
-            DrawTriangle(vertices, threadIndex);
+            unsigned chunkCount = Min(numVertices - chunkStart, PROJECT_CHUNK_TRIANGLES * 3);
+            ProjectPoints(modelViewProj, &srcData[chunkStart * batch.vertexSize_], batch.vertexSize_, projected, chunkCount);
 
-            index += 3;
+            for (unsigned index = 0; index < chunkCount; index += 3)
+            {
+                vertices[0] = projected[index];
+                vertices[1] = projected[index + 1];
+                vertices[2] = projected[index + 2];
+                DrawTriangle(vertices, threadIndex);
+            }
         }
     }
     else
@@ -32,6 +32,10 @@
 #include "../Scene/Scene.h"
 #include "../Scene/SceneEvents.h"
 
+#ifdef URHO3D_SSE
+#include <xmmintrin.h>
+#endif
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -43,8 +47,91 @@ static const unsigned MAX_PARTICLES_IN_FRAME = 100;
 
 extern const char* autoRemoveModeNames[];
 
+/// Advance timers, velocities and size scales of particles [0, count). Several particles are processed at once where SIMD is available.
+static void IntegrateParticles(ParticleArrays& particles, unsigned count, float timeStep, const Vector3& force, float dampingForce,
+    float sizeAdd, float sizeMul)
+{
+    float* velocityX = particles.velocityX_.Buffer();
+    float* velocityY = particles.velocityY_.Buffer();
+    float* velocityZ = particles.velocityZ_.Buffer();
+    float* timer = particles.timer_.Buffer();
+    float* scale = particles.scale_.Buffer();
+
+    // Applying the force and then damping the result is a multiply-add followed by a multiply
+    float damping = 1.0f - timeStep * dampingForce;
+    Vector3 forceStep = timeStep * force;
+    bool updateScale = sizeAdd != 0.0f || sizeMul != 1.0f;
+    float scaleAdd = timeStep * sizeAdd;
+    float scaleMul = sizeMul != 1.0f ? (timeStep * (sizeMul - 1.0f)) + 1.0f : 1.0f;
+
+    unsigned i = 0;
+
+#ifdef URHO3D_SSE
+    __m128 timeStep4 = _mm_set1_ps(timeStep);
+    __m128 damping4 = _mm_set1_ps(damping);
+    __m128 forceX4 = _mm_set1_ps(forceStep.x_);
+    __m128 forceY4 = _mm_set1_ps(forceStep.y_);
+    __m128 forceZ4 = _mm_set1_ps(forceStep.z_);
+    __m128 scaleAdd4 = _mm_set1_ps(scaleAdd);
+    __m128 scaleMul4 = _mm_set1_ps(scaleMul);
+    __m128 zero4 = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(&timer[i], _mm_add_ps(_mm_loadu_ps(&timer[i]), timeStep4));
+        _mm_storeu_ps(&velocityX[i], _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&velocityX[i]), forceX4), damping4));
+        _mm_storeu_ps(&velocityY[i], _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&velocityY[i]), forceY4), damping4));
+        _mm_storeu_ps(&velocityZ[i], _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&velocityZ[i]), forceZ4), damping4));
+        if (updateScale)
+        {
+            __m128 newScale = _mm_max_ps(_mm_add_ps(_mm_loadu_ps(&scale[i]), scaleAdd4), zero4);
+            _mm_storeu_ps(&scale[i], _mm_mul_ps(newScale, scaleMul4));
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        timer[i] += timeStep;
+        velocityX[i] = (velocityX[i] + forceStep.x_) * damping;
+        velocityY[i] = (velocityY[i] + forceStep.y_) * damping;
+        velocityZ[i] = (velocityZ[i] + forceStep.z_) * damping;
+        if (updateScale)
+            scale[i] = Max(scale[i] + scaleAdd, 0.0f) * scaleMul;
+    }
+}
+
+void ParticleArrays::Resize(unsigned num)
+{
+    velocityX_.Resize(num);
+    velocityY_.Resize(num);
+    velocityZ_.Resize(num);
+    size_.Resize(num);
+    timer_.Resize(num);
+    timeToLive_.Resize(num);
+    scale_.Resize(num);
+    rotationSpeed_.Resize(num);
+    colorIndex_.Resize(num);
+    texIndex_.Resize(num);
+}
+
+void ParticleArrays::Copy(unsigned dest, unsigned src)
+{
+    velocityX_[dest] = velocityX_[src];
+    velocityY_[dest] = velocityY_[src];
+    velocityZ_[dest] = velocityZ_[src];
+    size_[dest] = size_[src];
+    timer_[dest] = timer_[src];
+    timeToLive_[dest] = timeToLive_[src];
+    scale_[dest] = scale_[src];
+    rotationSpeed_[dest] = rotationSpeed_[src];
+    colorIndex_[dest] = colorIndex_[src];
+    texIndex_[dest] = texIndex_[src];
+}
+
 ParticleEmitter::ParticleEmitter(Context* context) :
     BillboardSet(context),
+    numActiveParticles_(0),
     periodTimer_(0.0f),
     emissionTimer_(0.0f),
     lastTimeStep_(0.0f),
@@ -53,7 +140,8 @@ ParticleEmitter::ParticleEmitter(Context* context) :
     needUpdate_(false),
     serializeParticles_(true),
     sendFinishedEvent_(true),
-    autoRemove_(REMOVE_DISABLED)
+    autoRemove_(REMOVE_DISABLED),
+    particlesPacked_(true)
 {
     SetNumParticles(DEFAULT_NUM_PARTICLES);
 }
@@ -84,6 +172,12 @@ void ParticleEmitter::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Serialize Particles", bool, serializeParticles_, true, AM_FILE);
 }
 
+void ParticleEmitter::ApplyAttributes()
+{
+    // Loaded billboards may have their enabled flags in any order
+    particlesPacked_ = false;
+}
+
 void ParticleEmitter::OnSetEnabled()
 {
     BillboardSet::OnSetEnabled();
@@ -109,7 +203,13 @@ void ParticleEmitter::Update(const FrameInfo& frame)
 
     // If there is an amount mismatch between particles and billboards, correct it
     if (particles_.Size() != billboards_.Size())
+    {
         SetNumBillboards(particles_.Size());
+        particlesPacked_ = false;
+    }
+
+    if (!particlesPacked_)
+        PackParticles();
 
     bool needCommit = false;
 
@@ -165,6 +265,17 @@ void ParticleEmitter::Update(const FrameInfo& frame)
         }
     }
 
+    // Remove particles whose time to live has been reached. This keeps the active particles packed at the beginning
+    if (numActiveParticles_)
+        needCommit = true;
+    for (unsigned i = 0; i < numActiveParticles_;)
+    {
+        if (particles_.timer_[i] >= particles_.timeToLive_[i])
+            RemoveParticle(i);
+        else
+            ++i;
+    }
+
     // Update existing particles
     Vector3 relativeConstantForce = node_->GetWorldRotation().Inverse() * effect_->GetConstantForce();
     // If billboards are not relative, apply scaling to the position update
@@ -172,84 +283,53 @@ void ParticleEmitter::Update(const FrameInfo& frame)
     if (scaled_ && !relative_)
         scaleVector = node_->GetWorldScale();
 
-    for (unsigned i = 0; i < particles_.Size(); ++i)
-    {
-        Particle& particle = particles_[i];
-        Billboard& billboard = billboards_[i];
-
-        if (billboard.enabled_)
-        {
-            needCommit = true;
-
-            // Time to live
-            if (particle.timer_ >= particle.timeToLive_)
-            {
-                billboard.enabled_ = false;
-                continue;
-            }
-            particle.timer_ += lastTimeStep_;
+    float sizeAdd = effect_->GetSizeAdd();
+    float sizeMul = effect_->GetSizeMul();
+    bool updateSize = sizeAdd != 0.0f || sizeMul != 1.0f;
+    const Vector<ColorFrame>& colorFrames = effect_->GetColorFrames();
+    const Vector<TextureFrame>& textureFrames = effect_->GetTextureFrames();
 
-            // Velocity & position
-            const Vector3& constantForce = effect_->GetConstantForce();
-            if (constantForce != Vector3::ZERO)
-            {
-                if (relative_)
-                    particle.velocity_ += lastTimeStep_ * relativeConstantForce;
-                else
-                    particle.velocity_ += lastTimeStep_ * constantForce;
-            }
+    IntegrateParticles(particles_, numActiveParticles_, lastTimeStep_, relative_ ? relativeConstantForce : effect_->GetConstantForce(),
+        effect_->GetDampingForce(), sizeAdd, sizeMul);
 
-            float dampingForce = effect_->GetDampingForce();
-            if (dampingForce != 0.0f)
-            {
-                Vector3 force = -dampingForce * particle.velocity_;
-                particle.velocity_ += lastTimeStep_ * force;
-            }
-            billboard.position_ += lastTimeStep_ * particle.velocity_ * scaleVector;
-            billboard.direction_ = particle.velocity_.Normalized();
+    for (unsigned i = 0; i < numActiveParticles_; ++i)
+    {
+        Billboard& billboard = billboards_[i];
+        float timer = particles_.timer_[i];
 
-            // Rotation
-            billboard.rotation_ += lastTimeStep_ * particle.rotationSpeed_;
+        // Position, direction & rotation
+        Vector3 velocity(particles_.velocityX_[i], particles_.velocityY_[i], particles_.velocityZ_[i]);
+        billboard.position_ += lastTimeStep_ * velocity * scaleVector;
+        billboard.direction_ = velocity.Normalized();
+        billboard.rotation_ += lastTimeStep_ * particles_.rotationSpeed_[i];
 
-            // Scaling
-            float sizeAdd = effect_->GetSizeAdd();
-            float sizeMul = effect_->GetSizeMul();
-            if (sizeAdd != 0.0f || sizeMul != 1.0f)
-            {
-                particle.scale_ += lastTimeStep_ * sizeAdd;
-                if (particle.scale_ < 0.0f)
-                    particle.scale_ = 0.0f;
-                if (sizeMul != 1.0f)
-                    particle.scale_ *= (lastTimeStep_ * (sizeMul - 1.0f)) + 1.0f;
-                billboard.size_ = particle.size_ * particle.scale_;
-            }
+        // Scaling
+        if (updateSize)
+            billboard.size_ = particles_.size_[i] * particles_.scale_[i];
 
-            // Color interpolation
-            unsigned& index = particle.colorIndex_;
-            const Vector<ColorFrame>& colorFrames_ = effect_->GetColorFrames();
-            if (index < colorFrames_.Size())
+        // Color interpolation
+        unsigned& index = particles_.colorIndex_[i];
+        if (index < colorFrames.Size())
+        {
+            if (index < colorFrames.Size() - 1)
             {
-                if (index < colorFrames_.Size() - 1)
-                {
-                    if (particle.timer_ >= colorFrames_[index + 1].time_)
-                        ++index;
-                }
-                if (index < colorFrames_.Size() - 1)
-                    billboard.color_ = colorFrames_[index].Interpolate(colorFrames_[index + 1], particle.timer_);
-                else
-                    billboard.color_ = colorFrames_[index].color_;
+                if (timer >= colorFrames[index + 1].time_)
+                    ++index;
             }
+            if (index < colorFrames.Size() - 1)
+                billboard.color_ = colorFrames[index].Interpolate(colorFrames[index + 1], timer);
+            else
+                billboard.color_ = colorFrames[index].color_;
+        }
 
-            // Texture animation
-            unsigned& texIndex = particle.texIndex_;
-            const Vector<TextureFrame>& textureFrames_ = effect_->GetTextureFrames();
-            if (textureFrames_.Size() && texIndex < textureFrames_.Size() - 1)
+        // Texture animation
+        unsigned& texIndex = particles_.texIndex_[i];
+        if (textureFrames.Size() && texIndex < textureFrames.Size() - 1)
+        {
+            if (timer >= textureFrames[texIndex + 1].time_)
             {
-                if (particle.timer_ >= textureFrames_[texIndex + 1].time_)
-                {
-                    billboard.uv_ = textureFrames_[texIndex + 1].uv_;
-                    ++texIndex;
-                }
+                billboard.uv_ = textureFrames[texIndex + 1].uv_;
+                ++texIndex;
             }
         }
     }
@@ -288,6 +368,8 @@ void ParticleEmitter::SetNumParticles(unsigned num)
 
     particles_.Resize(num);
     SetNumBillboards(num);
+    // Billboards beyond the old size are disabled, so the active particles stay packed
+    numActiveParticles_ = Min(numActiveParticles_, num);
 }
 
 void ParticleEmitter::SetEmitting(bool enable)
@@ -325,6 +407,8 @@ void ParticleEmitter::RemoveAllParticles()
     for (PODVector<Billboard>::Iterator i = billboards_.Begin(); i != billboards_.End(); ++i)
         i->enabled_ = false;
 
+    numActiveParticles_ = 0;
+    particlesPacked_ = true;
     Commit();
 }
 
@@ -371,17 +455,22 @@ void ParticleEmitter::SetParticlesAttr(const VariantVector& value)
     unsigned index = 0;
     SetNumParticles(index < value.Size() ? value[index++].GetUInt() : 0);
 
-    for (PODVector<Particle>::Iterator i = particles_.Begin(); i != particles_.End() && index < value.Size(); ++i)
+    for (unsigned i = 0; i < particles_.Size() && index < value.Size(); ++i)
     {
-        i->velocity_ = value[index++].GetVector3();
-        i->size_ = value[index++].GetVector2();
-        i->timer_ = value[index++].GetFloat();
-        i->timeToLive_ = value[index++].GetFloat();
-        i->scale_ = value[index++].GetFloat();
-        i->rotationSpeed_ = value[index++].GetFloat();
-        i->colorIndex_ = (unsigned)value[index++].GetInt();
-        i->texIndex_ = (unsigned)value[index++].GetInt();
+        const Vector3& velocity = value[index++].GetVector3();
+        particles_.velocityX_[i] = velocity.x_;
+        particles_.velocityY_[i] = velocity.y_;
+        particles_.velocityZ_[i] = velocity.z_;
+        particles_.size_[i] = value[index++].GetVector2();
+        particles_.timer_[i] = value[index++].GetFloat();
+        particles_.timeToLive_[i] = value[index++].GetFloat();
+        particles_.scale_[i] = value[index++].GetFloat();
+        particles_.rotationSpeed_[i] = value[index++].GetFloat();
+        particles_.colorIndex_[i] = (unsigned)value[index++].GetInt();
+        particles_.texIndex_[i] = (unsigned)value[index++].GetInt();
     }
+
+    particlesPacked_ = false;
 }
 
 VariantVector ParticleEmitter::GetParticlesAttr() const
@@ -395,16 +484,16 @@ VariantVector ParticleEmitter::GetParticlesAttr() const
 
     ret.Reserve(particles_.Size() * 8 + 1);
     ret.Push(particles_.Size());
-    for (PODVector<Particle>::ConstIterator i = particles_.Begin(); i != particles_.End(); ++i)
+    for (unsigned i = 0; i < particles_.Size(); ++i)
     {
-        ret.Push(i->velocity_);
-        ret.Push(i->size_);
-        ret.Push(i->timer_);
-        ret.Push(i->timeToLive_);
-        ret.Push(i->scale_);
-        ret.Push(i->rotationSpeed_);
-        ret.Push(i->colorIndex_);
-        ret.Push(i->texIndex_);
+        ret.Push(Vector3(particles_.velocityX_[i], particles_.velocityY_[i], particles_.velocityZ_[i]));
+        ret.Push(particles_.size_[i]);
+        ret.Push(particles_.timer_[i]);
+        ret.Push(particles_.timeToLive_[i]);
+        ret.Push(particles_.scale_[i]);
+        ret.Push(particles_.rotationSpeed_[i]);
+        ret.Push(particles_.colorIndex_[i]);
+        ret.Push(particles_.texIndex_[i]);
     }
     return ret;
 }
@@ -447,11 +536,14 @@ void ParticleEmitter::OnSceneSet(Scene* scene)
 
 bool ParticleEmitter::EmitNewParticle()
 {
+    if (!particlesPacked_)
+        PackParticles();
+
     unsigned index = GetFreeParticle();
     if (index == M_MAX_UNSIGNED)
         return false;
-    assert(index < particles_.Size());
-    Particle& particle = particles_[index];
+    assert(index == numActiveParticles_ && index < particles_.Size());
+    ++numActiveParticles_;
     Billboard& billboard = billboards_[index];
 
     Vector3 startDir;
@@ -513,17 +605,18 @@ bool ParticleEmitter::EmitNewParticle()
         break;
     }
 
-    particle.size_ = effect_->GetRandomSize();
-    particle.timer_ = 0.0f;
-    particle.timeToLive_ = effect_->GetRandomTimeToLive();
-    particle.scale_ = 1.0f;
-    particle.rotationSpeed_ = effect_->GetRandomRotationSpeed();
-    particle.colorIndex_ = 0;
-    particle.texIndex_ = 0;
+    Vector2 size = effect_->GetRandomSize();
+    particles_.size_[index] = size;
+    particles_.timer_[index] = 0.0f;
+    particles_.timeToLive_[index] = effect_->GetRandomTimeToLive();
+    particles_.scale_[index] = 1.0f;
+    particles_.rotationSpeed_[index] = effect_->GetRandomRotationSpeed();
+    particles_.colorIndex_[index] = 0;
+    particles_.texIndex_[index] = 0;
 
     if (faceCameraMode_ == FC_DIRECTION)
     {
-        startPos += startDir * particle.size_.y_;
+        startPos += startDir * size.y_;
     }
 
     if (!relative_)
@@ -532,10 +625,13 @@ bool ParticleEmitter::EmitNewParticle()
         startDir = node_->GetWorldRotation() * startDir;
     };
 
-    particle.velocity_ = effect_->GetRandomVelocity() * startDir;
+    Vector3 velocity = effect_->GetRandomVelocity() * startDir;
+    particles_.velocityX_[index] = velocity.x_;
+    particles_.velocityY_[index] = velocity.y_;
+    particles_.velocityZ_[index] = velocity.z_;
 
     billboard.position_ = startPos;
-    billboard.size_ = particles_[index].size_;
+    billboard.size_ = size;
     const Vector<TextureFrame>& textureFrames_ = effect_->GetTextureFrames();
     billboard.uv_ = textureFrames_.Size() ? textureFrames_[0].uv_ : Rect::POSITIVE;
     billboard.rotation_ = effect_->GetRandomRotation();
@@ -549,6 +645,9 @@ bool ParticleEmitter::EmitNewParticle()
 
 unsigned ParticleEmitter::GetFreeParticle() const
 {
+    if (particlesPacked_)
+        return numActiveParticles_ < billboards_.Size() ? numActiveParticles_ : M_MAX_UNSIGNED;
+
     for (unsigned i = 0; i < billboards_.Size(); ++i)
     {
         if (!billboards_[i].enabled_)
@@ -558,8 +657,61 @@ unsigned ParticleEmitter::GetFreeParticle() const
     return M_MAX_UNSIGNED;
 }
 
+unsigned ParticleEmitter::GetNumActiveParticles() const
+{
+    if (particlesPacked_)
+        return numActiveParticles_;
+
+    unsigned num = 0;
+    for (unsigned i = 0; i < billboards_.Size(); ++i)
+    {
+        if (billboards_[i].enabled_)
+            ++num;
+    }
+
+    return num;
+}
+
+void ParticleEmitter::PackParticles()
+{
+    unsigned num = Min(particles_.Size(), billboards_.Size());
+    numActiveParticles_ = 0;
+
+    for (unsigned i = 0; i < num; ++i)
+    {
+        if (billboards_[i].enabled_)
+        {
+            if (i != numActiveParticles_)
+            {
+                particles_.Copy(numActiveParticles_, i);
+                billboards_[numActiveParticles_] = billboards_[i];
+                billboards_[i].enabled_ = false;
+            }
+            ++numActiveParticles_;
+        }
+    }
+
+    particlesPacked_ = true;
+}
+
+void ParticleEmitter::RemoveParticle(unsigned index)
+{
+    assert(index < numActiveParticles_);
+
+    unsigned last = --numActiveParticles_;
+    if (index != last)
+    {
+        particles_.Copy(index, last);
+        billboards_[index] = billboards_[last];
+    }
+    billboards_[last].enabled_ = false;
+}
+
 bool ParticleEmitter::CheckActiveParticles() const
 {
+    if (particlesPacked_)
+        return numActiveParticles_ != 0;
+
     for (unsigned i = 0; i < billboards_.Size(); ++i)
     {
         if (billboards_[i].enabled_)
@@ -29,25 +29,36 @@ namespace Urho3D
 
 class ParticleEffect;
 
-/// One particle in the particle system.
-struct Particle
+/// Particle simulation state, stored as separate arrays per member so that several particles can be updated at once with SIMD instructions.
+struct URHO3D_API ParticleArrays
 {
-    /// Velocity.
-    Vector3 velocity_;
+    /// Resize all arrays.
+    void Resize(unsigned num);
+    /// Copy one particle over another.
+    void Copy(unsigned dest, unsigned src);
+    /// Return number of particles.
+    unsigned Size() const { return timer_.Size(); }
+
+    /// Velocity X component.
+    PODVector<float> velocityX_;
+    /// Velocity Y component.
+    PODVector<float> velocityY_;
+    /// Velocity Z component.
+    PODVector<float> velocityZ_;
     /// Original billboard size.
-    Vector2 size_;
+    PODVector<Vector2> size_;
     /// Time elapsed from creation.
-    float timer_;
+    PODVector<float> timer_;
     /// Lifetime.
-    float timeToLive_;
+    PODVector<float> timeToLive_;
     /// Size scaling value.
-    float scale_;
+    PODVector<float> scale_;
     /// Rotation speed.
-    float rotationSpeed_;
+    PODVector<float> rotationSpeed_;
     /// Current color animation index.
-    unsigned colorIndex_;
+    PODVector<unsigned> colorIndex_;
     /// Current texture animation index.
-    unsigned texIndex_;
+    PODVector<unsigned> texIndex_;
 };
 
 /// %Particle emitter component.
@@ -63,6 +74,8 @@ public:
     /// Register object factory.
     static void RegisterObject(Context* context);
 
+    /// Apply attribute changes that can not be applied immediately.
+    void ApplyAttributes() override;
     /// Handle enabled/disabled state change.
     void OnSetEnabled() override;
     /// Update before octree reinsertion. Is called from a worker thread.
@@ -92,6 +105,8 @@ public:
 
     /// Return maximum number of particles.
     unsigned GetNumParticles() const { return particles_.Size(); }
+    /// Return number of currently active particles.
+    unsigned GetNumActiveParticles() const;
 
     /// Return whether is currently emitting.
     bool IsEmitting() const { return emitting_; }
@@ -123,6 +138,10 @@ protected:
     unsigned GetFreeParticle() const;
     /// Return whether has active particles.
     bool CheckActiveParticles() const;
+    /// Move the active particles to the beginning of the arrays, in case billboards were enabled or disabled from outside.
+    void PackParticles();
+    /// Remove an active particle by moving the last active particle in its place.
+    void RemoveParticle(unsigned index);
 
 private:
     /// Handle scene post-update event.
@@ -132,8 +151,10 @@ private:
 
     /// Particle effect.
     SharedPtr<ParticleEffect> effect_;
-    /// Particles.
-    PODVector<Particle> particles_;
+    /// Particles. The active particles occupy the first numActiveParticles_ indices.
+    ParticleArrays particles_;
+    /// Number of active particles.
+    unsigned numActiveParticles_;
     /// Active/inactive period timer.
     float periodTimer_;
     /// New particle emission timer.
@@ -152,6 +173,8 @@ private:
     bool sendFinishedEvent_;
     /// Automatic removal mode.
     AutoRemoveMode autoRemove_;
+    /// Active particles are known to be at the beginning of the arrays flag.
+    bool particlesPacked_;
 };
 
 }
@@ -24,6 +24,7 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DrawableEvents.h"
 #include "../Graphics/Geometry.h"
 #include "../Graphics/IndexBuffer.h"
@@ -38,6 +39,7 @@
 #include "../Resource/ResourceEvents.h"
 #include "../Scene/Node.h"
 #include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
 
 #include "../DebugNew.h"
 
@@ -56,6 +58,34 @@ static const unsigned STITCH_NORTH = 1;
 static const unsigned STITCH_SOUTH = 2;
 static const unsigned STITCH_WEST = 4;
 static const unsigned STITCH_EAST = 8;
+static const float DEFAULT_STREAMING_UNLOAD_DELAY = 5.0f;
+static const unsigned TERRAIN_VERTEX_FLOATS = 12;
+
+/// %Terrain patch vertex data being generated in a worker thread in streaming mode.
+struct TerrainPatchBuild : public RefCounted
+{
+    /// Patch coordinates.
+    IntVector2 coordinates_;
+    /// Vertex buffer data.
+    SharedArrayPtr<float> vertexData_;
+    /// CPU-side position data.
+    SharedArrayPtr<unsigned char> cpuVertexData_;
+    /// CPU-side occlusion position data.
+    SharedArrayPtr<unsigned char> occlusionVertexData_;
+    /// Local-space bounding box.
+    BoundingBox box_;
+    /// Work item.
+    SharedPtr<WorkItem> workItem_;
+};
+
+void GeneratePatchVerticesWork(const WorkItem* item, unsigned threadIndex)
+{
+    const Terrain* terrain = reinterpret_cast<Terrain*>(item->start_);
+    TerrainPatchBuild* build = reinterpret_cast<TerrainPatchBuild*>(item->aux_);
+
+    terrain->GeneratePatchVertices(build->coordinates_, build->vertexData_.Get(), (float*)build->cpuVertexData_.Get(),
+        (float*)build->occlusionVertexData_.Get(), build->box_);
+}
 
 inline void GrowUpdateRegion(IntRect& updateRegion, int x, int y)
 {
@@ -110,12 +140,18 @@ Terrain::Terrain(Context* context) :
     westID_(0),
     eastID_(0),
     recreateTerrain_(false),
-    neighborsDirty_(false)
+    neighborsDirty_(false),
+    streaming_(false),
+    streamingUnloadDelay_(DEFAULT_STREAMING_UNLOAD_DELAY),
+    numPatchBuilds_(0)
 {
     indexBuffer_->SetShadowed(true);
 }
 
-Terrain::~Terrain() = default;
+Terrain::~Terrain()
+{
+    CancelPatchBuilds();
+}
 
 void Terrain::RegisterObject(Context* context)
 {
@@ -146,6 +182,9 @@ void Terrain::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Shadow Mask", GetShadowMask, SetShadowMask, unsigned, DEFAULT_SHADOWMASK, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Zone Mask", GetZoneMask, SetZoneMask, unsigned, DEFAULT_ZONEMASK, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Occlusion LOD level", GetOcclusionLodLevel, SetOcclusionLodLevelAttr, unsigned, M_MAX_UNSIGNED, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Streaming", IsStreaming, SetStreaming, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Streaming Unload Delay", GetStreamingUnloadDelay, SetStreamingUnloadDelay, float,
+        DEFAULT_STREAMING_UNLOAD_DELAY, AM_DEFAULT);
 }
 
 void Terrain::ApplyAttributes()
@@ -180,6 +219,11 @@ void Terrain::OnSetEnabled()
     }
 }
 
+void Terrain::OnSceneSet(Scene* scene)
+{
+    UpdateStreamingSubscription(scene);
+}
+
 void Terrain::SetPatchSize(int size)
 {
     if (size < MIN_PATCH_SIZE || size > MAX_PATCH_SIZE || !IsPowerOfTwo((unsigned)size))
@@ -187,6 +231,8 @@ void Terrain::SetPatchSize(int size)
 
     if (size != patchSize_)
     {
+        // Patch builds in progress size their output by the patch size
+        CancelPatchBuilds();
         patchSize_ = size;
 
         CreateGeometry();
@@ -509,6 +555,35 @@ void Terrain::SetOccludee(bool enable)
     MarkNetworkUpdate();
 }
 
+void Terrain::SetStreaming(bool enable)
+{
+    if (enable != streaming_)
+    {
+        streaming_ = enable;
+
+        // When leaving streaming mode, all patches need their vertex data again
+        if (!streaming_)
+        {
+            CancelPatchBuilds();
+
+            for (unsigned i = 0; i < patches_.Size(); ++i)
+            {
+                if (patches_[i] && !patches_[i]->IsGeometryLoaded())
+                    CreatePatchGeometry(patches_[i]);
+            }
+        }
+
+        UpdateStreamingSubscription(GetScene());
+        MarkNetworkUpdate();
+    }
+}
+
+void Terrain::SetStreamingUnloadDelay(float delay)
+{
+    streamingUnloadDelay_ = Max(delay, 0.0f);
+    MarkNetworkUpdate();
+}
+
 void Terrain::ApplyHeightMap()
 {
     if (heightMap_)
@@ -525,6 +600,18 @@ Material* Terrain::GetMaterial() const
     return material_;
 }
 
+unsigned Terrain::GetNumLoadedPatches() const
+{
+    unsigned count = 0;
+    for (unsigned i = 0; i < patches_.Size(); ++i)
+    {
+        if (patches_[i] && patches_[i]->IsGeometryLoaded())
+            ++count;
+    }
+
+    return count;
+}
+
 TerrainPatch* Terrain::GetPatch(unsigned index) const
 {
     return index < patches_.Size() ? patches_[index] : nullptr;
@@ -654,9 +741,6 @@ void Terrain::CreatePatchGeometry(TerrainPatch* patch)
 
     auto row = (unsigned)(patchSize_ + 1);
     VertexBuffer* vertexBuffer = patch->GetVertexBuffer();
-    Geometry* geometry = patch->GetGeometry();
-    Geometry* maxLodGeometry = patch->GetMaxLodGeometry();
-    Geometry* occlusionGeometry = patch->GetOcclusionGeometry();
 
     if (vertexBuffer->GetVertexCount() != row * row)
         vertexBuffer->SetSize(row * row, MASK_POSITION | MASK_NORMAL | MASK_TEXCOORD1 | MASK_TANGENT);
@@ -665,99 +749,86 @@ void Terrain::CreatePatchGeometry(TerrainPatch* patch)
     SharedArrayPtr<unsigned char> occlusionCpuVertexData(new unsigned char[row * row * sizeof(Vector3)]);
 
     auto* vertexData = (float*)vertexBuffer->Lock(0, vertexBuffer->GetVertexCount());
-    auto* positionData = (float*)cpuVertexData.Get();
-    auto* occlusionData = (float*)occlusionCpuVertexData.Get();
     BoundingBox box;
 
+    if (vertexData)
+    {
+        GeneratePatchVertices(patch->GetCoordinates(), vertexData, (float*)cpuVertexData.Get(),
+            (float*)occlusionCpuVertexData.Get(), box);
+
+        vertexBuffer->Unlock();
+        vertexBuffer->ClearDataLost();
+    }
+
+    SetPatchGeometry(patch, cpuVertexData, occlusionCpuVertexData, box);
+}
+
+void Terrain::GeneratePatchVertices(const IntVector2& coordinates, float* vertexData, float* positionData, float* occlusionData,
+    BoundingBox& box) const
+{
     unsigned occlusionLevel = occlusionLodLevel_;
     if (occlusionLevel > numLodLevels_ - 1)
         occlusionLevel = numLodLevels_ - 1;
 
-    if (vertexData)
-    {
-        const IntVector2& coords = patch->GetCoordinates();
-        unsigned lodExpand = (1u << (occlusionLevel)) - 1;
-        unsigned halfLodExpand = (1u << (occlusionLevel)) / 2;
+    unsigned lodExpand = (1u << (occlusionLevel)) - 1;
+    unsigned halfLodExpand = (1u << (occlusionLevel)) / 2;
 
-        for (unsigned z = 0; z <= patchSize_; ++z)
+    for (unsigned z = 0; z <= patchSize_; ++z)
+    {
+        for (unsigned x = 0; x <= patchSize_; ++x)
         {
-            for (unsigned x = 0; x <= patchSize_; ++x)
+            int xPos = coordinates.x_ * patchSize_ + x;
+            int zPos = coordinates.y_ * patchSize_ + z;
+
+            // Position
+            Vector3 position((float)x * spacing_.x_, GetRawHeight(xPos, zPos), (float)z * spacing_.z_);
+            *vertexData++ = position.x_;
+            *vertexData++ = position.y_;
+            *vertexData++ = position.z_;
+            *positionData++ = position.x_;
+            *positionData++ = position.y_;
+            *positionData++ = position.z_;
+
+            box.Merge(position);
+
+            // For vertices that are part of the occlusion LOD, calculate the minimum height in the neighborhood
+            // to prevent false positive occlusion due to inaccuracy between occlusion LOD & visible LOD
+            float minHeight = position.y_;
+            if (halfLodExpand > 0 && (x & lodExpand) == 0 && (z & lodExpand) == 0)
             {
-                int xPos = coords.x_ * patchSize_ + x;
-                int zPos = coords.y_ * patchSize_ + z;
-
-                // Position
-                Vector3 position((float)x * spacing_.x_, GetRawHeight(xPos, zPos), (float)z * spacing_.z_);
-                *vertexData++ = position.x_;
-                *vertexData++ = position.y_;
-                *vertexData++ = position.z_;
-                *positionData++ = position.x_;
-                *positionData++ = position.y_;
-                *positionData++ = position.z_;
-
-                box.Merge(position);
-
-                // For vertices that are part of the occlusion LOD, calculate the minimum height in the neighborhood
-                // to prevent false positive occlusion due to inaccuracy between occlusion LOD & visible LOD
-                float minHeight = position.y_;
-                if (halfLodExpand > 0 && (x & lodExpand) == 0 && (z & lodExpand) == 0)
+                int minX = Max(xPos - halfLodExpand, 0);
+                int maxX = Min(xPos + halfLodExpand, numVertices_.x_ - 1);
+                int minZ = Max(zPos - halfLodExpand, 0);
+                int maxZ = Min(zPos + halfLodExpand, numVertices_.y_ - 1);
+                for (int nZ = minZ; nZ <= maxZ; ++nZ)
                 {
-                    int minX = Max(xPos - halfLodExpand, 0);
-                    int maxX = Min(xPos + halfLodExpand, numVertices_.x_ - 1);
-                    int minZ = Max(zPos - halfLodExpand, 0);
-                    int maxZ = Min(zPos + halfLodExpand, numVertices_.y_ - 1);
-                    for (int nZ = minZ; nZ <= maxZ; ++nZ)
-                    {
-                        for (int nX = minX; nX <= maxX; ++nX)
-                            minHeight = Min(minHeight, GetRawHeight(nX, nZ));
-                    }
+                    for (int nX = minX; nX <= maxX; ++nX)
+                        minHeight = Min(minHeight, GetRawHeight(nX, nZ));
                 }
-                *occlusionData++ = position.x_;
-                *occlusionData++ = minHeight;
-                *occlusionData++ = position.z_;
-
-                // Normal
-                Vector3 normal = GetRawNormal(xPos, zPos);
-                *vertexData++ = normal.x_;
-                *vertexData++ = normal.y_;
-                *vertexData++ = normal.z_;
-
-                // Texture coordinate
-                Vector2 texCoord((float)xPos / (float)(numVertices_.x_ - 1), 1.0f - (float)zPos / (float)(numVertices_.y_ - 1));
-                *vertexData++ = texCoord.x_;
-                *vertexData++ = texCoord.y_;
-
-                // Tangent
-                Vector3 xyz = (Vector3::RIGHT - normal * normal.DotProduct(Vector3::RIGHT)).Normalized();
-                *vertexData++ = xyz.x_;
-                *vertexData++ = xyz.y_;
-                *vertexData++ = xyz.z_;
-                *vertexData++ = 1.0f;
             }
+            *occlusionData++ = position.x_;
+            *occlusionData++ = minHeight;
+            *occlusionData++ = position.z_;
+
+            // Normal
+            Vector3 normal = GetRawNormal(xPos, zPos);
+            *vertexData++ = normal.x_;
+            *vertexData++ = normal.y_;
+            *vertexData++ = normal.z_;
+
+            // Texture coordinate
+            Vector2 texCoord((float)xPos / (float)(numVertices_.x_ - 1), 1.0f - (float)zPos / (float)(numVertices_.y_ - 1));
+            *vertexData++ = texCoord.x_;
+            *vertexData++ = texCoord.y_;
+
+            // Tangent
+            Vector3 xyz = (Vector3::RIGHT - normal * normal.DotProduct(Vector3::RIGHT)).Normalized();
+            *vertexData++ = xyz.x_;
+            *vertexData++ = xyz.y_;
+            *vertexData++ = xyz.z_;
+            *vertexData++ = 1.0f;
         }
-
-        vertexBuffer->Unlock();
-        vertexBuffer->ClearDataLost();
     }
-
-    patch->SetBoundingBox(box);
-
-    if (drawRanges_.Size())
-    {
-        unsigned occlusionDrawRange = occlusionLevel << 4u;
-
-        geometry->SetIndexBuffer(indexBuffer_);
-        geometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[0].first_, drawRanges_[0].second_, false);
-        geometry->SetRawVertexData(cpuVertexData, MASK_POSITION);
-        maxLodGeometry->SetIndexBuffer(indexBuffer_);
-        maxLodGeometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[0].first_, drawRanges_[0].second_, false);
-        maxLodGeometry->SetRawVertexData(cpuVertexData, MASK_POSITION);
-        occlusionGeometry->SetIndexBuffer(indexBuffer_);
-        occlusionGeometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[occlusionDrawRange].first_, drawRanges_[occlusionDrawRange].second_, false);
-        occlusionGeometry->SetRawVertexData(occlusionCpuVertexData, MASK_POSITION);
-    }
-
-    patch->ResetLod();
 }
 
 void Terrain::UpdatePatchLod(TerrainPatch* patch)
@@ -808,6 +879,7 @@ void Terrain::SetPatchSizeAttr(int value)
 
     if (value != patchSize_)
     {
+        CancelPatchBuilds();
         patchSize_ = value;
         recreateTerrain_ = true;
     }
@@ -849,6 +921,9 @@ void Terrain::CreateGeometry()
 {
     recreateTerrain_ = false;
 
+    // Worker threads must not be reading the height data while it changes
+    CancelPatchBuilds();
+
     if (!node_)
         return;
 
@@ -1072,6 +1147,10 @@ void Terrain::CreateGeometry()
             }
         }
 
+        patchViewFrames_.Resize(patches_.Size());
+        patchIdleTimes_.Resize(patches_.Size());
+        patchBuilds_.Resize(patches_.Size());
+
         // Create the shared index data
         if (updateAll)
             CreateIndexData();
@@ -1115,8 +1194,20 @@ void Terrain::CreateGeometry()
 
             if (dirtyPatches[i])
             {
-                CreatePatchGeometry(patch);
-                CalculateLodErrors(patch);
+                // In streaming mode only calculate the bounds for culling. Patches that are already loaded are regenerated
+                // immediately on a partial update to avoid them disappearing until the next build finishes
+                if (streaming_ && (updateAll || !patch->IsGeometryLoaded()))
+                {
+                    UnloadPatchGeometry(patch);
+                    patch->SetBoundingBox(CalculateLodErrors(patch));
+                    patchViewFrames_[i] = 0;
+                    patchIdleTimes_[i] = 0.0f;
+                }
+                else
+                {
+                    CreatePatchGeometry(patch);
+                    CalculateLodErrors(patch);
+                }
             }
 
             SetPatchNeighbors(patch);
@@ -1362,45 +1453,47 @@ Vector3 Terrain::GetRawNormal(int x, int z) const
             Vector3(nwSlope, up, nwSlope)).Normalized();
 }
 
-void Terrain::CalculateLodErrors(TerrainPatch* patch)
+BoundingBox Terrain::CalculateLodErrors(TerrainPatch* patch)
 {
     URHO3D_PROFILE(CalculateLodErrors);
 
     const IntVector2& coords = patch->GetCoordinates();
     PODVector<float>& lodErrors = patch->GetLodErrors();
-    lodErrors.Clear();
-    lodErrors.Reserve(numLodLevels_);
+    lodErrors.Resize(numLodLevels_);
+    for (unsigned i = 0; i < numLodLevels_; ++i)
+        lodErrors[i] = 0.0f;
 
     int xStart = coords.x_ * patchSize_;
     int zStart = coords.y_ * patchSize_;
     int xEnd = xStart + patchSize_;
     int zEnd = zStart + patchSize_;
+    float minHeight = M_INFINITY;
+    float maxHeight = -M_INFINITY;
 
-    for (unsigned i = 0; i < numLodLevels_; ++i)
+    // Visit each height sample once, accumulating the height range and the error of every LOD level
+    for (int z = zStart; z <= zEnd; ++z)
     {
-        float maxError = 0.0f;
-        int divisor = 1u << i;
-
-        if (i > 0)
+        for (int x = xStart; x <= xEnd; ++x)
         {
-            for (int z = zStart; z <= zEnd; ++z)
+            float height = GetRawHeight(x, z);
+            minHeight = Min(minHeight, height);
+            maxHeight = Max(maxHeight, height);
+
+            for (unsigned i = 1; i < numLodLevels_; ++i)
             {
-                for (int x = xStart; x <= xEnd; ++x)
-                {
-                    if (x % divisor || z % divisor)
-                    {
-                        float error = Abs(GetLodHeight(x, z, i) - GetRawHeight(x, z));
-                        maxError = Max(error, maxError);
-                    }
-                }
+                int divisor = 1u << i;
+                if (x % divisor || z % divisor)
+                    lodErrors[i] = Max(lodErrors[i], Abs(GetLodHeight(x, z, i) - height));
             }
-
-            // Set error to be at least same as (half vertex spacing x LOD) to prevent horizontal stretches getting too inaccurate
-            maxError = Max(maxError, 0.25f * (spacing_.x_ + spacing_.z_) * (float)(1u << i));
         }
-
-        lodErrors.Push(maxError);
     }
+
+    // Set error to be at least same as (half vertex spacing x LOD) to prevent horizontal stretches getting too inaccurate
+    for (unsigned i = 1; i < numLodLevels_; ++i)
+        lodErrors[i] = Max(lodErrors[i], 0.25f * (spacing_.x_ + spacing_.z_) * (float)(1u << i));
+
+    return BoundingBox(Vector3(0.0f, minHeight, 0.0f), Vector3((float)patchSize_ * spacing_.x_, maxHeight,
+        (float)patchSize_ * spacing_.z_));
 }
 
 void Terrain::SetPatchNeighbors(TerrainPatch* patch)
@@ -1413,6 +1506,152 @@ void Terrain::SetPatchNeighbors(TerrainPatch* patch)
         GetNeighborPatch(coords.x_ - 1, coords.y_), GetNeighborPatch(coords.x_ + 1, coords.y_));
 }
 
+void Terrain::SetPatchGeometry(TerrainPatch* patch, const SharedArrayPtr<unsigned char>& cpuVertexData,
+    const SharedArrayPtr<unsigned char>& occlusionCpuVertexData, const BoundingBox& box)
+{
+    Geometry* geometry = patch->GetGeometry();
+    Geometry* maxLodGeometry = patch->GetMaxLodGeometry();
+    Geometry* occlusionGeometry = patch->GetOcclusionGeometry();
+
+    patch->SetBoundingBox(box);
+
+    if (drawRanges_.Size())
+    {
+        unsigned occlusionLevel = occlusionLodLevel_;
+        if (occlusionLevel > numLodLevels_ - 1)
+            occlusionLevel = numLodLevels_ - 1;
+        unsigned occlusionDrawRange = occlusionLevel << 4u;
+
+        geometry->SetIndexBuffer(indexBuffer_);
+        geometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[0].first_, drawRanges_[0].second_, false);
+        geometry->SetRawVertexData(cpuVertexData, MASK_POSITION);
+        maxLodGeometry->SetIndexBuffer(indexBuffer_);
+        maxLodGeometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[0].first_, drawRanges_[0].second_, false);
+        maxLodGeometry->SetRawVertexData(cpuVertexData, MASK_POSITION);
+        occlusionGeometry->SetIndexBuffer(indexBuffer_);
+        occlusionGeometry->SetDrawRange(TRIANGLE_LIST, drawRanges_[occlusionDrawRange].first_, drawRanges_[occlusionDrawRange].second_, false);
+        occlusionGeometry->SetRawVertexData(occlusionCpuVertexData, MASK_POSITION);
+    }
+
+    patch->ResetLod();
+    patch->SetGeometryLoaded(true);
+}
+
+void Terrain::UnloadPatchGeometry(TerrainPatch* patch)
+{
+    patch->SetGeometryLoaded(false);
+    patch->GetVertexBuffer()->SetSize(0, MASK_POSITION | MASK_NORMAL | MASK_TEXCOORD1 | MASK_TANGENT);
+    patch->GetGeometry()->SetRawVertexData(SharedArrayPtr<unsigned char>(), MASK_POSITION);
+    patch->GetMaxLodGeometry()->SetRawVertexData(SharedArrayPtr<unsigned char>(), MASK_POSITION);
+    patch->GetOcclusionGeometry()->SetRawVertexData(SharedArrayPtr<unsigned char>(), MASK_POSITION);
+}
+
+void Terrain::QueuePatchBuild(unsigned index)
+{
+    auto row = (unsigned)(patchSize_ + 1);
+
+    SharedPtr<TerrainPatchBuild> build(new TerrainPatchBuild());
+    build->coordinates_ = patches_[index]->GetCoordinates();
+    build->vertexData_ = new float[row * row * TERRAIN_VERTEX_FLOATS];
+    build->cpuVertexData_ = new unsigned char[row * row * sizeof(Vector3)];
+    build->occlusionVertexData_ = new unsigned char[row * row * sizeof(Vector3)];
+
+    // Use a non-pooled work item so that its completion can be polled, and the lowest priority so that waiting
+    // for the view update to complete never waits for streaming
+    build->workItem_ = new WorkItem();
+    build->workItem_->workFunction_ = GeneratePatchVerticesWork;
+    build->workItem_->start_ = this;
+    build->workItem_->aux_ = build.Get();
+    build->workItem_->priority_ = 0;
+
+    patchBuilds_[index] = build;
+    ++numPatchBuilds_;
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    if (queue)
+        queue->AddWorkItem(build->workItem_);
+    else
+    {
+        GeneratePatchVerticesWork(build->workItem_, 0);
+        build->workItem_->completed_ = true;
+    }
+}
+
+void Terrain::CancelPatchBuilds()
+{
+    if (!numPatchBuilds_)
+        return;
+
+    auto* queue = GetSubsystem<WorkQueue>();
+
+    for (unsigned i = 0; i < patchBuilds_.Size(); ++i)
+    {
+        TerrainPatchBuild* build = patchBuilds_[i];
+        if (!build)
+            continue;
+
+        // If a worker thread already took the build, it has to finish before the height data may change. Without a work
+        // queue the build was executed immediately when queued
+        if (queue && !queue->RemoveWorkItem(build->workItem_))
+            queue->CompleteItem(build->workItem_);
+
+        patchBuilds_[i].Reset();
+    }
+
+    numPatchBuilds_ = 0;
+}
+
+void Terrain::UpdateStreaming(float timeStep)
+{
+    URHO3D_PROFILE(UpdateTerrainStreaming);
+
+    auto row = (unsigned)(patchSize_ + 1);
+
+    for (unsigned i = 0; i < patches_.Size(); ++i)
+    {
+        TerrainPatch* patch = patches_[i];
+        if (!patch)
+            continue;
+
+        TerrainPatchBuild* build = patchBuilds_[i];
+        if (build && build->workItem_->completed_)
+        {
+            VertexBuffer* vertexBuffer = patch->GetVertexBuffer();
+            if (vertexBuffer->GetVertexCount() != row * row)
+                vertexBuffer->SetSize(row * row, MASK_POSITION | MASK_NORMAL | MASK_TEXCOORD1 | MASK_TANGENT);
+            vertexBuffer->SetData(build->vertexData_.Get());
+            vertexBuffer->ClearDataLost();
+
+            SetPatchGeometry(patch, build->cpuVertexData_, build->occlusionVertexData_, build->box_);
+            patchBuilds_[i].Reset();
+            --numPatchBuilds_;
+            build = nullptr;
+        }
+
+        // A changed view frame number means the patch has been in view since the last update
+        unsigned viewFrame = patch->GetViewFrameNumber();
+        bool inView = viewFrame != patchViewFrames_[i];
+        patchViewFrames_[i] = viewFrame;
+        patchIdleTimes_[i] = inView ? 0.0f : patchIdleTimes_[i] + timeStep;
+
+        if (patch->IsGeometryLoaded())
+        {
+            if (patchIdleTimes_[i] > streamingUnloadDelay_)
+                UnloadPatchGeometry(patch);
+        }
+        else if (inView && !build)
+            QueuePatchBuild(i);
+    }
+}
+
+void Terrain::UpdateStreamingSubscription(Scene* scene)
+{
+    if (scene && streaming_)
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(Terrain, HandleScenePostUpdate));
+    else
+        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+}
+
 bool Terrain::SetHeightMapInternal(Image* image, bool recreateNow)
 {
     if (image && image->IsCompressed())
@@ -1447,6 +1686,13 @@ void Terrain::HandleNeighborTerrainCreated(StringHash /*eventType*/, VariantMap&
     UpdateEdgePatchNeighbors();
 }
 
+void Terrain::HandleScenePostUpdate(StringHash /*eventType*/, VariantMap& eventData)
+{
+    using namespace ScenePostUpdate;
+
+    UpdateStreaming(eventData[P_TIMESTEP].GetFloat());
+}
+
 void Terrain::UpdateEdgePatchNeighbors()
 {
     for (int x = 1; x < numPatches_.x_ - 1; ++x)
@@ -33,6 +33,7 @@ class IndexBuffer;
 class Material;
 class Node;
 class TerrainPatch;
+struct TerrainPatchBuild;
 
 /// Heightmap terrain component.
 class URHO3D_API Terrain : public Component
@@ -51,6 +52,8 @@ public:
     void ApplyAttributes() override;
     /// Handle enabled/disabled state change.
     void OnSetEnabled() override;
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
 
     /// Set patch quads per side. Must be a power of two.
     void SetPatchSize(int size);
@@ -98,6 +101,10 @@ public:
     void SetOccluder(bool enable);
     /// Set occludee flag for patches.
     void SetOccludee(bool enable);
+    /// Set streaming mode. When enabled, patch vertex data is generated in worker threads once a patch becomes visible, and released after it has not been visible for the unload delay. Height data stays resident.
+    void SetStreaming(bool enable);
+    /// Set time in seconds after which a streamed patch that has not been visible releases its vertex data.
+    void SetStreamingUnloadDelay(float delay);
     /// Apply changes from the heightmap image.
     void ApplyHeightMap();
 
@@ -192,8 +199,19 @@ public:
     /// Return occludee flag.
     bool IsOccludee() const { return occludee_; }
 
+    /// Return whether streaming mode is enabled.
+    bool IsStreaming() const { return streaming_; }
+
+    /// Return streaming unload delay in seconds.
+    float GetStreamingUnloadDelay() const { return streamingUnloadDelay_; }
+
+    /// Return number of patches that currently have vertex data.
+    unsigned GetNumLoadedPatches() const;
+
     /// Regenerate patch geometry.
     void CreatePatchGeometry(TerrainPatch* patch);
+    /// Generate vertex data for the patch at given coordinates. Vertex data receives the full vertex format, position and occlusion data receive positions only. Reads only height data, so may be called from a worker thread.
+    void GeneratePatchVertices(const IntVector2& coordinates, float* vertexData, float* positionData, float* occlusionData, BoundingBox& box) const;
     /// Update patch based on LOD and neighbor LOD.
     void UpdatePatchLod(TerrainPatch* patch);
     /// Set heightmap attribute.
@@ -224,10 +242,25 @@ private:
     float GetLodHeight(int x, int z, unsigned lodLevel) const;
     /// Get slope-based terrain normal at position.
     Vector3 GetRawNormal(int x, int z) const;
-    /// Calculate LOD errors for a patch.
-    void CalculateLodErrors(TerrainPatch* patch);
+    /// Calculate LOD errors for a patch. Return the patch-local bounding box of its height data.
+    BoundingBox CalculateLodErrors(TerrainPatch* patch);
     /// Set neighbors for a patch.
     void SetPatchNeighbors(TerrainPatch* patch);
+    /// Assign generated CPU-side vertex data and draw ranges to patch geometries.
+    void SetPatchGeometry(TerrainPatch* patch, const SharedArrayPtr<unsigned char>& cpuVertexData,
+        const SharedArrayPtr<unsigned char>& occlusionCpuVertexData, const BoundingBox& box);
+    /// Release patch vertex data in streaming mode.
+    void UnloadPatchGeometry(TerrainPatch* patch);
+    /// Queue vertex data generation for a patch in streaming mode.
+    void QueuePatchBuild(unsigned index);
+    /// Cancel or wait for in-progress patch builds. Must be called before height data or patch layout changes.
+    void CancelPatchBuilds();
+    /// Upload finished patch builds, request visible patches and release patches that are no longer visible.
+    void UpdateStreaming(float timeStep);
+    /// Subscribe to or unsubscribe from scene post-update according to streaming mode.
+    void UpdateStreamingSubscription(Scene* scene);
+    /// Handle scene post-update event.
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
     /// Set heightmap image and optionally recreate the geometry immediately. Return true if successful.
     bool SetHeightMapInternal(Image* image, bool recreateNow);
     /// Handle heightmap image reload finished.
@@ -325,6 +358,18 @@ private:
     bool recreateTerrain_;
     /// Terrain neighbor attributes dirty flag.
     bool neighborsDirty_;
+    /// Streaming mode flag.
+    bool streaming_;
+    /// Streaming unload delay in seconds.
+    float streamingUnloadDelay_;
+    /// Last seen view frame number per patch in streaming mode.
+    PODVector<unsigned> patchViewFrames_;
+    /// Time since last visible per patch in streaming mode.
+    PODVector<float> patchIdleTimes_;
+    /// In-progress vertex data builds per patch in streaming mode.
+    Vector<SharedPtr<TerrainPatchBuild> > patchBuilds_;
+    /// Number of in-progress vertex data builds.
+    unsigned numPatchBuilds_;
 };
 
 }
@@ -52,7 +52,8 @@ TerrainPatch::TerrainPatch(Context* context) :
     occlusionGeometry_(new Geometry(context)),
     vertexBuffer_(new VertexBuffer(context)),
     coordinates_(IntVector2::ZERO),
-    lodLevel_(0)
+    lodLevel_(0),
+    geometryLoaded_(true)
 {
     geometry_->SetVertexBuffer(0, vertexBuffer_);
     maxLodGeometry_->SetVertexBuffer(0, vertexBuffer_);
@@ -88,7 +89,8 @@ void TerrainPatch::ProcessRayQuery(const RayOctreeQuery& query, PODVector<RayQue
             float distance = localRay.HitDistance(boundingBox_);
             Vector3 normal = -query.ray_.direction_;
 
-            if (level == RAY_TRIANGLE && distance < query.maxDistance_)
+            // Without vertex data only the bounding box can be tested
+            if (level == RAY_TRIANGLE && distance < query.maxDistance_ && geometryLoaded_)
             {
                 Vector3 geometryNormal;
                 distance = geometry_->GetHitDistance(localRay, &geometryNormal);
@@ -140,6 +142,9 @@ void TerrainPatch::UpdateBatches(const FrameInfo& frame)
 
 void TerrainPatch::UpdateGeometry(const FrameInfo& frame)
 {
+    if (!geometryLoaded_)
+        return;
+
     if (vertexBuffer_->IsDataLost())
     {
         if (owner_)
@@ -161,7 +166,9 @@ UpdateGeometryType TerrainPatch::GetUpdateGeometryType()
 
 Geometry* TerrainPatch::GetLodGeometry(unsigned batchIndex, unsigned level)
 {
-    if (!level)
+    if (!geometryLoaded_)
+        return nullptr;
+    else if (!level)
         return maxLodGeometry_;
     else
         return geometry_;
@@ -171,7 +178,7 @@ unsigned TerrainPatch::GetNumOccluderTriangles()
 {
     // Check that the material is suitable for occlusion (default material always is)
     Material* mat = batches_[0].material_;
-    if (mat && !mat->GetOcclusion())
+    if (!geometryLoaded_ || (mat && !mat->GetOcclusion()))
         return 0;
     else
         return occlusionGeometry_->GetIndexCount() / 3;
@@ -245,6 +252,12 @@ void TerrainPatch::ResetLod()
     lodLevel_ = 0;
 }
 
+void TerrainPatch::SetGeometryLoaded(bool enable)
+{
+    geometryLoaded_ = enable;
+    batches_[0].geometry_ = enable ? geometry_.Get() : nullptr;
+}
+
 Geometry* TerrainPatch::GetGeometry() const
 {
     return geometry_;
@@ -73,6 +73,8 @@ public:
     void SetCoordinates(const IntVector2& coordinates);
     /// Reset to LOD level 0.
     void ResetLod();
+    /// Set whether vertex data is loaded. A patch without vertex data is culled normally, but does not render, occlude or return triangle-level raycast hits. Used by terrain streaming.
+    void SetGeometryLoaded(bool enable);
 
     /// Return visible geometry.
     Geometry* GetGeometry() const;
@@ -106,6 +108,9 @@ public:
     /// Return current LOD level.
     unsigned GetLodLevel() const { return lodLevel_; }
 
+    /// Return whether vertex data is loaded.
+    bool IsGeometryLoaded() const { return geometryLoaded_; }
+
 protected:
     /// Recalculate the world-space bounding box.
     void OnWorldBoundingBoxUpdate() override;
@@ -138,6 +143,8 @@ private:
     IntVector2 coordinates_;
     /// Current LOD level.
     unsigned lodLevel_;
+    /// Vertex data loaded flag.
+    bool geometryLoaded_;
 };
 
 }
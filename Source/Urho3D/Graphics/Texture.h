@@ -189,6 +189,9 @@ public:
     /// Return the data type corresponding to an OpenGL internal format.
     static unsigned GetDataType(unsigned format);
 
+    /// Return whether a reload can be parsed on the background loader thread. Texture BeginLoad() only reads the images and parameters for EndLoad().
+    bool SupportsBackgroundReload() const override { return true; }
+
 protected:
     /// Check whether texture memory budget has been exceeded. Free unused materials in that case to release the texture references.
     void CheckTextureBudget(StringHash type);
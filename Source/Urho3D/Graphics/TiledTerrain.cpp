@@ -0,0 +1,1093 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/Profiler.h"
+#include "../Graphics/Camera.h"
+#include "../Graphics/Material.h"
+#include "../Graphics/Renderer.h"
+#include "../Graphics/Terrain.h"
+#include "../Graphics/TiledTerrain.h"
+#include "../Graphics/Viewport.h"
+#include "../IO/FileSystem.h"
+#include "../IO/Log.h"
+#include "../Resource/Image.h"
+#include "../Resource/ResourceCache.h"
+#include "../Resource/ResourceEvents.h"
+#include "../Resource/XMLFile.h"
+#include "../Scene/Node.h"
+#include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+extern const char* GEOMETRY_CATEGORY;
+
+static const Vector3 DEFAULT_SPACING(1.0f, 0.25f, 1.0f);
+static const int DEFAULT_PATCH_SIZE = 32;
+static const int MIN_PATCH_SIZE = 4;
+static const int MAX_PATCH_SIZE = 128;
+static const unsigned MIN_LOD_LEVELS = 1;
+static const unsigned MAX_LOD_LEVELS = 4;
+static const float DEFAULT_LOAD_DISTANCE = 500.0f;
+static const float DEFAULT_UNLOAD_DISTANCE = 600.0f;
+static const unsigned DEFAULT_HEIGHT_CACHE_SIZE = 64;
+static const unsigned DEFAULT_MAX_TILES_PER_UPDATE = 1;
+
+/// Return a raw 16-bit height from a heightmap pixel. Uses 8-bit grayscale, or red as MSB and green as LSB.
+static inline unsigned short GetPixelHeight(const unsigned char* pixel, unsigned components)
+{
+    return (unsigned short)(components == 1 ? pixel[0] << 8u : (pixel[0] << 8u) | pixel[1]);
+}
+
+TiledTerrain::TiledTerrain(Context* context) :
+    Component(context),
+    spacing_(DEFAULT_SPACING),
+    origin_(Vector2::ZERO),
+    numTiles_(IntVector2::ZERO),
+    numVertices_(IntVector2::ZERO),
+    overviewSize_(IntVector2::ZERO),
+    tileSize_(0),
+    overviewStep_(1),
+    patchSize_(DEFAULT_PATCH_SIZE),
+    maxLodLevels_(MAX_LOD_LEVELS),
+    loadDistance_(DEFAULT_LOAD_DISTANCE),
+    unloadDistance_(DEFAULT_UNLOAD_DISTANCE),
+    heightCacheSize_(DEFAULT_HEIGHT_CACHE_SIZE),
+    maxTilesPerUpdate_(DEFAULT_MAX_TILES_PER_UPDATE),
+    updateNumber_(0),
+    drawDistance_(0.0f),
+    shadowDistance_(0.0f),
+    lodBias_(1.0f),
+    viewMask_(DEFAULT_VIEWMASK),
+    lightMask_(DEFAULT_LIGHTMASK),
+    castShadows_(false),
+    occluder_(false),
+    occludee_(true)
+{
+}
+
+TiledTerrain::~TiledTerrain() = default;
+
+void TiledTerrain::RegisterObject(Context* context)
+{
+    context->RegisterFactory<TiledTerrain>(GEOMETRY_CATEGORY);
+
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Enabled", IsEnabled, SetEnabled, bool, true, AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Tile Set", GetTileSetAttr, SetTileSetAttr, ResourceRef, ResourceRef(XMLFile::GetTypeStatic()),
+        AM_DEFAULT);
+    URHO3D_MIXED_ACCESSOR_ATTRIBUTE("Material", GetMaterialAttr, SetMaterialAttr, ResourceRef, ResourceRef(Material::GetTypeStatic()),
+        AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Vertex Spacing", GetSpacing, SetSpacing, Vector3, DEFAULT_SPACING, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Patch Size", GetPatchSize, SetPatchSize, int, DEFAULT_PATCH_SIZE, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max LOD Levels", GetMaxLodLevels, SetMaxLodLevels, unsigned, MAX_LOD_LEVELS, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Load Distance", GetLoadDistance, SetLoadDistance, float, DEFAULT_LOAD_DISTANCE, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Unload Distance", GetUnloadDistance, SetUnloadDistance, float, DEFAULT_UNLOAD_DISTANCE, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Height Cache Size", GetHeightCacheSize, SetHeightCacheSize, unsigned, DEFAULT_HEIGHT_CACHE_SIZE,
+        AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Tiles Per Update", GetMaxTilesPerUpdate, SetMaxTilesPerUpdate, unsigned,
+        DEFAULT_MAX_TILES_PER_UPDATE, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Is Occluder", IsOccluder, SetOccluder, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Can Be Occluded", IsOccludee, SetOccludee, bool, true, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Cast Shadows", GetCastShadows, SetCastShadows, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Draw Distance", GetDrawDistance, SetDrawDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Shadow Distance", GetShadowDistance, SetShadowDistance, float, 0.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("LOD Bias", GetLodBias, SetLodBias, float, 1.0f, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("View Mask", GetViewMask, SetViewMask, unsigned, DEFAULT_VIEWMASK, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Light Mask", GetLightMask, SetLightMask, unsigned, DEFAULT_LIGHTMASK, AM_DEFAULT);
+}
+
+void TiledTerrain::OnSetEnabled()
+{
+    bool enabled = IsEnabledEffective();
+
+    for (unsigned i = 0; i < loadedTiles_.Size(); ++i)
+    {
+        Terrain* terrain = tiles_[loadedTiles_[i]].terrain_;
+        if (terrain)
+            terrain->SetEnabled(enabled);
+    }
+}
+
+void TiledTerrain::OnSceneSet(Scene* scene)
+{
+    if (scene)
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(TiledTerrain, HandleScenePostUpdate));
+    else
+        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+}
+
+void TiledTerrain::OnNodeSet(Node* node)
+{
+    // The tile nodes are children of the previous node, so they have to go with it
+    if (!node)
+        RemoveAllTiles();
+}
+
+bool TiledTerrain::SetTileSet(XMLFile* tileSet)
+{
+    RemoveAllTiles();
+    tiles_.Clear();
+    quadNodes_.Clear();
+    overview_.Clear();
+    cachedTiles_.Clear();
+    loadingTiles_.Clear();
+    numTiles_ = numVertices_ = overviewSize_ = IntVector2::ZERO;
+    tileSize_ = 0;
+    tileSet_ = tileSet;
+
+    MarkNetworkUpdate();
+
+    if (!tileSet)
+        return true;
+
+    XMLElement root = tileSet->GetRoot("terraintiles");
+    int tileSize = root.GetInt("tileSize");
+    IntVector2 numTiles = root.GetIntVector2("numTiles");
+    int overviewStep = root.GetInt("overviewStep");
+    if (tileSize < MIN_PATCH_SIZE || !IsPowerOfTwo((unsigned)tileSize) || numTiles.x_ <= 0 || numTiles.y_ <= 0 ||
+        overviewStep <= 0 || tileSize % overviewStep)
+    {
+        URHO3D_LOGERROR("Invalid terrain tile set " + tileSet->GetName());
+        return false;
+    }
+
+    // Read the height ranges of the tiles for the quadtree. They are stored in rows from south to north
+    tiles_.Resize((unsigned)(numTiles.x_ * numTiles.y_));
+    unsigned index = 0;
+    for (XMLElement tileElem = root.GetChild("tile"); tileElem && index < tiles_.Size(); tileElem = tileElem.GetNext("tile"), ++index)
+    {
+        tiles_[index].minHeight_ = (unsigned short)tileElem.GetUInt("min");
+        tiles_[index].maxHeight_ = (unsigned short)tileElem.GetUInt("max");
+    }
+    if (index < tiles_.Size())
+    {
+        URHO3D_LOGERROR("Terrain tile set " + tileSet->GetName() + " is missing tile height ranges");
+        tiles_.Clear();
+        return false;
+    }
+
+    // Decode the overview into raw heights, and release the image as only the heights are used
+    auto* cache = GetSubsystem<ResourceCache>();
+    String path = GetPath(tileSet->GetName());
+    String overviewName = path + root.GetAttribute("overview");
+    IntVector2 overviewSize(numTiles.x_ * tileSize / overviewStep + 1, numTiles.y_ * tileSize / overviewStep + 1);
+    auto* overview = cache->GetResource<Image>(overviewName);
+    if (!overview || overview->IsCompressed() || overview->GetWidth() != overviewSize.x_ || overview->GetHeight() != overviewSize.y_)
+    {
+        URHO3D_LOGERROR("Invalid overview image for terrain tile set " + tileSet->GetName());
+        tiles_.Clear();
+        if (overview)
+            cache->ReleaseResource<Image>(overviewName, true);
+        return false;
+    }
+
+    unsigned components = overview->GetComponents();
+    const unsigned char* src = overview->GetData();
+    overview_.Resize((unsigned)(overviewSize.x_ * overviewSize.y_));
+    for (int z = 0; z < overviewSize.y_; ++z)
+    {
+        for (int x = 0; x < overviewSize.x_; ++x)
+        {
+            overview_[z * overviewSize.x_ + x] = GetPixelHeight(src + ((overviewSize.y_ - 1 - z) * overviewSize.x_ + x) *
+                components, components);
+        }
+    }
+    cache->ReleaseResource<Image>(overviewName, true);
+
+    tilePrefix_ = path + root.GetAttribute("tiles");
+    tileSize_ = tileSize;
+    numTiles_ = numTiles;
+    numVertices_ = IntVector2(numTiles.x_ * tileSize + 1, numTiles.y_ * tileSize + 1);
+    overviewStep_ = overviewStep;
+    overviewSize_ = overviewSize;
+    origin_ = Vector2(-0.5f * (float)(numTiles.x_ * tileSize) * spacing_.x_, -0.5f * (float)(numTiles.y_ * tileSize) * spacing_.z_);
+
+    BuildQuadtree();
+    SubscribeToEvent(cache, E_RESOURCEBACKGROUNDLOADED, URHO3D_HANDLER(TiledTerrain, HandleResourceBackgroundLoaded));
+
+    return true;
+}
+
+void TiledTerrain::SetMaterial(Material* material)
+{
+    material_ = material;
+
+    for (unsigned i = 0; i < loadedTiles_.Size(); ++i)
+    {
+        Terrain* terrain = tiles_[loadedTiles_[i]].terrain_;
+        if (terrain)
+            terrain->SetMaterial(material);
+    }
+
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetSpacing(const Vector3& spacing)
+{
+    if (spacing != spacing_)
+    {
+        // Tiles are paged in again with the new spacing from the height cache
+        RemoveAllTiles();
+        spacing_ = spacing;
+        origin_ = Vector2(-0.5f * (float)(numTiles_.x_ * tileSize_) * spacing_.x_, -0.5f * (float)(numTiles_.y_ * tileSize_) *
+            spacing_.z_);
+
+        MarkNetworkUpdate();
+    }
+}
+
+void TiledTerrain::SetPatchSize(int size)
+{
+    if (size < MIN_PATCH_SIZE || size > MAX_PATCH_SIZE || !IsPowerOfTwo((unsigned)size))
+        return;
+
+    if (size != patchSize_)
+    {
+        RemoveAllTiles();
+        patchSize_ = size;
+
+        MarkNetworkUpdate();
+    }
+}
+
+void TiledTerrain::SetMaxLodLevels(unsigned levels)
+{
+    levels = Clamp(levels, MIN_LOD_LEVELS, MAX_LOD_LEVELS);
+    if (levels != maxLodLevels_)
+    {
+        RemoveAllTiles();
+        maxLodLevels_ = levels;
+
+        MarkNetworkUpdate();
+    }
+}
+
+void TiledTerrain::SetLoadDistance(float distance)
+{
+    loadDistance_ = Max(distance, 0.0f);
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetUnloadDistance(float distance)
+{
+    unloadDistance_ = Max(distance, 0.0f);
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetHeightCacheSize(unsigned tiles)
+{
+    heightCacheSize_ = tiles;
+    TrimHeightCache();
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetMaxTilesPerUpdate(unsigned tiles)
+{
+    maxTilesPerUpdate_ = Max(tiles, 1U);
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetFocusNode(Node* node)
+{
+    focusNode_ = node;
+}
+
+void TiledTerrain::SetDrawDistance(float distance)
+{
+    drawDistance_ = distance;
+    for (unsigned i = 0; i < loadedTiles_.Size(); ++i)
+    {
+        Terrain* terrain = tiles_[loadedTiles_[i]].terrain_;
+        if (terrain)
+            terrain->SetDrawDistance(distance);
+    }
+
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetShadowDistance(float distance)
+{
+    shadowDistance_ = distance;
+    for (unsigned i = 0; i < loadedTiles_.Size(); ++i)
+    {
+        Terrain* terrain = tiles_[loadedTiles_[i]].terrain_;
+        if (terrain)
+            terrain->SetShadowDistance(distance);
+    }
+
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetLodBias(float bias)
+{
+    lodBias_ = bias;
+    for (unsigned i = 0; i < loadedTiles_.Size(); ++i)
+    {
+        Terrain* terrain = tiles_[loadedTiles_[i]].terrain_;
+        if (terrain)
+            terrain->SetLodBias(bias);
+    }
+
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetViewMask(unsigned mask)
+{
+    viewMask_ = mask;
+    for (unsigned i = 0; i < loadedTiles_.Size(); ++i)
+    {
+        Terrain* terrain = tiles_[loadedTiles_[i]].terrain_;
+        if (terrain)
+            terrain->SetViewMask(mask);
+    }
+
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetLightMask(unsigned mask)
+{
+    lightMask_ = mask;
+    for (unsigned i = 0; i < loadedTiles_.Size(); ++i)
+    {
+        Terrain* terrain = tiles_[loadedTiles_[i]].terrain_;
+        if (terrain)
+            terrain->SetLightMask(mask);
+    }
+
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetCastShadows(bool enable)
+{
+    castShadows_ = enable;
+    for (unsigned i = 0; i < loadedTiles_.Size(); ++i)
+    {
+        Terrain* terrain = tiles_[loadedTiles_[i]].terrain_;
+        if (terrain)
+            terrain->SetCastShadows(enable);
+    }
+
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetOccluder(bool enable)
+{
+    occluder_ = enable;
+    for (unsigned i = 0; i < loadedTiles_.Size(); ++i)
+    {
+        Terrain* terrain = tiles_[loadedTiles_[i]].terrain_;
+        if (terrain)
+            terrain->SetOccluder(enable);
+    }
+
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::SetOccludee(bool enable)
+{
+    occludee_ = enable;
+    for (unsigned i = 0; i < loadedTiles_.Size(); ++i)
+    {
+        Terrain* terrain = tiles_[loadedTiles_[i]].terrain_;
+        if (terrain)
+            terrain->SetOccludee(enable);
+    }
+
+    MarkNetworkUpdate();
+}
+
+void TiledTerrain::UpdateTiles()
+{
+    if (!node_ || tiles_.Empty())
+        return;
+
+    URHO3D_PROFILE(UpdateTiledTerrain);
+
+    ++updateNumber_;
+
+    // Gather the focus positions in local space
+    Matrix3x4 inverseWorld = node_->GetWorldTransform().Inverse();
+    PODVector<Vector3> focusPositions;
+    if (focusNode_)
+        focusPositions.Push(inverseWorld * focusNode_->GetWorldPosition());
+    else
+    {
+        auto* renderer = GetSubsystem<Renderer>();
+        Scene* scene = GetScene();
+        for (unsigned i = 0; renderer && i < renderer->GetNumViewports(); ++i)
+        {
+            Viewport* viewport = renderer->GetViewport(i);
+            Camera* camera = viewport ? viewport->GetCamera() : nullptr;
+            if (camera && viewport->GetScene() == scene)
+                focusPositions.Push(inverseWorld * camera->GetNode()->GetWorldPosition());
+        }
+    }
+
+    if (focusPositions.Empty())
+        return;
+
+    // Page out the tiles that all focus positions have moved away from
+    for (unsigned i = loadedTiles_.Size() - 1; i < loadedTiles_.Size(); --i)
+    {
+        unsigned index = loadedTiles_[i];
+        const TerrainTile& tile = tiles_[index];
+        IntVector2 coords((int)index % numTiles_.x_, (int)index / numTiles_.x_);
+        BoundingBox box = GetTilesBoundingBox(IntRect(coords.x_, coords.y_, coords.x_ + 1, coords.y_ + 1), tile.minHeight_,
+            tile.maxHeight_);
+
+        float distance = M_INFINITY;
+        for (unsigned j = 0; j < focusPositions.Size(); ++j)
+            distance = Min(distance, box.DistanceToPoint(focusPositions[j]));
+        if (distance > Max(unloadDistance_, loadDistance_))
+            RemoveTileTerrain(index);
+    }
+
+    // Find the tiles within the load distance from the quadtree, and page in the nearest first
+    PODVector<Pair<float, unsigned> > wantedTiles;
+    for (unsigned i = 0; i < focusPositions.Size(); ++i)
+        CollectTiles(0, focusPositions[i], loadDistance_, wantedTiles);
+    Sort(wantedTiles.Begin(), wantedTiles.End());
+
+    unsigned numCreated = 0;
+    for (unsigned i = 0; i < wantedTiles.Size(); ++i)
+    {
+        unsigned index = wantedTiles[i].second_;
+        TerrainTile& tile = tiles_[index];
+        tile.lastUsed_ = updateNumber_;
+
+        if (tile.terrain_ || tile.loading_ || tile.failed_)
+            continue;
+
+        if (tile.heights_)
+        {
+            if (numCreated < maxTilesPerUpdate_)
+            {
+                SharedPtr<Image> image = CreateTileImage(index);
+                CreateTileTerrain(index, image);
+                ++numCreated;
+            }
+        }
+        else
+            RequestTile(index);
+    }
+
+    TrimHeightCache();
+}
+
+bool TiledTerrain::SaveTileSet(Image* heightMap, const String& fileName, int tileSize, int overviewStep) const
+{
+    if (!heightMap || heightMap->IsCompressed() || heightMap->GetDepth() > 1)
+    {
+        URHO3D_LOGERROR("Can not save a terrain tile set from a missing, compressed or 3D heightmap");
+        return false;
+    }
+
+    int width = heightMap->GetWidth();
+    int height = heightMap->GetHeight();
+    if (tileSize < MIN_PATCH_SIZE || !IsPowerOfTwo((unsigned)tileSize) || width <= tileSize || height <= tileSize ||
+        (width - 1) % tileSize || (height - 1) % tileSize)
+    {
+        URHO3D_LOGERROR("Heightmap size must be a multiple of the terrain tile size plus one");
+        return false;
+    }
+
+    overviewStep = Clamp((int)NextPowerOfTwo((unsigned)Max(overviewStep, 1)), 1, tileSize);
+    IntVector2 numTiles((width - 1) / tileSize, (height - 1) / tileSize);
+    String path = GetPath(fileName);
+    String baseName = GetFileName(fileName);
+    unsigned components = heightMap->GetComponents();
+    const unsigned char* src = heightMap->GetData();
+
+    SharedPtr<XMLFile> tileSet(new XMLFile(context_));
+    XMLElement root = tileSet->CreateRoot("terraintiles");
+    root.SetInt("tileSize", tileSize);
+    root.SetIntVector2("numTiles", numTiles);
+    root.SetInt("overviewStep", overviewStep);
+    root.SetAttribute("tiles", baseName + "_");
+    root.SetAttribute("overview", baseName + "_Overview.png");
+
+    // Tiles share their edge rows and columns with the neighbor tiles. Tile rows go from south to north, while north is at
+    // the top of the image
+    SharedPtr<Image> tileImage(new Image(context_));
+    tileImage->SetSize(tileSize + 1, tileSize + 1, 3);
+    for (int z = 0; z < numTiles.y_; ++z)
+    {
+        for (int x = 0; x < numTiles.x_; ++x)
+        {
+            int top = (numTiles.y_ - 1 - z) * tileSize;
+            int left = x * tileSize;
+            unsigned short minHeight = 0xffffu;
+            unsigned short maxHeight = 0;
+            unsigned char* dest = tileImage->GetData();
+
+            for (int y = top; y <= top + tileSize; ++y)
+            {
+                for (int i = left; i <= left + tileSize; ++i)
+                {
+                    unsigned short value = GetPixelHeight(src + (y * width + i) * components, components);
+                    minHeight = Min(minHeight, value);
+                    maxHeight = Max(maxHeight, value);
+                    *dest++ = (unsigned char)(value >> 8u);
+                    *dest++ = (unsigned char)(value & 0xffu);
+                    *dest++ = 0;
+                }
+            }
+
+            if (!tileImage->SavePNG(path + baseName + "_" + String(x) + "_" + String(z) + ".png"))
+                return false;
+
+            XMLElement tileElem = root.CreateChild("tile");
+            tileElem.SetUInt("min", minHeight);
+            tileElem.SetUInt("max", maxHeight);
+        }
+    }
+
+    SharedPtr<Image> overview(new Image(context_));
+    overview->SetSize((width - 1) / overviewStep + 1, (height - 1) / overviewStep + 1, 3);
+    unsigned char* dest = overview->GetData();
+    for (int y = 0; y < height; y += overviewStep)
+    {
+        for (int x = 0; x < width; x += overviewStep)
+        {
+            unsigned short value = GetPixelHeight(src + (y * width + x) * components, components);
+            *dest++ = (unsigned char)(value >> 8u);
+            *dest++ = (unsigned char)(value & 0xffu);
+            *dest++ = 0;
+        }
+    }
+
+    return overview->SavePNG(path + baseName + "_Overview.png") && tileSet->SaveFile(fileName);
+}
+
+XMLFile* TiledTerrain::GetTileSet() const
+{
+    return tileSet_;
+}
+
+Material* TiledTerrain::GetMaterial() const
+{
+    return material_;
+}
+
+Terrain* TiledTerrain::GetTileTerrain(int x, int z) const
+{
+    if (x < 0 || z < 0 || x >= numTiles_.x_ || z >= numTiles_.y_)
+        return nullptr;
+    else
+        return tiles_[z * numTiles_.x_ + x].terrain_;
+}
+
+BoundingBox TiledTerrain::GetBoundingBox() const
+{
+    if (quadNodes_.Empty())
+        return BoundingBox();
+
+    const TerrainQuadNode& root = quadNodes_[0];
+    return GetTilesBoundingBox(root.tiles_, root.minHeight_, root.maxHeight_);
+}
+
+float TiledTerrain::GetHeight(const Vector3& worldPosition) const
+{
+    if (node_ && !tiles_.Empty())
+    {
+        Vector3 position = node_->GetWorldTransform().Inverse() * worldPosition;
+        float xPos = Clamp((position.x_ - origin_.x_) / spacing_.x_, 0.0f, (float)(numVertices_.x_ - 1));
+        float zPos = Clamp((position.z_ - origin_.y_) / spacing_.z_, 0.0f, (float)(numVertices_.y_ - 1));
+        float xFrac = Fract(xPos);
+        float zFrac = Fract(zPos);
+        float h1, h2, h3;
+
+        if (xFrac + zFrac >= 1.0f)
+        {
+            h1 = GetRawHeight((int)xPos + 1, (int)zPos + 1);
+            h2 = GetRawHeight((int)xPos, (int)zPos + 1);
+            h3 = GetRawHeight((int)xPos + 1, (int)zPos);
+            xFrac = 1.0f - xFrac;
+            zFrac = 1.0f - zFrac;
+        }
+        else
+        {
+            h1 = GetRawHeight((int)xPos, (int)zPos);
+            h2 = GetRawHeight((int)xPos + 1, (int)zPos);
+            h3 = GetRawHeight((int)xPos, (int)zPos + 1);
+        }
+
+        float h = h1 * (1.0f - xFrac - zFrac) + h2 * xFrac + h3 * zFrac;
+        /// \todo This assumes that the terrain scene node is upright
+        return node_->GetWorldScale().y_ * h + node_->GetWorldPosition().y_;
+    }
+    else
+        return 0.0f;
+}
+
+Vector3 TiledTerrain::GetNormal(const Vector3& worldPosition) const
+{
+    if (node_ && !tiles_.Empty())
+    {
+        Vector3 position = node_->GetWorldTransform().Inverse() * worldPosition;
+        float xPos = Clamp((position.x_ - origin_.x_) / spacing_.x_, 0.0f, (float)(numVertices_.x_ - 1));
+        float zPos = Clamp((position.z_ - origin_.y_) / spacing_.z_, 0.0f, (float)(numVertices_.y_ - 1));
+        float xFrac = Fract(xPos);
+        float zFrac = Fract(zPos);
+        Vector3 n1, n2, n3;
+
+        if (xFrac + zFrac >= 1.0f)
+        {
+            n1 = GetRawNormal((int)xPos + 1, (int)zPos + 1);
+            n2 = GetRawNormal((int)xPos, (int)zPos + 1);
+            n3 = GetRawNormal((int)xPos + 1, (int)zPos);
+            xFrac = 1.0f - xFrac;
+            zFrac = 1.0f - zFrac;
+        }
+        else
+        {
+            n1 = GetRawNormal((int)xPos, (int)zPos);
+            n2 = GetRawNormal((int)xPos + 1, (int)zPos);
+            n3 = GetRawNormal((int)xPos, (int)zPos + 1);
+        }
+
+        Vector3 n = (n1 * (1.0f - xFrac - zFrac) + n2 * xFrac + n3 * zFrac).Normalized();
+        return node_->GetWorldRotation() * n;
+    }
+    else
+        return Vector3::UP;
+}
+
+void TiledTerrain::SetTileSetAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetTileSet(cache->GetResource<XMLFile>(value.name_));
+}
+
+void TiledTerrain::SetMaterialAttr(const ResourceRef& value)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    SetMaterial(cache->GetResource<Material>(value.name_));
+}
+
+ResourceRef TiledTerrain::GetTileSetAttr() const
+{
+    return GetResourceRef(tileSet_, XMLFile::GetTypeStatic());
+}
+
+ResourceRef TiledTerrain::GetMaterialAttr() const
+{
+    return GetResourceRef(material_, Material::GetTypeStatic());
+}
+
+void TiledTerrain::BuildQuadtree()
+{
+    // Split the tile rectangle breadth first, so that children always come after their parent
+    quadNodes_.Clear();
+    TerrainQuadNode root;
+    root.tiles_ = IntRect(0, 0, numTiles_.x_, numTiles_.y_);
+    quadNodes_.Push(root);
+
+    for (unsigned i = 0; i < quadNodes_.Size(); ++i)
+    {
+        IntRect tiles = quadNodes_[i].tiles_;
+        if (tiles.Width() == 1 && tiles.Height() == 1)
+        {
+            const TerrainTile& tile = tiles_[tiles.top_ * numTiles_.x_ + tiles.left_];
+            quadNodes_[i].minHeight_ = tile.minHeight_;
+            quadNodes_[i].maxHeight_ = tile.maxHeight_;
+            continue;
+        }
+
+        int midX = tiles.left_ + (tiles.Width() + 1) / 2;
+        int midZ = tiles.top_ + (tiles.Height() + 1) / 2;
+        IntRect childTiles[] = {
+            IntRect(tiles.left_, tiles.top_, midX, midZ),
+            IntRect(midX, tiles.top_, tiles.right_, midZ),
+            IntRect(tiles.left_, midZ, midX, tiles.bottom_),
+            IntRect(midX, midZ, tiles.right_, tiles.bottom_)
+        };
+
+        quadNodes_[i].firstChild_ = quadNodes_.Size();
+        for (const IntRect& rect : childTiles)
+        {
+            if (rect.Width() > 0 && rect.Height() > 0)
+            {
+                TerrainQuadNode child;
+                child.tiles_ = rect;
+                quadNodes_.Push(child);
+                ++quadNodes_[i].numChildren_;
+            }
+        }
+    }
+
+    // Propagate the height ranges up from the leaves
+    for (unsigned i = quadNodes_.Size() - 1; i < quadNodes_.Size(); --i)
+    {
+        TerrainQuadNode& quadNode = quadNodes_[i];
+        if (!quadNode.numChildren_)
+            continue;
+
+        quadNode.minHeight_ = 0xffffu;
+        quadNode.maxHeight_ = 0;
+        for (unsigned j = quadNode.firstChild_; j < quadNode.firstChild_ + quadNode.numChildren_; ++j)
+        {
+            quadNode.minHeight_ = Min(quadNode.minHeight_, quadNodes_[j].minHeight_);
+            quadNode.maxHeight_ = Max(quadNode.maxHeight_, quadNodes_[j].maxHeight_);
+        }
+    }
+}
+
+void TiledTerrain::CollectTiles(unsigned nodeIndex, const Vector3& position, float distance,
+    PODVector<Pair<float, unsigned> >& dest) const
+{
+    const TerrainQuadNode& quadNode = quadNodes_[nodeIndex];
+    float nodeDistance = GetTilesBoundingBox(quadNode.tiles_, quadNode.minHeight_, quadNode.maxHeight_).DistanceToPoint(position);
+    if (nodeDistance > distance)
+        return;
+
+    if (quadNode.numChildren_)
+    {
+        for (unsigned i = quadNode.firstChild_; i < quadNode.firstChild_ + quadNode.numChildren_; ++i)
+            CollectTiles(i, position, distance, dest);
+    }
+    else
+    {
+        // With several focus positions the same tile can be found more than once; keep the nearest
+        auto index = (unsigned)(quadNode.tiles_.top_ * numTiles_.x_ + quadNode.tiles_.left_);
+        for (unsigned i = 0; i < dest.Size(); ++i)
+        {
+            if (dest[i].second_ == index)
+            {
+                dest[i].first_ = Min(dest[i].first_, nodeDistance);
+                return;
+            }
+        }
+        dest.Push(MakePair(nodeDistance, index));
+    }
+}
+
+BoundingBox TiledTerrain::GetTilesBoundingBox(const IntRect& tiles, unsigned short minHeight, unsigned short maxHeight) const
+{
+    float tileWidth = (float)tileSize_ * spacing_.x_;
+    float tileDepth = (float)tileSize_ * spacing_.z_;
+    float heightScale = spacing_.y_ / 256.0f;
+
+    return BoundingBox(Vector3(origin_.x_ + (float)tiles.left_ * tileWidth, (float)minHeight * heightScale,
+        origin_.y_ + (float)tiles.top_ * tileDepth), Vector3(origin_.x_ + (float)tiles.right_ * tileWidth,
+        (float)maxHeight * heightScale, origin_.y_ + (float)tiles.bottom_ * tileDepth));
+}
+
+String TiledTerrain::GetTileName(unsigned index) const
+{
+    return tilePrefix_ + String(index % numTiles_.x_) + "_" + String(index / numTiles_.x_) + ".png";
+}
+
+void TiledTerrain::RequestTile(unsigned index)
+{
+    auto* cache = GetSubsystem<ResourceCache>();
+    String name = GetTileName(index);
+    TerrainTile& tile = tiles_[index];
+
+    if (cache->BackgroundLoadResource<Image>(name))
+    {
+        tile.loading_ = true;
+        loadingTiles_[StringHash(name)] = index;
+        return;
+    }
+
+    // The image was already loaded, or background loading is not available and it was loaded immediately
+    auto* image = cache->GetExistingResource<Image>(name);
+    if (image)
+    {
+        CacheTileHeights(index, image);
+        CreateTileTerrain(index, image);
+        cache->ReleaseResource<Image>(name, true);
+    }
+    else
+    {
+        URHO3D_LOGERROR("Could not load terrain tile " + name);
+        tile.failed_ = true;
+    }
+}
+
+void TiledTerrain::CacheTileHeights(unsigned index, Image* image)
+{
+    TerrainTile& tile = tiles_[index];
+    int row = tileSize_ + 1;
+    if (image->IsCompressed() || image->GetWidth() != row || image->GetHeight() != row)
+    {
+        URHO3D_LOGERROR("Terrain tile " + image->GetName() + " has wrong size or format");
+        tile.failed_ = true;
+        return;
+    }
+
+    if (!tile.heights_)
+    {
+        tile.heights_ = new unsigned short[row * row];
+        cachedTiles_.Push(index);
+    }
+
+    unsigned components = image->GetComponents();
+    const unsigned char* src = image->GetData();
+    unsigned short* dest = tile.heights_.Get();
+    for (int z = 0; z < row; ++z)
+    {
+        for (int x = 0; x < row; ++x)
+            *dest++ = GetPixelHeight(src + ((row - 1 - z) * row + x) * components, components);
+    }
+}
+
+SharedPtr<Image> TiledTerrain::CreateTileImage(unsigned index) const
+{
+    int row = tileSize_ + 1;
+    SharedPtr<Image> image(new Image(context_));
+    image->SetSize(row, row, 3);
+    image->SetName(GetTileName(index));
+
+    const unsigned short* src = tiles_[index].heights_.Get();
+    unsigned char* dest = image->GetData();
+    for (int z = row - 1; z >= 0; --z)
+    {
+        for (int x = 0; x < row; ++x)
+        {
+            unsigned short value = src[z * row + x];
+            *dest++ = (unsigned char)(value >> 8u);
+            *dest++ = (unsigned char)(value & 0xffu);
+            *dest++ = 0;
+        }
+    }
+
+    return image;
+}
+
+void TiledTerrain::CreateTileTerrain(unsigned index, Image* image)
+{
+    URHO3D_PROFILE(CreateTerrainTile);
+
+    TerrainTile& tile = tiles_[index];
+    if (!node_ || tile.terrain_ || tile.failed_)
+        return;
+
+    int x = (int)index % numTiles_.x_;
+    int z = (int)index / numTiles_.x_;
+
+    // Create the tile scene node as local and temporary so that it is not serialized or replicated. The terrain centers
+    // itself on the node
+    Node* tileNode = node_->CreateTemporaryChild("Tile_" + String(x) + "_" + String(z), LOCAL);
+    tileNode->SetPosition(Vector3(origin_.x_ + ((float)x + 0.5f) * (float)tileSize_ * spacing_.x_, 0.0f,
+        origin_.y_ + ((float)z + 0.5f) * (float)tileSize_ * spacing_.z_));
+
+    auto* terrain = tileNode->CreateComponent<Terrain>(LOCAL);
+    ApplyTileSettings(terrain);
+
+    // Connect the neighbors before the geometry is created, so that the LOD stitching is correct from the start
+    Terrain* north = GetTileTerrain(x, z + 1);
+    Terrain* south = GetTileTerrain(x, z - 1);
+    Terrain* west = GetTileTerrain(x - 1, z);
+    Terrain* east = GetTileTerrain(x + 1, z);
+    terrain->SetNeighbors(north, south, west, east);
+    if (north)
+        north->SetSouthNeighbor(terrain);
+    if (south)
+        south->SetNorthNeighbor(terrain);
+    if (west)
+        west->SetEastNeighbor(terrain);
+    if (east)
+        east->SetWestNeighbor(terrain);
+
+    terrain->SetHeightMap(image);
+
+    tile.terrain_ = terrain;
+    loadedTiles_.Push(index);
+}
+
+void TiledTerrain::RemoveTileTerrain(unsigned index)
+{
+    TerrainTile& tile = tiles_[index];
+    loadedTiles_.Remove(index);
+
+    Terrain* terrain = tile.terrain_;
+    if (!terrain)
+        return;
+
+    int x = (int)index % numTiles_.x_;
+    int z = (int)index / numTiles_.x_;
+    Terrain* north = GetTileTerrain(x, z + 1);
+    Terrain* south = GetTileTerrain(x, z - 1);
+    Terrain* west = GetTileTerrain(x - 1, z);
+    Terrain* east = GetTileTerrain(x + 1, z);
+    if (north)
+        north->SetSouthNeighbor(nullptr);
+    if (south)
+        south->SetNorthNeighbor(nullptr);
+    if (west)
+        west->SetEastNeighbor(nullptr);
+    if (east)
+        east->SetWestNeighbor(nullptr);
+
+    tile.terrain_.Reset();
+    terrain->GetNode()->Remove();
+}
+
+void TiledTerrain::RemoveAllTiles()
+{
+    while (!loadedTiles_.Empty())
+        RemoveTileTerrain(loadedTiles_.Back());
+}
+
+void TiledTerrain::ApplyTileSettings(Terrain* terrain) const
+{
+    terrain->SetEnabled(IsEnabledEffective());
+    terrain->SetPatchSize(Min(patchSize_, tileSize_));
+    terrain->SetSpacing(spacing_);
+    terrain->SetMaxLodLevels(maxLodLevels_);
+    terrain->SetMaterial(material_);
+    terrain->SetDrawDistance(drawDistance_);
+    terrain->SetShadowDistance(shadowDistance_);
+    terrain->SetLodBias(lodBias_);
+    terrain->SetViewMask(viewMask_);
+    terrain->SetLightMask(lightMask_);
+    terrain->SetCastShadows(castShadows_);
+    terrain->SetOccluder(occluder_);
+    terrain->SetOccludee(occludee_);
+    // Generate patch vertex data in worker threads once the patches become visible
+    terrain->SetStreaming(true);
+}
+
+void TiledTerrain::TrimHeightCache()
+{
+    while (cachedTiles_.Size() > heightCacheSize_)
+    {
+        // Find the least recently used tile that is not paged in or wanted by the current update
+        unsigned oldest = M_MAX_UNSIGNED;
+        for (unsigned i = 0; i < cachedTiles_.Size(); ++i)
+        {
+            const TerrainTile& tile = tiles_[cachedTiles_[i]];
+            if (!tile.terrain_ && tile.lastUsed_ != updateNumber_ &&
+                (oldest == M_MAX_UNSIGNED || tile.lastUsed_ < tiles_[cachedTiles_[oldest]].lastUsed_))
+                oldest = i;
+        }
+
+        if (oldest == M_MAX_UNSIGNED)
+            break;
+
+        tiles_[cachedTiles_[oldest]].heights_.Reset();
+        cachedTiles_.EraseSwap(oldest);
+    }
+}
+
+float TiledTerrain::GetRawHeight(int x, int z) const
+{
+    x = Clamp(x, 0, numVertices_.x_ - 1);
+    z = Clamp(z, 0, numVertices_.y_ - 1);
+
+    int tileX = Min(x / tileSize_, numTiles_.x_ - 1);
+    int tileZ = Min(z / tileSize_, numTiles_.y_ - 1);
+    float heightScale = spacing_.y_ / 256.0f;
+
+    // Vertices on a tile edge are shared with the west and south neighbors, so check those tiles too
+    int minTileX = (x == tileX * tileSize_ && tileX > 0) ? tileX - 1 : tileX;
+    int minTileZ = (z == tileZ * tileSize_ && tileZ > 0) ? tileZ - 1 : tileZ;
+    for (int tz = tileZ; tz >= minTileZ; --tz)
+    {
+        for (int tx = tileX; tx >= minTileX; --tx)
+        {
+            const TerrainTile& tile = tiles_[tz * numTiles_.x_ + tx];
+            if (tile.heights_)
+                return (float)tile.heights_[(z - tz * tileSize_) * (tileSize_ + 1) + x - tx * tileSize_] * heightScale;
+        }
+    }
+
+    // Interpolate from the overview when the tile is not in the height cache
+    int overviewX = Min(x / overviewStep_, overviewSize_.x_ - 2);
+    int overviewZ = Min(z / overviewStep_, overviewSize_.y_ - 2);
+    float xFrac = (float)(x - overviewX * overviewStep_) / (float)overviewStep_;
+    float zFrac = (float)(z - overviewZ * overviewStep_) / (float)overviewStep_;
+    const unsigned short* src = &overview_[overviewZ * overviewSize_.x_ + overviewX];
+    float south = (float)src[0] * (1.0f - xFrac) + (float)src[1] * xFrac;
+    float north = (float)src[overviewSize_.x_] * (1.0f - xFrac) + (float)src[overviewSize_.x_ + 1] * xFrac;
+    return (south * (1.0f - zFrac) + north * zFrac) * heightScale;
+}
+
+Vector3 TiledTerrain::GetRawNormal(int x, int z) const
+{
+    float baseHeight = GetRawHeight(x, z);
+    float nSlope = GetRawHeight(x, z - 1) - baseHeight;
+    float neSlope = GetRawHeight(x + 1, z - 1) - baseHeight;
+    float eSlope = GetRawHeight(x + 1, z) - baseHeight;
+    float seSlope = GetRawHeight(x + 1, z + 1) - baseHeight;
+    float sSlope = GetRawHeight(x, z + 1) - baseHeight;
+    float swSlope = GetRawHeight(x - 1, z + 1) - baseHeight;
+    float wSlope = GetRawHeight(x - 1, z) - baseHeight;
+    float nwSlope = GetRawHeight(x - 1, z - 1) - baseHeight;
+    float up = 0.5f * (spacing_.x_ + spacing_.z_);
+
+    return (Vector3(0.0f, up, nSlope) +
+            Vector3(-neSlope, up, neSlope) +
+            Vector3(-eSlope, up, 0.0f) +
+            Vector3(-seSlope, up, -seSlope) +
+            Vector3(0.0f, up, -sSlope) +
+            Vector3(swSlope, up, -swSlope) +
+            Vector3(wSlope, up, 0.0f) +
+            Vector3(nwSlope, up, nwSlope)).Normalized();
+}
+
+void TiledTerrain::HandleScenePostUpdate(StringHash /*eventType*/, VariantMap& /*eventData*/)
+{
+    if (IsEnabledEffective())
+        UpdateTiles();
+}
+
+void TiledTerrain::HandleResourceBackgroundLoaded(StringHash /*eventType*/, VariantMap& eventData)
+{
+    using namespace ResourceBackgroundLoaded;
+
+    const String& name = eventData[P_RESOURCENAME].GetString();
+    HashMap<StringHash, unsigned>::Iterator i = loadingTiles_.Find(StringHash(name));
+    if (i == loadingTiles_.End())
+        return;
+
+    unsigned index = i->second_;
+    loadingTiles_.Erase(i);
+    TerrainTile& tile = tiles_[index];
+    tile.loading_ = false;
+
+    if (!eventData[P_SUCCESS].GetBool())
+    {
+        tile.failed_ = true;
+        return;
+    }
+
+    // Keep only the height samples and the terrain's own reference to the image, not the resource cache's
+    auto* image = static_cast<Image*>(eventData[P_RESOURCE].GetPtr());
+    SharedPtr<Image> imageRef(image);
+    CacheTileHeights(index, image);
+    GetSubsystem<ResourceCache>()->ReleaseResource<Image>(name, true);
+
+    // Page in immediately if the tile is still wanted, otherwise the heights stay cached for later
+    if (tile.lastUsed_ == updateNumber_)
+        CreateTileTerrain(index, image);
+}
+
+}
@@ -0,0 +1,322 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/ArrayPtr.h"
+#include "../Scene/Component.h"
+
+namespace Urho3D
+{
+
+class Image;
+class Material;
+class Terrain;
+class XMLFile;
+
+/// %Tile of a tiled terrain.
+struct TerrainTile
+{
+    /// Minimum raw height from the tile set description.
+    unsigned short minHeight_{};
+    /// Maximum raw height from the tile set description.
+    unsigned short maxHeight_{};
+    /// Cached raw height samples with south at row 0, or null if not in the height cache.
+    SharedArrayPtr<unsigned short> heights_;
+    /// Paged-in terrain, or null if not paged in.
+    WeakPtr<Terrain> terrain_;
+    /// Update number when the tile was last within the load distance.
+    unsigned lastUsed_{};
+    /// Background loading in progress flag.
+    bool loading_{};
+    /// Loading failed flag. A failed tile is not requested again.
+    bool failed_{};
+};
+
+/// Quadtree node of a tiled terrain, covering a rectangle of tiles.
+struct TerrainQuadNode
+{
+    /// Covered tiles. Right and bottom are exclusive, top is the southmost tile row.
+    IntRect tiles_;
+    /// Minimum raw height within the node.
+    unsigned short minHeight_{};
+    /// Maximum raw height within the node.
+    unsigned short maxHeight_{};
+    /// Index of the first child node.
+    unsigned firstChild_{};
+    /// Number of child nodes, 0 for a single tile.
+    unsigned numChildren_{};
+};
+
+/// Large heightmap terrain that pages tiles in and out around the camera. Each paged-in tile is a streaming Terrain component in a temporary child node, and tiles are found through a quadtree of the tile height ranges. Only the tile set description and a downsampled overview of the heights are loaded up front; tile heightmaps are loaded in the background through the resource cache and kept in a height cache of 16-bit samples.
+class URHO3D_API TiledTerrain : public Component
+{
+    URHO3D_OBJECT(TiledTerrain, Component);
+
+public:
+    /// Construct.
+    explicit TiledTerrain(Context* context);
+    /// Destruct.
+    ~TiledTerrain() override;
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+
+    /// Handle enabled/disabled state change.
+    void OnSetEnabled() override;
+    /// Handle scene being assigned.
+    void OnSceneSet(Scene* scene) override;
+
+    /// Set tile set description. Return true if successful.
+    bool SetTileSet(XMLFile* tileSet);
+    /// Set material of the tiles.
+    void SetMaterial(Material* material);
+    /// Set vertex (XZ) and height (Y) spacing.
+    void SetSpacing(const Vector3& spacing);
+    /// Set patch quads per side. Must be a power of two, and not larger than the tile size.
+    void SetPatchSize(int size);
+    /// Set maximum number of LOD levels for terrain patches. This can be between 1-4.
+    void SetMaxLodLevels(unsigned levels);
+    /// Set distance from the focus within which tiles are paged in.
+    void SetLoadDistance(float distance);
+    /// Set distance from the focus beyond which tiles are paged out. Should be larger than the load distance to avoid tiles being repeatedly paged in and out.
+    void SetUnloadDistance(float distance);
+    /// Set number of tiles whose height samples are kept in memory. Paged-in tiles always stay cached.
+    void SetHeightCacheSize(unsigned tiles);
+    /// Set maximum number of tiles paged in per update. Paging in a tile creates its patches and LOD data in the main thread.
+    void SetMaxTilesPerUpdate(unsigned tiles);
+    /// Set node whose position tiles are paged in around. If null (default), the cameras of the renderer viewports showing the scene are used.
+    void SetFocusNode(Node* node);
+    /// Set draw distance for patches.
+    void SetDrawDistance(float distance);
+    /// Set shadow draw distance for patches.
+    void SetShadowDistance(float distance);
+    /// Set LOD bias for patches.
+    void SetLodBias(float bias);
+    /// Set view mask for patches.
+    void SetViewMask(unsigned mask);
+    /// Set light mask for patches.
+    void SetLightMask(unsigned mask);
+    /// Set shadowcaster flag for patches.
+    void SetCastShadows(bool enable);
+    /// Set occluder flag for patches.
+    void SetOccluder(bool enable);
+    /// Set occludee flag for patches.
+    void SetOccludee(bool enable);
+    /// Page tiles in and out for the focus. Called automatically on scene post-update.
+    void UpdateTiles();
+    /// Split a heightmap image into a tile set for this component: tile heightmaps, an overview image and the tile set description, written next to the given description file name. The heightmap size must be a multiple of the tile size plus one, and the tile size a power of two. Return true if successful.
+    bool SaveTileSet(Image* heightMap, const String& fileName, int tileSize, int overviewStep = 16) const;
+
+    /// Return tile set description.
+    XMLFile* GetTileSet() const;
+    /// Return material.
+    Material* GetMaterial() const;
+
+    /// Return vertex and height spacing.
+    const Vector3& GetSpacing() const { return spacing_; }
+
+    /// Return patch quads per side.
+    int GetPatchSize() const { return patchSize_; }
+
+    /// Return maximum number of LOD levels.
+    unsigned GetMaxLodLevels() const { return maxLodLevels_; }
+
+    /// Return load distance.
+    float GetLoadDistance() const { return loadDistance_; }
+
+    /// Return unload distance.
+    float GetUnloadDistance() const { return unloadDistance_; }
+
+    /// Return height cache size in tiles.
+    unsigned GetHeightCacheSize() const { return heightCacheSize_; }
+
+    /// Return maximum number of tiles paged in per update.
+    unsigned GetMaxTilesPerUpdate() const { return maxTilesPerUpdate_; }
+
+    /// Return focus node.
+    Node* GetFocusNode() const { return focusNode_; }
+
+    /// Return draw distance.
+    float GetDrawDistance() const { return drawDistance_; }
+
+    /// Return shadow draw distance.
+    float GetShadowDistance() const { return shadowDistance_; }
+
+    /// Return LOD bias.
+    float GetLodBias() const { return lodBias_; }
+
+    /// Return view mask.
+    unsigned GetViewMask() const { return viewMask_; }
+
+    /// Return light mask.
+    unsigned GetLightMask() const { return lightMask_; }
+
+    /// Return shadowcaster flag.
+    bool GetCastShadows() const { return castShadows_; }
+
+    /// Return occluder flag.
+    bool IsOccluder() const { return occluder_; }
+
+    /// Return occludee flag.
+    bool IsOccludee() const { return occludee_; }
+
+    /// Return tile size in quads.
+    int GetTileSize() const { return tileSize_; }
+
+    /// Return terrain size in tiles.
+    const IntVector2& GetNumTiles() const { return numTiles_; }
+
+    /// Return terrain size in vertices.
+    const IntVector2& GetNumVertices() const { return numVertices_; }
+
+    /// Return number of paged-in tiles.
+    unsigned GetNumLoadedTiles() const { return loadedTiles_.Size(); }
+
+    /// Return number of tiles in the height cache.
+    unsigned GetNumCachedTiles() const { return cachedTiles_.Size(); }
+
+    /// Return number of tiles being loaded in the background.
+    unsigned GetNumLoadingTiles() const { return loadingTiles_.Size(); }
+
+    /// Return paged-in terrain of a tile, or null if not paged in.
+    Terrain* GetTileTerrain(int x, int z) const;
+    /// Return local space bounding box of the whole terrain.
+    BoundingBox GetBoundingBox() const;
+    /// Return height at world coordinates. Uses the cached height samples of the tile, or the overview if the tile is not cached.
+    float GetHeight(const Vector3& worldPosition) const;
+    /// Return normal at world coordinates. Uses the cached height samples of the tile, or the overview if the tile is not cached.
+    Vector3 GetNormal(const Vector3& worldPosition) const;
+
+    /// Set tile set attribute.
+    void SetTileSetAttr(const ResourceRef& value);
+    /// Set material attribute.
+    void SetMaterialAttr(const ResourceRef& value);
+    /// Return tile set attribute.
+    ResourceRef GetTileSetAttr() const;
+    /// Return material attribute.
+    ResourceRef GetMaterialAttr() const;
+
+protected:
+    /// Handle scene node being assigned at creation.
+    void OnNodeSet(Node* node) override;
+
+private:
+    /// Build the quadtree from the tile height ranges.
+    void BuildQuadtree();
+    /// Collect tiles within distance of a local space position, with their distances.
+    void CollectTiles(unsigned nodeIndex, const Vector3& position, float distance, PODVector<Pair<float, unsigned> >& dest) const;
+    /// Return local space bounding box of a tile rectangle and raw height range.
+    BoundingBox GetTilesBoundingBox(const IntRect& tiles, unsigned short minHeight, unsigned short maxHeight) const;
+    /// Return resource name of a tile heightmap.
+    String GetTileName(unsigned index) const;
+    /// Start loading a tile heightmap in the background.
+    void RequestTile(unsigned index);
+    /// Store the height samples of a loaded tile heightmap in the height cache.
+    void CacheTileHeights(unsigned index, Image* image);
+    /// Create a heightmap image from the cached height samples of a tile.
+    SharedPtr<Image> CreateTileImage(unsigned index) const;
+    /// Page in a tile: create its terrain from a heightmap image and connect it to the neighbor tiles.
+    void CreateTileTerrain(unsigned index, Image* image);
+    /// Page out a tile.
+    void RemoveTileTerrain(unsigned index);
+    /// Page out all tiles.
+    void RemoveAllTiles();
+    /// Apply the terrain and drawable settings to a paged-in tile.
+    void ApplyTileSettings(Terrain* terrain) const;
+    /// Release least recently used height samples beyond the height cache size.
+    void TrimHeightCache();
+    /// Return a raw height sample, clamping to edges.
+    float GetRawHeight(int x, int z) const;
+    /// Return slope-based normal at a height sample.
+    Vector3 GetRawNormal(int x, int z) const;
+    /// Handle scene post-update event.
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle a tile heightmap finishing background loading.
+    void HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData);
+
+    /// Tile set description.
+    SharedPtr<XMLFile> tileSet_;
+    /// Material.
+    SharedPtr<Material> material_;
+    /// Focus node.
+    WeakPtr<Node> focusNode_;
+    /// Tiles.
+    Vector<TerrainTile> tiles_;
+    /// Quadtree nodes. The root is the first node.
+    PODVector<TerrainQuadNode> quadNodes_;
+    /// Raw height samples of the overview, with south at row 0.
+    PODVector<unsigned short> overview_;
+    /// Paged-in tile indices.
+    PODVector<unsigned> loadedTiles_;
+    /// Cached tile indices.
+    PODVector<unsigned> cachedTiles_;
+    /// Tiles being loaded in the background by resource name.
+    HashMap<StringHash, unsigned> loadingTiles_;
+    /// Tile heightmap resource name prefix.
+    String tilePrefix_;
+    /// Vertex and height spacing.
+    Vector3 spacing_;
+    /// Origin of the tiles on the XZ-plane.
+    Vector2 origin_;
+    /// Terrain size in tiles.
+    IntVector2 numTiles_;
+    /// Terrain size in vertices.
+    IntVector2 numVertices_;
+    /// Overview size in samples.
+    IntVector2 overviewSize_;
+    /// Tile size in quads.
+    int tileSize_;
+    /// Distance between overview samples in height samples.
+    int overviewStep_;
+    /// Patch size in quads.
+    int patchSize_;
+    /// Maximum number of LOD levels.
+    unsigned maxLodLevels_;
+    /// Load distance.
+    float loadDistance_;
+    /// Unload distance.
+    float unloadDistance_;
+    /// Height cache size in tiles.
+    unsigned heightCacheSize_;
+    /// Maximum number of tiles paged in per update.
+    unsigned maxTilesPerUpdate_;
+    /// Number of tile updates so far.
+    unsigned updateNumber_;
+    /// Draw distance.
+    float drawDistance_;
+    /// Shadow distance.
+    float shadowDistance_;
+    /// LOD bias.
+    float lodBias_;
+    /// View mask.
+    unsigned viewMask_;
+    /// Light mask.
+    unsigned lightMask_;
+    /// Shadowcaster flag.
+    bool castShadows_;
+    /// Occluder flag.
+    bool occluder_;
+    /// Occludee flag.
+    bool occludee_;
+};
+
+}
@@ -1363,8 +1363,10 @@ void View::UpdateGeometries()
             (*i)->UpdateGeometry(frame_);
     }
 
-    // Finally ensure all threaded work has completed
+    // Finally ensure all threaded work has completed, including work queued by the non-threaded updates
     queue->Complete(M_MAX_UNSIGNED);
+    for (PODVector<Drawable*>::ConstIterator i = nonThreadedGeometries_.Begin(); i != nonThreadedGeometries_.End(); ++i)
+        (*i)->FinishUpdateGeometry();
     geometriesUpdated_ = true;
 }
 
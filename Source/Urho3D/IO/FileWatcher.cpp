@@ -46,13 +46,15 @@ extern "C"
 namespace Urho3D
 {
 #ifndef __APPLE__
-static const unsigned BUFFERSIZE = 4096;
+// Large enough to drain a burst of notifications with one system call
+static const unsigned BUFFERSIZE = 65536;
 #endif
 
 FileWatcher::FileWatcher(Context* context) :
     Object(context),
     fileSystem_(GetSubsystem<FileSystem>()),
     delay_(1.0f),
+    maxBatchDelay_(5.0f),
     watchSubDirs_(false)
 {
 #ifdef URHO3D_FILEWATCHER
@@ -113,7 +115,7 @@ bool FileWatcher::StartWatching(const String& pathName, bool watchSubDirs)
         return false;
     }
 #elif defined(__linux__)
-    int flags = IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO;
+    int flags = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO;
     int handle = inotify_add_watch(watchHandle_, pathName.CString(), (unsigned)flags);
 
     if (handle < 0)
@@ -241,6 +243,8 @@ void FileWatcher::ThreadFunction()
     unsigned char buffer[BUFFERSIZE];
     DWORD bytesFilled = 0;
 
+    Vector<String> fileNames;
+
     while (shouldRun_)
     {
         if (ReadDirectoryChangesW((HANDLE)dirHandle_,
@@ -267,8 +271,7 @@ void FileWatcher::ThreadFunction()
                     while (src < end)
                         fileName.AppendUTF8(String::DecodeUTF16(src));
 
-                    fileName = GetInternalPath(fileName);
-                    AddChange(fileName);
+                    fileNames.Push(GetInternalPath(fileName));
                 }
 
                 if (!record->NextEntryOffset)
@@ -276,10 +279,14 @@ void FileWatcher::ThreadFunction()
                 else
                     offset += record->NextEntryOffset;
             }
+
+            AddChanges(fileNames);
+            fileNames.Clear();
         }
     }
 #elif defined(__linux__)
     unsigned char buffer[BUFFERSIZE];
+    Vector<String> fileNames;
 
     while (shouldRun_)
     {
@@ -295,16 +302,16 @@ void FileWatcher::ThreadFunction()
 
             if (event->len > 0)
             {
-                if (event->mask & IN_MODIFY || event->mask & IN_MOVE)
-                {
-                    String fileName;
-                    fileName = dirHandle_[event->wd] + event->name;
-                    AddChange(fileName);
-                }
+                if (event->mask & IN_MODIFY || event->mask & IN_CLOSE_WRITE || event->mask & IN_MOVE)
+                    fileNames.Push(dirHandle_[event->wd] + event->name);
             }
 
             i += sizeof(inotify_event) + event->len;
         }
+
+        // Queue all changes from one read at once; a save typically produces several events for the same file
+        AddChanges(fileNames);
+        fileNames.Clear();
     }
 #elif defined(__APPLE__) && !defined(IOS) && !defined(TVOS)
     while (shouldRun_)
@@ -314,23 +321,45 @@ void FileWatcher::ThreadFunction()
         String changes = ReadFileWatcher(watcher_);
         if (!changes.Empty())
         {
-            Vector<String> fileNames = changes.Split(1);
-            for (unsigned i = 0; i < fileNames.Size(); ++i)
-                AddChange(fileNames[i]);
+            AddChanges(changes.Split(1));
         }
     }
 #endif
 #endif
 }
 
+void FileWatcher::SetMaxBatchDelay(float interval)
+{
+    maxBatchDelay_ = Max(interval, 0.0f);
+}
+
 void FileWatcher::AddChange(const String& fileName)
 {
     MutexLock lock(changesMutex_);
 
+    if (changes_.Empty())
+        batchTimer_.Reset();
+    lastChangeTimer_.Reset();
+
     // Reset the timer associated with the filename. Will be notified once timer exceeds the delay
     changes_[fileName].Reset();
 }
 
+void FileWatcher::AddChanges(const Vector<String>& fileNames)
+{
+    if (fileNames.Empty())
+        return;
+
+    MutexLock lock(changesMutex_);
+
+    if (changes_.Empty())
+        batchTimer_.Reset();
+    lastChangeTimer_.Reset();
+
+    for (unsigned i = 0; i < fileNames.Size(); ++i)
+        changes_[fileNames[i]].Reset();
+}
+
 bool FileWatcher::GetNextChange(String& dest)
 {
     MutexLock lock(changesMutex_);
@@ -355,4 +384,38 @@ bool FileWatcher::GetNextChange(String& dest)
     }
 }
 
+bool FileWatcher::GetNextChanges(Vector<String>& dest)
+{
+    MutexLock lock(changesMutex_);
+
+    if (changes_.Empty())
+        return false;
+
+    auto delayMsec = (unsigned)(delay_ * 1000.0f);
+    auto maxBatchDelayMsec = (unsigned)(maxBatchDelay_ * 1000.0f);
+
+    // Wait until the whole burst of changes has settled, so that eg. a content sync is handled as one batch. If files
+    // keep changing, release the ones that have settled once the batch has been held back for too long
+    bool quiet = lastChangeTimer_.GetMSec(false) >= delayMsec;
+    if (!quiet && batchTimer_.GetMSec(false) < maxBatchDelayMsec)
+        return false;
+
+    unsigned oldSize = dest.Size();
+    for (HashMap<String, Timer>::Iterator i = changes_.Begin(); i != changes_.End();)
+    {
+        if (quiet || i->second_.GetMSec(false) >= delayMsec)
+        {
+            dest.Push(i->first_);
+            i = changes_.Erase(i);
+        }
+        else
+            ++i;
+    }
+
+    if (!changes_.Empty())
+        batchTimer_.Reset();
+
+    return dest.Size() > oldSize;
+}
+
 }
@@ -53,10 +53,16 @@ public:
     void StopWatching();
     /// Set the delay in seconds before file changes are notified. This (hopefully) avoids notifying when a file save is still in progress. Default 1 second.
     void SetDelay(float interval);
+    /// Set the maximum time in seconds a batch of changes is held back while files keep changing. Default 5 seconds.
+    void SetMaxBatchDelay(float interval);
     /// Add a file change into the changes queue.
     void AddChange(const String& fileName);
+    /// Add several file changes into the changes queue at once.
+    void AddChanges(const Vector<String>& fileNames);
     /// Return a file change (true if was found, false if not).
     bool GetNextChange(String& dest);
+    /// Return a batch of file changes once no file has changed for the delay, or settled changes once the maximum batch delay is exceeded. Return true if any were returned.
+    bool GetNextChanges(Vector<String>& dest);
 
     /// Return the path being watched, or empty if not watching.
     const String& GetPath() const { return path_; }
@@ -64,6 +70,9 @@ public:
     /// Return the delay in seconds for notifying file changes.
     float GetDelay() const { return delay_; }
 
+    /// Return the maximum batch delay in seconds.
+    float GetMaxBatchDelay() const { return maxBatchDelay_; }
+
 private:
     /// Filesystem.
     SharedPtr<FileSystem> fileSystem_;
@@ -73,8 +82,14 @@ private:
     HashMap<String, Timer> changes_;
     /// Mutex for the change buffer.
     Mutex changesMutex_;
+    /// Time since the latest change was added.
+    Timer lastChangeTimer_;
+    /// Time since the oldest change in the current batch was added.
+    Timer batchTimer_;
     /// Delay in seconds for notifying changes.
     float delay_;
+    /// Maximum delay in seconds for holding back a batch.
+    float maxBatchDelay_;
     /// Watch subdirectories flag.
     bool watchSubDirs_;
 
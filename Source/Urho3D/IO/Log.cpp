@@ -30,6 +30,7 @@
 #include "../IO/File.h"
 #include "../IO/IOEvents.h"
 #include "../IO/Log.h"
+#include "../IO/LogWriter.h"
 
 #include <cstdio>
 
@@ -58,6 +59,45 @@ const char* logLevelPrefixes[] =
 static Log* logInstance = nullptr;
 static bool threadErrorDisplayed = false;
 
+static void AppendJSONString(String& dest, const String& str)
+{
+    dest += '"';
+    for (unsigned i = 0; i < str.Length(); ++i)
+    {
+        char c = str[i];
+        switch (c)
+        {
+        case '"':
+            dest += "\\\"";
+            break;
+
+        case '\\':
+            dest += "\\\\";
+            break;
+
+        case '\n':
+            dest += "\\n";
+            break;
+
+        case '\r':
+            dest += "\\r";
+            break;
+
+        case '\t':
+            dest += "\\t";
+            break;
+
+        default:
+            if ((unsigned char)c < 0x20)
+                dest.AppendWithFormat("\\u%04x", (unsigned)c);
+            else
+                dest += c;
+            break;
+        }
+    }
+    dest += '"';
+}
+
 Log::Log(Context* context) :
     Object(context),
 #ifdef _DEBUG
@@ -65,9 +105,16 @@ Log::Log(Context* context) :
 #else
     level_(LOG_INFO),
 #endif
+    format_(LOG_FORMAT_TEXT),
+    flushInterval_(100),
+    flushSize_(64 * 1024),
+    maxQueueSize_(4 * 1024 * 1024),
+    numDroppedReported_(0),
     timeStamp_(true),
     inWrite_(false),
-    quiet_(false)
+    quiet_(false),
+    async_(false),
+    dropOnOverflow_(false)
 {
     logInstance = this;
 
@@ -76,6 +123,7 @@ Log::Log(Context* context) :
 
 Log::~Log()
 {
+    StopWriter();
     logInstance = nullptr;
 }
 
@@ -94,7 +142,10 @@ void Log::Open(const String& fileName)
 
     logFile_ = new File(context_);
     if (logFile_->Open(fileName, FILE_WRITE))
+    {
         Write(LOG_INFO, "Opened log file " + fileName);
+        StartWriter();
+    }
     else
     {
         logFile_.Reset();
@@ -108,6 +159,7 @@ void Log::Close()
 #if !defined(__ANDROID__) && !defined(IOS) && !defined(TVOS)
     if (logFile_ && logFile_->IsOpen())
     {
+        StopWriter();
         logFile_->Close();
         logFile_.Reset();
     }
@@ -135,6 +187,56 @@ void Log::SetQuiet(bool quiet)
     quiet_ = quiet;
 }
 
+void Log::SetFormat(LogFormat format)
+{
+    format_ = format;
+}
+
+void Log::SetAsync(bool enable)
+{
+    if (enable == async_)
+        return;
+
+    async_ = enable;
+    if (enable)
+        StartWriter();
+    else
+        StopWriter();
+}
+
+void Log::SetFlushInterval(unsigned ms)
+{
+    flushInterval_ = ms;
+    if (writer_)
+        writer_->SetFlushInterval(ms);
+}
+
+void Log::SetFlushSize(unsigned size)
+{
+    flushSize_ = size;
+    if (writer_)
+        writer_->SetFlushSize(size);
+}
+
+void Log::SetMaxQueueSize(unsigned size)
+{
+    maxQueueSize_ = size;
+    if (writer_)
+        writer_->SetMaxQueueSize(size);
+}
+
+void Log::SetDropOnOverflow(bool enable)
+{
+    dropOnOverflow_ = enable;
+    if (writer_)
+        writer_->SetDropOnOverflow(enable);
+}
+
+unsigned Log::GetNumDroppedMessages() const
+{
+    return writer_ ? writer_->GetNumDropped() : numDroppedReported_;
+}
+
 void Log::Write(int level, const String& message)
 {
     // Special case for LOG_RAW level
@@ -188,10 +290,7 @@ void Log::Write(int level, const String& message)
 #endif
 
     if (logInstance->logFile_)
-    {
-        logInstance->logFile_->WriteLine(formattedMessage);
-        logInstance->logFile_->Flush();
-    }
+        logInstance->WriteFile(level, message, formattedMessage, level == LOG_ERROR);
 
     logInstance->inWrite_ = true;
 
@@ -247,10 +346,7 @@ void Log::WriteRaw(const String& message, bool error)
 #endif
 
     if (logInstance->logFile_)
-    {
-        logInstance->logFile_->Write(message.CString(), message.Length());
-        logInstance->logFile_->Flush();
-    }
+        logInstance->WriteFile(LOG_RAW, message, message, error);
 
     logInstance->inWrite_ = true;
 
@@ -277,6 +373,18 @@ void Log::HandleEndFrame(StringHash eventType, VariantMap& eventData)
         return;
     }
 
+    // Report messages dropped by the background writer since the last check
+    if (writer_)
+    {
+        unsigned numDropped = writer_->GetNumDropped();
+        if (numDropped > numDroppedReported_)
+        {
+            unsigned newDropped = numDropped - numDroppedReported_;
+            numDroppedReported_ = numDropped;
+            Write(LOG_WARNING, "Log queue full, dropped " + String(newDropped) + " messages");
+        }
+    }
+
     MutexLock lock(logMutex_);
 
     // Process messages accumulated from other threads (if any)
@@ -293,4 +401,68 @@ void Log::HandleEndFrame(StringHash eventType, VariantMap& eventData)
     }
 }
 
+void Log::WriteFile(int level, const String& message, const String& formattedMessage, bool error)
+{
+    String text;
+    if (format_ == LOG_FORMAT_JSONLINES)
+    {
+        text.Reserve(message.Length() + 64);
+        text += '{';
+        if (timeStamp_)
+        {
+            text += "\"time\":";
+            AppendJSONString(text, Time::GetTimeStamp());
+            text += ',';
+        }
+        text += "\"level\":\"";
+        text += level != LOG_RAW ? logLevelPrefixes[level] : "RAW";
+        text += "\",";
+        if (level == LOG_RAW && error)
+            text += "\"error\":true,";
+        text += "\"message\":";
+        AppendJSONString(text, message);
+        text += "}\r\n";
+    }
+    else if (level != LOG_RAW)
+        text = formattedMessage + "\r\n";
+    else
+        text = formattedMessage;
+
+    // Write errors out immediately also in asynchronous mode, so that they are not lost if the application crashes
+    if (writer_)
+        writer_->Queue(text, error);
+    else
+    {
+        logFile_->Write(text.CString(), text.Length());
+        logFile_->Flush();
+    }
+}
+
+void Log::StartWriter()
+{
+    if (!async_ || writer_ || !logFile_ || !logFile_->IsOpen())
+        return;
+
+    writer_ = new LogWriter(logFile_);
+    writer_->SetFlushInterval(flushInterval_);
+    writer_->SetFlushSize(flushSize_);
+    writer_->SetMaxQueueSize(maxQueueSize_);
+    writer_->SetDropOnOverflow(dropOnOverflow_);
+    numDroppedReported_ = 0;
+
+    // If threads are not available, keep writing synchronously
+    if (!writer_->Run())
+        writer_.Reset();
+}
+
+void Log::StopWriter()
+{
+    if (writer_)
+    {
+        numDroppedReported_ = writer_->GetNumDropped();
+        // Destroying the writer stops the thread after writing out the queue
+        writer_.Reset();
+    }
+}
+
 }
@@ -45,7 +45,17 @@ static const int LOG_ERROR = 4;
 /// Disable all log messages.
 static const int LOG_NONE = 5;
 
+/// Log file output format.
+enum LogFormat
+{
+    /// Plain text lines, the same as printed to the console.
+    LOG_FORMAT_TEXT = 0,
+    /// One JSON object per line with time, level and message fields.
+    LOG_FORMAT_JSONLINES
+};
+
 class File;
+class LogWriter;
 
 /// Stored log message from another thread.
 struct StoredLogMessage
@@ -90,6 +100,18 @@ public:
     void SetTimeStamp(bool enable);
     /// Set quiet mode ie. only print error entries to standard error stream (which is normally redirected to console also). Output to log file is not affected by this mode.
     void SetQuiet(bool quiet);
+    /// Set log file output format.
+    void SetFormat(LogFormat format);
+    /// Set whether to write the log file asynchronously on a background thread. The messages are then written in batches and the file is flushed at most once per flush interval, unless the flush size is exceeded. Errors are still written and flushed immediately together with the messages queued before them.
+    void SetAsync(bool enable);
+    /// Set maximum time in milliseconds to keep messages queued in asynchronous mode. Default 100.
+    void SetFlushInterval(unsigned ms);
+    /// Set amount of queued messages in bytes that causes a write regardless of the flush interval in asynchronous mode. Default 64 KB.
+    void SetFlushSize(unsigned size);
+    /// Set maximum amount of queued messages in bytes in asynchronous mode. Default 4 MB.
+    void SetMaxQueueSize(unsigned size);
+    /// Set whether to drop messages when the queue is full in asynchronous mode, instead of writing the queued messages in the calling thread. Errors are never dropped. Default false.
+    void SetDropOnOverflow(bool enable);
 
     /// Return logging level.
     int GetLevel() const { return level_; }
@@ -103,6 +125,27 @@ public:
     /// Return whether log is in quiet mode (only errors printed to standard error stream).
     bool IsQuiet() const { return quiet_; }
 
+    /// Return log file output format.
+    LogFormat GetFormat() const { return format_; }
+
+    /// Return whether the log file is written asynchronously.
+    bool IsAsync() const { return async_; }
+
+    /// Return asynchronous mode flush interval in milliseconds.
+    unsigned GetFlushInterval() const { return flushInterval_; }
+
+    /// Return asynchronous mode flush size in bytes.
+    unsigned GetFlushSize() const { return flushSize_; }
+
+    /// Return asynchronous mode maximum queue size in bytes.
+    unsigned GetMaxQueueSize() const { return maxQueueSize_; }
+
+    /// Return whether messages are dropped when the queue is full in asynchronous mode.
+    bool GetDropOnOverflow() const { return dropOnOverflow_; }
+
+    /// Return number of messages dropped in asynchronous mode since the log file was opened.
+    unsigned GetNumDroppedMessages() const;
+
     /// Write to the log. If logging level is higher than the level of the message, the message is ignored.
     static void Write(int level, const String& message);
     /// Write raw output to the log.
@@ -111,6 +154,12 @@ public:
 private:
     /// Handle end of frame. Process the threaded log messages.
     void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Write a message to the log file in the current format, either directly or through the background writer.
+    void WriteFile(int level, const String& message, const String& formattedMessage, bool error);
+    /// Start the background writer if asynchronous mode is enabled and the log file is open.
+    void StartWriter();
+    /// Stop the background writer, writing out the queued messages.
+    void StopWriter();
 
     /// Mutex for threaded operation.
     Mutex logMutex_;
@@ -118,16 +167,32 @@ private:
     List<StoredLogMessage> threadMessages_;
     /// Log file.
     SharedPtr<File> logFile_;
+    /// Background writer of the log file in asynchronous mode.
+    SharedPtr<LogWriter> writer_;
     /// Last log message.
     String lastMessage_;
     /// Logging level.
     int level_;
+    /// Log file output format.
+    LogFormat format_;
+    /// Asynchronous mode flush interval.
+    unsigned flushInterval_;
+    /// Asynchronous mode flush size.
+    unsigned flushSize_;
+    /// Asynchronous mode maximum queue size.
+    unsigned maxQueueSize_;
+    /// Number of dropped messages already reported in the log.
+    unsigned numDroppedReported_;
     /// Timestamp log messages flag.
     bool timeStamp_;
     /// In write flag to prevent recursion.
     bool inWrite_;
     /// Quiet mode flag.
     bool quiet_;
+    /// Asynchronous mode flag.
+    bool async_;
+    /// Drop messages on queue overflow flag.
+    bool dropOnOverflow_;
 };
 
 #ifdef URHO3D_LOGGING
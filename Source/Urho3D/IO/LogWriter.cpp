@@ -0,0 +1,153 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Timer.h"
+#include "../IO/File.h"
+#include "../IO/LogWriter.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+LogWriter::LogWriter(File* file) :
+    file_(file),
+    flushInterval_(100),
+    flushSize_(64 * 1024),
+    maxQueueSize_(4 * 1024 * 1024),
+    numDropped_(0),
+    dropOnOverflow_(false)
+{
+}
+
+LogWriter::~LogWriter()
+{
+    // Wake up the thread so that it notices it should stop
+    shouldRun_ = false;
+    queueCondition_.Set();
+    Stop();
+}
+
+void LogWriter::ThreadFunction()
+{
+    Timer flushTimer;
+
+    while (shouldRun_)
+    {
+        bool empty;
+        bool full;
+        {
+            MutexLock lock(queueMutex_);
+            empty = queue_.Empty();
+            full = queue_.Length() >= flushSize_;
+        }
+
+        // Sleep until text is queued, then until the flush interval has elapsed or the flush size is exceeded
+        if (empty)
+        {
+            queueCondition_.Wait();
+            flushTimer.Reset();
+            continue;
+        }
+
+        unsigned elapsed = flushTimer.GetMSec(false);
+        if (!full && elapsed < flushInterval_)
+        {
+            queueCondition_.Wait(flushInterval_ - elapsed);
+            continue;
+        }
+
+        WriteQueued();
+    }
+
+    // Write out what was queued before stopping
+    WriteQueued();
+}
+
+bool LogWriter::Queue(const String& text, bool flush)
+{
+    bool wakeWriter;
+
+    for (;;)
+    {
+        {
+            MutexLock lock(queueMutex_);
+            if (flush || queue_.Empty() || queue_.Length() + text.Length() <= maxQueueSize_)
+            {
+                // Wake up the writer when it should start measuring the flush interval, or when the flush size is reached
+                wakeWriter = queue_.Empty() || (queue_.Length() < flushSize_ && queue_.Length() + text.Length() >= flushSize_);
+                queue_ += text;
+                break;
+            }
+
+            if (dropOnOverflow_)
+            {
+                ++numDropped_;
+                return false;
+            }
+        }
+
+        // The queue is full: write it out in the calling thread instead of waiting for the writer thread
+        WriteQueued();
+    }
+
+    if (flush)
+        WriteQueued();
+    else if (wakeWriter)
+        queueCondition_.Set();
+
+    return true;
+}
+
+unsigned LogWriter::GetQueueSize() const
+{
+    MutexLock lock(queueMutex_);
+    return queue_.Length();
+}
+
+unsigned LogWriter::GetNumDropped() const
+{
+    MutexLock lock(queueMutex_);
+    return numDropped_;
+}
+
+void LogWriter::WriteQueued()
+{
+    MutexLock writeLock(writeMutex_);
+
+    {
+        MutexLock lock(queueMutex_);
+        if (queue_.Empty())
+            return;
+        writeBuffer_.Swap(queue_);
+    }
+
+    // Write the whole batch at once and flush only once per batch
+    file_->Write(writeBuffer_.CString(), writeBuffer_.Length());
+    file_->Flush();
+    writeBuffer_.Clear();
+}
+
+}
@@ -0,0 +1,94 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Container/Ptr.h"
+#include "../Container/RefCounted.h"
+#include "../Core/Condition.h"
+#include "../Core/Mutex.h"
+#include "../Core/Thread.h"
+
+namespace Urho3D
+{
+
+class File;
+
+/// Background writer of the log file in asynchronous mode. Owned by the Log subsystem.
+class LogWriter : public RefCounted, public Thread
+{
+public:
+    /// Construct.
+    explicit LogWriter(File* file);
+    /// Destruct. Stop the thread, which writes out the remaining queued text.
+    ~LogWriter() override;
+
+    /// Log file writing loop.
+    void ThreadFunction() override;
+
+    /// Queue text to be written. If the queue is full, either write out the queued text in the calling thread or drop the text depending on the overflow policy. With the flush flag, write out the queue including the text in the calling thread before returning; such text is never dropped. Return true if queued. Is thread-safe.
+    bool Queue(const String& text, bool flush = false);
+
+    /// Set maximum time in milliseconds to keep text queued before writing and flushing.
+    void SetFlushInterval(unsigned ms) { flushInterval_ = ms; }
+    /// Set amount of queued text in bytes that causes a write regardless of the flush interval.
+    void SetFlushSize(unsigned size) { flushSize_ = size; }
+    /// Set maximum amount of queued text in bytes.
+    void SetMaxQueueSize(unsigned size) { maxQueueSize_ = size; }
+    /// Set whether to drop text when the queue is full instead of waiting for the writer thread.
+    void SetDropOnOverflow(bool enable) { dropOnOverflow_ = enable; }
+
+    /// Return amount of text currently queued in bytes.
+    unsigned GetQueueSize() const;
+    /// Return number of texts dropped because of a full queue.
+    unsigned GetNumDropped() const;
+
+private:
+    /// Swap out the queued text and write it to the file. Can be called from any thread.
+    void WriteQueued();
+
+    /// Log file.
+    SharedPtr<File> file_;
+    /// Mutex for the queue.
+    mutable Mutex queueMutex_;
+    /// Mutex held while writing to the file, so that batches written from different threads stay in order.
+    Mutex writeMutex_;
+    /// Condition set when the writer thread should wake up to write or to stop.
+    Condition queueCondition_;
+    /// Text waiting to be written.
+    String queue_;
+    /// Text being written. Only accessed with the write mutex held, and kept between the writes to reuse its buffer.
+    String writeBuffer_;
+    /// Flush interval in milliseconds.
+    volatile unsigned flushInterval_;
+    /// Flush size in bytes.
+    volatile unsigned flushSize_;
+    /// Maximum queue size in bytes.
+    unsigned maxQueueSize_;
+    /// Number of dropped texts.
+    unsigned numDropped_;
+    /// Drop on overflow flag.
+    bool dropOnOverflow_;
+};
+
+}
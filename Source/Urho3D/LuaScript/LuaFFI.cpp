@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../LuaScript/LuaFFI.h"
+#include "../Scene/Component.h"
+#include "../Scene/Node.h"
+
+extern "C"
+{
+#include <lua.h>
+}
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+#ifdef URHO3D_LUAJIT
+
+// The functions take the objects as raw pointers and the math types as plain structs with the same memory layout,
+// so that calls from LuaJIT compiled traces neither allocate userdata nor go through the Lua C API
+
+static void NodeGetPosition(const Node* node, Vector3* out) { *out = node->GetPosition(); }
+static void NodeSetPosition(Node* node, const Vector3* position) { node->SetPosition(*position); }
+static void NodeGetRotation(const Node* node, Quaternion* out) { *out = node->GetRotation(); }
+static void NodeSetRotation(Node* node, const Quaternion* rotation) { node->SetRotation(*rotation); }
+static void NodeGetScale(const Node* node, Vector3* out) { *out = node->GetScale(); }
+static void NodeSetScale(Node* node, const Vector3* scale) { node->SetScale(*scale); }
+static void NodeGetWorldPosition(const Node* node, Vector3* out) { *out = node->GetWorldPosition(); }
+static void NodeSetWorldPosition(Node* node, const Vector3* position) { node->SetWorldPosition(*position); }
+static void NodeGetWorldRotation(const Node* node, Quaternion* out) { *out = node->GetWorldRotation(); }
+static void NodeSetWorldRotation(Node* node, const Quaternion* rotation) { node->SetWorldRotation(*rotation); }
+static void NodeGetDirection(const Node* node, Vector3* out) { *out = node->GetDirection(); }
+static void NodeGetWorldDirection(const Node* node, Vector3* out) { *out = node->GetWorldDirection(); }
+static void NodeTranslate(Node* node, const Vector3* delta, int space) { node->Translate(*delta, (TransformSpace)space); }
+static void NodeRotate(Node* node, const Quaternion* delta, int space) { node->Rotate(*delta, (TransformSpace)space); }
+static Node* ComponentGetNode(const Component* component) { return component->GetNode(); }
+
+struct FFIFunction
+{
+    const char* name_;
+    void* function_;
+};
+
+#define URHO3D_FFI_FUNCTION(name) { #name, reinterpret_cast<void*>(&(name)) }
+
+static const FFIFunction ffiFunctions[] =
+{
+    URHO3D_FFI_FUNCTION(NodeGetPosition),
+    URHO3D_FFI_FUNCTION(NodeSetPosition),
+    URHO3D_FFI_FUNCTION(NodeGetRotation),
+    URHO3D_FFI_FUNCTION(NodeSetRotation),
+    URHO3D_FFI_FUNCTION(NodeGetScale),
+    URHO3D_FFI_FUNCTION(NodeSetScale),
+    URHO3D_FFI_FUNCTION(NodeGetWorldPosition),
+    URHO3D_FFI_FUNCTION(NodeSetWorldPosition),
+    URHO3D_FFI_FUNCTION(NodeGetWorldRotation),
+    URHO3D_FFI_FUNCTION(NodeSetWorldRotation),
+    URHO3D_FFI_FUNCTION(NodeGetDirection),
+    URHO3D_FFI_FUNCTION(NodeGetWorldDirection),
+    URHO3D_FFI_FUNCTION(NodeTranslate),
+    URHO3D_FFI_FUNCTION(NodeRotate),
+    URHO3D_FFI_FUNCTION(ComponentGetNode),
+};
+
+#undef URHO3D_FFI_FUNCTION
+
+void RegisterLuaFFIFunctions(lua_State* L)
+{
+    // The function pointers are passed as light userdata, and cast to the declared function types on the Lua side.
+    // This avoids relying on the symbols being exported from the executable
+    lua_newtable(L);
+    lua_newtable(L);
+    for (const FFIFunction& function : ffiFunctions)
+    {
+        lua_pushlightuserdata(L, function.function_);
+        lua_setfield(L, -2, function.name_);
+    }
+    lua_setfield(L, -2, "functions_");
+    lua_setglobal(L, "UrhoFFI");
+}
+
+#else
+
+void RegisterLuaFFIFunctions(lua_State* L)
+{
+}
+
+#endif
+
+}
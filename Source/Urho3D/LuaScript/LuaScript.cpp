@@ -29,6 +29,7 @@
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
+#include "../LuaScript/LuaFFI.h"
 #include "../LuaScript/LuaFile.h"
 #include "../LuaScript/LuaFunction.h"
 #include "../LuaScript/LuaScript.h"
@@ -99,6 +100,8 @@ LuaScript::LuaScript(Context* context) :
     luaL_openlibs(luaState_);
     RegisterLoader();
     ReplacePrint();
+    // Must be registered before the Lua side of the FFI bindings is run by the LuaScript API package
+    RegisterLuaFFIFunctions(luaState_);
 
     tolua_MathLuaAPI_open(luaState_);
     tolua_CoreLuaAPI_open(luaState_);
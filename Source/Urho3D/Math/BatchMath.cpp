@@ -0,0 +1,273 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Math/BatchMath.h"
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+#ifdef URHO3D_SSE
+/// Load a Vector3 into the low three lanes without reading past its end.
+static inline __m128 LoadVector3(const float* src)
+{
+    return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)src), _mm_load_ss(src + 2));
+}
+
+/// Store the low three lanes as a Vector3 without writing past its end.
+static inline void StoreVector3(float* dest, __m128 vec)
+{
+    _mm_storel_pi((__m64*)dest, vec);
+    _mm_store_ss(dest + 2, _mm_movehl_ps(vec, vec));
+}
+
+/// Multiply broadcast point components with matrix columns and sum.
+static inline __m128 MultiplyColumns(const float* src, __m128 c0, __m128 c1, __m128 c2)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_load1_ps(src)), _mm_mul_ps(c1, _mm_load1_ps(src + 1))),
+        _mm_mul_ps(c2, _mm_load1_ps(src + 2)));
+}
+#endif
+
+void TransformPoints(const Matrix3x4& transform, const void* source, unsigned sourceStride, void* dest, unsigned destStride, unsigned count)
+{
+    const auto* src = (const unsigned char*)source;
+    auto* dst = (unsigned char*)dest;
+
+#ifdef URHO3D_SSE
+    __m128 c0 = _mm_set_ps(0.f, transform.m20_, transform.m10_, transform.m00_);
+    __m128 c1 = _mm_set_ps(0.f, transform.m21_, transform.m11_, transform.m01_);
+    __m128 c2 = _mm_set_ps(0.f, transform.m22_, transform.m12_, transform.m02_);
+    __m128 c3 = _mm_set_ps(0.f, transform.m23_, transform.m13_, transform.m03_);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        StoreVector3((float*)dst, _mm_add_ps(MultiplyColumns((const float*)src, c0, c1, c2), c3));
+        src += sourceStride;
+        dst += destStride;
+    }
+#else
+    for (unsigned i = 0; i < count; ++i)
+    {
+        *((Vector3*)dst) = transform * *((const Vector3*)src);
+        src += sourceStride;
+        dst += destStride;
+    }
+#endif
+}
+
+void TransformDirections(const Matrix3x4& transform, const void* source, unsigned sourceStride, void* dest, unsigned destStride, unsigned count)
+{
+    const auto* src = (const unsigned char*)source;
+    auto* dst = (unsigned char*)dest;
+
+#ifdef URHO3D_SSE
+    __m128 c0 = _mm_set_ps(0.f, transform.m20_, transform.m10_, transform.m00_);
+    __m128 c1 = _mm_set_ps(0.f, transform.m21_, transform.m11_, transform.m01_);
+    __m128 c2 = _mm_set_ps(0.f, transform.m22_, transform.m12_, transform.m02_);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        StoreVector3((float*)dst, MultiplyColumns((const float*)src, c0, c1, c2));
+        src += sourceStride;
+        dst += destStride;
+    }
+#else
+    Matrix3 rotationScale = transform.ToMatrix3();
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        *((Vector3*)dst) = rotationScale * *((const Vector3*)src);
+        src += sourceStride;
+        dst += destStride;
+    }
+#endif
+}
+
+void TransformNormals(const Matrix3& normalMatrix, const void* source, unsigned sourceStride, void* dest, unsigned destStride, unsigned count)
+{
+    const auto* src = (const unsigned char*)source;
+    auto* dst = (unsigned char*)dest;
+
+#ifdef URHO3D_SSE
+    __m128 c0 = _mm_set_ps(0.f, normalMatrix.m20_, normalMatrix.m10_, normalMatrix.m00_);
+    __m128 c1 = _mm_set_ps(0.f, normalMatrix.m21_, normalMatrix.m11_, normalMatrix.m01_);
+    __m128 c2 = _mm_set_ps(0.f, normalMatrix.m22_, normalMatrix.m12_, normalMatrix.m02_);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        __m128 vec = MultiplyColumns((const float*)src, c0, c1, c2);
+        __m128 sq = _mm_mul_ps(vec, vec);
+        __m128 lenSquared = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1)));
+        lenSquared = _mm_add_ps(lenSquared, _mm_movehl_ps(sq, sq));
+        lenSquared = _mm_shuffle_ps(lenSquared, lenSquared, _MM_SHUFFLE(0, 0, 0, 0));
+        // Divide only where the length is nonzero, zero vectors pass through unchanged
+        __m128 nonZero = _mm_cmpgt_ps(lenSquared, zero);
+        __m128 normalized = _mm_div_ps(vec, _mm_sqrt_ps(lenSquared));
+        StoreVector3((float*)dst, _mm_or_ps(_mm_and_ps(nonZero, normalized), _mm_andnot_ps(nonZero, vec)));
+        src += sourceStride;
+        dst += destStride;
+    }
+#else
+    for (unsigned i = 0; i < count; ++i)
+    {
+        Vector3 vec = normalMatrix * *((const Vector3*)src);
+        float lenSquared = vec.LengthSquared();
+        if (lenSquared > 0.0f)
+            vec *= 1.0f / sqrtf(lenSquared);
+        *((Vector3*)dst) = vec;
+        src += sourceStride;
+        dst += destStride;
+    }
+#endif
+}
+
+void ProjectPoints(const Matrix4& projection, const void* source, unsigned sourceStride, Vector4* dest, unsigned count)
+{
+    const auto* src = (const unsigned char*)source;
+
+#ifdef URHO3D_SSE
+    __m128 c0 = _mm_set_ps(projection.m30_, projection.m20_, projection.m10_, projection.m00_);
+    __m128 c1 = _mm_set_ps(projection.m31_, projection.m21_, projection.m11_, projection.m01_);
+    __m128 c2 = _mm_set_ps(projection.m32_, projection.m22_, projection.m12_, projection.m02_);
+    __m128 c3 = _mm_set_ps(projection.m33_, projection.m23_, projection.m13_, projection.m03_);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        _mm_storeu_ps(&dest[i].x_, _mm_add_ps(MultiplyColumns((const float*)src, c0, c1, c2), c3));
+        src += sourceStride;
+    }
+#else
+    for (unsigned i = 0; i < count; ++i)
+    {
+        dest[i] = projection * Vector4(*((const Vector3*)src), 1.0f);
+        src += sourceStride;
+    }
+#endif
+}
+
+void MergePoints(BoundingBox& box, const void* source, unsigned sourceStride, unsigned count)
+{
+    const auto* src = (const unsigned char*)source;
+
+#ifdef URHO3D_SSE
+    __m128 minPt = _mm_loadu_ps(&box.min_.x_);
+    __m128 maxPt = _mm_loadu_ps(&box.max_.x_);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        __m128 vec = LoadVector3((const float*)src);
+        minPt = _mm_min_ps(minPt, vec);
+        maxPt = _mm_max_ps(maxPt, vec);
+        src += sourceStride;
+    }
+
+    StoreVector3(&box.min_.x_, minPt);
+    StoreVector3(&box.max_.x_, maxPt);
+#else
+    for (unsigned i = 0; i < count; ++i)
+    {
+        box.Merge(*((const Vector3*)src));
+        src += sourceStride;
+    }
+#endif
+}
+
+void TransformBoundingBoxes(const Matrix3x4& transform, const BoundingBox* source, BoundingBox* dest, unsigned count)
+{
+#ifdef URHO3D_SSE
+    __m128 c0 = _mm_set_ps(0.f, transform.m20_, transform.m10_, transform.m00_);
+    __m128 c1 = _mm_set_ps(0.f, transform.m21_, transform.m11_, transform.m01_);
+    __m128 c2 = _mm_set_ps(0.f, transform.m22_, transform.m12_, transform.m02_);
+    __m128 c3 = _mm_set_ps(0.f, transform.m23_, transform.m13_, transform.m03_);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 a0 = _mm_and_ps(absMask, c0);
+    __m128 a1 = _mm_and_ps(absMask, c1);
+    __m128 a2 = _mm_and_ps(absMask, c2);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        // The min and max vectors are padded, so reading four floats is safe
+        __m128 minPt = _mm_loadu_ps(&source[i].min_.x_);
+        __m128 maxPt = _mm_loadu_ps(&source[i].max_.x_);
+        __m128 center = _mm_mul_ps(_mm_add_ps(minPt, maxPt), half);
+        __m128 edge = _mm_sub_ps(center, minPt);
+        __m128 newCenter = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(c0, _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0))),
+            _mm_mul_ps(c1, _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1)))),
+            _mm_mul_ps(c2, _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2)))), c3);
+        __m128 newEdge = _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(a0, _mm_shuffle_ps(edge, edge, _MM_SHUFFLE(0, 0, 0, 0))),
+            _mm_mul_ps(a1, _mm_shuffle_ps(edge, edge, _MM_SHUFFLE(1, 1, 1, 1)))),
+            _mm_mul_ps(a2, _mm_shuffle_ps(edge, edge, _MM_SHUFFLE(2, 2, 2, 2))));
+        dest[i] = BoundingBox(_mm_sub_ps(newCenter, newEdge), _mm_add_ps(newCenter, newEdge));
+    }
+#else
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = source[i].Transformed(transform);
+#endif
+}
+
+void CalculatePlaneDistances(const Plane& plane, const void* source, unsigned sourceStride, float* dest, unsigned count)
+{
+    const auto* src = (const unsigned char*)source;
+    unsigned i = 0;
+
+#ifdef URHO3D_SSE
+    // Process four points at a time in structure-of-arrays form
+    __m128 nx = _mm_set1_ps(plane.normal_.x_);
+    __m128 ny = _mm_set1_ps(plane.normal_.y_);
+    __m128 nz = _mm_set1_ps(plane.normal_.z_);
+    __m128 d = _mm_set1_ps(plane.d_);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto* p0 = (const float*)src;
+        const auto* p1 = (const float*)(src + sourceStride);
+        const auto* p2 = (const float*)(src + 2 * sourceStride);
+        const auto* p3 = (const float*)(src + 3 * sourceStride);
+        __m128 x = _mm_set_ps(p3[0], p2[0], p1[0], p0[0]);
+        __m128 y = _mm_set_ps(p3[1], p2[1], p1[1], p0[1]);
+        __m128 z = _mm_set_ps(p3[2], p2[2], p1[2], p0[2]);
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, x), _mm_mul_ps(ny, y)), _mm_mul_ps(nz, z)), d));
+        src += 4 * sourceStride;
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        dest[i] = plane.Distance(*((const Vector3*)src));
+        src += sourceStride;
+    }
+}
+
+}
@@ -0,0 +1,51 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Math/BoundingBox.h"
+#include "../Math/Matrix3.h"
+#include "../Math/Matrix3x4.h"
+#include "../Math/Matrix4.h"
+#include "../Math/Plane.h"
+#include "../Math/Vector4.h"
+
+namespace Urho3D
+{
+
+/// Transform an array of points (Vector3) by a 3x4 matrix. Strides are in bytes, source and destination may be the same array.
+URHO3D_API void TransformPoints(const Matrix3x4& transform, const void* source, unsigned sourceStride, void* dest, unsigned destStride, unsigned count);
+/// Transform an array of directions (Vector3) by the rotation and scale of a 3x4 matrix. Strides are in bytes, source and destination may be the same array.
+URHO3D_API void TransformDirections(const Matrix3x4& transform, const void* source, unsigned sourceStride, void* dest, unsigned destStride, unsigned count);
+/// Transform an array of normals (Vector3) by a normal matrix and renormalize them. Zero vectors are left as zero. Strides are in bytes, source and destination may be the same array.
+URHO3D_API void TransformNormals(const Matrix3& normalMatrix, const void* source, unsigned sourceStride, void* dest, unsigned destStride, unsigned count);
+/// Transform an array of points (Vector3) by a 4x4 matrix into homogeneous coordinates without the perspective divide.
+URHO3D_API void ProjectPoints(const Matrix4& projection, const void* source, unsigned sourceStride, Vector4* dest, unsigned count);
+/// Merge an array of points (Vector3) into a bounding box.
+URHO3D_API void MergePoints(BoundingBox& box, const void* source, unsigned sourceStride, unsigned count);
+/// Transform an array of bounding boxes by a 3x4 matrix. Equivalent to calling BoundingBox::Transformed() for each. Source and destination may be the same array.
+URHO3D_API void TransformBoundingBoxes(const Matrix3x4& transform, const BoundingBox* source, BoundingBox* dest, unsigned count);
+/// Calculate signed distances of an array of points (Vector3) to a plane.
+URHO3D_API void CalculatePlaneDistances(const Plane& plane, const void* source, unsigned sourceStride, float* dest, unsigned count);
+
+}
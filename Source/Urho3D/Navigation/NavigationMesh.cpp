@@ -33,6 +33,7 @@
 #include "../Graphics/VertexBuffer.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
+#include "../Math/BatchMath.h"
 #include "../Navigation/CrowdAgent.h"
 #include "../Navigation/DynamicNavigationMesh.h"
 #include "../Navigation/NavArea.h"
@@ -1144,8 +1145,9 @@ void NavigationMesh::GetTileGeometry(NavBuildData* build, Vector<NavigationGeome
                         unsigned numIndices = data->indexCount_;
                         unsigned destVertexStart = build->vertices_.Size();
 
-                        for (unsigned j = 0; j < numVertices; ++j)
-                            build->vertices_.Push(transform * data->vertexData_[j]);
+                        build->vertices_.Resize(destVertexStart + numVertices);
+                        TransformPoints(transform, data->vertexData_.Get(), sizeof(Vector3), &build->vertices_[destVertexStart],
+                            sizeof(Vector3), numVertices);
 
                         for (unsigned j = 0; j < numIndices; ++j)
                             build->indices_.Push(data->indexData_[j] + destVertexStart);
@@ -1219,11 +1221,9 @@ void NavigationMesh::AddTriMeshGeometry(NavBuildData* build, Geometry* geometry,
 
     unsigned destVertexStart = build->vertices_.Size();
 
-    for (unsigned k = srcVertexStart; k < srcVertexStart + srcVertexCount; ++k)
-    {
-        Vector3 vertex = transform * *((const Vector3*)(&vertexData[k * vertexSize]));
-        build->vertices_.Push(vertex);
-    }
+    build->vertices_.Resize(destVertexStart + srcVertexCount);
+    TransformPoints(transform, &vertexData[srcVertexStart * vertexSize], vertexSize, &build->vertices_[destVertexStart],
+        sizeof(Vector3), srcVertexCount);
 
     // Copy remapped indices
     if (indexSize == sizeof(unsigned short))
@@ -54,6 +54,14 @@ namespace Urho3D
 {
 
 static const int STATS_INTERVAL_MSEC = 2000;
+static const unsigned MAX_UNACKNOWLEDGED_CONTROLS = 64;
+static const Controls noControls;
+
+/// Return the smoothing clock of a server scene in the milliseconds sent with scene updates. Wraps around after about 49 days.
+static unsigned GetServerTimeMs(Scene* scene)
+{
+    return (unsigned)(unsigned long long)(scene->GetSmoothingTime() * 1000.0 + 0.5);
+}
 
 PackageDownload::PackageDownload() :
     totalFragments_(0),
@@ -73,6 +81,8 @@ Connection::Connection(Context* context, bool isClient, const SLNet::AddressOrGU
     timeStamp_(0),
     peer_(peer),
     sendMode_(OPSM_NONE),
+    acknowledgedTimeStamp_(0),
+    controlsAcknowledged_(false),
     isClient_(isClient),
     connectPending_(false),
     sceneLoaded_(false),
@@ -164,6 +174,8 @@ void Connection::SetScene(Scene* newScene)
 
     scene_ = newScene;
     sceneLoaded_ = false;
+    unacknowledgedControls_.Clear();
+    controlsAcknowledged_ = false;
     UnsubscribeFromEvent(E_ASYNCLOADFINISHED);
 
     if (!scene_)
@@ -274,6 +286,11 @@ void Connection::SendClientUpdate()
         msg_.WritePackedQuaternion(rotation_);
     SendMessage(MSG_CONTROLS, false, false, msg_, CONTROLS_CONTENT_ID);
 
+    // Keep the sent controls until the server acknowledges them, so that client-side prediction can replay them
+    if (unacknowledgedControls_.Size() >= MAX_UNACKNOWLEDGED_CONTROLS)
+        unacknowledgedControls_.Erase(0);
+    unacknowledgedControls_.Push(controls_);
+
     ++timeStamp_;
 }
 
@@ -368,6 +385,7 @@ void Connection::ProcessPendingLatestData()
         {
             MemoryBuffer msg(current->second_);
             msg.ReadNetID(); // Skip the node ID
+            msg.ReadUInt(); // Skip the server time
             node->ReadLatestDataUpdate(msg);
             // ApplyAttributes() is deliberately skipped, as Node has no attributes that require late applying.
             // Furthermore it would propagate to components and child nodes, which is not desired in this case
@@ -384,6 +402,7 @@ void Connection::ProcessPendingLatestData()
         {
             MemoryBuffer msg(current->second_);
             msg.ReadNetID(); // Skip the component ID
+            msg.ReadUInt(); // Skip the server time
             if (component->ReadLatestDataUpdate(msg))
                 component->ApplyAttributes();
             componentLatestData_.Erase(current);
@@ -391,6 +410,21 @@ void Connection::ProcessPendingLatestData()
     }
 }
 
+void Connection::ProcessAcknowledgedControls()
+{
+    if (!controlsAcknowledged_)
+        return;
+
+    controlsAcknowledged_ = false;
+
+    using namespace ControlsAcknowledged;
+
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_CONNECTION] = this;
+    eventData[P_TIMESTAMP] = (unsigned)acknowledgedTimeStamp_;
+    SendEvent(E_CONTROLSACKNOWLEDGED, eventData);
+}
+
 bool Connection::ProcessMessage(int msgID, MemoryBuffer& msg)
 {
     // New incomming message, reset last heard timer
@@ -521,6 +555,33 @@ void Connection::ProcessSceneChecksumError(int msgID, MemoryBuffer& msg)
     OnSceneLoadFailed();
 }
 
+void Connection::ReadServerTime(MemoryBuffer& msg)
+{
+    // Snapshots received during this update are stamped with the server time, so that interpolation does not replay the
+    // jitter of their arrival
+    scene_->SetServerTime(msg.ReadUInt() / 1000.0);
+}
+
+void Connection::ReadAcknowledgedTimeStamp(MemoryBuffer& msg)
+{
+    // The server writes the latest controls timestamp it has received in front of each update's attribute data
+    if (msg.GetPosition() >= msg.GetSize())
+        return;
+    unsigned char timeStamp = msg.GetData()[msg.GetPosition()];
+
+    // Unacknowledged controls have consecutive timestamps ending at the current one. Older or repeated acknowledgements,
+    // for example from out-of-order latest data messages, fall outside the range and are ignored
+    unsigned numControls = unacknowledgedControls_.Size();
+    auto oldest = (unsigned char)(timeStamp_ - numControls);
+    unsigned numAcknowledged = (unsigned char)(timeStamp - oldest) + 1u;
+    if (numAcknowledged > numControls)
+        return;
+
+    unacknowledgedControls_.Erase(0, numAcknowledged);
+    acknowledgedTimeStamp_ = timeStamp;
+    controlsAcknowledged_ = true;
+}
+
 void Connection::ProcessSceneUpdate(int msgID, MemoryBuffer& msg)
 {
     /// \todo On mobile devices processing this message may potentially cause a crash if it attempts to load new GPU resources
@@ -599,6 +660,8 @@ void Connection::ProcessSceneUpdate(int msgID, MemoryBuffer& msg)
     case MSG_NODEDELTAUPDATE:
         {
             unsigned nodeID = msg.ReadNetID();
+            ReadServerTime(msg);
+            ReadAcknowledgedTimeStamp(msg);
             Node* node = scene_->GetNode(nodeID);
             if (node)
             {
@@ -621,6 +684,8 @@ void Connection::ProcessSceneUpdate(int msgID, MemoryBuffer& msg)
     case MSG_NODELATESTDATA:
         {
             unsigned nodeID = msg.ReadNetID();
+            ReadServerTime(msg);
+            ReadAcknowledgedTimeStamp(msg);
             Node* node = scene_->GetNode(nodeID);
             if (node)
             {
@@ -685,6 +750,8 @@ void Connection::ProcessSceneUpdate(int msgID, MemoryBuffer& msg)
     case MSG_COMPONENTDELTAUPDATE:
         {
             unsigned componentID = msg.ReadNetID();
+            ReadServerTime(msg);
+            ReadAcknowledgedTimeStamp(msg);
             Component* component = scene_->GetComponent(componentID);
             if (component)
             {
@@ -699,6 +766,8 @@ void Connection::ProcessSceneUpdate(int msgID, MemoryBuffer& msg)
     case MSG_COMPONENTLATESTDATA:
         {
             unsigned componentID = msg.ReadNetID();
+            ReadServerTime(msg);
+            ReadAcknowledgedTimeStamp(msg);
             Component* component = scene_->GetComponent(componentID);
             if (component)
             {
@@ -1064,6 +1133,11 @@ unsigned Connection::GetNumDownloads() const
     return downloads_.Size();
 }
 
+const Controls& Connection::GetUnacknowledgedControls(unsigned index) const
+{
+    return index < unacknowledgedControls_.Size() ? unacknowledgedControls_[index] : noControls;
+}
+
 const String& Connection::GetDownloadName() const
 {
     for (HashMap<StringHash, PackageDownload>::ConstIterator i = downloads_.Begin(); i != downloads_.End(); ++i)
@@ -1268,6 +1342,7 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
         {
             msg_.Clear();
             msg_.WriteNetID(node->GetID());
+            msg_.WriteUInt(GetServerTimeMs(scene_));
             node->WriteLatestDataUpdate(msg_, timeStamp_);
 
             SendMessage(MSG_NODELATESTDATA, true, false, msg_, node->GetID());
@@ -1278,6 +1353,7 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
         {
             msg_.Clear();
             msg_.WriteNetID(node->GetID());
+            msg_.WriteUInt(GetServerTimeMs(scene_));
             node->WriteDeltaUpdate(msg_, nodeState.dirtyAttributes_, timeStamp_);
 
             // Write changed variables
@@ -1346,6 +1422,7 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
                 {
                     msg_.Clear();
                     msg_.WriteNetID(component->GetID());
+                    msg_.WriteUInt(GetServerTimeMs(scene_));
                     component->WriteLatestDataUpdate(msg_, timeStamp_);
 
                     SendMessage(MSG_COMPONENTLATESTDATA, true, false, msg_, component->GetID());
@@ -1356,6 +1433,7 @@ void Connection::ProcessExistingNode(Node* node, NodeReplicationState& nodeState
                 {
                     msg_.Clear();
                     msg_.WriteNetID(component->GetID());
+                    msg_.WriteUInt(GetServerTimeMs(scene_));
                     component->WriteDeltaUpdate(msg_, componentState.dirtyAttributes_, timeStamp_);
 
                     SendMessage(MSG_COMPONENTDELTAUPDATE, true, true, msg_);
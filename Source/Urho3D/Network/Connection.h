@@ -151,6 +151,8 @@ public:
     void SendPackages();
     /// Process pending latest data for nodes and components.
     void ProcessPendingLatestData();
+    /// Send the controls acknowledged event if the server acknowledged new client controls while processing messages. Called by Network.
+    void ProcessAcknowledgedControls();
     /// Process a message from the server or client. Called by Network.
     bool ProcessMessage(int msgID, MemoryBuffer& msg);
     /// Ban this connections IP address.
@@ -172,6 +174,15 @@ public:
     /// Return the controls timestamp, sent from client to server along each control update.
     unsigned char GetTimeStamp() const { return timeStamp_; }
 
+    /// Return the latest controls timestamp acknowledged by the server. Only meaningful on the client.
+    unsigned char GetAcknowledgedTimeStamp() const { return acknowledgedTimeStamp_; }
+
+    /// Return number of sent controls not yet acknowledged by the server. Only meaningful on the client.
+    unsigned GetNumUnacknowledgedControls() const { return unacknowledgedControls_.Size(); }
+
+    /// Return sent controls not yet acknowledged by the server by index, oldest first. Only meaningful on the client.
+    const Controls& GetUnacknowledgedControls(unsigned index) const;
+
     /// Return the observer position sent by the client for interest management.
     const Vector3& GetPosition() const { return position_; }
 
@@ -257,6 +268,10 @@ private:
     void ProcessSceneLoaded(int msgID, MemoryBuffer& msg);
     /// Process a remote event message from the client or server. Called by Network.
     void ProcessRemoteEvent(int msgID, MemoryBuffer& msg);
+    /// Read the server time of a scene update message and pass it to the scene.
+    void ReadServerTime(MemoryBuffer& msg);
+    /// Record the controls timestamp echoed by the server in a scene update message. The read position is not changed.
+    void ReadAcknowledgedTimeStamp(MemoryBuffer& msg);
     /// Process a node for sending a network update. Recurses to process depended on node(s) first.
     void ProcessNode(unsigned nodeID);
     /// Process a node that the client has not yet received.
@@ -296,6 +311,8 @@ private:
     VectorBuffer msg_;
     /// Queued remote events.
     Vector<RemoteEvent> remoteEvents_;
+    /// Sent controls not yet acknowledged by the server, oldest first.
+    Vector<Controls> unacknowledgedControls_;
     /// Scene file to load once all packages (if any) have been downloaded.
     String sceneFileName_;
     /// Statistics timer.
@@ -308,6 +325,10 @@ private:
     Quaternion rotation_;
     /// Send mode for the observer position & rotation.
     ObserverPositionSendMode sendMode_;
+    /// Latest controls timestamp acknowledged by the server.
+    unsigned char acknowledgedTimeStamp_;
+    /// Controls acknowledged since the last acknowledged event flag.
+    bool controlsAcknowledged_;
     /// Client connection flag.
     bool isClient_;
     /// Connection pending flag.
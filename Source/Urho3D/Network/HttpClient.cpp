@@ -0,0 +1,464 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Thread.h"
+#include "../Core/Timer.h"
+#include "../IO/Log.h"
+#include "../Network/HttpClient.h"
+#include "../Network/HttpRequest.h"
+
+#include <Civetweb/civetweb.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static const unsigned ERROR_BUFFER_SIZE = 256;
+static const unsigned RECEIVE_BUFFER_SIZE = 16384;
+/// Error that Civetweb reports when the connection ended or timed out before any response byte arrived.
+static const char* NO_RESPONSE_ERROR = "Client did not send a request";
+
+/// Return whether a request may be sent again after a pooled connection failed. Only requests without side effects
+/// are resent, as the server may have already processed the request before closing the connection.
+static bool IsRetryableVerb(const String& verb)
+{
+    return !verb.Compare("GET", false) || !verb.Compare("HEAD", false) || !verb.Compare("OPTIONS", false) ||
+        !verb.Compare("TRACE", false);
+}
+
+/// Worker thread managed by the HTTP client.
+class HttpClientThread : public Thread, public RefCounted
+{
+public:
+    /// Construct.
+    explicit HttpClientThread(HttpClient* owner) :
+        owner_(owner)
+    {
+    }
+
+    /// Execute requests until stopped.
+    void ThreadFunction() override
+    {
+        owner_->ProcessRequests(shouldRun_);
+    }
+
+private:
+    /// HTTP client.
+    HttpClient* owner_;
+};
+
+HttpClient::HttpClient() :
+    shutDown_(false),
+    numThreads_(2),
+    keepAlive_(true),
+    maxIdleConnections_(4),
+    idleTimeout_(15000),
+    timeout_(30000)
+{
+}
+
+HttpClient::~HttpClient()
+{
+    StopThreads();
+    CloseIdleConnections();
+}
+
+void HttpClient::QueueRequest(HttpRequest* request)
+{
+    if (!request)
+        return;
+
+#ifdef URHO3D_THREADING
+    // The main thread keeps the request alive until a worker thread has returned it as finished
+    requests_.Push(SharedPtr<HttpRequest>(request));
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queue_.Push(request);
+    }
+    queueCondition_.notify_one();
+
+    StartThreads();
+#else
+    URHO3D_LOGERROR("HTTP request will not execute as threading is disabled");
+    request->SetFinished(HTTP_ERROR, "Threading disabled");
+#endif
+}
+
+void HttpClient::GetFinishedRequests(Vector<SharedPtr<HttpRequest> >& dest)
+{
+    // If only the client refers to a request, nobody will read the response
+    for (unsigned i = 0; i < requests_.Size(); ++i)
+    {
+        if (requests_[i]->Refs() == 1)
+            requests_[i]->abandoned_ = true;
+    }
+
+    PODVector<HttpRequest*> finished;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        finished.Swap(finished_);
+    }
+
+    for (unsigned i = 0; i < finished.Size(); ++i)
+    {
+        for (unsigned j = 0; j < requests_.Size(); ++j)
+        {
+            if (requests_[j] == finished[i])
+            {
+                if (!finished[i]->IsAbandoned())
+                    dest.Push(requests_[j]);
+                requests_.Erase(j);
+                break;
+            }
+        }
+    }
+}
+
+void HttpClient::CloseIdleConnections()
+{
+    MutexLock lock(poolMutex_);
+
+    for (HashMap<String, Vector<HttpPooledConnection> >::Iterator i = idleConnections_.Begin(); i != idleConnections_.End(); ++i)
+    {
+        for (unsigned j = 0; j < i->second_.Size(); ++j)
+            mg_close_connection(i->second_[j].connection_);
+    }
+
+    idleConnections_.Clear();
+}
+
+void HttpClient::SetNumThreads(unsigned num)
+{
+    if (!threads_.Empty())
+    {
+        URHO3D_LOGWARNING("Can not change number of HTTP client threads after they have been started");
+        return;
+    }
+
+    numThreads_ = Max(num, 1U);
+}
+
+void HttpClient::SetKeepAlive(bool enable)
+{
+    keepAlive_ = enable;
+    if (!enable)
+        CloseIdleConnections();
+}
+
+void HttpClient::SetMaxIdleConnections(unsigned num)
+{
+    maxIdleConnections_ = num;
+}
+
+void HttpClient::SetIdleTimeout(unsigned ms)
+{
+    idleTimeout_ = ms;
+}
+
+void HttpClient::SetTimeout(int ms)
+{
+    timeout_ = ms;
+}
+
+unsigned HttpClient::GetNumQueuedRequests() const
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    return queue_.Size();
+}
+
+unsigned HttpClient::GetNumIdleConnections() const
+{
+    MutexLock lock(poolMutex_);
+
+    unsigned num = 0;
+    for (HashMap<String, Vector<HttpPooledConnection> >::ConstIterator i = idleConnections_.Begin(); i != idleConnections_.End(); ++i)
+        num += i->second_.Size();
+    return num;
+}
+
+void HttpClient::StartThreads()
+{
+    if (!threads_.Empty())
+        return;
+
+    for (unsigned i = 0; i < numThreads_; ++i)
+    {
+        SharedPtr<HttpClientThread> thread(new HttpClientThread(this));
+        thread->Run();
+        threads_.Push(thread);
+    }
+}
+
+void HttpClient::StopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        shutDown_ = true;
+    }
+    queueCondition_.notify_all();
+
+    for (unsigned i = 0; i < threads_.Size(); ++i)
+        threads_[i]->Stop();
+    threads_.Clear();
+    shutDown_ = false;
+
+    // Fail the requests that never got executed. The worker threads have exited, so the requests can be released
+    for (List<HttpRequest*>::Iterator i = queue_.Begin(); i != queue_.End(); ++i)
+        (*i)->SetFinished(HTTP_ERROR, "HTTP client shut down");
+    queue_.Clear();
+    finished_.Clear();
+    requests_.Clear();
+}
+
+void HttpClient::ProcessRequests(const volatile bool& shouldRun)
+{
+    for (;;)
+    {
+        HttpRequest* request = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            // Wake up at least once per idle timeout to close expired pooled connections
+            if (queue_.Empty() && !shutDown_)
+            {
+                queueCondition_.wait_for(lock, std::chrono::milliseconds(Max(idleTimeout_, 1U)),
+                    [this] { return !queue_.Empty() || shutDown_; });
+            }
+            if (shutDown_)
+                return;
+            if (!queue_.Empty())
+            {
+                request = queue_.Front();
+                queue_.PopFront();
+            }
+        }
+
+        if (!request)
+        {
+            ExpireIdleConnections();
+            continue;
+        }
+
+        // Skip requests nobody refers to anymore. Return them also in that case, so that the main thread can release them
+        if (!request->IsAbandoned())
+            ExecuteRequest(request, shouldRun);
+
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        finished_.Push(request);
+    }
+}
+
+void HttpClient::ExecuteRequest(HttpRequest* request, const volatile bool& shouldRun)
+{
+    String key = request->host_ + ":" + String(request->port_) + (request->secure_ ? ":https" : ":http");
+    bool keepAlive = keepAlive_;
+
+    String headersStr;
+    for (unsigned i = 0; i < request->headers_.Size(); ++i)
+    {
+        // Trim and only add non-empty header strings
+        String header = request->headers_[i].Trimmed();
+        if (header.Length())
+            headersStr += header + "\r\n";
+    }
+    headersStr += keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    if (!request->postData_.Empty())
+        headersStr += "Content-Length: " + String(request->postData_.Length()) + "\r\n";
+
+    char errorBuffer[ERROR_BUFFER_SIZE];
+    mg_connection* connection = nullptr;
+    bool reused;
+    bool retryable = IsRetryableVerb(request->verb_);
+
+    for (;;)
+    {
+        memset(errorBuffer, 0, sizeof(errorBuffer));
+
+        connection = keepAlive ? AcquireConnection(key) : nullptr;
+        reused = connection != nullptr;
+        if (!connection)
+        {
+            // Initiate a new connection. This may block due to DNS query
+            /// \todo SSL mode will not actually work unless Civetweb's SSL mode is initialized with an external SSL DLL
+            connection = mg_connect_client(request->host_.CString(), request->port_, request->secure_ ? 1 : 0, errorBuffer,
+                sizeof(errorBuffer));
+            if (!connection)
+            {
+                request->SetFinished(HTTP_ERROR, String(&errorBuffer[0]));
+                return;
+            }
+        }
+
+        bool sent = mg_printf(connection,
+            "%s %s HTTP/1.1\r\n"
+            "Host: %s\r\n"
+            "%s"
+            "\r\n", request->verb_.CString(), request->path_.CString(), request->host_.CString(), headersStr.CString()) > 0;
+        if (sent && !request->postData_.Empty())
+            sent = mg_write(connection, request->postData_.CString(), request->postData_.Length()) > 0;
+
+        bool closedBeforeResponse = false;
+        if (sent)
+        {
+            Timer responseTimer;
+            if (mg_get_response(connection, errorBuffer, sizeof(errorBuffer), timeout_) >= 0)
+                break;
+
+            // Civetweb reports a timeout the same way as a closed connection, so tell them apart by the time waited
+            closedBeforeResponse = !strcmp(errorBuffer, NO_RESPONSE_ERROR) &&
+                (timeout_ < 0 || responseTimer.GetMSec(false) < (unsigned)timeout_);
+        }
+
+        mg_close_connection(connection);
+        connection = nullptr;
+
+        // A pooled connection may have been closed by the server while idle. In that case retry, but only if the
+        // request has no side effects and no response was started: a timed out request may still be processing
+        if (!reused || !retryable || (sent && !closedBeforeResponse))
+        {
+            request->SetFinished(HTTP_ERROR, errorBuffer[0] ? String(&errorBuffer[0]) : String("Error sending request"));
+            return;
+        }
+    }
+
+    // For responses Civetweb stores the protocol version in the request method and the status code in the URI
+    const mg_request_info* info = mg_get_request_info(connection);
+    int statusCode = info->uri ? ToInt(info->uri) : 0;
+    HashMap<String, String> headers;
+    for (int i = 0; i < info->num_headers; ++i)
+        headers[String(info->http_headers[i].name).ToLower()] = String(info->http_headers[i].value).Trimmed();
+
+    // The connection can only be reused if the body length is known, so that exactly the body can be consumed, and the
+    // server did not ask to close it
+    long long contentLength = info->content_length;
+    bool canReuse = keepAlive && contentLength >= 0 && info->request_method && !strcmp(info->request_method, "HTTP/1.1");
+    HashMap<String, String>::ConstIterator connectionHeader = headers.Find("connection");
+    if (connectionHeader != headers.End() && !connectionHeader->second_.Compare("close", false))
+        canReuse = false;
+    if (headers.Contains("transfer-encoding"))
+        canReuse = false;
+
+    request->SetResponse(statusCode, headers, reused);
+
+    // Responses to HEAD requests, informational, 204 and 304 responses never have a body
+    bool hasBody = request->verb_.Compare("HEAD", false) && statusCode >= 200 && statusCode != 204 && statusCode != 304;
+    long long totalRead = 0;
+
+    if (hasBody)
+    {
+        unsigned char buffer[RECEIVE_BUFFER_SIZE];
+
+        for (;;)
+        {
+            // Reading may block
+            int bytesRead = mg_read(connection, buffer, sizeof(buffer));
+            if (bytesRead <= 0)
+                break;
+
+            totalRead += bytesRead;
+            if (!request->WriteResponseData(buffer, (unsigned)bytesRead, shouldRun))
+            {
+                // Nobody will read the rest of the response, so the connection can not be reused either
+                canReuse = false;
+                break;
+            }
+        }
+    }
+
+    if (canReuse && (!hasBody || totalRead == contentLength))
+        ReleaseConnection(key, connection);
+    else
+        mg_close_connection(connection);
+
+    request->SetFinished(HTTP_CLOSED);
+}
+
+mg_connection* HttpClient::AcquireConnection(const String& key)
+{
+    MutexLock lock(poolMutex_);
+
+    HashMap<String, Vector<HttpPooledConnection> >::Iterator i = idleConnections_.Find(key);
+    if (i == idleConnections_.End())
+        return nullptr;
+
+    Vector<HttpPooledConnection>& connections = i->second_;
+    unsigned now = Time::GetSystemTime();
+
+    // Prefer the most recently used connection, as it is the least likely to have been closed by the server
+    while (!connections.Empty())
+    {
+        HttpPooledConnection pooled = connections.Back();
+        connections.Pop();
+        if (now - pooled.idleSince_ <= idleTimeout_)
+            return pooled.connection_;
+        mg_close_connection(pooled.connection_);
+    }
+
+    return nullptr;
+}
+
+void HttpClient::ReleaseConnection(const String& key, mg_connection* connection)
+{
+    MutexLock lock(poolMutex_);
+
+    Vector<HttpPooledConnection>& connections = idleConnections_[key];
+    if (connections.Size() >= maxIdleConnections_)
+    {
+        if (connections.Empty())
+        {
+            mg_close_connection(connection);
+            return;
+        }
+
+        // Pool full, close the connection idle for the longest time
+        mg_close_connection(connections.Front().connection_);
+        connections.Erase(0);
+    }
+
+    HttpPooledConnection pooled;
+    pooled.connection_ = connection;
+    pooled.idleSince_ = Time::GetSystemTime();
+    connections.Push(pooled);
+}
+
+void HttpClient::ExpireIdleConnections()
+{
+    MutexLock lock(poolMutex_);
+
+    unsigned now = Time::GetSystemTime();
+    for (HashMap<String, Vector<HttpPooledConnection> >::Iterator i = idleConnections_.Begin(); i != idleConnections_.End(); ++i)
+    {
+        Vector<HttpPooledConnection>& connections = i->second_;
+        // Connections are in the order they were returned, so expired ones are at the front
+        while (!connections.Empty() && now - connections.Front().idleSince_ > idleTimeout_)
+        {
+            mg_close_connection(connections.Front().connection_);
+            connections.Erase(0);
+        }
+    }
+}
+
+}
@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Container/HashMap.h"
+#include "../Container/List.h"
+#include "../Container/Ptr.h"
+#include "../Container/RefCounted.h"
+#include "../Core/Mutex.h"
+
+#include <condition_variable>
+#include <mutex>
+
+struct mg_connection;
+
+namespace Urho3D
+{
+
+class HttpClientThread;
+class HttpRequest;
+
+/// Idle keep-alive connection in the HTTP client pool.
+struct HttpPooledConnection
+{
+    /// Civetweb connection.
+    mg_connection* connection_;
+    /// System time in milliseconds when the connection was returned to the pool.
+    unsigned idleSince_;
+};
+
+/// Shared HTTP client that executes queued requests on a small pool of worker threads and reuses keep-alive connections per host. Owned by the Network subsystem. The requests are owned by the main thread; the worker threads only see raw pointers to them.
+class URHO3D_API HttpClient : public RefCounted
+{
+    friend class HttpClientThread;
+
+public:
+    /// Construct.
+    HttpClient();
+    /// Destruct. Stop the worker threads and close pooled connections.
+    ~HttpClient() override;
+
+    /// Queue a request for execution. Worker threads are started on first use. Called from the main thread.
+    void QueueRequest(HttpRequest* request);
+    /// Move requests finished since the last call to the destination vector and release the client's references to them. Requests nobody else refers to are marked abandoned, so that the worker threads skip or stop them, and are not returned. Called from the main thread.
+    void GetFinishedRequests(Vector<SharedPtr<HttpRequest> >& dest);
+    /// Close all idle pooled connections.
+    void CloseIdleConnections();
+
+    /// Set number of worker threads. Only takes effect before the first request is queued.
+    void SetNumThreads(unsigned num);
+    /// Set whether to keep connections alive for reuse by subsequent requests to the same host. Default true.
+    void SetKeepAlive(bool enable);
+    /// Set maximum number of idle connections pooled per host.
+    void SetMaxIdleConnections(unsigned num);
+    /// Set time in milliseconds after which an idle pooled connection is closed.
+    void SetIdleTimeout(unsigned ms);
+    /// Set socket timeout in milliseconds for receiving the response. Negative waits indefinitely.
+    void SetTimeout(int ms);
+
+    /// Return number of worker threads.
+    unsigned GetNumThreads() const { return numThreads_; }
+    /// Return whether keep-alive connections are used.
+    bool GetKeepAlive() const { return keepAlive_; }
+    /// Return maximum number of idle connections pooled per host.
+    unsigned GetMaxIdleConnections() const { return maxIdleConnections_; }
+    /// Return idle connection timeout in milliseconds.
+    unsigned GetIdleTimeout() const { return idleTimeout_; }
+    /// Return response timeout in milliseconds.
+    int GetTimeout() const { return timeout_; }
+    /// Return number of requests waiting for a worker thread.
+    unsigned GetNumQueuedRequests() const;
+    /// Return number of requests queued or executing that have not been returned by GetFinishedRequests() yet.
+    unsigned GetNumActiveRequests() const { return requests_.Size(); }
+    /// Return number of idle pooled connections across all hosts.
+    unsigned GetNumIdleConnections() const;
+
+private:
+    /// Start the worker threads if not started yet.
+    void StartThreads();
+    /// Stop the worker threads.
+    void StopThreads();
+    /// Execute queued requests until stopped. Called from the worker threads.
+    void ProcessRequests(const volatile bool& shouldRun);
+    /// Execute one request: send it, stream the response body and pool or close the connection.
+    void ExecuteRequest(HttpRequest* request, const volatile bool& shouldRun);
+    /// Take an idle connection for the host key from the pool, or null if none.
+    mg_connection* AcquireConnection(const String& key);
+    /// Return a connection with no pending response data to the pool.
+    void ReleaseConnection(const String& key, mg_connection* connection);
+    /// Close pooled connections that have been idle longer than the idle timeout.
+    void ExpireIdleConnections();
+
+    /// Worker threads.
+    Vector<SharedPtr<HttpClientThread> > threads_;
+    /// Requests queued or executing. Only accessed from the main thread, so that the reference counts are never changed by the worker threads.
+    Vector<SharedPtr<HttpRequest> > requests_;
+    /// Requests waiting for execution.
+    List<HttpRequest*> queue_;
+    /// Requests executed, skipped or failed, waiting to be released on the main thread.
+    PODVector<HttpRequest*> finished_;
+    /// Idle connections keyed by host, port and protocol.
+    HashMap<String, Vector<HttpPooledConnection> > idleConnections_;
+    /// Mutex for the request queue and the finished requests.
+    mutable std::mutex queueMutex_;
+    /// Condition for waking up the worker threads when requests are queued or the client shuts down.
+    std::condition_variable queueCondition_;
+    /// Shutting down flag. Protected by the queue mutex.
+    bool shutDown_;
+    /// Mutex for the connection pool.
+    mutable Mutex poolMutex_;
+    /// Number of worker threads.
+    unsigned numThreads_;
+    /// Keep-alive flag.
+    bool keepAlive_;
+    /// Maximum idle connections per host.
+    unsigned maxIdleConnections_;
+    /// Idle connection timeout in milliseconds.
+    unsigned idleTimeout_;
+    /// Response timeout in milliseconds.
+    int timeout_;
+};
+
+}
@@ -22,28 +22,31 @@
 
 #include "../Precompiled.h"
 
-#include "../Core/Profiler.h"
+#include "../Core/Timer.h"
 #include "../IO/Log.h"
 #include "../Network/HttpRequest.h"
 
-#include <Civetweb/civetweb.h>
-
 #include "../DebugNew.h"
 
 namespace Urho3D
 {
 
-static const unsigned ERROR_BUFFER_SIZE = 256;
-static const unsigned READ_BUFFER_SIZE = 65536; // Must be a power of two
+static const unsigned INITIAL_READ_BUFFER_SIZE = 65536; // Must be a power of two
 
 HttpRequest::HttpRequest(const String& url, const String& verb, const Vector<String>& headers, const String& postData) :
     url_(url.Trimmed()),
     verb_(!verb.Empty() ? verb : "GET"),
+    path_("/"),
+    port_(80),
+    secure_(false),
     headers_(headers),
     postData_(postData),
     state_(HTTP_INITIALIZING),
-    httpReadBuffer_(new unsigned char[READ_BUFFER_SIZE]),
-    readBuffer_(new unsigned char[READ_BUFFER_SIZE]),
+    statusCode_(0),
+    reused_(false),
+    abandoned_(false),
+    readBuffer_(new unsigned char[INITIAL_READ_BUFFER_SIZE]),
+    readBufferSize_(INITIAL_READ_BUFFER_SIZE),
     readPosition_(0),
     writePosition_(0)
 {
@@ -51,151 +54,36 @@ HttpRequest::HttpRequest(const String& url, const String& verb, const Vector<Str
     // to maximum value once the request is done, signaling end for Deserializer::IsEof().
     size_ = M_MAX_UNSIGNED;
 
-    URHO3D_LOGDEBUG("HTTP " + verb_ + " request to URL " + url_);
-
-#ifdef URHO3D_THREADING
-    // Start the worker thread to actually create the connection and read the response data.
-    Run();
-#else
-    URHO3D_LOGERROR("HTTP request will not execute as threading is disabled");
-#endif
-}
-
-HttpRequest::~HttpRequest()
-{
-    Stop();
-}
-
-void HttpRequest::ThreadFunction()
-{
-    String protocol = "http";
-    String host;
-    String path = "/";
-    int port = 80;
-
     unsigned protocolEnd = url_.Find("://");
     if (protocolEnd != String::NPOS)
     {
-        protocol = url_.Substring(0, protocolEnd);
-        host = url_.Substring(protocolEnd + 3);
+        secure_ = !url_.Substring(0, protocolEnd).Compare("https", false);
+        host_ = url_.Substring(protocolEnd + 3);
     }
     else
-        host = url_;
+        host_ = url_;
 
-    unsigned pathStart = host.Find('/');
+    unsigned pathStart = host_.Find('/');
     if (pathStart != String::NPOS)
     {
-        path = host.Substring(pathStart);
-        host = host.Substring(0, pathStart);
+        path_ = host_.Substring(pathStart);
+        host_ = host_.Substring(0, pathStart);
     }
 
-    unsigned portStart = host.Find(':');
+    unsigned portStart = host_.Find(':');
     if (portStart != String::NPOS)
     {
-        port = ToInt(host.Substring(portStart + 1));
-        host = host.Substring(0, portStart);
+        port_ = ToInt(host_.Substring(portStart + 1));
+        host_ = host_.Substring(0, portStart);
     }
+    else if (secure_)
+        port_ = 443;
 
-    char errorBuffer[ERROR_BUFFER_SIZE];
-    memset(errorBuffer, 0, sizeof(errorBuffer));
-
-    String headersStr;
-    for (unsigned i = 0; i < headers_.Size(); ++i)
-    {
-        // Trim and only add non-empty header strings
-        String header = headers_[i].Trimmed();
-        if (header.Length())
-            headersStr += header + "\r\n";
-    }
-
-    // Initiate the connection. This may block due to DNS query
-    /// \todo SSL mode will not actually work unless Civetweb's SSL mode is initialized with an external SSL DLL
-    mg_connection* connection = nullptr;
-    if (postData_.Empty())
-    {
-        connection = mg_download(host.CString(), port, protocol.Compare("https", false) ? 0 : 1, errorBuffer, sizeof(errorBuffer),
-            "%s %s HTTP/1.0\r\n"
-            "Host: %s\r\n"
-            "%s"
-            "\r\n", verb_.CString(), path.CString(), host.CString(), headersStr.CString());
-    }
-    else
-    {
-        connection = mg_download(host.CString(), port, protocol.Compare("https", false) ? 0 : 1, errorBuffer, sizeof(errorBuffer),
-            "%s %s HTTP/1.0\r\n"
-            "Host: %s\r\n"
-            "%s"
-            "Content-Length: %d\r\n"
-            "\r\n"
-            "%s", verb_.CString(), path.CString(), host.CString(), headersStr.CString(), postData_.Length(), postData_.CString());
-    }
-
-    {
-        MutexLock lock(mutex_);
-        state_ = connection ? HTTP_OPEN : HTTP_ERROR;
-
-        // If no connection could be made, store the error and exit
-        if (state_ == HTTP_ERROR)
-        {
-            error_ = String(&errorBuffer[0]);
-            return;
-        }
-    }
-
-    // Loop while should run, read data from the connection, copy to the main thread buffer if there is space
-    while (shouldRun_)
-    {
-        // Read less than full buffer to be able to distinguish between full and empty ring buffer. Reading may block
-        int bytesRead = mg_read(connection, httpReadBuffer_.Get(), READ_BUFFER_SIZE / 4);
-        if (bytesRead <= 0)
-            break;
-
-        mutex_.Acquire();
-
-        // Wait until enough space in the main thread's ring buffer
-        for (;;)
-        {
-            unsigned spaceInBuffer = READ_BUFFER_SIZE - ((writePosition_ - readPosition_) & (READ_BUFFER_SIZE - 1));
-            if ((int)spaceInBuffer > bytesRead || !shouldRun_)
-                break;
-
-            mutex_.Release();
-            Time::Sleep(5);
-            mutex_.Acquire();
-        }
-
-        if (!shouldRun_)
-        {
-            mutex_.Release();
-            break;
-        }
-
-        if (writePosition_ + bytesRead <= READ_BUFFER_SIZE)
-            memcpy(readBuffer_.Get() + writePosition_, httpReadBuffer_.Get(), (size_t)bytesRead);
-        else
-        {
-            // Handle ring buffer wrap
-            unsigned part1 = READ_BUFFER_SIZE - writePosition_;
-            unsigned part2 = bytesRead - part1;
-            memcpy(readBuffer_.Get() + writePosition_, httpReadBuffer_.Get(), part1);
-            memcpy(readBuffer_.Get(), httpReadBuffer_.Get() + part1, part2);
-        }
-
-        writePosition_ += bytesRead;
-        writePosition_ &= READ_BUFFER_SIZE - 1;
-
-        mutex_.Release();
-    }
-
-    // Close the connection
-    mg_close_connection(connection);
-
-    {
-        MutexLock lock(mutex_);
-        state_ = HTTP_CLOSED;
-    }
+    URHO3D_LOGDEBUG("HTTP " + verb_ + " request to URL " + url_);
 }
 
+HttpRequest::~HttpRequest() = default;
+
 unsigned HttpRequest::Read(void* dest, unsigned size)
 {
 #ifdef URHO3D_THREADING
@@ -227,19 +115,19 @@ unsigned HttpRequest::Read(void* dest, unsigned size)
             if (bytesAvailable > sizeLeft)
                 bytesAvailable = sizeLeft;
 
-            if (readPosition_ + bytesAvailable <= READ_BUFFER_SIZE)
+            if (readPosition_ + bytesAvailable <= readBufferSize_)
                 memcpy(destPtr, readBuffer_.Get() + readPosition_, bytesAvailable);
             else
             {
                 // Handle ring buffer wrap
-                unsigned part1 = READ_BUFFER_SIZE - readPosition_;
+                unsigned part1 = readBufferSize_ - readPosition_;
                 unsigned part2 = bytesAvailable - part1;
                 memcpy(destPtr, readBuffer_.Get() + readPosition_, part1);
                 memcpy(destPtr + part1, readBuffer_.Get(), part2);
             }
 
             readPosition_ += bytesAvailable;
-            readPosition_ &= READ_BUFFER_SIZE - 1;
+            readPosition_ &= readBufferSize_ - 1;
             sizeLeft -= bytesAvailable;
             totalRead += bytesAvailable;
             destPtr += bytesAvailable;
@@ -280,6 +168,25 @@ HttpRequestState HttpRequest::GetState() const
     return state_;
 }
 
+int HttpRequest::GetStatusCode() const
+{
+    MutexLock lock(mutex_);
+    return statusCode_;
+}
+
+String HttpRequest::GetResponseHeader(const String& name) const
+{
+    MutexLock lock(mutex_);
+    HashMap<String, String>::ConstIterator i = responseHeaders_.Find(name.ToLower());
+    return i != responseHeaders_.End() ? i->second_ : String::EMPTY;
+}
+
+bool HttpRequest::IsConnectionReused() const
+{
+    MutexLock lock(mutex_);
+    return reused_;
+}
+
 unsigned HttpRequest::GetAvailableSize() const
 {
     MutexLock lock(mutex_);
@@ -288,8 +195,74 @@ unsigned HttpRequest::GetAvailableSize() const
 
 Pair<unsigned, bool> HttpRequest::CheckAvailableSizeAndEof() const
 {
-    unsigned size = (writePosition_ - readPosition_) & (READ_BUFFER_SIZE - 1);
+    unsigned size = (writePosition_ - readPosition_) & (readBufferSize_ - 1);
     return {size, (state_ == HTTP_ERROR || (state_ == HTTP_CLOSED && !size))};
 }
 
+void HttpRequest::SetResponse(int statusCode, const HashMap<String, String>& headers, bool reused)
+{
+    MutexLock lock(mutex_);
+    statusCode_ = statusCode;
+    responseHeaders_ = headers;
+    reused_ = reused;
+    state_ = HTTP_OPEN;
+}
+
+bool HttpRequest::WriteResponseData(const unsigned char* data, unsigned size, const volatile bool& shouldRun)
+{
+    if (!shouldRun || IsAbandoned())
+        return false;
+
+    MutexLock lock(mutex_);
+
+    // Leave one byte free to be able to distinguish between full and empty buffer
+    unsigned dataInBuffer = (writePosition_ - readPosition_) & (readBufferSize_ - 1);
+    if (readBufferSize_ - 1 - dataInBuffer < size)
+    {
+        // Grow the buffer instead of waiting for the main thread to read, so that an unread large response does not
+        // keep a worker thread from executing the other requests. Unwrap the existing data to the start
+        unsigned newSize = readBufferSize_;
+        while (newSize - 1 - dataInBuffer < size)
+            newSize <<= 1;
+
+        SharedArrayPtr<unsigned char> newBuffer(new unsigned char[newSize]);
+        if (readPosition_ + dataInBuffer <= readBufferSize_)
+            memcpy(newBuffer.Get(), readBuffer_.Get() + readPosition_, dataInBuffer);
+        else
+        {
+            unsigned part1 = readBufferSize_ - readPosition_;
+            memcpy(newBuffer.Get(), readBuffer_.Get() + readPosition_, part1);
+            memcpy(newBuffer.Get() + part1, readBuffer_.Get(), dataInBuffer - part1);
+        }
+
+        readBuffer_ = newBuffer;
+        readBufferSize_ = newSize;
+        readPosition_ = 0;
+        writePosition_ = dataInBuffer;
+    }
+
+    if (writePosition_ + size <= readBufferSize_)
+        memcpy(readBuffer_.Get() + writePosition_, data, size);
+    else
+    {
+        // Handle ring buffer wrap
+        unsigned part1 = readBufferSize_ - writePosition_;
+        unsigned part2 = size - part1;
+        memcpy(readBuffer_.Get() + writePosition_, data, part1);
+        memcpy(readBuffer_.Get(), data + part1, part2);
+    }
+
+    writePosition_ += size;
+    writePosition_ &= readBufferSize_ - 1;
+
+    return true;
+}
+
+void HttpRequest::SetFinished(HttpRequestState state, const String& error)
+{
+    MutexLock lock(mutex_);
+    state_ = state;
+    error_ = error;
+}
+
 }
@@ -25,11 +25,13 @@
 #pragma once
 
 #include "../Container/ArrayPtr.h"
+#include "../Container/HashMap.h"
 #include "../Core/Mutex.h"
 #include "../Container/RefCounted.h"
-#include "../Core/Thread.h"
 #include "../IO/Deserializer.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -42,18 +44,17 @@ enum HttpRequestState
     HTTP_CLOSED
 };
 
-/// An HTTP connection with response data stream.
-class URHO3D_API HttpRequest : public RefCounted, public Deserializer, public Thread
+/// An HTTP request with response data stream. Executed by the HttpClient worker threads of the Network subsystem.
+class URHO3D_API HttpRequest : public RefCounted, public Deserializer
 {
+    friend class HttpClient;
+
 public:
-    /// Construct with parameters.
+    /// Construct with parameters. The request does not execute until queued to an HttpClient, which Network::MakeHttpRequest() does.
     HttpRequest(const String& url, const String& verb, const Vector<String>& headers, const String& postData);
-    /// Destruct. Release the connection object.
+    /// Destruct.
     ~HttpRequest() override;
 
-    /// Process the connection in the worker thread until closed.
-    void ThreadFunction() override;
-
     /// Read response data from the HTTP connection and return number of bytes actually read. While the connection is open, will block while trying to read the specified size. To avoid blocking, only read up to as many bytes as GetAvailableSize() returns.
     unsigned Read(void* dest, unsigned size) override;
     /// Set position from the beginning of the stream. Not supported.
@@ -67,12 +68,27 @@ public:
     /// Return verb used in the request. Default GET if empty verb specified on construction.
     const String& GetVerb() const { return verb_; }
 
+    /// Return host parsed from the URL.
+    const String& GetHost() const { return host_; }
+
+    /// Return port parsed from the URL.
+    int GetPort() const { return port_; }
+
+    /// Return whether the URL uses the https protocol.
+    bool IsSecure() const { return secure_; }
+
     /// Return error. Only non-empty in the error state.
     String GetError() const;
     /// Return connection state.
     HttpRequestState GetState() const;
     /// Return amount of bytes in the read buffer.
     unsigned GetAvailableSize() const;
+    /// Return HTTP status code of the response, or 0 if the response headers have not been received yet.
+    int GetStatusCode() const;
+    /// Return a response header value by case-insensitive name, or empty if not found or not received yet.
+    String GetResponseHeader(const String& name) const;
+    /// Return whether the request was served using a pooled keep-alive connection.
+    bool IsConnectionReused() const;
 
     /// Return whether connection is in the open state.
     bool IsOpen() const { return GetState() == HTTP_OPEN; }
@@ -80,11 +96,27 @@ public:
 private:
     /// Check for available read data in buffer and whether end has been reached. Must only be called when the mutex is held by the main thread.
     Pair<unsigned, bool> CheckAvailableSizeAndEof() const;
+    /// Store response status and headers and set the open state. Called from the worker thread.
+    void SetResponse(int statusCode, const HashMap<String, String>& headers, bool reused);
+    /// Copy response data to the ring buffer, growing it if full so that the worker thread never waits for the main thread to read. Return false if abandoned. Called from the worker thread.
+    bool WriteResponseData(const unsigned char* data, unsigned size, const volatile bool& shouldRun);
+    /// Set the final state and error. Called from the worker thread.
+    void SetFinished(HttpRequestState state, const String& error = String::EMPTY);
+    /// Return whether nobody but the client refers to the request anymore, meaning nobody will read the response. Set by the client on the main thread.
+    bool IsAbandoned() const { return abandoned_; }
 
     /// URL.
     String url_;
     /// Verb.
     String verb_;
+    /// Host parsed from the URL.
+    String host_;
+    /// Path parsed from the URL.
+    String path_;
+    /// Port parsed from the URL.
+    int port_;
+    /// Whether to use https.
+    bool secure_;
     /// Error string. Empty if no error.
     String error_;
     /// Headers.
@@ -93,12 +125,20 @@ private:
     String postData_;
     /// Connection state.
     HttpRequestState state_;
+    /// Response status code.
+    int statusCode_;
+    /// Response headers keyed by lowercase name.
+    HashMap<String, String> responseHeaders_;
+    /// Whether a pooled connection was used.
+    bool reused_;
+    /// Abandoned flag.
+    std::atomic<bool> abandoned_;
     /// Mutex for synchronizing the worker and the main thread.
     mutable Mutex mutex_;
-    /// Read buffer for the worker thread.
-    SharedArrayPtr<unsigned char> httpReadBuffer_;
     /// Read buffer for the main thread.
     SharedArrayPtr<unsigned char> readBuffer_;
+    /// Read buffer size. Always a power of two.
+    unsigned readBufferSize_;
     /// Read buffer read cursor.
     unsigned readPosition_;
     /// Read buffer write cursor.
@@ -0,0 +1,387 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
+#include "../Core/Profiler.h"
+#include "../Core/Timer.h"
+#include "../Graphics/Renderer.h"
+#include "../IO/Log.h"
+#include "../Network/Connection.h"
+#include "../Network/MetricsServer.h"
+#include "../Network/Network.h"
+#include "../Resource/JSONFile.h"
+#include "../Resource/ResourceCache.h"
+
+#include <Civetweb/civetweb.h>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static const char* METRICS_TEXT_URI = "/metrics";
+static const char* METRICS_JSON_URI = "/metrics.json";
+
+/// Escape a Prometheus label value.
+static String EscapeLabel(const String& value)
+{
+    String ret;
+    ret.Reserve(value.Length());
+    for (unsigned i = 0; i < value.Length(); ++i)
+    {
+        char c = value[i];
+        if (c == '\\' || c == '"')
+            ret += '\\';
+        if (c == '\n')
+            ret += "\\n";
+        else
+            ret += c;
+    }
+    return ret;
+}
+
+/// Append a metric with help and type comments to Prometheus text.
+static void AppendMetric(String& dest, const char* name, const char* type, const char* help, double value)
+{
+    dest.AppendWithFormat("# HELP %s %s\n# TYPE %s %s\n%s %f\n", name, help, name, type, name, value);
+}
+
+/// Send a snapshot as the response to a Civetweb request.
+static void SendSnapshot(mg_connection* connection, const String& body, const char* contentType)
+{
+    mg_printf(connection,
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: %s\r\n"
+        "Content-Length: %u\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: close\r\n"
+        "\r\n", contentType, body.Length());
+    mg_write(connection, body.CString(), body.Length());
+}
+
+/// Civetweb handler for the Prometheus text endpoint. Runs in a Civetweb worker thread.
+static int HandleTextRequest(mg_connection* connection, void* cbdata)
+{
+    SendSnapshot(connection, static_cast<MetricsServer*>(cbdata)->GetTextSnapshot(), "text/plain; version=0.0.4");
+    return 1;
+}
+
+/// Civetweb handler for the JSON endpoint. Runs in a Civetweb worker thread.
+static int HandleJSONRequest(mg_connection* connection, void* cbdata)
+{
+    SendSnapshot(connection, static_cast<MetricsServer*>(cbdata)->GetJSONSnapshot(), "application/json");
+    return 1;
+}
+
+MetricsServer::MetricsServer(Context* context) :
+    Object(context),
+    serverContext_(nullptr),
+    pending_(false),
+    updateInterval_(1.0f),
+    intervalTime_(0.0f),
+    intervalFrames_(0),
+    intervalMaxFrameTime_(0.0f),
+    profilerMaxDepth_(4)
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+    Stop();
+}
+
+bool MetricsServer::Start(unsigned short port, const String& address)
+{
+    Stop();
+
+    String listeningPorts = address.Empty() ? String(port) : address + ":" + String(port);
+    const char* options[] = {
+        "listening_ports", listeningPorts.CString(),
+        "num_threads", "1",
+        nullptr
+    };
+
+    mg_callbacks callbacks;
+    memset(&callbacks, 0, sizeof(callbacks));
+
+    serverContext_ = mg_start(&callbacks, this, options);
+    if (!serverContext_)
+    {
+        URHO3D_LOGERROR("Failed to start metrics server on " + listeningPorts);
+        return false;
+    }
+
+    mg_set_request_handler(serverContext_, METRICS_TEXT_URI, HandleTextRequest, this);
+    mg_set_request_handler(serverContext_, METRICS_JSON_URI, HandleJSONRequest, this);
+
+    // Publish an initial snapshot so that the endpoints are not empty before the first interval elapses
+    UpdateSnapshot();
+    PublishSnapshot();
+    intervalTime_ = 0.0f;
+    intervalFrames_ = 0;
+    intervalMaxFrameTime_ = 0.0f;
+
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(MetricsServer, HandleEndFrame));
+
+    URHO3D_LOGINFO("Serving metrics on " + listeningPorts);
+    return true;
+}
+
+void MetricsServer::Stop()
+{
+    if (!serverContext_)
+        return;
+
+    UnsubscribeFromEvent(E_ENDFRAME);
+    // Stopping waits for the Civetweb threads, so no request handler can run afterward
+    mg_stop(serverContext_);
+    serverContext_ = nullptr;
+}
+
+void MetricsServer::SetUpdateInterval(float interval)
+{
+    updateInterval_ = Max(interval, 0.0f);
+}
+
+void MetricsServer::SetProfilerMaxDepth(unsigned depth)
+{
+    profilerMaxDepth_ = depth;
+}
+
+String MetricsServer::GetTextSnapshot() const
+{
+    MutexLock lock(snapshotMutex_);
+    return text_;
+}
+
+String MetricsServer::GetJSONSnapshot() const
+{
+    MutexLock lock(snapshotMutex_);
+    return json_;
+}
+
+void MetricsServer::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    float timeStep = GetSubsystem<Time>()->GetTimeStep();
+    intervalTime_ += timeStep;
+    ++intervalFrames_;
+    intervalMaxFrameTime_ = Max(intervalMaxFrameTime_, timeStep);
+
+    if (intervalTime_ >= updateInterval_)
+    {
+        UpdateSnapshot();
+        intervalTime_ = 0.0f;
+        intervalFrames_ = 0;
+        intervalMaxFrameTime_ = 0.0f;
+    }
+
+    // A request handler may hold the mutex at the moment, in which case retry on the next frame
+    if (pending_)
+        PublishSnapshot();
+}
+
+void MetricsServer::UpdateSnapshot()
+{
+    URHO3D_PROFILE(UpdateMetricsSnapshot);
+
+    auto* time = GetSubsystem<Time>();
+    auto* renderer = GetSubsystem<Renderer>();
+    auto* cache = GetSubsystem<ResourceCache>();
+    auto* network = GetSubsystem<Network>();
+    auto* profiler = GetSubsystem<Profiler>();
+
+    float averageFrameTime = intervalFrames_ ? intervalTime_ / intervalFrames_ : time->GetTimeStep();
+
+    JSONFile jsonFile(context_);
+    JSONValue& root = jsonFile.GetRoot();
+    String& text = pendingText_;
+    text.Clear();
+
+    AppendMetric(text, "urho3d_frames_total", "counter", "Frames since engine start.", time->GetFrameNumber());
+    AppendMetric(text, "urho3d_elapsed_seconds", "counter", "Seconds since engine start.", time->GetElapsedTime());
+    AppendMetric(text, "urho3d_fps", "gauge", "Average frames per second over the update interval.",
+        averageFrameTime > 0.0f ? 1.0f / averageFrameTime : 0.0f);
+    AppendMetric(text, "urho3d_frame_time_seconds", "gauge", "Average frame time over the update interval.", averageFrameTime);
+    AppendMetric(text, "urho3d_frame_time_max_seconds", "gauge", "Longest frame time over the update interval.", intervalMaxFrameTime_);
+
+    JSONValue frame;
+    frame["number"] = time->GetFrameNumber();
+    frame["elapsed"] = time->GetElapsedTime();
+    frame["fps"] = averageFrameTime > 0.0f ? 1.0f / averageFrameTime : 0.0f;
+    frame["averageTime"] = averageFrameTime;
+    frame["maxTime"] = intervalMaxFrameTime_;
+    root["frame"] = frame;
+
+    if (renderer)
+    {
+        AppendMetric(text, "urho3d_renderer_views", "gauge", "Views rendered in the last frame.", renderer->GetNumViews());
+        AppendMetric(text, "urho3d_renderer_batches", "gauge", "Batches rendered in the last frame.", renderer->GetNumBatches());
+        AppendMetric(text, "urho3d_renderer_primitives", "gauge", "Primitives rendered in the last frame.", renderer->GetNumPrimitives());
+
+        JSONValue rendering;
+        rendering["views"] = renderer->GetNumViews();
+        rendering["batches"] = renderer->GetNumBatches();
+        rendering["primitives"] = renderer->GetNumPrimitives();
+        root["renderer"] = rendering;
+    }
+
+    if (cache)
+    {
+        AppendMetric(text, "urho3d_resource_memory_total_bytes", "gauge", "Memory used by all loaded resources.",
+            (double)cache->GetTotalMemoryUse());
+        text += "# HELP urho3d_resource_memory_bytes Memory used by loaded resources of a type.\n"
+            "# TYPE urho3d_resource_memory_bytes gauge\n";
+
+        JSONValue resources;
+        resources["totalMemory"] = (double)cache->GetTotalMemoryUse();
+        JSONValue types;
+        const HashMap<StringHash, ResourceGroup>& groups = cache->GetAllResources();
+        for (HashMap<StringHash, ResourceGroup>::ConstIterator i = groups.Begin(); i != groups.End(); ++i)
+        {
+            const String& typeName = context_->GetTypeName(i->first_);
+            String name = !typeName.Empty() ? typeName : i->first_.ToString();
+            text.AppendWithFormat("urho3d_resource_memory_bytes{type=\"%s\"} %f\n", EscapeLabel(name).CString(),
+                (double)i->second_.memoryUse_);
+
+            JSONValue type;
+            type["count"] = i->second_.resources_.Size();
+            type["memory"] = (double)i->second_.memoryUse_;
+            type["budget"] = (double)i->second_.memoryBudget_;
+            types[name] = type;
+        }
+        resources["types"] = types;
+        root["resources"] = resources;
+    }
+
+    if (network)
+    {
+        Vector<SharedPtr<Connection> > connections = network->GetClientConnections();
+        if (network->GetServerConnection())
+            connections.Push(SharedPtr<Connection>(network->GetServerConnection()));
+
+        AppendMetric(text, "urho3d_network_server_running", "gauge", "Whether the network server is running.",
+            network->IsServerRunning() ? 1.0 : 0.0);
+        AppendMetric(text, "urho3d_network_connections", "gauge", "Open client and server connections.", connections.Size());
+
+        static const char* connectionMetrics[] = {
+            "urho3d_network_bytes_in_per_second",
+            "urho3d_network_bytes_out_per_second",
+            "urho3d_network_packets_in_per_second",
+            "urho3d_network_packets_out_per_second",
+            "urho3d_network_round_trip_seconds"
+        };
+        static const char* connectionHelp[] = {
+            "Bytes received per second on a connection.",
+            "Bytes sent per second on a connection.",
+            "Packets received per second on a connection.",
+            "Packets sent per second on a connection.",
+            "Round trip time of a connection."
+        };
+
+        JSONValue networkValue;
+        networkValue["serverRunning"] = network->IsServerRunning();
+        JSONValue connectionsValue;
+
+        for (unsigned m = 0; m < 5; ++m)
+        {
+            text.AppendWithFormat("# HELP %s %s\n# TYPE %s gauge\n", connectionMetrics[m], connectionHelp[m], connectionMetrics[m]);
+            for (unsigned i = 0; i < connections.Size(); ++i)
+            {
+                Connection* connection = connections[i];
+                double values[] = {
+                    connection->GetBytesInPerSec(),
+                    connection->GetBytesOutPerSec(),
+                    (double)connection->GetPacketsInPerSec(),
+                    (double)connection->GetPacketsOutPerSec(),
+                    connection->GetRoundTripTime() * 0.001
+                };
+                text.AppendWithFormat("%s{connection=\"%s\"} %f\n", connectionMetrics[m], EscapeLabel(connection->ToString()).CString(),
+                    values[m]);
+
+                if (!m)
+                {
+                    JSONValue connectionValue;
+                    connectionValue["address"] = connection->ToString();
+                    connectionValue["bytesInPerSec"] = values[0];
+                    connectionValue["bytesOutPerSec"] = values[1];
+                    connectionValue["packetsInPerSec"] = values[2];
+                    connectionValue["packetsOutPerSec"] = values[3];
+                    connectionValue["roundTripTime"] = values[4];
+                    connectionsValue.Push(connectionValue);
+                }
+            }
+        }
+
+        networkValue["connections"] = connectionsValue;
+        root["network"] = networkValue;
+    }
+
+    if (profiler && profiler->GetRootBlock())
+    {
+        JSONValue profilerValue;
+        WriteProfilerBlock(profiler->GetRootBlock(), profilerValue, 0);
+        root["profiler"] = profilerValue;
+    }
+
+    pendingJSON_ = jsonFile.ToString(String::EMPTY);
+    pending_ = true;
+}
+
+void MetricsServer::PublishSnapshot()
+{
+    // Never block the main thread on a request handler copying the previous snapshot
+    if (!snapshotMutex_.TryAcquire())
+        return;
+
+    text_.Swap(pendingText_);
+    json_.Swap(pendingJSON_);
+    snapshotMutex_.Release();
+    pending_ = false;
+}
+
+void MetricsServer::WriteProfilerBlock(const ProfilerBlock* block, JSONValue& dest, unsigned depth) const
+{
+    dest["name"] = block->name_ ? block->name_ : "Root";
+    dest["frameTime"] = block->frameTime_ * 0.001;
+    dest["frameMaxTime"] = block->frameMaxTime_ * 0.001;
+    dest["frameCount"] = block->frameCount_;
+    dest["totalTime"] = block->totalTime_ * 0.001;
+    dest["totalCount"] = block->totalCount_;
+
+    if (depth >= profilerMaxDepth_ || block->children_.Empty())
+        return;
+
+    JSONValue children;
+    for (PODVector<ProfilerBlock*>::ConstIterator i = block->children_.Begin(); i != block->children_.End(); ++i)
+    {
+        JSONValue child;
+        WriteProfilerBlock(*i, child, depth + 1);
+        children.Push(child);
+    }
+    dest["children"] = children;
+}
+
+}
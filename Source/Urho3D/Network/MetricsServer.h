@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+/// \file
+
+#pragma once
+
+#include "../Core/Mutex.h"
+#include "../Core/Object.h"
+
+struct mg_context;
+
+namespace Urho3D
+{
+
+class JSONValue;
+class ProfilerBlock;
+
+/// Embedded HTTP server exposing engine counters for monitoring. Serves Prometheus text format at /metrics and a JSON snapshot including the profiler tree at /metrics.json.
+class URHO3D_API MetricsServer : public Object
+{
+    URHO3D_OBJECT(MetricsServer, Object);
+
+public:
+    /// Construct.
+    explicit MetricsServer(Context* context);
+    /// Destruct. Stop the server.
+    ~MetricsServer() override;
+
+    /// Start serving on the specified port. Listens only on the loopback interface unless another address is given. Return true if successful.
+    bool Start(unsigned short port, const String& address = "127.0.0.1");
+    /// Stop serving.
+    void Stop();
+    /// Set interval in seconds between snapshot updates on the main thread.
+    void SetUpdateInterval(float interval);
+    /// Set maximum depth of the profiler tree included in the JSON snapshot.
+    void SetProfilerMaxDepth(unsigned depth);
+
+    /// Return whether the server is running.
+    bool IsRunning() const { return serverContext_ != nullptr; }
+    /// Return snapshot update interval in seconds.
+    float GetUpdateInterval() const { return updateInterval_; }
+    /// Return maximum depth of the profiler tree in the JSON snapshot.
+    unsigned GetProfilerMaxDepth() const { return profilerMaxDepth_; }
+
+    /// Return the latest published snapshot in Prometheus text format. Thread-safe.
+    String GetTextSnapshot() const;
+    /// Return the latest published snapshot in JSON format. Thread-safe.
+    String GetJSONSnapshot() const;
+
+private:
+    /// Handle end of frame. Accumulate frame timing and publish a new snapshot when the interval has elapsed.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Gather the counters and format both snapshot representations.
+    void UpdateSnapshot();
+    /// Try to publish the pending snapshot without blocking.
+    void PublishSnapshot();
+    /// Add a profiler block and its children to JSON.
+    void WriteProfilerBlock(const ProfilerBlock* block, JSONValue& dest, unsigned depth) const;
+
+    /// Civetweb server context. Null when not running.
+    mg_context* serverContext_;
+    /// Mutex for the published snapshot. Only try-acquired by the main thread.
+    mutable Mutex snapshotMutex_;
+    /// Published Prometheus text snapshot.
+    String text_;
+    /// Published JSON snapshot.
+    String json_;
+    /// Formatted Prometheus text snapshot waiting to be published.
+    String pendingText_;
+    /// Formatted JSON snapshot waiting to be published.
+    String pendingJSON_;
+    /// Whether a formatted snapshot is waiting to be published.
+    bool pending_;
+    /// Snapshot update interval in seconds.
+    float updateInterval_;
+    /// Time accumulated since the last snapshot.
+    float intervalTime_;
+    /// Frames since the last snapshot.
+    unsigned intervalFrames_;
+    /// Longest frame since the last snapshot.
+    float intervalMaxFrameTime_;
+    /// Maximum profiler tree depth in the JSON snapshot.
+    unsigned profilerMaxDepth_;
+};
+
+}
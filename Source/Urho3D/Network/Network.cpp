@@ -31,6 +31,7 @@
 #include "../IO/IOEvents.h"
 #include "../IO/Log.h"
 #include "../IO/MemoryBuffer.h"
+#include "../Network/HttpClient.h"
 #include "../Network/HttpRequest.h"
 #include "../Network/Network.h"
 #include "../Network/NetworkEvents.h"
@@ -216,6 +217,8 @@ Network::Network(Context* context) :
 
     SetNATServerInfo("127.0.0.1", 61111);
 
+    httpClient_ = new HttpClient();
+
     // Register Network library object factories
     RegisterNetworkLibrary(context_);
 
@@ -263,6 +266,7 @@ Network::Network(Context* context) :
     blacklistedRemoteEvents_.Insert(E_NETWORKMESSAGE);
     blacklistedRemoteEvents_.Insert(E_NETWORKUPDATE);
     blacklistedRemoteEvents_.Insert(E_NETWORKUPDATESENT);
+    blacklistedRemoteEvents_.Insert(E_CONTROLSACKNOWLEDGED);
     blacklistedRemoteEvents_.Insert(E_NETWORKSCENELOADFAILED);
 }
 
@@ -275,6 +279,7 @@ Network::~Network()
     serverConnection_.Reset();
 
     clientConnections_.Clear();
+    httpClient_.Reset();
 
     delete natPunchthroughServerClient_;
     natPunchthroughServerClient_ = nullptr;
@@ -652,6 +657,7 @@ SharedPtr<HttpRequest> Network::MakeHttpRequest(const String& url, const String&
 
     // The initialization of the request will take time, can not know at this point if it has an error or not
     SharedPtr<HttpRequest> request(new HttpRequest(url, verb, headers, postData));
+    httpClient_->QueueRequest(request);
     return request;
 }
 
@@ -918,6 +924,22 @@ void Network::Update(float timeStep)
             rakPeerClient_->DeallocatePacket(packet);
         }
     }
+
+    // Reconcile client-side prediction once all scene updates of this frame have been applied
+    if (serverConnection_)
+        serverConnection_->ProcessAcknowledgedControls();
+
+    // Notify of finished HTTP requests
+    Vector<SharedPtr<HttpRequest> > finishedRequests;
+    httpClient_->GetFinishedRequests(finishedRequests);
+    for (unsigned i = 0; i < finishedRequests.Size(); ++i)
+    {
+        using namespace HttpRequestFinished;
+
+        VariantMap& eventData = GetEventDataMap();
+        eventData[P_REQUEST] = finishedRequests[i].Get();
+        SendEvent(E_HTTPREQUESTFINISHED, eventData);
+    }
 }
 
 void Network::PostUpdate(float timeStep)
@@ -30,6 +30,7 @@
 namespace Urho3D
 {
 
+class HttpClient;
 class HttpRequest;
 class MemoryBuffer;
 class Scene;
@@ -100,7 +101,7 @@ public:
     void SetPackageCacheDir(const String& path);
     /// Trigger all client connections in the specified scene to download a package file from the server. Can be used to download additional resource packages when clients are already joined in the scene. The package must have been added as a requirement to the scene, or else the eventual download will fail.
     void SendPackageToClients(Scene* scene, PackageFile* package);
-    /// Perform an HTTP request to the specified URL. Empty verb defaults to a GET request. Return a request object which can be used to read the response data.
+    /// Perform an HTTP request to the specified URL. Empty verb defaults to a GET request. The request is queued to the shared HTTP client, which reuses keep-alive connections per host. Return a request object which can be used to read the response data. E_HTTPREQUESTFINISHED is sent when done.
     SharedPtr<HttpRequest> MakeHttpRequest(const String& url, const String& verb = String::EMPTY, const Vector<String>& headers = Vector<String>(), const String& postData = String::EMPTY);
     /// Ban specific IP addresses.
     void BanAddress(const String& address);
@@ -127,6 +128,9 @@ public:
     /// Return the package download cache directory.
     const String& GetPackageCacheDir() const { return packageCacheDir_; }
 
+    /// Return the shared HTTP client for configuring its worker threads and connection pool.
+    HttpClient* GetHttpClient() const { return httpClient_; }
+
     /// Process incoming messages from connections. Called by HandleBeginFrame.
     void Update(float timeStep);
     /// Send outgoing messages after frame logic. Called by HandleRenderUpdate.
@@ -154,6 +158,8 @@ private:
     SharedPtr<Connection> serverConnection_;
     /// Server's client connections.
     HashMap<SLNet::AddressOrGUID, SharedPtr<Connection> > clientConnections_;
+    /// Shared HTTP client.
+    SharedPtr<HttpClient> httpClient_;
     /// Allowed remote events.
     HashSet<StringHash> allowedRemoteEvents_;
     /// Remote event fixed blacklist.
@@ -90,6 +90,13 @@ URHO3D_EVENT(E_NETWORKUPDATESENT, NetworkUpdateSent)
 {
 }
 
+/// Server has acknowledged client controls up to a timestamp. Sent on the client after the scene updates received during the frame have been applied, so that client-side prediction can be reconciled by replaying the still unacknowledged controls.
+URHO3D_EVENT(E_CONTROLSACKNOWLEDGED, ControlsAcknowledged)
+{
+    URHO3D_PARAM(P_CONNECTION, Connection);      // Connection pointer
+    URHO3D_PARAM(P_TIMESTAMP, TimeStamp);        // unsigned (0-255)
+}
+
 /// Scene load failed, either due to file not found or checksum error.
 URHO3D_EVENT(E_NETWORKSCENELOADFAILED, NetworkSceneLoadFailed)
 {
@@ -149,4 +156,10 @@ URHO3D_EVENT(E_NATMASTERDISCONNECTED, NetworkNatMasterDisconnected)
 {
 }
 
+/// HTTP request made through Network::MakeHttpRequest() finished, either closed or in the error state. Any unread response data can still be read from the request.
+URHO3D_EVENT(E_HTTPREQUESTFINISHED, HttpRequestFinished)
+{
+    URHO3D_PARAM(P_REQUEST, Request);   // HttpRequest pointer
+}
+
 }
@@ -42,17 +42,17 @@ static const int MSG_LOADSCENE = 0x8C;
 static const int MSG_SCENECHECKSUMERROR = 0x8D;
 /// Server->client: create new node.
 static const int MSG_CREATENODE = 0x8E;
-/// Server->client: node delta update.
+/// Server->client: node delta update. The node ID is followed by the server time in milliseconds.
 static const int MSG_NODEDELTAUPDATE = 0x8F;
-/// Server->client: node latest data update.
+/// Server->client: node latest data update. The node ID is followed by the server time in milliseconds.
 static const int MSG_NODELATESTDATA = 0x90;
 /// Server->client: remove node.
 static const int MSG_REMOVENODE = 0x91;
 /// Server->client: create new component.
 static const int MSG_CREATECOMPONENT = 0x92;
-/// Server->client: component delta update.
+/// Server->client: component delta update. The component ID is followed by the server time in milliseconds.
 static const int MSG_COMPONENTDELTAUPDATE = 0x93;
-/// Server->client: component latest data update.
+/// Server->client: component latest data update. The component ID is followed by the server time in milliseconds.
 static const int MSG_COMPONENTLATESTDATA = 0x94;
 /// Server->client: remove component.
 static const int MSG_REMOVECOMPONENT = 0x95;
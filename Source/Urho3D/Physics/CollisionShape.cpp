@@ -32,6 +32,8 @@
 #include "../Graphics/Model.h"
 #include "../Graphics/Terrain.h"
 #include "../Graphics/VertexBuffer.h"
+#include "../IO/File.h"
+#include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../Physics/CollisionShape.h"
 #include "../Physics/PhysicsUtils.h"
@@ -49,6 +51,7 @@
 #include <Bullet/BulletCollision/CollisionShapes/btConvexHullShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btCylinderShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <Bullet/BulletCollision/CollisionShapes/btOptimizedBvh.h>
 #include <Bullet/BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btSphereShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
@@ -62,6 +65,10 @@ namespace Urho3D
 
 static const float DEFAULT_COLLISION_MARGIN = 0.04f;
 static const unsigned QUANTIZE_MAX_TRIANGLES = 1000000;
+static const unsigned COLLISION_CACHE_VERSION = 2;
+static const unsigned COLLISION_CACHE_HEADER_SIZE = 5 * sizeof(unsigned) + sizeof(unsigned long long);
+static const unsigned long long FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const unsigned long long FNV_PRIME = 1099511628211ULL;
 
 static const btVector3 WHITE(1.0f, 1.0f, 1.0f);
 static const btVector3 GREEN(0.0f, 1.0f, 0.0f);
@@ -196,13 +203,22 @@ private:
     Vector<SharedArrayPtr<unsigned char> > dataArrays_;
 };
 
-TriangleMeshData::TriangleMeshData(Model* model, unsigned lodLevel)
+/// Return a 16-byte aligned pointer to a buffer allocated with 16 extra bytes, as required by Bullet's in-place BVH serialization.
+static unsigned char* AlignBvhData(unsigned char* data)
+{
+    return reinterpret_cast<unsigned char*>((reinterpret_cast<size_t>(data) + 15) & ~(size_t)15);
+}
+
+TriangleMeshData::TriangleMeshData(Model* model, unsigned lodLevel, bool buildBvh)
 {
     meshInterface_ = new TriangleMeshInterface(model, lodLevel);
-    shape_ = new btBvhTriangleMeshShape(meshInterface_.Get(), meshInterface_->useQuantize_, true);
+    shape_ = new btBvhTriangleMeshShape(meshInterface_.Get(), meshInterface_->useQuantize_, buildBvh);
 
-    infoMap_ = new btTriangleInfoMap();
-    btGenerateInternalEdgeInfo(shape_.Get(), infoMap_.Get());
+    if (buildBvh)
+    {
+        infoMap_ = new btTriangleInfoMap();
+        btGenerateInternalEdgeInfo(shape_.Get(), infoMap_.Get());
+    }
 }
 
 TriangleMeshData::TriangleMeshData(CustomGeometry* custom)
@@ -214,6 +230,79 @@ TriangleMeshData::TriangleMeshData(CustomGeometry* custom)
     btGenerateInternalEdgeInfo(shape_.Get(), infoMap_.Get());
 }
 
+bool TriangleMeshData::LoadCookedData(Deserializer& source)
+{
+    if (!shape_ || shape_->getOptimizedBvh() || source.GetSize() - source.GetPosition() < sizeof(unsigned))
+        return false;
+
+    unsigned bvhSize = source.ReadUInt();
+    if (!bvhSize || bvhSize > source.GetSize() - source.GetPosition())
+        return false;
+
+    // Read the BVH directly into its final buffer, where Bullet fixes up the node arrays in place without copying
+    bvhData_ = new unsigned char[bvhSize + 16];
+    unsigned char* alignedData = AlignBvhData(bvhData_.Get());
+    if (source.Read(alignedData, bvhSize) != bvhSize)
+        return false;
+
+    btOptimizedBvh* bvh = btOptimizedBvh::deSerializeInPlace(alignedData, bvhSize, false);
+    if (!bvh || bvh->isQuantized() != meshInterface_->useQuantize_)
+        return false;
+
+    if (source.GetSize() - source.GetPosition() < sizeof(unsigned))
+        return false;
+    unsigned numInfos = source.ReadUInt();
+    if (numInfos > (source.GetSize() - source.GetPosition()) / (5 * sizeof(unsigned)))
+        return false;
+
+    infoMap_ = new btTriangleInfoMap();
+    for (unsigned i = 0; i < numInfos; ++i)
+    {
+        int key = source.ReadInt();
+        btTriangleInfo info;
+        info.m_flags = source.ReadInt();
+        info.m_edgeV0V1Angle = source.ReadFloat();
+        info.m_edgeV1V2Angle = source.ReadFloat();
+        info.m_edgeV2V0Angle = source.ReadFloat();
+        infoMap_->insert(key, info);
+    }
+
+    shape_->setOptimizedBvh(bvh);
+    shape_->setTriangleInfoMap(infoMap_.Get());
+    return true;
+}
+
+bool TriangleMeshData::SaveCookedData(Serializer& dest) const
+{
+    btOptimizedBvh* bvh = shape_ ? shape_->getOptimizedBvh() : nullptr;
+    if (!bvh || !infoMap_)
+        return false;
+
+    unsigned bvhSize = bvh->calculateSerializeBufferSize();
+    SharedArrayPtr<unsigned char> bvhData(new unsigned char[bvhSize + 16]);
+    unsigned char* alignedData = AlignBvhData(bvhData.Get());
+    if (!bvh->serializeInPlace(alignedData, bvhSize, false))
+        return false;
+
+    bool success = true;
+    success &= dest.WriteUInt(bvhSize);
+    success &= dest.Write(alignedData, bvhSize) == bvhSize;
+
+    auto numInfos = (unsigned)infoMap_->size();
+    success &= dest.WriteUInt(numInfos);
+    for (unsigned i = 0; i < numInfos; ++i)
+    {
+        const btTriangleInfo* info = infoMap_->getAtIndex(i);
+        success &= dest.WriteInt(infoMap_->getKeyAtIndex(i).getUid1());
+        success &= dest.WriteInt(info->m_flags);
+        success &= dest.WriteFloat(info->m_edgeV0V1Angle);
+        success &= dest.WriteFloat(info->m_edgeV1V2Angle);
+        success &= dest.WriteFloat(info->m_edgeV2V0Angle);
+    }
+
+    return success;
+}
+
 GImpactMeshData::GImpactMeshData(Model* model, unsigned lodLevel)
 {
     meshInterface_ = new TriangleMeshInterface(model, lodLevel);
@@ -314,6 +403,43 @@ void ConvexData::BuildHull(const PODVector<Vector3>& vertices)
     }
 }
 
+bool ConvexData::LoadCookedData(Deserializer& source)
+{
+    if (source.GetSize() - source.GetPosition() < sizeof(unsigned))
+        return false;
+    unsigned vertexCount = source.ReadUInt();
+    if (vertexCount > (source.GetSize() - source.GetPosition()) / sizeof(Vector3))
+        return false;
+    vertexData_ = new Vector3[vertexCount];
+    if (source.Read(vertexData_.Get(), vertexCount * sizeof(Vector3)) != vertexCount * sizeof(Vector3))
+        return false;
+
+    if (source.GetSize() - source.GetPosition() < sizeof(unsigned))
+        return false;
+    unsigned indexCount = source.ReadUInt();
+    if (indexCount > (source.GetSize() - source.GetPosition()) / sizeof(unsigned))
+        return false;
+    indexData_ = new unsigned[indexCount];
+    if (source.Read(indexData_.Get(), indexCount * sizeof(unsigned)) != indexCount * sizeof(unsigned))
+        return false;
+
+    vertexCount_ = vertexCount;
+    indexCount_ = indexCount;
+    return true;
+}
+
+bool ConvexData::SaveCookedData(Serializer& dest) const
+{
+    bool success = true;
+    success &= dest.WriteUInt(vertexCount_);
+    if (vertexCount_)
+        success &= dest.Write(vertexData_.Get(), vertexCount_ * sizeof(Vector3)) == vertexCount_ * sizeof(Vector3);
+    success &= dest.WriteUInt(indexCount_);
+    if (indexCount_)
+        success &= dest.Write(indexData_.Get(), indexCount_ * sizeof(unsigned)) == indexCount_ * sizeof(unsigned);
+    return success;
+}
+
 HeightfieldData::HeightfieldData(Terrain* terrain, unsigned lodLevel) :
     heightData_(terrain->GetHeightData()),
     spacing_(terrain->GetSpacing()),
@@ -409,6 +535,152 @@ CollisionGeometryData* CreateCollisionGeometryData(ShapeType shapeType, Model* m
     }
 }
 
+/// Identifies the source data of cached collision geometry. Hash collisions are guarded against by also comparing the sizes.
+struct CollisionGeometryKey
+{
+    /// 64-bit FNV-1a hash of the vertex positions and indices.
+    unsigned long long hash_{FNV_OFFSET_BASIS};
+    /// Vertex and index count of each geometry that contributed to the hash.
+    PODVector<unsigned> counts_;
+};
+
+/// Accumulate bytes to a 64-bit FNV-1a hash.
+static inline void HashBytes(unsigned long long& hash, const unsigned char* data, unsigned size)
+{
+    for (unsigned i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+/// Return the key of the vertex positions and indices that the collision geometry of a model LOD level is built from.
+static CollisionGeometryKey GetCollisionGeometryKey(Model* model, unsigned lodLevel)
+{
+    CollisionGeometryKey key;
+    unsigned long long& hash = key.hash_;
+    unsigned numGeometries = model->GetNumGeometries();
+
+    for (unsigned i = 0; i < numGeometries; ++i)
+    {
+        Geometry* geometry = model->GetGeometry(i, lodLevel);
+        if (!geometry)
+            continue;
+
+        const unsigned char* vertexData;
+        const unsigned char* indexData;
+        unsigned vertexSize;
+        unsigned indexSize;
+        const PODVector<VertexElement>* elements;
+
+        geometry->GetRawData(vertexData, vertexSize, indexData, indexSize, elements);
+        if (!vertexData || !elements || VertexBuffer::GetElementOffset(*elements, TYPE_VECTOR3, SEM_POSITION) != 0)
+            continue;
+
+        // Other vertex elements do not affect collision, so hash only the positions
+        unsigned vertexEnd = geometry->GetVertexStart() + geometry->GetVertexCount();
+        for (unsigned j = geometry->GetVertexStart(); j < vertexEnd; ++j)
+            HashBytes(hash, &vertexData[j * vertexSize], sizeof(Vector3));
+        key.counts_.Push(geometry->GetVertexCount());
+
+        if (indexData)
+        {
+            auto indexSizeByte = (unsigned char)indexSize;
+            HashBytes(hash, &indexSizeByte, 1);
+            HashBytes(hash, &indexData[geometry->GetIndexStart() * indexSize], geometry->GetIndexCount() * indexSize);
+            key.counts_.Push(geometry->GetIndexCount());
+        }
+        else
+            key.counts_.Push(0);
+    }
+
+    return key;
+}
+
+/// Read the header of a collision cache file. Return true if it was written by the same build from the same source geometry.
+static bool ReadCollisionCacheHeader(File& file, const CollisionGeometryKey& key)
+{
+    // The serialized BVH contains pointer-sized fields, so the pointer size is part of the header
+    if (!file.IsOpen() || file.GetSize() < COLLISION_CACHE_HEADER_SIZE || file.ReadFileID() != "UCOL" ||
+        file.ReadUInt() != COLLISION_CACHE_VERSION || file.ReadUInt() != (unsigned)BT_BULLET_VERSION ||
+        file.ReadUInt() != sizeof(void*) || file.ReadUInt64() != key.hash_ || file.ReadUInt() != key.counts_.Size())
+        return false;
+
+    for (unsigned i = 0; i < key.counts_.Size(); ++i)
+    {
+        if (file.ReadUInt() != key.counts_[i])
+            return false;
+    }
+
+    return true;
+}
+
+CollisionGeometryData* CreateCollisionGeometryData(ShapeType shapeType, Model* model, unsigned lodLevel, const String& cacheDir)
+{
+    // GImpact meshes have no precomputed acceleration structure, so only trimeshes and convex hulls are cached
+    if (shapeType != SHAPE_TRIANGLEMESH && shapeType != SHAPE_CONVEXHULL)
+        return CreateCollisionGeometryData(shapeType, model, lodLevel);
+
+    Context* context = model->GetContext();
+    auto* fileSystem = context->GetSubsystem<FileSystem>();
+    CollisionGeometryKey key = GetCollisionGeometryKey(model, lodLevel);
+    String fileName = cacheDir + ToStringHex((unsigned)(key.hash_ >> 32u)) + ToStringHex((unsigned)key.hash_) +
+        (shapeType == SHAPE_TRIANGLEMESH ? ".trimesh" : ".hull");
+
+    if (fileSystem->FileExists(fileName))
+    {
+        File file(context, fileName);
+        if (ReadCollisionCacheHeader(file, key))
+        {
+            if (shapeType == SHAPE_TRIANGLEMESH)
+            {
+                auto* triMesh = new TriangleMeshData(model, lodLevel, false);
+                if (triMesh->LoadCookedData(file))
+                    return triMesh;
+                delete triMesh;
+            }
+            else
+            {
+                auto* convex = new ConvexData();
+                if (convex->LoadCookedData(file))
+                    return convex;
+                delete convex;
+            }
+        }
+
+        URHO3D_LOGDEBUG("Rebuilding outdated or invalid cached collision data " + fileName);
+    }
+
+    CollisionGeometryData* geometry = CreateCollisionGeometryData(shapeType, model, lodLevel);
+
+    if (!fileSystem->DirExists(cacheDir))
+        fileSystem->CreateDir(cacheDir);
+
+    File file(context, fileName, FILE_WRITE);
+    if (file.IsOpen())
+    {
+        bool success = file.WriteFileID("UCOL");
+        success &= file.WriteUInt(COLLISION_CACHE_VERSION);
+        success &= file.WriteUInt(BT_BULLET_VERSION);
+        success &= file.WriteUInt(sizeof(void*));
+        success &= file.WriteUInt64(key.hash_);
+        success &= file.WriteUInt(key.counts_.Size());
+        for (unsigned i = 0; i < key.counts_.Size(); ++i)
+            success &= file.WriteUInt(key.counts_[i]);
+        if (shapeType == SHAPE_TRIANGLEMESH)
+            success &= static_cast<TriangleMeshData*>(geometry)->SaveCookedData(file);
+        else
+            success &= static_cast<ConvexData*>(geometry)->SaveCookedData(file);
+
+        file.Close();
+        // Do not leave a partially written file behind
+        if (!success)
+            fileSystem->Delete(fileName);
+    }
+
+    return geometry;
+}
+
 CollisionGeometryData* CreateCollisionGeometryData(ShapeType shapeType, CustomGeometry* custom)
 {
     switch (shapeType)
@@ -1122,10 +1394,15 @@ void CollisionShape::UpdateCachedGeometryShape(CollisionGeometryDataCache& cache
             geometry_ = cachedGeometry->second_;
         else
         {
-            geometry_ = CreateCollisionGeometryData(shapeType_, model_, lodLevel_);
-            assert(geometry_);
             // Check if model has dynamic buffers, do not cache in that case
-            if (!HasDynamicBuffers(model_, lodLevel_))
+            bool dynamicBuffers = HasDynamicBuffers(model_, lodLevel_);
+            const String& cacheDir = physicsWorld_->GetCollisionCacheDir();
+            if (!dynamicBuffers && !cacheDir.Empty())
+                geometry_ = CreateCollisionGeometryData(shapeType_, model_, lodLevel_, cacheDir);
+            else
+                geometry_ = CreateCollisionGeometryData(shapeType_, model_, lodLevel_);
+            assert(geometry_);
+            if (!dynamicBuffers)
                 cache[id] = geometry_;
         }
 
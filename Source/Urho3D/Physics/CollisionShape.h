@@ -41,10 +41,12 @@ namespace Urho3D
 {
 
 class CustomGeometry;
+class Deserializer;
 class Geometry;
 class Model;
 class PhysicsWorld;
 class RigidBody;
+class Serializer;
 class Terrain;
 class TriangleMeshInterface;
 
@@ -75,13 +77,20 @@ using CollisionGeometryDataCache = HashMap<Pair<Model*, unsigned>, SharedPtr<Col
 /// Triangle mesh geometry data.
 struct TriangleMeshData : public CollisionGeometryData
 {
-    /// Construct from a model.
-    TriangleMeshData(Model* model, unsigned lodLevel);
+    /// Construct from a model. If BVH building is skipped, LoadCookedData() must be called to complete the shape.
+    TriangleMeshData(Model* model, unsigned lodLevel, bool buildBvh = true);
     /// Construct from a custom geometry.
     explicit TriangleMeshData(CustomGeometry* custom);
 
+    /// Load the BVH and triangle info map from the collision data cache. Return true if successful.
+    bool LoadCookedData(Deserializer& source);
+    /// Save the BVH and triangle info map to the collision data cache. Return true if successful.
+    bool SaveCookedData(Serializer& dest) const;
+
     /// Bullet triangle mesh interface.
     UniquePtr<TriangleMeshInterface> meshInterface_;
+    /// Serialized BVH data the shape uses in place, when loaded from the collision data cache.
+    SharedArrayPtr<unsigned char> bvhData_;
     /// Bullet triangle mesh collision shape.
     UniquePtr<btBvhTriangleMeshShape> shape_;
     /// Bullet triangle info map.
@@ -103,6 +112,8 @@ struct GImpactMeshData : public CollisionGeometryData
 /// Convex hull geometry data.
 struct ConvexData : public CollisionGeometryData
 {
+    /// Construct empty, to be filled with LoadCookedData().
+    ConvexData() = default;
     /// Construct from a model.
     ConvexData(Model* model, unsigned lodLevel);
     /// Construct from a custom geometry.
@@ -110,6 +121,10 @@ struct ConvexData : public CollisionGeometryData
 
     /// Build the convex hull from vertices.
     void BuildHull(const PODVector<Vector3>& vertices);
+    /// Load the hull from the collision data cache. Return true if successful.
+    bool LoadCookedData(Deserializer& source);
+    /// Save the hull to the collision data cache. Return true if successful.
+    bool SaveCookedData(Serializer& dest) const;
 
     /// Vertex data.
     SharedArrayPtr<Vector3> vertexData_;
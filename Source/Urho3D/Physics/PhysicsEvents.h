@@ -27,14 +27,14 @@
 namespace Urho3D
 {
 
-/// Physics world is about to be stepped.
+/// Physics world is about to be stepped. The LogicComponent and ScriptInstance fixed updates called directly by the scene have already been executed when this is sent.
 URHO3D_EVENT(E_PHYSICSPRESTEP, PhysicsPreStep)
 {
     URHO3D_PARAM(P_WORLD, World);                  // PhysicsWorld pointer
     URHO3D_PARAM(P_TIMESTEP, TimeStep);            // float
 }
 
-/// Physics world has been stepped.
+/// Physics world has been stepped. The LogicComponent and ScriptInstance fixed post-updates called directly by the scene have already been executed when this is sent.
 URHO3D_EVENT(E_PHYSICSPOSTSTEP, PhysicsPostStep)
 {
     URHO3D_PARAM(P_WORLD, World);                  // PhysicsWorld pointer
@@ -25,8 +25,10 @@
 #include "../Core/Context.h"
 #include "../Core/Mutex.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Model.h"
+#include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../Math/Ray.h"
 #include "../Physics/CollisionShape.h"
@@ -42,6 +44,7 @@
 #include <Bullet/BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <Bullet/BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
 #include <Bullet/BulletCollision/CollisionDispatch/btInternalEdgeUtility.h>
+#include <Bullet/BulletCollision/CollisionDispatch/btSimulationIslandManager.h>
 #include <Bullet/BulletCollision/CollisionShapes/btBoxShape.h>
 #include <Bullet/BulletCollision/CollisionShapes/btSphereShape.h>
 #include <Bullet/BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
@@ -58,6 +61,7 @@ extern const char* SUBSYSTEM_CATEGORY;
 
 static const int MAX_SOLVER_ITERATIONS = 256;
 static const Vector3 DEFAULT_GRAVITY = Vector3(0.0f, -9.81f, 0.0f);
+static const unsigned MIN_QUERIES_PER_WORK_ITEM = 64;
 
 PhysicsWorldConfig PhysicsWorld::config;
 
@@ -66,6 +70,360 @@ static bool CompareRaycastResults(const PhysicsRaycastResult& lhs, const Physics
     return lhs.distance_ < rhs.distance_;
 }
 
+static bool CompareRigidBodyIDs(const RigidBody* lhs, const RigidBody* rhs)
+{
+    return lhs->GetID() < rhs->GetID();
+}
+
+/// Compare rigid bodies by the order in which they were added to the broadphase, which decides the body order of their contact
+/// pairs. Bodies outside the world go last.
+static bool CompareRigidBodyBroadphaseOrder(const RigidBody* lhs, const RigidBody* rhs)
+{
+    const btBroadphaseProxy* lhsProxy = lhs->GetBody() ? lhs->GetBody()->getBroadphaseHandle() : nullptr;
+    const btBroadphaseProxy* rhsProxy = rhs->GetBody() ? rhs->GetBody()->getBroadphaseHandle() : nullptr;
+    if (lhsProxy && rhsProxy)
+        return lhsProxy->m_uniqueId < rhsProxy->m_uniqueId;
+    else if (lhsProxy || rhsProxy)
+        return lhsProxy != nullptr;
+    else
+        return lhs->GetID() < rhs->GetID();
+}
+
+static bool CompareConstraintIDs(btTypedConstraint* lhs, btTypedConstraint* rhs)
+{
+    auto* lhsConstraint = static_cast<Constraint*>(lhs->getUserConstraintPtr());
+    auto* rhsConstraint = static_cast<Constraint*>(rhs->getUserConstraintPtr());
+    return (lhsConstraint ? lhsConstraint->GetID() : M_MAX_UNSIGNED) < (rhsConstraint ? rhsConstraint->GetID() : M_MAX_UNSIGNED);
+}
+
+/// Return a rigid body of the physics world by component ID, or null if not found.
+static RigidBody* GetStateRigidBody(Scene* scene, PhysicsWorld* world, unsigned id)
+{
+    Component* component = scene->GetComponent(id);
+    if (!component || component->GetType() != RigidBody::GetTypeStatic())
+        return nullptr;
+
+    auto* body = static_cast<RigidBody*>(component);
+    return body->GetPhysicsWorld() == world && body->GetBody() ? body : nullptr;
+}
+
+/// Return the rigid bodies of a contact manifold. Return false if either object is not a rigid body in the scene.
+static bool GetManifoldBodies(const btPersistentManifold* manifold, RigidBody*& bodyA, RigidBody*& bodyB)
+{
+    bodyA = static_cast<RigidBody*>(manifold->getBody0()->getUserPointer());
+    bodyB = static_cast<RigidBody*>(manifold->getBody1()->getUserPointer());
+    return bodyA && bodyB && bodyA->GetNode() && bodyB->GetNode();
+}
+
+/// Return the key of a body pair in saved contact manifolds, independent of the body order.
+static Pair<unsigned, unsigned> GetManifoldKey(unsigned idA, unsigned idB)
+{
+    return idA < idB ? MakePair(idA, idB) : MakePair(idB, idA);
+}
+
+/// Return the sort key of a contact manifold in deterministic mode. Manifolds of objects that are not rigid bodies go last.
+static Pair<unsigned, unsigned> GetManifoldSortKey(const btPersistentManifold* manifold)
+{
+    RigidBody* bodyA;
+    RigidBody* bodyB;
+    if (GetManifoldBodies(manifold, bodyA, bodyB))
+        return GetManifoldKey(bodyA->GetID(), bodyB->GetID());
+    else
+        return MakePair(M_MAX_UNSIGNED, M_MAX_UNSIGNED);
+}
+
+/// Sort the contact manifolds of a dispatcher by their body IDs. Manifolds of the same body pair keep their relative order.
+static void SortManifolds(btDispatcher* dispatcher)
+{
+    // The manifolds are still sorted from the previous step except for the ones created or removed since, so an insertion
+    // sort is close to linear
+    btPersistentManifold** manifolds = dispatcher->getInternalManifoldPointer();
+    int numManifolds = dispatcher->getNumManifolds();
+    for (int i = 1; i < numManifolds; ++i)
+    {
+        btPersistentManifold* manifold = manifolds[i];
+        Pair<unsigned, unsigned> key = GetManifoldSortKey(manifold);
+        int j = i;
+        while (j > 0 && key < GetManifoldSortKey(manifolds[j - 1]))
+        {
+            manifolds[j] = manifolds[j - 1];
+            --j;
+        }
+        manifolds[j] = manifold;
+    }
+
+    for (int i = 0; i < numManifolds; ++i)
+        manifolds[i]->m_index1a = i;
+}
+
+/// Bullet dynamics world which can solve the constraints in a canonical order for deterministic simulation.
+class PhysicsDynamicsWorld : public btDiscreteDynamicsWorld
+{
+public:
+    /// Construct.
+    PhysicsDynamicsWorld(PhysicsWorld* owner, btDispatcher* dispatcher, btBroadphaseInterface* broadphase,
+        btConstraintSolver* solver, btCollisionConfiguration* collisionConfiguration) :
+        btDiscreteDynamicsWorld(dispatcher, broadphase, solver, collisionConfiguration),
+        owner_(owner)
+    {
+    }
+
+    /// Solve the constraints. In deterministic mode the order of the contact manifolds and of the island indices depends on
+    /// the history of the broadphase pair cache, which a restored state does not have. Sort the manifolds by body IDs and the
+    /// joints by component ID instead, and solve all islands at once so that their order does not matter.
+    void solveConstraints(btContactSolverInfo& solverInfo) override
+    {
+        if (!owner_->IsDeterministic())
+        {
+            btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+            return;
+        }
+
+        SortManifolds(m_dispatcher1);
+
+        m_sortedConstraints.resize(m_constraints.size());
+        for (int i = 0; i < m_constraints.size(); ++i)
+            m_sortedConstraints[i] = m_constraints[i];
+        if (m_sortedConstraints.size())
+        {
+            Sort(RandomAccessIterator<btTypedConstraint*>(&m_sortedConstraints[0]),
+                RandomAccessIterator<btTypedConstraint*>(&m_sortedConstraints[0] + m_sortedConstraints.size()), CompareConstraintIDs);
+        }
+
+        m_constraintSolver->prepareSolve(getNumCollisionObjects(), m_dispatcher1->getNumManifolds());
+        // Build the islands only for the activation states
+        m_islandManager->buildIslands(m_dispatcher1, this);
+        if (m_collisionObjects.size())
+        {
+            m_constraintSolver->solveGroup(&m_collisionObjects[0], m_collisionObjects.size(),
+                m_dispatcher1->getInternalManifoldPointer(), m_dispatcher1->getNumManifolds(),
+                m_sortedConstraints.size() ? &m_sortedConstraints[0] : nullptr, m_sortedConstraints.size(), solverInfo,
+                m_debugDrawer, m_dispatcher1);
+        }
+        m_constraintSolver->allSolved(solverInfo, m_debugDrawer);
+    }
+
+private:
+    /// Physics world component.
+    PhysicsWorld* owner_;
+};
+
+/// Write a contact point of a manifold, including the impulses used to warm-start the solver.
+static void WriteManifoldPoint(Serializer& dest, const btManifoldPoint& point)
+{
+    dest.WriteVector3(ToVector3(point.m_localPointA));
+    dest.WriteVector3(ToVector3(point.m_localPointB));
+    dest.WriteVector3(ToVector3(point.m_positionWorldOnA));
+    dest.WriteVector3(ToVector3(point.m_positionWorldOnB));
+    dest.WriteVector3(ToVector3(point.m_normalWorldOnB));
+    dest.WriteFloat(point.m_distance1);
+    dest.WriteFloat(point.m_combinedFriction);
+    dest.WriteFloat(point.m_combinedRollingFriction);
+    dest.WriteFloat(point.m_combinedSpinningFriction);
+    dest.WriteFloat(point.m_combinedRestitution);
+    dest.WriteInt(point.m_partId0);
+    dest.WriteInt(point.m_partId1);
+    dest.WriteInt(point.m_index0);
+    dest.WriteInt(point.m_index1);
+    dest.WriteInt(point.m_contactPointFlags);
+    dest.WriteFloat(point.m_appliedImpulse);
+    dest.WriteFloat(point.m_appliedImpulseLateral1);
+    dest.WriteFloat(point.m_appliedImpulseLateral2);
+    dest.WriteFloat(point.m_contactMotion1);
+    dest.WriteFloat(point.m_contactMotion2);
+    dest.WriteFloat(point.m_contactCFM);
+    dest.WriteFloat(point.m_contactERP);
+    dest.WriteFloat(point.m_frictionCFM);
+    dest.WriteInt(point.m_lifeTime);
+    dest.WriteVector3(ToVector3(point.m_lateralFrictionDir1));
+    dest.WriteVector3(ToVector3(point.m_lateralFrictionDir2));
+}
+
+/// Read a contact point of a manifold. When flipped, the manifold has its bodies in the opposite order than when saved.
+static void ReadManifoldPoint(Deserializer& source, btManifoldPoint& point, bool flip)
+{
+    point.m_localPointA = ToBtVector3(source.ReadVector3());
+    point.m_localPointB = ToBtVector3(source.ReadVector3());
+    point.m_positionWorldOnA = ToBtVector3(source.ReadVector3());
+    point.m_positionWorldOnB = ToBtVector3(source.ReadVector3());
+    point.m_normalWorldOnB = ToBtVector3(source.ReadVector3());
+    point.m_distance1 = source.ReadFloat();
+    point.m_combinedFriction = source.ReadFloat();
+    point.m_combinedRollingFriction = source.ReadFloat();
+    point.m_combinedSpinningFriction = source.ReadFloat();
+    point.m_combinedRestitution = source.ReadFloat();
+    point.m_partId0 = source.ReadInt();
+    point.m_partId1 = source.ReadInt();
+    point.m_index0 = source.ReadInt();
+    point.m_index1 = source.ReadInt();
+    point.m_userPersistentData = nullptr;
+    point.m_contactPointFlags = source.ReadInt();
+    point.m_appliedImpulse = source.ReadFloat();
+    point.m_appliedImpulseLateral1 = source.ReadFloat();
+    point.m_appliedImpulseLateral2 = source.ReadFloat();
+    point.m_contactMotion1 = source.ReadFloat();
+    point.m_contactMotion2 = source.ReadFloat();
+    point.m_contactCFM = source.ReadFloat();
+    point.m_contactERP = source.ReadFloat();
+    point.m_frictionCFM = source.ReadFloat();
+    point.m_lifeTime = source.ReadInt();
+    point.m_lateralFrictionDir1 = ToBtVector3(source.ReadVector3());
+    point.m_lateralFrictionDir2 = ToBtVector3(source.ReadVector3());
+
+    // The impulses act on the bodies in the opposite directions, so they stay the same when the directions are negated
+    if (flip)
+    {
+        btSwap(point.m_localPointA, point.m_localPointB);
+        btSwap(point.m_positionWorldOnA, point.m_positionWorldOnB);
+        btSwap(point.m_partId0, point.m_partId1);
+        btSwap(point.m_index0, point.m_index1);
+        point.m_normalWorldOnB = -point.m_normalWorldOnB;
+        point.m_lateralFrictionDir1 = -point.m_lateralFrictionDir1;
+        point.m_lateralFrictionDir2 = -point.m_lateralFrictionDir2;
+    }
+}
+
+/// Return whether a broadphase proxy passes the collision filter used by the world queries.
+static inline bool QueryNeedsCollision(const btBroadphaseProxy* proxy, unsigned collisionMask)
+{
+    return (proxy->m_collisionFilterGroup & (short)collisionMask) != 0 && (proxy->m_collisionFilterMask & (short)0xffff) != 0;
+}
+
+/// Broadphase leaf callback for batched ray and sweep queries.
+struct BatchCastCallback : public btDbvt::ICollide
+{
+    /// Test the ray or sweep against the collision object of a leaf.
+    void Process(const btDbvtNode* leaf) override
+    {
+        auto* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+        if (!QueryNeedsCollision(proxy, collisionMask_))
+            return;
+
+        auto* object = static_cast<btCollisionObject*>(proxy->m_clientObject);
+        if (castShape_)
+        {
+            btCollisionWorld::objectQuerySingle(castShape_, from_, to_, object, object->getCollisionShape(),
+                object->getWorldTransform(), *convexCallback_, 0.0f);
+        }
+        else
+        {
+            btCollisionWorld::rayTestSingle(from_, to_, object, object->getCollisionShape(), object->getWorldTransform(),
+                *rayCallback_);
+        }
+    }
+
+    /// Traverse both broadphase trees along the segment, with the leaf volumes expanded by the cast shape's bounds.
+    void Traverse(const btDbvtBroadphase* broadphase, const btVector3& aabbMin, const btVector3& aabbMax)
+    {
+        btVector3 direction = to_.getOrigin() - from_.getOrigin();
+        btVector3 normalizedDirection = direction.normalized();
+        btVector3 directionInverse;
+        unsigned signs[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            directionInverse[i] = normalizedDirection[i] == 0.0f ? BT_LARGE_FLOAT : 1.0f / normalizedDirection[i];
+            signs[i] = directionInverse[i] < 0.0f;
+        }
+        btScalar lambdaMax = normalizedDirection.dot(direction);
+
+        for (int i = 0; i < 2; ++i)
+        {
+            broadphase->m_sets[i].rayTestInternal(broadphase->m_sets[i].m_root, from_.getOrigin(), to_.getOrigin(),
+                directionInverse, signs, lambdaMax, aabbMin, aabbMax, stack_, *this);
+        }
+    }
+
+    /// Start transform.
+    btTransform from_;
+    /// End transform.
+    btTransform to_;
+    /// Swept shape, or null for a raycast.
+    const btConvexShape* castShape_{};
+    /// Raycast result callback.
+    btCollisionWorld::RayResultCallback* rayCallback_{};
+    /// Sweep result callback.
+    btCollisionWorld::ConvexResultCallback* convexCallback_{};
+    /// Collision mask.
+    unsigned collisionMask_{};
+    /// Traversal stack, reused between the queries of one work item.
+    btAlignedObjectArray<const btDbvtNode*> stack_;
+};
+
+/// Broadphase leaf callback for batched overlap queries.
+struct BatchOverlapCallback : public btDbvt::ICollide
+{
+    /// Construct.
+    BatchOverlapCallback(PODVector<RigidBody*>& result, const btVector3& aabbMin, const btVector3& aabbMax,
+        unsigned collisionMask) :
+        result_(result),
+        aabbMin_(aabbMin),
+        aabbMax_(aabbMax),
+        collisionMask_(collisionMask)
+    {
+    }
+
+    /// Add the body of a leaf if its exact bounding box overlaps. The tree volumes of dynamic objects are enlarged.
+    void Process(const btDbvtNode* leaf) override
+    {
+        auto* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+        if (!TestAabbAgainstAabb2(proxy->m_aabbMin, proxy->m_aabbMax, aabbMin_, aabbMax_))
+            return;
+
+        auto* body = static_cast<RigidBody*>(static_cast<btCollisionObject*>(proxy->m_clientObject)->getUserPointer());
+        if (body && (body->GetCollisionLayer() & collisionMask_))
+            result_.Push(body);
+    }
+
+    /// Result bodies.
+    PODVector<RigidBody*>& result_;
+    /// Query box minimum.
+    btVector3 aabbMin_;
+    /// Query box maximum.
+    btVector3 aabbMax_;
+    /// Collision mask.
+    unsigned collisionMask_;
+};
+
+/// Shared state of a batched raycast.
+struct RaycastBatchData
+{
+    /// Physics world.
+    const PhysicsWorld* world_;
+    /// First query of the batch.
+    const PhysicsRaycastQuery* queries_;
+    /// First result of the batch.
+    PhysicsRaycastResult* results_;
+};
+
+/// Per work item state of a batched overlap query.
+struct OverlapBatchData
+{
+    /// Physics world.
+    const PhysicsWorld* world_;
+    /// Result counts for the work item's queries.
+    unsigned* counts_;
+    /// Result bodies for the work item's queries.
+    PODVector<RigidBody*> bodies_;
+};
+
+void RaycastBatchWork(const WorkItem* item, unsigned threadIndex)
+{
+    const RaycastBatchData& data = *(reinterpret_cast<RaycastBatchData*>(item->aux_));
+    auto* start = reinterpret_cast<const PhysicsRaycastQuery*>(item->start_);
+    auto* end = reinterpret_cast<const PhysicsRaycastQuery*>(item->end_);
+
+    data.world_->ProcessRaycastBatch(start, end, data.results_ + (start - data.queries_));
+}
+
+void OverlapBatchWork(const WorkItem* item, unsigned threadIndex)
+{
+    auto* data = reinterpret_cast<OverlapBatchData*>(item->aux_);
+    auto* start = reinterpret_cast<const PhysicsOverlapQuery*>(item->start_);
+    auto* end = reinterpret_cast<const PhysicsOverlapQuery*>(item->end_);
+
+    data->world_->ProcessOverlapBatch(start, end, data->bodies_, data->counts_);
+}
+
 void InternalPreTickCallback(btDynamicsWorld* world, btScalar timeStep)
 {
     static_cast<PhysicsWorld*>(world->getWorldUserInfo())->PreStep(timeStep);
@@ -161,7 +519,7 @@ PhysicsWorld::PhysicsWorld(Context* context) :
 
     broadphase_ = new btDbvtBroadphase();
     solver_ = new btSequentialImpulseConstraintSolver();
-    world_ = new btDiscreteDynamicsWorld(collisionDispatcher_.Get(), broadphase_.Get(), solver_.Get(), collisionConfiguration_);
+    world_ = new PhysicsDynamicsWorld(this, collisionDispatcher_.Get(), broadphase_.Get(), solver_.Get(), collisionConfiguration_);
 
     world_->setGravity(ToBtVector3(DEFAULT_GRAVITY));
     world_->getDispatchInfo().m_useContinuous = true;
@@ -208,6 +566,7 @@ void PhysicsWorld::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Solver Iterations", GetNumIterations, SetNumIterations, int, 10, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Net Max Angular Vel.", float, maxNetworkAngularVelocity_, DEFAULT_MAX_NETWORK_ANGULAR_VELOCITY, AM_DEFAULT);
     URHO3D_ATTRIBUTE("Interpolation", bool, interpolation_, true, AM_FILE);
+    URHO3D_ATTRIBUTE("Deterministic", bool, deterministic_, false, AM_FILE);
     URHO3D_ATTRIBUTE("Internal Edge Utility", bool, internalEdge_, true, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Split Impulse", GetSplitImpulse, SetSplitImpulse, bool, false, AM_DEFAULT);
 }
@@ -259,7 +618,7 @@ void PhysicsWorld::Update(float timeStep)
 
     float internalTimeStep = 1.0f / fps_;
     int maxSubSteps = (int)(timeStep * fps_) + 1;
-    if (maxSubSteps_ < 0)
+    if (maxSubSteps_ < 0 && !deterministic_)
     {
         internalTimeStep = timeStep;
         maxSubSteps = 1;
@@ -270,7 +629,7 @@ void PhysicsWorld::Update(float timeStep)
     delayedWorldTransforms_.Clear();
     simulating_ = true;
 
-    if (interpolation_)
+    if (interpolation_ && !deterministic_)
         world_->stepSimulation(timeStep, maxSubSteps, internalTimeStep);
     else
     {
@@ -285,7 +644,28 @@ void PhysicsWorld::Update(float timeStep)
 
     simulating_ = false;
 
-    // Apply delayed (parented) world transforms now
+    ApplyDelayedWorldTransforms();
+}
+
+void PhysicsWorld::Simulate(unsigned numSteps)
+{
+    URHO3D_PROFILE(SimulatePhysics);
+
+    float internalTimeStep = 1.0f / fps_;
+
+    delayedWorldTransforms_.Clear();
+    simulating_ = true;
+
+    for (unsigned i = 0; i < numSteps; ++i)
+        world_->stepSimulation(internalTimeStep, 0, internalTimeStep);
+
+    simulating_ = false;
+
+    ApplyDelayedWorldTransforms();
+}
+
+void PhysicsWorld::ApplyDelayedWorldTransforms()
+{
     while (!delayedWorldTransforms_.Empty())
     {
         for (HashMap<RigidBody*, DelayedWorldTransform>::Iterator i = delayedWorldTransforms_.Begin();
@@ -369,6 +749,356 @@ void PhysicsWorld::SetMaxNetworkAngularVelocity(float velocity)
     MarkNetworkUpdate();
 }
 
+void PhysicsWorld::SetCollisionCacheDir(const String& path)
+{
+    String trimmedPath = path.Trimmed();
+    collisionCacheDir_ = trimmedPath.Length() ? AddTrailingSlash(trimmedPath) : String::EMPTY;
+}
+
+void PhysicsWorld::SetDeterministic(bool enable)
+{
+    deterministic_ = enable;
+}
+
+void PhysicsWorld::AddStateNode(Node* node)
+{
+    if (node && !stateNodes_.Contains(WeakPtr<Node>(node)))
+        stateNodes_.Push(WeakPtr<Node>(node));
+}
+
+void PhysicsWorld::RemoveStateNode(Node* node)
+{
+    stateNodes_.Remove(WeakPtr<Node>(node));
+}
+
+void PhysicsWorld::AddStateComponent(Component* component)
+{
+    if (component && !stateComponents_.Contains(WeakPtr<Component>(component)))
+        stateComponents_.Push(WeakPtr<Component>(component));
+}
+
+void PhysicsWorld::RemoveStateComponent(Component* component)
+{
+    stateComponents_.Remove(WeakPtr<Component>(component));
+}
+
+void PhysicsWorld::SaveState(VectorBuffer& dest)
+{
+    if (simulating_)
+    {
+        URHO3D_LOGERROR("Can not save physics state during simulation");
+        return;
+    }
+
+    URHO3D_PROFILE(SavePhysicsState);
+
+    dest.Clear();
+    dest.WriteFloat(timeAcc_);
+
+    // Write the bodies in the order they were added to the broadphase, which decides the body order of their contact pairs,
+    // so that restoring can add them back in the same order
+    PODVector<RigidBody*> bodies;
+    for (unsigned i = 0; i < rigidBodies_.Size(); ++i)
+    {
+        if (rigidBodies_[i]->GetNode() && rigidBodies_[i]->GetBody())
+            bodies.Push(rigidBodies_[i]);
+    }
+    Sort(bodies.Begin(), bodies.End(), CompareRigidBodyBroadphaseOrder);
+    dest.WriteVLE(bodies.Size());
+    for (unsigned i = 0; i < bodies.Size(); ++i)
+    {
+        dest.WriteUInt(bodies[i]->GetID());
+        bodies[i]->SaveState(dest);
+    }
+
+    for (Vector<WeakPtr<Node> >::Iterator i = stateNodes_.Begin(); i != stateNodes_.End();)
+    {
+        if (*i)
+            ++i;
+        else
+            i = stateNodes_.Erase(i);
+    }
+    dest.WriteVLE(stateNodes_.Size());
+    for (unsigned i = 0; i < stateNodes_.Size(); ++i)
+    {
+        Node* node = stateNodes_[i];
+        dest.WriteUInt(node->GetID());
+        dest.WriteVector3(node->GetPosition());
+        dest.WriteQuaternion(node->GetRotation());
+        dest.WriteVector3(node->GetScale());
+    }
+
+    for (Vector<WeakPtr<Component> >::Iterator i = stateComponents_.Begin(); i != stateComponents_.End();)
+    {
+        if (*i)
+            ++i;
+        else
+            i = stateComponents_.Erase(i);
+    }
+    dest.WriteVLE(stateComponents_.Size());
+    for (unsigned i = 0; i < stateComponents_.Size(); ++i)
+    {
+        Component* component = stateComponents_[i];
+        dest.WriteUInt(component->GetID());
+        // Write the attributes only, without the type and ID written by Component::Save()
+        component->Serializable::Save(dest);
+    }
+
+    // Write the ongoing collisions, so that collision start and end events are also the same after restoring
+    unsigned numCollisions = 0;
+    for (HashMap<Pair<WeakPtr<RigidBody>, WeakPtr<RigidBody> >, ManifoldPair>::ConstIterator i = previousCollisions_.Begin();
+         i != previousCollisions_.End(); ++i)
+    {
+        if (i->first_.first_ && i->first_.second_)
+            ++numCollisions;
+    }
+    dest.WriteVLE(numCollisions);
+    for (HashMap<Pair<WeakPtr<RigidBody>, WeakPtr<RigidBody> >, ManifoldPair>::ConstIterator i = previousCollisions_.Begin();
+         i != previousCollisions_.End(); ++i)
+    {
+        if (i->first_.first_ && i->first_.second_)
+        {
+            dest.WriteUInt(i->first_.first_->GetID());
+            dest.WriteUInt(i->first_.second_->GetID());
+        }
+    }
+
+    // Write the contact manifolds in the dispatcher order, as the solver processes their constraints in that order, and
+    // their contact points, so that the solver is warm-started the same way after restoring. A body pair may have several
+    // manifolds with compound shapes, so identify them also by their order among the manifolds of the pair
+    int numManifolds = collisionDispatcher_->getNumManifolds();
+    unsigned numStateManifolds = 0;
+    for (int i = 0; i < numManifolds; ++i)
+    {
+        RigidBody* bodyA;
+        RigidBody* bodyB;
+        if (GetManifoldBodies(collisionDispatcher_->getManifoldByIndexInternal(i), bodyA, bodyB))
+            ++numStateManifolds;
+    }
+    dest.WriteVLE(numStateManifolds);
+    HashMap<Pair<unsigned, unsigned>, unsigned> manifoldIndices;
+    for (int i = 0; i < numManifolds; ++i)
+    {
+        btPersistentManifold* manifold = collisionDispatcher_->getManifoldByIndexInternal(i);
+        RigidBody* bodyA;
+        RigidBody* bodyB;
+        if (!GetManifoldBodies(manifold, bodyA, bodyB))
+            continue;
+
+        unsigned index = manifoldIndices[GetManifoldKey(bodyA->GetID(), bodyB->GetID())]++;
+        dest.WriteUInt(bodyA->GetID());
+        dest.WriteUInt(bodyB->GetID());
+        dest.WriteVLE(index);
+        dest.WriteUByte((unsigned char)manifold->getNumContacts());
+        for (int j = 0; j < manifold->getNumContacts(); ++j)
+            WriteManifoldPoint(dest, manifold->getContactPoint(j));
+    }
+}
+
+bool PhysicsWorld::RestoreState(Deserializer& source)
+{
+    if (simulating_)
+    {
+        URHO3D_LOGERROR("Can not restore physics state during simulation");
+        return false;
+    }
+
+    Scene* scene = GetScene();
+    if (!scene)
+        return false;
+
+    URHO3D_PROFILE(RestorePhysicsState);
+
+    timeAcc_ = source.ReadFloat();
+    bool success = true;
+
+    unsigned numBodies = source.ReadVLE();
+    PODVector<RigidBody*> bodyOrder;
+    for (unsigned i = 0; i < numBodies && success; ++i)
+    {
+        unsigned id = source.ReadUInt();
+        RigidBody* body = GetStateRigidBody(scene, this, id);
+        if (!body)
+        {
+            URHO3D_LOGERROR("Rigid body " + String(id) + " of physics state not found");
+            success = false;
+        }
+        else
+        {
+            body->RestoreState(source);
+            bodyOrder.Push(body);
+        }
+    }
+
+    if (success)
+    {
+        // The bodies already have their exact state, so do not let node transform changes apply back to them
+        SetApplyingTransforms(true);
+        unsigned numNodes = source.ReadVLE();
+        for (unsigned i = 0; i < numNodes && success; ++i)
+        {
+            unsigned id = source.ReadUInt();
+            Vector3 position = source.ReadVector3();
+            Quaternion rotation = source.ReadQuaternion();
+            Vector3 scale = source.ReadVector3();
+            Node* node = scene->GetNode(id);
+            if (!node)
+            {
+                URHO3D_LOGERROR("Node " + String(id) + " of physics state not found");
+                success = false;
+            }
+            else
+                node->SetTransform(position, rotation, scale);
+        }
+        SetApplyingTransforms(false);
+    }
+
+    if (success)
+    {
+        unsigned numComponents = source.ReadVLE();
+        for (unsigned i = 0; i < numComponents && success; ++i)
+        {
+            unsigned id = source.ReadUInt();
+            Component* component = scene->GetComponent(id);
+            if (!component)
+            {
+                URHO3D_LOGERROR("Component " + String(id) + " of physics state not found");
+                success = false;
+            }
+            else if (component->Load(source))
+                component->ApplyAttributes();
+            else
+                success = false;
+        }
+    }
+
+    if (success)
+    {
+        previousCollisions_.Clear();
+        unsigned numCollisions = source.ReadVLE();
+        for (unsigned i = 0; i < numCollisions; ++i)
+        {
+            RigidBody* bodyA = GetStateRigidBody(scene, this, source.ReadUInt());
+            RigidBody* bodyB = GetStateRigidBody(scene, this, source.ReadUInt());
+            if (bodyA && bodyB)
+                previousCollisions_[MakePair(WeakPtr<RigidBody>(bodyA), WeakPtr<RigidBody>(bodyB))] = ManifoldPair();
+        }
+        currentCollisions_ = previousCollisions_;
+    }
+
+    ResetSimulationCaches(bodyOrder);
+    if (success)
+        RestoreContactPoints(source);
+
+    return success;
+}
+
+void PhysicsWorld::ResetSimulationCaches(const PODVector<RigidBody*>& bodyOrder)
+{
+    HashSet<RigidBody*> removedBodies;
+    for (unsigned i = 0; i < rigidBodies_.Size(); ++i)
+    {
+        btRigidBody* body = rigidBodies_[i]->GetBody();
+        if (body && body->getBroadphaseHandle())
+        {
+            world_->removeRigidBody(body);
+            removedBodies.Insert(rigidBodies_[i]);
+        }
+    }
+
+    // The broadphase is only reset if it is now empty, which is not the case if objects were added to the Bullet world
+    // directly. The pair and object order then depend on the history, and replays are not guaranteed to be identical
+    broadphase_->resetPool(collisionDispatcher_.Get());
+    solver_->reset();
+
+    // Add the bodies of the state back in the saved order, so that their contact pairs have the same body order as when
+    // saving, followed by the bodies created after saving in ID order
+    PODVector<RigidBody*> bodies;
+    for (unsigned i = 0; i < bodyOrder.Size(); ++i)
+    {
+        if (removedBodies.Erase(bodyOrder[i]))
+            bodies.Push(bodyOrder[i]);
+    }
+    PODVector<RigidBody*> otherBodies;
+    for (HashSet<RigidBody*>::ConstIterator i = removedBodies.Begin(); i != removedBodies.End(); ++i)
+        otherBodies.Push(*i);
+    Sort(otherBodies.Begin(), otherBodies.End(), CompareRigidBodyIDs);
+    bodies.Push(otherBodies);
+    for (unsigned i = 0; i < bodies.Size(); ++i)
+    {
+        RigidBody* body = bodies[i];
+        world_->addRigidBody(body->GetBody(), (short)body->GetCollisionLayer(), (short)body->GetCollisionMask());
+    }
+}
+
+void PhysicsWorld::RestoreContactPoints(Deserializer& source)
+{
+    // Create the overlapping pairs and their manifolds in the rebuilt broadphase, then clear the contact points found for
+    // the current transforms, as only the saved ones existed when the state was saved
+    world_->performDiscreteCollisionDetection();
+
+    HashMap<Pair<unsigned, unsigned>, PODVector<btPersistentManifold*> > manifolds;
+    int numManifolds = collisionDispatcher_->getNumManifolds();
+    for (int i = 0; i < numManifolds; ++i)
+    {
+        btPersistentManifold* manifold = collisionDispatcher_->getManifoldByIndexInternal(i);
+        manifold->clearManifold();
+
+        RigidBody* bodyA;
+        RigidBody* bodyB;
+        if (GetManifoldBodies(manifold, bodyA, bodyB))
+            manifolds[GetManifoldKey(bodyA->GetID(), bodyB->GetID())].Push(manifold);
+    }
+
+    PODVector<btPersistentManifold*> orderedManifolds;
+    HashSet<btPersistentManifold*> restoredManifolds;
+    unsigned numStateManifolds = source.ReadVLE();
+    for (unsigned i = 0; i < numStateManifolds; ++i)
+    {
+        unsigned idA = source.ReadUInt();
+        unsigned idB = source.ReadUInt();
+        unsigned index = source.ReadVLE();
+        unsigned numContacts = source.ReadUByte();
+
+        // A manifold that no longer exists, for example because the collision shapes changed, loses its contact points
+        btPersistentManifold* manifold = nullptr;
+        HashMap<Pair<unsigned, unsigned>, PODVector<btPersistentManifold*> >::ConstIterator j =
+            manifolds.Find(GetManifoldKey(idA, idB));
+        if (j != manifolds.End() && index < j->second_.Size())
+            manifold = j->second_[index];
+        bool flip = manifold && static_cast<RigidBody*>(manifold->getBody0()->getUserPointer())->GetID() != idA;
+
+        for (unsigned k = 0; k < numContacts; ++k)
+        {
+            btManifoldPoint point;
+            ReadManifoldPoint(source, point, flip);
+            if (manifold && k < MANIFOLD_CACHE_SIZE)
+                manifold->getContactPoint(k) = point;
+        }
+        bool restored = true;
+        if (manifold)
+            restoredManifolds.Insert(manifold, restored);
+        if (!restored)
+        {
+            manifold->setNumContacts(Min(numContacts, (unsigned)MANIFOLD_CACHE_SIZE));
+            orderedManifolds.Push(manifold);
+        }
+    }
+
+    // Put the restored manifolds in the saved order, followed by the ones that did not exist when saving
+    btPersistentManifold** manifoldArray = collisionDispatcher_->getInternalManifoldPointer();
+    for (int i = 0; i < numManifolds; ++i)
+    {
+        if (!restoredManifolds.Contains(manifoldArray[i]))
+            orderedManifolds.Push(manifoldArray[i]);
+    }
+    for (int i = 0; i < numManifolds; ++i)
+    {
+        manifoldArray[i] = orderedManifolds[i];
+        manifoldArray[i]->m_index1a = i;
+    }
+}
+
 void PhysicsWorld::Raycast(PODVector<PhysicsRaycastResult>& result, const Ray& ray, float maxDistance, unsigned collisionMask)
 {
     URHO3D_PROFILE(PhysicsRaycast);
@@ -611,6 +1341,106 @@ void PhysicsWorld::ConvexCast(PhysicsRaycastResult& result, btCollisionShape* sh
     }
 }
 
+void PhysicsWorld::RaycastBatch(PODVector<PhysicsRaycastResult>& result, const PODVector<PhysicsRaycastQuery>& queries)
+{
+    URHO3D_PROFILE(PhysicsRaycastBatch);
+
+    result.Resize(queries.Size());
+    if (queries.Empty())
+        return;
+
+    RaycastBatchData data;
+    data.world_ = this;
+    data.queries_ = queries.Buffer();
+    data.results_ = result.Buffer();
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    unsigned numWorkItems = queue ? Min(queue->GetNumThreads() + 1, queries.Size() / MIN_QUERIES_PER_WORK_ITEM) : 0;
+
+    if (numWorkItems <= 1)
+    {
+        ProcessRaycastBatch(data.queries_, data.queries_ + queries.Size(), data.results_);
+        return;
+    }
+
+    unsigned queriesPerItem = queries.Size() / numWorkItems;
+    const PhysicsRaycastQuery* start = data.queries_;
+
+    for (unsigned i = 0; i < numWorkItems; ++i)
+    {
+        const PhysicsRaycastQuery* end = i < numWorkItems - 1 ? start + queriesPerItem : data.queries_ + queries.Size();
+
+        SharedPtr<WorkItem> item = queue->GetFreeItem();
+        item->priority_ = M_MAX_UNSIGNED;
+        item->workFunction_ = RaycastBatchWork;
+        item->aux_ = &data;
+        item->start_ = (void*)start;
+        item->end_ = (void*)end;
+        queue->AddWorkItem(item);
+
+        start = end;
+    }
+
+    queue->Complete(M_MAX_UNSIGNED);
+}
+
+void PhysicsWorld::GetRigidBodiesBatch(PODVector<RigidBody*>& result, PODVector<unsigned>& offsets,
+    const PODVector<PhysicsOverlapQuery>& queries)
+{
+    URHO3D_PROFILE(PhysicsOverlapBatch);
+
+    result.Clear();
+    offsets.Resize(queries.Size() + 1);
+    if (queries.Empty())
+    {
+        offsets[0] = 0;
+        return;
+    }
+
+    // Store the per-query counts shifted by one, so that they can be turned into offsets in place
+    const PhysicsOverlapQuery* queryData = queries.Buffer();
+    unsigned* counts = offsets.Buffer() + 1;
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    unsigned numWorkItems = queue ? Min(queue->GetNumThreads() + 1, queries.Size() / MIN_QUERIES_PER_WORK_ITEM) : 0;
+
+    if (numWorkItems <= 1)
+        ProcessOverlapBatch(queryData, queryData + queries.Size(), result, counts);
+    else
+    {
+        Vector<OverlapBatchData> itemData(numWorkItems);
+        unsigned queriesPerItem = queries.Size() / numWorkItems;
+        const PhysicsOverlapQuery* start = queryData;
+
+        for (unsigned i = 0; i < numWorkItems; ++i)
+        {
+            const PhysicsOverlapQuery* end = i < numWorkItems - 1 ? start + queriesPerItem : queryData + queries.Size();
+            itemData[i].world_ = this;
+            itemData[i].counts_ = counts + (start - queryData);
+
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = OverlapBatchWork;
+            item->aux_ = &itemData[i];
+            item->start_ = (void*)start;
+            item->end_ = (void*)end;
+            queue->AddWorkItem(item);
+
+            start = end;
+        }
+
+        queue->Complete(M_MAX_UNSIGNED);
+
+        // Work items cover consecutive query ranges, so concatenating keeps the results in query order
+        for (unsigned i = 0; i < numWorkItems; ++i)
+            result.Push(itemData[i].bodies_);
+    }
+
+    offsets[0] = 0;
+    for (unsigned i = 1; i < offsets.Size(); ++i)
+        offsets[i] += offsets[i - 1];
+}
+
 void PhysicsWorld::RemoveCachedGeometry(Model* model)
 {
     RemoveCachedGeometryImpl(triMeshCache_, model);
@@ -799,6 +1629,10 @@ void PhysicsWorld::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap&
 
 void PhysicsWorld::PreStep(float timeStep)
 {
+    // Call the components registered for direct fixed updates, unless another world is the fixed update source
+    if (GetFixedUpdateSource() == this)
+        GetScene()->UpdateComponents(UPDATE_PHASE_FIXEDUPDATE, timeStep);
+
     // Send pre-step event
     using namespace PhysicsPreStep;
 
@@ -825,6 +1659,9 @@ void PhysicsWorld::PostStep(float timeStep)
 
     SendCollisionEvents();
 
+    if (GetFixedUpdateSource() == this)
+        GetScene()->UpdateComponents(UPDATE_PHASE_FIXEDPOSTUPDATE, timeStep);
+
     // Send post-step event
     using namespace PhysicsPostStep;
 
@@ -834,6 +1671,93 @@ void PhysicsWorld::PostStep(float timeStep)
     SendEvent(E_PHYSICSPOSTSTEP, eventData);
 }
 
+void PhysicsWorld::ProcessRaycastBatch(const PhysicsRaycastQuery* start, const PhysicsRaycastQuery* end,
+    PhysicsRaycastResult* result) const
+{
+    // Traverse the broadphase trees directly with a local stack, as btDbvtBroadphase::rayTest shares one stack between callers
+    auto* broadphase = static_cast<btDbvtBroadphase*>(broadphase_.Get());
+
+    BatchCastCallback castCallback;
+
+    for (const PhysicsRaycastQuery* query = start; query != end; ++query, ++result)
+    {
+        const Ray& ray = query->ray_;
+        Vector3 endPos = ray.origin_ + query->maxDistance_ * ray.direction_;
+        castCallback.from_ = btTransform(btQuaternion::getIdentity(), ToBtVector3(ray.origin_));
+        castCallback.to_ = btTransform(btQuaternion::getIdentity(), ToBtVector3(endPos));
+        castCallback.collisionMask_ = query->collisionMask_;
+
+        result->body_ = nullptr;
+        result->position_ = Vector3::ZERO;
+        result->normal_ = Vector3::ZERO;
+        result->distance_ = M_INFINITY;
+        result->hitFraction_ = 0.0f;
+
+        if (query->radius_ > 0.0f)
+        {
+            btSphereShape shape(query->radius_);
+            btCollisionWorld::ClosestConvexResultCallback convexCallback(castCallback.from_.getOrigin(),
+                castCallback.to_.getOrigin());
+            convexCallback.m_collisionFilterGroup = (short)0xffff;
+            convexCallback.m_collisionFilterMask = (short)query->collisionMask_;
+            castCallback.castShape_ = &shape;
+            castCallback.convexCallback_ = &convexCallback;
+
+            btVector3 shapeMin, shapeMax;
+            shape.getAabb(btTransform::getIdentity(), shapeMin, shapeMax);
+            castCallback.Traverse(broadphase, shapeMin, shapeMax);
+            castCallback.castShape_ = nullptr;
+
+            if (convexCallback.hasHit())
+            {
+                result->body_ = static_cast<RigidBody*>(convexCallback.m_hitCollisionObject->getUserPointer());
+                result->position_ = ToVector3(convexCallback.m_hitPointWorld);
+                result->normal_ = ToVector3(convexCallback.m_hitNormalWorld);
+                result->distance_ = convexCallback.m_closestHitFraction * (endPos - ray.origin_).Length();
+                result->hitFraction_ = convexCallback.m_closestHitFraction;
+            }
+        }
+        else
+        {
+            btCollisionWorld::ClosestRayResultCallback rayCallback(castCallback.from_.getOrigin(), castCallback.to_.getOrigin());
+            rayCallback.m_collisionFilterGroup = (short)0xffff;
+            rayCallback.m_collisionFilterMask = (short)query->collisionMask_;
+            castCallback.rayCallback_ = &rayCallback;
+
+            castCallback.Traverse(broadphase, btVector3(0.0f, 0.0f, 0.0f), btVector3(0.0f, 0.0f, 0.0f));
+
+            if (rayCallback.hasHit())
+            {
+                result->position_ = ToVector3(rayCallback.m_hitPointWorld);
+                result->normal_ = ToVector3(rayCallback.m_hitNormalWorld);
+                result->distance_ = (result->position_ - ray.origin_).Length();
+                result->hitFraction_ = rayCallback.m_closestHitFraction;
+                result->body_ = static_cast<RigidBody*>(rayCallback.m_collisionObject->getUserPointer());
+            }
+        }
+    }
+}
+
+void PhysicsWorld::ProcessOverlapBatch(const PhysicsOverlapQuery* start, const PhysicsOverlapQuery* end,
+    PODVector<RigidBody*>& result, unsigned* counts) const
+{
+    auto* broadphase = static_cast<btDbvtBroadphase*>(broadphase_.Get());
+
+    for (const PhysicsOverlapQuery* query = start; query != end; ++query, ++counts)
+    {
+        unsigned oldSize = result.Size();
+        btVector3 aabbMin = ToBtVector3(query->box_.min_);
+        btVector3 aabbMax = ToBtVector3(query->box_.max_);
+        ATTRIBUTE_ALIGNED16(btDbvtVolume) bounds = btDbvtVolume::FromMM(aabbMin, aabbMax);
+
+        BatchOverlapCallback callback(result, aabbMin, aabbMax, query->collisionMask_);
+        broadphase->m_sets[0].collideTV(broadphase->m_sets[0].m_root, bounds, callback);
+        broadphase->m_sets[1].collideTV(broadphase->m_sets[1].m_root, bounds, callback);
+
+        *counts = result.Size() - oldSize;
+    }
+}
+
 void PhysicsWorld::SendCollisionEvents()
 {
     URHO3D_PROFILE(SendCollisionEvents);
@@ -25,6 +25,7 @@
 #include "../Container/HashSet.h"
 #include "../IO/VectorBuffer.h"
 #include "../Math/BoundingBox.h"
+#include "../Math/Ray.h"
 #include "../Math/Sphere.h"
 #include "../Math/Vector3.h"
 #include "../Scene/Component.h"
@@ -48,13 +49,13 @@ class Deserializer;
 class Constraint;
 class Model;
 class Node;
-class Ray;
 class RigidBody;
 class Scene;
 class Serializer;
 class XMLElement;
 
 struct CollisionGeometryData;
+struct WorkItem;
 
 /// Physics raycast hit.
 struct URHO3D_API PhysicsRaycastResult
@@ -77,6 +78,28 @@ struct URHO3D_API PhysicsRaycastResult
     RigidBody* body_{};
 };
 
+/// Ray or swept sphere query for batched execution. Returns the closest hit.
+struct URHO3D_API PhysicsRaycastQuery
+{
+    /// World-space ray.
+    Ray ray_;
+    /// Maximum distance along the ray.
+    float maxDistance_{};
+    /// Swept sphere radius. Zero performs a raycast.
+    float radius_{};
+    /// Collision mask.
+    unsigned collisionMask_{M_MAX_UNSIGNED};
+};
+
+/// Broadphase overlap query for batched execution. Returns rigid bodies whose bounding boxes overlap the volume.
+struct URHO3D_API PhysicsOverlapQuery
+{
+    /// World-space bounding box.
+    BoundingBox box_;
+    /// Collision mask.
+    unsigned collisionMask_{M_MAX_UNSIGNED};
+};
+
 /// Delayed world transform assignment for parented rigidbodies.
 struct DelayedWorldTransform
 {
@@ -131,6 +154,8 @@ class URHO3D_API PhysicsWorld : public Component, public btIDebugDraw
 
     friend void InternalPreTickCallback(btDynamicsWorld* world, btScalar timeStep);
     friend void InternalTickCallback(btDynamicsWorld* world, btScalar timeStep);
+    friend void RaycastBatchWork(const WorkItem* item, unsigned threadIndex);
+    friend void OverlapBatchWork(const WorkItem* item, unsigned threadIndex);
 
 public:
     /// Construct.
@@ -183,6 +208,24 @@ public:
     void SetSplitImpulse(bool enable);
     /// Set maximum angular velocity for network replication.
     void SetMaxNetworkAngularVelocity(float velocity);
+    /// Set directory for the persistent triangle mesh and convex hull collision data cache. Empty (default) disables the cache.
+    void SetCollisionCacheDir(const String& path);
+    /// Set deterministic mode. The simulation then always advances in whole fixed steps without interpolation or adaptive timestep, and contacts and constraints are solved in a canonical order, so that simulating on from a restored state gives bitwise identical results to the original run. Disabled by default.
+    void SetDeterministic(bool enable);
+    /// Advance the simulation immediately by a number of fixed steps, sending the fixed update and physics step events for each. Use to re-simulate after restoring a state.
+    void Simulate(unsigned numSteps);
+    /// Add a node whose transform is included in saved simulation states. Nodes of rigid bodies are always included.
+    void AddStateNode(Node* node);
+    /// Remove a node from saved simulation states.
+    void RemoveStateNode(Node* node);
+    /// Add a component whose attributes are included in saved simulation states.
+    void AddStateComponent(Component* component);
+    /// Remove a component from saved simulation states.
+    void RemoveStateComponent(Component* component);
+    /// Write the simulation state: rigid bodies and their node transforms, the added state nodes and components, and the contact points with their solver impulses. Does not modify the simulation. The buffer is cleared first but keeps its storage, so reusing buffers avoids allocation once they have grown to the state size. Must be called between simulation steps.
+    void SaveState(VectorBuffer& dest);
+    /// Restore a simulation state written by SaveState(). Rebuilds the broadphase and contact manifolds in a repeatable order, then restores the saved contact points and manifold order so that the solver stays warm-started the same way. Objects created after saving keep their current state. Return true if successful, or false if an object in the state no longer exists.
+    bool RestoreState(Deserializer& source);
     /// Perform a physics world raycast and return all hits.
     void Raycast
         (PODVector<PhysicsRaycastResult>& result, const Ray& ray, float maxDistance, unsigned collisionMask = M_MAX_UNSIGNED);
@@ -200,6 +243,10 @@ public:
     /// Perform a physics world swept convex test using a user-supplied Bullet collision shape and return the first hit.
     void ConvexCast(PhysicsRaycastResult& result, btCollisionShape* shape, const Vector3& startPos, const Quaternion& startRot,
         const Vector3& endPos, const Quaternion& endRot, unsigned collisionMask = M_MAX_UNSIGNED);
+    /// Perform a batch of raycasts and swept sphere tests, returning the closest hit for each query in the same order. Large batches are split across the worker threads. Must be called from the main thread between simulation steps.
+    void RaycastBatch(PODVector<PhysicsRaycastResult>& result, const PODVector<PhysicsRaycastQuery>& queries);
+    /// Perform a batch of broadphase overlap queries. Bodies found by query i are stored in result between offsets[i] and offsets[i + 1]. Large batches are split across the worker threads. Must be called from the main thread between simulation steps.
+    void GetRigidBodiesBatch(PODVector<RigidBody*>& result, PODVector<unsigned>& offsets, const PODVector<PhysicsOverlapQuery>& queries);
     /// Invalidate cached collision geometry for a model.
     void RemoveCachedGeometry(Model* model);
     /// Return rigid bodies by a sphere query.
@@ -238,6 +285,12 @@ public:
     /// Return maximum angular velocity for network replication.
     float GetMaxNetworkAngularVelocity() const { return maxNetworkAngularVelocity_; }
 
+    /// Return directory of the persistent collision data cache.
+    const String& GetCollisionCacheDir() const { return collisionCacheDir_; }
+
+    /// Return whether deterministic mode is enabled.
+    bool IsDeterministic() const { return deterministic_; }
+
     /// Add a rigid body to keep track of. Called by RigidBody.
     void AddRigidBody(RigidBody* body);
     /// Remove a rigid body. Called by RigidBody.
@@ -299,6 +352,17 @@ private:
     void PostStep(float timeStep);
     /// Send accumulated collision events.
     void SendCollisionEvents();
+    /// Apply delayed (parented) world transforms after simulation steps.
+    void ApplyDelayedWorldTransforms();
+    /// Remove all rigid bodies from the world and add them back in the given order followed by the rest in ID order, so that the broadphase, overlapping pairs and contact manifolds are rebuilt in a repeatable way.
+    void ResetSimulationCaches(const PODVector<RigidBody*>& bodyOrder);
+    /// Create the contact manifolds for the current transforms and replace their contact points and order with ones read from a saved state.
+    void RestoreContactPoints(Deserializer& source);
+    /// Execute a range of batched ray and sweep queries. Only reads the world, so may be called from worker threads.
+    void ProcessRaycastBatch(const PhysicsRaycastQuery* start, const PhysicsRaycastQuery* end, PhysicsRaycastResult* result) const;
+    /// Execute a range of batched overlap queries, appending the bodies and storing per-query counts. Only reads the world, so may be called from worker threads.
+    void ProcessOverlapBatch(const PhysicsOverlapQuery* start, const PhysicsOverlapQuery* end, PODVector<RigidBody*>& result,
+        unsigned* counts) const;
 
     /// Bullet collision configuration.
     btCollisionConfiguration* collisionConfiguration_{};
@@ -330,6 +394,12 @@ private:
     CollisionGeometryDataCache convexCache_;
     /// Cache for GImpact trimesh geometry data by model and LOD level.
     CollisionGeometryDataCache gimpactTrimeshCache_;
+    /// Persistent collision data cache directory.
+    String collisionCacheDir_;
+    /// Nodes whose transforms are included in saved simulation states.
+    Vector<WeakPtr<Node> > stateNodes_;
+    /// Components whose attributes are included in saved simulation states.
+    Vector<WeakPtr<Component> > stateComponents_;
     /// Preallocated event data map for physics collision events.
     VariantMap physicsCollisionData_;
     /// Preallocated event data map for node collision events.
@@ -348,6 +418,8 @@ private:
     bool updateEnabled_{true};
     /// Interpolation flag.
     bool interpolation_{true};
+    /// Deterministic mode flag.
+    bool deterministic_{};
     /// Use internal edge utility flag.
     bool internalEdge_{true};
     /// Applying transforms flag.
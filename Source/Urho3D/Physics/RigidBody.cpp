@@ -51,6 +51,39 @@ static const float DEFAULT_ROLLING_FRICTION = 0.0f;
 static const unsigned DEFAULT_COLLISION_LAYER = 0x1;
 static const unsigned DEFAULT_COLLISION_MASK = M_MAX_UNSIGNED;
 
+static void WriteBtVector3(Serializer& dest, const btVector3& vector)
+{
+    dest.WriteFloat(vector.x());
+    dest.WriteFloat(vector.y());
+    dest.WriteFloat(vector.z());
+}
+
+static btVector3 ReadBtVector3(Deserializer& source)
+{
+    btVector3 vector;
+    vector.setX(source.ReadFloat());
+    vector.setY(source.ReadFloat());
+    vector.setZ(source.ReadFloat());
+    return vector;
+}
+
+static void WriteBtTransform(Serializer& dest, const btTransform& transform)
+{
+    // Write the basis as is instead of converting to a quaternion, so that the restored state is bitwise identical
+    for (int i = 0; i < 3; ++i)
+        WriteBtVector3(dest, transform.getBasis()[i]);
+    WriteBtVector3(dest, transform.getOrigin());
+}
+
+static btTransform ReadBtTransform(Deserializer& source)
+{
+    btTransform transform;
+    for (int i = 0; i < 3; ++i)
+        transform.getBasis()[i] = ReadBtVector3(source);
+    transform.setOrigin(ReadBtVector3(source));
+    return transform;
+}
+
 static const char* collisionEventModeNames[] =
 {
     "Never",
@@ -585,6 +618,55 @@ void RigidBody::ReAddBodyToWorld()
         AddBodyToWorld();
 }
 
+void RigidBody::SaveState(Serializer& dest) const
+{
+    if (!node_ || !body_)
+        return;
+
+    dest.WriteVector3(node_->GetPosition());
+    dest.WriteQuaternion(node_->GetRotation());
+    dest.WriteVector3(lastPosition_);
+    dest.WriteQuaternion(lastRotation_);
+    dest.WriteBool(hasSimulated_);
+    WriteBtTransform(dest, body_->getWorldTransform());
+    WriteBtTransform(dest, body_->getInterpolationWorldTransform());
+    WriteBtVector3(dest, body_->getLinearVelocity());
+    WriteBtVector3(dest, body_->getAngularVelocity());
+    WriteBtVector3(dest, body_->getInterpolationLinearVelocity());
+    WriteBtVector3(dest, body_->getInterpolationAngularVelocity());
+    dest.WriteUByte((unsigned char)body_->getActivationState());
+    dest.WriteFloat(body_->getDeactivationTime());
+}
+
+void RigidBody::RestoreState(Deserializer& source)
+{
+    if (!node_ || !body_ || !physicsWorld_)
+        return;
+
+    Vector3 position = source.ReadVector3();
+    Quaternion rotation = source.ReadQuaternion();
+    lastPosition_ = source.ReadVector3();
+    lastRotation_ = source.ReadQuaternion();
+    hasSimulated_ = source.ReadBool();
+
+    // Assign the node transform without applying it back to the body
+    physicsWorld_->SetApplyingTransforms(true);
+    node_->SetTransform(position, rotation);
+    physicsWorld_->SetApplyingTransforms(false);
+
+    body_->setWorldTransform(ReadBtTransform(source));
+    body_->setInterpolationWorldTransform(ReadBtTransform(source));
+    body_->updateInertiaTensor();
+    body_->setLinearVelocity(ReadBtVector3(source));
+    body_->setAngularVelocity(ReadBtVector3(source));
+    body_->setInterpolationLinearVelocity(ReadBtVector3(source));
+    body_->setInterpolationAngularVelocity(ReadBtVector3(source));
+    // Accumulated forces are cleared by Bullet after each step, so there is nothing to restore between steps
+    body_->clearForces();
+    body_->forceActivationState(source.ReadUByte());
+    body_->setDeactivationTime(source.ReadFloat());
+}
+
 void RigidBody::DisableMassUpdate()
 {
     enableMassUpdate_ = false;
@@ -144,6 +144,10 @@ public:
     void Activate();
     /// Readd rigid body to the physics world to clean up internal state like stale contacts.
     void ReAddBodyToWorld();
+    /// Write the simulation state of the body and the transform of its node. Called by PhysicsWorld.
+    void SaveState(Serializer& dest) const;
+    /// Restore the simulation state of the body and the transform of its node. Called by PhysicsWorld.
+    void RestoreState(Deserializer& source);
     /// Disable mass update. Call this to optimize performance when adding or editing multiple collision shapes in the same node.
     void DisableMassUpdate();
     /// Re-enable mass update and recalculate the mass/inertia by calling UpdateMass(). Call when collision shape changes are finished.
@@ -122,6 +122,7 @@ bool BackgroundLoader::QueueResource(StringHash type, const String& name, bool s
 
     BackgroundLoadItem& item = backgroundLoadQueue_[key];
     item.sendEventOnFailure_ = sendEventOnFailure;
+    item.reload_ = false;
 
     // Make sure the pointer is non-null and is a Resource subclass
     item.resource_ = DynamicCast<Resource>(owner_->GetContext()->CreateObject(type));
@@ -170,6 +171,29 @@ bool BackgroundLoader::QueueResource(StringHash type, const String& name, bool s
     return true;
 }
 
+bool BackgroundLoader::QueueReload(Resource* resource)
+{
+    Pair<StringHash, StringHash> key = MakePair(resource->GetType(), resource->GetNameHash());
+
+    MutexLock lock(backgroundLoadMutex_);
+
+    if (backgroundLoadQueue_.Find(key) != backgroundLoadQueue_.End())
+        return false;
+
+    URHO3D_LOGDEBUG("Background reloading resource " + resource->GetName());
+
+    BackgroundLoadItem& item = backgroundLoadQueue_[key];
+    item.resource_ = resource;
+    item.sendEventOnFailure_ = false;
+    item.reload_ = true;
+    resource->SetAsyncLoadState(ASYNC_QUEUED);
+
+    if (!IsStarted())
+        Run();
+
+    return true;
+}
+
 void BackgroundLoader::WaitForResource(StringHash type, StringHash nameHash)
 {
     backgroundLoadMutex_.Acquire();
@@ -281,6 +305,19 @@ void BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item)
     }
     resource->SetAsyncLoadState(ASYNC_DONE);
 
+    // A reloaded resource is already in the cache. Like a synchronous reload, keep it there even if reloading failed
+    if (item.reload_)
+    {
+        if (success)
+        {
+            owner_->AddManualResource(resource);
+            resource->SendEvent(E_RELOADFINISHED);
+        }
+        else
+            resource->SendEvent(E_RELOADFAILED);
+        return;
+    }
+
     if (!success && item.sendEventOnFailure_)
     {
         using namespace LoadFailed;
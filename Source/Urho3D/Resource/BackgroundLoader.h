@@ -47,6 +47,8 @@ struct BackgroundLoadItem
     HashSet<Pair<StringHash, StringHash> > dependents_;
     /// Whether to send failure event.
     bool sendEventOnFailure_;
+    /// Whether this is a reload of a resource already in the cache.
+    bool reload_;
 };
 
 /// Background loader of resources. Owned by the ResourceCache.
@@ -64,6 +66,8 @@ public:
 
     /// Queue loading of a resource. The name must be sanitated to ensure consistent format. Return true if queued (not a duplicate and resource was a known type).
     bool QueueResource(StringHash type, const String& name, bool sendEventOnFailure, Resource* caller);
+    /// Queue reloading of a resource already in the cache. Its BeginLoad() runs in the background and EndLoad() when finishing resources. Return true if queued (not already being loaded).
+    bool QueueReload(Resource* resource);
     /// Wait and finish possible loading of a resource when being requested from the cache.
     void WaitForResource(StringHash type, StringHash nameHash);
     /// Process resources that are ready to finish.
@@ -0,0 +1,403 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Resource/Compress.h"
+
+#include "../DebugNew.h"
+
+// DXT compression using a principal axis fit of the block colors followed by a least squares refinement of the endpoints
+
+namespace Urho3D
+{
+
+/// Expand a 5:6:5 packed color to 8 bits per channel the same way as the decompressor does.
+static void Unpack565(unsigned packed, int* color)
+{
+    int red = (packed >> 11) & 0x1f;
+    int green = (packed >> 5) & 0x3f;
+    int blue = packed & 0x1f;
+
+    color[0] = (red << 3) | (red >> 2);
+    color[1] = (green << 2) | (green >> 4);
+    color[2] = (blue << 3) | (blue >> 2);
+}
+
+/// Quantize a color with 0-255 channel range to 5:6:5.
+static unsigned Pack565(const float* color)
+{
+    int red = Clamp(RoundToInt(color[0] * (31.0f / 255.0f)), 0, 31);
+    int green = Clamp(RoundToInt(color[1] * (63.0f / 255.0f)), 0, 63);
+    int blue = Clamp(RoundToInt(color[2] * (31.0f / 255.0f)), 0, 31);
+
+    return (unsigned)((red << 11) | (green << 5) | blue);
+}
+
+/// Order the endpoints for the color mode, then choose the closest palette entry for each pixel. Return the total squared error.
+static int FitColorIndices(const unsigned char* block, const bool* transparent, bool threeColor, unsigned& first, unsigned& second,
+    unsigned& indices)
+{
+    // The 4-color mode requires the first endpoint to be greater, the 3-color mode requires the opposite
+    if (threeColor ? first > second : first < second)
+        Swap(first, second);
+
+    int palette[4][3];
+    Unpack565(first, palette[0]);
+    Unpack565(second, palette[1]);
+
+    int numColors = 4;
+    if (threeColor)
+    {
+        for (int i = 0; i < 3; ++i)
+            palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+        numColors = 3;
+    }
+    else if (first == second)
+    {
+        // Equal endpoints decode as 3-color mode in DXT1, so only use the first palette entry
+        numColors = 1;
+    }
+    else
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+            palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+        }
+    }
+
+    int totalError = 0;
+    indices = 0;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        unsigned index = 0;
+
+        if (transparent[i])
+            index = 3;
+        else
+        {
+            int bestError = M_MAX_INT;
+            for (int j = 0; j < numColors; ++j)
+            {
+                int dr = block[4 * i] - palette[j][0];
+                int dg = block[4 * i + 1] - palette[j][1];
+                int db = block[4 * i + 2] - palette[j][2];
+                int error = dr * dr + dg * dg + db * db;
+                if (error < bestError)
+                {
+                    bestError = error;
+                    index = (unsigned)j;
+                }
+            }
+            totalError += bestError;
+        }
+
+        indices |= index << (2 * i);
+    }
+
+    return totalError;
+}
+
+/// Solve the endpoints that best reproduce the pixels with the chosen 4-color mode indices by least squares. Return false if the system is degenerate.
+static bool RefineColorEndpoints(const unsigned char* block, unsigned indices, float* first, float* second)
+{
+    static const float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+    float alpha2Sum = 0.0f;
+    float beta2Sum = 0.0f;
+    float alphaBetaSum = 0.0f;
+    float alphaX[3] = {0.0f, 0.0f, 0.0f};
+    float betaX[3] = {0.0f, 0.0f, 0.0f};
+
+    for (int i = 0; i < 16; ++i)
+    {
+        float alpha = weights[(indices >> (2 * i)) & 0x3];
+        float beta = 1.0f - alpha;
+
+        alpha2Sum += alpha * alpha;
+        beta2Sum += beta * beta;
+        alphaBetaSum += alpha * beta;
+        for (int j = 0; j < 3; ++j)
+        {
+            alphaX[j] += alpha * block[4 * i + j];
+            betaX[j] += beta * block[4 * i + j];
+        }
+    }
+
+    float denominator = alpha2Sum * beta2Sum - alphaBetaSum * alphaBetaSum;
+    if (Abs(denominator) < M_EPSILON)
+        return false;
+
+    float factor = 1.0f / denominator;
+    for (int j = 0; j < 3; ++j)
+    {
+        first[j] = Clamp((alphaX[j] * beta2Sum - betaX[j] * alphaBetaSum) * factor, 0.0f, 255.0f);
+        second[j] = Clamp((betaX[j] * alpha2Sum - alphaX[j] * alphaBetaSum) * factor, 0.0f, 255.0f);
+    }
+
+    return true;
+}
+
+/// Compress the colors of a 4x4 RGBA block. If transparency is allowed (DXT1), pixels with alpha below 128 are encoded as transparent using the 3-color mode.
+static void CompressColorBlock(unsigned char* dest, const unsigned char* block, bool allowTransparent)
+{
+    bool transparent[16];
+    bool anyTransparent = false;
+    int numOpaque = 0;
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+
+    for (int i = 0; i < 16; ++i)
+    {
+        transparent[i] = allowTransparent && block[4 * i + 3] < 128;
+        if (transparent[i])
+            anyTransparent = true;
+        else
+        {
+            for (int j = 0; j < 3; ++j)
+                mean[j] += block[4 * i + j];
+            ++numOpaque;
+        }
+    }
+
+    unsigned first = 0;
+    unsigned second = 0;
+    unsigned indices = 0;
+
+    if (numOpaque)
+    {
+        for (int j = 0; j < 3; ++j)
+            mean[j] /= numOpaque;
+
+        // Compute the covariance matrix of the opaque colors
+        float covariance[3][3] = {};
+        for (int i = 0; i < 16; ++i)
+        {
+            if (transparent[i])
+                continue;
+
+            float delta[3];
+            for (int j = 0; j < 3; ++j)
+                delta[j] = block[4 * i + j] - mean[j];
+            for (int j = 0; j < 3; ++j)
+            {
+                for (int k = 0; k < 3; ++k)
+                    covariance[j][k] += delta[j] * delta[k];
+            }
+        }
+
+        // Find the principal axis by power iteration
+        float axis[3] = {1.0f, 1.0f, 1.0f};
+        for (int iteration = 0; iteration < 8; ++iteration)
+        {
+            float next[3];
+            for (int j = 0; j < 3; ++j)
+                next[j] = covariance[j][0] * axis[0] + covariance[j][1] * axis[1] + covariance[j][2] * axis[2];
+
+            float largest = Max(Max(Abs(next[0]), Abs(next[1])), Abs(next[2]));
+            if (largest < M_EPSILON)
+                break;
+            for (int j = 0; j < 3; ++j)
+                axis[j] = next[j] / largest;
+        }
+
+        // Use the extreme colors along the axis as the endpoints
+        float minDot = M_INFINITY;
+        float maxDot = -M_INFINITY;
+        int minIndex = 0;
+        int maxIndex = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            if (transparent[i])
+                continue;
+
+            float dot = block[4 * i] * axis[0] + block[4 * i + 1] * axis[1] + block[4 * i + 2] * axis[2];
+            if (dot < minDot)
+            {
+                minDot = dot;
+                minIndex = i;
+            }
+            if (dot > maxDot)
+            {
+                maxDot = dot;
+                maxIndex = i;
+            }
+        }
+
+        float maxColor[3];
+        float minColor[3];
+        for (int j = 0; j < 3; ++j)
+        {
+            maxColor[j] = block[4 * maxIndex + j];
+            minColor[j] = block[4 * minIndex + j];
+        }
+
+        first = Pack565(maxColor);
+        second = Pack565(minColor);
+        int error = FitColorIndices(block, transparent, anyTransparent, first, second, indices);
+
+        // Refine the endpoints for the chosen indices, and keep the result if it improves
+        if (!anyTransparent && error > 0 && RefineColorEndpoints(block, indices, maxColor, minColor))
+        {
+            unsigned refinedFirst = Pack565(maxColor);
+            unsigned refinedSecond = Pack565(minColor);
+            unsigned refinedIndices;
+            int refinedError = FitColorIndices(block, transparent, false, refinedFirst, refinedSecond, refinedIndices);
+            if (refinedError < error)
+            {
+                first = refinedFirst;
+                second = refinedSecond;
+                indices = refinedIndices;
+            }
+        }
+    }
+    else
+    {
+        // All pixels transparent: equal endpoints select the 3-color mode
+        indices = 0xffffffff;
+    }
+
+    dest[0] = (unsigned char)(first & 0xff);
+    dest[1] = (unsigned char)(first >> 8);
+    dest[2] = (unsigned char)(second & 0xff);
+    dest[3] = (unsigned char)(second >> 8);
+    dest[4] = (unsigned char)(indices & 0xff);
+    dest[5] = (unsigned char)((indices >> 8) & 0xff);
+    dest[6] = (unsigned char)((indices >> 16) & 0xff);
+    dest[7] = (unsigned char)(indices >> 24);
+}
+
+/// Compress the alpha of a 4x4 RGBA block to explicit 4-bit values.
+static void CompressAlphaBlockDXT3(unsigned char* dest, const unsigned char* block)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        auto lo = (unsigned char)((block[8 * i + 3] * 15 + 127) / 255);
+        auto hi = (unsigned char)((block[8 * i + 7] * 15 + 127) / 255);
+        dest[i] = lo | (hi << 4);
+    }
+}
+
+/// Compress the alpha of a 4x4 RGBA block to interpolated alpha using the 8-alpha codebook.
+static void CompressAlphaBlockDXT5(unsigned char* dest, const unsigned char* block)
+{
+    int minAlpha = 255;
+    int maxAlpha = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        minAlpha = Min(minAlpha, (int)block[4 * i + 3]);
+        maxAlpha = Max(maxAlpha, (int)block[4 * i + 3]);
+    }
+
+    dest[0] = (unsigned char)maxAlpha;
+    dest[1] = (unsigned char)minAlpha;
+
+    // With equal values all indices stay zero, which selects the first alpha in either codebook
+    unsigned long long indices = 0;
+    if (maxAlpha > minAlpha)
+    {
+        int codes[8];
+        codes[0] = maxAlpha;
+        codes[1] = minAlpha;
+        for (int i = 1; i < 7; ++i)
+            codes[1 + i] = ((7 - i) * maxAlpha + i * minAlpha) / 7;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            int alpha = block[4 * i + 3];
+            int bestError = M_MAX_INT;
+            unsigned long long bestIndex = 0;
+            for (int j = 0; j < 8; ++j)
+            {
+                int error = Abs(alpha - codes[j]);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestIndex = (unsigned long long)j;
+                }
+            }
+            indices |= bestIndex << (3 * i);
+        }
+    }
+
+    for (int i = 0; i < 6; ++i)
+        dest[2 + i] = (unsigned char)((indices >> (8 * i)) & 0xff);
+}
+
+void CompressImageDXT(unsigned char* blocks, const unsigned char* rgba, int width, int height, CompressedFormat format)
+{
+    CompressImageDXT(blocks, rgba, width, height, format, 0, (height + 3) / 4);
+}
+
+void CompressImageDXT(unsigned char* blocks, const unsigned char* rgba, int width, int height, CompressedFormat format,
+    int blockRowStart, int blockRowEnd)
+{
+    int bytesPerBlock = format == CF_DXT1 ? 8 : 16;
+    int blocksPerRow = (width + 3) / 4;
+    unsigned char* destBlock = blocks + blockRowStart * blocksPerRow * bytesPerBlock;
+
+    for (int row = blockRowStart; row < blockRowEnd; ++row)
+    {
+        int y = row * 4;
+
+        for (int x = 0; x < width; x += 4)
+        {
+            // Gather the block pixels, repeating the edge pixels of the image to fill partial blocks
+            unsigned char sourceRgba[4 * 16];
+            for (int py = 0; py < 4; ++py)
+            {
+                int sy = Min(y + py, height - 1);
+                for (int px = 0; px < 4; ++px)
+                {
+                    int sx = Min(x + px, width - 1);
+                    memcpy(sourceRgba + 4 * (4 * py + px), rgba + 4 * (width * sy + sx), 4);
+                }
+            }
+
+            switch (format)
+            {
+            case CF_DXT1:
+                CompressColorBlock(destBlock, sourceRgba, true);
+                break;
+
+            case CF_DXT3:
+                CompressAlphaBlockDXT3(destBlock, sourceRgba);
+                CompressColorBlock(destBlock + 8, sourceRgba, false);
+                break;
+
+            case CF_DXT5:
+                CompressAlphaBlockDXT5(destBlock, sourceRgba);
+                CompressColorBlock(destBlock + 8, sourceRgba, false);
+                break;
+
+            default:
+                break;
+            }
+
+            destBlock += bytesPerBlock;
+        }
+    }
+}
+
+}
@@ -24,6 +24,12 @@
 
 #include "../Resource/Decompress.h"
 
+#include <cstdint>
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
+
 // ETC2 decompress
 typedef unsigned char uint8;
 typedef unsigned short uint16;
@@ -211,6 +217,89 @@ static void DecompressAlphaDXT5(unsigned char* rgba, void const* block)
         rgba[4 * i + 3] = codes[indices[i]];
 }
 
+#ifdef URHO3D_SSE
+static void DecompressColourDXTSSE(unsigned char* rgba, void const* block, bool isDxt1)
+{
+    auto const* bytes = reinterpret_cast< unsigned char const* >( block );
+
+    // unpack the endpoints
+    unsigned char endpoints[8];
+    int a = Unpack565(bytes, endpoints);
+    int b = Unpack565(bytes + 2, endpoints + 4);
+
+    // widen the endpoints to 16-bit lanes, with the swapped order in the other register
+    const __m128i zero = _mm_setzero_si128();
+    __m128i ends = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(endpoints)), zero);
+    __m128i swapped = _mm_shuffle_epi32(ends, _MM_SHUFFLE(1, 0, 3, 2));
+
+    // generate the midpoints
+    __m128i mids;
+    if (isDxt1 && a <= b)
+    {
+        // average of the endpoints and transparent black
+        mids = _mm_unpacklo_epi64(_mm_srli_epi16(_mm_add_epi16(ends, swapped), 1), zero);
+    }
+    else
+    {
+        // divide the weighted sums by 3 as multiplication by 0xaaab and shift right by 17
+        __m128i sums = _mm_add_epi16(_mm_add_epi16(ends, ends), swapped);
+        mids = _mm_srli_epi16(_mm_mulhi_epu16(sums, _mm_set1_epi16((short)0xaaab)), 1);
+    }
+
+    unsigned codes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(codes), _mm_packus_epi16(ends, mids));
+
+    // store out the colours by the 2-bit indices
+    unsigned indices = (unsigned)bytes[4] | ((unsigned)bytes[5] << 8) | ((unsigned)bytes[6] << 16) | ((unsigned)bytes[7] << 24);
+    for (int i = 0; i < 16; ++i)
+    {
+        memcpy(rgba + 4 * i, &codes[indices & 0x3], 4);
+        indices >>= 2;
+    }
+}
+
+static void DecompressAlphaDXT5SSE(unsigned char* rgba, void const* block)
+{
+    // get the two alpha values
+    auto const* bytes = reinterpret_cast< unsigned char const* >( block );
+    int alpha0 = bytes[0];
+    int alpha1 = bytes[1];
+    __m128i first = _mm_set1_epi16((short)alpha0);
+    __m128i second = _mm_set1_epi16((short)alpha1);
+
+    // build the whole codebook at once from weighted sums of the alpha values
+    __m128i codebook;
+    if (alpha0 <= alpha1)
+    {
+        // use 5-alpha codebook, divide by 5 as multiplication by 0xcccd and shift right by 18
+        __m128i sums = _mm_add_epi16(_mm_mullo_epi16(first, _mm_setr_epi16(5, 0, 4, 3, 2, 1, 0, 0)),
+            _mm_mullo_epi16(second, _mm_setr_epi16(0, 5, 1, 2, 3, 4, 0, 0)));
+        codebook = _mm_srli_epi16(_mm_mulhi_epu16(sums, _mm_set1_epi16((short)0xcccd)), 2);
+        codebook = _mm_insert_epi16(codebook, 255, 7);
+    }
+    else
+    {
+        // use 7-alpha codebook, divide by 7 as multiplication by 0x2493 and shift right by 16
+        __m128i sums = _mm_add_epi16(_mm_mullo_epi16(first, _mm_setr_epi16(7, 0, 6, 5, 4, 3, 2, 1)),
+            _mm_mullo_epi16(second, _mm_setr_epi16(0, 7, 1, 2, 3, 4, 5, 6)));
+        codebook = _mm_mulhi_epu16(sums, _mm_set1_epi16(0x2493));
+    }
+
+    unsigned char codes[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(codes), _mm_packus_epi16(codebook, codebook));
+
+    // write out the indexed codebook values from the 48 bits of 3-bit indices
+    unsigned long long indices = 0;
+    for (int i = 0; i < 6; ++i)
+        indices |= (unsigned long long)bytes[2 + i] << (8 * i);
+    for (int i = 0; i < 16; ++i)
+    {
+        rgba[4 * i + 3] = codes[indices & 0x7];
+        indices >>= 3;
+    }
+}
+#endif
+
 static void DecompressDXT(unsigned char* rgba, const void* block, CompressedFormat format)
 {
     // get the block locations
@@ -220,61 +309,58 @@ static void DecompressDXT(unsigned char* rgba, const void* block, CompressedForm
         colourBlock = reinterpret_cast< unsigned char const* >( block ) + 8;
 
     // decompress colour
+#ifdef URHO3D_SSE
+    DecompressColourDXTSSE(rgba, colourBlock, format == CF_DXT1);
+#else
     DecompressColourDXT(rgba, colourBlock, format == CF_DXT1);
+#endif
 
     // decompress alpha separately if necessary
     if (format == CF_DXT3)
         DecompressAlphaDXT3(rgba, alphaBock);
     else if (format == CF_DXT5)
+#ifdef URHO3D_SSE
+        DecompressAlphaDXT5SSE(rgba, alphaBock);
+#else
         DecompressAlphaDXT5(rgba, alphaBock);
+#endif
 }
 
 void DecompressImageDXT(unsigned char* rgba, const void* blocks, int width, int height, int depth, CompressedFormat format)
 {
-    // initialise the block input
-    auto const* sourceBlock = reinterpret_cast< unsigned char const* >( blocks );
+    DecompressImageDXT(rgba, blocks, width, height, depth, format, 0, ((height + 3) / 4) * depth);
+}
+
+void DecompressImageDXT(unsigned char* rgba, const void* blocks, int width, int height, int depth, CompressedFormat format,
+    int blockRowStart, int blockRowEnd)
+{
     int bytesPerBlock = format == CF_DXT1 ? 8 : 16;
+    int blocksPerRow = (width + 3) / 4;
+    int blockRowsPerSlice = (height + 3) / 4;
 
-    // loop over blocks
-    for (int z = 0; z < depth; ++z)
+    // initialise the block input
+    auto const* sourceBlock = reinterpret_cast< unsigned char const* >( blocks ) + blockRowStart * blocksPerRow * bytesPerBlock;
+
+    // loop over block rows of all depth slices
+    for (int row = blockRowStart; row < blockRowEnd; ++row)
     {
-        int sz = width * height * 4 * z;
-        for (int y = 0; y < height; y += 4)
+        int sz = width * height * 4 * (row / blockRowsPerSlice);
+        int y = (row % blockRowsPerSlice) * 4;
+        int rowsInBlock = Min(height - y, 4);
+
+        for (int x = 0; x < width; x += 4)
         {
-            for (int x = 0; x < width; x += 4)
-            {
-                // decompress the block
-                unsigned char targetRgba[4 * 16];
-                DecompressDXT(targetRgba, sourceBlock, format);
+            // decompress the block
+            unsigned char targetRgba[4 * 16];
+            DecompressDXT(targetRgba, sourceBlock, format);
 
-                // write the decompressed pixels to the correct image locations
-                unsigned char const* sourcePixel = targetRgba;
-                for (int py = 0; py < 4; ++py)
-                {
-                    for (int px = 0; px < 4; ++px)
-                    {
-                        // get the target location
-                        int sx = x + px;
-                        int sy = y + py;
-                        if (sx < width && sy < height)
-                        {
-                            unsigned char* targetPixel = rgba + sz + 4 * (width * sy + sx);
-
-                            // copy the rgba value
-                            for (int i = 0; i < 4; ++i)
-                                *targetPixel++ = *sourcePixel++;
-                        }
-                        else
-                        {
-                            // skip this pixel as its outside the image
-                            sourcePixel += 4;
-                        }
-                    }
-                }
+            // write the decompressed pixel rows to the correct image locations, skipping pixels outside the image
+            unsigned bytesPerRow = (unsigned)Min(width - x, 4) * 4;
+            for (int py = 0; py < rowsInBlock; ++py)
+                memcpy(rgba + sz + 4 * (width * (y + py) + x), targetRgba + 16 * py, bytesPerRow);
 
-                // advance
-                sourceBlock += bytesPerBlock;
-            }
+            // advance
+            sourceBlock += bytesPerBlock;
         }
     }
 }
@@ -633,6 +719,12 @@ static unsigned TwiddleUV(unsigned YSize, unsigned XSize, unsigned YPos, unsigne
 }
 
 void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, int height, CompressedFormat format)
+{
+    DecompressImagePVRTC(rgba, blocks, width, height, format, 0, height);
+}
+
+void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, int height, CompressedFormat format, int rowStart,
+    int rowEnd)
 {
     auto* pCompressedData = (AMTC_BLOCK_STRUCT*)blocks;
     int AssumeImageTiles = 1;
@@ -687,7 +779,7 @@ void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, in
     // Step through the pixels of the image decompressing each one in turn
     //
     // Note that this is a hideously inefficient way to do this!
-    for (y = 0; y < height; y++)
+    for (y = rowStart; y < rowEnd; y++)
     {
         for (x = 0; x < width; x++)
         {
@@ -908,21 +1000,26 @@ static void ReadBigEndian4byteWord(uint32_t* pBlock, const unsigned char *s)
 
 // Use ETCPACK to decompress ETC texture.
 void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha)
+{
+    DecompressImageETC(dstImage, blocks, width, height, hasAlpha, 0, (height + 3) / 4);
+}
+
+void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha, int blockRowStart,
+    int blockRowEnd)
 {
     // ETCPACK initialization.
     static const bool placeholder = []() { setupAlphaTable(); return true; }();
 
     const int channelCount = hasAlpha ? 4 : 3;
-    unsigned char* src = (unsigned char*)blocks;
     unsigned int blockPart1, blockPart2;
 
     // ETCPACK write 4x4 blocks, so it needs padding.
     int w4 = ((width + 3) / 4);
-    int h4 = ((height + 3) / 4);
+    unsigned char* src = (unsigned char*)blocks + blockRowStart * w4 * (hasAlpha ? 16 : 8);
 
     unsigned char buffer4x4[4 * 4 * 4];
 
-    for (int y = 0; y < h4; ++y) 
+    for (int y = blockRowStart; y < blockRowEnd; ++y) 
     {
         for (int x = 0; x < w4; ++x) 
         {
@@ -30,10 +30,19 @@ namespace Urho3D
 /// Decompress a DXT compressed image to RGBA.
 URHO3D_API void
     DecompressImageDXT(unsigned char* rgba, const void* blocks, int width, int height, int depth, CompressedFormat format);
+/// Decompress a range of 4-pixel block rows of a DXT compressed image to RGBA. Block rows of all depth slices are numbered consecutively. Disjoint ranges may be decompressed from different threads.
+URHO3D_API void DecompressImageDXT(unsigned char* rgba, const void* blocks, int width, int height, int depth, CompressedFormat format,
+    int blockRowStart, int blockRowEnd);
 /// Decompress an ETC1/ETC2 compressed image to RGBA.
 URHO3D_API void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha);
+/// Decompress a range of 4-pixel block rows of an ETC1/ETC2 compressed image to RGBA. Disjoint ranges may be decompressed from different threads.
+URHO3D_API void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha,
+    int blockRowStart, int blockRowEnd);
 /// Decompress a PVRTC compressed image to RGBA.
 URHO3D_API void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, int height, CompressedFormat format);
+/// Decompress a range of pixel rows of a PVRTC compressed image to RGBA. Disjoint ranges may be decompressed from different threads.
+URHO3D_API void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, int height, CompressedFormat format,
+    int rowStart, int rowEnd);
 /// Flip a compressed block vertically.
 URHO3D_API void FlipBlockVertical(unsigned char* dest, const unsigned char* src, CompressedFormat format);
 /// Flip a compressed block horizontally.
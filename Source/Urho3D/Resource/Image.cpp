@@ -24,9 +24,12 @@
 
 #include "../Core/Context.h"
 #include "../Core/Profiler.h"
+#include "../Core/Thread.h"
+#include "../Core/WorkQueue.h"
 #include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
+#include "../Resource/Compress.h"
 #include "../Resource/Decompress.h"
 
 #include <SDL/SDL_surface.h>
@@ -34,6 +37,9 @@
 #include <STB/stb_image.h>
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <STB/stb_image_write.h>
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#endif
 #ifdef URHO3D_WEBP
 #include <webp/decode.h>
 #include <webp/encode.h>
@@ -87,6 +93,9 @@ static const unsigned DDS_DXGI_FORMAT_BC2_UNORM_SRGB = 75;
 static const unsigned DDS_DXGI_FORMAT_BC3_UNORM = 77;
 static const unsigned DDS_DXGI_FORMAT_BC3_UNORM_SRGB = 78;
 
+// Minimum number of pixels to split the processing of image data across worker threads
+static const int MIN_THREADED_IMAGE_PIXELS = 256 * 256;
+
 namespace Urho3D
 {
 
@@ -216,39 +225,194 @@ struct DDSurfaceDesc2
     unsigned dwTextureStage_;
 };
 
-bool CompressedLevel::Decompress(unsigned char* dest) const
+/// Function for processing a range of rows of image data.
+using ImageRowFunction = void (*)(const void* data, int rowStart, int rowEnd);
+
+/// Work description for processing a range of rows of image data.
+struct ImageRowWork
 {
-    if (!data_)
-        return false;
+    /// Row processing function.
+    ImageRowFunction function_;
+    /// Function-specific data.
+    const void* data_;
+    /// First row.
+    int rowStart_;
+    /// Row end (exclusive.)
+    int rowEnd_;
+};
+
+/// Worker function for processing a range of rows of image data.
+static void ImageRowWorkFunction(const WorkItem* item, unsigned /*threadIndex*/)
+{
+    const ImageRowWork& rows = *reinterpret_cast<const ImageRowWork*>(item->aux_);
+    rows.function_(rows.data_, rows.rowStart_, rows.rowEnd_);
+}
 
-    switch (format_)
+/// Process rows of image data. If there are enough pixels, split the rows across the work queue threads. In the main thread
+/// this is not possible when the work queue is already completing work, as the image may be processed inside a work item.
+/// Other threads (for example the background loader) execute their share of the rows while waiting for the worker threads.
+static void ProcessImageRows(WorkQueue* queue, ImageRowFunction function, const void* data, int numRows, int numPixels)
+{
+    bool mainThread = Thread::IsMainThread();
+    if (!queue || !queue->GetNumThreads() || (mainThread && queue->IsCompleting()) || numPixels < MIN_THREADED_IMAGE_PIXELS ||
+        numRows < 2)
+    {
+        function(data, 0, numRows);
+        return;
+    }
+
+    unsigned numWorkItems = Min(queue->GetNumThreads() + 1, (unsigned)numRows); // Worker threads + main thread
+    int rowsPerItem = numRows / numWorkItems;
+
+    PODVector<ImageRowWork> work(numWorkItems);
+    Vector<SharedPtr<WorkItem> > items;
+    int rowStart = 0;
+    for (unsigned i = 0; i < numWorkItems; ++i)
+    {
+        ImageRowWork& rows = work[i];
+        rows.function_ = function;
+        rows.data_ = data;
+        rows.rowStart_ = rowStart;
+        rows.rowEnd_ = i < numWorkItems - 1 ? rowStart + rowsPerItem : numRows;
+        rowStart = rows.rowEnd_;
+
+        if (mainThread)
+        {
+            SharedPtr<WorkItem> item = queue->GetFreeItem();
+            item->priority_ = M_MAX_UNSIGNED;
+            item->workFunction_ = ImageRowWorkFunction;
+            item->aux_ = &rows;
+            queue->AddWorkItem(item);
+        }
+        else
+        {
+            // The item pool belongs to the main thread. Use lowest priority so that the main thread does not pick up
+            // the rows when completing rendering work
+            SharedPtr<WorkItem> item(new WorkItem());
+            item->priority_ = 0;
+            item->workFunction_ = ImageRowWorkFunction;
+            item->aux_ = &rows;
+            items.Push(item);
+        }
+    }
+
+    if (mainThread)
+        queue->Complete(M_MAX_UNSIGNED);
+    else
+        queue->ExecuteItems(items);
+}
+
+/// Compression parameters for processing rows of an uncompressed level.
+struct CompressLevelParams
+{
+    /// Destination blocks.
+    unsigned char* blocks_;
+    /// Source RGBA data.
+    const unsigned char* rgba_;
+    /// Level width.
+    int width_;
+    /// Level height.
+    int height_;
+    /// Compressed format.
+    CompressedFormat format_;
+};
+
+/// Compress a range of block rows of an uncompressed level.
+static void CompressLevelRowsFunction(const void* data, int rowStart, int rowEnd)
+{
+    const CompressLevelParams& params = *reinterpret_cast<const CompressLevelParams*>(data);
+    CompressImageDXT(params.blocks_, params.rgba_, params.width_, params.height_, params.format_, rowStart, rowEnd);
+}
+
+/// Decompression parameters for processing rows of a compressed level.
+struct DecompressLevelParams
+{
+    /// Compressed level.
+    const CompressedLevel* level_;
+    /// Destination RGBA data.
+    unsigned char* dest_;
+};
+
+/// Return the number of independently decodable rows in a compressed level: block rows of all slices for DXT, block rows for ETC and pixel rows for PVRTC. Return 0 if the format is not supported.
+static int GetNumDecompressRows(const CompressedLevel& level)
+{
+    switch (level.format_)
     {
     case CF_DXT1:
     case CF_DXT3:
     case CF_DXT5:
-        DecompressImageDXT(dest, data_, width_, height_, depth_, format_);
-        return true;
+        return ((level.height_ + 3) / 4) * level.depth_;
+
+    case CF_ETC1:
+    case CF_ETC2_RGB:
+    case CF_ETC2_RGBA:
+        return (level.height_ + 3) / 4;
+
+    case CF_PVRTC_RGB_2BPP:
+    case CF_PVRTC_RGBA_2BPP:
+    case CF_PVRTC_RGB_4BPP:
+    case CF_PVRTC_RGBA_4BPP:
+        return level.height_;
+
+    default:
+        return 0;
+    }
+}
+
+/// Decompress a range of rows of a compressed level to RGBA.
+static void DecompressLevelRows(const CompressedLevel& level, unsigned char* dest, int rowStart, int rowEnd)
+{
+    switch (level.format_)
+    {
+    case CF_DXT1:
+    case CF_DXT3:
+    case CF_DXT5:
+        DecompressImageDXT(dest, level.data_, level.width_, level.height_, level.depth_, level.format_, rowStart, rowEnd);
+        break;
 
     // ETC2 format is compatible with ETC1, so we just use the same function.
     case CF_ETC1:
     case CF_ETC2_RGB:
-        DecompressImageETC(dest, data_, width_, height_, false);
-        return true;
+        DecompressImageETC(dest, level.data_, level.width_, level.height_, false, rowStart, rowEnd);
+        break;
     case CF_ETC2_RGBA:
-        DecompressImageETC(dest, data_, width_, height_, true);
-        return true;
+        DecompressImageETC(dest, level.data_, level.width_, level.height_, true, rowStart, rowEnd);
+        break;
 
     case CF_PVRTC_RGB_2BPP:
     case CF_PVRTC_RGBA_2BPP:
     case CF_PVRTC_RGB_4BPP:
     case CF_PVRTC_RGBA_4BPP:
-        DecompressImagePVRTC(dest, data_, width_, height_, format_);
-        return true;
+        DecompressImagePVRTC(dest, level.data_, level.width_, level.height_, level.format_, rowStart, rowEnd);
+        break;
 
     default:
+        break;
+    }
+}
+
+/// Decompress a range of rows of a compressed level. Rows are block rows for block-based formats and pixel rows for PVRTC.
+static void DecompressLevelRowsFunction(const void* data, int rowStart, int rowEnd)
+{
+    const DecompressLevelParams& params = *reinterpret_cast<const DecompressLevelParams*>(data);
+    DecompressLevelRows(*params.level_, params.dest_, rowStart, rowEnd);
+}
+
+bool CompressedLevel::Decompress(unsigned char* dest, WorkQueue* workQueue) const
+{
+    if (!data_)
+        return false;
+
+    int numRows = GetNumDecompressRows(*this);
+    if (!numRows)
+    {
         // Unknown format
         return false;
     }
+
+    DecompressLevelParams params{this, dest};
+    ProcessImageRows(workQueue, DecompressLevelRowsFunction, &params, numRows, width_ * height_ * depth_);
+    return true;
 }
 
 Image::Image(Context* context) :
@@ -369,7 +533,7 @@ bool Image::BeginLoad(Deserializer& source)
             // Add 3 to ensure valid block: ie 2x2 fits uses a whole 4x4 block
             unsigned blocksWide = (ddsd.dwWidth_ + 3) / 4;
             unsigned blocksHeight = (ddsd.dwHeight_ + 3) / 4;
-            dataSize = blocksWide * blocksHeight * blockSize;
+            dataSize = blocksWide * blocksHeight * blockSize * Max(ddsd.dwDepth_, 1U);
 
             // Calculate mip data size
             unsigned x = ddsd.dwWidth_ / 2;
@@ -795,34 +959,29 @@ bool Image::BeginLoad(Deserializer& source)
         source.Seek(0);
         source.Read(data.Get(), dataSize);
 
-        WebPBitstreamFeatures features;
-
-        if (WebPGetFeatures(data.Get(), dataSize, &features) != VP8_STATUS_OK)
+        WebPDecoderConfig config;
+        if (!WebPInitDecoderConfig(&config) || WebPGetFeatures(data.Get(), dataSize, &config.input) != VP8_STATUS_OK)
         {
             URHO3D_LOGERROR("Error reading WebP image: " + source.GetName());
             return false;
         }
 
-        size_t imgSize = (size_t)features.width * features.height * (features.has_alpha ? 4 : 3);
-        SharedArrayPtr<uint8_t> pixelData(new uint8_t[imgSize]);
+        const WebPBitstreamFeatures& features = config.input;
+        SetSize(features.width, features.height, features.has_alpha ? 4 : 3);
 
-        bool decodeError(false);
-        if (features.has_alpha)
-        {
-            decodeError = WebPDecodeRGBAInto(data.Get(), dataSize, pixelData.Get(), imgSize, 4 * features.width) == nullptr;
-        }
-        else
-        {
-            decodeError = WebPDecodeRGBInto(data.Get(), dataSize, pixelData.Get(), imgSize, 3 * features.width) == nullptr;
-        }
-        if (decodeError)
+        // Decode straight into the image data, and let libwebp run its filtering stage on a separate thread
+        config.options.use_threads = 1;
+        config.output.colorspace = features.has_alpha ? MODE_RGBA : MODE_RGB;
+        config.output.is_external_memory = 1;
+        config.output.u.RGBA.rgba = data_.Get();
+        config.output.u.RGBA.stride = features.width * components_;
+        config.output.u.RGBA.size = (size_t)features.width * features.height * components_;
+
+        if (WebPDecode(data.Get(), dataSize, &config) != VP8_STATUS_OK)
         {
             URHO3D_LOGERROR("Error decoding WebP image:" + source.GetName());
             return false;
         }
-
-        SetSize(features.width, features.height, features.has_alpha ? 4 : 3);
-        SetData(pixelData);
     }
 #endif
     else
@@ -1328,8 +1487,6 @@ bool Image::SaveJPG(const String& fileName, int quality) const
 
 bool Image::SaveDDS(const String& fileName) const
 {
-    URHO3D_PROFILE(SaveImageDDS);
-
     File outFile(context_, fileName, FILE_WRITE);
     if (!outFile.IsOpen())
     {
@@ -1337,23 +1494,45 @@ bool Image::SaveDDS(const String& fileName) const
         return false;
     }
 
-    if (IsCompressed())
+    return SaveDDS(outFile);
+}
+
+bool Image::SaveDDS(Serializer& dest) const
+{
+    URHO3D_PROFILE(SaveImageDDS);
+
+    if (IsCompressed() && compressedFormat_ != CF_DXT1 && compressedFormat_ != CF_DXT3 && compressedFormat_ != CF_DXT5)
     {
-        URHO3D_LOGERROR("Can not save compressed image to DDS");
+        URHO3D_LOGERROR("Can not save compressed image to DDS in other formats than DXT1, DXT3 or DXT5");
         return false;
     }
 
-    if (components_ != 4)
+    if (!IsCompressed() && components_ != 4)
     {
         URHO3D_LOGERRORF("Can not save image with %u components to DDS", components_);
         return false;
     }
 
-    // Write image
-    PODVector<const Image*> levels;
-    GetLevels(levels);
+    if (array_)
+    {
+        URHO3D_LOGERROR("Can not save texture array image to DDS");
+        return false;
+    }
 
-    outFile.WriteFileID("DDS ");
+    // Cube map faces are stored one after another, each with its mip levels
+    unsigned numFaces = cubemap_ ? 6 : 1;
+    const Image* face = this;
+    for (unsigned i = 0; i < numFaces; ++i, face = face->nextSibling_)
+    {
+        if (!face || face->width_ != width_ || face->height_ != height_ || face->compressedFormat_ != compressedFormat_ ||
+            face->numCompressedLevels_ != numCompressedLevels_)
+        {
+            URHO3D_LOGERROR("Can not save cube map image with missing or mismatching faces to DDS");
+            return false;
+        }
+    }
+
+    dest.WriteFileID("DDS ");
 
     DDSurfaceDesc2 ddsd;        // NOLINT(hicpp-member-init)
     memset(&ddsd, 0, sizeof(ddsd));
@@ -1362,18 +1541,75 @@ bool Image::SaveDDS(const String& fileName) const
         | 0x00000002l /*DDSD_HEIGHT*/ | 0x00000004l /*DDSD_WIDTH*/ | 0x00020000l /*DDSD_MIPMAPCOUNT*/ | 0x00001000l /*DDSD_PIXELFORMAT*/;
     ddsd.dwWidth_ = width_;
     ddsd.dwHeight_ = height_;
+    ddsd.ddpfPixelFormat_.dwSize_ = sizeof(ddsd.ddpfPixelFormat_);
+    ddsd.ddsCaps_.dwCaps_ = DDSCAPS_TEXTURE;
+    if (depth_ > 1)
+    {
+        ddsd.dwFlags_ |= 0x00800000l /*DDSD_DEPTH*/;
+        ddsd.dwDepth_ = depth_;
+        ddsd.ddsCaps_.dwCaps_ |= DDSCAPS_COMPLEX;
+        ddsd.ddsCaps_.dwCaps2_ = DDSCAPS2_VOLUME;
+    }
+    else if (cubemap_)
+    {
+        ddsd.ddsCaps_.dwCaps_ |= DDSCAPS_COMPLEX;
+        ddsd.ddsCaps_.dwCaps2_ = DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_ALL_FACES;
+    }
+
+    if (IsCompressed())
+    {
+        // Write all compressed mip levels as they are stored
+        ddsd.dwFlags_ |= 0x00080000l /*DDSD_LINEARSIZE*/;
+        ddsd.dwLinearSize_ = GetCompressedLevel(0).dataSize_;
+        ddsd.dwMipMapCount_ = numCompressedLevels_;
+        ddsd.ddpfPixelFormat_.dwFlags_ = 0x00000004l /*DDPF_FOURCC*/;
+        ddsd.ddpfPixelFormat_.dwFourCC_ = compressedFormat_ == CF_DXT1 ? FOURCC_DXT1 : (compressedFormat_ == CF_DXT3 ?
+            FOURCC_DXT3 : FOURCC_DXT5);
+        if (numCompressedLevels_ > 1)
+            ddsd.ddsCaps_.dwCaps_ |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+
+        dest.Write(&ddsd, sizeof(ddsd));
+        face = this;
+        for (unsigned i = 0; i < numFaces; ++i, face = face->nextSibling_)
+            dest.Write(face->data_.Get(), face->GetMemoryUse());
+        return true;
+    }
+
+    // Write image
+    PODVector<const Image*> levels;
+    GetLevels(levels);
+
+    // Cube map faces must have the same number of precalculated levels
+    face = nextSibling_;
+    for (unsigned i = 1; i < numFaces; ++i, face = face->nextSibling_)
+    {
+        PODVector<const Image*> faceLevels;
+        face->GetLevels(faceLevels);
+        if (faceLevels.Size() != levels.Size())
+        {
+            URHO3D_LOGERROR("Can not save cube map image with mismatching face mip levels to DDS");
+            return false;
+        }
+    }
+
     ddsd.dwMipMapCount_ = levels.Size();
+    if (levels.Size() > 1)
+        ddsd.ddsCaps_.dwCaps_ |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
     ddsd.ddpfPixelFormat_.dwFlags_ = 0x00000040l /*DDPF_RGB*/ | 0x00000001l /*DDPF_ALPHAPIXELS*/;
-    ddsd.ddpfPixelFormat_.dwSize_ = sizeof(ddsd.ddpfPixelFormat_);
     ddsd.ddpfPixelFormat_.dwRGBBitCount_ = 32;
     ddsd.ddpfPixelFormat_.dwRBitMask_ = 0x000000ff;
     ddsd.ddpfPixelFormat_.dwGBitMask_ = 0x0000ff00;
     ddsd.ddpfPixelFormat_.dwBBitMask_ = 0x00ff0000;
     ddsd.ddpfPixelFormat_.dwRGBAlphaBitMask_ = 0xff000000;
 
-    outFile.Write(&ddsd, sizeof(ddsd));
-    for (unsigned i = 0; i < levels.Size(); ++i)
-        outFile.Write(levels[i]->GetData(), levels[i]->GetWidth() * levels[i]->GetHeight() * 4);
+    dest.Write(&ddsd, sizeof(ddsd));
+    face = this;
+    for (unsigned i = 0; i < numFaces; ++i, face = face->nextSibling_)
+    {
+        face->GetLevels(levels);
+        for (unsigned j = 0; j < levels.Size(); ++j)
+            dest.Write(levels[j]->GetData(), levels[j]->GetWidth() * levels[j]->GetHeight() * levels[j]->GetDepth() * 4);
+    }
 
     return true;
 }
@@ -1588,6 +1824,147 @@ Color Image::GetPixelTrilinear(float x, float y, float z) const
     return colorNear.Lerp(colorFar, zF);
 }
 
+/// Parameters for generating rows of a 2D mip level.
+struct MipLevelParams
+{
+    /// Source level pixel data.
+    const unsigned char* pixelDataIn_;
+    /// Destination level pixel data.
+    unsigned char* pixelDataOut_;
+    /// Source level width.
+    int widthIn_;
+    /// Destination level width.
+    int widthOut_;
+    /// Number of color components.
+    unsigned components_;
+};
+
+/// Generate a range of rows of a 2D mip level by box filtering 2x2 source pixels.
+static void DownsampleRows(const unsigned char* pixelDataIn, unsigned char* pixelDataOut, int widthIn, int widthOut,
+    unsigned components, int yStart, int yEnd)
+{
+#ifdef URHO3D_SSE
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lowByteMask = _mm_set1_epi16(0xff);
+#endif
+
+    switch (components)
+    {
+    case 1:
+        for (int y = yStart; y < yEnd; ++y)
+        {
+            const unsigned char* inUpper = &pixelDataIn[(y * 2) * widthIn];
+            const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * widthIn];
+            unsigned char* out = &pixelDataOut[y * widthOut];
+            int x = 0;
+
+#ifdef URHO3D_SSE
+            // Sum horizontal pairs as 16-bit values, 8 output pixels at a time
+            for (; x + 8 <= widthOut; x += 8)
+            {
+                __m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&inUpper[x * 2]));
+                __m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&inLower[x * 2]));
+                __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(upper, lowByteMask), _mm_srli_epi16(upper, 8)),
+                    _mm_add_epi16(_mm_and_si128(lower, lowByteMask), _mm_srli_epi16(lower, 8)));
+                sum = _mm_srli_epi16(sum, 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(&out[x]), _mm_packus_epi16(sum, sum));
+            }
+#endif
+
+            for (; x < widthOut; ++x)
+            {
+                out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 1] +
+                                          inLower[x * 2] + inLower[x * 2 + 1]) >> 2);
+            }
+        }
+        break;
+
+    case 2:
+        for (int y = yStart; y < yEnd; ++y)
+        {
+            const unsigned char* inUpper = &pixelDataIn[(y * 2) * widthIn * 2];
+            const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * widthIn * 2];
+            unsigned char* out = &pixelDataOut[y * widthOut * 2];
+
+            for (int x = 0; x < widthOut * 2; x += 2)
+            {
+                out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 2] +
+                                          inLower[x * 2] + inLower[x * 2 + 2]) >> 2);
+                out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 3] +
+                                              inLower[x * 2 + 1] + inLower[x * 2 + 3]) >> 2);
+            }
+        }
+        break;
+
+    case 3:
+        for (int y = yStart; y < yEnd; ++y)
+        {
+            const unsigned char* inUpper = &pixelDataIn[(y * 2) * widthIn * 3];
+            const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * widthIn * 3];
+            unsigned char* out = &pixelDataOut[y * widthOut * 3];
+
+            for (int x = 0; x < widthOut * 3; x += 3)
+            {
+                out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 3] +
+                                          inLower[x * 2] + inLower[x * 2 + 3]) >> 2);
+                out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 4] +
+                                              inLower[x * 2 + 1] + inLower[x * 2 + 4]) >> 2);
+                out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 5] +
+                                              inLower[x * 2 + 2] + inLower[x * 2 + 5]) >> 2);
+            }
+        }
+        break;
+
+    case 4:
+        for (int y = yStart; y < yEnd; ++y)
+        {
+            const unsigned char* inUpper = &pixelDataIn[(y * 2) * widthIn * 4];
+            const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * widthIn * 4];
+            unsigned char* out = &pixelDataOut[y * widthOut * 4];
+            int x = 0;
+
+#ifdef URHO3D_SSE
+            // Widen 4 source pixels per row to 16-bit, then add the even and odd pixels to get 2 output pixels at a time
+            for (; x + 8 <= widthOut * 4; x += 8)
+            {
+                __m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&inUpper[x * 2]));
+                __m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&inLower[x * 2]));
+                __m128i sumLow = _mm_add_epi16(_mm_unpacklo_epi8(upper, zero), _mm_unpacklo_epi8(lower, zero));
+                __m128i sumHigh = _mm_add_epi16(_mm_unpackhi_epi8(upper, zero), _mm_unpackhi_epi8(lower, zero));
+                __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(sumLow, sumHigh), _mm_unpackhi_epi64(sumLow, sumHigh));
+                sum = _mm_srli_epi16(sum, 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(&out[x]), _mm_packus_epi16(sum, sum));
+            }
+#endif
+
+            for (; x < widthOut * 4; x += 4)
+            {
+                out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 4] +
+                                          inLower[x * 2] + inLower[x * 2 + 4]) >> 2);
+                out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 5] +
+                                              inLower[x * 2 + 1] + inLower[x * 2 + 5]) >> 2);
+                out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 6] +
+                                              inLower[x * 2 + 2] + inLower[x * 2 + 6]) >> 2);
+                out[x + 3] = (unsigned char)(((unsigned)inUpper[x * 2 + 3] + inUpper[x * 2 + 7] +
+                                              inLower[x * 2 + 3] + inLower[x * 2 + 7]) >> 2);
+            }
+        }
+        break;
+
+    default:
+        assert(false);  // Should never reach here
+        break;
+    }
+}
+
+/// Generate a range of rows of a 2D mip level from the parameters.
+static void DownsampleRowsFunction(const void* data, int rowStart, int rowEnd)
+{
+    const MipLevelParams& params = *reinterpret_cast<const MipLevelParams*>(data);
+    DownsampleRows(params.pixelDataIn_, params.pixelDataOut_, params.widthIn_, params.widthOut_, params.components_, rowStart,
+        rowEnd);
+}
+
 SharedPtr<Image> Image::GetNextLevel() const
 {
     if (IsCompressed())
@@ -1676,84 +2053,8 @@ SharedPtr<Image> Image::GetNextLevel() const
     // 2D case
     else if (depth_ == 1)
     {
-        switch (components_)
-        {
-        case 1:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_];
-                unsigned char* out = &pixelDataOut[y * widthOut];
-
-                for (int x = 0; x < widthOut; ++x)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 1] +
-                                              inLower[x * 2] + inLower[x * 2 + 1]) >> 2);
-                }
-            }
-            break;
-
-        case 2:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 2];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 2];
-                unsigned char* out = &pixelDataOut[y * widthOut * 2];
-
-                for (int x = 0; x < widthOut * 2; x += 2)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 2] +
-                                              inLower[x * 2] + inLower[x * 2 + 2]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 3] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 3]) >> 2);
-                }
-            }
-            break;
-
-        case 3:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 3];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 3];
-                unsigned char* out = &pixelDataOut[y * widthOut * 3];
-
-                for (int x = 0; x < widthOut * 3; x += 3)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 3] +
-                                              inLower[x * 2] + inLower[x * 2 + 3]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 4] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 4]) >> 2);
-                    out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 5] +
-                                                  inLower[x * 2 + 2] + inLower[x * 2 + 5]) >> 2);
-                }
-            }
-            break;
-
-        case 4:
-            for (int y = 0; y < heightOut; ++y)
-            {
-                const unsigned char* inUpper = &pixelDataIn[(y * 2) * width_ * 4];
-                const unsigned char* inLower = &pixelDataIn[(y * 2 + 1) * width_ * 4];
-                unsigned char* out = &pixelDataOut[y * widthOut * 4];
-
-                for (int x = 0; x < widthOut * 4; x += 4)
-                {
-                    out[x] = (unsigned char)(((unsigned)inUpper[x * 2] + inUpper[x * 2 + 4] +
-                                              inLower[x * 2] + inLower[x * 2 + 4]) >> 2);
-                    out[x + 1] = (unsigned char)(((unsigned)inUpper[x * 2 + 1] + inUpper[x * 2 + 5] +
-                                                  inLower[x * 2 + 1] + inLower[x * 2 + 5]) >> 2);
-                    out[x + 2] = (unsigned char)(((unsigned)inUpper[x * 2 + 2] + inUpper[x * 2 + 6] +
-                                                  inLower[x * 2 + 2] + inLower[x * 2 + 6]) >> 2);
-                    out[x + 3] = (unsigned char)(((unsigned)inUpper[x * 2 + 3] + inUpper[x * 2 + 7] +
-                                                  inLower[x * 2 + 3] + inLower[x * 2 + 7]) >> 2);
-                }
-            }
-            break;
-
-        default:
-            assert(false);  // Should never reach here
-            break;
-        }
+        MipLevelParams params{pixelDataIn, pixelDataOut, width_, widthOut, components_};
+        ProcessImageRows(GetSubsystem<WorkQueue>(), DownsampleRowsFunction, &params, heightOut, widthOut * heightOut);
     }
     // 3D case
     else
@@ -1920,7 +2221,28 @@ SharedPtr<Image> Image::ConvertToRGBA() const
     switch (components_)
     {
     case 1:
-        for (unsigned i = 0; i < static_cast<unsigned>(width_ * height_ * depth_); ++i)
+    {
+        unsigned i = 0;
+#ifdef URHO3D_SSE
+        // Expand 16 luminance pixels at a time to L, L, L, 255
+        const __m128i opaque = _mm_set1_epi8((char)0xff);
+        for (; i + 16 <= static_cast<unsigned>(width_ * height_ * depth_); i += 16)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i lumLow = _mm_unpacklo_epi8(pixels, pixels);
+            __m128i lumHigh = _mm_unpackhi_epi8(pixels, pixels);
+            __m128i lumAlphaLow = _mm_unpacklo_epi8(pixels, opaque);
+            __m128i lumAlphaHigh = _mm_unpackhi_epi8(pixels, opaque);
+            auto* out = reinterpret_cast<__m128i*>(dest);
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(lumLow, lumAlphaLow));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lumLow, lumAlphaLow));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(lumHigh, lumAlphaHigh));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(lumHigh, lumAlphaHigh));
+            src += 16;
+            dest += 64;
+        }
+#endif
+        for (; i < static_cast<unsigned>(width_ * height_ * depth_); ++i)
         {
             unsigned char pixel = *src++;
             *dest++ = pixel;
@@ -1929,6 +2251,7 @@ SharedPtr<Image> Image::ConvertToRGBA() const
             *dest++ = 255;
         }
         break;
+    }
 
     case 2:
         for (unsigned i = 0; i < static_cast<unsigned>(width_ * height_ * depth_); ++i)
@@ -2103,11 +2426,84 @@ SharedPtr<Image> Image::GetDecompressedImage() const
 
     auto decompressedImage = MakeShared<Image>(context_);
     decompressedImage->SetSize(compressedLevel.width_, compressedLevel.height_, 4);
-    compressedLevel.Decompress(decompressedImage->GetData());
+    compressedLevel.Decompress(decompressedImage->GetData(), GetSubsystem<WorkQueue>());
 
     return decompressedImage;
 }
 
+SharedPtr<Image> Image::GetCompressedImage(CompressedFormat format) const
+{
+    if (format != CF_DXT1 && format != CF_DXT3 && format != CF_DXT5)
+    {
+        URHO3D_LOGERROR("Image can only be compressed to DXT1, DXT3 or DXT5");
+        return SharedPtr<Image>();
+    }
+    if (IsCompressed())
+    {
+        URHO3D_LOGERROR("Image is already compressed");
+        return SharedPtr<Image>();
+    }
+    if (depth_ > 1)
+    {
+        URHO3D_LOGERROR("Can not compress 3D image");
+        return SharedPtr<Image>();
+    }
+
+    URHO3D_PROFILE(CompressImage);
+
+    // Convert to RGBA if necessary, then generate the full mip chain. Keep the generated images alive until compressed
+    Vector<SharedPtr<Image> > generatedImages;
+    const Image* level = this;
+    if (components_ != 4)
+    {
+        SharedPtr<Image> rgbaImage = ConvertToRGBA();
+        if (!rgbaImage)
+            return SharedPtr<Image>();
+        generatedImages.Push(rgbaImage);
+        level = rgbaImage;
+    }
+
+    PODVector<const Image*> levels;
+    levels.Push(level);
+    while (level->width_ > 1 || level->height_ > 1)
+    {
+        SharedPtr<Image> nextLevel = level->GetNextLevel();
+        generatedImages.Push(nextLevel);
+        level = nextLevel;
+        levels.Push(level);
+    }
+
+    unsigned blockSize = format == CF_DXT1 ? 8 : 16;
+    unsigned dataSize = 0;
+    for (unsigned i = 0; i < levels.Size(); ++i)
+        dataSize += ((levels[i]->width_ + 3) / 4) * ((levels[i]->height_ + 3) / 4) * blockSize;
+
+    SharedPtr<Image> compressedImage(new Image(context_));
+    compressedImage->data_ = new unsigned char[dataSize];
+    compressedImage->width_ = width_;
+    compressedImage->height_ = height_;
+    compressedImage->depth_ = 1;
+    compressedImage->components_ = format == CF_DXT1 ? 3 : 4;
+    compressedImage->compressedFormat_ = format;
+    compressedImage->numCompressedLevels_ = levels.Size();
+    compressedImage->sRGB_ = sRGB_;
+    compressedImage->SetMemoryUse(dataSize);
+
+    auto* queue = GetSubsystem<WorkQueue>();
+    unsigned char* dest = compressedImage->data_.Get();
+    for (unsigned i = 0; i < levels.Size(); ++i)
+    {
+        level = levels[i];
+        int numBlockRows = (level->height_ + 3) / 4;
+
+        CompressLevelParams params{dest, level->data_.Get(), level->width_, level->height_, format};
+        ProcessImageRows(queue, CompressLevelRowsFunction, &params, numBlockRows, level->width_ * level->height_);
+        dest += ((level->width_ + 3) / 4) * numBlockRows * blockSize;
+    }
+
+    return compressedImage;
+}
+
 Image* Image::GetSubimage(const IntRect& rect) const
 {
     if (!data_)
@@ -32,6 +32,8 @@ struct SDL_Surface;
 namespace Urho3D
 {
 
+class WorkQueue;
+
 static const int COLOR_LUT_SIZE = 16;
 
 /// Supported compressed image formats.
@@ -54,8 +56,8 @@ enum CompressedFormat
 /// Compressed image mip level.
 struct CompressedLevel
 {
-    /// Decompress to RGBA. The destination buffer required is width * height * 4 bytes. Return true if successful.
-    bool Decompress(unsigned char* dest) const;
+    /// Decompress to RGBA. The destination buffer required is width * height * depth * 4 bytes. If a work queue is given, large levels are decompressed by rows on the worker threads. Return true if successful.
+    bool Decompress(unsigned char* dest, WorkQueue* workQueue = nullptr) const;
 
     /// Compressed image data.
     unsigned char* data_{};
@@ -131,8 +133,10 @@ public:
     bool SaveTGA(const String& fileName) const;
     /// Save in JPG format with specified quality. Return true if successful.
     bool SaveJPG(const String& fileName, int quality) const;
-    /// Save in DDS format. Only uncompressed RGBA images are supported. Return true if successful.
+    /// Save in DDS format. Only uncompressed RGBA and DXT1/DXT3/DXT5 compressed images are supported. Return true if successful.
     bool SaveDDS(const String& fileName) const;
+    /// Save in DDS format to a stream. Only uncompressed RGBA and DXT1/DXT3/DXT5 compressed images are supported. Return true if successful.
+    bool SaveDDS(Serializer& dest) const;
     /// Save in WebP format with minimum (fastest) or specified compression. Return true if successful. Fails always if WebP support is not compiled in.
     bool SaveWEBP(const String& fileName, float compression = 0.0f) const;
     /// Whether this texture is detected as a cubemap, only relevant for DDS.
@@ -179,7 +183,7 @@ public:
     /// Return number of compressed mip levels. Returns 0 if the image is has not been loaded from a source file containing multiple mip levels.
     unsigned GetNumCompressedLevels() const { return numCompressedLevels_; }
 
-    /// Return next mip level by bilinear filtering. Note that if the image is already 1x1x1, will keep returning an image of that size.
+    /// Return next mip level by bilinear filtering. Note that if the image is already 1x1x1, will keep returning an image of that size. Large 2D levels are split by rows across the work queue threads.
     SharedPtr<Image> GetNextLevel() const;
     /// Return the next sibling image of an array or cubemap.
     SharedPtr<Image> GetNextSibling() const { return nextSibling_;  }
@@ -189,11 +193,13 @@ public:
     CompressedLevel GetCompressedLevel(unsigned index) const;
     /// Return decompressed image data in RGBA format.
     SharedPtr<Image> GetDecompressedImage() const;
+    /// Return the image compressed to DXT1, DXT3 or DXT5 including a full mip chain, or null if failed. Large levels are compressed on the work queue threads. 3D images are not supported.
+    SharedPtr<Image> GetCompressedImage(CompressedFormat format) const;
     /// Return subimage from the image by the defined rect or null if failed. 3D images are not supported. You must free the subimage yourself.
     Image* GetSubimage(const IntRect& rect) const;
     /// Return an SDL surface from the image, or null if failed. Only RGB images are supported. Specify rect to only return partial image. You must free the surface yourself.
     SDL_Surface* GetSDLSurface(const IntRect& rect = IntRect::ZERO) const;
-    /// Precalculate the mip levels. Used by asynchronous texture loading.
+    /// Precalculate the mip levels. Used by asynchronous texture loading. Each large level is generated on the work queue threads, also when called from a background thread.
     void PrecalculateLevels();
     /// Whether this texture has an alpha channel.
     bool HasAlphaChannel() const;
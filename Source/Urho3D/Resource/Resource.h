@@ -97,6 +97,9 @@ public:
     /// Return the asynchronous loading state.
     AsyncLoadState GetAsyncLoadState() const { return asyncLoadState_; }
 
+    /// Return whether BeginLoad() only fills intermediate data for EndLoad() without modifying the live state, so that a reload can be parsed on the background loader thread while the resource is in use. Default false.
+    virtual bool SupportsBackgroundReload() const { return false; }
+
 private:
     /// Name.
     String name_;
@@ -70,6 +70,7 @@ static const SharedPtr<Resource> noResource;
 ResourceCache::ResourceCache(Context* context) :
     Object(context),
     autoReloadResources_(false),
+    backgroundReloadResources_(true),
     returnFailedResources_(false),
     searchPackagesFirst_(true),
     isRouting_(false),
@@ -433,11 +434,81 @@ void ResourceCache::ReloadResourceWithDependencies(const String& fileName)
     }
 }
 
+void ResourceCache::ReloadResourcesWithDependencies(const Vector<String>& fileNames)
+{
+    URHO3D_PROFILE(ReloadResources);
+
+    // Plan the whole batch before reloading anything, as reloading may modify the dependency tracking structure. A
+    // resource that is both changed and a dependent is reloaded only once, after its dependencies
+    Vector<SharedPtr<Resource> > changed;
+    Vector<SharedPtr<Resource> > dependents;
+    HashSet<Resource*> planned;
+
+    for (unsigned i = 0; i < fileNames.Size(); ++i)
+    {
+        StringHash fileNameHash(fileNames[i]);
+        const SharedPtr<Resource>& resource = FindResource(fileNameHash);
+        if (resource)
+            changed.Push(resource);
+
+        // Always perform dependency resource check for resource loaded from XML file as it could be used in inheritance
+        if (!resource || GetExtension(resource->GetName()) == ".xml")
+        {
+            HashMap<StringHash, HashSet<StringHash> >::ConstIterator j = dependentResources_.Find(fileNameHash);
+            if (j == dependentResources_.End())
+                continue;
+
+            for (HashSet<StringHash>::ConstIterator k = j->second_.Begin(); k != j->second_.End(); ++k)
+            {
+                const SharedPtr<Resource>& dependent = FindResource(*k);
+                if (dependent && !planned.Contains(dependent))
+                {
+                    planned.Insert(dependent);
+                    dependents.Push(dependent);
+                }
+            }
+        }
+    }
+
+    unsigned numBackground = 0;
+    for (unsigned i = 0; i < changed.Size(); ++i)
+    {
+        if (planned.Contains(changed[i]))
+            continue;
+        planned.Insert(changed[i]);
+
+        URHO3D_LOGDEBUG("Reloading changed resource " + changed[i]->GetName());
+        if (BackgroundReloadResource(changed[i]))
+            ++numBackground;
+        else
+            ReloadResource(changed[i]);
+    }
+
+    // Synchronously reloaded dependents get their dependencies through GetResource(), which finishes any of them
+    // still being reloaded in the background first
+    for (unsigned i = 0; i < dependents.Size(); ++i)
+    {
+        URHO3D_LOGDEBUG("Reloading dependent resource " + dependents[i]->GetName());
+        if (BackgroundReloadResource(dependents[i]))
+            ++numBackground;
+        else
+            ReloadResource(dependents[i]);
+    }
+
+    if (numBackground)
+        URHO3D_LOGDEBUG("Reloading " + String(numBackground) + " resources in the background");
+}
+
 void ResourceCache::SetMemoryBudget(StringHash type, unsigned long long budget)
 {
     resourceGroups_[type].memoryBudget_ = budget;
 }
 
+void ResourceCache::SetBackgroundReloadResources(bool enable)
+{
+    backgroundReloadResources_ = enable;
+}
+
 void ResourceCache::SetAutoReloadResources(bool enable)
 {
     if (enable != autoReloadResources_)
@@ -1070,22 +1141,64 @@ void ResourceCache::UpdateResourceGroup(StringHash type)
     }
 }
 
+bool ResourceCache::BackgroundReloadResource(Resource* resource)
+{
+#ifdef URHO3D_THREADING
+    if (!backgroundReloadResources_ || !resource->SupportsBackgroundReload())
+        return false;
+
+    // Fails if the resource is already being loaded, in which case reload synchronously
+    if (!backgroundLoader_->QueueReload(resource))
+        return false;
+
+    resource->SendEvent(E_RELOADSTARTED);
+    return true;
+#else
+    return false;
+#endif
+}
+
 void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
-    for (unsigned i = 0; i < fileWatchers_.Size(); ++i)
+    if (!fileWatchers_.Empty())
     {
-        String fileName;
-        while (fileWatchers_[i]->GetNextChange(fileName))
+        // Gather the settled changes of all watchers into one batch. The same resource name may be reported by several
+        // watchers if resource directories overlap
+        Vector<String> batch;
+        Vector<String> changedFiles;
+        Vector<String> changedPaths;
+        HashSet<String> seen;
+
+        for (unsigned i = 0; i < fileWatchers_.Size(); ++i)
         {
-            ReloadResourceWithDependencies(fileName);
+            batch.Clear();
+            if (!fileWatchers_[i]->GetNextChanges(batch))
+                continue;
 
-            // Finally send a general file changed event even if the file was not a tracked resource
-            using namespace FileChanged;
+            for (unsigned j = 0; j < batch.Size(); ++j)
+            {
+                if (seen.Contains(batch[j]))
+                    continue;
+                seen.Insert(batch[j]);
+                changedFiles.Push(batch[j]);
+                changedPaths.Push(fileWatchers_[i]->GetPath() + batch[j]);
+            }
+        }
 
-            VariantMap& eventData = GetEventDataMap();
-            eventData[P_FILENAME] = fileWatchers_[i]->GetPath() + fileName;
-            eventData[P_RESOURCENAME] = fileName;
-            SendEvent(E_FILECHANGED, eventData);
+        if (!changedFiles.Empty())
+        {
+            ReloadResourcesWithDependencies(changedFiles);
+
+            // Finally send a general file changed event for each file even if it was not a tracked resource
+            for (unsigned i = 0; i < changedFiles.Size(); ++i)
+            {
+                using namespace FileChanged;
+
+                VariantMap& eventData = GetEventDataMap();
+                eventData[P_FILENAME] = changedPaths[i];
+                eventData[P_RESOURCENAME] = changedFiles[i];
+                SendEvent(E_FILECHANGED, eventData);
+            }
         }
     }
 
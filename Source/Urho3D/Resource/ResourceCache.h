@@ -118,10 +118,14 @@ public:
     bool ReloadResource(Resource* resource);
     /// Reload a resource based on filename. Causes also reload of dependent resources if necessary.
     void ReloadResourceWithDependencies(const String& fileName);
+    /// Reload a batch of changed files. Each affected resource is reloaded once, with dependents after the changed resources. Resources that support it are parsed on the background loader thread and finished over the following frames.
+    void ReloadResourcesWithDependencies(const Vector<String>& fileNames);
     /// Set memory budget for a specific resource type, default 0 is unlimited.
     void SetMemoryBudget(StringHash type, unsigned long long budget);
     /// Enable or disable automatic reloading of resources as files are modified. Default false.
     void SetAutoReloadResources(bool enable);
+    /// Enable or disable parsing reloaded resources on the background loader thread when the resource type supports it. Default true.
+    void SetBackgroundReloadResources(bool enable);
     /// Enable or disable returning resources that failed to load. Default false. This may be useful in editing to not lose resource ref attributes.
     void SetReturnFailedResources(bool enable) { returnFailedResources_ = enable; }
 
@@ -186,6 +190,9 @@ public:
     /// Return whether automatic resource reloading is enabled.
     bool GetAutoReloadResources() const { return autoReloadResources_; }
 
+    /// Return whether reloaded resources are parsed on the background loader thread when supported.
+    bool GetBackgroundReloadResources() const { return backgroundReloadResources_; }
+
     /// Return whether resources that failed to load are returned.
     bool GetReturnFailedResources() const { return returnFailedResources_; }
 
@@ -223,6 +230,8 @@ private:
     void UpdateResourceGroup(StringHash type);
     /// Handle begin frame event. Automatic resource reloads and the finalization of background loaded resources are processed here.
     void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+    /// Queue a resource for reloading on the background loader thread if supported. Return true if queued.
+    bool BackgroundReloadResource(Resource* resource);
     /// Search FileSystem for file.
     File* SearchResourceDirs(const String& name);
     /// Search resource packages for file.
@@ -246,6 +255,8 @@ private:
     Vector<SharedPtr<ResourceRouter> > resourceRouters_;
     /// Automatic resource reloading flag.
     bool autoReloadResources_;
+    /// Background reloading flag.
+    bool backgroundReloadResources_;
     /// Return failed resources flag.
     bool returnFailedResources_;
     /// Search priority flag.
@@ -0,0 +1,439 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Core/Context.h"
+#include "../IO/Deserializer.h"
+#include "../IO/Log.h"
+#include "../IO/Serializer.h"
+#include "../Scene/CompiledScene.h"
+#include "../Scene/Serializable.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+template <class T> static void ReadCompiledValue(const unsigned char* src, Variant& dest)
+{
+    T value;
+    memcpy(&value, src, sizeof value);
+    dest = value;
+}
+
+template <class T, class E, unsigned N> static void ReadCompiledArray(const unsigned char* src, Variant& dest)
+{
+    E data[N];
+    memcpy(data, src, sizeof data);
+    dest = T(data);
+}
+
+static void ReadCompiledBool(const unsigned char* src, Variant& dest)
+{
+    dest = *src != 0;
+}
+
+/// Fixed-size attribute value type, with its size in the serialized data and its reader.
+struct CompiledValueType
+{
+    /// Value type.
+    VariantType type_;
+    /// Size in bytes.
+    unsigned size_;
+    /// Reader.
+    CompiledAttributeReader reader_;
+};
+
+static const CompiledValueType fixedValueTypes[] =
+{
+    {VAR_INT, 4, ReadCompiledValue<int>},
+    {VAR_BOOL, 1, ReadCompiledBool},
+    {VAR_FLOAT, 4, ReadCompiledValue<float>},
+    {VAR_VECTOR2, 8, ReadCompiledArray<Vector2, float, 2>},
+    {VAR_VECTOR3, 12, ReadCompiledArray<Vector3, float, 3>},
+    {VAR_VECTOR4, 16, ReadCompiledArray<Vector4, float, 4>},
+    {VAR_QUATERNION, 16, ReadCompiledArray<Quaternion, float, 4>},
+    {VAR_COLOR, 16, ReadCompiledArray<Color, float, 4>},
+    {VAR_INTRECT, 16, ReadCompiledArray<IntRect, int, 4>},
+    {VAR_INTVECTOR2, 8, ReadCompiledArray<IntVector2, int, 2>},
+    {VAR_MATRIX3, 36, ReadCompiledArray<Matrix3, float, 9>},
+    {VAR_MATRIX3X4, 48, ReadCompiledArray<Matrix3x4, float, 12>},
+    {VAR_MATRIX4, 64, ReadCompiledArray<Matrix4, float, 16>},
+    {VAR_DOUBLE, 8, ReadCompiledValue<double>},
+    {VAR_INTVECTOR3, 12, ReadCompiledArray<IntVector3, int, 3>},
+    {VAR_INT64, 8, ReadCompiledValue<long long>},
+};
+
+/// Return the fixed-size value type description, or null if the values of the type vary in size.
+static const CompiledValueType* GetFixedValueType(VariantType type)
+{
+    for (const CompiledValueType& fixed : fixedValueTypes)
+    {
+        if (fixed.type_ == type)
+            return &fixed;
+    }
+
+    return nullptr;
+}
+
+/// Return whether an attribute is saved to files.
+static bool IsFileAttribute(const AttributeInfo& attr)
+{
+    return (attr.mode_ & AM_FILE) && (attr.mode_ & AM_FILEREADONLY) != AM_FILEREADONLY;
+}
+
+CompiledSceneWriter::CompiledSceneWriter() = default;
+
+CompiledSceneWriter::~CompiledSceneWriter() = default;
+
+unsigned CompiledSceneWriter::AddType(const Serializable* object, bool& compiled)
+{
+    StringHash type = object->GetType();
+    const Vector<AttributeInfo>* attributes = object->GetAttributes();
+    // Objects with per-instance attribute descriptions, like script instances, can not share a layout
+    compiled = attributes == object->GetContext()->GetAttributes(type);
+
+    unsigned index;
+    HashMap<StringHash, unsigned>::ConstIterator i = typeIndices_.Find(type);
+    if (i != typeIndices_.End())
+    {
+        index = i->second_;
+        // A type first added by a raw object has no layout yet
+        if (!compiled || attributes_[index] || !attributes)
+            return index;
+    }
+    else
+    {
+        index = types_.Size();
+        types_.Push(type);
+        layouts_.Resize(index + 1);
+        attributes_.Push(nullptr);
+        typeIndices_[type] = index;
+        if (!compiled || !attributes)
+            return index;
+    }
+
+    // Fixed-size attributes first, so that each of them has the same offset in all blocks of the type
+    PODVector<unsigned>& layout = layouts_[index];
+    for (unsigned j = 0; j < attributes->Size(); ++j)
+    {
+        if (IsFileAttribute(attributes->At(j)) && GetFixedValueType(attributes->At(j).type_))
+            layout.Push(j);
+    }
+    for (unsigned j = 0; j < attributes->Size(); ++j)
+    {
+        if (IsFileAttribute(attributes->At(j)) && !GetFixedValueType(attributes->At(j).type_))
+            layout.Push(j);
+    }
+    attributes_[index] = attributes;
+
+    return index;
+}
+
+unsigned CompiledSceneWriter::AddBlock(const unsigned char* data, unsigned size)
+{
+    unsigned hash = size;
+    for (unsigned i = 0; i < size; ++i)
+        hash = SDBMHash(hash, data[i]);
+
+    // Check for an identical block with the same hash
+    PODVector<unsigned>& indices = blockIndices_[hash];
+    for (unsigned i = 0; i < indices.Size(); ++i)
+    {
+        unsigned index = indices[i];
+        if (blockSizes_[index] == size && (!size || !memcmp(&blockData_[blockOffsets_[index]], data, size)))
+        {
+            ++blockUses_[index];
+            return index;
+        }
+    }
+
+    unsigned index = blockSizes_.Size();
+    blockOffsets_.Push(blockData_.Size());
+    blockSizes_.Push(size);
+    blockUses_.Push(1);
+    if (size)
+    {
+        blockData_.Resize(blockData_.Size() + size);
+        memcpy(&blockData_[blockOffsets_.Back()], data, size);
+    }
+    indices.Push(index);
+    return index;
+}
+
+unsigned CompiledSceneWriter::AddAttributes(const Serializable* object, unsigned typeIndex)
+{
+    encodeBuffer_.Clear();
+
+    if (typeIndex < types_.Size() && attributes_[typeIndex])
+    {
+        const Vector<AttributeInfo>& attributes = *attributes_[typeIndex];
+        const PODVector<unsigned>& layout = layouts_[typeIndex];
+        Variant value;
+
+        for (unsigned i = 0; i < layout.Size(); ++i)
+        {
+            const AttributeInfo& attr = attributes[layout[i]];
+            object->OnGetAttribute(attr, value);
+            // Keep the precomputed offsets valid even if an accessor returns a value of another type
+            if (value.GetType() != attr.type_)
+                value = Variant(attr.type_, String::EMPTY);
+            encodeBuffer_.WriteVariantData(value);
+        }
+    }
+
+    return AddBlock(encodeBuffer_.GetData(), encodeBuffer_.GetSize());
+}
+
+bool CompiledSceneWriter::Write(Serializer& dest) const
+{
+    if (!dest.WriteFileID("UCSN"))
+        return false;
+
+    dest.WriteVLE(types_.Size());
+    for (unsigned i = 0; i < types_.Size(); ++i)
+    {
+        dest.WriteStringHash(types_[i]);
+        const PODVector<unsigned>& layout = layouts_[i];
+        dest.WriteVLE(layout.Size());
+        for (unsigned j = 0; j < layout.Size(); ++j)
+        {
+            const AttributeInfo& attr = attributes_[i]->At(layout[j]);
+            dest.WriteStringHash(StringHash(attr.name_));
+            dest.WriteUByte((unsigned char)attr.type_);
+        }
+    }
+
+    // The lowest bit of the block size tells whether the block is shared
+    dest.WriteVLE(blockSizes_.Size());
+    for (unsigned i = 0; i < blockSizes_.Size(); ++i)
+        dest.WriteVLE(blockSizes_[i] << 1u | (blockUses_[i] > 1 ? 1u : 0u));
+    if (blockData_.Size() && dest.Write(&blockData_[0], blockData_.Size()) != blockData_.Size())
+        return false;
+
+    return dest.Write(nodeStream_.GetData(), nodeStream_.GetSize()) == nodeStream_.GetSize();
+}
+
+CompiledSceneReader::CompiledSceneReader() :
+    blockData_(nullptr),
+    nodeStream_((const void*)nullptr, 0)
+{
+}
+
+CompiledSceneReader::~CompiledSceneReader() = default;
+
+bool CompiledSceneReader::Open(const void* data, unsigned size)
+{
+    types_.Clear();
+    blockOffsets_.Clear();
+    blockSizes_.Clear();
+    blockShared_.Clear();
+    decodedBlocks_.Clear();
+
+    MemoryBuffer header(data, size);
+    if (header.ReadFileID() != "UCSN")
+    {
+        URHO3D_LOGERROR(header.GetName() + " is not a valid compiled scene file");
+        return false;
+    }
+
+    // Each table entry takes at least one byte, which gives an upper bound for sanity checking the table sizes
+    unsigned numTypes = header.ReadVLE();
+    if (numTypes > header.GetSize() - header.GetPosition())
+    {
+        URHO3D_LOGERROR("Compiled scene type table is corrupt");
+        return false;
+    }
+    types_.Resize(numTypes);
+    for (unsigned i = 0; i < numTypes; ++i)
+    {
+        TypeInfo& type = types_[i];
+        type.type_ = header.ReadStringHash();
+        type.fixedSize_ = 0;
+        type.boundAttributes_ = nullptr;
+
+        unsigned numAttributes = header.ReadVLE();
+        if (numAttributes > header.GetSize() - header.GetPosition())
+        {
+            URHO3D_LOGERROR("Compiled scene type table is corrupt");
+            return false;
+        }
+        type.names_.Resize(numAttributes);
+        type.valueTypes_.Resize(numAttributes);
+        for (unsigned j = 0; j < numAttributes; ++j)
+        {
+            type.names_[j] = header.ReadStringHash();
+            type.valueTypes_[j] = (VariantType)header.ReadUByte();
+        }
+
+        // Precompute the offsets of the leading fixed-size attributes
+        for (unsigned j = 0; j < numAttributes; ++j)
+        {
+            const CompiledValueType* fixed = GetFixedValueType(type.valueTypes_[j]);
+            if (!fixed)
+                break;
+            type.offsets_.Push(type.fixedSize_);
+            type.readers_.Push(fixed->reader_);
+            type.fixedSize_ += fixed->size_;
+        }
+    }
+
+    unsigned numBlocks = header.ReadVLE();
+    if (numBlocks > header.GetSize() - header.GetPosition())
+    {
+        URHO3D_LOGERROR("Compiled scene block table is corrupt");
+        return false;
+    }
+    blockOffsets_.Resize(numBlocks);
+    blockSizes_.Resize(numBlocks);
+    blockShared_.Resize(numBlocks);
+    unsigned totalBlockSize = 0;
+    for (unsigned i = 0; i < numBlocks; ++i)
+    {
+        unsigned sizeAndShared = header.ReadVLE();
+        blockOffsets_[i] = totalBlockSize;
+        blockSizes_[i] = sizeAndShared >> 1u;
+        blockShared_[i] = (sizeAndShared & 1u) != 0;
+        totalBlockSize += blockSizes_[i];
+    }
+
+    if (header.IsEof() || totalBlockSize > header.GetSize() - header.GetPosition())
+    {
+        URHO3D_LOGERROR("Compiled scene block data is truncated");
+        return false;
+    }
+
+    decodedBlocks_.Resize(numBlocks);
+    for (unsigned i = 0; i < numBlocks; ++i)
+        decodedBlocks_[i].first_ = M_MAX_UNSIGNED;
+
+    blockData_ = reinterpret_cast<const unsigned char*>(data) + header.GetPosition();
+    nodeStream_ = MemoryBuffer(blockData_ + totalBlockSize, header.GetSize() - header.GetPosition() - totalBlockSize);
+    return true;
+}
+
+bool CompiledSceneReader::Open(Deserializer& source)
+{
+    unsigned position = source.GetPosition();
+    unsigned size = source.GetSize() - position;
+
+    // Memory buffers, for example on top of memory-mapped files, are read in place
+    auto* memory = dynamic_cast<MemoryBuffer*>(&source);
+    if (memory)
+    {
+        source.Seek(position + size);
+        return Open(memory->GetData() + position, size);
+    }
+
+    buffer_ = new unsigned char[size];
+    if (source.Read(buffer_.Get(), size) != size)
+    {
+        URHO3D_LOGERROR("Could not read compiled scene data from " + source.GetName());
+        return false;
+    }
+
+    return Open(buffer_.Get(), size);
+}
+
+bool CompiledSceneReader::LoadAttributes(Serializable* object, unsigned typeIndex, unsigned blockIndex)
+{
+    if (typeIndex >= types_.Size() || blockIndex >= blockSizes_.Size())
+    {
+        URHO3D_LOGERROR("Compiled scene node hierarchy is corrupt");
+        return false;
+    }
+
+    TypeInfo& type = types_[typeIndex];
+
+    // Bind the stored layout to the attribute descriptions of the class by name and type, once per type
+    const Vector<AttributeInfo>* attributes = object->GetAttributes();
+    if (type.boundAttributes_ != attributes || type.bound_.Size() != type.names_.Size())
+    {
+        type.bound_.Resize(type.names_.Size());
+        for (unsigned i = 0; i < type.names_.Size(); ++i)
+        {
+            type.bound_[i] = nullptr;
+            for (unsigned j = 0; attributes && j < attributes->Size(); ++j)
+            {
+                const AttributeInfo& attr = attributes->At(j);
+                if ((attr.mode_ & AM_FILE) && attr.type_ == type.valueTypes_[i] && StringHash(attr.name_) == type.names_[i])
+                {
+                    type.bound_[i] = &attr;
+                    break;
+                }
+            }
+        }
+        type.boundAttributes_ = attributes;
+    }
+
+    // Shared blocks are decoded once and the values reused for every object referring to them
+    if (blockShared_[blockIndex])
+    {
+        Pair<unsigned, Vector<Variant> >& decoded = decodedBlocks_[blockIndex];
+        if (decoded.first_ != typeIndex)
+        {
+            if (!DecodeBlock(type, blockIndex, decoded.second_))
+                return false;
+            decoded.first_ = typeIndex;
+        }
+        return object->LoadAttributeValues(type.bound_, decoded.second_);
+    }
+
+    if (!DecodeBlock(type, blockIndex, decodeBuffer_))
+        return false;
+    return object->LoadAttributeValues(type.bound_, decodeBuffer_);
+}
+
+MemoryBuffer CompiledSceneReader::GetBlock(unsigned index) const
+{
+    if (index < blockSizes_.Size())
+        return MemoryBuffer(blockData_ + blockOffsets_[index], blockSizes_[index]);
+    else
+        return MemoryBuffer((const void*)nullptr, 0);
+}
+
+bool CompiledSceneReader::DecodeBlock(const TypeInfo& type, unsigned blockIndex, Vector<Variant>& values) const
+{
+    const unsigned char* data = blockData_ + blockOffsets_[blockIndex];
+    unsigned size = blockSizes_[blockIndex];
+    if (size < type.fixedSize_)
+    {
+        URHO3D_LOGERROR("Compiled scene attribute block is truncated");
+        return false;
+    }
+
+    values.Resize(type.valueTypes_.Size());
+
+    // Fixed-size attributes from their precomputed offsets, then the variable-size attributes in order
+    unsigned numFixed = type.readers_.Size();
+    for (unsigned i = 0; i < numFixed; ++i)
+        type.readers_[i](data + type.offsets_[i], values[i]);
+
+    MemoryBuffer variable(data + type.fixedSize_, size - type.fixedSize_);
+    for (unsigned i = numFixed; i < values.Size(); ++i)
+        values[i] = variable.ReadVariant(type.valueTypes_[i]);
+
+    return true;
+}
+
+}
@@ -0,0 +1,158 @@
+//
+// Copyright (c) 2008-2020 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/ArrayPtr.h"
+#include "../Container/HashMap.h"
+#include "../Core/Attribute.h"
+#include "../IO/MemoryBuffer.h"
+#include "../IO/VectorBuffer.h"
+#include "../Math/StringHash.h"
+
+namespace Urho3D
+{
+
+class Deserializer;
+class Serializable;
+class Serializer;
+
+/// Function that decodes a fixed-size attribute value from compiled scene data.
+using CompiledAttributeReader = void (*)(const unsigned char* src, Variant& dest);
+
+/// Utility class that collects a node hierarchy into the compiled scene format. Each object type is stored once in a type table together with its attribute layout: the fixed-size attributes come first so that they have the same precomputed offset in every attribute block of the type, followed by the variable-size attributes. Identical attribute blocks are stored only once in a block table, which the node hierarchy refers to by index.
+class URHO3D_API CompiledSceneWriter
+{
+public:
+    /// Construct.
+    CompiledSceneWriter();
+    /// Destruct.
+    ~CompiledSceneWriter();
+
+    /// Add the type of an object and return its index in the type table. If the object uses the attribute descriptions of its class, also store the attribute layout and set the compiled flag. Otherwise, for example for a script instance, clear the flag; the object must then be saved as raw data with its own Save().
+    unsigned AddType(const Serializable* object, bool& compiled);
+    /// Add an attribute block and return its index in the block table. Return the existing index if an identical block has already been added.
+    unsigned AddBlock(const unsigned char* data, unsigned size);
+    /// Encode the attributes of an object according to the layout of its type and add them as an attribute block. Return the block index.
+    unsigned AddAttributes(const Serializable* object, unsigned typeIndex);
+    /// Write the file ID, the type and block tables and the node hierarchy. Return true if successful.
+    bool Write(Serializer& dest) const;
+
+    /// Return the stream for writing the node hierarchy.
+    VectorBuffer& GetNodeStream() { return nodeStream_; }
+
+private:
+    /// Object types.
+    PODVector<StringHash> types_;
+    /// Attribute layouts of the types as indices to the attribute descriptions.
+    Vector<PODVector<unsigned> > layouts_;
+    /// Attribute descriptions of the types.
+    PODVector<const Vector<AttributeInfo>*> attributes_;
+    /// Type indices by type.
+    HashMap<StringHash, unsigned> typeIndices_;
+    /// Concatenated attribute block data.
+    PODVector<unsigned char> blockData_;
+    /// Attribute block start offsets into the concatenated data.
+    PODVector<unsigned> blockOffsets_;
+    /// Attribute block sizes.
+    PODVector<unsigned> blockSizes_;
+    /// Number of references to each attribute block.
+    PODVector<unsigned> blockUses_;
+    /// Attribute block indices by content hash, for finding identical blocks.
+    HashMap<unsigned, PODVector<unsigned> > blockIndices_;
+    /// Buffer for encoding attribute blocks.
+    VectorBuffer encodeBuffer_;
+    /// Node hierarchy.
+    VectorBuffer nodeStream_;
+};
+
+/// Utility class for reading the compiled scene format. Attribute blocks are read directly from the source memory without copying, so a memory-mapped file can be loaded without intermediate buffers. The attribute layout of each type is bound to the attribute descriptions of its class once, and the fixed-size attributes are decoded from their precomputed offsets with type-specialized readers. Blocks shared by several objects are decoded only once.
+class URHO3D_API CompiledSceneReader
+{
+public:
+    /// Construct.
+    CompiledSceneReader();
+    /// Destruct.
+    ~CompiledSceneReader();
+
+    /// Open from memory, which must stay valid while the reader is used. Check the file ID and read the type and block tables. Return true if successful.
+    bool Open(const void* data, unsigned size);
+    /// Open from a stream. Read directly from memory if the stream is a memory buffer, otherwise read the remaining data into an internal buffer first. Return true if successful.
+    bool Open(Deserializer& source);
+    /// Load the attributes of an object from an attribute block encoded with the layout of a type. Attributes that no longer exist in the class are skipped. Return true if successful.
+    bool LoadAttributes(Serializable* object, unsigned typeIndex, unsigned blockIndex);
+
+    /// Return the stream for reading the node hierarchy.
+    MemoryBuffer& GetNodeStream() { return nodeStream_; }
+    /// Return object type by index, or zero hash if out of range.
+    StringHash GetType(unsigned index) const { return index < types_.Size() ? types_[index].type_ : StringHash::ZERO; }
+    /// Return number of attribute blocks.
+    unsigned GetNumBlocks() const { return blockSizes_.Size(); }
+    /// Return a read-only buffer to an attribute block. Return an empty buffer if out of range.
+    MemoryBuffer GetBlock(unsigned index) const;
+
+private:
+    /// Type table entry.
+    struct TypeInfo
+    {
+        /// Object type.
+        StringHash type_;
+        /// Attribute name hashes in the stored order.
+        PODVector<StringHash> names_;
+        /// Attribute value types in the stored order.
+        PODVector<VariantType> valueTypes_;
+        /// Offsets of the fixed-size attributes within an attribute block.
+        PODVector<unsigned> offsets_;
+        /// Readers of the fixed-size attributes.
+        PODVector<CompiledAttributeReader> readers_;
+        /// Total size of the fixed-size attributes.
+        unsigned fixedSize_;
+        /// Attribute descriptions the layout has been bound to, or null if not bound yet.
+        const Vector<AttributeInfo>* boundAttributes_;
+        /// Matching attribute description for each stored attribute, or null if the class no longer has it.
+        PODVector<const AttributeInfo*> bound_;
+    };
+
+    /// Decode an attribute block with the layout of a type. Return true if successful.
+    bool DecodeBlock(const TypeInfo& type, unsigned blockIndex, Vector<Variant>& values) const;
+
+    /// Data read from a stream.
+    SharedArrayPtr<unsigned char> buffer_;
+    /// Start of the block data.
+    const unsigned char* blockData_;
+    /// Object types and their attribute layouts.
+    Vector<TypeInfo> types_;
+    /// Attribute block start offsets into the block data.
+    PODVector<unsigned> blockOffsets_;
+    /// Attribute block sizes.
+    PODVector<unsigned> blockSizes_;
+    /// Whether each attribute block is shared by several objects.
+    PODVector<bool> blockShared_;
+    /// Decoded values of the shared attribute blocks, and the type index they were decoded with.
+    Vector<Pair<unsigned, Vector<Variant> > > decodedBlocks_;
+    /// Buffer for decoding attribute blocks that are not shared.
+    Vector<Variant> decodeBuffer_;
+    /// Node hierarchy.
+    MemoryBuffer nodeStream_;
+};
+
+}
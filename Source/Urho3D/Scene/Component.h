@@ -43,6 +43,16 @@ enum AutoRemoveMode
     REMOVE_NODE
 };
 
+/// Scene update phases during which components can be called directly by the scene, without going through update events.
+enum UpdatePhase
+{
+    UPDATE_PHASE_UPDATE = 0,
+    UPDATE_PHASE_POSTUPDATE,
+    UPDATE_PHASE_FIXEDUPDATE,
+    UPDATE_PHASE_FIXEDPOSTUPDATE,
+    MAX_UPDATE_PHASES
+};
+
 /// Base class for components. Components can be created to scene nodes.
 class URHO3D_API Component : public Animatable
 {
@@ -59,6 +69,8 @@ public:
 
     /// Handle enabled/disabled state change.
     virtual void OnSetEnabled() { }
+    /// Handle an update phase. Called by the scene when registered with Scene::AddUpdateComponent(), or from a worker thread on the update phase when registered with Scene::AddParallelUpdateComponent().
+    virtual void OnSceneUpdate(UpdatePhase phase, float timeStep) { }
 
     /// Save as binary data. Return true if successful.
     bool Save(Serializer& dest) const override;
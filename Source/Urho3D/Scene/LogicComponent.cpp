@@ -93,6 +93,7 @@ void LogicComponent::OnSceneSet(Scene* scene)
         UpdateEventSubscription();
     else
     {
+        // The scene has already removed this component from its direct update registry
         UnsubscribeFromEvent(E_SCENEUPDATE);
         UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
@@ -103,98 +104,199 @@ void LogicComponent::OnSceneSet(Scene* scene)
     }
 }
 
+void LogicComponent::OnSceneUpdate(UpdatePhase phase, float timeStep)
+{
+    switch (phase)
+    {
+    case UPDATE_PHASE_UPDATE:
+        // Execute user-defined delayed start function before first update
+        if (!delayedStartCalled_)
+        {
+            DelayedStart();
+            delayedStartCalled_ = true;
+
+            // If did not need actual update events, unsubscribe now
+            if (!(updateEventMask_ & USE_UPDATE))
+            {
+                SetEventSubscription(USE_UPDATE, false);
+                return;
+            }
+
+            // Move to the parallel update from the next frame on. This frame's update is still called on the main thread
+            if (updateEventMask_ & USE_PARALLELUPDATE)
+                UpdateEventSubscription();
+        }
+
+        // Then execute user-defined update function
+        Update(timeStep);
+        break;
+
+    case UPDATE_PHASE_POSTUPDATE:
+        PostUpdate(timeStep);
+        break;
+
+    case UPDATE_PHASE_FIXEDUPDATE:
+        // Execute user-defined delayed start function before first fixed update if not called yet
+        if (!delayedStartCalled_)
+        {
+            DelayedStart();
+            delayedStartCalled_ = true;
+        }
+
+        FixedUpdate(timeStep);
+        break;
+
+    case UPDATE_PHASE_FIXEDPOSTUPDATE:
+        FixedPostUpdate(timeStep);
+        break;
+
+    default:
+        break;
+    }
+}
+
 void LogicComponent::UpdateEventSubscription()
 {
     Scene* scene = GetScene();
     if (!scene)
         return;
 
-    bool enabled = IsEnabledEffective();
-
-    bool needUpdate = enabled && ((updateEventMask_ & USE_UPDATE) || !delayedStartCalled_);
-    if (needUpdate && !(currentEventMask_ & USE_UPDATE))
+    // When switching between direct calls and events, drop all subscriptions made the old way first
+    if ((currentEventMask_ ^ updateEventMask_) & USE_EVENTDISPATCH)
     {
-        SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(LogicComponent, HandleSceneUpdate));
-        currentEventMask_ |= USE_UPDATE;
-    }
-    else if (!needUpdate && (currentEventMask_ & USE_UPDATE))
-    {
-        UnsubscribeFromEvent(scene, E_SCENEUPDATE);
-        currentEventMask_ &= ~USE_UPDATE;
+        SetEventSubscription(USE_UPDATE, false);
+        SetEventSubscription(USE_POSTUPDATE, false);
+        SetEventSubscription(USE_FIXEDUPDATE, false);
+        SetEventSubscription(USE_FIXEDPOSTUPDATE, false);
+        currentEventMask_ ^= USE_EVENTDISPATCH;
     }
 
-    bool needPostUpdate = enabled && (updateEventMask_ & USE_POSTUPDATE);
-    if (needPostUpdate && !(currentEventMask_ & USE_POSTUPDATE))
-    {
-        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(LogicComponent, HandleScenePostUpdate));
-        currentEventMask_ |= USE_POSTUPDATE;
-    }
-    else if (!needPostUpdate && (currentEventMask_ & USE_POSTUPDATE))
+    // Likewise when switching the update between the main thread and the worker threads. DelayedStart() must be called on the main thread first
+    UpdateEventFlags parallelMask = USE_NO_EVENT;
+    if ((updateEventMask_ & USE_PARALLELUPDATE) && !(updateEventMask_ & USE_EVENTDISPATCH) && delayedStartCalled_)
+        parallelMask = USE_PARALLELUPDATE;
+    if ((currentEventMask_ ^ parallelMask) & USE_PARALLELUPDATE)
     {
-        UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
-        currentEventMask_ &= ~USE_POSTUPDATE;
+        SetEventSubscription(USE_UPDATE, false);
+        currentEventMask_ ^= USE_PARALLELUPDATE;
     }
 
+    bool enabled = IsEnabledEffective();
+
+    SetEventSubscription(USE_UPDATE, enabled && ((updateEventMask_ & USE_UPDATE) || !delayedStartCalled_));
+    SetEventSubscription(USE_POSTUPDATE, enabled && (updateEventMask_ & USE_POSTUPDATE));
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
-    Component* world = GetFixedUpdateSource();
-    if (!world)
+    SetEventSubscription(USE_FIXEDUPDATE, enabled && (updateEventMask_ & USE_FIXEDUPDATE));
+    SetEventSubscription(USE_FIXEDPOSTUPDATE, enabled && (updateEventMask_ & USE_FIXEDPOSTUPDATE));
+#endif
+}
+
+void LogicComponent::SetEventSubscription(UpdateEvent event, bool enable)
+{
+    if (enable == (bool)(currentEventMask_ & event))
         return;
 
-    bool needFixedUpdate = enabled && (updateEventMask_ & USE_FIXEDUPDATE);
-    if (needFixedUpdate && !(currentEventMask_ & USE_FIXEDUPDATE))
-    {
-        SubscribeToEvent(world, E_PHYSICSPRESTEP, URHO3D_HANDLER(LogicComponent, HandlePhysicsPreStep));
-        currentEventMask_ |= USE_FIXEDUPDATE;
-    }
-    else if (!needFixedUpdate && (currentEventMask_ & USE_FIXEDUPDATE))
-    {
-        UnsubscribeFromEvent(world, E_PHYSICSPRESTEP);
-        currentEventMask_ &= ~USE_FIXEDUPDATE;
-    }
+    Scene* scene = GetScene();
+    if (!scene)
+        return;
 
-    bool needFixedPostUpdate = enabled && (updateEventMask_ & USE_FIXEDPOSTUPDATE);
-    if (needFixedPostUpdate && !(currentEventMask_ & USE_FIXEDPOSTUPDATE))
+    if (!(currentEventMask_ & USE_EVENTDISPATCH))
     {
-        SubscribeToEvent(world, E_PHYSICSPOSTSTEP, URHO3D_HANDLER(LogicComponent, HandlePhysicsPostStep));
-        currentEventMask_ |= USE_FIXEDPOSTUPDATE;
+        UpdatePhase phase;
+        switch (event)
+        {
+        case USE_UPDATE:
+            phase = UPDATE_PHASE_UPDATE;
+            break;
+
+        case USE_POSTUPDATE:
+            phase = UPDATE_PHASE_POSTUPDATE;
+            break;
+
+        case USE_FIXEDUPDATE:
+            phase = UPDATE_PHASE_FIXEDUPDATE;
+            break;
+
+        case USE_FIXEDPOSTUPDATE:
+            phase = UPDATE_PHASE_FIXEDPOSTUPDATE;
+            break;
+
+        default:
+            return;
+        }
+
+        if ((currentEventMask_ & USE_PARALLELUPDATE) && phase == UPDATE_PHASE_UPDATE)
+        {
+            if (enable)
+                scene->AddParallelUpdateComponent(this);
+            else
+                scene->RemoveParallelUpdateComponent(this);
+        }
+        else if (enable)
+            scene->AddUpdateComponent(phase, this);
+        else
+            scene->RemoveUpdateComponent(phase, this);
     }
-    else if (!needFixedPostUpdate && (currentEventMask_ & USE_FIXEDPOSTUPDATE))
+    else
     {
-        UnsubscribeFromEvent(world, E_PHYSICSPOSTSTEP);
-        currentEventMask_ &= ~USE_FIXEDPOSTUPDATE;
-    }
+        switch (event)
+        {
+        case USE_UPDATE:
+            if (enable)
+                SubscribeToEvent(scene, E_SCENEUPDATE, URHO3D_HANDLER(LogicComponent, HandleSceneUpdate));
+            else
+                UnsubscribeFromEvent(scene, E_SCENEUPDATE);
+            break;
+
+        case USE_POSTUPDATE:
+            if (enable)
+                SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(LogicComponent, HandleScenePostUpdate));
+            else
+                UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
+            break;
+
+#if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
+        case USE_FIXEDUPDATE:
+        case USE_FIXEDPOSTUPDATE:
+            {
+                Component* world = GetFixedUpdateSource();
+                if (!world)
+                    return;
+
+                StringHash eventType = event == USE_FIXEDUPDATE ? E_PHYSICSPRESTEP : E_PHYSICSPOSTSTEP;
+                if (!enable)
+                    UnsubscribeFromEvent(world, eventType);
+                else if (event == USE_FIXEDUPDATE)
+                    SubscribeToEvent(world, eventType, URHO3D_HANDLER(LogicComponent, HandlePhysicsPreStep));
+                else
+                    SubscribeToEvent(world, eventType, URHO3D_HANDLER(LogicComponent, HandlePhysicsPostStep));
+            }
+            break;
 #endif
+
+        default:
+            return;
+        }
+    }
+
+    if (enable)
+        currentEventMask_ |= event;
+    else
+        currentEventMask_ &= ~event;
 }
 
 void LogicComponent::HandleSceneUpdate(StringHash eventType, VariantMap& eventData)
 {
     using namespace SceneUpdate;
 
-    // Execute user-defined delayed start function before first update
-    if (!delayedStartCalled_)
-    {
-        DelayedStart();
-        delayedStartCalled_ = true;
-
-        // If did not need actual update events, unsubscribe now
-        if (!(updateEventMask_ & USE_UPDATE))
-        {
-            UnsubscribeFromEvent(GetScene(), E_SCENEUPDATE);
-            currentEventMask_ &= ~USE_UPDATE;
-            return;
-        }
-    }
-
-    // Then execute user-defined update function
-    Update(eventData[P_TIMESTEP].GetFloat());
+    OnSceneUpdate(UPDATE_PHASE_UPDATE, eventData[P_TIMESTEP].GetFloat());
 }
 
 void LogicComponent::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
 {
     using namespace ScenePostUpdate;
 
-    // Execute user-defined post-update function
-    PostUpdate(eventData[P_TIMESTEP].GetFloat());
+    OnSceneUpdate(UPDATE_PHASE_POSTUPDATE, eventData[P_TIMESTEP].GetFloat());
 }
 
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
@@ -203,23 +305,14 @@ void LogicComponent::HandlePhysicsPreStep(StringHash eventType, VariantMap& even
 {
     using namespace PhysicsPreStep;
 
-    // Execute user-defined delayed start function before first fixed update if not called yet
-    if (!delayedStartCalled_)
-    {
-        DelayedStart();
-        delayedStartCalled_ = true;
-    }
-
-    // Execute user-defined fixed update function
-    FixedUpdate(eventData[P_TIMESTEP].GetFloat());
+    OnSceneUpdate(UPDATE_PHASE_FIXEDUPDATE, eventData[P_TIMESTEP].GetFloat());
 }
 
 void LogicComponent::HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData)
 {
     using namespace PhysicsPostStep;
 
-    // Execute user-defined fixed post-update function
-    FixedPostUpdate(eventData[P_TIMESTEP].GetFloat());
+    OnSceneUpdate(UPDATE_PHASE_FIXEDPOSTUPDATE, eventData[P_TIMESTEP].GetFloat());
 }
 
 #endif
@@ -42,10 +42,14 @@ enum UpdateEvent : unsigned
     USE_FIXEDUPDATE = 0x4,
     /// Bitmask for using the physics post-update event.
     USE_FIXEDPOSTUPDATE = 0x8,
+    /// Bitmask for receiving the updates through the scene and physics events instead of being called directly by the scene. Use when the update must be ordered relative to other event handlers.
+    USE_EVENTDISPATCH = 0x10,
+    /// Bitmask for allowing the scene to call Update() from the work queue's worker threads after DelayedStart() has been called. Update() must then only modify the component's own node and send events through Scene::DelayedSendEvent(). Has no effect together with USE_EVENTDISPATCH.
+    USE_PARALLELUPDATE = 0x20,
 };
 URHO3D_FLAGSET(UpdateEvent, UpdateEventFlags);
 
-/// Helper base class for user-defined game logic components that hooks up to update events and forwards them to virtual functions similar to ScriptInstance class.
+/// Helper base class for user-defined game logic components that hooks up to scene updates and forwards them to virtual functions similar to ScriptInstance class. By default the scene calls the components directly, grouped by type, before sending the corresponding update event.
 class URHO3D_API LogicComponent : public Component
 {
     URHO3D_OBJECT(LogicComponent, Component);
@@ -57,6 +61,8 @@ class URHO3D_API LogicComponent : public Component
 
     /// Handle enabled/disabled state change. Changes update event subscription.
     void OnSetEnabled() override;
+    /// Handle an update phase called directly by the scene.
+    void OnSceneUpdate(UpdatePhase phase, float timeStep) override;
 
     /// Called when the component is added to a scene node. Other components may not yet exist.
     virtual void Start() { }
@@ -67,7 +73,7 @@ class URHO3D_API LogicComponent : public Component
     /// Called when the component is detached from a scene node, usually on destruction. Note that you will no longer have access to the node and scene at that point.
     virtual void Stop() { }
 
-    /// Called on scene update, variable timestep.
+    /// Called on scene update, variable timestep. May be called from a worker thread if USE_PARALLELUPDATE is set in the update event mask.
     virtual void Update(float timeStep);
     /// Called on scene post-update, variable timestep.
     virtual void PostUpdate(float timeStep);
@@ -94,6 +100,8 @@ protected:
 private:
     /// Subscribe/unsubscribe to update events based on current enabled state and update event mask.
     void UpdateEventSubscription();
+    /// Subscribe/unsubscribe to one update event, either through the scene's direct update registry or the event itself.
+    void SetEventSubscription(UpdateEvent event, bool enable);
     /// Handle scene update event.
     void HandleSceneUpdate(StringHash eventType, VariantMap& eventData);
     /// Handle scene post-update event.
@@ -28,6 +28,7 @@
 #include "../IO/MemoryBuffer.h"
 #include "../Resource/XMLFile.h"
 #include "../Resource/JSONFile.h"
+#include "../Scene/CompiledScene.h"
 #include "../Scene/Component.h"
 #include "../Scene/ObjectAnimation.h"
 #include "../Scene/ReplicationState.h"
@@ -1590,6 +1591,133 @@ bool Node::Load(Deserializer& source, SceneResolver& resolver, bool loadChildren
     return true;
 }
 
+bool Node::LoadCompiled(CompiledSceneReader& source, SceneResolver& resolver, bool rewriteIDs, CreateMode mode)
+{
+    // Remove all children and components first in case this is not a fresh load
+    RemoveAllChildren();
+    RemoveAllComponents();
+
+    MemoryBuffer& nodeStream = source.GetNodeStream();
+
+    // ID has been read at the parent level. The type entry tells whether the attribute block uses the layout of the type
+    // or is raw binary data
+    unsigned typeEntry = nodeStream.ReadVLE();
+    unsigned blockIndex = nodeStream.ReadVLE();
+    if (typeEntry & 1u)
+    {
+        MemoryBuffer attrBlock = source.GetBlock(blockIndex);
+        if (!Animatable::Load(attrBlock))
+            return false;
+    }
+    else if (!source.LoadAttributes(this, typeEntry >> 1u, blockIndex))
+        return false;
+
+    unsigned numComponents = nodeStream.ReadVLE();
+    for (unsigned i = 0; i < numComponents; ++i)
+    {
+        typeEntry = nodeStream.ReadVLE();
+        StringHash compType = source.GetType(typeEntry >> 1u);
+        unsigned compID = nodeStream.ReadUInt();
+        blockIndex = nodeStream.ReadVLE();
+
+        Component* newComponent = SafeCreateComponent(String::EMPTY, compType,
+            (mode == REPLICATED && Scene::IsReplicatedID(compID)) ? REPLICATED : LOCAL, rewriteIDs ? 0 : compID);
+        if (newComponent)
+        {
+            resolver.AddComponent(compID, newComponent);
+            // Do not abort if component fails to load, as the attribute block is separate and we can skip to the next
+            if (typeEntry & 1u)
+            {
+                MemoryBuffer compBlock = source.GetBlock(blockIndex);
+                newComponent->Load(compBlock);
+            }
+            else
+                source.LoadAttributes(newComponent, typeEntry >> 1u, blockIndex);
+        }
+    }
+
+    unsigned numChildren = nodeStream.ReadVLE();
+    for (unsigned i = 0; i < numChildren; ++i)
+    {
+        if (nodeStream.IsEof())
+        {
+            URHO3D_LOGERROR("Compiled scene node hierarchy is truncated");
+            return false;
+        }
+
+        unsigned nodeID = nodeStream.ReadUInt();
+        Node* newNode = CreateChild(rewriteIDs ? 0 : nodeID, (mode == REPLICATED && Scene::IsReplicatedID(nodeID)) ? REPLICATED :
+            LOCAL);
+        resolver.AddNode(nodeID, newNode);
+        if (!newNode->LoadCompiled(source, resolver, rewriteIDs, mode))
+            return false;
+    }
+
+    return true;
+}
+
+bool Node::SaveCompiled(CompiledSceneWriter& dest) const
+{
+    VectorBuffer& nodeStream = dest.GetNodeStream();
+
+    // Write node ID
+    nodeStream.WriteUInt(id_);
+
+    // Write attributes with the layout of the type, or as raw binary data if the attribute descriptions are per-instance
+    bool compiled;
+    unsigned typeIndex = dest.AddType(this, compiled);
+    nodeStream.WriteVLE(typeIndex << 1u | (compiled ? 0u : 1u));
+    if (compiled)
+        nodeStream.WriteVLE(dest.AddAttributes(this, typeIndex));
+    else
+    {
+        VectorBuffer attrBuffer;
+        if (!Animatable::Save(attrBuffer))
+            return false;
+        nodeStream.WriteVLE(dest.AddBlock(attrBuffer.GetData(), attrBuffer.GetSize()));
+    }
+
+    // Write components. The type and ID are stored separately so that the attribute blocks of identical components can be
+    // shared. Components with per-instance attribute descriptions, like script instances, are saved as raw binary data
+    // without the type and ID in front
+    static const unsigned COMPONENT_HEADER_SIZE = 2 * sizeof(unsigned);
+    nodeStream.WriteVLE(GetNumPersistentComponents());
+    for (unsigned i = 0; i < components_.Size(); ++i)
+    {
+        Component* component = components_[i];
+        if (component->IsTemporary())
+            continue;
+
+        typeIndex = dest.AddType(component, compiled);
+        nodeStream.WriteVLE(typeIndex << 1u | (compiled ? 0u : 1u));
+        nodeStream.WriteUInt(component->GetID());
+        if (compiled)
+            nodeStream.WriteVLE(dest.AddAttributes(component, typeIndex));
+        else
+        {
+            VectorBuffer compBuffer;
+            if (!component->Save(compBuffer) || compBuffer.GetSize() < COMPONENT_HEADER_SIZE)
+                return false;
+            nodeStream.WriteVLE(dest.AddBlock(compBuffer.GetData() + COMPONENT_HEADER_SIZE, compBuffer.GetSize() -
+                COMPONENT_HEADER_SIZE));
+        }
+    }
+
+    // Write child nodes
+    nodeStream.WriteVLE(GetNumPersistentChildren());
+    for (unsigned i = 0; i < children_.Size(); ++i)
+    {
+        Node* node = children_[i];
+        if (node->IsTemporary())
+            continue;
+
+        if (!node->SaveCompiled(dest))
+            return false;
+    }
+
+    return true;
+}
+
 bool Node::LoadXML(const XMLElement& source, SceneResolver& resolver, bool loadChildren, bool rewriteIDs, CreateMode mode)
 {
     // Remove all children and components first in case this is not a fresh load
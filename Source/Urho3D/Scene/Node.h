@@ -31,6 +31,8 @@
 namespace Urho3D
 {
 
+class CompiledSceneReader;
+class CompiledSceneWriter;
 class Component;
 class Connection;
 class Node;
@@ -600,6 +602,10 @@ public:
     /// Load components from XML data and optionally load child nodes.
     bool LoadXML(const XMLElement& source, SceneResolver& resolver, bool loadChildren = true, bool rewriteIDs = false,
         CreateMode mode = REPLICATED);
+    /// Load components and child nodes from compiled scene data.
+    bool LoadCompiled(CompiledSceneReader& source, SceneResolver& resolver, bool rewriteIDs = false, CreateMode mode = REPLICATED);
+    /// Save ID, attributes, components and child nodes as compiled scene data. Return true if successful.
+    bool SaveCompiled(CompiledSceneWriter& dest) const;
     /// Load components from XML data and optionally load child nodes.
     bool LoadJSON(const JSONValue& source, SceneResolver& resolver, bool loadChildren = true, bool rewriteIDs = false,
         CreateMode mode = REPLICATED);
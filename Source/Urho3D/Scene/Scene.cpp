@@ -33,6 +33,7 @@
 #include "../Resource/ResourceEvents.h"
 #include "../Resource/XMLFile.h"
 #include "../Resource/JSONFile.h"
+#include "../Scene/CompiledScene.h"
 #include "../Scene/Component.h"
 #include "../Scene/ObjectAnimation.h"
 #include "../Scene/ReplicationState.h"
@@ -48,12 +49,31 @@
 namespace Urho3D
 {
 
+static void UpdateComponentsWork(const WorkItem* item, unsigned threadIndex)
+{
+    float timeStep = *(reinterpret_cast<float*>(item->aux_));
+    auto** start = reinterpret_cast<Component**>(item->start_);
+    auto** end = reinterpret_cast<Component**>(item->end_);
+
+    while (start != end)
+    {
+        Component* component = *start;
+        if (component)
+            component->OnSceneUpdate(UPDATE_PHASE_UPDATE, timeStep);
+        ++start;
+    }
+}
+
 const char* SCENE_CATEGORY = "Scene";
 const char* LOGIC_CATEGORY = "Logic";
 const char* SUBSYSTEM_CATEGORY = "Subsystem";
 
 static const float DEFAULT_SMOOTHING_CONSTANT = 50.0f;
 static const float DEFAULT_SNAP_THRESHOLD = 5.0f;
+static const float DEFAULT_INTERPOLATION_DELAY = 0.0f;
+static const float DEFAULT_MAX_EXTRAPOLATION = 0.1f;
+static const double SERVER_TIME_RESYNC_THRESHOLD = 1.0;
+static const double SERVER_TIME_OFFSET_SMOOTHING = 0.1;
 
 Scene::Scene(Context* context) :
     Node(context),
@@ -67,9 +87,18 @@ Scene::Scene(Context* context) :
     elapsedTime_(0),
     smoothingConstant_(DEFAULT_SMOOTHING_CONSTANT),
     snapThreshold_(DEFAULT_SNAP_THRESHOLD),
+    interpolationDelay_(DEFAULT_INTERPOLATION_DELAY),
+    maxExtrapolation_(DEFAULT_MAX_EXTRAPOLATION),
+    smoothingTime_(0.0),
+    serverTime_(0.0),
+    serverTimeOffset_(0.0),
+    hasServerTime_(false),
     updateEnabled_(true),
     asyncLoading_(false),
-    threadedUpdate_(false)
+    threadedAsyncLoading_(false),
+    threadedUpdate_(false),
+    updateComponentsDirty_(),
+    parallelUpdateComponentsDirty_(false)
 {
     // Assign an ID to self so that nodes can refer to this node as a parent
     SetID(GetFreeNodeID(REPLICATED));
@@ -81,6 +110,10 @@ Scene::Scene(Context* context) :
 
 Scene::~Scene()
 {
+    // Wait for a worker thread that may still be reading a file for asynchronous loading
+    if (asyncProgress_.workItem_)
+        StopAsyncLoading();
+
     // Remove root-level components first, so that scene subsystems such as the octree destroy themselves. This will speed up
     // the removal of child nodes' components
     RemoveAllComponents();
@@ -102,6 +135,10 @@ void Scene::RegisterObject(Context* context)
     URHO3D_ACCESSOR_ATTRIBUTE("Smoothing Constant", GetSmoothingConstant, SetSmoothingConstant, float, DEFAULT_SMOOTHING_CONSTANT,
         AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Snap Threshold", GetSnapThreshold, SetSnapThreshold, float, DEFAULT_SNAP_THRESHOLD, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Interpolation Delay", GetInterpolationDelay, SetInterpolationDelay, float,
+        DEFAULT_INTERPOLATION_DELAY, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Max Extrapolation", GetMaxExtrapolation, SetMaxExtrapolation, float, DEFAULT_MAX_EXTRAPOLATION,
+        AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Elapsed Time", GetElapsedTime, SetElapsedTime, float, 0.0f, AM_FILE);
     URHO3D_ATTRIBUTE("Next Replicated Node ID", unsigned, replicatedNodeID_, FIRST_REPLICATED_ID, AM_FILE | AM_NOEDIT);
     URHO3D_ATTRIBUTE("Next Replicated Component ID", unsigned, replicatedComponentID_, FIRST_REPLICATED_ID, AM_FILE | AM_NOEDIT);
@@ -306,6 +343,283 @@ bool Scene::SaveJSON(Serializer& dest, const String& indentation) const
         return false;
 }
 
+bool Scene::LoadCompiled(Deserializer& source)
+{
+    URHO3D_PROFILE(LoadCompiledScene);
+
+    StopAsyncLoading();
+
+    CompiledSceneReader reader;
+    if (!reader.Open(source))
+    {
+        URHO3D_LOGERROR(source.GetName() + " is not a valid compiled scene file");
+        return false;
+    }
+
+    URHO3D_LOGINFO("Loading compiled scene from " + source.GetName());
+
+    Clear();
+
+    SceneResolver resolver;
+    // Read own ID. Will not be applied, only stored for resolving possible references
+    unsigned nodeID = reader.GetNodeStream().ReadUInt();
+    resolver.AddNode(nodeID, this);
+
+    // Load the whole scene, then perform post-load if successfully loaded
+    if (Node::LoadCompiled(reader, resolver))
+    {
+        resolver.Resolve();
+        ApplyAttributes();
+        FinishLoading(&source);
+        return true;
+    }
+    else
+        return false;
+}
+
+bool Scene::LoadCompiled(const void* data, unsigned size)
+{
+    MemoryBuffer source(data, size);
+    return LoadCompiled(source);
+}
+
+bool Scene::SaveCompiled(Serializer& dest) const
+{
+    URHO3D_PROFILE(SaveCompiledScene);
+
+    auto* ptr = dynamic_cast<Deserializer*>(&dest);
+    if (ptr)
+        URHO3D_LOGINFO("Saving compiled scene to " + ptr->GetName());
+
+    CompiledSceneWriter writer;
+    if (!Node::SaveCompiled(writer))
+        return false;
+
+    if (!writer.Write(dest))
+    {
+        URHO3D_LOGERROR("Could not save compiled scene, writing to stream failed");
+        return false;
+    }
+
+    FinishSaving(&dest);
+    return true;
+}
+
+/// Find resources referenced by component attributes in a binary scene or object prefab file.
+static void CollectResources(Context* context, Deserializer& source, bool isSceneFile, Vector<ResourceRef>& dest)
+{
+    // If not threaded, can not background load resources, so rather load synchronously later when needed
+#ifdef URHO3D_THREADING
+    // Read node ID (not needed)
+    /*unsigned nodeID = */source.ReadUInt();
+
+    // Read Node or Scene attributes; these do not include any resources
+    const Vector<AttributeInfo>* attributes = context->GetAttributes(isSceneFile ? Scene::GetTypeStatic() : Node::GetTypeStatic());
+    assert(attributes);
+
+    for (unsigned i = 0; i < attributes->Size(); ++i)
+    {
+        const AttributeInfo& attr = attributes->At(i);
+        if (!(attr.mode_ & AM_FILE))
+            continue;
+        /*Variant varValue = */source.ReadVariant(attr.type_);
+    }
+
+    // Read component attributes
+    unsigned numComponents = source.ReadVLE();
+    for (unsigned i = 0; i < numComponents; ++i)
+    {
+        VectorBuffer compBuffer(source, source.ReadVLE());
+        StringHash compType = compBuffer.ReadStringHash();
+        // Read component ID (not needed)
+        /*unsigned compID = */compBuffer.ReadUInt();
+
+        attributes = context->GetAttributes(compType);
+        if (attributes)
+        {
+            for (unsigned j = 0; j < attributes->Size(); ++j)
+            {
+                const AttributeInfo& attr = attributes->At(j);
+                if (!(attr.mode_ & AM_FILE))
+                    continue;
+                Variant varValue = compBuffer.ReadVariant(attr.type_);
+                if (attr.type_ == VAR_RESOURCEREF)
+                    dest.Push(varValue.GetResourceRef());
+                else if (attr.type_ == VAR_RESOURCEREFLIST)
+                {
+                    const ResourceRefList& refList = varValue.GetResourceRefList();
+                    for (unsigned k = 0; k < refList.names_.Size(); ++k)
+                        dest.Push(ResourceRef(refList.type_, refList.names_[k]));
+                }
+            }
+        }
+    }
+
+    // Read child nodes
+    unsigned numChildren = source.ReadVLE();
+    for (unsigned i = 0; i < numChildren; ++i)
+        CollectResources(context, source, false, dest);
+#endif
+}
+
+/// Find resources referenced by component attributes in an XML scene or object prefab file.
+static void CollectResourcesXML(Context* context, const XMLElement& element, Vector<ResourceRef>& dest)
+{
+    // If not threaded, can not background load resources, so rather load synchronously later when needed
+#ifdef URHO3D_THREADING
+    // Node or Scene attributes do not include any resources; therefore skip to the components
+    XMLElement compElem = element.GetChild("component");
+    while (compElem)
+    {
+        String typeName = compElem.GetAttribute("type");
+        const Vector<AttributeInfo>* attributes = context->GetAttributes(StringHash(typeName));
+        if (attributes)
+        {
+            XMLElement attrElem = compElem.GetChild("attribute");
+            unsigned startIndex = 0;
+
+            while (attrElem)
+            {
+                String name = attrElem.GetAttribute("name");
+                unsigned i = startIndex;
+                unsigned attempts = attributes->Size();
+
+                while (attempts)
+                {
+                    const AttributeInfo& attr = attributes->At(i);
+                    if ((attr.mode_ & AM_FILE) && !attr.name_.Compare(name, true))
+                    {
+                        if (attr.type_ == VAR_RESOURCEREF)
+                            dest.Push(attrElem.GetVariantValue(attr.type_).GetResourceRef());
+                        else if (attr.type_ == VAR_RESOURCEREFLIST)
+                        {
+                            ResourceRefList refList = attrElem.GetVariantValue(attr.type_).GetResourceRefList();
+                            for (unsigned k = 0; k < refList.names_.Size(); ++k)
+                                dest.Push(ResourceRef(refList.type_, refList.names_[k]));
+                        }
+
+                        startIndex = (i + 1) % attributes->Size();
+                        break;
+                    }
+                    else
+                    {
+                        i = (i + 1) % attributes->Size();
+                        --attempts;
+                    }
+                }
+
+                attrElem = attrElem.GetNext("attribute");
+            }
+        }
+
+        compElem = compElem.GetNext("component");
+    }
+
+    XMLElement childElem = element.GetChild("node");
+    while (childElem)
+    {
+        CollectResourcesXML(context, childElem, dest);
+        childElem = childElem.GetNext("node");
+    }
+#endif
+}
+
+/// Find resources referenced by component attributes in a JSON scene or object prefab file.
+static void CollectResourcesJSON(Context* context, const JSONValue& value, Vector<ResourceRef>& dest)
+{
+    // If not threaded, can not background load resources, so rather load synchronously later when needed
+#ifdef URHO3D_THREADING
+    // Node or Scene attributes do not include any resources; therefore skip to the components
+    JSONArray componentArray = value.Get("components").GetArray();
+
+    for (unsigned i = 0; i < componentArray.Size(); i++)
+    {
+        const JSONValue& compValue = componentArray.At(i);
+        String typeName = compValue.Get("type").GetString();
+
+        const Vector<AttributeInfo>* attributes = context->GetAttributes(StringHash(typeName));
+        if (attributes)
+        {
+            JSONArray attributesArray = compValue.Get("attributes").GetArray();
+
+            unsigned startIndex = 0;
+
+            for (unsigned j = 0; j < attributesArray.Size(); j++)
+            {
+                const JSONValue& attrVal = attributesArray.At(j);
+                String name = attrVal.Get("name").GetString();
+                unsigned i = startIndex;
+                unsigned attempts = attributes->Size();
+
+                while (attempts)
+                {
+                    const AttributeInfo& attr = attributes->At(i);
+                    if ((attr.mode_ & AM_FILE) && !attr.name_.Compare(name, true))
+                    {
+                        if (attr.type_ == VAR_RESOURCEREF)
+                            dest.Push(attrVal.Get("value").GetVariantValue(attr.type_).GetResourceRef());
+                        else if (attr.type_ == VAR_RESOURCEREFLIST)
+                        {
+                            ResourceRefList refList = attrVal.Get("value").GetVariantValue(attr.type_).GetResourceRefList();
+                            for (unsigned k = 0; k < refList.names_.Size(); ++k)
+                                dest.Push(ResourceRef(refList.type_, refList.names_[k]));
+                        }
+
+                        startIndex = (i + 1) % attributes->Size();
+                        break;
+                    }
+                    else
+                    {
+                        i = (i + 1) % attributes->Size();
+                        --attempts;
+                    }
+                }
+            }
+        }
+    }
+
+    JSONArray childrenArray = value.Get("children").GetArray();
+    for (unsigned i = 0; i < childrenArray.Size(); i++)
+    {
+        const JSONValue& childVal = childrenArray.At(i);
+        CollectResourcesJSON(context, childVal, dest);
+    }
+#endif
+}
+
+/// Read a scene or object prefab file for asynchronous loading and find the resources to preload on a worker thread.
+static void ReadAsyncSceneWork(const WorkItem* item, unsigned /*threadIndex*/)
+{
+    AsyncProgress& progress = *reinterpret_cast<AsyncProgress*>(item->aux_);
+    File& file = *progress.file_;
+    bool findResources = progress.mode_ != LOAD_SCENE;
+
+    if (progress.xmlFile_)
+    {
+        progress.readSuccess_ = progress.xmlFile_->Load(file);
+        if (progress.readSuccess_ && findResources)
+            CollectResourcesXML(file.GetContext(), progress.xmlFile_->GetRoot(), progress.resourceRefs_);
+    }
+    else if (progress.jsonFile_)
+    {
+        progress.readSuccess_ = progress.jsonFile_->Load(file);
+        if (progress.readSuccess_ && findResources)
+            CollectResourcesJSON(file.GetContext(), progress.jsonFile_->GetRoot(), progress.resourceRefs_);
+    }
+    else
+    {
+        // Read the rest of the file into memory, so that the nodes can be instantiated without further file access
+        unsigned size = file.GetSize() - file.GetPosition();
+        progress.buffer_.SetData(file, size);
+        progress.readSuccess_ = progress.buffer_.GetSize() == size;
+        if (progress.readSuccess_ && findResources)
+        {
+            CollectResources(file.GetContext(), progress.buffer_, progress.isSceneFile_, progress.resourceRefs_);
+            progress.buffer_.Seek(0);
+        }
+    }
+}
+
 bool Scene::LoadAsync(File* file, LoadMode mode)
 {
     if (!file)
@@ -335,45 +649,40 @@ bool Scene::LoadAsync(File* file, LoadMode mode)
         URHO3D_LOGINFO("Loading scene from " + file->GetName());
         Clear();
     }
+    else
+        URHO3D_LOGINFO("Preloading resources from " + file->GetName());
 
     asyncLoading_ = true;
     asyncProgress_.file_ = file;
     asyncProgress_.mode_ = mode;
+    asyncProgress_.isSceneFile_ = isSceneFile;
     asyncProgress_.loadedNodes_ = asyncProgress_.totalNodes_ = asyncProgress_.loadedResources_ = asyncProgress_.totalResources_ = 0;
     asyncProgress_.resources_.Clear();
 
-    if (mode > LOAD_RESOURCES_ONLY)
+    // In threaded mode read the file into memory and find the resources on a worker thread
+    WorkQueue* queue = GetAsyncLoadingQueue();
+    if (queue)
     {
-        // Preload resources if appropriate, then return to the original position for loading the scene content
-        if (mode != LOAD_SCENE)
-        {
-            URHO3D_PROFILE(FindResourcesToPreload);
-
-            unsigned currentPos = file->GetPosition();
-            PreloadResources(file, isSceneFile);
-            file->Seek(currentPos);
-        }
-
-        // Store own old ID for resolving possible root node references
-        unsigned nodeID = file->ReadUInt();
-        resolver_.AddNode(nodeID, this);
-
-        // Load root level components first
-        if (!Node::Load(*file, resolver_, false))
-        {
-            StopAsyncLoading();
-            return false;
-        }
-
-        // Then prepare to load child nodes in the async updates
-        asyncProgress_.totalNodes_ = file->ReadVLE();
+        StartAsyncRead(queue);
+        return true;
     }
-    else
+
+    // Preload resources if appropriate, then return to the original position for loading the scene content
+    if (mode != LOAD_SCENE)
     {
         URHO3D_PROFILE(FindResourcesToPreload);
 
-        URHO3D_LOGINFO("Preloading resources from " + file->GetName());
-        PreloadResources(file, isSceneFile);
+        Vector<ResourceRef> resources;
+        unsigned currentPos = file->GetPosition();
+        CollectResources(context_, *file, isSceneFile, resources);
+        file->Seek(currentPos);
+        PreloadResources(resources);
+    }
+
+    if (mode > LOAD_RESOURCES_ONLY && !StartAsyncLoadingNodes())
+    {
+        StopAsyncLoading();
+        return false;
     }
 
     return true;
@@ -389,8 +698,10 @@ bool Scene::LoadAsyncXML(File* file, LoadMode mode)
 
     StopAsyncLoading();
 
+    // In threaded mode the file is parsed on a worker thread
+    WorkQueue* queue = GetAsyncLoadingQueue();
     SharedPtr<XMLFile> xml(new XMLFile(context_));
-    if (!xml->Load(*file))
+    if (!queue && !xml->Load(*file))
         return false;
 
     if (mode > LOAD_RESOURCES_ONLY)
@@ -398,6 +709,8 @@ bool Scene::LoadAsyncXML(File* file, LoadMode mode)
         URHO3D_LOGINFO("Loading scene from " + file->GetName());
         Clear();
     }
+    else
+        URHO3D_LOGINFO("Preloading resources from " + file->GetName());
 
     asyncLoading_ = true;
     asyncProgress_.xmlFile_ = xml;
@@ -406,43 +719,26 @@ bool Scene::LoadAsyncXML(File* file, LoadMode mode)
     asyncProgress_.loadedNodes_ = asyncProgress_.totalNodes_ = asyncProgress_.loadedResources_ = asyncProgress_.totalResources_ = 0;
     asyncProgress_.resources_.Clear();
 
-    if (mode > LOAD_RESOURCES_ONLY)
+    if (queue)
     {
-        XMLElement rootElement = xml->GetRoot();
-
-        // Preload resources if appropriate
-        if (mode != LOAD_SCENE)
-        {
-            URHO3D_PROFILE(FindResourcesToPreload);
-
-            PreloadResourcesXML(rootElement);
-        }
-
-        // Store own old ID for resolving possible root node references
-        unsigned nodeID = rootElement.GetUInt("id");
-        resolver_.AddNode(nodeID, this);
-
-        // Load the root level components first
-        if (!Node::LoadXML(rootElement, resolver_, false))
-            return false;
-
-        // Then prepare for loading all root level child nodes in the async update
-        XMLElement childNodeElement = rootElement.GetChild("node");
-        asyncProgress_.xmlElement_ = childNodeElement;
-
-        // Count the amount of child nodes
-        while (childNodeElement)
-        {
-            ++asyncProgress_.totalNodes_;
-            childNodeElement = childNodeElement.GetNext("node");
-        }
+        StartAsyncRead(queue);
+        return true;
     }
-    else
+
+    // Preload resources if appropriate
+    if (mode != LOAD_SCENE)
     {
         URHO3D_PROFILE(FindResourcesToPreload);
 
-        URHO3D_LOGINFO("Preloading resources from " + file->GetName());
-        PreloadResourcesXML(xml->GetRoot());
+        Vector<ResourceRef> resources;
+        CollectResourcesXML(context_, xml->GetRoot(), resources);
+        PreloadResources(resources);
+    }
+
+    if (mode > LOAD_RESOURCES_ONLY && !StartAsyncLoadingNodes())
+    {
+        StopAsyncLoading();
+        return false;
     }
 
     return true;
@@ -458,8 +754,10 @@ bool Scene::LoadAsyncJSON(File* file, LoadMode mode)
 
     StopAsyncLoading();
 
+    // In threaded mode the file is parsed on a worker thread
+    WorkQueue* queue = GetAsyncLoadingQueue();
     SharedPtr<JSONFile> json(new JSONFile(context_));
-    if (!json->Load(*file))
+    if (!queue && !json->Load(*file))
         return false;
 
     if (mode > LOAD_RESOURCES_ONLY)
@@ -467,6 +765,8 @@ bool Scene::LoadAsyncJSON(File* file, LoadMode mode)
         URHO3D_LOGINFO("Loading scene from " + file->GetName());
         Clear();
     }
+    else
+        URHO3D_LOGINFO("Preloading resources from " + file->GetName());
 
     asyncLoading_ = true;
     asyncProgress_.jsonFile_ = json;
@@ -475,39 +775,26 @@ bool Scene::LoadAsyncJSON(File* file, LoadMode mode)
     asyncProgress_.loadedNodes_ = asyncProgress_.totalNodes_ = asyncProgress_.loadedResources_ = asyncProgress_.totalResources_ = 0;
     asyncProgress_.resources_.Clear();
 
-    if (mode > LOAD_RESOURCES_ONLY)
+    if (queue)
     {
-        JSONValue rootVal = json->GetRoot();
-
-        // Preload resources if appropriate
-        if (mode != LOAD_SCENE)
-        {
-            URHO3D_PROFILE(FindResourcesToPreload);
-
-            PreloadResourcesJSON(rootVal);
-        }
-
-        // Store own old ID for resolving possible root node references
-        unsigned nodeID = rootVal.Get("id").GetUInt();
-        resolver_.AddNode(nodeID, this);
-
-        // Load the root level components first
-        if (!Node::LoadJSON(rootVal, resolver_, false))
-            return false;
-
-        // Then prepare for loading all root level child nodes in the async update
-        JSONArray childrenArray = rootVal.Get("children").GetArray();
-        asyncProgress_.jsonIndex_ = 0;
-
-        // Count the amount of child nodes
-        asyncProgress_.totalNodes_ = childrenArray.Size();
+        StartAsyncRead(queue);
+        return true;
     }
-    else
+
+    // Preload resources if appropriate
+    if (mode != LOAD_SCENE)
     {
         URHO3D_PROFILE(FindResourcesToPreload);
 
-        URHO3D_LOGINFO("Preloading resources from " + file->GetName());
-        PreloadResourcesJSON(json->GetRoot());
+        Vector<ResourceRef> resources;
+        CollectResourcesJSON(context_, json->GetRoot(), resources);
+        PreloadResources(resources);
+    }
+
+    if (mode > LOAD_RESOURCES_ONLY && !StartAsyncLoadingNodes())
+    {
+        StopAsyncLoading();
+        return false;
     }
 
     return true;
@@ -515,6 +802,15 @@ bool Scene::LoadAsyncJSON(File* file, LoadMode mode)
 
 void Scene::StopAsyncLoading()
 {
+    // If the worker thread is already reading the file, wait for it, as it uses the asynchronous loading progress
+    if (asyncProgress_.workItem_)
+    {
+        auto* queue = GetSubsystem<WorkQueue>();
+        if (queue && !queue->RemoveWorkItem(asyncProgress_.workItem_))
+            queue->CompleteItem(asyncProgress_.workItem_);
+        asyncProgress_.workItem_.Reset();
+    }
+
     asyncLoading_ = false;
     asyncProgress_.file_.Reset();
     asyncProgress_.xmlFile_.Reset();
@@ -522,6 +818,9 @@ void Scene::StopAsyncLoading()
     asyncProgress_.xmlElement_ = XMLElement::EMPTY;
     asyncProgress_.jsonIndex_ = 0;
     asyncProgress_.resources_.Clear();
+    asyncProgress_.buffer_.Clear();
+    asyncProgress_.resourceRefs_.Clear();
+    asyncProgress_.threaded_ = false;
     resolver_.Reset();
 }
 
@@ -664,11 +963,43 @@ void Scene::SetSnapThreshold(float threshold)
     Node::MarkNetworkUpdate();
 }
 
+void Scene::SetInterpolationDelay(float delay)
+{
+    interpolationDelay_ = Max(delay, 0.0f);
+    Node::MarkNetworkUpdate();
+}
+
+void Scene::SetMaxExtrapolation(float time)
+{
+    maxExtrapolation_ = Max(time, 0.0f);
+    Node::MarkNetworkUpdate();
+}
+
+void Scene::SetServerTime(double time)
+{
+    // Each update arrives later than the server sent it by a varying latency. Average the offset over the updates so that
+    // interpolation runs at the server's pace instead of replaying the jitter, but follow a large change such as a new server
+    // at once. Messages of the same update carry the same time, so they count only once
+    double offset = time - smoothingTime_;
+    if (!hasServerTime_ || Abs(offset - serverTimeOffset_) > SERVER_TIME_RESYNC_THRESHOLD)
+        serverTimeOffset_ = offset;
+    else if (time != serverTime_)
+        serverTimeOffset_ += (offset - serverTimeOffset_) * SERVER_TIME_OFFSET_SMOOTHING;
+
+    serverTime_ = time;
+    hasServerTime_ = true;
+}
+
 void Scene::SetAsyncLoadingMs(int ms)
 {
     asyncLoadingMs_ = Max(ms, 1);
 }
 
+void Scene::SetThreadedAsyncLoading(bool enable)
+{
+    threadedAsyncLoading_ = enable;
+}
+
 void Scene::SetElapsedTime(float time)
 {
     elapsedTime_ = time;
@@ -746,6 +1077,10 @@ Component* Scene::GetComponent(unsigned id) const
 
 float Scene::GetAsyncProgress() const
 {
+    // The amount of nodes and resources is not known while a worker thread is still reading the file
+    if (asyncLoading_ && asyncProgress_.workItem_)
+        return 0.0f;
+
     return !asyncLoading_ || asyncProgress_.totalNodes_ + asyncProgress_.totalResources_ == 0 ? 1.0f :
         (float)(asyncProgress_.loadedNodes_ + asyncProgress_.loadedResources_) /
         (float)(asyncProgress_.totalNodes_ + asyncProgress_.totalResources_);
@@ -767,78 +1102,282 @@ void Scene::Update(float timeStep)
             return;
     }
 
-    URHO3D_PROFILE(UpdateScene);
-
-    timeStep *= timeScale_;
-
-    using namespace SceneUpdate;
-
-    VariantMap& eventData = GetEventDataMap();
-    eventData[P_SCENE] = this;
-    eventData[P_TIMESTEP] = timeStep;
+    URHO3D_PROFILE(UpdateScene);
+
+    timeStep *= timeScale_;
+
+    using namespace SceneUpdate;
+
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_SCENE] = this;
+    eventData[P_TIMESTEP] = timeStep;
+
+    // Update variable timestep logic, first the thread-safe components on the worker threads
+    UpdateParallelComponents(timeStep);
+    UpdateComponents(UPDATE_PHASE_UPDATE, timeStep);
+    SendEvent(E_SCENEUPDATE, eventData);
+
+    // Update scene attribute animation.
+    SendEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
+
+    // Update scene subsystems. If a physics world is present, it will be updated, triggering fixed timestep logic updates
+    SendEvent(E_SCENESUBSYSTEMUPDATE, eventData);
+
+    // Update transform smoothing
+    {
+        URHO3D_PROFILE(UpdateSmoothing);
+
+        float constant = 1.0f - Clamp(powf(2.0f, -timeStep * smoothingConstant_), 0.0f, 1.0f);
+        float squaredSnapThreshold = snapThreshold_ * snapThreshold_;
+        // Advance the clock that received network snapshots are stamped with
+        smoothingTime_ += timeStep;
+
+        using namespace UpdateSmoothing;
+
+        smoothingData_[P_CONSTANT] = constant;
+        smoothingData_[P_SQUAREDSNAPTHRESHOLD] = squaredSnapThreshold;
+        SendEvent(E_UPDATESMOOTHING, smoothingData_);
+    }
+
+    // Post-update variable timestep logic
+    UpdateComponents(UPDATE_PHASE_POSTUPDATE, timeStep);
+    SendEvent(E_SCENEPOSTUPDATE, eventData);
+
+    // Note: using a float for elapsed time accumulation is inherently inaccurate. The purpose of this value is
+    // primarily to update material animation effects, as it is available to shaders. It can be reset by calling
+    // SetElapsedTime()
+    elapsedTime_ += timeStep;
+}
+
+void Scene::BeginThreadedUpdate()
+{
+    // Check the work queue subsystem whether it actually has created worker threads. If not, do not enter threaded mode.
+    if (GetSubsystem<WorkQueue>()->GetNumThreads())
+        threadedUpdate_ = true;
+}
+
+void Scene::EndThreadedUpdate()
+{
+    if (!threadedUpdate_)
+        return;
+
+    threadedUpdate_ = false;
+
+    if (!delayedDirtyComponents_.Empty())
+    {
+        URHO3D_PROFILE(EndThreadedUpdate);
+
+        for (PODVector<Component*>::ConstIterator i = delayedDirtyComponents_.Begin(); i != delayedDirtyComponents_.End(); ++i)
+            (*i)->OnMarkedDirty((*i)->GetNode());
+        delayedDirtyComponents_.Clear();
+    }
+
+    if (!delayedEvents_.Empty())
+        SendDelayedEvents();
+}
+
+void Scene::DelayedMarkedDirty(Component* component)
+{
+    MutexLock lock(sceneMutex_);
+    delayedDirtyComponents_.Push(component);
+}
+
+void Scene::DelayedSendEvent(Object* sender, StringHash eventType, const VariantMap& eventData)
+{
+    if (!sender)
+        return;
+
+    if (!threadedUpdate_)
+    {
+        VariantMap& newEventData = GetEventDataMap();
+        newEventData = eventData;
+        sender->SendEvent(eventType, newEventData);
+        return;
+    }
+
+    MutexLock lock(sceneMutex_);
+    delayedEvents_.Resize(delayedEvents_.Size() + 1);
+    DelayedEvent& event = delayedEvents_.Back();
+    event.sender_ = sender;
+    event.eventType_ = eventType;
+    event.eventData_ = eventData;
+}
+
+void Scene::AddUpdateComponent(UpdatePhase phase, Component* component)
+{
+    if (!component || updateComponentSlots_[phase].Contains(component))
+        return;
+
+    Vector<Pair<StringHash, PODVector<Component*> > >& groups = updateComponents_[phase];
+    StringHash type = component->GetType();
+    unsigned group = 0;
+    while (group < groups.Size() && groups[group].first_ != type)
+        ++group;
+    if (group == groups.Size())
+        groups.Push(MakePair(type, PODVector<Component*>()));
+
+    PODVector<Component*>& components = groups[group].second_;
+    updateComponentSlots_[phase][component] = MakePair(group, components.Size());
+    components.Push(component);
+}
+
+void Scene::RemoveUpdateComponent(UpdatePhase phase, Component* component)
+{
+    HashMap<Component*, Pair<unsigned, unsigned> >::Iterator i = updateComponentSlots_[phase].Find(component);
+    if (i == updateComponentSlots_[phase].End())
+        return;
+
+    // Leave a null slot so that removal is safe during the update loop; compact later
+    updateComponents_[phase][i->second_.first_].second_[i->second_.second_] = nullptr;
+    updateComponentSlots_[phase].Erase(i);
+    updateComponentsDirty_[phase] = true;
+}
+
+void Scene::UpdateComponents(UpdatePhase phase, float timeStep)
+{
+    Vector<Pair<StringHash, PODVector<Component*> > >& groups = updateComponents_[phase];
+    if (groups.Empty())
+        return;
+
+    URHO3D_PROFILE(UpdateComponents);
+
+    // Components may be registered or unregistered during the loop, so index instead of holding iterators
+    for (unsigned i = 0; i < groups.Size(); ++i)
+    {
+        for (unsigned j = 0; j < groups[i].second_.Size(); ++j)
+        {
+            Component* component = groups[i].second_[j];
+            if (component)
+                component->OnSceneUpdate(phase, timeStep);
+        }
+    }
+
+    if (updateComponentsDirty_[phase])
+        CompactUpdateComponents(phase);
+}
+
+void Scene::AddParallelUpdateComponent(Component* component)
+{
+    if (!component || parallelUpdateComponentSlots_.Contains(component))
+        return;
+
+    parallelUpdateComponentSlots_[component] = parallelUpdateComponents_.Size();
+    parallelUpdateComponents_.Push(component);
+}
+
+void Scene::RemoveParallelUpdateComponent(Component* component)
+{
+    HashMap<Component*, unsigned>::Iterator i = parallelUpdateComponentSlots_.Find(component);
+    if (i == parallelUpdateComponentSlots_.End())
+        return;
+
+    parallelUpdateComponents_[i->second_] = nullptr;
+    parallelUpdateComponentSlots_.Erase(i);
+    parallelUpdateComponentsDirty_ = true;
+}
+
+void Scene::CompactUpdateComponents(UpdatePhase phase)
+{
+    Vector<Pair<StringHash, PODVector<Component*> > >& groups = updateComponents_[phase];
+    HashMap<Component*, Pair<unsigned, unsigned> >& slots = updateComponentSlots_[phase];
+
+    for (unsigned i = 0; i < groups.Size(); ++i)
+    {
+        PODVector<Component*>& components = groups[i].second_;
+        unsigned dest = 0;
+        for (unsigned j = 0; j < components.Size(); ++j)
+        {
+            Component* component = components[j];
+            if (!component)
+                continue;
+            if (dest != j)
+            {
+                components[dest] = component;
+                slots[component].second_ = dest;
+            }
+            ++dest;
+        }
+        components.Resize(dest);
+    }
+
+    updateComponentsDirty_[phase] = false;
+}
+
+void Scene::UpdateParallelComponents(float timeStep)
+{
+    if (parallelUpdateComponentsDirty_)
+    {
+        unsigned dest = 0;
+        for (unsigned i = 0; i < parallelUpdateComponents_.Size(); ++i)
+        {
+            Component* component = parallelUpdateComponents_[i];
+            if (!component)
+                continue;
+            if (dest != i)
+            {
+                parallelUpdateComponents_[dest] = component;
+                parallelUpdateComponentSlots_[component] = dest;
+            }
+            ++dest;
+        }
+        parallelUpdateComponents_.Resize(dest);
+        parallelUpdateComponentsDirty_ = false;
+    }
+
+    if (parallelUpdateComponents_.Empty())
+        return;
 
-    // Update variable timestep logic
-    SendEvent(E_SCENEUPDATE, eventData);
+    URHO3D_PROFILE(UpdateParallelComponents);
 
-    // Update scene attribute animation.
-    SendEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
+    auto* queue = GetSubsystem<WorkQueue>();
+    int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
+    int componentsPerItem = Max((int)(parallelUpdateComponents_.Size() / numWorkItems), 1);
 
-    // Update scene subsystems. If a physics world is present, it will be updated, triggering fixed timestep logic updates
-    SendEvent(E_SCENESUBSYSTEMUPDATE, eventData);
+    // Transform changes are propagated to the components that are not thread-safe after all items have completed
+    BeginThreadedUpdate();
 
-    // Update transform smoothing
+    PODVector<Component*>::Iterator start = parallelUpdateComponents_.Begin();
+    // Create a work item for each thread
+    for (int i = 0; i < numWorkItems; ++i)
     {
-        URHO3D_PROFILE(UpdateSmoothing);
+        SharedPtr<WorkItem> item = queue->GetFreeItem();
+        item->priority_ = M_MAX_UNSIGNED;
+        item->workFunction_ = UpdateComponentsWork;
+        item->aux_ = &timeStep;
 
-        float constant = 1.0f - Clamp(powf(2.0f, -timeStep * smoothingConstant_), 0.0f, 1.0f);
-        float squaredSnapThreshold = snapThreshold_ * snapThreshold_;
+        PODVector<Component*>::Iterator end = parallelUpdateComponents_.End();
+        if (i < numWorkItems - 1 && end - start > componentsPerItem)
+            end = start + componentsPerItem;
 
-        using namespace UpdateSmoothing;
+        item->start_ = &(*start);
+        item->end_ = &(*end);
+        queue->AddWorkItem(item);
 
-        smoothingData_[P_CONSTANT] = constant;
-        smoothingData_[P_SQUAREDSNAPTHRESHOLD] = squaredSnapThreshold;
-        SendEvent(E_UPDATESMOOTHING, smoothingData_);
+        start = end;
     }
 
-    // Post-update variable timestep logic
-    SendEvent(E_SCENEPOSTUPDATE, eventData);
-
-    // Note: using a float for elapsed time accumulation is inherently inaccurate. The purpose of this value is
-    // primarily to update material animation effects, as it is available to shaders. It can be reset by calling
-    // SetElapsedTime()
-    elapsedTime_ += timeStep;
-}
-
-void Scene::BeginThreadedUpdate()
-{
-    // Check the work queue subsystem whether it actually has created worker threads. If not, do not enter threaded mode.
-    if (GetSubsystem<WorkQueue>()->GetNumThreads())
-        threadedUpdate_ = true;
+    queue->Complete(M_MAX_UNSIGNED);
+    EndThreadedUpdate();
 }
 
-void Scene::EndThreadedUpdate()
+void Scene::SendDelayedEvents()
 {
-    if (!threadedUpdate_)
-        return;
+    URHO3D_PROFILE(SendDelayedEvents);
 
-    threadedUpdate_ = false;
+    // Event handlers may destroy the senders of the later events or queue new events, so take weak references and swap the queue first
+    Vector<DelayedEvent> events;
+    events.Swap(delayedEvents_);
+    Vector<WeakPtr<Object> > senders(events.Size());
+    for (unsigned i = 0; i < events.Size(); ++i)
+        senders[i] = events[i].sender_;
 
-    if (!delayedDirtyComponents_.Empty())
+    for (unsigned i = 0; i < events.Size(); ++i)
     {
-        URHO3D_PROFILE(EndThreadedUpdate);
-
-        for (PODVector<Component*>::ConstIterator i = delayedDirtyComponents_.Begin(); i != delayedDirtyComponents_.End(); ++i)
-            (*i)->OnMarkedDirty((*i)->GetNode());
-        delayedDirtyComponents_.Clear();
+        if (!senders[i].Expired())
+            senders[i]->SendEvent(events[i].eventType_, events[i].eventData_);
     }
 }
 
-void Scene::DelayedMarkedDirty(Component* component)
-{
-    MutexLock lock(sceneMutex_);
-    delayedDirtyComponents_.Push(component);
-}
-
 unsigned Scene::GetFreeNodeID(CreateMode mode)
 {
     if (mode == REPLICATED)
@@ -1061,6 +1600,9 @@ void Scene::ComponentRemoved(Component* component)
         localComponents_.Erase(id);
 
     component->SetID(0);
+    for (unsigned i = 0; i < MAX_UPDATE_PHASES; ++i)
+        RemoveUpdateComponent((UpdatePhase)i, component);
+    RemoveParallelUpdateComponent(component);
     component->OnSceneSet(nullptr);
 }
 
@@ -1189,6 +1731,20 @@ void Scene::UpdateAsyncLoading()
 {
     URHO3D_PROFILE(UpdateAsyncLoading);
 
+    // In threaded mode, wait until the worker thread has read the file and found the resources to preload
+    if (asyncProgress_.workItem_)
+    {
+        if (!asyncProgress_.workItem_->completed_)
+            return;
+
+        asyncProgress_.workItem_.Reset();
+        if (!FinishAsyncRead())
+        {
+            StopAsyncLoading();
+            return;
+        }
+    }
+
     // If resources left to load, do not load nodes yet
     if (asyncProgress_.loadedResources_ < asyncProgress_.totalResources_)
         return;
@@ -1226,10 +1782,11 @@ void Scene::UpdateAsyncLoading()
         }
         else // Load from binary
         {
-            unsigned nodeID = asyncProgress_.file_->ReadUInt();
+            Deserializer& source = GetAsyncLoadingSource();
+            unsigned nodeID = source.ReadUInt();
             Node* newNode = CreateChild(nodeID, IsReplicatedID(nodeID) ? REPLICATED : LOCAL);
             resolver_.AddNode(nodeID, newNode);
-            newNode->Load(*asyncProgress_.file_, resolver_);
+            newNode->Load(source, resolver_);
         }
 
         ++asyncProgress_.loadedNodes_;
@@ -1288,243 +1845,128 @@ void Scene::FinishSaving(Serializer* dest) const
     }
 }
 
-void Scene::PreloadResources(File* file, bool isSceneFile)
+void Scene::PreloadResources(const Vector<ResourceRef>& resources)
 {
-    // If not threaded, can not background load resources, so rather load synchronously later when needed
-#ifdef URHO3D_THREADING
     auto* cache = GetSubsystem<ResourceCache>();
 
-    // Read node ID (not needed)
-    /*unsigned nodeID = */file->ReadUInt();
-
-    // Read Node or Scene attributes; these do not include any resources
-    const Vector<AttributeInfo>* attributes = context_->GetAttributes(isSceneFile ? Scene::GetTypeStatic() : Node::GetTypeStatic());
-    assert(attributes);
-
-    for (unsigned i = 0; i < attributes->Size(); ++i)
-    {
-        const AttributeInfo& attr = attributes->At(i);
-        if (!(attr.mode_ & AM_FILE))
-            continue;
-        /*Variant varValue = */file->ReadVariant(attr.type_);
-    }
-
-    // Read component attributes
-    unsigned numComponents = file->ReadVLE();
-    for (unsigned i = 0; i < numComponents; ++i)
+    for (unsigned i = 0; i < resources.Size(); ++i)
     {
-        VectorBuffer compBuffer(*file, file->ReadVLE());
-        StringHash compType = compBuffer.ReadStringHash();
-        // Read component ID (not needed)
-        /*unsigned compID = */compBuffer.ReadUInt();
-
-        attributes = context_->GetAttributes(compType);
-        if (attributes)
+        // Sanitate resource name beforehand so that when we get the background load event, the name matches exactly
+        String name = cache->SanitateResourceName(resources[i].name_);
+        bool success = cache->BackgroundLoadResource(resources[i].type_, name);
+        if (success)
         {
-            for (unsigned j = 0; j < attributes->Size(); ++j)
-            {
-                const AttributeInfo& attr = attributes->At(j);
-                if (!(attr.mode_ & AM_FILE))
-                    continue;
-                Variant varValue = compBuffer.ReadVariant(attr.type_);
-                if (attr.type_ == VAR_RESOURCEREF)
-                {
-                    const ResourceRef& ref = varValue.GetResourceRef();
-                    // Sanitate resource name beforehand so that when we get the background load event, the name matches exactly
-                    String name = cache->SanitateResourceName(ref.name_);
-                    bool success = cache->BackgroundLoadResource(ref.type_, name);
-                    if (success)
-                    {
-                        ++asyncProgress_.totalResources_;
-                        asyncProgress_.resources_.Insert(StringHash(name));
-                    }
-                }
-                else if (attr.type_ == VAR_RESOURCEREFLIST)
-                {
-                    const ResourceRefList& refList = varValue.GetResourceRefList();
-                    for (unsigned k = 0; k < refList.names_.Size(); ++k)
-                    {
-                        String name = cache->SanitateResourceName(refList.names_[k]);
-                        bool success = cache->BackgroundLoadResource(refList.type_, name);
-                        if (success)
-                        {
-                            ++asyncProgress_.totalResources_;
-                            asyncProgress_.resources_.Insert(StringHash(name));
-                        }
-                    }
-                }
-            }
+            ++asyncProgress_.totalResources_;
+            asyncProgress_.resources_.Insert(StringHash(name));
         }
     }
-
-    // Read child nodes
-    unsigned numChildren = file->ReadVLE();
-    for (unsigned i = 0; i < numChildren; ++i)
-        PreloadResources(file, false);
-#endif
 }
 
-void Scene::PreloadResourcesXML(const XMLElement& element)
+WorkQueue* Scene::GetAsyncLoadingQueue() const
 {
-    // If not threaded, can not background load resources, so rather load synchronously later when needed
-#ifdef URHO3D_THREADING
-    auto* cache = GetSubsystem<ResourceCache>();
-
-    // Node or Scene attributes do not include any resources; therefore skip to the components
-    XMLElement compElem = element.GetChild("component");
-    while (compElem)
-    {
-        String typeName = compElem.GetAttribute("type");
-        const Vector<AttributeInfo>* attributes = context_->GetAttributes(StringHash(typeName));
-        if (attributes)
-        {
-            XMLElement attrElem = compElem.GetChild("attribute");
-            unsigned startIndex = 0;
-
-            while (attrElem)
-            {
-                String name = attrElem.GetAttribute("name");
-                unsigned i = startIndex;
-                unsigned attempts = attributes->Size();
-
-                while (attempts)
-                {
-                    const AttributeInfo& attr = attributes->At(i);
-                    if ((attr.mode_ & AM_FILE) && !attr.name_.Compare(name, true))
-                    {
-                        if (attr.type_ == VAR_RESOURCEREF)
-                        {
-                            ResourceRef ref = attrElem.GetVariantValue(attr.type_).GetResourceRef();
-                            String name = cache->SanitateResourceName(ref.name_);
-                            bool success = cache->BackgroundLoadResource(ref.type_, name);
-                            if (success)
-                            {
-                                ++asyncProgress_.totalResources_;
-                                asyncProgress_.resources_.Insert(StringHash(name));
-                            }
-                        }
-                        else if (attr.type_ == VAR_RESOURCEREFLIST)
-                        {
-                            ResourceRefList refList = attrElem.GetVariantValue(attr.type_).GetResourceRefList();
-                            for (unsigned k = 0; k < refList.names_.Size(); ++k)
-                            {
-                                String name = cache->SanitateResourceName(refList.names_[k]);
-                                bool success = cache->BackgroundLoadResource(refList.type_, name);
-                                if (success)
-                                {
-                                    ++asyncProgress_.totalResources_;
-                                    asyncProgress_.resources_.Insert(StringHash(name));
-                                }
-                            }
-                        }
+    if (!threadedAsyncLoading_)
+        return nullptr;
 
-                        startIndex = (i + 1) % attributes->Size();
-                        break;
-                    }
-                    else
-                    {
-                        i = (i + 1) % attributes->Size();
-                        --attempts;
-                    }
-                }
+    auto* queue = GetSubsystem<WorkQueue>();
+    return queue && queue->GetNumThreads() ? queue : nullptr;
+}
 
-                attrElem = attrElem.GetNext("attribute");
-            }
-        }
+void Scene::StartAsyncRead(WorkQueue* queue)
+{
+    asyncProgress_.threaded_ = true;
+    asyncProgress_.readSuccess_ = false;
 
-        compElem = compElem.GetNext("component");
-    }
+    // Use a low priority so that frame work is not delayed. The item is not taken from the pool, as its completion is
+    // polled in the async updates and it must not be reused meanwhile
+    asyncProgress_.workItem_ = new WorkItem();
+    asyncProgress_.workItem_->workFunction_ = ReadAsyncSceneWork;
+    asyncProgress_.workItem_->aux_ = &asyncProgress_;
+    asyncProgress_.workItem_->priority_ = 0;
+    queue->AddWorkItem(asyncProgress_.workItem_);
+}
 
-    XMLElement childElem = element.GetChild("node");
-    while (childElem)
+bool Scene::FinishAsyncRead()
+{
+    if (!asyncProgress_.readSuccess_)
     {
-        PreloadResourcesXML(childElem);
-        childElem = childElem.GetNext("node");
+        URHO3D_LOGERROR("Could not read " + asyncProgress_.file_->GetName() + " for async loading");
+        return false;
     }
-#endif
+
+    PreloadResources(asyncProgress_.resourceRefs_);
+    asyncProgress_.resourceRefs_.Clear();
+
+    return asyncProgress_.mode_ == LOAD_RESOURCES_ONLY || StartAsyncLoadingNodes();
 }
 
-void Scene::PreloadResourcesJSON(const JSONValue& value)
+bool Scene::StartAsyncLoadingNodes()
 {
-    // If not threaded, can not background load resources, so rather load synchronously later when needed
-#ifdef URHO3D_THREADING
-    auto* cache = GetSubsystem<ResourceCache>();
+    if (asyncProgress_.xmlFile_)
+    {
+        XMLElement rootElement = asyncProgress_.xmlFile_->GetRoot();
 
-    // Node or Scene attributes do not include any resources; therefore skip to the components
-    JSONArray componentArray = value.Get("components").GetArray();
+        // Store own old ID for resolving possible root node references
+        unsigned nodeID = rootElement.GetUInt("id");
+        resolver_.AddNode(nodeID, this);
 
-    for (unsigned i = 0; i < componentArray.Size(); i++)
-    {
-        const JSONValue& compValue = componentArray.At(i);
-        String typeName = compValue.Get("type").GetString();
+        // Load the root level components first
+        if (!Node::LoadXML(rootElement, resolver_, false))
+            return false;
 
-        const Vector<AttributeInfo>* attributes = context_->GetAttributes(StringHash(typeName));
-        if (attributes)
+        // Then prepare for loading all root level child nodes in the async update
+        XMLElement childNodeElement = rootElement.GetChild("node");
+        asyncProgress_.xmlElement_ = childNodeElement;
+
+        // Count the amount of child nodes
+        while (childNodeElement)
         {
-            JSONArray attributesArray = compValue.Get("attributes").GetArray();
+            ++asyncProgress_.totalNodes_;
+            childNodeElement = childNodeElement.GetNext("node");
+        }
+    }
+    else if (asyncProgress_.jsonFile_)
+    {
+        const JSONValue& rootVal = asyncProgress_.jsonFile_->GetRoot();
 
-            unsigned startIndex = 0;
+        // Store own old ID for resolving possible root node references
+        unsigned nodeID = rootVal.Get("id").GetUInt();
+        resolver_.AddNode(nodeID, this);
 
-            for (unsigned j = 0; j < attributesArray.Size(); j++)
-            {
-                const JSONValue& attrVal = attributesArray.At(j);
-                String name = attrVal.Get("name").GetString();
-                unsigned i = startIndex;
-                unsigned attempts = attributes->Size();
+        // Load the root level components first
+        if (!Node::LoadJSON(rootVal, resolver_, false))
+            return false;
 
-                while (attempts)
-                {
-                    const AttributeInfo& attr = attributes->At(i);
-                    if ((attr.mode_ & AM_FILE) && !attr.name_.Compare(name, true))
-                    {
-                        if (attr.type_ == VAR_RESOURCEREF)
-                        {
-                            ResourceRef ref = attrVal.Get("value").GetVariantValue(attr.type_).GetResourceRef();
-                            String name = cache->SanitateResourceName(ref.name_);
-                            bool success = cache->BackgroundLoadResource(ref.type_, name);
-                            if (success)
-                            {
-                                ++asyncProgress_.totalResources_;
-                                asyncProgress_.resources_.Insert(StringHash(name));
-                            }
-                        }
-                        else if (attr.type_ == VAR_RESOURCEREFLIST)
-                        {
-                            ResourceRefList refList = attrVal.Get("value").GetVariantValue(attr.type_).GetResourceRefList();
-                            for (unsigned k = 0; k < refList.names_.Size(); ++k)
-                            {
-                                String name = cache->SanitateResourceName(refList.names_[k]);
-                                bool success = cache->BackgroundLoadResource(refList.type_, name);
-                                if (success)
-                                {
-                                    ++asyncProgress_.totalResources_;
-                                    asyncProgress_.resources_.Insert(StringHash(name));
-                                }
-                            }
-                        }
+        // Then prepare for loading all root level child nodes in the async update
+        asyncProgress_.jsonIndex_ = 0;
 
-                        startIndex = (i + 1) % attributes->Size();
-                        break;
-                    }
-                    else
-                    {
-                        i = (i + 1) % attributes->Size();
-                        --attempts;
-                    }
-                }
+        // Count the amount of child nodes
+        asyncProgress_.totalNodes_ = rootVal.Get("children").GetArray().Size();
+    }
+    else
+    {
+        Deserializer& source = GetAsyncLoadingSource();
 
-            }
-        }
+        // Store own old ID for resolving possible root node references
+        unsigned nodeID = source.ReadUInt();
+        resolver_.AddNode(nodeID, this);
 
-    }
+        // Load root level components first
+        if (!Node::Load(source, resolver_, false))
+            return false;
 
-    JSONArray childrenArray = value.Get("children").GetArray();
-    for (unsigned i = 0; i < childrenArray.Size(); i++)
-    {
-        const JSONValue& childVal = childrenArray.At(i);
-        PreloadResourcesJSON(childVal);
+        // Then prepare to load child nodes in the async updates
+        asyncProgress_.totalNodes_ = source.ReadVLE();
     }
-#endif
+
+    return true;
+}
+
+Deserializer& Scene::GetAsyncLoadingSource()
+{
+    if (asyncProgress_.threaded_)
+        return asyncProgress_.buffer_;
+    else
+        return *asyncProgress_.file_;
 }
 
 void RegisterSceneLibrary(Context* context)
@@ -26,8 +26,10 @@
 
 #include "../Container/HashSet.h"
 #include "../Core/Mutex.h"
+#include "../IO/VectorBuffer.h"
 #include "../Resource/XMLElement.h"
 #include "../Resource/JSONFile.h"
+#include "../Scene/Component.h"
 #include "../Scene/Node.h"
 #include "../Scene/SceneResolver.h"
 
@@ -36,6 +38,9 @@ namespace Urho3D
 
 class File;
 class PackageFile;
+class WorkQueue;
+
+struct WorkItem;
 
 static const unsigned FIRST_REPLICATED_ID = 0x1;
 static const unsigned LAST_REPLICATED_ID = 0xffffff;
@@ -81,6 +86,30 @@ struct AsyncProgress
     unsigned loadedNodes_;
     /// Total root-level nodes.
     unsigned totalNodes_;
+
+    /// Work item reading the file on a worker thread in threaded mode.
+    SharedPtr<WorkItem> workItem_;
+    /// File data read into memory for binary mode in threaded mode.
+    VectorBuffer buffer_;
+    /// Resources found on the worker thread to be queued for background loading in threaded mode.
+    Vector<ResourceRef> resourceRefs_;
+    /// Whether the binary file is a scene file as opposed to an object prefab.
+    bool isSceneFile_{};
+    /// Whether the file is read on a worker thread.
+    bool threaded_{};
+    /// Whether the worker thread read the file successfully.
+    bool readSuccess_{};
+};
+
+/// Event queued for sending at the end of a threaded update.
+struct DelayedEvent
+{
+    /// Sender object.
+    Object* sender_;
+    /// Event type.
+    StringHash eventType_;
+    /// Event parameters.
+    VariantMap eventData_;
 };
 
 /// Root scene node, represents the whole scene.
@@ -121,6 +150,12 @@ public:
     bool SaveXML(Serializer& dest, const String& indentation = "\t") const;
     /// Save to a JSON file. Return true if successful.
     bool SaveJSON(Serializer& dest, const String& indentation = "\t") const;
+    /// Load from compiled scene data. Memory buffers are read in place, other streams are read into memory first. Removes all existing child nodes and components first. Return true if successful.
+    bool LoadCompiled(Deserializer& source);
+    /// Load from compiled scene data in memory, for example a memory-mapped file. The data must stay valid during the call. Removes all existing child nodes and components first. Return true if successful.
+    bool LoadCompiled(const void* data, unsigned size);
+    /// Save to compiled scene data, which stores each object type with its attribute layout and each distinct attribute block only once. The attributes are matched to the classes by name and type when loading, so attributes added or removed since saving are tolerated, but components whose type is unknown when loading lose their attributes. Return true if successful.
+    bool SaveCompiled(Serializer& dest) const;
     /// Load from a binary file asynchronously. Return true if started successfully. The LOAD_RESOURCES_ONLY mode can also be used to preload resources from object prefab files.
     bool LoadAsync(File* file, LoadMode mode = LOAD_SCENE_AND_RESOURCES);
     /// Load from an XML file asynchronously. Return true if started successfully. The LOAD_RESOURCES_ONLY mode can also be used to preload resources from object prefab files.
@@ -154,8 +189,16 @@ public:
     void SetSmoothingConstant(float constant);
     /// Set network client motion smoothing snap threshold.
     void SetSnapThreshold(float threshold);
+    /// Set network client snapshot interpolation delay in seconds. 0 (default) uses exponential smoothing towards the latest update instead.
+    void SetInterpolationDelay(float delay);
+    /// Set network client maximum time in seconds to extrapolate past the latest snapshot when snapshot interpolation is in use.
+    void SetMaxExtrapolation(float time);
+    /// Set the server's smoothing clock time of the network update being applied on the client, and adjust the estimated offset of the server clock. Called by Connection.
+    void SetServerTime(double time);
     /// Set maximum milliseconds per frame to spend on async scene loading.
     void SetAsyncLoadingMs(int ms);
+    /// Set whether async loading reads and parses the file and finds the resources to preload on a worker thread. The nodes are still instantiated on the main thread in time slices, as components may only request resources and subscribe to events there. Requires work queue threads.
+    void SetThreadedAsyncLoading(bool enable);
     /// Add a required package file for networking. To be called on the server.
     void AddRequiredPackageFile(PackageFile* package);
     /// Clear required package files.
@@ -204,9 +247,27 @@ public:
     /// Return motion smoothing snap threshold.
     float GetSnapThreshold() const { return snapThreshold_; }
 
+    /// Return snapshot interpolation delay in seconds.
+    float GetInterpolationDelay() const { return interpolationDelay_; }
+
+    /// Return maximum snapshot extrapolation time in seconds.
+    float GetMaxExtrapolation() const { return maxExtrapolation_; }
+
+    /// Return the local clock in seconds that transform smoothing runs on. Advanced by the scene update before transform smoothing. On the server it is sent with the scene updates as the server time.
+    double GetSmoothingTime() const { return smoothingTime_; }
+
+    /// Return the time to stamp received network snapshots with: the server time of the update being applied, or the local smoothing clock if no server time has been received.
+    double GetSnapshotTime() const { return hasServerTime_ ? serverTime_ : smoothingTime_; }
+
+    /// Return the time on the snapshot clock that snapshot interpolation renders at: the estimated current server time minus the interpolation delay.
+    double GetInterpolationTime() const { return smoothingTime_ + serverTimeOffset_ - interpolationDelay_; }
+
     /// Return maximum milliseconds per frame to spend on async loading.
     int GetAsyncLoadingMs() const { return asyncLoadingMs_; }
 
+    /// Return whether async loading reads the file on a worker thread.
+    bool IsThreadedAsyncLoading() const { return threadedAsyncLoading_; }
+
     /// Return required package files.
     const Vector<SharedPtr<PackageFile> >& GetRequiredPackageFiles() const { return requiredPackageFiles_; }
 
@@ -221,10 +282,23 @@ public:
     void EndThreadedUpdate();
     /// Add a component to the delayed dirty notify queue. Is thread-safe.
     void DelayedMarkedDirty(Component* component);
+    /// Send an event at the end of the threaded update, or immediately if not in a threaded update. Is thread-safe.
+    void DelayedSendEvent(Object* sender, StringHash eventType, const VariantMap& eventData);
 
     /// Return threaded update flag.
     bool IsThreadedUpdate() const { return threadedUpdate_; }
 
+    /// Register a component to be called directly on an update phase, before the corresponding update event is sent. Components are grouped by type to keep the calls of the same type together.
+    void AddUpdateComponent(UpdatePhase phase, Component* component);
+    /// Unregister a component from an update phase.
+    void RemoveUpdateComponent(UpdatePhase phase, Component* component);
+    /// Call the components registered on an update phase. Called by the scene for the variable timestep phases and by the physics world for the fixed timestep phases.
+    void UpdateComponents(UpdatePhase phase, float timeStep);
+    /// Register a component to be called on the update phase from the work queue's worker threads, before the components updated on the main thread. The component must only modify its own node and must send events through DelayedSendEvent().
+    void AddParallelUpdateComponent(Component* component);
+    /// Unregister a component from the parallel update phase. Must not be called from the parallel update itself.
+    void RemoveParallelUpdateComponent(Component* component);
+
     /// Get free node ID, either non-local or local.
     unsigned GetFreeNodeID(CreateMode mode);
     /// Get free component ID, either non-local or local.
@@ -269,16 +343,28 @@ private:
     void UpdateAsyncLoading();
     /// Finish asynchronous loading.
     void FinishAsyncLoading();
+    /// Remove the slots of unregistered components from an update phase.
+    void CompactUpdateComponents(UpdatePhase phase);
+    /// Call the components registered on the parallel update phase, split across the work queue threads.
+    void UpdateParallelComponents(float timeStep);
+    /// Send the events queued during a threaded update.
+    void SendDelayedEvents();
     /// Finish loading. Sets the scene filename and checksum.
     void FinishLoading(Deserializer* source);
     /// Finish saving. Sets the scene filename and checksum.
     void FinishSaving(Serializer* dest) const;
-    /// Preload resources from a binary scene or object prefab file.
-    void PreloadResources(File* file, bool isSceneFile);
-    /// Preload resources from an XML scene or object prefab file.
-    void PreloadResourcesXML(const XMLElement& element);
-    /// Preload resources from a JSON scene or object prefab file.
-    void PreloadResourcesJSON(const JSONValue& value);
+    /// Queue resources found from a scene or object prefab file for background loading.
+    void PreloadResources(const Vector<ResourceRef>& resources);
+    /// Return the work queue for threaded async loading, or null if not enabled or no worker threads.
+    WorkQueue* GetAsyncLoadingQueue() const;
+    /// Start reading the async loading file on a worker thread.
+    void StartAsyncRead(WorkQueue* queue);
+    /// Queue the resources found on the worker thread and prepare loading the nodes. Return true if successful.
+    bool FinishAsyncRead();
+    /// Load the root level components and prepare loading the root level child nodes in the async updates. Return true if successful.
+    bool StartAsyncLoadingNodes();
+    /// Return the stream for loading nodes in binary mode.
+    Deserializer& GetAsyncLoadingSource();
 
     /// Replicated scene nodes by ID.
     HashMap<unsigned, Node*> replicatedNodes_;
@@ -304,9 +390,19 @@ private:
     HashSet<unsigned> networkUpdateNodes_;
     /// Components to check for attribute changes on the next network update.
     HashSet<unsigned> networkUpdateComponents_;
+    /// Components called directly on each update phase, grouped by component type. Unregistered components leave a null slot until the next compaction.
+    Vector<Pair<StringHash, PODVector<Component*> > > updateComponents_[MAX_UPDATE_PHASES];
+    /// Group and slot index of the registered components on each update phase.
+    HashMap<Component*, Pair<unsigned, unsigned> > updateComponentSlots_[MAX_UPDATE_PHASES];
+    /// Components called from worker threads on the update phase. Unregistered components leave a null slot until the next compaction.
+    PODVector<Component*> parallelUpdateComponents_;
+    /// Slot index of the components registered on the parallel update phase.
+    HashMap<Component*, unsigned> parallelUpdateComponentSlots_;
     /// Delayed dirty notification queue for components.
     PODVector<Component*> delayedDirtyComponents_;
-    /// Mutex for the delayed dirty notification queue.
+    /// Delayed event queue.
+    Vector<DelayedEvent> delayedEvents_;
+    /// Mutex for the delayed dirty notification and event queues.
     Mutex sceneMutex_;
     /// Preallocated event data map for smoothing update events.
     VariantMap smoothingData_;
@@ -330,12 +426,30 @@ private:
     float smoothingConstant_;
     /// Motion smoothing snap threshold.
     float snapThreshold_;
+    /// Snapshot interpolation delay.
+    float interpolationDelay_;
+    /// Maximum snapshot extrapolation time.
+    float maxExtrapolation_;
+    /// Snapshot interpolation clock.
+    double smoothingTime_;
+    /// Server time of the latest network update.
+    double serverTime_;
+    /// Estimated offset of the server clock from the smoothing clock.
+    double serverTimeOffset_;
+    /// Server time received flag.
+    bool hasServerTime_;
     /// Update enabled flag.
     bool updateEnabled_;
     /// Asynchronous loading flag.
     bool asyncLoading_;
+    /// Threaded asynchronous loading flag.
+    bool threadedAsyncLoading_;
     /// Threaded update flag.
     bool threadedUpdate_;
+    /// Whether update phases have null slots to compact.
+    bool updateComponentsDirty_[MAX_UPDATE_PHASES];
+    /// Whether the parallel update phase has null slots to compact.
+    bool parallelUpdateComponentsDirty_;
 };
 
 /// Register Scene library objects.
@@ -27,7 +27,7 @@
 namespace Urho3D
 {
 
-/// Variable timestep scene update.
+/// Variable timestep scene update. The LogicComponent and ScriptInstance updates called directly by the scene have already been executed when this is sent.
 URHO3D_EVENT(E_SCENEUPDATE, SceneUpdate)
 {
     URHO3D_PARAM(P_SCENE, Scene);                  // Scene pointer
@@ -86,7 +86,7 @@ URHO3D_EVENT(E_ATTRIBUTEANIMATIONREMOVED, AttributeAnimationRemoved)
     URHO3D_PARAM(P_ATTRIBUTEANIMATIONNAME, AttributeAnimationName); // String
 }
 
-/// Variable timestep scene post-update.
+/// Variable timestep scene post-update. The LogicComponent and ScriptInstance post-updates called directly by the scene have already been executed when this is sent.
 URHO3D_EVENT(E_SCENEPOSTUPDATE, ScenePostUpdate)
 {
     URHO3D_PARAM(P_SCENE, Scene);                  // Scene pointer
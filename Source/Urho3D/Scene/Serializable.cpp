@@ -315,6 +315,18 @@ bool Serializable::Load(Deserializer& source)
     return true;
 }
 
+bool Serializable::LoadAttributeValues(const PODVector<const AttributeInfo*>& attributes, const Vector<Variant>& values)
+{
+    unsigned numValues = Min(attributes.Size(), values.Size());
+    for (unsigned i = 0; i < numValues; ++i)
+    {
+        if (attributes[i])
+            OnSetAttribute(*attributes[i], values[i]);
+    }
+
+    return true;
+}
+
 bool Serializable::Save(Serializer& dest) const
 {
     const Vector<AttributeInfo>* attributes = GetAttributes();
@@ -63,6 +63,8 @@ public:
     virtual bool Load(Deserializer& source);
     /// Save as binary data. Return true if successful.
     virtual bool Save(Serializer& dest) const;
+    /// Load from attribute values decoded in advance, as done by the compiled scene loader. Each value is applied to the attribute description with the same index, null descriptions are skipped. Subclasses that override Load() to wrap attribute loading should override this as well. Return true if successful.
+    virtual bool LoadAttributeValues(const PODVector<const AttributeInfo*>& attributes, const Vector<Variant>& values);
     /// Load from XML data. Return true if successful.
     virtual bool LoadXML(const XMLElement& source);
     /// Save as XML data. Return true if successful.
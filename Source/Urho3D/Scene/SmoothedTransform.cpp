@@ -32,6 +32,8 @@
 namespace Urho3D
 {
 
+static const unsigned MAX_SNAPSHOTS = 32;
+
 SmoothedTransform::SmoothedTransform(Context* context) :
     Component(context),
     targetPosition_(Vector3::ZERO),
@@ -48,8 +50,29 @@ void SmoothedTransform::RegisterObject(Context* context)
     context->RegisterFactory<SmoothedTransform>();
 }
 
+void SmoothedTransform::OnSetEnabled()
+{
+    if (IsEnabled())
+    {
+        // Resume moving towards the targets that were received while disabled
+        smoothingMask_ = SMOOTH_POSITION | SMOOTH_ROTATION;
+        SubscribeToSmoothing();
+    }
+    else
+    {
+        snapshots_.Clear();
+        smoothingMask_ = SMOOTH_NONE;
+        UnsubscribeFromEvent(GetScene(), E_UPDATESMOOTHING);
+        subscribed_ = false;
+    }
+}
+
 void SmoothedTransform::Update(float constant, float squaredSnapThreshold)
 {
+    // Snapping to the end also discards the snapshot history
+    if (constant >= 1.0f && snapshots_.Size() > 1)
+        snapshots_.Erase(0, snapshots_.Size() - 1);
+
     if (smoothingMask_ && node_)
     {
         Vector3 position = node_->GetPosition();
@@ -96,16 +119,69 @@ void SmoothedTransform::Update(float constant, float squaredSnapThreshold)
     }
 }
 
+void SmoothedTransform::UpdateInterpolation(double renderTime, float maxExtrapolation)
+{
+    if (node_ && !snapshots_.Empty())
+    {
+        // Discard snapshots the render time has passed, keeping the start of the current interval and one more to
+        // extrapolate along
+        unsigned expired = 0;
+        while (expired + 2 < snapshots_.Size() && snapshots_[expired + 1].time_ <= renderTime)
+            ++expired;
+        if (expired)
+            snapshots_.Erase(0, expired);
+
+        const TransformSnapshot& from = snapshots_.Front();
+        const TransformSnapshot& to = snapshots_.Back();
+        Vector3 position;
+        Quaternion rotation;
+        bool finished = false;
+
+        if (renderTime <= from.time_)
+        {
+            position = from.position_;
+            rotation = from.rotation_;
+        }
+        else if (snapshots_.Size() == 1 || renderTime > to.time_ + maxExtrapolation)
+        {
+            // No newer data arrived in time: settle on the newest snapshot, so that a node which stopped moving does not
+            // stay displaced by the extrapolation
+            position = to.position_;
+            rotation = to.rotation_;
+            finished = true;
+        }
+        else
+        {
+            // Interpolate within the interval, or extrapolate along it past the newest snapshot
+            const TransformSnapshot& next = snapshots_[1];
+            auto t = (float)((renderTime - from.time_) / (next.time_ - from.time_));
+            position = from.position_.Lerp(next.position_, t);
+            rotation = from.rotation_.Slerp(next.rotation_, t);
+        }
+
+        node_->SetTransform(position, rotation);
+        if (finished)
+            smoothingMask_ = SMOOTH_NONE;
+    }
+    else
+        smoothingMask_ = SMOOTH_NONE;
+
+    if (!smoothingMask_)
+    {
+        UnsubscribeFromEvent(GetScene(), E_UPDATESMOOTHING);
+        subscribed_ = false;
+    }
+}
+
 void SmoothedTransform::SetTargetPosition(const Vector3& position)
 {
     targetPosition_ = position;
-    smoothingMask_ |= SMOOTH_POSITION;
 
-    // Subscribe to smoothing update if not yet subscribed
-    if (!subscribed_)
+    if (IsEnabled())
     {
-        SubscribeToEvent(GetScene(), E_UPDATESMOOTHING, URHO3D_HANDLER(SmoothedTransform, HandleUpdateSmoothing));
-        subscribed_ = true;
+        smoothingMask_ |= SMOOTH_POSITION;
+        AddSnapshot();
+        SubscribeToSmoothing();
     }
 
     SendEvent(E_TARGETPOSITION);
@@ -114,12 +190,12 @@ void SmoothedTransform::SetTargetPosition(const Vector3& position)
 void SmoothedTransform::SetTargetRotation(const Quaternion& rotation)
 {
     targetRotation_ = rotation;
-    smoothingMask_ |= SMOOTH_ROTATION;
 
-    if (!subscribed_)
+    if (IsEnabled())
     {
-        SubscribeToEvent(GetScene(), E_UPDATESMOOTHING, URHO3D_HANDLER(SmoothedTransform, HandleUpdateSmoothing));
-        subscribed_ = true;
+        smoothingMask_ |= SMOOTH_ROTATION;
+        AddSnapshot();
+        SubscribeToSmoothing();
     }
 
     SendEvent(E_TARGETROTATION);
@@ -171,9 +247,76 @@ void SmoothedTransform::HandleUpdateSmoothing(StringHash eventType, VariantMap&
 {
     using namespace UpdateSmoothing;
 
+    Scene* scene = GetScene();
+    if (scene && scene->GetInterpolationDelay() > 0.0f && !snapshots_.Empty())
+    {
+        UpdateInterpolation(scene->GetInterpolationTime(), scene->GetMaxExtrapolation());
+        return;
+    }
+
     float constant = eventData[P_CONSTANT].GetFloat();
     float squaredSnapThreshold = eventData[P_SQUAREDSNAPTHRESHOLD].GetFloat();
     Update(constant, squaredSnapThreshold);
 }
 
+void SmoothedTransform::SubscribeToSmoothing()
+{
+    if (!subscribed_)
+    {
+        SubscribeToEvent(GetScene(), E_UPDATESMOOTHING, URHO3D_HANDLER(SmoothedTransform, HandleUpdateSmoothing));
+        subscribed_ = true;
+    }
+}
+
+void SmoothedTransform::AddSnapshot()
+{
+    Scene* scene = GetScene();
+    if (!scene || scene->GetInterpolationDelay() <= 0.0f)
+    {
+        snapshots_.Clear();
+        return;
+    }
+
+    // Stamp the snapshot with the server time of the update, so that the interpolation follows the server's timing rather
+    // than the time the update happened to arrive
+    double time = scene->GetSnapshotTime();
+    double renderTime = scene->GetInterpolationTime();
+
+    if (!snapshots_.Empty())
+    {
+        // Position and rotation of the same update arrive separately, merge them into one snapshot
+        if (snapshots_.Back().time_ == time)
+        {
+            snapshots_.Back().position_ = targetPosition_;
+            snapshots_.Back().rotation_ = targetRotation_;
+            return;
+        }
+        // An update older than the newest snapshot arrived out of order, it is already superseded
+        if (snapshots_.Back().time_ > time)
+            return;
+
+        float snapThreshold = scene->GetSnapThreshold();
+        if ((targetPosition_ - snapshots_.Back().position_).LengthSquared() > snapThreshold * snapThreshold)
+        {
+            // Discard the history on a large jump so that the node snaps instead of sweeping through
+            snapshots_.Clear();
+        }
+        else if (snapshots_.Back().time_ < renderTime)
+        {
+            // After a pause in updates, restart the history from the last snapshot at the current render time, so that
+            // motion resumes smoothly instead of jumping ahead
+            snapshots_.Erase(0, snapshots_.Size() - 1);
+            snapshots_.Back().time_ = renderTime;
+        }
+        else if (snapshots_.Size() >= MAX_SNAPSHOTS)
+            snapshots_.Erase(0);
+    }
+
+    TransformSnapshot snapshot;
+    snapshot.time_ = time;
+    snapshot.position_ = targetPosition_;
+    snapshot.rotation_ = targetRotation_;
+    snapshots_.Push(snapshot);
+}
+
 }
@@ -40,7 +40,18 @@ enum SmoothingType : unsigned
 };
 URHO3D_FLAGSET(SmoothingType, SmoothingTypeFlags);
 
-/// Transform smoothing component for network updates.
+/// Received network transform for snapshot interpolation.
+struct TransformSnapshot
+{
+    /// Server time of the update, or receive time on the scene smoothing clock if the server time is not known.
+    double time_;
+    /// Position in parent space.
+    Vector3 position_;
+    /// Rotation in parent space.
+    Quaternion rotation_;
+};
+
+/// Transform smoothing component for network updates. Uses exponential smoothing towards the latest update, or interpolation between buffered snapshots if the scene has an interpolation delay. When disabled, targets are still received but the node transform is left alone, for example for client-side prediction.
 class URHO3D_API SmoothedTransform : public Component
 {
     URHO3D_OBJECT(SmoothedTransform, Component);
@@ -53,8 +64,13 @@ public:
     /// Register object factory.
     static void RegisterObject(Context* context);
 
+    /// Handle enabled/disabled state change.
+    void OnSetEnabled() override;
+
     /// Update smoothing.
     void Update(float constant, float squaredSnapThreshold);
+    /// Update snapshot interpolation to the specified time on the snapshot clock, extrapolating at most the specified time past the newest snapshot.
+    void UpdateInterpolation(double renderTime, float maxExtrapolation);
     /// Set target position in parent space.
     void SetTargetPosition(const Vector3& position);
     /// Set target rotation in parent space.
@@ -78,6 +94,9 @@ public:
     /// Return whether smoothing is in progress.
     bool IsInProgress() const { return smoothingMask_ != SMOOTH_NONE; }
 
+    /// Return number of buffered snapshots.
+    unsigned GetNumSnapshots() const { return snapshots_.Size(); }
+
 protected:
     /// Handle scene node being assigned at creation.
     void OnNodeSet(Node* node) override;
@@ -85,11 +104,17 @@ protected:
 private:
     /// Handle smoothing update event.
     void HandleUpdateSmoothing(StringHash eventType, VariantMap& eventData);
+    /// Subscribe to the smoothing update event if not yet subscribed.
+    void SubscribeToSmoothing();
+    /// Record the current targets as a snapshot if snapshot interpolation is in use.
+    void AddSnapshot();
 
     /// Target position.
     Vector3 targetPosition_;
     /// Target rotation.
     Quaternion targetRotation_;
+    /// Buffered snapshots, oldest first.
+    PODVector<TransformSnapshot> snapshots_;
     /// Active smoothing operations bitmask.
     SmoothingTypeFlags smoothingMask_;
     /// Subscribed to smoothing update event flag.
@@ -86,7 +86,10 @@ void CollisionShape2D::SetTrigger(bool trigger)
     fixtureDef_.isSensor = trigger;
 
     if (fixture_)
+    {
+        rigidBody_->WaitForStep();
         fixture_->SetSensor(trigger);
+    }
 
     MarkNetworkUpdate();
 }
@@ -99,7 +102,10 @@ void CollisionShape2D::SetCategoryBits(int categoryBits)
     fixtureDef_.filter.categoryBits = (uint16)categoryBits;
 
     if (fixture_)
+    {
+        rigidBody_->WaitForStep();
         fixture_->SetFilterData(fixtureDef_.filter);
+    }
 
     MarkNetworkUpdate();
 }
@@ -112,7 +118,10 @@ void CollisionShape2D::SetMaskBits(int maskBits)
     fixtureDef_.filter.maskBits = (uint16)maskBits;
 
     if (fixture_)
+    {
+        rigidBody_->WaitForStep();
         fixture_->SetFilterData(fixtureDef_.filter);
+    }
 
     MarkNetworkUpdate();
 }
@@ -125,7 +134,10 @@ void CollisionShape2D::SetGroupIndex(int groupIndex)
     fixtureDef_.filter.groupIndex = (int16)groupIndex;
 
     if (fixture_)
+    {
+        rigidBody_->WaitForStep();
         fixture_->SetFilterData(fixtureDef_.filter);
+    }
 
     MarkNetworkUpdate();
 }
@@ -139,6 +151,7 @@ void CollisionShape2D::SetDensity(float density)
 
     if (fixture_)
     {
+        rigidBody_->WaitForStep();
         // This will not automatically adjust the mass of the body
         fixture_->SetDensity(density);
 
@@ -158,6 +171,7 @@ void CollisionShape2D::SetFriction(float friction)
 
     if (fixture_)
     {
+        rigidBody_->WaitForStep();
         // This will not change the friction of existing contacts
         fixture_->SetFriction(friction);
 
@@ -184,6 +198,7 @@ void CollisionShape2D::SetRestitution(float restitution)
 
     if (fixture_)
     {
+        rigidBody_->WaitForStep();
         // This will not change the restitution of existing contacts
         fixture_->SetRestitution(restitution);
 
@@ -257,6 +272,7 @@ float CollisionShape2D::GetMass() const
     if (!fixture_)
         return 0.0f;
 
+    rigidBody_->WaitForStep();
     b2MassData massData;
     fixture_->GetMassData(&massData);
 
@@ -268,6 +284,7 @@ float CollisionShape2D::GetInertia() const
     if (!fixture_)
         return 0.0f;
 
+    rigidBody_->WaitForStep();
     b2MassData massData;
     fixture_->GetMassData(&massData);
 
@@ -279,6 +296,7 @@ Vector2 CollisionShape2D::GetMassCenter() const
     if (!fixture_)
         return Vector2::ZERO;
 
+    rigidBody_->WaitForStep();
     b2MassData massData;
     fixture_->GetMassData(&massData);
 
@@ -71,6 +71,14 @@ URHO3D_EVENT(E_PHYSICSENDCONTACT2D, PhysicsEndContact2D)
     URHO3D_PARAM(P_SHAPEB, ShapeB);                // CollisionShape2D pointer
 }
 
+/// Physics contacts of a simulation step. Global event sent by PhysicsWorld2D instead of the individual begin and end contact events when batched contact events are enabled. The contacts can be read with PhysicsWorld2D::GetBeginContacts() and GetEndContacts() during the event.
+URHO3D_EVENT(E_PHYSICSCONTACTS2D, PhysicsContacts2D)
+{
+    URHO3D_PARAM(P_WORLD, World);                  // PhysicsWorld2D pointer
+    URHO3D_PARAM(P_NUMBEGINCONTACTS, NumBeginContacts); // unsigned
+    URHO3D_PARAM(P_NUMENDCONTACTS, NumEndContacts); // unsigned
+}
+
 /// Node update contact. Sent by scene nodes participating in a collision.
 URHO3D_EVENT(E_NODEUPDATECONTACT2D, NodeUpdateContact2D)
 {
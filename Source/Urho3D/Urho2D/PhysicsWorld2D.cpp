@@ -23,7 +23,9 @@
 #include "../Precompiled.h"
 
 #include "../Core/Context.h"
+#include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
+#include "../Core/WorkQueue.h"
 #include "../Graphics/DebugRenderer.h"
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
@@ -45,6 +47,66 @@ extern const char* SUBSYSTEM_CATEGORY;
 static const Vector2 DEFAULT_GRAVITY(0.0f, -9.81f);
 static const int DEFAULT_VELOCITY_ITERATIONS = 8;
 static const int DEFAULT_POSITION_ITERATIONS = 3;
+/// Work queue priority of threaded steps. Below the rendering work, which the main thread waits for with the highest priority.
+static const unsigned STEP_WORK_PRIORITY = M_MAX_UNSIGNED - 1;
+
+void StepWorld2DWork(const WorkItem* item, unsigned threadIndex)
+{
+    auto* world = reinterpret_cast<PhysicsWorld2D*>(item->aux_);
+    world->StepWorld(world->pendingTimeStep_);
+}
+
+static void ReadContact(b2Contact* contact, PhysicsContact2D& dest)
+{
+    b2Fixture* fixtureA = contact->GetFixtureA();
+    b2Fixture* fixtureB = contact->GetFixtureB();
+    dest.bodyA_ = (RigidBody2D*)(fixtureA->GetBody()->GetUserData());
+    dest.bodyB_ = (RigidBody2D*)(fixtureB->GetBody()->GetUserData());
+    dest.nodeA_ = dest.bodyA_->GetNode();
+    dest.nodeB_ = dest.bodyB_->GetNode();
+    dest.shapeA_ = (CollisionShape2D*)fixtureA->GetUserData();
+    dest.shapeB_ = (CollisionShape2D*)fixtureB->GetUserData();
+
+    b2WorldManifold worldManifold;
+    contact->GetWorldManifold(&worldManifold);
+    dest.numPoints_ = contact->GetManifold()->pointCount;
+    dest.worldNormal_ = Vector2(worldManifold.normal.x, worldManifold.normal.y);
+    for (int i = 0; i < dest.numPoints_; ++i)
+    {
+        dest.worldPositions_[i] = Vector2(worldManifold.points[i].x, worldManifold.points[i].y);
+        dest.separations_[i] = worldManifold.separations[i];
+    }
+}
+
+static const PODVector<unsigned char>& SerializeContact(const PhysicsContact2D& contact, VectorBuffer& buffer)
+{
+    buffer.Clear();
+    for (int i = 0; i < contact.numPoints_; ++i)
+    {
+        buffer.WriteVector2(contact.worldPositions_[i]);
+        buffer.WriteVector2(contact.worldNormal_);
+        buffer.WriteFloat(contact.separations_[i]);
+    }
+    return buffer.GetBuffer();
+}
+
+static void HoldContactObjects(Vector<SharedPtr<Object> >& dest, const PhysicsContact2D& contact)
+{
+    dest.Push(SharedPtr<Object>(contact.bodyA_));
+    dest.Push(SharedPtr<Object>(contact.bodyB_));
+    dest.Push(SharedPtr<Object>(contact.nodeA_));
+    dest.Push(SharedPtr<Object>(contact.nodeB_));
+    dest.Push(SharedPtr<Object>(contact.shapeA_));
+    dest.Push(SharedPtr<Object>(contact.shapeB_));
+}
+
+/// Return whether references can be held to the objects in a contact. Box2D also ends the contacts of a body or fixture
+/// when it is destroyed, which happens from the component destructor when the last reference is released.
+static bool CanHoldContactObjects(const PhysicsContact2D& contact)
+{
+    return contact.bodyA_->Refs() && contact.bodyB_->Refs() && contact.shapeA_->Refs() && contact.shapeB_->Refs() &&
+        (!contact.nodeA_ || contact.nodeA_->Refs()) && (!contact.nodeB_ || contact.nodeB_->Refs());
+}
 
 PhysicsWorld2D::PhysicsWorld2D(Context* context) :
     Component(context),
@@ -65,6 +127,8 @@ PhysicsWorld2D::PhysicsWorld2D(Context* context) :
 
 PhysicsWorld2D::~PhysicsWorld2D()
 {
+    CancelUpdate();
+
     for (unsigned i = 0; i < rigidBodies_.Size(); ++i)
         if (rigidBodies_[i])
             rigidBodies_[i]->ReleaseBody();
@@ -89,6 +153,8 @@ void PhysicsWorld2D::RegisterObject(Context* context)
         AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Position Iterations", GetPositionIterations, SetPositionIterations, int, DEFAULT_POSITION_ITERATIONS,
         AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Threaded Update", GetThreadedUpdate, SetThreadedUpdate, bool, false, AM_DEFAULT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Batched Contact Events", GetBatchedContactEvents, SetBatchedContactEvents, bool, false, AM_DEFAULT);
 }
 
 void PhysicsWorld2D::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
@@ -97,6 +163,8 @@ void PhysicsWorld2D::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
     {
         URHO3D_PROFILE(Physics2DDrawDebug);
 
+        WaitForStep();
+
         debugRenderer_ = debug;
         debugDepthTest_ = depthTest;
         world_->DrawDebugData();
@@ -110,12 +178,7 @@ void PhysicsWorld2D::BeginContact(b2Contact* contact)
     if (!physicsStepping_)
         return;
 
-    b2Fixture* fixtureA = contact->GetFixtureA();
-    b2Fixture* fixtureB = contact->GetFixtureB();
-    if (!fixtureA || !fixtureB)
-        return;
-
-    beginContactInfos_.Push(ContactInfo(contact));
+    RecordContact(beginContacts_, contact);
 }
 
 void PhysicsWorld2D::EndContact(b2Contact* contact)
@@ -123,35 +186,38 @@ void PhysicsWorld2D::EndContact(b2Contact* contact)
     if (!physicsStepping_)
         return;
 
-    b2Fixture* fixtureA = contact->GetFixtureA();
-    b2Fixture* fixtureB = contact->GetFixtureB();
-    if (!fixtureA || !fixtureB)
-        return;
-
-    endContactInfos_.Push(ContactInfo(contact));
+    RecordContact(endContacts_, contact);
 }
 
 void PhysicsWorld2D::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
 {
+    // Events can not be sent from a worker thread, so threaded steps never send the update contact events
+    if (updatePending_)
+        return;
+
     b2Fixture* fixtureA = contact->GetFixtureA();
     b2Fixture* fixtureB = contact->GetFixtureB();
     if (!fixtureA || !fixtureB)
         return;
 
-    ContactInfo contactInfo(contact);
+    PhysicsContact2D contactInfo;
+    ReadContact(contact, contactInfo);
+    // Use a separate holder, as the event handlers may destroy objects and record end contacts
+    Vector<SharedPtr<Object> > heldObjects;
+    HoldContactObjects(heldObjects, contactInfo);
 
     // Send global event
     VariantMap& eventData = GetEventDataMap();
     eventData[PhysicsUpdateContact2D::P_WORLD] = this;
     eventData[PhysicsUpdateContact2D::P_ENABLED] = contact->IsEnabled();
 
-    eventData[PhysicsUpdateContact2D::P_BODYA] = contactInfo.bodyA_.Get();
-    eventData[PhysicsUpdateContact2D::P_BODYB] = contactInfo.bodyB_.Get();
-    eventData[PhysicsUpdateContact2D::P_NODEA] = contactInfo.nodeA_.Get();
-    eventData[PhysicsUpdateContact2D::P_NODEB] = contactInfo.nodeB_.Get();
-    eventData[PhysicsUpdateContact2D::P_CONTACTS] = contactInfo.Serialize(contacts_);
-    eventData[PhysicsUpdateContact2D::P_SHAPEA] = contactInfo.shapeA_.Get();
-    eventData[PhysicsUpdateContact2D::P_SHAPEB] = contactInfo.shapeB_.Get();
+    eventData[PhysicsUpdateContact2D::P_BODYA] = contactInfo.bodyA_;
+    eventData[PhysicsUpdateContact2D::P_BODYB] = contactInfo.bodyB_;
+    eventData[PhysicsUpdateContact2D::P_NODEA] = contactInfo.nodeA_;
+    eventData[PhysicsUpdateContact2D::P_NODEB] = contactInfo.nodeB_;
+    eventData[PhysicsUpdateContact2D::P_CONTACTS] = SerializeContact(contactInfo, contacts_);
+    eventData[PhysicsUpdateContact2D::P_SHAPEA] = contactInfo.shapeA_;
+    eventData[PhysicsUpdateContact2D::P_SHAPEB] = contactInfo.shapeB_;
 
     SendEvent(E_PHYSICSUPDATECONTACT2D, eventData);
     contact->SetEnabled(eventData[PhysicsUpdateContact2D::P_ENABLED].GetBool());
@@ -159,26 +225,26 @@ void PhysicsWorld2D::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
 
     // Send node event
     eventData[NodeUpdateContact2D::P_ENABLED] = contact->IsEnabled();
-    eventData[NodeUpdateContact2D::P_CONTACTS] = contactInfo.Serialize(contacts_);
+    eventData[NodeUpdateContact2D::P_CONTACTS] = SerializeContact(contactInfo, contacts_);
 
     if (contactInfo.nodeA_)
     {
-        eventData[NodeUpdateContact2D::P_BODY] = contactInfo.bodyA_.Get();
-        eventData[NodeUpdateContact2D::P_OTHERNODE] = contactInfo.nodeB_.Get();
-        eventData[NodeUpdateContact2D::P_OTHERBODY] = contactInfo.bodyB_.Get();
-        eventData[NodeUpdateContact2D::P_SHAPE] = contactInfo.shapeA_.Get();
-        eventData[NodeUpdateContact2D::P_OTHERSHAPE] = contactInfo.shapeB_.Get();
+        eventData[NodeUpdateContact2D::P_BODY] = contactInfo.bodyA_;
+        eventData[NodeUpdateContact2D::P_OTHERNODE] = contactInfo.nodeB_;
+        eventData[NodeUpdateContact2D::P_OTHERBODY] = contactInfo.bodyB_;
+        eventData[NodeUpdateContact2D::P_SHAPE] = contactInfo.shapeA_;
+        eventData[NodeUpdateContact2D::P_OTHERSHAPE] = contactInfo.shapeB_;
 
         contactInfo.nodeA_->SendEvent(E_NODEUPDATECONTACT2D, eventData);
     }
 
     if (contactInfo.nodeB_)
     {
-        eventData[NodeUpdateContact2D::P_BODY] = contactInfo.bodyB_.Get();
-        eventData[NodeUpdateContact2D::P_OTHERNODE] = contactInfo.nodeA_.Get();
-        eventData[NodeUpdateContact2D::P_OTHERBODY] = contactInfo.bodyA_.Get();
-        eventData[NodeUpdateContact2D::P_SHAPE] = contactInfo.shapeB_.Get();
-        eventData[NodeUpdateContact2D::P_OTHERSHAPE] = contactInfo.shapeA_.Get();
+        eventData[NodeUpdateContact2D::P_BODY] = contactInfo.bodyB_;
+        eventData[NodeUpdateContact2D::P_OTHERNODE] = contactInfo.nodeA_;
+        eventData[NodeUpdateContact2D::P_OTHERBODY] = contactInfo.bodyA_;
+        eventData[NodeUpdateContact2D::P_SHAPE] = contactInfo.shapeB_;
+        eventData[NodeUpdateContact2D::P_OTHERSHAPE] = contactInfo.shapeA_;
 
         contactInfo.nodeB_->SendEvent(E_NODEUPDATECONTACT2D, eventData);
     }
@@ -278,19 +344,58 @@ void PhysicsWorld2D::DrawTransform(const b2Transform& xf)
 
 void PhysicsWorld2D::Update(float timeStep)
 {
+    CompleteUpdate();
+
     URHO3D_PROFILE(UpdatePhysics2D);
 
+    PreStep(timeStep);
+    StepWorld(timeStep);
+    PostStep(timeStep);
+}
+
+void PhysicsWorld2D::CompleteUpdate()
+{
+    if (!updatePending_)
+        return;
+
+    URHO3D_PROFILE(CompletePhysics2DUpdate);
+
+    WaitForStep();
+    if (!pendingStepped_)
+    {
+        StepWorld(pendingTimeStep_);
+        HoldRecordedContacts(beginContacts_);
+        HoldRecordedContacts(endContacts_);
+    }
+
+    updatePending_ = false;
+    pendingStepped_ = false;
+    PostStep(pendingTimeStep_);
+}
+
+void PhysicsWorld2D::PreStep(float timeStep)
+{
+    // Call the components registered for direct fixed updates, unless another world is the fixed update source
+    if (GetFixedUpdateSource() == this)
+        GetScene()->UpdateComponents(UPDATE_PHASE_FIXEDUPDATE, timeStep);
+
     using namespace PhysicsPreStep;
 
     VariantMap& eventData = GetEventDataMap();
     eventData[P_WORLD] = this;
     eventData[P_TIMESTEP] = timeStep;
     SendEvent(E_PHYSICSPRESTEP, eventData);
+}
 
+void PhysicsWorld2D::StepWorld(float timeStep)
+{
     physicsStepping_ = true;
     world_->Step(timeStep, velocityIterations_, positionIterations_);
     physicsStepping_ = false;
+}
 
+void PhysicsWorld2D::PostStep(float timeStep)
+{
     // Apply world transforms. Unparented transforms first
     for (unsigned i = 0; i < rigidBodies_.Size();)
     {
@@ -325,13 +430,53 @@ void PhysicsWorld2D::Update(float timeStep)
         }
     }
 
-    SendBeginContactEvents();
-    SendEndContactEvents();
+    SendContactEvents();
+
+    // The scene may have been removed by the contact event handlers
+    Scene* scene = GetScene();
+    if (!scene)
+        return;
+
+    if (GetFixedUpdateSource() == this)
+        scene->UpdateComponents(UPDATE_PHASE_FIXEDPOSTUPDATE, timeStep);
 
     using namespace PhysicsPostStep;
+
+    VariantMap& eventData = GetEventDataMap();
+    eventData[P_WORLD] = this;
+    eventData[P_TIMESTEP] = timeStep;
     SendEvent(E_PHYSICSPOSTSTEP, eventData);
 }
 
+void PhysicsWorld2D::WaitForStep()
+{
+    if (!stepItem_)
+        return;
+
+    // If the step was not taken by a worker thread yet, execute it now. Otherwise block until it has finished
+    auto* queue = GetSubsystem<WorkQueue>();
+    if (queue)
+        queue->CompleteItem(stepItem_);
+
+    stepItem_.Reset();
+    pendingStepped_ = true;
+
+    // Back on the main thread, reference the objects of the recorded contacts before anything can destroy them
+    HoldRecordedContacts(beginContacts_);
+    HoldRecordedContacts(endContacts_);
+}
+
+void PhysicsWorld2D::CancelUpdate()
+{
+    WaitForStep();
+
+    updatePending_ = false;
+    pendingStepped_ = false;
+    beginContacts_.Clear();
+    endContacts_.Clear();
+    contactObjects_.Clear();
+}
+
 void PhysicsWorld2D::DrawDebugGeometry()
 {
     auto* debug = GetComponent<DebugRenderer>();
@@ -344,6 +489,22 @@ void PhysicsWorld2D::SetUpdateEnabled(bool enable)
     updateEnabled_ = enable;
 }
 
+void PhysicsWorld2D::SetThreadedUpdate(bool enable)
+{
+    if (enable == threadedUpdate_)
+        return;
+
+    if (!enable)
+        CompleteUpdate();
+
+    threadedUpdate_ = enable;
+}
+
+void PhysicsWorld2D::SetBatchedContactEvents(bool enable)
+{
+    batchedContactEvents_ = enable;
+}
+
 void PhysicsWorld2D::SetDrawShape(bool drawShape)
 {
     if (drawShape)
@@ -387,26 +548,32 @@ void PhysicsWorld2D::SetDrawCenterOfMass(bool drawCenterOfMass)
 
 void PhysicsWorld2D::SetAllowSleeping(bool enable)
 {
+    WaitForStep();
     world_->SetAllowSleeping(enable);
 }
 
 void PhysicsWorld2D::SetWarmStarting(bool enable)
 {
+    WaitForStep();
     world_->SetWarmStarting(enable);
 }
 
 void PhysicsWorld2D::SetContinuousPhysics(bool enable)
 {
+    WaitForStep();
     world_->SetContinuousPhysics(enable);
 }
 
 void PhysicsWorld2D::SetSubStepping(bool enable)
 {
+    WaitForStep();
     world_->SetSubStepping(enable);
 }
 
 void PhysicsWorld2D::SetGravity(const Vector2& gravity)
 {
+    WaitForStep();
+
     gravity_ = gravity;
 
     world_->SetGravity(ToB2Vec2(gravity_));
@@ -414,16 +581,19 @@ void PhysicsWorld2D::SetGravity(const Vector2& gravity)
 
 void PhysicsWorld2D::SetAutoClearForces(bool enable)
 {
+    WaitForStep();
     world_->SetAutoClearForces(enable);
 }
 
 void PhysicsWorld2D::SetVelocityIterations(int velocityIterations)
 {
+    WaitForStep();
     velocityIterations_ = velocityIterations;
 }
 
 void PhysicsWorld2D::SetPositionIterations(int positionIterations)
 {
+    WaitForStep();
     positionIterations_ = positionIterations;
 }
 
@@ -497,6 +667,8 @@ protected:
 void PhysicsWorld2D::Raycast(PODVector<PhysicsRaycastResult2D>& results, const Vector2& startPoint, const Vector2& endPoint,
     unsigned collisionMask)
 {
+    WaitForStep();
+
     results.Clear();
 
     RayCastCallback callback(results, startPoint, collisionMask);
@@ -554,6 +726,8 @@ private:
 void PhysicsWorld2D::RaycastSingle(PhysicsRaycastResult2D& result, const Vector2& startPoint, const Vector2& endPoint,
     unsigned collisionMask)
 {
+    WaitForStep();
+
     result.body_ = nullptr;
 
     SingleRayCastCallback callback(result, startPoint, collisionMask);
@@ -605,6 +779,8 @@ private:
 
 RigidBody2D* PhysicsWorld2D::GetRigidBody(const Vector2& point, unsigned collisionMask)
 {
+    WaitForStep();
+
     PointQueryCallback callback(ToB2Vec2(point), collisionMask);
 
     b2AABB b2Aabb;
@@ -667,6 +843,8 @@ private:
 
 void PhysicsWorld2D::GetRigidBodies(PODVector<RigidBody2D*>& results, const Rect& aabb, unsigned collisionMask)
 {
+    WaitForStep();
+
     AabbQueryCallback callback(results, collisionMask);
 
     b2AABB b2Aabb;
@@ -702,13 +880,28 @@ bool PhysicsWorld2D::GetAutoClearForces() const
     return world_->GetAutoClearForces();
 }
 
+b2World* PhysicsWorld2D::GetWorld()
+{
+    WaitForStep();
+    return world_.Get();
+}
+
 void PhysicsWorld2D::OnSceneSet(Scene* scene)
 {
     // Subscribe to the scene subsystem update, which will trigger the physics simulation step
     if (scene)
+    {
         SubscribeToEvent(scene, E_SCENESUBSYSTEMUPDATE, URHO3D_HANDLER(PhysicsWorld2D, HandleSceneSubsystemUpdate));
+        SubscribeToEvent(E_POSTRENDERUPDATE, URHO3D_HANDLER(PhysicsWorld2D, HandlePostRenderUpdate));
+        SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(PhysicsWorld2D, HandleEndFrame));
+    }
     else
+    {
+        CancelUpdate();
         UnsubscribeFromEvent(E_SCENESUBSYSTEMUPDATE);
+        UnsubscribeFromEvent(E_POSTRENDERUPDATE);
+        UnsubscribeFromEvent(E_ENDFRAME);
+    }
 }
 
 void PhysicsWorld2D::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData)
@@ -717,12 +910,115 @@ void PhysicsWorld2D::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap
         return;
 
     using namespace SceneSubsystemUpdate;
-    Update(eventData[P_TIMESTEP].GetFloat());
+    float timeStep = eventData[P_TIMESTEP].GetFloat();
+
+    if (!threadedUpdate_)
+    {
+        Update(timeStep);
+        return;
+    }
+
+    // Complete the previous threaded step in case the frame end was not reached, then run the pre-step logic now.
+    // The Box2D step is started after the logic and rendering updates, so that it does not run concurrently with the
+    // scene logic that may modify the physics objects
+    CompleteUpdate();
+
+    URHO3D_PROFILE(UpdatePhysics2D);
+
+    PreStep(timeStep);
+    updatePending_ = true;
+    pendingTimeStep_ = timeStep;
+}
+
+void PhysicsWorld2D::HandlePostRenderUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (!updatePending_ || pendingStepped_ || stepItem_)
+        return;
+
+    // Without worker threads the step is executed when it is completed instead
+    auto* queue = GetSubsystem<WorkQueue>();
+    if (!queue || !queue->GetNumThreads())
+        return;
+
+    stepItem_ = new WorkItem();
+    stepItem_->workFunction_ = StepWorld2DWork;
+    stepItem_->aux_ = this;
+    stepItem_->priority_ = STEP_WORK_PRIORITY;
+    queue->AddWorkItem(stepItem_);
+}
+
+void PhysicsWorld2D::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    CompleteUpdate();
+}
+
+void PhysicsWorld2D::RecordContact(PODVector<PhysicsContact2D>& dest, b2Contact* contact)
+{
+    b2Fixture* fixtureA = contact->GetFixtureA();
+    b2Fixture* fixtureB = contact->GetFixtureB();
+    if (!fixtureA || !fixtureB)
+        return;
+
+    PhysicsContact2D contactInfo;
+    ReadContact(contact, contactInfo);
+
+    // A threaded step may run on a worker thread, so it only records the contact; WaitForStep() holds the objects.
+    // Otherwise hold them now, as update contact event handlers may destroy them during the step. A body or shape that
+    // is being destroyed ends its contacts from its destructor; those contacts can not be referenced and are dropped
+    if (!updatePending_)
+    {
+        if (!CanHoldContactObjects(contactInfo))
+            return;
+        HoldContactObjects(contactObjects_, contactInfo);
+    }
+
+    dest.Push(contactInfo);
+}
+
+void PhysicsWorld2D::HoldRecordedContacts(PODVector<PhysicsContact2D>& contacts)
+{
+    for (unsigned i = 0; i < contacts.Size();)
+    {
+        if (CanHoldContactObjects(contacts[i]))
+        {
+            HoldContactObjects(contactObjects_, contacts[i]);
+            ++i;
+        }
+        else
+            contacts.Erase(i);
+    }
+}
+
+void PhysicsWorld2D::SendContactEvents()
+{
+    // The objects in the recorded contacts are already held, so the event handlers may remove them
+    if (beginContacts_.Empty() && endContacts_.Empty())
+        return;
+
+    if (batchedContactEvents_)
+    {
+        using namespace PhysicsContacts2D;
+
+        VariantMap& eventData = GetEventDataMap();
+        eventData[P_WORLD] = this;
+        eventData[P_NUMBEGINCONTACTS] = beginContacts_.Size();
+        eventData[P_NUMENDCONTACTS] = endContacts_.Size();
+        SendEvent(E_PHYSICSCONTACTS2D, eventData);
+    }
+    else
+    {
+        SendBeginContactEvents();
+        SendEndContactEvents();
+    }
+
+    beginContacts_.Clear();
+    endContacts_.Clear();
+    contactObjects_.Clear();
 }
 
 void PhysicsWorld2D::SendBeginContactEvents()
 {
-    if (beginContactInfos_.Empty())
+    if (beginContacts_.Empty())
         return;
 
     using namespace PhysicsBeginContact2D;
@@ -730,50 +1026,48 @@ void PhysicsWorld2D::SendBeginContactEvents()
     VariantMap nodeEventData;
     eventData[P_WORLD] = this;
 
-    for (unsigned i = 0; i < beginContactInfos_.Size(); ++i)
+    for (unsigned i = 0; i < beginContacts_.Size(); ++i)
     {
-        ContactInfo& contactInfo = beginContactInfos_[i];
-        eventData[P_BODYA] = contactInfo.bodyA_.Get();
-        eventData[P_BODYB] = contactInfo.bodyB_.Get();
-        eventData[P_NODEA] = contactInfo.nodeA_.Get();
-        eventData[P_NODEB] = contactInfo.nodeB_.Get();
-        eventData[P_CONTACTS] = contactInfo.Serialize(contacts_);
-        eventData[P_SHAPEA] = contactInfo.shapeA_.Get();
-        eventData[P_SHAPEB] = contactInfo.shapeB_.Get();
+        const PhysicsContact2D& contactInfo = beginContacts_[i];
+        eventData[P_BODYA] = contactInfo.bodyA_;
+        eventData[P_BODYB] = contactInfo.bodyB_;
+        eventData[P_NODEA] = contactInfo.nodeA_;
+        eventData[P_NODEB] = contactInfo.nodeB_;
+        eventData[P_CONTACTS] = SerializeContact(contactInfo, contacts_);
+        eventData[P_SHAPEA] = contactInfo.shapeA_;
+        eventData[P_SHAPEB] = contactInfo.shapeB_;
 
         SendEvent(E_PHYSICSBEGINCONTACT2D, eventData);
 
-        nodeEventData[NodeBeginContact2D::P_CONTACTS] = contactInfo.Serialize(contacts_);
+        nodeEventData[NodeBeginContact2D::P_CONTACTS] = SerializeContact(contactInfo, contacts_);
 
         if (contactInfo.nodeA_)
         {
-            nodeEventData[NodeBeginContact2D::P_BODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERNODE] = contactInfo.nodeB_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERBODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeBeginContact2D::P_SHAPE] = contactInfo.shapeA_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERSHAPE] = contactInfo.shapeB_.Get();
+            nodeEventData[NodeBeginContact2D::P_BODY] = contactInfo.bodyA_;
+            nodeEventData[NodeBeginContact2D::P_OTHERNODE] = contactInfo.nodeB_;
+            nodeEventData[NodeBeginContact2D::P_OTHERBODY] = contactInfo.bodyB_;
+            nodeEventData[NodeBeginContact2D::P_SHAPE] = contactInfo.shapeA_;
+            nodeEventData[NodeBeginContact2D::P_OTHERSHAPE] = contactInfo.shapeB_;
 
             contactInfo.nodeA_->SendEvent(E_NODEBEGINCONTACT2D, nodeEventData);
         }
 
         if (contactInfo.nodeB_)
         {
-            nodeEventData[NodeBeginContact2D::P_BODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERNODE] = contactInfo.nodeA_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERBODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeBeginContact2D::P_SHAPE] = contactInfo.shapeB_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERSHAPE] = contactInfo.shapeA_.Get();
+            nodeEventData[NodeBeginContact2D::P_BODY] = contactInfo.bodyB_;
+            nodeEventData[NodeBeginContact2D::P_OTHERNODE] = contactInfo.nodeA_;
+            nodeEventData[NodeBeginContact2D::P_OTHERBODY] = contactInfo.bodyA_;
+            nodeEventData[NodeBeginContact2D::P_SHAPE] = contactInfo.shapeB_;
+            nodeEventData[NodeBeginContact2D::P_OTHERSHAPE] = contactInfo.shapeA_;
 
             contactInfo.nodeB_->SendEvent(E_NODEBEGINCONTACT2D, nodeEventData);
         }
     }
-
-    beginContactInfos_.Clear();
 }
 
 void PhysicsWorld2D::SendEndContactEvents()
 {
-    if (endContactInfos_.Empty())
+    if (endContacts_.Empty())
         return;
 
     using namespace PhysicsEndContact2D;
@@ -781,81 +1075,43 @@ void PhysicsWorld2D::SendEndContactEvents()
     VariantMap nodeEventData;
     eventData[P_WORLD] = this;
 
-    for (unsigned i = 0; i < endContactInfos_.Size(); ++i)
+    for (unsigned i = 0; i < endContacts_.Size(); ++i)
     {
-        ContactInfo& contactInfo = endContactInfos_[i];
-        eventData[P_BODYA] = contactInfo.bodyA_.Get();
-        eventData[P_BODYB] = contactInfo.bodyB_.Get();
-        eventData[P_NODEA] = contactInfo.nodeA_.Get();
-        eventData[P_NODEB] = contactInfo.nodeB_.Get();
-        eventData[P_CONTACTS] = contactInfo.Serialize(contacts_);
-        eventData[P_SHAPEA] = contactInfo.shapeA_.Get();
-        eventData[P_SHAPEB] = contactInfo.shapeB_.Get();
+        const PhysicsContact2D& contactInfo = endContacts_[i];
+        eventData[P_BODYA] = contactInfo.bodyA_;
+        eventData[P_BODYB] = contactInfo.bodyB_;
+        eventData[P_NODEA] = contactInfo.nodeA_;
+        eventData[P_NODEB] = contactInfo.nodeB_;
+        eventData[P_CONTACTS] = SerializeContact(contactInfo, contacts_);
+        eventData[P_SHAPEA] = contactInfo.shapeA_;
+        eventData[P_SHAPEB] = contactInfo.shapeB_;
 
         SendEvent(E_PHYSICSENDCONTACT2D, eventData);
 
-        nodeEventData[NodeEndContact2D::P_CONTACTS] = contactInfo.Serialize(contacts_);
+        nodeEventData[NodeEndContact2D::P_CONTACTS] = SerializeContact(contactInfo, contacts_);
 
         if (contactInfo.nodeA_)
         {
-            nodeEventData[NodeEndContact2D::P_BODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERNODE] = contactInfo.nodeB_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERBODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeEndContact2D::P_SHAPE] = contactInfo.shapeA_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERSHAPE] = contactInfo.shapeB_.Get();
+            nodeEventData[NodeEndContact2D::P_BODY] = contactInfo.bodyA_;
+            nodeEventData[NodeEndContact2D::P_OTHERNODE] = contactInfo.nodeB_;
+            nodeEventData[NodeEndContact2D::P_OTHERBODY] = contactInfo.bodyB_;
+            nodeEventData[NodeEndContact2D::P_SHAPE] = contactInfo.shapeA_;
+            nodeEventData[NodeEndContact2D::P_OTHERSHAPE] = contactInfo.shapeB_;
 
             contactInfo.nodeA_->SendEvent(E_NODEENDCONTACT2D, nodeEventData);
         }
 
         if (contactInfo.nodeB_)
         {
-            nodeEventData[NodeEndContact2D::P_BODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERNODE] = contactInfo.nodeA_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERBODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeEndContact2D::P_SHAPE] = contactInfo.shapeB_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERSHAPE] = contactInfo.shapeA_.Get();
+            nodeEventData[NodeEndContact2D::P_BODY] = contactInfo.bodyB_;
+            nodeEventData[NodeEndContact2D::P_OTHERNODE] = contactInfo.nodeA_;
+            nodeEventData[NodeEndContact2D::P_OTHERBODY] = contactInfo.bodyA_;
+            nodeEventData[NodeEndContact2D::P_SHAPE] = contactInfo.shapeB_;
+            nodeEventData[NodeEndContact2D::P_OTHERSHAPE] = contactInfo.shapeA_;
 
             contactInfo.nodeB_->SendEvent(E_NODEENDCONTACT2D, nodeEventData);
         }
     }
-
-    endContactInfos_.Clear();
-}
-
-PhysicsWorld2D::ContactInfo::ContactInfo() = default;
-
-PhysicsWorld2D::ContactInfo::ContactInfo(b2Contact* contact)
-{
-    b2Fixture* fixtureA = contact->GetFixtureA();
-    b2Fixture* fixtureB = contact->GetFixtureB();
-    bodyA_ = (RigidBody2D*)(fixtureA->GetBody()->GetUserData());
-    bodyB_ = (RigidBody2D*)(fixtureB->GetBody()->GetUserData());
-    nodeA_ = bodyA_->GetNode();
-    nodeB_ = bodyB_->GetNode();
-    shapeA_ = (CollisionShape2D*)fixtureA->GetUserData();
-    shapeB_ = (CollisionShape2D*)fixtureB->GetUserData();
-
-    b2WorldManifold worldManifold;
-    contact->GetWorldManifold(&worldManifold);
-    numPoints_ = contact->GetManifold()->pointCount;
-    worldNormal_ = Vector2(worldManifold.normal.x, worldManifold.normal.y);
-    for (int i = 0; i < numPoints_; ++i)
-    {
-        worldPositions_[i] = Vector2(worldManifold.points[i].x, worldManifold.points[i].y);
-        separations_[i] = worldManifold.separations[i];
-    }
-}
-
-const Urho3D::PODVector<unsigned char>& PhysicsWorld2D::ContactInfo::Serialize(VectorBuffer& buffer) const
-{
-    buffer.Clear();
-    for (int i = 0; i < numPoints_; ++i)
-    {
-        buffer.WriteVector2(worldPositions_[i]);
-        buffer.WriteVector2(worldNormal_);
-        buffer.WriteFloat(separations_[i]);
-    }
-    return buffer.GetBuffer();
 }
 
 }
@@ -33,6 +33,7 @@ namespace Urho3D
 class Camera;
 class CollisionShape2D;
 class RigidBody2D;
+struct WorkItem;
 
 /// 2D Physics raycast hit.
 struct URHO3D_API PhysicsRaycastResult2D
@@ -53,6 +54,31 @@ struct URHO3D_API PhysicsRaycastResult2D
     RigidBody2D* body_{};
 };
 
+/// 2D physics contact between two rigid bodies, recorded during a simulation step.
+struct URHO3D_API PhysicsContact2D
+{
+    /// Rigid body A.
+    RigidBody2D* bodyA_{};
+    /// Rigid body B.
+    RigidBody2D* bodyB_{};
+    /// Node A.
+    Node* nodeA_{};
+    /// Node B.
+    Node* nodeB_{};
+    /// Shape A.
+    CollisionShape2D* shapeA_{};
+    /// Shape B.
+    CollisionShape2D* shapeB_{};
+    /// Number of contact points.
+    int numPoints_{};
+    /// Contact normal in world space.
+    Vector2 worldNormal_;
+    /// Contact positions in world space.
+    Vector2 worldPositions_[b2_maxManifoldPoints];
+    /// Contact overlap values.
+    float separations_[b2_maxManifoldPoints]{};
+};
+
 /// Delayed world transform assignment for parented 2D rigidbodies.
 struct DelayedWorldTransform2D
 {
@@ -71,6 +97,8 @@ class URHO3D_API PhysicsWorld2D : public Component, public b2ContactListener, pu
 {
     URHO3D_OBJECT(PhysicsWorld2D, Component);
 
+    friend void StepWorld2DWork(const WorkItem* item, unsigned threadIndex);
+
 public:
     /// Construct.
     explicit PhysicsWorld2D(Context* context);
@@ -106,12 +134,20 @@ public:
     /// Draw a point.
     void DrawPoint(const b2Vec2& p, float32 size, const b2Color& color) override;
 
-    /// Step the simulation forward.
+    /// Step the simulation forward. Completes a pending threaded step first.
     void Update(float timeStep);
+    /// Complete a pending threaded simulation step: wait for the worker thread, then apply the transforms and send the contact and post-step events. Called automatically at the end of the frame.
+    void CompleteUpdate();
+    /// Wait for a threaded simulation step running on a worker thread, or execute it now if it was not started yet. Called before the Box2D world or bodies are accessed from the main thread.
+    void WaitForStep();
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry();
     /// Enable or disable automatic physics simulation during scene update. Enabled by default.
     void SetUpdateEnabled(bool enable);
+    /// Enable or disable stepping the Box2D world on a work queue thread during the automatic update. The step runs concurrently with rendering and with the steps of other worlds, and its results are applied at the end of the frame. Disabled by default.
+    void SetThreadedUpdate(bool enable);
+    /// Enable or disable sending the contacts of each step as one E_PHYSICSCONTACTS2D event instead of the individual begin and end contact events. Disabled by default.
+    void SetBatchedContactEvents(bool enable);
     /// Set draw shape.
     void SetDrawShape(bool drawShape);
     /// Set draw joint.
@@ -161,6 +197,18 @@ public:
     /// Return whether physics world will automatically simulate during scene update.
     bool IsUpdateEnabled() const { return updateEnabled_; }
 
+    /// Return whether the Box2D world is stepped on a work queue thread during the automatic update.
+    bool GetThreadedUpdate() const { return threadedUpdate_; }
+
+    /// Return whether contacts are sent as one batched event per step.
+    bool GetBatchedContactEvents() const { return batchedContactEvents_; }
+
+    /// Return begin contacts of the current step. Valid during the E_PHYSICSCONTACTS2D event.
+    const PODVector<PhysicsContact2D>& GetBeginContacts() const { return beginContacts_; }
+
+    /// Return end contacts of the current step. Valid during the E_PHYSICSCONTACTS2D event.
+    const PODVector<PhysicsContact2D>& GetEndContacts() const { return endContacts_; }
+
     /// Return draw shape.
     bool GetDrawShape() const { return (m_drawFlags & e_shapeBit) != 0; }
 
@@ -196,8 +244,8 @@ public:
     /// Return position iterations.
     int GetPositionIterations() const { return positionIterations_; }
 
-    /// Return the Box2D physics world.
-    b2World* GetWorld() { return world_.Get(); }
+    /// Return the Box2D physics world. Waits for a threaded simulation step to finish first.
+    b2World* GetWorld();
 
     /// Set node dirtying to be disregarded.
     void SetApplyingTransforms(bool enable) { applyingTransforms_ = enable; }
@@ -211,6 +259,24 @@ protected:
 
     /// Handle the scene subsystem update event, step simulation here.
     void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle the post-render update event, start a pending threaded step here.
+    void HandlePostRenderUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle the frame end event, complete a pending threaded step here.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Call the fixed update components and send the pre-step event.
+    void PreStep(float timeStep);
+    /// Step the Box2D world.
+    void StepWorld(float timeStep);
+    /// Apply the simulated transforms, send the contact events, then call the fixed post-update components and send the post-step event.
+    void PostStep(float timeStep);
+    /// Discard a pending threaded step after waiting for it.
+    void CancelUpdate();
+    /// Record a begin or end contact. Outside threaded steps also hold references to its objects.
+    void RecordContact(PODVector<PhysicsContact2D>& dest, b2Contact* contact);
+    /// Hold references to the objects of the contacts recorded during a threaded step, dropping the contacts whose objects are being destroyed.
+    void HoldRecordedContacts(PODVector<PhysicsContact2D>& contacts);
+    /// Send the recorded contacts as individual or batched events.
+    void SendContactEvents();
     /// Send begin contact events.
     void SendBeginContactEvents();
     /// Send end contact events.
@@ -234,6 +300,18 @@ protected:
 
     /// Automatic simulation update enabled flag.
     bool updateEnabled_{true};
+    /// Threaded update flag.
+    bool threadedUpdate_{};
+    /// Batched contact events flag.
+    bool batchedContactEvents_{};
+    /// Whether a threaded step has begun and is waiting to be completed.
+    bool updatePending_{};
+    /// Whether the Box2D world has been stepped for the pending threaded step.
+    bool pendingStepped_{};
+    /// Time step of the pending threaded step.
+    float pendingTimeStep_{};
+    /// Work item of the threaded step while it is queued or running.
+    SharedPtr<WorkItem> stepItem_;
     /// Whether is currently stepping the world. Used internally.
     bool physicsStepping_{};
     /// Applying transforms.
@@ -243,41 +321,12 @@ protected:
     /// Delayed (parented) world transform assignments.
     HashMap<RigidBody2D*, DelayedWorldTransform2D> delayedWorldTransforms_;
 
-    /// Contact info.
-    struct ContactInfo
-    {
-        /// Construct.
-        ContactInfo();
-        /// Construct.
-        explicit ContactInfo(b2Contact* contact);
-        /// Write contact info to buffer.
-        const PODVector<unsigned char>& Serialize(VectorBuffer& buffer) const;
-
-        /// Rigid body A.
-        SharedPtr<RigidBody2D> bodyA_;
-        /// Rigid body B.
-        SharedPtr<RigidBody2D> bodyB_;
-        /// Node A.
-        SharedPtr<Node> nodeA_;
-        /// Node B.
-        SharedPtr<Node> nodeB_;
-        /// Shape A.
-        SharedPtr<CollisionShape2D> shapeA_;
-        /// Shape B.
-        SharedPtr<CollisionShape2D> shapeB_;
-        /// Number of contact points.
-        int numPoints_{};
-        /// Contact normal in world space.
-        Vector2 worldNormal_;
-        /// Contact positions in world space.
-        Vector2 worldPositions_[b2_maxManifoldPoints];
-        /// Contact overlap values.
-        float separations_[b2_maxManifoldPoints]{};
-    };
-    /// Begin contact infos.
-    Vector<ContactInfo> beginContactInfos_;
-    /// End contact infos.
-    Vector<ContactInfo> endContactInfos_;
+    /// Begin contacts recorded during the step.
+    PODVector<PhysicsContact2D> beginContacts_;
+    /// End contacts recorded during the step.
+    PODVector<PhysicsContact2D> endContacts_;
+    /// References to the objects in the recorded contacts, held until the contact events have been sent.
+    Vector<SharedPtr<Object> > contactObjects_;
     /// Temporary buffer with contact data.
     VectorBuffer contacts_;
 };
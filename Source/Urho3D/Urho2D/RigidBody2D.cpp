@@ -92,6 +92,8 @@ void RigidBody2D::RegisterObject(Context* context)
 
 void RigidBody2D::OnSetEnabled()
 {
+    WaitForStep();
+
     bool enabled = IsEnabledEffective();
 
     bodyDef_.active = enabled;
@@ -104,6 +106,8 @@ void RigidBody2D::OnSetEnabled()
 
 void RigidBody2D::SetBodyType(BodyType2D type)
 {
+    WaitForStep();
+
     auto bodyType = (b2BodyType)type;
     if (body_)
     {
@@ -126,6 +130,8 @@ void RigidBody2D::SetBodyType(BodyType2D type)
 
 void RigidBody2D::SetMass(float mass)
 {
+    WaitForStep();
+
     mass = Max(mass, 0.0f);
     if (massData_.mass == mass)
         return;
@@ -140,6 +146,8 @@ void RigidBody2D::SetMass(float mass)
 
 void RigidBody2D::SetInertia(float inertia)
 {
+    WaitForStep();
+
     inertia = Max(inertia, 0.0f);
     if (massData_.I == inertia)
         return;
@@ -154,6 +162,8 @@ void RigidBody2D::SetInertia(float inertia)
 
 void RigidBody2D::SetMassCenter(const Vector2& center)
 {
+    WaitForStep();
+
     b2Vec2 b2Center = ToB2Vec2(center);
     if (massData_.center == b2Center)
         return;
@@ -168,6 +178,8 @@ void RigidBody2D::SetMassCenter(const Vector2& center)
 
 void RigidBody2D::SetUseFixtureMass(bool useFixtureMass)
 {
+    WaitForStep();
+
     if (useFixtureMass_ == useFixtureMass)
         return;
 
@@ -186,6 +198,8 @@ void RigidBody2D::SetUseFixtureMass(bool useFixtureMass)
 
 void RigidBody2D::SetLinearDamping(float linearDamping)
 {
+    WaitForStep();
+
     if (body_)
         body_->SetLinearDamping(linearDamping);
     else
@@ -201,6 +215,8 @@ void RigidBody2D::SetLinearDamping(float linearDamping)
 
 void RigidBody2D::SetAngularDamping(float angularDamping)
 {
+    WaitForStep();
+
     if (body_)
         body_->SetAngularDamping(angularDamping);
     else
@@ -216,6 +232,8 @@ void RigidBody2D::SetAngularDamping(float angularDamping)
 
 void RigidBody2D::SetAllowSleep(bool allowSleep)
 {
+    WaitForStep();
+
     if (body_)
         body_->SetSleepingAllowed(allowSleep);
     else
@@ -231,6 +249,8 @@ void RigidBody2D::SetAllowSleep(bool allowSleep)
 
 void RigidBody2D::SetFixedRotation(bool fixedRotation)
 {
+    WaitForStep();
+
     if (body_)
     {
         body_->SetFixedRotation(fixedRotation);
@@ -252,6 +272,8 @@ void RigidBody2D::SetFixedRotation(bool fixedRotation)
 
 void RigidBody2D::SetBullet(bool bullet)
 {
+    WaitForStep();
+
     if (body_)
         body_->SetBullet(bullet);
     else
@@ -267,6 +289,8 @@ void RigidBody2D::SetBullet(bool bullet)
 
 void RigidBody2D::SetGravityScale(float gravityScale)
 {
+    WaitForStep();
+
     if (body_)
         body_->SetGravityScale(gravityScale);
     else
@@ -282,6 +306,8 @@ void RigidBody2D::SetGravityScale(float gravityScale)
 
 void RigidBody2D::SetAwake(bool awake)
 {
+    WaitForStep();
+
     if (body_)
         body_->SetAwake(awake);
     else
@@ -297,6 +323,8 @@ void RigidBody2D::SetAwake(bool awake)
 
 void RigidBody2D::SetLinearVelocity(const Vector2& linearVelocity)
 {
+    WaitForStep();
+
     b2Vec2 b2linearVelocity = ToB2Vec2(linearVelocity);
     if (body_)
         body_->SetLinearVelocity(b2linearVelocity);
@@ -313,6 +341,8 @@ void RigidBody2D::SetLinearVelocity(const Vector2& linearVelocity)
 
 void RigidBody2D::SetAngularVelocity(float angularVelocity)
 {
+    WaitForStep();
+
     if (body_)
         body_->SetAngularVelocity(angularVelocity);
     else
@@ -328,36 +358,42 @@ void RigidBody2D::SetAngularVelocity(float angularVelocity)
 
 void RigidBody2D::ApplyForce(const Vector2& force, const Vector2& point, bool wake)
 {
+    WaitForStep();
     if (body_ && force != Vector2::ZERO)
         body_->ApplyForce(ToB2Vec2(force), ToB2Vec2(point), wake);
 }
 
 void RigidBody2D::ApplyForceToCenter(const Vector2& force, bool wake)
 {
+    WaitForStep();
     if (body_ && force != Vector2::ZERO)
         body_->ApplyForceToCenter(ToB2Vec2(force), wake);
 }
 
 void RigidBody2D::ApplyTorque(float torque, bool wake)
 {
+    WaitForStep();
     if (body_ && torque != 0)
         body_->ApplyTorque(torque, wake);
 }
 
 void RigidBody2D::ApplyLinearImpulse(const Vector2& impulse, const Vector2& point, bool wake)
 {
+    WaitForStep();
     if (body_ && impulse != Vector2::ZERO)
         body_->ApplyLinearImpulse(ToB2Vec2(impulse), ToB2Vec2(point), wake);
 }
 
 void RigidBody2D::ApplyLinearImpulseToCenter(const Vector2& impulse, bool wake)
 {
+    WaitForStep();
     if (body_ && impulse != Vector2::ZERO)
         body_->ApplyLinearImpulseToCenter(ToB2Vec2(impulse), wake);
 }
 
 void RigidBody2D::ApplyAngularImpulse(float impulse, bool wake)
 {
+    WaitForStep();
     if (body_)
         body_->ApplyAngularImpulse(impulse, wake);
 }
@@ -508,6 +544,7 @@ void RigidBody2D::RemoveConstraint2D(Constraint2D* constraint)
 
 float RigidBody2D::GetMass() const
 {
+    WaitForStep();
     if (!useFixtureMass_)
         return massData_.mass;
     else
@@ -516,6 +553,7 @@ float RigidBody2D::GetMass() const
 
 float RigidBody2D::GetInertia() const
 {
+    WaitForStep();
     if (!useFixtureMass_)
         return massData_.I;
     else
@@ -524,24 +562,40 @@ float RigidBody2D::GetInertia() const
 
 Vector2 RigidBody2D::GetMassCenter() const
 {
+    WaitForStep();
     if (!useFixtureMass_)
         return ToVector2(massData_.center);
     else
         return body_ ? ToVector2(body_->GetLocalCenter()) : Vector2::ZERO;
 }
 
+b2Body* RigidBody2D::GetBody() const
+{
+    WaitForStep();
+    return body_;
+}
+
+void RigidBody2D::WaitForStep() const
+{
+    if (physicsWorld_)
+        physicsWorld_->WaitForStep();
+}
+
 bool RigidBody2D::IsAwake() const
 {
+    WaitForStep();
     return body_ ? body_->IsAwake() : bodyDef_.awake;
 }
 
 Vector2 RigidBody2D::GetLinearVelocity() const
 {
+    WaitForStep();
     return ToVector2(body_ ? body_->GetLinearVelocity() : bodyDef_.linearVelocity);
 }
 
 float RigidBody2D::GetAngularVelocity() const
 {
+    WaitForStep();
     return body_ ? body_->GetAngularVelocity() : bodyDef_.angularVelocity;
 }
 
@@ -597,6 +651,8 @@ void RigidBody2D::OnMarkedDirty(Node* node)
         return;
     }
 
+    WaitForStep();
+
     // Check if transform has changed from the last one set in ApplyWorldTransform()
     b2Vec2 newPosition = ToB2Vec2(node_->GetWorldPosition());
     float newAngle = node_->GetWorldRotation().RollAngle() * M_DEGTORAD;
@@ -156,8 +156,10 @@ public:
     /// Return angular velocity.
     float GetAngularVelocity() const;
 
-    /// Return Box2D body.
-    b2Body* GetBody() const { return body_; }
+    /// Return Box2D body. Waits for a threaded simulation step of the physics world to finish first.
+    b2Body* GetBody() const;
+    /// Wait for a threaded simulation step of the physics world to finish. Called before the Box2D body is accessed.
+    void WaitForStep() const;
 
 private:
     /// Handle node being assigned.